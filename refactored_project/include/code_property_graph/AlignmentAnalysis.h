@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * AlignmentAnalysis.h - 指针与内存访问地址的对齐分析
+ *
+ * 抽象值为 address ≡ offset (mod align)，align 为 2 的幂。对齐事实的来源：
+ *   - 声明：变量/字段的 alignas 与类型对齐（getDeclAlign），结构体字段按布局偏移
+ *   - 分配点：malloc/calloc/realloc、operator new（默认 new 对齐）、aligned_alloc/memalign、
+ *     _mm_malloc/_aligned_malloc、posix_memalign(&p, A, n)、assume_aligned/alloc_align 属性
+ *   - __builtin_assume_aligned(p, A[, off])、形参的 align_value 属性
+ * 传播：指针算术按值域分析给出的下标同余计算字节偏移；局部指针变量按其全部定义
+ * （初始化、赋值、+=/-=、++/--）做流不敏感的不动点合并；仅内部链接且未取地址的函数
+ * 从翻译单元内的调用点合并实参对齐。没有其他信息时按所指类型的对齐处理。
+ */
+#ifndef CPG_ALIGNMENT_ANALYSIS_H
+#define CPG_ALIGNMENT_ANALYSIS_H
+
+#include "code_property_graph/ValueRangeAnalysis.h"
+
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/Expr.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace cpg {
+
+class CPGContext;
+
+// ============================================
+// 抽象值：address ≡ offset (mod align)
+// ============================================
+struct Alignment {
+    static constexpr uint64_t kMaxAlign = uint64_t(1) << 32;
+
+    bool empty = false;             // 尚无定义（不动点求解的初值）
+    uint64_t align = 1;             // 2 的幂
+    uint64_t offset = 0;            // [0, align)
+
+    static Alignment Unknown() { return Alignment(); }
+    static Alignment Bottom();
+    static Alignment Aligned(uint64_t bytes, uint64_t misalign = 0);
+
+    // 地址一定是其倍数的最大 2 的幂
+    uint64_t KnownAlignment() const;
+    bool IsAlignedTo(uint64_t bytes) const { return !empty && KnownAlignment() % bytes == 0; }
+
+    Alignment Join(const Alignment& other) const;
+    // 加上字节偏移（取值范围 bytes 的同余部分）
+    Alignment Offset(const ValueRange& bytes) const;
+
+    bool operator==(const Alignment& other) const
+    {
+        return empty == other.empty && align == other.align && offset == other.offset;
+    }
+    bool operator!=(const Alignment& other) const { return !(*this == other); }
+
+    // "32"、"32+4"（地址 ≡ 4 mod 32）、"empty"
+    std::string ToString() const;
+};
+
+// ============================================
+// 分析器（按函数缓存局部指针变量的对齐）
+// ============================================
+class AlignmentAnalysis {
+public:
+    AlignmentAnalysis(clang::ASTContext& ctx, const CPGContext* cpgCtx);
+    ~AlignmentAnalysis();
+
+    // 指针右值的对齐（数组名按退化后的首元素地址）
+    Alignment GetPointerAlignment(const clang::Expr* pointer);
+
+    // 左值对象的地址对齐
+    Alignment GetObjectAlignment(const clang::Expr* lvalue);
+
+    // 访问表达式（a[i]、*p、p->f）在所有执行中的地址对齐，下标取值域分析的结果
+    Alignment GetAccessAlignment(const clang::Expr* access);
+
+    // 循环首次迭代时访问地址的对齐：下标中的 iv 取进入循环时的值，其余部分取其全部取值
+    Alignment GetLoopEntryAlignment(const clang::Expr* access, const clang::Stmt* loopStmt,
+                                    const clang::VarDecl* iv);
+
+    // 丢弃函数的局部变量结果（与 CPGContext::ReleaseFunction 同步）
+    void Release(const clang::FunctionDecl* func);
+
+private:
+    // 局部指针变量的一个定义；各字段都为空表示形参的入口值
+    struct Definition {
+        const clang::Expr* value = nullptr;     // 初始化/赋值的指针值
+        const clang::Expr* delta = nullptr;     // p += delta（元素个数）
+        bool subtract = false;                  // p -= delta
+        int64_t step = 0;                       // ++/--：±1 个元素
+        uint64_t aligned = 0;                   // posix_memalign(&p, A, n) 给出的对齐
+    };
+
+    struct FunctionFacts {
+        bool solving = false;
+        std::map<const clang::VarDecl*, std::vector<Definition>> definitions;   // 只含跟踪的变量
+        std::map<const clang::VarDecl*, Alignment> vars;
+    };
+
+    clang::ASTContext& astContext;
+    const CPGContext* cpgContext;
+    std::map<const clang::FunctionDecl*, std::unique_ptr<FunctionFacts>> functions;
+
+    // 翻译单元内的直接调用点与取过地址的函数（首次查询形参时收集）
+    bool callSitesCollected = false;
+    std::map<const clang::FunctionDecl*, std::vector<const clang::CallExpr*>> callSites;
+    std::set<const clang::FunctionDecl*> addressTaken;
+    std::set<const clang::ParmVarDecl*> paramsInProgress;
+
+    const clang::FunctionDecl* solvingFunc = nullptr;   // 正在求不动点的函数
+    int depth = 0;                                      // 表达式递归深度
+
+    FunctionFacts* FactsFor(const clang::FunctionDecl* func);
+    void Solve(const clang::FunctionDecl* func, FunctionFacts& facts);
+    void CollectCallSites();
+
+    Alignment VarAlignment(const clang::VarDecl* var);
+    Alignment ParamAlignment(const clang::ParmVarDecl* param);
+    Alignment CallAlignment(const clang::CallExpr* call);
+    Alignment NewAlignment(const clang::CXXNewExpr* newExpr);
+    Alignment TypeAlignment(clang::QualType pointee) const;
+    Alignment WithTypeAlignment(const Alignment& value, clang::QualType type) const;
+    Alignment AddElements(const Alignment& base, const clang::Expr* count, clang::QualType pointee,
+                          bool subtract);
+    Alignment DefinitionAlignment(const clang::VarDecl* var, const Definition& def);
+
+    uint64_t MallocAlignment() const;
+    bool EvaluateAlign(const clang::Expr* expr, uint64_t& value) const;
+    ValueRange IndexRange(const clang::Expr* index);
+    ValueRange EntryIndexRange(const clang::Expr* index, const clang::VarDecl* iv, const ValueRange& ivEntry);
+};
+
+} // namespace cpg
+
+#endif // CPG_ALIGNMENT_ANALYSIS_H
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * AnalysisPipeline.h - 从锚点到导出的分阶段流水线（内存受限）
+ *
+ * 逐函数分析时整个翻译单元的 CPG 一直保留到 HandleTranslationUnit 结束，大翻译单元的
+ * 峰值内存可达数十GB。这里把分析拆成四个阶段，阶段之间用有界队列连接：
+ *   发现（BuildCPG + 锚点查找/分簇） → 构建（每簇一次） → 去重/合并（函数的簇全部完成后） → 导出
+ * 单线程按“下游优先”调度：
+ *   - 【修改】发现函数前按需构建其引用集合（自身、calleeDepth 层以内的被调用者、callerDepth 层
+ *     以内的调用者）的ICFG，不再预先构建整个翻译单元的ICFG
+ *   - 队首函数的簇全部构建完成即合并并导出
+ *   - 簇队列未满且内存未超预算时提前发现后续函数，否则继续构建
+ *   - 函数导出后，引用它的函数都已导出（构建器内联与跨函数回溯都不会再访问它）时释放其 CPG 数据
+ *   - 超过 maxRSSBytes 时停止发现，先排空下游并释放；排空后仍超预算则每次只接纳一个函数
+ */
+#ifndef COMPUTE_GRAPH_ANALYSIS_PIPELINE_H
+#define COMPUTE_GRAPH_ANALYSIS_PIPELINE_H
+
+#include "ComputeGraph.h"
+#include "ComputeGraphAnchor.h"
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace compute_graph {
+
+struct PipelineOptions {
+    size_t maxQueuedClusters = 64;  // 簇队列容量；单个函数的簇数超过容量时等队列排空再接纳
+    size_t maxRSSBytes = 0;         // 常驻内存预算，0表示不限制
+    // 【新增】导出后释放不再被引用的CPG数据；释放与否输出完全一致
+    bool releaseFunctions = true;
+    // 【修改】引用深度（调用图跳数，分方向）：被调用者须覆盖构建器的内联深度，
+    // 调用者须覆盖跨函数回溯深度
+    int calleeDepth = 1;
+    int callerDepth = 1;
+};
+
+struct PipelineStats {
+    size_t functions = 0;           // 已导出的函数
+    size_t skippedFunctions = 0;    // 发现阶段放弃的函数
+    size_t clustersBuilt = 0;
+    size_t releasedFunctions = 0;   // 释放了CPG数据的函数
+    size_t backpressureStalls = 0;  // 因超出内存预算暂停发现的次数
+    size_t peakQueuedClusters = 0;
+    size_t peakRSSBytes = 0;
+    size_t peakLiveFunctions = 0;   // 【新增】同时持有ICFG的函数数峰值
+};
+
+// 一个函数的构建结果（去重/合并后交给导出阶段）
+struct PipelineFunctionResult {
+    const clang::FunctionDecl* func = nullptr;
+    ComputeGraphSet graphSet;
+    size_t builtGraphs = 0;         // 去重/合并前的图数
+    int anchorCount = 0;            // 产出非空图的簇内锚点数
+};
+
+class AnalysisPipeline {
+public:
+    // 发现：构建CPG并产出锚点簇；返回false表示跳过该函数（不进入后续阶段）
+    using DiscoverFn = std::function<bool(const clang::FunctionDecl*, std::vector<AnchorCluster>&)>;
+    // 构建：同一函数的簇按发现顺序连续到达
+    using BuildFn = std::function<std::shared_ptr<ComputeGraph>(const AnchorCluster&)>;
+    using ExportFn = std::function<void(PipelineFunctionResult&)>;
+    // 【新增】合并阶段对每个合并产生的图重新分析（见 ComputeGraphBuilder::ReanalyzeMerged）
+    using ReanalyzeFn = std::function<void(ComputeGraph&)>;
+
+    AnalysisPipeline(cpg::CPGContext& cpgCtx, const PipelineOptions& options);
+
+    void Run(const std::vector<const clang::FunctionDecl*>& functions,
+             const DiscoverFn& discover, const BuildFn& build, const ExportFn& exportFn,
+             const ReanalyzeFn& reanalyze = nullptr);
+
+    const PipelineStats& GetStats() const { return stats; }
+
+private:
+    struct PendingFunction {
+        size_t remainingClusters = 0;
+        PipelineFunctionResult result;
+    };
+    struct QueuedCluster {
+        PendingFunction* owner = nullptr;
+        AnchorCluster cluster;
+    };
+
+    cpg::CPGContext& cpgContext;
+    PipelineOptions options;
+    PipelineStats stats;
+
+    std::deque<std::unique_ptr<PendingFunction>> inFlight;     // 按发现顺序
+    std::deque<QueuedCluster> clusterQueue;
+
+    // 规范声明 -> 尚未导出且引用它的函数数（自身 + 引用深度以内的被调用者/调用者）
+    std::map<const clang::FunctionDecl*, size_t> references;
+    std::map<const clang::FunctionDecl*, std::vector<const clang::FunctionDecl*>> referencedBy;
+    bool stalled = false;
+
+    void CountReferences(const std::vector<const clang::FunctionDecl*>& functions);
+    bool CanAdmit();
+    bool OverBudget();
+    void Discover(const clang::FunctionDecl* func, const DiscoverFn& discover);
+    void BuildNext(const BuildFn& build);
+    void MergeAndExport(const ExportFn& exportFn, const ReanalyzeFn& reanalyze);
+    void Finish(const clang::FunctionDecl* func);
+};
+
+// 当前常驻内存（字节）：Linux 读 /proc/self/statm，其他平台以 malloc 用量近似
+size_t CurrentResidentBytes();
+
+// 【新增】进程生命周期内的常驻内存峰值（字节）：Linux 读 /proc/self/status 的 VmHWM，
+// 其他平台返回 0（不可测）
+size_t PeakResidentBytes();
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_ANALYSIS_PIPELINE_H
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * AnalysisRegistry.h - 跨翻译单元的“已分析”登记表
+ *
+ * 头文件中定义的内核会被每个包含它的翻译单元重复构建、重复报告。
+ * 这里用与翻译单元无关的稳定标识登记已经分析过的函数与锚点：
+ *   (文件真实路径, 函数USR, 文件内偏移, 宏内拼写位置)
+ * 函数的偏移取函数体起点，锚点的偏移取锚点语句起点（宏展开取展开位置）。
+ * 同一次宏展开产生的锚点展开位置相同，再用拼写位置（宏定义或实参中的文件+偏移）区分。
+ * 同一进程内的多个翻译单元共享内存中的登记表；指定登记文件后，
+ * 批处理的多个进程通过追加写同一文件共享（每条记录一次 write，O_APPEND 保证不交错）。
+ * 两个进程同时登记同一标识时可能各自分析一次，只会多做，不会漏做。
+ */
+#ifndef COMPUTE_GRAPH_ANALYSIS_REGISTRY_H
+#define COMPUTE_GRAPH_ANALYSIS_REGISTRY_H
+
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/Stmt.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+namespace llvm {
+class raw_fd_ostream;
+}
+
+namespace compute_graph {
+
+struct AnalysisIdentity {
+    std::string file;               // 真实路径
+    std::string usr;
+    unsigned offset = 0;
+    std::string spelling;           // 【新增】宏展开中的拼写位置 "真实路径:偏移"，非宏为空
+
+    bool IsValid() const { return !file.empty() && !usr.empty(); }
+    std::string Key() const;
+};
+
+// anchor 为空时取函数体起点；无法生成USR或定位文件时返回无效标识
+AnalysisIdentity MakeAnalysisIdentity(const clang::FunctionDecl* func, const clang::Stmt* anchor,
+                                      clang::ASTContext& ctx);
+
+class AnalysisRegistry {
+public:
+    AnalysisRegistry();
+    ~AnalysisRegistry();
+
+    // 绑定共享登记文件（不存在则创建）并读入已有记录；失败时输出原因并返回false
+    bool OpenFile(const std::string& path);
+
+    // 读入其他进程追加的新记录（未绑定文件时不做任何事）
+    void Refresh();
+
+    bool IsAnalyzed(const AnalysisIdentity& identity) const;
+
+    // 登记标识；已被登记（本进程或其他进程）时返回false。无效标识总是返回true（不参与去重）
+    bool Claim(const AnalysisIdentity& identity);
+
+    size_t ClaimedCount() const { return claimed; }
+    size_t SkippedCount() const { return skipped; }
+    void CountSkipped(size_t n) { skipped += n; }
+
+private:
+    std::unordered_set<std::string> keys;
+    std::string filePath;
+    uint64_t readOffset = 0;
+    std::unique_ptr<llvm::raw_fd_ostream> appendStream;
+    size_t claimed = 0;
+    size_t skipped = 0;
+};
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_ANALYSIS_REGISTRY_H
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * AnchorProfile.h - 锚点排序用的执行剖析数据（profile-guided ranking）
+ *
+ * 支持三种本地文本格式（自动识别）：
+ * 1. perf script 输出（需带 srcline 字段，如 perf script -F ip,sym,srcline）
+ * 2. gcov 文本（由 .gcda 生成的 *.gcov 行计数文件）
+ * 3. llvm-profdata show 文本（--sample 行偏移格式 / 插桩格式函数计数）
+ */
+#ifndef COMPUTE_GRAPH_ANCHOR_PROFILE_H
+#define COMPUTE_GRAPH_ANCHOR_PROFILE_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace compute_graph {
+
+// ============================================
+// 执行剖析数据
+// ============================================
+class AnchorProfile {
+public:
+    enum class Format {
+        Unknown,
+        PerfScript,
+        Gcov,
+        LLVMProfdata
+    };
+
+    // 从本地文件加载，失败返回false（不影响纯静态排序）
+    bool LoadFromFile(const std::string& path);
+
+    // 查询某一源码行的热度，归一化到[0, 1]
+    // 优先按文件+行号匹配（文件按规范化路径，找不到时按最长的路径分量后缀唯一匹配）；
+    // 缺失时按函数内行偏移、再按函数计数回退
+    double GetHotness(const std::string& fileName, int line,
+                      const std::string& funcName, int funcStartLine) const;
+
+    bool IsEmpty() const { return maxCount == 0 && maxFuncCount == 0; }
+    Format GetFormat() const { return format; }
+    std::string GetPath() const { return path; }
+    size_t LineCount() const;
+    void Clear();
+
+private:
+    Format format = Format::Unknown;
+    std::string path;
+
+    // 【修改】规范化路径（能解析时取真实路径） -> 行号 -> 计数
+    std::map<std::string, std::map<int, uint64_t>> lineCounts;
+    // 查询文件名 -> 匹配到的 lineCounts 项（nullptr 表示无匹配），避免每个锚点重复解析路径
+    mutable std::map<std::string, const std::map<int, uint64_t>*> fileMatchCache;
+    // 函数名 -> 相对函数起始行的偏移 -> 计数（llvm-profdata --sample）
+    std::map<std::string, std::map<int, uint64_t>> funcOffsetCounts;
+    // 函数名 -> 函数入口计数（llvm-profdata 插桩格式）
+    std::map<std::string, uint64_t> funcCounts;
+
+    uint64_t maxCount = 0;
+    uint64_t maxFuncCount = 0;
+
+    static Format DetectFormat(const std::string& content);
+    static std::string NormalizePath(const std::string& file);
+
+    const std::map<int, uint64_t>* FindFileLines(const std::string& fileName) const;
+
+    void ParsePerfScript(const std::string& content);
+    void ParseGcov(const std::string& content);
+    void ParseLLVMProfdata(const std::string& content);
+
+    void AddLineCount(const std::string& file, int line, uint64_t count);
+    void AddOffsetCount(const std::string& func, int offset, uint64_t count);
+};
+
+std::string AnchorProfileFormatToString(AnchorProfile::Format format);
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_ANCHOR_PROFILE_H
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * ArrayDependenceAnalysis.h - 数组访问依赖测试（GCD / Banerjee / strong SIV）
+ *
+ * 对图中同一数组、同一循环嵌套内的访问两两做依赖测试，输出方向/距离向量：
+ *   - 同一迭代内的依赖 -> Memory 边
+ *   - 跨迭代的依赖     -> LoopCarried 边
+ * 边属性：dep_kind (flow/anti/output)、direction、distance、dep_test、inner_carried
+ * 【新增】给定 CPGContext 且开启指针分析时，基址不同但可能别名的访问（如指针形参 x、y）
+ *         也成对测试，无法比较下标，按任意方向依赖处理（dep_test = may-alias）
+ */
+#ifndef COMPUTE_GRAPH_ARRAY_DEPENDENCE_ANALYSIS_H
+#define COMPUTE_GRAPH_ARRAY_DEPENDENCE_ANALYSIS_H
+
+#include "ComputeGraph.h"
+#include "LoopInductionAnalysis.h"
+
+#include <string>
+#include <vector>
+
+namespace compute_graph {
+
+// 单层循环上的依赖方向（位集合）
+enum DependenceDirection : unsigned {
+    DirNone = 0,
+    DirLess = 1,        // 源迭代早于汇迭代 (<)
+    DirEqual = 2,       // 同一迭代 (=)
+    DirGreater = 4,     // 源迭代晚于汇迭代 (>)
+    DirAll = DirLess | DirEqual | DirGreater
+};
+
+// 【新增】依赖类别对内层向量化的限制程度：flow > output > anti > none（合并图时取较严者）
+int DependenceRank(const std::string& kind);
+
+// ============================================
+// 一对访问之间的依赖
+// ============================================
+struct ArrayDependence {
+    bool independent = false;
+    std::string test;                       // 证明/刻画依赖所用的测试
+    std::vector<unsigned> directions;       // 公共循环由外到内，每层的方向集合
+    std::vector<int64_t> distances;         // 每层距离（汇迭代-源迭代）
+    std::vector<bool> distanceKnown;
+
+    // 方向向量 "(=,<)"、距离向量 "(0,1)"，未知距离为 "*"
+    std::string DirectionString(bool reversed = false) const;
+    std::string DistanceString(bool reversed = false) const;
+};
+
+// ============================================
+// 依赖分析器
+// ============================================
+class ArrayDependenceAnalyzer {
+public:
+    ArrayDependenceAnalyzer(clang::ASTContext& ctx, LoopInductionAnalysis& induction,
+                            const cpg::CPGContext* cpgCtx = nullptr);
+
+    // 为图中的ArrayAccess节点添加Memory/LoopCarried边，并写入图级摘要属性
+    void Run(ComputeGraph& graph);
+
+private:
+    struct AccessInfo {
+        ComputeNode::NodeId nodeId = 0;
+        const clang::ArraySubscriptExpr* expr = nullptr;
+        const clang::ValueDecl* array = nullptr;
+        std::string arrayText;                    // 基址源码文本（区分不同对象的同名成员）
+        bool isWrite = false;
+        bool isRead = true;
+        const clang::Stmt* writeStmt = nullptr;   // 写入该访问的赋值/自增语句
+        std::vector<const clang::Stmt*> nest;     // 由内到外
+        NestedIndexForm index;
+    };
+
+    clang::ASTContext& astContext;
+    LoopInductionAnalysis& inductionAnalysis;
+    const cpg::CPGContext* cpgContext;
+
+    bool CollectAccess(const ComputeNode& node, AccessInfo& info);
+    const clang::ValueDecl* GetArrayDecl(const clang::ArraySubscriptExpr* expr) const;
+    void ClassifyReadWrite(const clang::ArraySubscriptExpr* expr, AccessInfo& info) const;
+    bool ExecutesBefore(const AccessInfo& a, const AccessInfo& b) const;
+    bool MayAliasBases(const AccessInfo& a, const AccessInfo& b) const;
+
+    ArrayDependence Test(const AccessInfo& src, const AccessInfo& dst,
+                         const std::vector<const clang::Stmt*>& commonNest);
+};
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_ARRAY_DEPENDENCE_ANALYSIS_H
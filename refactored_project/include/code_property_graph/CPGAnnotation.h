@@ -5,7 +5,11 @@
 #ifndef CPG_ANNOTATION_V2_H
 #define CPG_ANNOTATION_V2_H
 
+#include "code_property_graph/AlignmentAnalysis.h"
 #include "code_property_graph/CPGBase.h"
+#include "code_property_graph/PathFeasibility.h"
+#include "code_property_graph/PointsToAnalysis.h"
+#include "code_property_graph/ValueRangeAnalysis.h"
 #include "clang/Basic/SourceManager.h"  // 必须包含，用于 isInSystemHeader
 
 namespace cpg {
@@ -81,6 +85,43 @@ public:
     void BuildCPG(const clang::FunctionDecl* func);
     void BuildICFGForTranslationUnit();
 
+    // 【新增】只构建全翻译单元的调用图（不构建ICFG）；之后由 BuildCPG/BuildICFGFor 按需构建
+    // 单个函数的ICFG，并与两端都已构建的调用点相连
+    void BuildCallGraphForTranslationUnit();
+    // 【新增】按需构建函数的ICFG（不做到达定值与PDG），已构建时不重复构建
+    void BuildICFGFor(const clang::FunctionDecl* func);
+    // 【新增】当前持有ICFG的函数数
+    size_t GetBuiltFunctionCount() const { return funcEntries.size(); }
+
+    // 【修改】直接被调用者 / 直接调用者（规范化声明，不含自身）
+    std::set<const clang::FunctionDecl*> GetCallees(const clang::FunctionDecl* func) const;
+    std::set<const clang::FunctionDecl*> GetCallers(const clang::FunctionDecl* func) const;
+
+    // 【新增】释放函数的 ICFG/CFG/PDG/到达定值数据，与其他函数之间的ICFG边一并断开
+    // 释放后针对该函数的查询返回空结果（首次查询时告警）；调用图保留。返回是否释放了数据
+    bool ReleaseFunction(const clang::FunctionDecl* func);
+    // 【新增】函数的CPG数据是否已被释放（重新 BuildCPG 后清除）
+    bool IsReleased(const clang::FunctionDecl* func) const;
+
+    // 【新增】调用点的被调函数（规范化声明），未登记返回空
+    const clang::FunctionDecl* GetCallTarget(const clang::CallExpr* call) const;
+
+    // ============================================
+    // 【新增】指针分析接口（全翻译单元，首次查询时构建）
+    // ============================================
+    void SetPointsToMode(PointsToMode mode);
+    PointsToMode GetPointsToMode() const { return pointsToMode; }
+    PointsToAnalysis& GetPointsToAnalysis() const;
+
+    // 两个表达式可能访问重叠的内存；未开启指针分析时恒为 true
+    bool MayAlias(const clang::Expr* a, const clang::Expr* b) const;
+
+    // 【新增】整型值域分析（按函数惰性分析，ReleaseFunction 时一并丢弃）
+    ValueRangeAnalysis& GetValueRanges() const;
+
+    // 【新增】指针/访问地址的对齐分析（局部变量按函数缓存，ReleaseFunction 时一并丢弃）
+    AlignmentAnalysis& GetAlignment() const;
+
     // ============================================
     // 数据流分析接口
     // ============================================
@@ -212,7 +253,8 @@ public:
         const std::vector<std::unique_ptr<ICFGNode>>& nodes,
         const clang::CallExpr* call) const;
 
-    void RegisterCallSite(clang::CallExpr* call);
+    // caller：调用点所在的函数定义（遍历时记录），不参与分析的函数中的调用点只登记被调函数
+    void RegisterCallSite(clang::CallExpr* call, const clang::FunctionDecl* caller);
 
 private:
     clang::ASTContext& astContext;
@@ -233,9 +275,26 @@ private:
     // CFG缓存
     std::map<const clang::FunctionDecl*, std::unique_ptr<clang::CFG>> cfgCache;
 
+    // 【新增】已释放CPG数据的函数（规范化声明）及已告警过的函数
+    std::set<const clang::FunctionDecl*> releasedFunctions;
+    mutable std::set<const clang::FunctionDecl*> releasedQueryWarned;
+
     // 调用图
     std::map<const clang::FunctionDecl*, std::set<const clang::CallExpr*>> callSites;
     std::map<const clang::CallExpr*, const clang::FunctionDecl*> callTargets;
+    // 【新增】参与分析的函数（规范化声明）与已连接ICFG调用/返回边的调用点
+    std::set<const clang::FunctionDecl*> callGraphFunctions;
+    std::set<const clang::CallExpr*> linkedCalls;
+
+    // 【新增】指针分析（与 CPG 数据无关，ReleaseFunction 不影响）
+    PointsToMode pointsToMode = PointsToMode::Steensgaard;
+    mutable std::unique_ptr<PointsToAnalysis> pointsTo;
+
+    // 【新增】值域分析
+    mutable std::unique_ptr<ValueRangeAnalysis> valueRanges;
+
+    // 【新增】对齐分析
+    mutable std::unique_ptr<AlignmentAnalysis> alignment;
 
     // 预留：上下文敏感分析
     std::map<CallContext, std::unique_ptr<PDGNode>> contextSensitivePDG;
@@ -245,6 +304,9 @@ private:
     void BuildICFG(const clang::FunctionDecl* func);
     void BuildCallGraph();
     void LinkCallSites();
+    // 【新增】连接 func 作为调用者或被调用者、两端ICFG都已构建的未连接调用点
+    void LinkCallSitesOf(const clang::FunctionDecl* func);
+    std::vector<const clang::FunctionDecl*> CollectTranslationUnitFunctions() const;
     ICFGNode* CreateICFGNode(ICFGNodeKind kind, const clang::FunctionDecl* func);
     void AddICFGEdge(ICFGNode* from, ICFGNode* to, ICFGEdgeKind kind);
 
@@ -309,6 +371,11 @@ private:
 
     void ExportICFGWithCalleesDotFile(const clang::FunctionDecl* func,
                                        const std::string& filename) const;
+    void ExportICFGCollapsedCallees(
+        llvm::raw_fd_ostream& out,
+        const clang::FunctionDecl* func,
+        const std::set<const clang::FunctionDecl*>& funcsToInclude,
+        const std::string& filename) const;
     void ExportPDGDotFile(const clang::FunctionDecl* func,
                           const std::string& filename) const;
     void AssignGlobalNodeIdsForCPG(
@@ -521,19 +588,29 @@ private:
         std::queue<const clang::Stmt*>& worklist,
         std::set<const clang::Stmt*>& visited) const;
 
+    // 【新增】路径枚举时沿途记录的分支条件
+    struct PathSearchState {
+        explicit PathSearchState(clang::ASTContext* ctx) : checker(ctx) {}
+        PathCondition path;
+        PathFeasibilityChecker checker;
+        bool recording = true;      // 经过调用/返回边后停止记录
+    };
+
     void ExploreSuccessors(
         ICFGNode* node, ICFGNode* sink,
         int depth, int maxDepth,
         std::vector<ICFGNode*>& currentPath,
         std::set<ICFGNode*>& visited,
-        std::vector<std::vector<ICFGNode*>>& allPaths) const;
+        std::vector<std::vector<ICFGNode*>>& allPaths,
+        PathSearchState& state) const;
 
     void FindPathsDFS(
         ICFGNode* node, ICFGNode* sink,
         int depth, int maxDepth,
         std::vector<ICFGNode*>& currentPath,
         std::set<ICFGNode*>& visited,
-        std::vector<std::vector<ICFGNode*>>& allPaths) const;
+        std::vector<std::vector<ICFGNode*>>& allPaths,
+        PathSearchState& state) const;
 
     void ExtractDefinedVarFromAssignment(
         const clang::BinaryOperator* binOp,
@@ -563,6 +640,7 @@ class CallGraphBuilder : public clang::RecursiveASTVisitor<CallGraphBuilder> {
 public:
     CPGContext& ctx;
     clang::SourceManager* sourceManager;
+    const clang::FunctionDecl* currentFunc = nullptr;  // 【新增】正在遍历的函数定义（lambda 体内为空）
 
     explicit CallGraphBuilder(CPGContext& c)
         : ctx(c), sourceManager(nullptr) {}
@@ -601,9 +679,28 @@ public:
             return true;
         }
 
+        // 【新增】记录调用点所在的函数，调用图不再依赖已构建的ICFG
+        auto* func = llvm::dyn_cast<clang::FunctionDecl>(D);
+        if (func && func->doesThisDeclarationHaveABody()) {
+            const clang::FunctionDecl* saved = currentFunc;
+            currentFunc = func;
+            bool result = clang::RecursiveASTVisitor<CallGraphBuilder>::TraverseDecl(D);
+            currentFunc = saved;
+            return result;
+        }
         return clang::RecursiveASTVisitor<CallGraphBuilder>::TraverseDecl(D);
     }
 
+    // 【新增】lambda 体不属于外层函数的CFG，其中的调用点不归外层函数
+    bool TraverseLambdaExpr(clang::LambdaExpr* lambda)
+    {
+        const clang::FunctionDecl* saved = currentFunc;
+        currentFunc = nullptr;
+        bool result = clang::RecursiveASTVisitor<CallGraphBuilder>::TraverseLambdaExpr(lambda);
+        currentFunc = saved;
+        return result;
+    }
+
     // 控制类型遍历，避免进入复杂模板。 跳过类型遍历，我们只关心调用表达式
     bool TraverseType(clang::QualType T)
     {
@@ -634,7 +731,7 @@ public:
             }
         }
 
-        ctx.RegisterCallSite(call);
+        ctx.RegisterCallSite(call, currentFunc);
         return true;
     }
 };
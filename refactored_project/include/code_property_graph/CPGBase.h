@@ -143,7 +143,7 @@ public:
 };
 
 // ============================================
-// 路径条件（预留用于路径敏感分析）
+// 路径条件（路径敏感分析）
 // ============================================
 class PathCondition {
 public:
@@ -154,6 +154,7 @@ public:
         conditions.push_back({cond, value});
     }
 
+    // 【修改】整数比较的区间/差分约束判定（见 PathFeasibility.h），无法建模的条件视为成立
     bool IsFeasible() const;
     std::string ToString() const;
 };
@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 #include <functional>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -29,6 +30,10 @@
 
 namespace compute_graph {
 
+struct IntrinsicInfo;
+class CostModel;
+class LoopInductionAnalysis;
+
 // ============================================
 // 计算图节点
 // ============================================
@@ -156,6 +161,10 @@ public:
     EdgePtr GetEdge(ComputeEdge::EdgeId id) const;
     void RemoveEdge(ComputeEdge::EdgeId id);
 
+    // 【新增】是否已存在 (src, tgt, kind, label) 完全相同的边；哈希查找，不分配内存
+    bool HasEdge(ComputeNode::NodeId src, ComputeNode::NodeId tgt,
+                 ComputeEdgeKind kind, const std::string& label) const;
+
     // 获取节点的输入/输出边
     std::vector<EdgePtr> GetIncomingEdges(ComputeNode::NodeId nodeId) const;
     std::vector<EdgePtr> GetOutgoingEdges(ComputeNode::NodeId nodeId) const;
@@ -211,8 +220,15 @@ public:
     // ========================================
     void ExportDotFile(const std::string& filename) const;
     void ExportDotFileEnhanced(const std::string& filename) const;
+    // 【新增】分层导出：节点数超过 flatThreshold 时把被调函数体/循环体/分支区域折叠为摘要节点，
+    // filename 写总览，<filename去掉.dot>.c<k>.dot 写第k个簇的下钻视图；
+    // 未超过阈值（或阈值为0）时等同 ExportDotFile。返回写出的文件数
+    size_t ExportDotFileLOD(const std::string& filename, size_t flatThreshold) const;
     void Dump() const;
     void PrintSummary() const;
+    // 【新增】规范化文本转储（回归测试的黄金输出）：节点按源码位置/类型/名称排序后
+    // 重新编号，边与循环/分支上下文引用新编号，属性按键排序；与节点ID分配顺序无关
+    void DumpCanonical(llvm::raw_ostream& os) const;
 
     // ========================================
     // 属性
@@ -220,6 +236,12 @@ public:
     void SetProperty(const std::string& key, const std::string& value);
     std::string GetProperty(const std::string& key) const;
     bool HasProperty(const std::string& key) const;
+    void RemoveProperty(const std::string& key) { properties.erase(key); }
+    const std::map<std::string, std::string>& GetProperties() const { return properties; }
+
+    // 【新增】惯用法位掩码（IdiomRecognizer 写入，常数时间查询）
+    unsigned GetIdiomMask() const { return idiomMask; }
+    void SetIdiomMask(unsigned mask) { idiomMask = mask; }
 
 private:
     std::string name;
@@ -229,16 +251,39 @@ private:
     std::map<ComputeNode::NodeId, NodePtr> nodes;
     std::map<ComputeEdge::EdgeId, EdgePtr> edges;
 
-    // 快速查找映射
-    std::map<const clang::Stmt*, ComputeNode::NodeId> stmtToNode;
+    // 快速查找映射（stmtToNode 按需由节点的 astStmt 重建，见 FindNodeByStmt）
+    mutable std::map<const clang::Stmt*, ComputeNode::NodeId> stmtToNode;
+    mutable ComputeNode::NodeId stmtIndexStamp = 0;
     std::map<std::string, ComputeNode::NodeId> nameToNode;
 
     // 邻接表
     std::map<ComputeNode::NodeId, std::vector<ComputeEdge::EdgeId>> inEdges;
     std::map<ComputeNode::NodeId, std::vector<ComputeEdge::EdgeId>> outEdges;
 
+    // 【新增】边存在性索引：(src, tgt, kind, 标签编号) -> 该组合的边数
+    struct EdgeKey {
+        ComputeNode::NodeId src = 0;
+        ComputeNode::NodeId tgt = 0;
+        uint32_t kind = 0;
+        uint32_t labelId = 0;
+
+        bool operator==(const EdgeKey& other) const
+        {
+            return src == other.src && tgt == other.tgt &&
+                   kind == other.kind && labelId == other.labelId;
+        }
+    };
+    struct EdgeKeyHash {
+        size_t operator()(const EdgeKey& key) const;
+    };
+    std::unordered_map<std::string, uint32_t> edgeLabelIds;     // 边标签驻留表
+    std::unordered_map<EdgeKey, uint32_t, EdgeKeyHash> edgeKeyCounts;
+
+    EdgeKey MakeEdgeKey(const ComputeEdge& edge);
+
     // 图属性
     std::map<std::string, std::string> properties;
+    unsigned idiomMask = 0;
 
     // 辅助方法
     void UpdateAdjacencyLists(EdgePtr edge);
@@ -247,9 +292,12 @@ private:
     std::string GetEdgeDotStyle(const EdgePtr& edge) const;
 
     // 详细可视化辅助方法
+    static constexpr size_t kDotWriteBufferSize = 1 << 20;
+    std::map<const clang::FunctionDecl*, std::string> AssignFunctionColors() const;
     void WriteDetailedNode(llvm::raw_fd_ostream& out, const NodePtr& node,
                            const std::map<const clang::FunctionDecl*, std::string>& funcColors) const;
     std::string GetDetailedEdgeStyle(const EdgePtr& edge) const;
+    void WriteDetailedEdgeStyle(llvm::raw_ostream& out, const EdgePtr& edge) const;
 
     // 增强可视化辅助方法
     void WriteNodeDotEnhanced(llvm::raw_fd_ostream& out, const NodePtr& node) const;
@@ -276,12 +324,18 @@ public:
     // 去重：移除同构图
     void Deduplicate();
 
-    // 合并可合并的图
-    void MergeOverlapping();
+    // 合并可合并的图；reanalyze 非空时对每个合并产生的图重新做依赖/迭代次数分析
+    void MergeOverlapping(const std::function<void(ComputeGraph&)>& reanalyze = nullptr);
 
-    // 按评分排序
+    // 按评分排序（已标注向量化收益时可向量化的图在前，再按预估加速比、锚点评分）
     void SortByScore();
 
+    // 【新增】用代价模型为每个图标注 cost_* 属性
+    void ApplyCostModel(const CostModel& model);
+
+    // 【新增】移除不可向量化或预估加速比低于阈值的图，返回移除数量
+    size_t PruneUnprofitable(double minSpeedup);
+
     size_t Size() const { return graphs.size(); }
     void Clear() { graphs.clear(); }
 
@@ -295,6 +349,52 @@ private:
     std::vector<GraphPtr> graphs;
 };
 
+// ============================================
+// 【新增】节点源码区间索引
+// 按 (FileID, 文件内偏移) 为图中节点建立有序索引，用于"某语句区间内有哪些节点"的查询
+// （循环体/分支体成员判定），代替逐节点比较行号：
+//   - 查询代价 O(log N + K)，不再是 O(N)
+//   - 以字符偏移而非行号判定，同一行上的 then/else、单行循环体不会互相误判
+// 节点只增不改位置，索引随图增量同步；已删除的节点在查询时跳过
+// ============================================
+class SourceRegionIndex {
+public:
+    // 文件内的闭区间 [begin, end]（宏展开按 getFileLoc 归一）
+    struct Region {
+        clang::FileID file;
+        unsigned begin = 0;
+        unsigned end = 0;
+        bool IsValid() const { return file.isValid() && begin <= end; }
+    };
+
+    explicit SourceRegionIndex(const clang::SourceManager& sm) : sourceManager(sm) {}
+
+    // 切换到新图时调用
+    void Reset();
+
+    // 把 graph 中尚未索引的节点（ID 大于上次同步的最大ID）加入索引
+    void Sync(const ComputeGraph& graph);
+
+    Region GetRegion(const clang::Stmt* stmt) const;
+    Region GetRegion(clang::SourceLocation begin, clang::SourceLocation end) const;
+
+    // 节点起始位置；没有AST位置的节点返回false
+    bool GetNodeLocation(const ComputeNode& node, clang::FileID& file, unsigned& offset) const;
+
+    // 起始位置落在 region 内的节点，按偏移升序（先同步 graph）
+    std::vector<ComputeNode::NodeId> Query(const ComputeGraph& graph, const Region& region);
+
+    // 没有AST位置、无法进入区间索引的节点（调用方按行号回退判断）
+    const std::vector<ComputeNode::NodeId>& GetUnlocatedNodes() const { return unlocatedNodes; }
+
+private:
+    const clang::SourceManager& sourceManager;
+    const ComputeGraph* indexedGraph = nullptr;
+    ComputeNode::NodeId lastIndexedId = 0;
+    std::map<clang::FileID, std::multimap<unsigned, ComputeNode::NodeId>> offsets;
+    std::vector<ComputeNode::NodeId> unlocatedNodes;
+};
+
 
 // ============================================
 // 计算图构建器
@@ -306,16 +406,25 @@ public:
     // 从锚点构建计算图
     std::shared_ptr<ComputeGraph> BuildFromAnchor(const AnchorPoint& anchor);
 
+    // 【新增】从锚点簇构建计算图（一次构建覆盖同一循环内的所有锚点）
+    std::shared_ptr<ComputeGraph> BuildFromAnchorCluster(const AnchorCluster& cluster);
+
     // 从表达式构建计算图
     std::shared_ptr<ComputeGraph> BuildFromExpr(const clang::Expr* expr);
 
     // 从函数构建完整计算图
     std::shared_ptr<ComputeGraph> BuildFromFunction(const clang::FunctionDecl* func);
 
+    // 【新增】合并后的图：丢弃两侧的依赖边与摘要，重新提升迭代次数并重新做依赖测试
+    // （代价模型在导出前重新标注）
+    void ReanalyzeMerged(ComputeGraph& graph);
+
     ComputeNode::NodeId CreateDefinitionNode(
 const clang::Stmt* defStmt,
 const std::string& varName);
 
+    static constexpr int kDefaultMaxCallDepth = 3;
+
     // 配置
     void SetMaxBackwardDepth(int depth) { maxBackwardDepth = depth; }
     void SetMaxForwardDepth(int depth) { maxForwardDepth = depth; }
@@ -332,7 +441,7 @@ private:
 
     int maxBackwardDepth = 10;      // 最大向后追踪深度
     int maxForwardDepth = 5;        // 最大向前追踪深度
-    int maxCallDepth = 3;           // 最大函数调用深度
+    int maxCallDepth = kDefaultMaxCallDepth;  // 最大函数调用深度
     int maxExprDepth = 20;          // 最大表达式递归深度
     bool enableInterprocedural = true;  // 是否启用跨函数分析
 
@@ -366,6 +475,44 @@ private:
     // 当前正在构建的图
     std::shared_ptr<ComputeGraph> currentGraph;
 
+    // 【新增】currentGraph 节点的源码区间索引（循环体/分支体成员查询）
+    SourceRegionIndex regionIndex;
+
+    // 【新增】循环节点 -> 曾被设为该循环上下文的节点（由 AssignLoopContext 维护；
+    // 节点改属其他循环后旧条目失效，查询时按 loopContextId 过滤）
+    std::map<ComputeNode::NodeId, std::vector<ComputeNode::NodeId>> loopContextMembers;
+
+    // 【新增】union成员别名索引，键为 (union变量的规范声明, 调用点, 所在函数)
+    // 同一键下的成员互为别名；ConnectUnionAliases 只遍历同键成员，不再扫描全图比较字符串属性
+    // 【修复】所有成员访问节点在 CreateMemberAccessNode 中登记，键统一取规范 VarDecl
+    struct UnionAliasKey {
+        const clang::VarDecl* var = nullptr;        // union变量的规范声明（s.u.f 等取最外层变量）
+        ComputeNode::NodeId callSiteId = 0;         // 展开函数中局部变量所属调用点，0表示不在展开函数中
+        const clang::FunctionDecl* func = nullptr;  // 局部变量所在函数；全局变量两者都为空，跨函数互为别名
+
+        bool operator<(const UnionAliasKey& other) const
+        {
+            return std::tie(var, callSiteId, func) <
+                   std::tie(other.var, other.callSiteId, other.func);
+        }
+    };
+
+    struct UnionMemberEntry {
+        ComputeNode::NodeId nodeId = 0;
+        const clang::FieldDecl* field = nullptr;
+        bool isWriteTarget = false;
+        size_t connectedUpTo = 0;                   // 连别名边时同键已登记的成员数，0表示尚未连边
+    };
+
+    std::map<UnionAliasKey, std::vector<UnionMemberEntry>> unionAliasIndex;
+    std::map<ComputeNode::NodeId, std::pair<UnionAliasKey, size_t>> unionMemberSlots;
+    ComputeNode::NodeId expandingCallSiteId = 0;    // 正在展开的被调函数所属调用点
+
+    // 【新增】经指针/下标写入的语句及被写左值（按函数缓存），已追踪过别名写入的读取
+    std::map<const clang::FunctionDecl*,
+             std::vector<std::pair<const clang::Stmt*, const clang::Expr*>>> memoryStoreCache;
+    std::set<const clang::Expr*> aliasTracedLoads;
+
     // 【新增】循环信息结构体（定义在使用之前）
     struct LoopInfo {
         ComputeNode::NodeId loopNodeId = 0;
@@ -392,11 +539,25 @@ private:
         int branchLine = 0;                         // 分支所在行号
         int bodyStartLine = 0;                      // 分支体开始行
         int bodyEndLine = 0;                        // 分支体结束行
+        const clang::Stmt* bodyStmt = nullptr;      // 【新增】分支体语句（then/else/case内语句），按源码区间判定成员
     };
 
     // 【新增】当前分支上下文（用于标注分支内的节点）
     BranchInfo currentBranchContext;
 
+    // 【新增】外层分支的路径条件（由外到内），与之矛盾的 THEN/ELSE/case 不再构建
+    struct BranchPathEntry {
+        const clang::Stmt* bodyBegin = nullptr;     // 条件成立时执行的语句区间
+        const clang::Stmt* bodyEnd = nullptr;
+        const clang::Stmt* condition = nullptr;     // IfStmt 或 case/default 标签
+        bool value = true;
+    };
+    std::vector<BranchPathEntry> branchPath;
+    cpg::PathFeasibilityChecker feasibilityChecker;
+
+    // 只取源码上包含 stmt 的外层条件（回溯定义时可能跳到分支之外的语句）
+    bool IsBranchFeasible(const clang::Stmt* stmt, const clang::Stmt* condition, bool value);
+
     // 深入分析被调用函数
     void AnalyzeCalleeBody(const clang::FunctionDecl* callee,
                            ComputeNode::NodeId callNodeId,
@@ -466,6 +627,14 @@ private:
     void ProcessStatementChildren(const clang::Stmt* stmt, 
                                  ComputeNode::NodeId nodeId, int depth);
 
+    // 【新增】按 Stmt::getStmtClass() 分发的访问器（ConstStmtVisitor，编译期生成跳转表）
+    // NodeCreator 定义见 ComputeGraphBuilderNode.cpp，ChildProcessor 定义见 ComputeGraphBuilderProcess.cpp
+    class NodeCreator;
+    class ChildProcessor;
+
+    // 【新增】该类语句是否可能需要先构建外层控制流（字面量等叶子表达式不需要）
+    static bool MayNeedControlFlowLift(const clang::Stmt* stmt);
+
     // ============================================
     // CreateNodeFromStmt 辅助函数
     // ============================================
@@ -482,6 +651,10 @@ private:
     std::shared_ptr<ComputeNode> CreateArrayAccessNode(const clang::ArraySubscriptExpr* arrayExpr);
     std::shared_ptr<ComputeNode> CreateOperatorCallNode(const clang::CXXOperatorCallExpr* opCallExpr);
     std::shared_ptr<ComputeNode> CreateCallExprNode(const clang::CallExpr* callExpr);
+    // 【新增】intrinsic语义查询与标注
+    const IntrinsicInfo* LookupIntrinsic(const clang::CallExpr* callExpr,
+                                         const std::string& calleeName);
+    void ApplyIntrinsicSemantics(std::shared_ptr<ComputeNode> node, const IntrinsicInfo& info);
     std::shared_ptr<ComputeNode> CreateConstructorNode(const clang::CXXConstructExpr* ctorExpr);
     std::shared_ptr<ComputeNode> CreateMemberAccessNode(const clang::MemberExpr* memberExpr);
     std::shared_ptr<ComputeNode> CreateCastNode(const clang::CastExpr* castExpr, 
@@ -585,6 +758,20 @@ private:
     // 【新增】从for循环中提取循环变量名
     std::string ExtractLoopVarFromFor(const clang::ForStmt* forStmt);
 
+    // 【新增】循环归纳分析：为Loop节点创建LoopInduction节点并标注迭代次数，
+    // 为ArrayAccess节点标注仿射下标与每次迭代的访问步长
+    void AnnotateLoopInduction(LoopInductionAnalysis& analysis);
+
+    // 【新增】值域分析：为整型表达式/下标标注取值范围，为Loop节点标注迭代次数范围，
+    // 最内层有界循环的迭代次数同时写入图属性供代价模型与代码生成使用
+    void AnnotateValueRanges(LoopInductionAnalysis& analysis);
+    // 最内层有界循环的 trip_count_* 提升为图属性
+    static void PromoteTripCount(ComputeGraph& graph, const ComputeNode& loopNode);
+
+    // 【新增】对齐与连续性：为ArrayAccess/Load/Store/解引用/成员访问节点标注地址对齐、
+    // 最内层循环首次迭代时的对齐与是否连续访问
+    void AnnotateAlignment(LoopInductionAnalysis& analysis);
+
     // 【新增】从条件表达式中提取循环变量名
     std::string ExtractLoopVarFromCondition(const clang::Expr* cond);
 
@@ -605,6 +792,10 @@ private:
     // 标注分支内的节点
     void MarkNodesInBranch(const BranchInfo& branchInfo);
 
+    // 【新增】源码区间 [stmt 起点, stmt 终点] 内的节点；stmt 为空或区间无效时按行号范围回退
+    std::vector<ComputeNode::NodeId> CollectNodesInRegion(const clang::Stmt* stmt,
+                                                          int startLine, int endLine);
+
     // 向后追踪所有变量的定义点
     void TraceAllDefinitionsBackward(const clang::Stmt* stmt, int depth);
 
@@ -614,12 +805,26 @@ private:
                                      const clang::RecordDecl* unionDecl,
                                      int depth);
 
+    // 【新增】经指针/下标的读取：连接基址不同、但指针分析判定可能别名的写入
+    // 源码中在前的最近写入 -> Memory 边；同一循环内在后的写入 -> LoopCarried 边
+    void TraceAliasingStores(const clang::Stmt* stmt, int depth);
+    void ConnectAliasingStore(const clang::Stmt* storeStmt, const std::string& storeBase,
+                              const std::string& loadBase, ComputeNode::NodeId loadId,
+                              ComputeEdgeKind kind, int depth);
+
+    // 【新增】把union成员访问节点登记到别名索引（节点创建时调用）
+    void RegisterUnionMember(ComputeNode::NodeId memberId, const clang::MemberExpr* memberExpr,
+                             const clang::FieldDecl* field);
+
     // 【新增】连接同一union的不同成员节点（别名关系）
     void ConnectUnionAliases(ComputeNode::NodeId baseId,
                              ComputeNode::NodeId currentMemberId,
                              const clang::RecordDecl* unionDecl,
                              const clang::FieldDecl* currentField);
 
+    // 【新增】标记赋值目标（is_assign_target / is_read_write），同步union别名索引中的读写角色
+    void MarkAssignTarget(const std::shared_ptr<ComputeNode>& node, bool readWrite);
+
     const clang::ParmVarDecl* FindParamDeclFromStmt(
     ComputeNode::NodeId nodeId);
 
@@ -753,6 +958,9 @@ private:
     ComputeNode::NodeId CreateGenericDefNode(
         const clang::Stmt* defStmt, const std::string& varName);
     void SetLoopContextForNode(ComputeNode::NodeId nodeId);
+    // 【新增】设置节点的循环上下文并登记到 loopContextMembers
+    void AssignLoopContext(const std::shared_ptr<ComputeNode>& node, ComputeNode::NodeId loopId,
+                           const std::string& loopVar, int loopLine);
 
     bool ShouldSkipCalleeAnalysis(const clang::FunctionDecl* callee);
     void InheritLoopContext(
@@ -837,6 +1045,10 @@ public:
     static void MergeOverlappingGraphs(ComputeGraphSet& graphSet);
 
 private:
+    // 【新增】合并图级属性（score、依赖/惯用法摘要等）
+    static void MergeGraphProperties(const ComputeGraph& g1, const ComputeGraph& g2,
+                                     ComputeGraph& merged);
+
     // 检查两个节点是否可以合并
     static bool CanMergeNodes(const ComputeNode& n1, const ComputeNode& n2);
 
@@ -844,8 +1056,9 @@ private:
     static void CopyNodeProperties(const ComputeNode* src, ComputeNode* dst);
 };
 
-// 全局辅助函数：合并重叠的图
-void MergeOverlappingGraphs(ComputeGraphSet& graphSet);
+// 全局辅助函数：合并重叠的图（reanalyze 见 ComputeGraphSet::MergeOverlapping）
+void MergeOverlappingGraphs(ComputeGraphSet& graphSet,
+                            const std::function<void(ComputeGraph&)>& reanalyze = nullptr);
 
 // ============================================
 // 模式匹配器 (用于向量化规则匹配)
@@ -8,6 +8,7 @@
 #include <set>
 #include <vector>
 #include "ComputeGraphBase.h"
+#include "AnchorProfile.h"
 #include "clang/AST/Stmt.h"
 #include "clang/AST/Expr.h"
 #include "clang/AST/Decl.h"
@@ -29,6 +30,9 @@ namespace compute_graph {
         // 锚点评分 (用于优先级排序)
         int score = 0;
 
+        // 【新增】剖析热度 [0, 1]，未加载剖析数据时为0
+        double hotness = 0.0;
+
         // 源码信息
         std::string sourceText;
         int sourceLine = 0;
@@ -36,6 +40,23 @@ namespace compute_graph {
         std::string ToString() const;
     };
 
+    // ============================================
+    // 【新增】锚点簇：同一最内层循环（非循环运算按函数）内的锚点
+    // 每个簇只做一次构建，取代逐锚点构建后再合并
+    // ============================================
+    struct AnchorCluster {
+        const clang::FunctionDecl* func = nullptr;
+        const clang::Stmt* scopeStmt = nullptr;  // 最内层循环语句，非循环簇为函数体
+        bool isLoopScope = false;
+        int scopeLine = 0;
+
+        std::vector<AnchorPoint> anchors;        // 按源码位置排序
+        size_t primaryIndex = 0;                 // 簇内评分最高的锚点下标
+        int score = 0;                           // 簇内最高评分
+
+        const AnchorPoint& Primary() const { return anchors[primaryIndex]; }
+    };
+
 
     // ============================================
     // 锚点查找器
@@ -54,9 +75,18 @@ namespace compute_graph {
         std::vector<AnchorPoint> FilterAndRankAnchors(
             const std::vector<AnchorPoint>& anchors);
 
+        // 【新增】按最内层循环/函数对已排序的锚点分簇，簇按最高评分保持排序
+        std::vector<AnchorCluster> ClusterAnchors(
+            const std::vector<AnchorPoint>& rankedAnchors) const;
+
         // 配置
         void SetMinLoopDepth(int depth) { minLoopDepth = depth; }
         void SetIncludeNonLoopOps(bool include) { includeNonLoopOps = include; }
+        // 【新增】剖析引导排序：profile为空时退化为纯静态评分
+        void SetProfile(const AnchorProfile* prof) { profile = prof; }
+        void SetProfileWeight(int weight) { profileWeight = weight; }
+        // 【新增】锚点数量上限，0表示不限制
+        void SetMaxAnchors(size_t count) { maxAnchors = count; }
 
     private:
         cpg::CPGContext& cpgContext;
@@ -64,6 +94,9 @@ namespace compute_graph {
 
         int minLoopDepth = 0;       // 最小循环深度要求
         bool includeNonLoopOps = true;  // 是否包含非循环内的运算
+        const AnchorProfile* profile = nullptr;  // 剖析数据（不持有）
+        int profileWeight = 500;    // 热度为1.0时的加分，相当于5层循环深度
+        size_t maxAnchors = 50;     // 锚点数量上限
 
         // 判断语句是否是潜在的向量化锚点
         bool IsVectorizableAnchor(const clang::Stmt* stmt, int loopDepth) const;
@@ -71,11 +104,17 @@ namespace compute_graph {
         // 计算锚点评分
         int ComputeAnchorScore(const AnchorPoint& anchor) const;
 
+        // 【新增】从剖析数据查询锚点所在源码行的热度
+        double LookupHotness(const AnchorPoint& anchor) const;
+
         // 获取语句的循环深度
         int GetLoopDepth(const clang::Stmt* stmt) const;
 
         // 判断是否在循环内
         bool IsInLoop(const clang::Stmt* stmt) const;
+
+        // 【新增】查找包含语句的最内层循环，不在循环内返回nullptr
+        const clang::Stmt* FindInnermostLoop(const clang::Stmt* stmt) const;
     };
 
 
@@ -67,10 +67,17 @@ enum class OpCode {
     Add, Sub, Mul, Div, Mod,
     // 位运算
     And, Or, Xor, Shl, Shr,
+    AndNot,             // 【新增】~a & b（x86 andnot 的操作数顺序）
     // 一元运算
     Neg, Not, BitNot,
     // 比较运算
     Lt, Gt, Le, Ge, Eq, Ne,
+    // 【新增】SIMD intrinsic 语义
+    Fma,                // a * b + c
+    Fms,                // 【新增】a * b - c
+    Fnma,               // 【新增】c - a * b（累加值减乘积，如 fnmadd / vfms / svmls）
+    Min, Max, Abs, Sqrt,
+    Load, Store, Convert, Broadcast, Shuffle, Select, Reduce, Dot,
     // 其他
     Assign, Unknown
 };
@@ -83,20 +90,38 @@ struct DataTypeInfo {
         Int8, Int16, Int32, Int64,
         UInt8, UInt16, UInt32, UInt64,
         Float, Double,
+        Float16,         // 【新增】IEEE半精度 (_Float16 / __fp16)
+        BFloat16,        // 【新增】bfloat16 (__bf16)
+        Predicate,       // 【新增】SVE谓词 (svbool_t)，每lane 1位
         Pointer, Array, Void,
         TemplateParam,   // 模板参数类型（如 T）
         Dependent,       // 依赖类型（模板中的复杂类型）
         Unknown
     };
 
+    // 向量类型时 baseType/bitWidth 描述元素（lane）类型
     BaseType baseType = BaseType::Unknown;
-    int vectorWidth = 1;        // 向量宽度 (1表示标量)
-    int bitWidth = 0;           // 位宽
+    int vectorWidth = 1;        // 向量宽度/lane数 (1表示标量；可伸缩向量为每128位的最小lane数)
+    int bitWidth = 0;           // 元素位宽
+    int totalBitWidth = 0;      // 【新增】总位宽 = bitWidth * vectorWidth（可伸缩向量为最小值）
+    bool isScalable = false;    // 【新增】可伸缩向量 (SVE sizeless)，实际lane数 = vscale * vectorWidth
+    bool isStorageOnly = false; // 【新增】仅存储格式，运算前提升为float (__fp16)
     bool isSigned = true;       // 是否有符号
     std::string typeName;       // 原始类型名（用于模板类型如 "T"）
 
+    bool IsVector() const { return vectorWidth > 1 || isScalable; }
+    bool IsFloatingPoint() const;
+    bool IsLowPrecisionFloat() const
+    {
+        return baseType == BaseType::Float16 || baseType == BaseType::BFloat16;
+    }
+
     std::string ToString() const;
     static DataTypeInfo FromClangType(const clang::QualType& type);
+
+private:
+    static bool FromBuiltinFloat(const clang::BuiltinType* builtin, DataTypeInfo& info);
+    static bool FromSizelessBuiltin(const clang::BuiltinType* builtin, DataTypeInfo& info);
 };
 
     // ============================================
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * ComputeGraphBinary.h - ComputeGraphSet 的紧凑二进制交换格式
+ *
+ * 面向下游排序服务的只读格式，读取端映射文件后直接在记录上访问，不做反序列化：
+ *   - 文件头：魔数 "CGBN"、主/次版本号、各段的偏移与记录数
+ *   - 图表 / 节点表 / 边表 / 属性表 / 源码位置表：定长、8字节对齐的小端记录，按下标互相引用
+ *   - 字符串池：去重的 (u32 长度, 字节, '\0')，记录中以池内偏移引用
+ * 主版本号不同的文件拒绝读取；次版本号只追加字段/段，旧读取端可忽略。
+ * 属性按取值推断类型（bool / int / float / string），读取端无需再解析字符串。
+ * 枚举字段存的是冻结的磁盘编码（见 ComputeGraphBinary.cpp 的编码表），不是枚举序数，
+ * 内存中的枚举调整顺序或插入新值不影响已写出的文件。
+ */
+#ifndef COMPUTE_GRAPH_BINARY_H
+#define COMPUTE_GRAPH_BINARY_H
+
+#include "ComputeGraph.h"
+
+#include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace compute_graph {
+
+namespace cgbin {
+
+constexpr char kMagic[4] = {'C', 'G', 'B', 'N'};
+constexpr uint16_t kVersionMajor = 1;
+constexpr uint16_t kVersionMinor = 0;
+constexpr uint32_t kNoIndex = 0xFFFFFFFFu;
+
+// 【修改】磁盘编码，取值冻结，新类型只能追加新编码
+enum class AttrType : uint8_t { String = 0, Int = 1, Float = 2, Bool = 3 };
+
+// 【新增】枚举 <-> 磁盘编码。Encode 对表中没有的值返回 Unknown（边类型为 DataFlow）的编码；
+// Decode 遇到未知编码返回 false，读取端据此在加载时拒绝文件
+uint16_t EncodeNodeKind(ComputeNodeKind kind);
+uint16_t EncodeOpCode(OpCode op);
+uint8_t EncodeBaseType(DataTypeInfo::BaseType type);
+uint16_t EncodeEdgeKind(ComputeEdgeKind kind);
+bool DecodeNodeKind(uint16_t code, ComputeNodeKind& kind);
+bool DecodeOpCode(uint16_t code, OpCode& op);
+bool DecodeBaseType(uint8_t code, DataTypeInfo::BaseType& type);
+bool DecodeEdgeKind(uint16_t code, ComputeEdgeKind& kind);
+
+// 节点标志位
+enum NodeFlags : uint8_t {
+    kHasConstValue = 1u << 0,
+    kConstIsInt = 1u << 1,
+    kLoopInvariant = 1u << 2,
+    kIsSigned = 1u << 3,
+    kIsScalable = 1u << 4,
+    kStorageOnly = 1u << 5,
+};
+
+struct Section {
+    uint64_t offset;
+    uint64_t count;             // 记录数；字符串池为字节数
+};
+
+struct FileHeader {
+    char magic[4];
+    uint16_t versionMajor;
+    uint16_t versionMinor;
+    uint64_t fileSize;
+    Section graphs;
+    Section nodes;
+    Section edges;
+    Section attrs;
+    Section locations;
+    Section strings;
+};
+
+struct GraphRecord {
+    uint32_t name;
+    uint32_t firstAttr;
+    uint32_t attrCount;
+    uint32_t reserved;
+    uint64_t firstNode;
+    uint64_t nodeCount;
+    uint64_t firstEdge;
+    uint64_t edgeCount;
+};
+
+struct NodeRecord {
+    uint64_t id;
+    uint64_t loopContextId;
+    uint64_t branchContextId;
+    uint64_t constBits;         // intValue 或 floatValue 的位模式，见 kConstIsInt
+    uint32_t name;
+    uint32_t sourceText;
+    uint32_t typeName;
+    uint32_t location;          // 源码位置表下标，kNoIndex 表示无
+    uint32_t firstAttr;
+    uint32_t attrCount;
+    uint16_t kind;              // ComputeNodeKind 磁盘编码
+    uint16_t opCode;            // OpCode 磁盘编码
+    uint16_t vectorWidth;
+    uint16_t bitWidth;
+    uint16_t loopDepth;
+    uint8_t baseType;           // DataTypeInfo::BaseType 磁盘编码
+    uint8_t flags;              // NodeFlags
+    uint32_t reserved;
+};
+
+struct EdgeRecord {
+    uint64_t id;
+    uint64_t source;
+    uint64_t target;
+    uint32_t label;
+    uint32_t firstAttr;
+    uint32_t attrCount;
+    uint16_t kind;              // ComputeEdgeKind 磁盘编码
+    uint16_t reserved;
+    int32_t weight;
+    uint32_t padding;
+};
+
+struct AttrRecord {
+    uint32_t key;
+    uint8_t type;               // AttrType
+    uint8_t reserved[3];
+    uint64_t value;             // 字符串池偏移 / int64 / double 位模式 / 0或1
+};
+
+struct LocationRecord {
+    uint32_t file;
+    uint32_t line;
+    uint32_t column;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 112, "FileHeader layout is part of the format");
+static_assert(sizeof(GraphRecord) == 48, "GraphRecord layout is part of the format");
+static_assert(sizeof(NodeRecord) == 72, "NodeRecord layout is part of the format");
+static_assert(sizeof(EdgeRecord) == 48, "EdgeRecord layout is part of the format");
+static_assert(sizeof(AttrRecord) == 16, "AttrRecord layout is part of the format");
+static_assert(sizeof(LocationRecord) == 16, "LocationRecord layout is part of the format");
+
+} // namespace cgbin
+
+// ============================================
+// 写出
+// sourceManager 用于解析节点的文件/列；为空时位置表只记录 sourceLine
+// ============================================
+bool WriteComputeGraphSetBinary(const ComputeGraphSet& graphSet, const std::string& filename,
+                                const clang::SourceManager* sourceManager = nullptr);
+
+// ============================================
+// 零拷贝读取
+// ============================================
+class ComputeGraphBinaryReader;
+
+struct BinaryAttrView {
+    const cgbin::AttrRecord* record;
+    const ComputeGraphBinaryReader* reader;
+
+    llvm::StringRef Key() const;
+    cgbin::AttrType Type() const { return static_cast<cgbin::AttrType>(record->type); }
+    llvm::StringRef AsString() const;       // 非字符串属性返回空
+    int64_t AsInt() const;
+    double AsFloat() const;
+    bool AsBool() const;
+    std::string ToString() const;           // 任意类型转回文本
+};
+
+struct BinaryNodeView {
+    const cgbin::NodeRecord* record;
+    const ComputeGraphBinaryReader* reader;
+
+    ComputeNode::NodeId Id() const { return record->id; }
+    ComputeNodeKind Kind() const;
+    OpCode Op() const;
+    DataTypeInfo::BaseType BaseType() const;
+    llvm::StringRef Name() const;
+    llvm::StringRef SourceText() const;
+    const cgbin::LocationRecord* Location() const;  // 无位置返回nullptr
+    llvm::StringRef LocationFile() const;
+    size_t AttrCount() const { return record->attrCount; }
+    BinaryAttrView Attr(size_t idx) const;
+};
+
+struct BinaryEdgeView {
+    const cgbin::EdgeRecord* record;
+    const ComputeGraphBinaryReader* reader;
+
+    ComputeEdgeKind Kind() const;
+    ComputeNode::NodeId Source() const { return record->source; }
+    ComputeNode::NodeId Target() const { return record->target; }
+    llvm::StringRef Label() const;
+    size_t AttrCount() const { return record->attrCount; }
+    BinaryAttrView Attr(size_t idx) const;
+};
+
+struct BinaryGraphView {
+    const cgbin::GraphRecord* record;
+    const ComputeGraphBinaryReader* reader;
+
+    llvm::StringRef Name() const;
+    size_t NodeCount() const { return record->nodeCount; }
+    size_t EdgeCount() const { return record->edgeCount; }
+    BinaryNodeView Node(size_t idx) const;
+    BinaryEdgeView Edge(size_t idx) const;
+    size_t AttrCount() const { return record->attrCount; }
+    BinaryAttrView Attr(size_t idx) const;
+    // 按键查找图属性（线性扫描），找不到返回空；【修复】类型化属性按 ToString 转回文本
+    std::string GetProperty(llvm::StringRef key) const;
+};
+
+class ComputeGraphBinaryReader {
+public:
+    // 以只读方式 mmap 文件并校验文件头与各段边界，失败时输出原因并返回false
+    bool Open(const std::string& filename);
+
+    size_t GraphCount() const { return header ? header->graphs.count : 0; }
+    BinaryGraphView Graph(size_t idx) const;
+
+    // 把一个图还原为 ComputeGraph（节点ID重新分配，上下文ID随之映射；不含AST关联）
+    std::shared_ptr<ComputeGraph> Materialize(size_t idx) const;
+
+    uint16_t VersionMinor() const { return header ? header->versionMinor : 0; }
+
+private:
+    friend struct BinaryAttrView;
+    friend struct BinaryNodeView;
+    friend struct BinaryEdgeView;
+    friend struct BinaryGraphView;
+
+    std::unique_ptr<llvm::sys::fs::mapped_file_region> mapping;
+    const cgbin::FileHeader* header = nullptr;
+    const cgbin::GraphRecord* graphs = nullptr;
+    const cgbin::NodeRecord* nodes = nullptr;
+    const cgbin::EdgeRecord* edges = nullptr;
+    const cgbin::AttrRecord* attrs = nullptr;
+    const cgbin::LocationRecord* locations = nullptr;
+    const char* strings = nullptr;
+
+    llvm::StringRef GetString(uint32_t offset) const;
+    BinaryAttrView MakeAttr(uint64_t idx) const;
+};
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_BINARY_H
@@ -6,6 +6,8 @@
 #define COMPUTE_GRAPH_TESTER_H
 
 #include "ComputeGraph.h"
+#include "ComputeGraphAnchor.h"
+#include "SIMDCostModel.h"
 #include "code_property_graph/CPGAnnotation.h"
 
 #include "clang/AST/ASTContext.h"
@@ -28,11 +30,82 @@ struct ComputeGraphTestConfig {
     std::string targetFunction = "";
     int maxBackwardDepth = 5;
     int maxForwardDepth = 5;
+    std::string profileFile = "";   // 【新增】剖析数据文件（perf script / gcov / llvm-profdata）
+    size_t maxAnchors = 50;         // 【新增】每个函数保留的锚点上限，0表示不限制
+    std::string simdTarget = "avx2"; // 【新增】收益估计的目标指令集，"none"表示不估计
+    double minSpeedup = 1.0;        // 【新增】导出前剪除不可向量化或预估加速比低于该值的图，0表示不剪除
+    bool emitSIMD = false;          // 【新增】为已识别惯用法的循环生成向量化C++函数
+    std::string emitISA = "";       // 【新增】生成代码的指令集，空表示沿用 simdTarget
+    bool emitBench = false;         // 【新增】为排名靠前的图生成微基准/差分测试程序
+    size_t benchTop = 3;            // 【新增】每个函数生成测试程序的图数
+    long benchElements = 4096;      // 【新增】测试程序默认元素数
+    std::string benchCompiler = "c++"; // 【新增】本机编译器，空表示只生成不编译
+    unsigned benchTimeout = 60;     // 【新增】测试程序编译/运行各自的超时（秒），0表示不限时
+    bool instantiations = false;    // 【新增】模板函数按实例分别构建（共享模式上的锚点簇）
+    size_t dotLODThreshold = 2000;  // 【新增】超过该节点数的图分层导出DOT，0表示始终平铺
+    bool emitBinary = false;        // 【新增】导出紧凑二进制图文件（.cgb）供下游服务读取
+    bool similarity = false;        // 【新增】跨函数/文件按结构相似度聚类内核
+    double similarityThreshold = 0.8; // 【新增】聚类的最低估计相似度
+    bool crossTUDedup = false;      // 【新增】跨翻译单元跳过已分析的函数/锚点
+    std::string dedupRegistry = ""; // 【新增】多进程共享的登记文件，非空时隐含 crossTUDedup
+    size_t pipelineQueue = 64;      // 【新增】流水线中等待构建的锚点簇上限
+    unsigned maxRSSMB = 0;          // 【新增】常驻内存预算（MB），超出时暂停发现新函数，0表示不限制
+    bool keepCPG = false;           // 【新增】导出后保留CPG数据（调试用，内存随翻译单元增长）
+    std::string pointsTo = "steensgaard"; // 【新增】指针分析：off / steensgaard / andersen
+    std::string goldenDump = "";    // 【新增】规范化图转储文件（回归测试比对黄金输出），空表示不输出
 };
 
 // 全局配置
 extern ComputeGraphTestConfig g_cgConfig;
 
+// 【新增】按 g_cgConfig.profileFile 懒加载的剖析数据，未配置或加载失败返回nullptr
+const AnchorProfile* GetConfiguredProfile();
+
+// 【新增】按 g_cgConfig.simdTarget 创建的代价模型，"none"或未知目标返回nullptr
+const CostModel* GetConfiguredCostModel();
+
+// 【新增】标注向量化收益、按加速比排序并剪除无收益的图，返回剪除数量
+size_t ApplyConfiguredCostModel(ComputeGraphSet& graphSet);
+
+// 【修改】按 g_cgConfig.instantiations 把模板模式函数的锚点簇替换为逐实例的簇（并构建实例的CPG），
+// 返回实例簇数量；非模板函数或没有实例时簇不变
+size_t ExpandConfiguredInstantiations(std::vector<AnchorCluster>& clusters, const clang::FunctionDecl* func,
+                                      cpg::CPGContext& cpgCtx, clang::ASTContext& astCtx);
+
+// 【新增】按 g_cgConfig.emitBinary 把图集写到 <outputDir>/<baseName>.cgb，成功返回true
+bool ExportConfiguredBinary(const ComputeGraphSet& graphSet, const std::string& baseName,
+                            clang::ASTContext& astCtx);
+
+// 【新增】按 g_cgConfig.similarity 把图集加入全局相似度索引（只保存指纹），返回加入数量
+size_t IndexConfiguredSimilarity(const ComputeGraphSet& graphSet, clang::ASTContext& astCtx);
+
+// 【新增】输出全局相似度索引的聚类报告（所有翻译单元处理完后调用）
+void ReportConfiguredSimilarity();
+
+// 【新增】跨翻译单元去重：登记函数，已被其他翻译单元（或共享登记文件中的进程）分析过时返回false
+bool ClaimConfiguredFunction(const clang::FunctionDecl* func, clang::ASTContext& astCtx);
+
+// 【新增】移除已被登记的锚点并登记其余锚点，返回移除数量
+size_t FilterConfiguredAnalyzedAnchors(std::vector<AnchorPoint>& anchors, clang::ASTContext& astCtx);
+
+// 【新增】输出跨翻译单元去重的统计
+void ReportConfiguredDedup();
+
+// 【新增】按 g_cgConfig.goldenDump 追加函数的规范化图转储（首次写入时截断文件），返回写出的图数
+size_t DumpConfiguredCanonical(const ComputeGraphSet& graphSet, const std::string& funcName);
+
+// 【新增】向量代码生成使用的指令集（emitISA 为空时沿用 simdTarget）
+std::string GetConfiguredEmitTarget();
+
+// 【新增】按 g_cgConfig.emitSIMD/emitISA 为每个图生成 <baseName>_cg_<idx>.<isa>.cpp，返回生成数量
+size_t EmitConfiguredSIMDCode(const ComputeGraphSet& graphSet, const std::string& baseName,
+                              clang::ASTContext& astCtx);
+
+// 【新增】按 g_cgConfig.emitBench 为前 benchTop 个图生成 <baseName>_cg_<idx>.bench.cpp，
+// 配置了编译器时在本机编译运行，返回生成数量
+size_t RunConfiguredBenchmarks(const ComputeGraphSet& graphSet, const std::string& baseName,
+                               clang::ASTContext& astCtx);
+
 // ============================================
 // 测试结果
 // ============================================
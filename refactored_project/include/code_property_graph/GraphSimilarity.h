@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * GraphSimilarity.h - 计算图的近似相似度索引（跨文件内核聚类）
+ *
+ * 与 IsIsomorphicTo 的精确签名不同，这里只看计算的“形状”：
+ *   - 节点初始标签只取 kind / opCode / 元素类型，不含名字、常量值和行号
+ *   - Weisfeiler-Lehman 子树迭代：标签 = hash(自身标签, 排序后的 (方向, 边类型, 邻居标签))，
+ *     各轮标签的多重集合即图的结构特征
+ *   - 对特征多重集合做 MinHash，签名一致的比例估计加权 Jaccard 相似度
+ *   - LSH 分段：签名切成 bands 段，任一段相同即为候选，再按估计相似度确认并合并成簇
+ * 索引只保存签名与图的描述信息，不持有图本身。
+ */
+#ifndef COMPUTE_GRAPH_GRAPH_SIMILARITY_H
+#define COMPUTE_GRAPH_GRAPH_SIMILARITY_H
+
+#include "ComputeGraph.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace compute_graph {
+
+// ============================================
+// 图的结构指纹
+// ============================================
+struct GraphFingerprint {
+    std::unordered_map<uint64_t, uint32_t> features;    // WL 标签 -> 出现次数
+    std::vector<uint64_t> minHash;
+    size_t nodeCount = 0;
+    size_t edgeCount = 0;
+};
+
+// 被索引图的描述（报告用）
+struct SimilarityEntry {
+    std::string graphName;
+    std::string function;
+    std::string location;           // "<文件>:<行>"
+    GraphFingerprint fingerprint;
+};
+
+struct SimilarityCluster {
+    std::vector<size_t> members;    // SimilarityEntry 下标，首个为代表
+    double minSimilarity = 1.0;     // 簇内成员与代表的最低估计相似度
+};
+
+// ============================================
+// 相似度索引
+// ============================================
+class GraphSimilarityIndex {
+public:
+    // numHashes 须能被 bands 整除；wlIterations 为 WL 迭代轮数
+    explicit GraphSimilarityIndex(int wlIterations = 3, size_t numHashes = 64, size_t bands = 16);
+
+    GraphFingerprint ComputeFingerprint(const ComputeGraph& graph) const;
+
+    // 加入索引，返回条目下标
+    size_t Add(const ComputeGraph& graph, const std::string& function, const std::string& location);
+
+    // MinHash 一致比例（估计的加权 Jaccard 相似度）
+    static double EstimateSimilarity(const GraphFingerprint& a, const GraphFingerprint& b);
+
+    // 与 graph 相似度不低于 threshold 的已索引图，按相似度降序
+    std::vector<std::pair<size_t, double>> Query(const ComputeGraph& graph, double threshold) const;
+
+    // 把相似度不低于 threshold 的图合并成簇（单元素簇也返回），按簇大小降序
+    std::vector<SimilarityCluster> Cluster(double threshold) const;
+
+    const std::vector<SimilarityEntry>& GetEntries() const { return entries; }
+    size_t Size() const { return entries.size(); }
+
+private:
+    int iterations;
+    size_t hashCount;
+    size_t bandCount;
+    size_t rowsPerBand;
+    std::vector<uint64_t> seeds;
+
+    std::vector<SimilarityEntry> entries;
+    std::unordered_map<uint64_t, std::vector<size_t>> buckets;  // LSH 段哈希 -> 条目
+
+    std::vector<uint64_t> BandKeys(const GraphFingerprint& fingerprint) const;
+};
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_GRAPH_SIMILARITY_H
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * IdiomRecognizer.h - 归约/扫描/直方图/逐元素映射惯用法识别
+ *
+ * 在构建完成的计算图上识别循环中的典型计算模式，并标注到节点与图属性：
+ *   - 归约：sum / product / min / max / dot
+ *   - 前缀扫描：out[i] = out[i-1] op x[i]，或累加器逐次写出
+ *   - 直方图：hist[idx[i]] += ...（下标非仿射，需冲突检测）
+ *   - 逐元素映射：y[i] = a*x[i] + y[i]（saxpy 等）
+ * 识别结果以位掩码缓存在图上，查询为常数时间。
+ */
+#ifndef COMPUTE_GRAPH_IDIOM_RECOGNIZER_H
+#define COMPUTE_GRAPH_IDIOM_RECOGNIZER_H
+
+#include "ComputeGraph.h"
+#include "LoopInductionAnalysis.h"
+
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace compute_graph {
+
+// 惯用法种类（位掩码，可组合）
+enum class IdiomKind : unsigned {
+    None = 0,
+    SumReduction = 1u << 0,
+    ProductReduction = 1u << 1,
+    MinReduction = 1u << 2,
+    MaxReduction = 1u << 3,
+    DotProduct = 1u << 4,
+    PrefixScan = 1u << 5,
+    Histogram = 1u << 6,
+    ElementwiseMap = 1u << 7
+};
+
+constexpr unsigned IdiomBit(IdiomKind kind)
+{
+    return static_cast<unsigned>(kind);
+}
+
+// 所有归约类惯用法
+constexpr unsigned kReductionIdiomMask =
+    IdiomBit(IdiomKind::SumReduction) | IdiomBit(IdiomKind::ProductReduction) |
+    IdiomBit(IdiomKind::MinReduction) | IdiomBit(IdiomKind::MaxReduction) |
+    IdiomBit(IdiomKind::DotProduct);
+
+// "sum"/"product"/"min"/"max"/"dot"/"scan"/"histogram"/"map"
+const char* IdiomKindToString(IdiomKind kind);
+
+// ============================================
+// 一次识别结果
+// ============================================
+struct IdiomMatch {
+    IdiomKind kind = IdiomKind::None;
+    std::string variable;               // 累加器/目标数组的源码文本
+    std::string op;                     // "+", "*", "min", "max"
+    std::string subtype;                // 映射："saxpy"/"scale"/"copy"/"map"；归约："argmin"/"argmax"
+    ComputeNode::NodeId updateNodeId = 0;   // 更新语句对应的节点
+    ComputeNode::NodeId targetNodeId = 0;   // 被写入的变量/数组访问节点
+    std::set<ComputeNode::NodeId> nodes;    // 参与该惯用法的所有节点
+    int sourceLine = 0;
+
+    // 运算在元素类型上的代数性质
+    bool isAssociative = false;
+    bool isCommutative = false;
+    // 向量化该惯用法所需的性质（归约需要两者，扫描只需结合律）
+    bool requiresAssociativity = false;
+    bool requiresCommutativity = false;
+    // 浮点运算重排后结果可能不同（需 -ffast-math / -fassociative-math 语义）
+    bool needsFPReassociation = false;
+    // 直方图：同一向量内可能写同一元素
+    bool needsConflictDetection = false;
+
+    std::string ToString() const;
+};
+
+// ============================================
+// 识别器
+// ============================================
+class IdiomRecognizer {
+public:
+    IdiomRecognizer(clang::ASTContext& ctx, LoopInductionAnalysis& induction);
+
+    // 识别图中所有惯用法（按节点ID顺序，同一语句只报告一次）
+    std::vector<IdiomMatch> Recognize(const ComputeGraph& graph);
+
+    // 识别并写入节点属性 (idiom, is_reduction, reduction_op, is_accumulator …)
+    // 与图属性 (idioms, idiom_mask, has_reduction, fp_reassociation)
+    void Annotate(ComputeGraph& graph);
+
+    // 常数时间查询（读取 Annotate 缓存在图上的位掩码）
+    static unsigned GetIdiomMask(const ComputeGraph& graph) { return graph.GetIdiomMask(); }
+    static bool HasIdiom(const ComputeGraph& graph, IdiomKind kind)
+    {
+        return (graph.GetIdiomMask() & IdiomBit(kind)) != 0;
+    }
+    static bool HasReduction(const ComputeGraph& graph)
+    {
+        return (graph.GetIdiomMask() & kReductionIdiomMask) != 0;
+    }
+
+private:
+    using ExprPredicate = std::function<bool(const clang::Expr*)>;
+
+    clang::ASTContext& astContext;
+    LoopInductionAnalysis& inductionAnalysis;
+
+    bool MatchScalarUpdate(const ComputeGraph& graph, const clang::Stmt* update,
+                           const clang::Stmt* loopStmt, IdiomMatch& match);
+    bool MatchArrayUpdate(const ComputeGraph& graph, const clang::Stmt* update,
+                          const clang::ArraySubscriptExpr* target,
+                          const clang::Stmt* loopStmt, IdiomMatch& match);
+    bool MatchHandBuilt(const ComputeGraph& graph, const ComputeNode& node, IdiomMatch& match);
+
+    // 表达式沿 +/- 或 * 链恰好含一个累加器叶子，返回对应惯用法；addends 收集其余加数
+    IdiomKind ClassifyChain(const clang::Expr* expr, const ExprPredicate& isAccumulator,
+                            std::vector<const clang::Expr*>& addends) const;
+    // s < E ? s : E、min(s, E)、if (E > s) s = E 等形式
+    IdiomKind ClassifyMinMax(const clang::Expr* cond, const clang::Expr* picked,
+                             const ExprPredicate& isAccumulator) const;
+
+    // 累加器在循环内的其他引用只允许写入数组（前缀扫描），否则不是归约
+    bool CheckAccumulatorUses(const clang::VarDecl* var, const clang::Stmt* loopStmt,
+                              const clang::Stmt* update, const clang::Stmt* guard,
+                              bool& storedToArray) const;
+    // 循环内（更新语句之外）是否还访问同一数组
+    bool HasOtherArrayRefs(const clang::Stmt* loopStmt, const clang::Stmt* update,
+                           const std::string& baseText) const;
+    bool IsInvariantExpr(const clang::Expr* expr, const LoopInductionInfo& loop) const;
+    bool SameExpr(const clang::Expr* a, const clang::Expr* b) const;
+    std::string GetBaseText(const clang::ArraySubscriptExpr* access) const;
+
+    std::string ClassifyMapUpdate(const clang::Expr* rhs, const LoopInductionInfo& loop,
+                                  bool compound) const;
+    void CollectNodes(const ComputeGraph& graph, const clang::Stmt* stmt,
+                      std::set<ComputeNode::NodeId>& nodes) const;
+};
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_IDIOM_RECOGNIZER_H
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * IntrinsicSemantics.h - SIMD intrinsic 语义数据库
+ *
+ * 把 NEON / SVE / SSE / AVX2 / AVX-512 intrinsic 名映射到：
+ * 运算OpCode、操作数/结果的lane类型与数量、访存行为、各微架构的粗略延迟/吞吐。
+ * 表内容见 IntrinsicSemantics.def，首次使用时展开为哈希表，查询O(1)。
+ */
+#ifndef COMPUTE_GRAPH_INTRINSIC_SEMANTICS_H
+#define COMPUTE_GRAPH_INTRINSIC_SEMANTICS_H
+
+#include "ComputeGraphBase.h"
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <string>
+
+namespace compute_graph {
+
+enum class IntrinsicISA {
+    NEON,
+    SVE,
+    SSE,        // _mm_ 前缀（含SSE2~SSE4.2及128位AVX形式）
+    AVX2,       // _mm256_ 前缀（AVX/AVX2/FMA）
+    AVX512,     // _mm512_ 前缀及 mask/maskz 形式
+    Unknown
+};
+
+enum class IntrinsicMemKind {
+    None,
+    Load,
+    Store,
+    Gather,
+    Scatter
+};
+
+// 延迟/吞吐参考的微架构（x86行填前两列，Arm行填后两列）
+enum class Microarch {
+    SkylakeX,
+    Zen4,
+    NeoverseN2,
+    NeoverseV1,
+    Count
+};
+
+struct IntrinsicCost {
+    double latency = 0.0;           // 周期
+    double recipThroughput = 0.0;   // 倒数吞吐（周期/指令）
+
+    bool IsValid() const { return latency > 0.0; }
+};
+
+// ============================================
+// 单个intrinsic的语义
+// ============================================
+struct IntrinsicInfo {
+    std::string name;
+    IntrinsicISA isa = IntrinsicISA::Unknown;
+    OpCode opCode = OpCode::Unknown;
+    IntrinsicMemKind memKind = IntrinsicMemKind::None;
+
+    // 操作数lane类型：baseType/bitWidth 为元素，vectorWidth 为lane数，isScalable 标记SVE
+    // SVE重载名（如 svadd_m）无法从名字得知类型，baseType 为 Unknown，由调用点类型补全
+    DataTypeInfo laneType;
+    // 【新增】结果lane类型；加宽运算（如 _mm_madd_epi16 的 i16 -> i32）与 laneType 不同，其余相同
+    DataTypeInfo resultType;
+
+    bool isMasked = false;          // 谓词/掩码形式（_m/_z、_mask_/_maskz_）
+
+    IntrinsicCost costs[static_cast<size_t>(Microarch::Count)];
+
+    IntrinsicCost GetCost(Microarch arch) const
+    {
+        return costs[static_cast<size_t>(arch)];
+    }
+    bool IsMemoryOp() const { return memKind != IntrinsicMemKind::None; }
+};
+
+// ============================================
+// intrinsic 语义数据库（进程内单例，只读）
+// ============================================
+class IntrinsicSemanticsDB {
+public:
+    static const IntrinsicSemanticsDB& Instance();
+
+    // 按函数名查询，未收录返回nullptr
+    const IntrinsicInfo* Lookup(llvm::StringRef name) const;
+
+    size_t Size() const { return table.size(); }
+
+private:
+    IntrinsicSemanticsDB();
+
+    llvm::StringMap<IntrinsicInfo> table;
+
+    void AddEntry(const std::string& name, IntrinsicISA isa, OpCode op,
+                  IntrinsicMemKind mem, const DataTypeInfo& laneType,
+                  const DataTypeInfo& resultType, bool masked,
+                  Microarch arch0, IntrinsicCost cost0,
+                  Microarch arch1, IntrinsicCost cost1);
+
+    void AddNeon(const char* stem, OpCode op, IntrinsicMemKind mem, const char* types,
+                 IntrinsicCost n2, IntrinsicCost v1);
+    void AddSve(const char* stem, OpCode op, IntrinsicMemKind mem, const char* types,
+                IntrinsicCost n2, IntrinsicCost v1);
+    void AddX86(const char* stem, OpCode op, IntrinsicMemKind mem, const char* types,
+                IntrinsicCost skx, IntrinsicCost zen4);
+    void AddExplicit(const char* name, IntrinsicISA isa, OpCode op, IntrinsicMemKind mem,
+                     const char* type, int width, IntrinsicCost cost0, IntrinsicCost cost1);
+};
+
+std::string IntrinsicISAToString(IntrinsicISA isa);
+std::string IntrinsicMemKindToString(IntrinsicMemKind kind);
+std::string MicroarchToString(Microarch arch);
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_INTRINSIC_SEMANTICS_H
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * KernelBenchmark.h - 候选内核的本地微基准与差分测试
+ *
+ * 把计算图所在的循环抽取为独立内核，生成可单独编译的测试程序：
+ *   - 循环中引用的外部变量成为内核形参（数组/指针 -> 缓冲区，被写标量 -> 引用）
+ *   - 按形参的 DataTypeInfo 合成输入（浮点 [-1,1)、整数小范围、间接下标 [0,count)）
+ *   - 标量原循环与 SIMDCodeEmitter 生成的向量版本在同一输入上运行，逐元素比对输出
+ *   - 报告每元素耗时 (ns/element)
+ * 编译与运行只使用本机编译器，不需要网络。
+ */
+#ifndef COMPUTE_GRAPH_KERNEL_BENCHMARK_H
+#define COMPUTE_GRAPH_KERNEL_BENCHMARK_H
+
+#include "ComputeGraph.h"
+#include "LoopInductionAnalysis.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace compute_graph {
+
+// ============================================
+// 内核形参
+// ============================================
+struct KernelParam {
+    const clang::VarDecl* var = nullptr;
+    std::string name;
+    std::string declText;           // 形参声明（"const float* b"、"float& s"、"int n"）
+    std::string typeText;           // 缓冲区形参的类型（调用时 reinterpret_cast 的目标）
+    std::string elementType;        // 缓冲区元素/标量的类型拼写
+    DataTypeInfo elementInfo;       // 合成输入依据的类型信息
+
+    bool isBuffer = false;
+    bool isOutput = false;          // 缓冲区元素可写 / 标量在循环中被修改
+    bool isBound = false;           // 出现在循环边界中，取值为元素数
+    bool isIndexArray = false;      // 用作其他数组的下标，取值限制在 [0, count)
+    std::string initValue;          // 标量初值表达式
+    std::vector<std::string> indexExprs;    // 缓冲区各访问的展平下标（按归纳变量求值）
+    bool hasIndirectAccess = false;         // 存在 a[idx[i]] 形式的访问
+};
+
+// ============================================
+// 生成结果
+// ============================================
+struct KernelBenchHarness {
+    bool success = false;
+    std::string reason;             // 失败原因
+    std::string code;               // 测试程序源码
+    std::string kernelName;         // "<函数> loop at <文件>:<行>"
+
+    bool hasVector = false;         // 是否包含向量版本
+    std::string vectorReason;       // 未包含向量版本的原因
+    std::string isaSuffix;
+    std::string compileFlags;       // 向量版本所需的编译选项（只用于编译 KernelVector_）
+};
+
+// ============================================
+// 测试程序生成器
+// ============================================
+class KernelBenchGenerator {
+public:
+    // target: SIMDCodeEmitter 的指令集名；elements: 默认元素数（可由命令行参数覆盖）
+    KernelBenchGenerator(clang::ASTContext& ctx, const std::string& target, long elements);
+
+    // harnessFile 用于测试程序内的 #line 复位
+    KernelBenchHarness Generate(const ComputeGraph& graph, const std::string& harnessFile);
+
+private:
+    clang::ASTContext& astContext;
+    std::string targetName;
+    long defaultElements;
+    LoopInductionAnalysis inductionAnalysis;
+
+    // 单次生成的状态
+    const LoopInductionInfo* loopInfo = nullptr;
+    std::vector<KernelParam> params;
+    std::vector<const clang::ArraySubscriptExpr*> accesses;
+    std::string failure;
+    bool needsStdUsing = false;
+
+    const clang::Stmt* SelectLoop(const ComputeGraph& graph) const;
+    bool CollectParams(const clang::Stmt* loop);
+    bool ClassifyParam(KernelParam& param, bool written);
+    bool CollectAccesses();
+    void InitScalar(KernelParam& param, const clang::VarDecl* ivVar);
+    std::string FlatIndexText(const clang::ArraySubscriptExpr* access, const clang::VarDecl*& base) const;
+
+    std::string GetText(const clang::Stmt* stmt) const;
+    KernelParam* FindParam(const clang::VarDecl* var);
+    bool Fail(const std::string& reason);
+};
+
+// 用本机编译器编译测试程序并运行，输出直接写到标准输出；返回测试程序退出码为0
+// compileFlags 非空时向量内核单独带该选项编译为 <exeFile>.vector.o，驱动不带该选项编译后链接
+// 每步编译与运行各自限时 timeoutSeconds 秒（0表示不限时），超时视为失败
+bool CompileAndRunKernelBench(const std::string& compiler, const std::string& sourceFile,
+                              const std::string& compileFlags, const std::string& exeFile,
+                              unsigned timeoutSeconds);
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_KERNEL_BENCHMARK_H
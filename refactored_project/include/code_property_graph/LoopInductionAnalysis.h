@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * LoopInductionAnalysis.h - 循环归纳变量、迭代次数与访问步长分析
+ *
+ * 类 scalar-evolution 的轻量分析，直接作用于 clang AST：
+ *   - 识别 for/while/do-while 的归纳变量（起始值、步长、边界）
+ *   - 可计算时给出迭代次数
+ *   - 把数组下标化为仿射形式 base + stride*i + offset
+ */
+#ifndef COMPUTE_GRAPH_LOOP_INDUCTION_ANALYSIS_H
+#define COMPUTE_GRAPH_LOOP_INDUCTION_ANALYSIS_H
+
+#include "ComputeGraphBase.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace compute_graph {
+
+// ============================================
+// 归纳变量
+// ============================================
+struct InductionVariable {
+    const clang::VarDecl* var = nullptr;
+    std::string name;
+    bool isPrimary = false;         // 出现在循环条件中的主归纳变量
+
+    std::string startExpr;          // 起始值（源码文本）
+    bool hasConstStart = false;
+    int64_t start = 0;
+
+    int64_t step = 0;               // 每次迭代的增量（常量步长才认为是归纳变量）
+
+    std::string boundExpr;          // 边界（仅主归纳变量）
+    bool hasConstBound = false;
+    int64_t bound = 0;
+    std::string compareOp;          // 归一化为 "i <op> bound" 的比较符
+};
+
+// ============================================
+// 单个循环的归纳信息
+// ============================================
+struct LoopInductionInfo {
+    const clang::Stmt* loopStmt = nullptr;
+    std::vector<InductionVariable> inductionVars;   // 主归纳变量在前
+
+    bool hasTripCount = false;      // 常量迭代次数
+    int64_t tripCount = 0;
+    std::string tripCountExpr;      // 符号迭代次数（如 "n"、"(n - 1) / 2"）
+
+    // 循环体内被修改、但不是归纳变量的变量（在下标中出现即非仿射）
+    std::set<const clang::VarDecl*> variantVars;
+
+    // 循环体内声明且之后不再修改的局部变量及其初始化表达式（下标中可直接代入）
+    std::map<const clang::VarDecl*, const clang::Expr*> bodyDefinitions;
+
+    const InductionVariable* GetPrimary() const
+    {
+        return inductionVars.empty() || !inductionVars.front().isPrimary ?
+            nullptr : &inductionVars.front();
+    }
+    const InductionVariable* Find(const clang::VarDecl* var) const;
+};
+
+// ============================================
+// 仿射下标：base + stride*iv + offset
+// ============================================
+struct AffineIndex {
+    bool isAffine = false;
+    std::string ivName;             // 参与的主归纳变量（不含时为空）
+
+    bool hasConstStride = true;
+    int64_t stride = 0;             // 下标对 iv 的系数
+    std::string symbolicStride;     // 系数非常量时的符号形式（如 "n"）
+    int64_t ivStep = 1;             // 符号系数所乘归纳变量的步长
+
+    int64_t iterationStride = 0;    // 每次迭代的元素步长（各归纳变量系数*步长之和）
+    int64_t offset = 0;             // 常量偏移
+    std::string base;               // 循环不变的符号部分（如 "j * n"），可为空
+
+    std::string ToString() const;
+    // 供代价模型使用的每次迭代步长："0"/"1"/"k"，符号步长返回其文本，非仿射返回 "unknown"
+    std::string StrideString() const;
+};
+
+// ============================================
+// 下标在整个循环嵌套上的线性展开：Σ coeff*iv + constant + 不变量项（依赖测试用）
+// ============================================
+struct NestedIndexForm {
+    bool isAffine = false;
+    std::map<const clang::VarDecl*, int64_t> ivCoeffs;
+    int64_t constant = 0;
+    std::vector<std::pair<int64_t, std::string>> invariantTerms;  // 已排序，可直接比较
+};
+
+// ============================================
+// 分析器（按循环语句缓存结果）
+// ============================================
+class LoopInductionAnalysis {
+public:
+    explicit LoopInductionAnalysis(clang::ASTContext& ctx);
+
+    const LoopInductionInfo& Analyze(const clang::Stmt* loopStmt);
+
+    // 数组访问相对其所在循环的仿射形式；多维数组按行主序展开为元素下标
+    AffineIndex AnalyzeIndex(const clang::ArraySubscriptExpr* access,
+                             const LoopInductionInfo& loop);
+
+    // 语句所在的最内层循环（for/while/do），函数边界处停止
+    const clang::Stmt* FindEnclosingLoop(const clang::Stmt* stmt) const;
+
+    // 语句外层的循环嵌套，由内到外
+    std::vector<const clang::Stmt*> GetLoopNest(const clang::Stmt* stmt) const;
+
+    // 数组访问在循环嵌套（由内到外）上的线性展开；符号系数或非仿射时 isAffine=false
+    NestedIndexForm AnalyzeIndexInNest(const clang::ArraySubscriptExpr* access,
+                                       const std::vector<const clang::Stmt*>& nest);
+
+    // 表达式在循环内是否不变（不含归纳变量、循环内修改的变量与调用）
+    bool IsLoopInvariant(const clang::Expr* expr, const LoopInductionInfo& loop) const;
+
+private:
+    // 下标的线性形式：constant + Σ coeff*var + Σ invariantTerm
+    struct LinearForm {
+        bool ok = true;
+        int64_t constant = 0;
+        std::map<const clang::VarDecl*, int64_t> ivCoeffs;
+        std::string symbolicCoeff;      // 归纳变量乘以不变量时的符号系数
+        const clang::VarDecl* symbolicVar = nullptr;
+        std::vector<std::pair<int64_t, std::string>> invariantTerms;
+    };
+
+    clang::ASTContext& astContext;
+    std::map<const clang::Stmt*, LoopInductionInfo> cache;
+
+    void CollectInductionVars(const clang::Stmt* loopStmt, LoopInductionInfo& info);
+    void CollectUpdates(const clang::Stmt* stmt, bool conditional,
+                        std::map<const clang::VarDecl*, int64_t>& steps,
+                        LoopInductionInfo& info) const;
+    bool ExtractConstantStep(const clang::Expr* update, const clang::VarDecl*& var,
+                             int64_t& step) const;
+    void ExtractStart(const clang::Stmt* init, const clang::Stmt* loopStmt,
+                      InductionVariable& iv) const;
+    void ExtractBound(const clang::Expr* cond, LoopInductionInfo& info) const;
+    void ComputeTripCount(LoopInductionInfo& info) const;
+
+    LinearForm Flatten(const clang::ArraySubscriptExpr* access, const LoopInductionInfo& loop,
+                       std::string& rowBase) const;
+    LinearForm Linearize(const clang::Expr* expr, const LoopInductionInfo& loop,
+                         int depth = 0) const;
+    static LinearForm Add(const LinearForm& a, const LinearForm& b, int64_t sign);
+    static LinearForm Scale(const LinearForm& a, int64_t factor);
+    bool EvaluateConstant(const clang::Expr* expr, int64_t& value) const;
+};
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_LOOP_INDUCTION_ANALYSIS_H
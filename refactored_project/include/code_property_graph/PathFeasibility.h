@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * PathFeasibility.h - 路径条件的区间/差分约束可行性判定
+ *
+ * 不依赖外部求解器，只处理整数比较：
+ *   - 条件按 !、&&、|| 展开成析取范式（项数有上限，超出部分视为无约束）
+ *   - 原子为 (x + a) op (y + b)，x/y 为局部整型变量或常量，转成差分约束 x - y <= c
+ *   - 差分约束图（DBM）做 Floyd-Warshall 闭包，出现负环即矛盾；!= 在闭包后收紧边界再判定
+ * 只把“取值在整个函数执行期间不变”的变量当作符号：形参/局部变量除初始化外没有写入、
+ * 没有取地址或按引用传递、声明不在循环体内，且函数中没有 goto。其余条件一律视为无约束，
+ * 判定结果只会偏向“可行”，不会剪掉真实存在的路径。
+ */
+#ifndef CPG_PATH_FEASIBILITY_H
+#define CPG_PATH_FEASIBILITY_H
+
+#include "code_property_graph/CPGBase.h"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace cpg {
+
+class PathFeasibilityChecker {
+public:
+    // ctx 为空时从条件中引用的变量声明取 ASTContext
+    explicit PathFeasibilityChecker(clang::ASTContext* ctx = nullptr) : astContext(ctx) {}
+
+    // 条件可以是 IfStmt/WhileStmt/ForStmt/DoStmt（取其条件）、CaseStmt/DefaultStmt
+    // （取值为真表示进入该标签，需要 ctx 定位所属 switch）或整型表达式
+    bool IsFeasible(const PathCondition& path);
+
+    size_t CheckedCount() const { return checked; }
+    size_t InfeasibleCount() const { return infeasible; }
+
+private:
+    // x + offset，x 为空表示常量 offset
+    struct Term {
+        const clang::VarDecl* var = nullptr;
+        int64_t offset = 0;
+    };
+    // lhs op rhs，op 为比较运算符
+    struct Atom {
+        Term lhs;
+        Term rhs;
+        clang::BinaryOperatorKind op = clang::BO_EQ;
+    };
+    using Conjunction = std::vector<Atom>;
+    using Disjunction = std::vector<Conjunction>;   // 空表示恒假，{{}} 表示无约束
+
+    clang::ASTContext* astContext;
+    std::map<const clang::FunctionDecl*, std::set<const clang::VarDecl*>> stableVarsCache;
+    size_t checked = 0;
+    size_t infeasible = 0;
+
+    Disjunction DecomposeStmt(const clang::Stmt* cond, bool value);
+    Disjunction DecomposeExpr(const clang::Expr* expr, bool value, int depth);
+    Disjunction DecomposeCase(const clang::SwitchCase* label, bool value);
+    Disjunction DecomposeComparison(const clang::Expr* lhs, const clang::Expr* rhs,
+                                    clang::BinaryOperatorKind op, bool value);
+
+    bool ToTerm(const clang::Expr* expr, clang::QualType cmpType, Term& term,
+                Conjunction& implied);
+    bool EvaluateConstant(const clang::Expr* expr, int64_t& value);
+    bool IsStable(const clang::VarDecl* var);
+    clang::ASTContext* ContextFor(const clang::Decl* decl);
+
+    static Disjunction And(const Disjunction& a, const Disjunction& b);
+    static Disjunction Or(const Disjunction& a, const Disjunction& b);
+    static bool IsConsistent(const Conjunction& atoms);
+};
+
+} // namespace cpg
+
+#endif // CPG_PATH_FEASIBILITY_H
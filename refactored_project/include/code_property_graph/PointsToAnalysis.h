@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * PointsToAnalysis.h - 全翻译单元的字段敏感指针分析（Steensgaard / Andersen）
+ *
+ * 抽象内存对象：变量、堆分配点（malloc/new 等）、字符串/复合字面量、临时对象、
+ * restrict 形参所指对象，以及代表“翻译单元外部可见内存”的 External。
+ * 对象的字段按 FieldDecl 拆成子对象；union、按值拷贝过且含指针的结构体不拆字段。
+ * 数组元素与指针算术不区分偏移，p + i 与 p 指向同一对象。
+ *
+ * 约束：x ⊇ {o}、x ⊇ y、x ⊇ *y、*x ⊇ y、x ⊇ &y->f，两种求解器：
+ *   - Steensgaard：合一（近线性，默认）
+ *   - Andersen：包含关系的工作表求解（更精确，较慢）
+ * 调用关系优先取 CPGContext 的调用图，否则取直接被调函数。
+ *
+ * 假设（封闭世界）：
+ *   - 翻译单元内有调用点且未取地址的函数，只从这些调用点接收参数；
+ *     其余函数（根函数）的指针形参可指向 External，restrict 形参各自指向独立对象
+ *   - 无函数体的库函数不保存指针参数；间接调用的指针实参逃逸到 External
+ *   - 外部可见的全局变量视为已逃逸
+ */
+#ifndef CPG_POINTS_TO_ANALYSIS_H
+#define CPG_POINTS_TO_ANALYSIS_H
+
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/Expr.h"
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace cpg {
+
+class CPGContext;
+class PointsToSolver;
+
+enum class PointsToMode {
+    Off,            // 不做指针分析，MayAlias 一律为 true
+    Steensgaard,
+    Andersen
+};
+
+const char* PointsToModeName(PointsToMode mode);
+bool ParsePointsToMode(const std::string& text, PointsToMode& mode);
+
+class PointsToAnalysis {
+public:
+    PointsToAnalysis(clang::ASTContext& ctx, const CPGContext* cpgCtx, PointsToMode mode);
+    ~PointsToAnalysis();
+
+    // 为翻译单元内所有函数体与全局初始化生成约束
+    void Run();
+
+    // 两个表达式可能访问重叠的内存：左值比较其所在位置，指针右值比较其指向。
+    // 任一表达式不在模型内（非指针右值、未建模的表达式形式）时保守返回 true
+    bool MayAlias(const clang::Expr* a, const clang::Expr* b);
+
+    PointsToMode GetMode() const { return mode; }
+    size_t ObjectCount() const { return objects.size(); }
+    size_t VariableCount() const;
+    size_t ConstraintCount() const { return constraints; }
+
+private:
+    enum class ObjectKind { Variable, Heap, Literal, Temporary, Restrict, External };
+    struct Object {
+        ObjectKind kind = ObjectKind::Variable;
+        const void* key = nullptr;      // 声明或分配点
+        int var = -1;                   // 对象内容对应的约束变量
+    };
+
+    clang::ASTContext& astContext;
+    const CPGContext* cpgContext;
+    PointsToMode mode;
+    std::unique_ptr<PointsToSolver> solver;
+    bool ran = false;
+    size_t constraints = 0;
+
+    std::vector<Object> objects;
+    std::map<std::pair<ObjectKind, const void*>, int> objectIndex;
+    int externalVar = -1;
+
+    // 根函数（形参来自翻译单元外部）与按值拷贝过的含指针结构体（不拆字段）
+    std::set<const clang::FunctionDecl*> rootFunctions;
+    std::set<const clang::RecordDecl*> collapsedRecords;
+
+    std::map<const clang::Expr*, int> addrMemo;
+    std::map<const clang::Expr*, int> valMemo;
+    std::map<const clang::ValueDecl*, int> declAddrMemo;
+    std::map<const clang::FunctionDecl*, int> returnVars;
+    std::map<const clang::CXXMethodDecl*, int> thisVars;
+    std::map<const clang::CallExpr*, int> callMemo;
+    std::set<const clang::Expr*> generated;
+    mutable std::map<const clang::Type*, bool> hasPointersCache;
+
+    // 约束
+    int NewVar();
+    void AddrOf(int dst, int objectVar);
+    void Copy(int dst, int src);
+    void Load(int dst, int srcPtr);
+    void Store(int dstPtr, int src);
+    void FieldAddr(int dst, int srcPtr, const clang::FieldDecl* field);
+
+    // 对象与特殊变量
+    int ObjectVar(ObjectKind kind, const void* key);
+    int DeclObjectVar(const clang::ValueDecl* decl);
+    int DeclAddr(const clang::ValueDecl* decl);
+    int ReturnVar(const clang::FunctionDecl* func);
+    int ThisVar(const clang::CXXMethodDecl* method);
+    int ExternalPointer();
+    int Join(int a, int b);
+    void StoreTo(int dstAddr, int value);
+    const clang::ValueDecl* CanonicalStorage(const clang::ValueDecl* decl) const;
+    void BindRootParameters(const clang::FunctionDecl* func);
+
+    // 表达式：Addr 为左值所在位置集合，Val 为指针/引用/含指针聚合值的指向集合；-1 表示未建模
+    int Addr(const clang::Expr* expr);
+    int Val(const clang::Expr* expr);
+    int Location(const clang::Expr* expr);
+    int ComputeAddr(const clang::Expr* expr);
+    int ComputeVal(const clang::Expr* expr);
+    int Call(const clang::CallExpr* call);
+    void Construct(const clang::CXXConstructExpr* construct, int targetAddr);
+    void CopyValue(int dstAddr, int srcAddr, clang::QualType type);
+    void Assign(const clang::BinaryOperator* assign);
+    void Initialize(int targetAddr, clang::QualType type, const clang::Expr* init);
+    void Return(const clang::FunctionDecl* func, const clang::Expr* value);
+    void InitializeMembers(const clang::CXXConstructorDecl* ctor);
+
+    // 类型与调用
+    bool IsTracked(clang::QualType type) const;
+    bool HasPointers(clang::QualType type, int depth = 0) const;
+    bool IsCollapsed(const clang::FieldDecl* field) const;
+    void CollapseRecord(const clang::RecordDecl* record);
+    const clang::FunctionDecl* ResolveCallee(const clang::CallExpr* call) const;
+    const clang::CXXMethodDecl* EnclosingMethod(const clang::Expr* expr) const;
+
+    friend class PointsToCollector;
+    friend class PointsToGenerator;
+};
+
+} // namespace cpg
+
+#endif // CPG_POINTS_TO_ANALYSIS_H
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * SIMDCodeEmitter.h - 由计算图生成向量化C++函数
+ *
+ * 以图中已识别的逐元素映射/归约所在的循环为对象，生成与原函数签名一致、
+ * 仅把该循环替换为向量化实现的C++函数（函数名追加 "_<isa>" 后缀）：
+ *   - x86 SSE4.2/AVX2/AVX-512 与 NEON intrinsic，或可移植的 std::experimental::simd
+ *   - 对齐快速路径（所有访问首地址按向量宽度对齐时使用对齐加载/存储）
+ *   - 标量尾部循环（原循环体）
+ *   - #line 指回原始源码位置
+ */
+#ifndef COMPUTE_GRAPH_SIMD_CODE_EMITTER_H
+#define COMPUTE_GRAPH_SIMD_CODE_EMITTER_H
+
+#include "ComputeGraph.h"
+#include "LoopInductionAnalysis.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace compute_graph {
+
+// ============================================
+// 目标指令集上一种元素类型的intrinsic拼写
+// 模板中 %0/%1 为操作数占位符；空串表示不支持
+// ============================================
+struct SIMDIntrinsicSet {
+    std::string isaName;
+    std::string header;             // 需要包含的头文件
+    std::string prelude;            // 文件级前置声明（如 namespace stdx）
+    std::string elementType;        // float / double / int
+    std::string vectorType;
+    std::string lanes;              // 每向量元素数（常量或表达式）
+    std::string alignment;          // 对齐字节数（常量或表达式）
+    std::string compileFlags;       // 本地编译所需的编译选项（如 "-mavx2 -mfma"）
+    std::string cpuFeature;         // 运行前检查的CPU特性（__builtin_cpu_supports），空表示不检查
+
+    std::string loadAligned, loadUnaligned;     // %0 = 地址
+    std::string storeAligned, storeUnaligned;   // %0 = 地址, %1 = 向量
+    std::string broadcast;
+    std::string add, sub, mul, div, min, max, sqrt, abs;
+
+    bool HasAlignedForms() const { return loadAligned != loadUnaligned; }
+
+    // target: sse4.2/avx2/avx512/neon/simd（sve256 用可移植 simd 生成）
+    static bool Get(const std::string& target, const std::string& elementType,
+                    SIMDIntrinsicSet& result);
+};
+
+// ============================================
+// 生成结果
+// ============================================
+struct SIMDEmitResult {
+    bool success = false;
+    std::string reason;             // 失败原因
+    std::string functionName;       // 生成的函数名
+    std::string isaSuffix;          // 函数名/文件名后缀（sse42/avx2/avx512/neon/simd）
+    std::string code;               // 完整源码（头文件 + 函数）
+    std::string preamble;           // 头文件与前置声明部分
+    std::string loopCode;           // 替换原循环的代码块（含 #line）
+    std::string compileFlags;
+    std::string cpuFeature;
+    const clang::Stmt* loopStmt = nullptr;
+    std::string sourceFile;
+    int loopLine = 0;
+};
+
+// ============================================
+// 代码生成器
+// ============================================
+class SIMDCodeEmitter {
+public:
+    SIMDCodeEmitter(clang::ASTContext& ctx, const std::string& target);
+
+    SIMDEmitResult Emit(const ComputeGraph& graph);
+
+    // 生成对象：第一个已识别惯用法所在的最内层循环
+    const clang::Stmt* SelectLoop(const ComputeGraph& graph) const;
+
+    static std::vector<std::string> GetSupportedTargets();
+
+private:
+    // 循环体内一条语句的向量化形式
+    struct VectorStmt {
+        std::string alignedCode;
+        std::string unalignedCode;
+    };
+
+    // 标量累加器
+    struct Reduction {
+        const clang::VarDecl* var = nullptr;
+        std::string name;
+        std::string vectorName;
+        std::string op;             // "+", "*", "min", "max"
+    };
+
+    clang::ASTContext& astContext;
+    std::string targetName;
+    LoopInductionAnalysis inductionAnalysis;
+
+    // 单次生成的状态
+    const ComputeGraph* graph = nullptr;
+    const LoopInductionInfo* loopInfo = nullptr;
+    SIMDIntrinsicSet isa;
+    std::string elementTypeName;
+    clang::QualType elementType;
+    std::map<const clang::VarDecl*, std::string> vectorLocals;
+    std::vector<Reduction> reductions;
+    std::vector<std::string> alignmentChecks;   // 需检查对齐的地址表达式
+    std::set<std::string> alignmentCheckSet;
+    std::set<std::string> staticallyAligned;    // 【新增】对齐分析证明循环入口已对齐的地址
+    std::string failure;
+
+    bool DetermineElementType(const clang::Stmt* body);
+    bool CheckDependences() const;
+
+    bool TranslateStmt(const clang::Stmt* stmt, VectorStmt& out);
+    bool TranslateStore(const clang::BinaryOperator* binOp, const clang::ArraySubscriptExpr* target,
+                        VectorStmt& out);
+    bool TranslateReduction(const clang::Stmt* update, const std::string& idiom, VectorStmt& out);
+    bool TranslateExpr(const clang::Expr* expr, bool aligned, std::string& out);
+    bool TranslateAccess(const clang::ArraySubscriptExpr* access, bool aligned, std::string& out);
+
+    std::string GetText(const clang::Stmt* stmt) const;
+    std::string GetText(clang::SourceLocation begin, clang::SourceLocation end) const;
+    bool Fail(const std::string& reason);
+};
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_SIMD_CODE_EMITTER_H
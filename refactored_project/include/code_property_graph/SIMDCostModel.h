@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * SIMDCostModel.h - 计算图向量化收益估计（可插拔代价模型）
+ *
+ * 对每个计算图估计：每元素标量代价、访存量（按访问步长区分连续/跨步/gather）、
+ * 目标SIMD指令集上的每元素向量代价，得到预估加速比，用于排序与剪枝。
+ */
+#ifndef COMPUTE_GRAPH_SIMD_COST_MODEL_H
+#define COMPUTE_GRAPH_SIMD_COST_MODEL_H
+
+#include "ComputeGraph.h"
+#include "IntrinsicSemantics.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace compute_graph {
+
+enum class SIMDTarget {
+    SSE42,
+    AVX2,
+    AVX512,
+    NEON,
+    SVE256
+};
+
+// ============================================
+// 目标描述
+// ============================================
+struct SIMDTargetInfo {
+    SIMDTarget target = SIMDTarget::AVX2;
+    std::string name;
+    int vectorBits = 256;
+    bool hasGather = false;         // 硬件gather
+    bool hasMasking = false;        // 谓词/掩码（尾部与条件执行）
+    bool hasStructLoads = false;    // 交织加载 (vld2/3/4, ld2/3/4)
+    bool hasNativeFP16 = false;     // 原生半精度算术
+    bool hasNativeBF16 = false;     // 原生bf16点积/转换
+    Microarch uarch = Microarch::SkylakeX;  // 查询intrinsic代价时使用的微架构
+
+    static SIMDTargetInfo Get(SIMDTarget target);
+};
+
+// ============================================
+// 估计结果
+// ============================================
+struct CostEstimate {
+    std::string targetName;
+    bool vectorizable = false;
+    std::string reason;             // 不可向量化/收益受限的原因
+
+    int lanes = 1;                  // 向量化因子（按最宽元素类型）
+    double scalarCost = 0.0;        // 每元素标量代价（周期）
+    double vectorCost = 0.0;        // 每元素向量代价（周期）
+    double memoryBytes = 0.0;       // 每元素访存字节数
+    double speedup = 1.0;
+
+    int contiguousAccesses = 0;
+    int stridedAccesses = 0;
+    int gatherAccesses = 0;
+    int assumedStrideAccesses = 0;  // 无步长信息、按连续处理的访问
+    int alignedAccesses = 0;        // 【新增】循环入口已按向量宽度对齐的连续访问
+
+    // 【新增】值域分析给出的迭代次数（图属性 trip_count_*）
+    int64_t tripCountMin = 0;
+    int64_t tripCountMax = -1;      // -1 表示无上界
+    uint64_t tripCountMultiple = 1; // 迭代次数一定是它的倍数
+    bool needsRemainder = true;     // 迭代次数不一定是 lanes 的倍数，需要标量尾循环
+    bool peelForAlignment = true;   // 迭代次数未知或足够长，值得做对齐剥离/多版本化
+
+    std::string ToString() const;
+};
+
+// ============================================
+// 代价模型接口
+// ============================================
+class CostModel {
+public:
+    virtual ~CostModel() = default;
+
+    virtual std::string GetName() const = 0;
+    virtual CostEstimate Estimate(const ComputeGraph& graph) const = 0;
+
+    // 估计并把结果写入图属性（cost_*、vectorizable）
+    CostEstimate Annotate(ComputeGraph& graph) const;
+};
+
+// ============================================
+// 基于目标指令集的默认代价模型
+// ============================================
+class SIMDCostModel : public CostModel {
+public:
+    explicit SIMDCostModel(SIMDTarget target);
+
+    std::string GetName() const override { return targetInfo.name; }
+    CostEstimate Estimate(const ComputeGraph& graph) const override;
+
+    const SIMDTargetInfo& GetTargetInfo() const { return targetInfo; }
+
+private:
+    SIMDTargetInfo targetInfo;
+
+    double ScalarOpCost(const ComputeNode& node) const;
+    double VectorOpCost(const ComputeNode& node, int lanes) const;
+    double MemoryAccessCost(const ComputeNode& node, int lanes, CostEstimate& est) const;
+    bool IsInLoopBody(const ComputeNode& node) const;
+    int ElementBits(const ComputeNode& node) const;
+    void ReadTripCount(const ComputeGraph& graph, CostEstimate& est) const;
+};
+
+// 按名字创建代价模型：sse4.2 / avx2 / avx512 / neon / sve256，未知返回nullptr
+std::unique_ptr<CostModel> CreateCostModel(const std::string& targetName);
+std::vector<std::string> GetSupportedSIMDTargets();
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_SIMD_COST_MODEL_H
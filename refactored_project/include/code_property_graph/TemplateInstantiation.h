@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * TemplateInstantiation.h - 函数模板实例化感知的计算图
+ *
+ * 模板函数的锚点查找与分簇只在模式（getTemplatedDecl）上做一次，每个具体实例
+ * （FunctionTemplateDecl::specializations）共享这份类型无关的骨架：
+ *   - 模式上的锚点簇按语句对应关系映射到实例的函数体
+ *   - 实例的 CPG 与计算图在实例自身的 AST 上构建，依赖模板参数的调用按实例解析与展开，
+ *     类型相关的分析（值域、对齐、依赖、惯用法、代价）都按实例的具体类型计算
+ *   - 实例的源码文本就是模式的文本（含模板参数），向量代码生成与微基准跳过实例图
+ * 实例语句与模式语句按源码位置 + 语句类对应（实例化保留模式的 SourceLocation）。
+ */
+#ifndef COMPUTE_GRAPH_TEMPLATE_INSTANTIATION_H
+#define COMPUTE_GRAPH_TEMPLATE_INSTANTIATION_H
+
+#include "ComputeGraph.h"
+#include "ComputeGraphAnchor.h"
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace compute_graph {
+
+// ============================================
+// 一个具体实例
+// ============================================
+struct TemplateInstantiation {
+    const clang::FunctionDecl* pattern = nullptr;   // 模板的模式函数
+    const clang::FunctionDecl* instance = nullptr;  // 实例（有函数体）
+    std::string argsText;                           // 模板实参（如 "<float>"）
+    std::string name;                               // 实例名（如 "dot<float>"）
+};
+
+// 模式函数的所有带函数体的实例（隐式实例化与显式实例化定义）；非模板函数返回空
+std::vector<TemplateInstantiation> CollectTemplateInstantiations(
+    const clang::FunctionDecl* pattern, clang::ASTContext& ctx);
+
+// ============================================
+// 模式语句 -> 实例语句
+// ============================================
+class InstantiationMapper {
+public:
+    explicit InstantiationMapper(const clang::FunctionDecl* instance);
+
+    // 优先同源码区间且同语句类；否则取同区间最外层的非隐式语句；没有对应返回nullptr
+    const clang::Stmt* MapStmt(const clang::Stmt* patternStmt) const;
+
+private:
+    using RangeKey = std::pair<unsigned, unsigned>;     // 起止位置的原始编码
+
+    std::map<std::tuple<unsigned, unsigned, unsigned>, const clang::Stmt*> byClass;
+    std::map<RangeKey, const clang::Stmt*> byRange;
+
+    friend class InstantiationIndexer;
+};
+
+// ============================================
+// 模式上的锚点簇 -> 实例上的锚点簇
+// 映射不到实例语句的锚点丢弃；全部丢弃时返回false
+// ============================================
+bool SpecializeCluster(const AnchorCluster& patternCluster, const TemplateInstantiation& inst,
+                       const InstantiationMapper& mapper, AnchorCluster& instanceCluster);
+
+// 模板实例的显示名（如 "dot<float>"）；不是函数模板实例时返回函数名
+std::string GetInstanceName(const clang::FunctionDecl* func, clang::ASTContext& ctx);
+
+} // namespace compute_graph
+
+#endif // COMPUTE_GRAPH_TEMPLATE_INSTANTIATION_H
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * ValueRangeAnalysis.h - 整型局部变量的值域分析（区间 × 同余，抽象解释）
+ *
+ * 在 CFG 上做前向抽象解释，每个变量的抽象值为 [lo, hi] ∩ { x | x ≡ r (mod m) }：
+ *   - 块入口合并前驱出口，分支/循环条件与 switch 标签在边上收紧取值
+ *   - 循环头（有回边的块）先合并若干次再加宽，收敛后做有限次收窄
+ *   - 只跟踪“值只经由读/赋值/自增自减使用”的局部整型变量与形参，
+ *     取地址、按引用绑定或被 lambda 捕获的变量视为未知
+ * 结果按 CFG 元素保存，CFG 取自 CPGContext（已释放或未构建时临时构建）。
+ */
+#ifndef CPG_VALUE_RANGE_ANALYSIS_H
+#define CPG_VALUE_RANGE_ANALYSIS_H
+
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/Expr.h"
+#include "clang/Analysis/CFG.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+namespace cpg {
+
+class CPGContext;
+
+// ============================================
+// 抽象值：区间与同余的约化积
+// ============================================
+struct ValueRange {
+    static constexpr int64_t kNegInf = INT64_MIN;   // lo 取此值表示无下界
+    static constexpr int64_t kPosInf = INT64_MAX;   // hi 取此值表示无上界
+
+    bool empty = false;             // 不可达/无可能取值
+    int64_t lo = kNegInf;
+    int64_t hi = kPosInf;
+    uint64_t modulus = 1;           // 0 表示常量 residue，1 表示无同余信息
+    int64_t residue = 0;            // modulus > 0 时位于 [0, modulus)
+
+    static ValueRange Top() { return ValueRange(); }
+    static ValueRange Bottom();
+    static ValueRange Constant(int64_t value);
+    static ValueRange Interval(int64_t lo, int64_t hi);
+    static ValueRange OfType(clang::QualType type, const clang::ASTContext& ctx);
+
+    bool IsTop() const { return !empty && lo == kNegInf && hi == kPosInf && modulus == 1; }
+    bool IsConstant() const { return !empty && modulus == 0; }
+    bool HasLower() const { return !empty && lo != kNegInf; }
+    bool HasUpper() const { return !empty && hi != kPosInf; }
+    bool Contains(const ValueRange& other) const;
+
+    // 值一定是 k 的倍数时返回最大的这种 k（常量返回其绝对值，0 返回 0），否则 1
+    uint64_t KnownMultiple() const;
+
+    bool operator==(const ValueRange& other) const;
+    bool operator!=(const ValueRange& other) const { return !(*this == other); }
+
+    // 格运算
+    ValueRange Join(const ValueRange& other) const;
+    ValueRange Meet(const ValueRange& other) const;
+    ValueRange Widen(const ValueRange& next) const;
+    ValueRange Narrow(const ValueRange& next) const;
+
+    // 算术（溢出的边界视为无界）
+    ValueRange Add(const ValueRange& other) const;
+    ValueRange Sub(const ValueRange& other) const;
+    ValueRange Mul(const ValueRange& other) const;
+    ValueRange Div(const ValueRange& other) const;      // 向零截断
+    ValueRange Rem(const ValueRange& other) const;
+    ValueRange Shl(const ValueRange& other) const;
+    ValueRange Shr(const ValueRange& other) const;
+    ValueRange And(const ValueRange& other) const;
+    ValueRange Or(const ValueRange& other) const;
+    ValueRange Xor(const ValueRange& other) const;
+    ValueRange Neg() const;
+    ValueRange Not() const;
+
+    // 转换到整型 type：超出可表示范围时按回绕处理，只保留 2 的幂次同余；
+    // wraps 为 false（有符号算术，溢出为未定义行为）时截断到类型范围
+    ValueRange CastTo(clang::QualType type, const clang::ASTContext& ctx, bool wraps = true) const;
+
+    // "[0, 15]"、"[8, +inf) mod 8 = 0"、"{16}"、"empty"
+    std::string ToString() const;
+
+    void Normalize();
+};
+
+// 迭代次数：归纳变量从 start 起每次加 step，按 "iv <compareOp> bound" 判定是否继续
+// （compareOp 为归一化的 < <= > >= !=）；不可推断时返回 [0, +inf)
+ValueRange LoopTripCount(const ValueRange& start, const ValueRange& bound, int64_t step,
+                         const std::string& compareOp);
+
+// ============================================
+// 分析器（按函数缓存，首次查询时分析）
+// ============================================
+class ValueRangeAnalysis {
+public:
+    ValueRangeAnalysis(clang::ASTContext& ctx, const CPGContext* cpgCtx);
+    ~ValueRangeAnalysis();
+
+    // 表达式求值处的取值；不在已分析函数体内或非整型时返回其类型的取值范围
+    ValueRange GetRange(const clang::Expr* expr);
+
+    // 变量在语句执行前的取值（语句须为 CFG 元素或其子表达式）
+    ValueRange GetRangeBefore(const clang::Stmt* stmt, const clang::VarDecl* var);
+
+    // 循环首次进入条件判断时变量的取值（只合并来自循环外的边）
+    ValueRange GetLoopEntryRange(const clang::Stmt* loopStmt, const clang::VarDecl* var);
+
+    // 变量在循环头（每次条件判断前）的取值
+    ValueRange GetLoopHeadRange(const clang::Stmt* loopStmt, const clang::VarDecl* var);
+
+    // 丢弃函数的分析结果（与 CPGContext::ReleaseFunction 同步）
+    void Release(const clang::FunctionDecl* func);
+
+    size_t AnalyzedFunctionCount() const { return results.size(); }
+
+private:
+    struct State {
+        bool reachable = false;
+        std::map<const clang::VarDecl*, ValueRange> vars;   // 缺省为变量类型的取值范围
+
+        bool operator==(const State& other) const
+        {
+            return reachable == other.reachable && vars == other.vars;
+        }
+        bool operator!=(const State& other) const { return !(*this == other); }
+    };
+
+    struct FunctionResult {
+        bool converged = false;
+        std::set<const clang::VarDecl*> tracked;
+        std::set<const clang::Stmt*> elements;                  // 全部 CFG 元素语句
+        std::map<const clang::Stmt*, State> before;             // 元素执行前的状态
+        std::map<const clang::Expr*, ValueRange> values;        // 元素表达式的取值
+        std::map<const clang::Stmt*, State> loopEntry;          // 循环语句 -> 进入时状态
+        std::map<const clang::Stmt*, State> loopHead;           // 循环语句 -> 循环头状态
+    };
+
+    clang::ASTContext& astContext;
+    const CPGContext* cpgContext;
+    std::map<const clang::FunctionDecl*, std::unique_ptr<FunctionResult>> results;
+
+    // 当前正在分析/查询的函数
+    FunctionResult* current = nullptr;
+    const clang::Stmt* currentElement = nullptr;
+
+    FunctionResult* ResultFor(const clang::Stmt* stmt);
+    const clang::FunctionDecl* ContainingFunction(const clang::Stmt* stmt) const;
+    void Analyze(const clang::FunctionDecl* func, FunctionResult& result);
+    void CollectTracked(const clang::FunctionDecl* func, FunctionResult& result) const;
+    const clang::Stmt* EnclosingElement(const clang::Stmt* stmt) const;
+
+    // 转移函数
+    void Transfer(const clang::Stmt* element, State& state);
+    ValueRange Eval(const clang::Expr* expr, State& state);
+    ValueRange EvalBinary(const clang::BinaryOperator* binOp, State& state);
+    ValueRange EvalUnary(const clang::UnaryOperator* unaryOp, State& state);
+    ValueRange EvalCast(const clang::CastExpr* cast, State& state);
+    ValueRange ReadVar(const clang::VarDecl* var, const State& state) const;
+    void WriteVar(const clang::VarDecl* var, const ValueRange& value, State& state) const;
+    const clang::VarDecl* TrackedVar(const clang::Expr* expr) const;
+    void EvalChildren(const clang::Stmt* stmt, State& state);
+
+    // 边上的条件收紧；返回 false 表示该边不可行
+    bool Refine(const clang::Expr* cond, bool truth, State& state);
+    bool RefineComparison(const clang::Expr* lhs, const clang::Expr* rhs,
+                          clang::BinaryOperatorKind op, State& state);
+    bool RefineVar(const clang::Expr* expr, const ValueRange& constraint, State& state);
+    bool RefineEdge(const clang::CFGBlock* block, unsigned succIndex,
+                    const clang::CFGBlock* succ, State& state);
+
+    State JoinStates(const State& a, const State& b) const;
+    State WidenStates(const State& older, const State& newer) const;
+    State NarrowStates(const State& older, const State& newer) const;
+};
+
+} // namespace cpg
+
+#endif // CPG_VALUE_RANGE_ANALYSIS_H
@@ -0,0 +1,805 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * AlignmentAnalysis.cpp - 指针与内存访问地址的对齐分析实现
+ */
+#include "code_property_graph/AlignmentAnalysis.h"
+#include "code_property_graph/CPGAnnotation.h"
+
+#include "clang/AST/Attr.h"
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/ExprCXX.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+#include "clang/Basic/Builtins.h"
+#include "clang/Basic/TargetInfo.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace cpg {
+
+namespace {
+
+constexpr int kMaxDepth = 64;           // 表达式/跨函数递归深度上限
+constexpr int kMaxSolveRounds = 128;    // 每个变量的格高度不超过 34，正常远小于此值
+
+// 能整除 value 的最大 2 的幂（value == 0 时返回 kMaxAlign）
+uint64_t PowerOfTwoFactor(uint64_t value)
+{
+    if (value == 0) return Alignment::kMaxAlign;
+    return std::min<uint64_t>(value & (~value + 1), Alignment::kMaxAlign);
+}
+
+uint64_t ModPositive(__int128 value, uint64_t modulus)
+{
+    __int128 r = value % static_cast<__int128>(modulus);
+    return static_cast<uint64_t>(r < 0 ? r + modulus : r);
+}
+
+bool ReferencesVar(const clang::Stmt* stmt, const clang::VarDecl* var)
+{
+    if (!stmt) return false;
+    if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(stmt)) {
+        return ref->getDecl() == var;
+    }
+    for (const clang::Stmt* child : stmt->children()) {
+        if (ReferencesVar(child, var)) return true;
+    }
+    return false;
+}
+
+std::string CalleeName(const clang::FunctionDecl* callee)
+{
+    const clang::IdentifierInfo* id = callee ? callee->getIdentifier() : nullptr;
+    if (!id) return "";
+    // 只认全局或 std 命名空间中的 C 分配函数
+    const clang::DeclContext* dc = callee->getDeclContext()->getRedeclContext();
+    if (!dc->isTranslationUnit() && !dc->isStdNamespace() && !dc->isExternCContext()) return "";
+    return id->getName().str();
+}
+
+struct DepthGuard {
+    int& value;
+    explicit DepthGuard(int& v) : value(v) { ++value; }
+    ~DepthGuard() { --value; }
+};
+
+// 局部指针变量的使用情况与定义
+class PointerVarScanner : public clang::RecursiveASTVisitor<PointerVarScanner> {
+public:
+    struct Use {
+        size_t refs = 0;
+        size_t plainUses = 0;
+    };
+    std::map<const clang::VarDecl*, Use> uses;
+    std::set<const clang::VarDecl*> escaped;
+    std::vector<const clang::VarDecl*> locals;
+
+    struct RawDefinition {
+        const clang::VarDecl* var = nullptr;
+        const clang::Expr* value = nullptr;
+        const clang::Expr* delta = nullptr;
+        bool subtract = false;
+        int64_t step = 0;
+        const clang::Expr* alignArg = nullptr;
+    };
+    std::vector<RawDefinition> definitions;
+
+    bool VisitDeclRefExpr(clang::DeclRefExpr* ref)
+    {
+        if (auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl())) {
+            uses[var].refs++;
+            if (ref->refersToEnclosingVariableOrCapture()) escaped.insert(var);
+        }
+        return true;
+    }
+
+    bool VisitImplicitCastExpr(clang::ImplicitCastExpr* cast)
+    {
+        if (cast->getCastKind() == clang::CK_LValueToRValue) {
+            PlainVar(cast->getSubExpr());
+        }
+        return true;
+    }
+
+    bool VisitBinaryOperator(clang::BinaryOperator* binOp)
+    {
+        if (!binOp->isAssignmentOp()) return true;
+        const clang::VarDecl* var = PlainVar(binOp->getLHS());
+        if (!var) return true;
+        RawDefinition def;
+        def.var = var;
+        if (binOp->getOpcode() == clang::BO_Assign) {
+            def.value = binOp->getRHS();
+        } else if (binOp->getOpcode() == clang::BO_AddAssign || binOp->getOpcode() == clang::BO_SubAssign) {
+            def.delta = binOp->getRHS();
+            def.subtract = binOp->getOpcode() == clang::BO_SubAssign;
+        }
+        definitions.push_back(def);
+        return true;
+    }
+
+    bool VisitUnaryOperator(clang::UnaryOperator* unaryOp)
+    {
+        if (!unaryOp->isIncrementDecrementOp()) return true;
+        if (const clang::VarDecl* var = PlainVar(unaryOp->getSubExpr())) {
+            RawDefinition def;
+            def.var = var;
+            def.step = unaryOp->isIncrementOp() ? 1 : -1;
+            definitions.push_back(def);
+        }
+        return true;
+    }
+
+    bool VisitVarDecl(clang::VarDecl* var)
+    {
+        if (llvm::isa<clang::ParmVarDecl>(var)) return true;
+        locals.push_back(var);
+        if (const clang::Expr* init = var->getInit()) {
+            if (const auto* list = llvm::dyn_cast<clang::InitListExpr>(init->IgnoreParens())) {
+                init = list->getNumInits() == 1 ? list->getInit(0) : nullptr;
+            }
+            RawDefinition def;
+            def.var = var;
+            def.value = init;
+            definitions.push_back(def);
+        }
+        return true;
+    }
+
+    // posix_memalign(&p, A, n)：&p 只作为出参
+    bool VisitCallExpr(clang::CallExpr* call)
+    {
+        if (CalleeName(call->getDirectCallee()) != "posix_memalign" || call->getNumArgs() < 2) return true;
+        const auto* addrOf = llvm::dyn_cast<clang::UnaryOperator>(call->getArg(0)->IgnoreParenImpCasts());
+        if (!addrOf || addrOf->getOpcode() != clang::UO_AddrOf) return true;
+        if (const clang::VarDecl* var = PlainVar(addrOf->getSubExpr())) {
+            RawDefinition def;
+            def.var = var;
+            def.alignArg = call->getArg(1);
+            definitions.push_back(def);
+        }
+        return true;
+    }
+
+    bool TraverseLambdaExpr(clang::LambdaExpr* lambda)
+    {
+        for (const clang::LambdaCapture& capture : lambda->captures()) {
+            if (capture.capturesVariable()) {
+                if (auto* var = llvm::dyn_cast<clang::VarDecl>(capture.getCapturedVar())) {
+                    escaped.insert(var);
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    const clang::VarDecl* PlainVar(const clang::Expr* expr)
+    {
+        const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(expr->IgnoreParens());
+        const auto* var = ref ? llvm::dyn_cast<clang::VarDecl>(ref->getDecl()) : nullptr;
+        if (var) uses[var].plainUses++;
+        return var;
+    }
+};
+
+// 翻译单元内的直接调用点与取地址的函数
+class CallSiteCollector : public clang::RecursiveASTVisitor<CallSiteCollector> {
+public:
+    explicit CallSiteCollector(const CPGContext* ctx) : cpgContext(ctx) {}
+
+    std::map<const clang::FunctionDecl*, std::vector<const clang::CallExpr*>> callSites;
+    std::set<const clang::DeclRefExpr*> calleeRefs;
+    std::map<const clang::DeclRefExpr*, const clang::FunctionDecl*> functionRefs;
+
+    bool shouldVisitTemplateInstantiations() const { return true; }
+    bool shouldVisitImplicitCode() const { return true; }
+
+    bool VisitCallExpr(clang::CallExpr* call)
+    {
+        const clang::FunctionDecl* target = cpgContext ? cpgContext->GetCallTarget(call) : nullptr;
+        if (!target) target = call->getDirectCallee();
+        if (target) callSites[target->getCanonicalDecl()].push_back(call);
+        if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(call->getCallee()->IgnoreParenImpCasts())) {
+            calleeRefs.insert(ref);
+        }
+        return true;
+    }
+
+    bool VisitDeclRefExpr(clang::DeclRefExpr* ref)
+    {
+        if (const auto* func = llvm::dyn_cast<clang::FunctionDecl>(ref->getDecl())) {
+            functionRefs[ref] = func->getCanonicalDecl();
+        }
+        return true;
+    }
+
+private:
+    const CPGContext* cpgContext;
+};
+
+} // namespace
+
+// ============================================
+// Alignment
+// ============================================
+
+Alignment Alignment::Bottom()
+{
+    Alignment result;
+    result.empty = true;
+    return result;
+}
+
+Alignment Alignment::Aligned(uint64_t bytes, uint64_t misalign)
+{
+    Alignment result;
+    // 非 2 的幂（如 assume_aligned(24)）只能保证其中 2 的幂因子
+    result.align = bytes == 0 ? 1 : PowerOfTwoFactor(bytes);
+    result.offset = misalign % result.align;
+    return result;
+}
+
+uint64_t Alignment::KnownAlignment() const
+{
+    if (empty) return kMaxAlign;
+    return offset == 0 ? align : PowerOfTwoFactor(offset);
+}
+
+Alignment Alignment::Join(const Alignment& other) const
+{
+    if (empty) return other;
+    if (other.empty) return *this;
+
+    Alignment result;
+    uint64_t common = std::min(align, other.align);
+    uint64_t diff = ModPositive(static_cast<__int128>(offset) - other.offset, common);
+    result.align = diff == 0 ? common : PowerOfTwoFactor(diff);
+    result.offset = offset % result.align;
+    return result;
+}
+
+Alignment Alignment::Offset(const ValueRange& bytes) const
+{
+    if (empty || bytes.empty) return Bottom();
+
+    Alignment result;
+    if (bytes.IsConstant()) {
+        result.align = align;
+    } else {
+        result.align = std::min(align, bytes.modulus <= 1 ? uint64_t(1) : PowerOfTwoFactor(bytes.modulus));
+    }
+    result.offset = ModPositive(static_cast<__int128>(offset) + bytes.residue, result.align);
+    return result;
+}
+
+std::string Alignment::ToString() const
+{
+    if (empty) return "empty";
+    std::ostringstream oss;
+    oss << align;
+    if (offset != 0) oss << "+" << offset;
+    return oss.str();
+}
+
+// ============================================
+// AlignmentAnalysis
+// ============================================
+
+AlignmentAnalysis::AlignmentAnalysis(clang::ASTContext& ctx, const CPGContext* cpgCtx)
+    : astContext(ctx), cpgContext(cpgCtx)
+{}
+
+AlignmentAnalysis::~AlignmentAnalysis() = default;
+
+void AlignmentAnalysis::Release(const clang::FunctionDecl* func)
+{
+    if (func) functions.erase(func->getCanonicalDecl());
+}
+
+uint64_t AlignmentAnalysis::MallocAlignment() const
+{
+    // malloc 与默认 operator new 都保证 __STDCPP_DEFAULT_NEW_ALIGNMENT__
+    return std::max<uint64_t>(1, astContext.getTargetInfo().getNewAlign() / 8);
+}
+
+bool AlignmentAnalysis::EvaluateAlign(const clang::Expr* expr, uint64_t& value) const
+{
+    if (!expr || expr->isValueDependent()) return false;
+    clang::Expr::EvalResult eval;
+    if (!expr->EvaluateAsInt(eval, astContext)) return false;
+    const llvm::APSInt& result = eval.Val.getInt();
+    if (result.isNegative() || result.getActiveBits() > 63) return false;
+    value = result.getZExtValue();
+    return true;
+}
+
+ValueRange AlignmentAnalysis::IndexRange(const clang::Expr* index)
+{
+    if (cpgContext) return cpgContext->GetValueRanges().GetRange(index);
+    uint64_t value;
+    if (EvaluateAlign(index, value)) return ValueRange::Constant(static_cast<int64_t>(value));
+    return ValueRange::OfType(index->getType(), astContext);
+}
+
+Alignment AlignmentAnalysis::TypeAlignment(clang::QualType pointee) const
+{
+    if (pointee.isNull() || pointee->isDependentType() || pointee->isVoidType() ||
+        pointee->isFunctionType() || pointee->isIncompleteType()) {
+        return Alignment::Unknown();
+    }
+    return Alignment::Aligned(static_cast<uint64_t>(astContext.getTypeAlignInChars(pointee).getQuantity()));
+}
+
+// 合法访问的地址至少按其类型对齐：x ≡ o (mod a) 与 x ≡ 0 (mod t) 相容且 a <= t 时取后者
+Alignment AlignmentAnalysis::WithTypeAlignment(const Alignment& value, clang::QualType type) const
+{
+    Alignment byType = TypeAlignment(type);
+    if (value.empty || value.align > byType.align || value.offset != 0) return value;
+    return byType;
+}
+
+Alignment AlignmentAnalysis::AddElements(const Alignment& base, const clang::Expr* count,
+                                         clang::QualType pointee, bool subtract)
+{
+    if (pointee.isNull() || pointee->isDependentType() || pointee->isFunctionType()) {
+        return Alignment::Unknown();
+    }
+    // GNU 扩展：void* 算术按 1 字节
+    int64_t size = pointee->isVoidType() ? 1 :
+        (pointee->isIncompleteType() ? 0 : astContext.getTypeSizeInChars(pointee).getQuantity());
+    if (size <= 0) return Alignment::Unknown();
+
+    ValueRange bytes = IndexRange(count).Mul(ValueRange::Constant(size));
+    return base.Offset(subtract ? bytes.Neg() : bytes);
+}
+
+// ============================================
+// 指针右值
+// ============================================
+
+Alignment AlignmentAnalysis::GetPointerAlignment(const clang::Expr* pointer)
+{
+    if (!pointer) return Alignment::Unknown();
+    pointer = pointer->IgnoreParens();
+    clang::QualType type = pointer->getType();
+    if (type->isArrayType()) return GetObjectAlignment(pointer);
+    if (!type->isPointerType()) return Alignment::Unknown();
+    clang::QualType pointee = type->getPointeeType();
+    if (depth > kMaxDepth || pointer->isValueDependent()) return TypeAlignment(pointee);
+
+    DepthGuard guard(depth);
+
+    if (const auto* cast = llvm::dyn_cast<clang::CastExpr>(pointer)) {
+        switch (cast->getCastKind()) {
+            case clang::CK_ArrayToPointerDecay:
+                return GetObjectAlignment(cast->getSubExpr());
+            case clang::CK_LValueToRValue: {
+                const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(cast->getSubExpr()->IgnoreParens());
+                const auto* var = ref ? llvm::dyn_cast<clang::VarDecl>(ref->getDecl()) : nullptr;
+                return var ? VarAlignment(var) : TypeAlignment(pointee);
+            }
+            case clang::CK_NoOp:
+            case clang::CK_BitCast:
+            case clang::CK_LValueBitCast:
+            case clang::CK_AddressSpaceConversion:
+                // 只改变类型，地址不变
+                return GetPointerAlignment(cast->getSubExpr());
+            default:
+                return TypeAlignment(pointee);
+        }
+    }
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(pointer)) {
+        if (unaryOp->getOpcode() == clang::UO_AddrOf) {
+            return GetObjectAlignment(unaryOp->getSubExpr());
+        }
+        return TypeAlignment(pointee);
+    }
+    if (const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(pointer)) {
+        switch (binOp->getOpcode()) {
+            case clang::BO_Add:
+            case clang::BO_Sub: {
+                bool lhsPointer = binOp->getLHS()->getType()->isPointerType() ||
+                                  binOp->getLHS()->getType()->isArrayType();
+                const clang::Expr* base = lhsPointer ? binOp->getLHS() : binOp->getRHS();
+                const clang::Expr* count = lhsPointer ? binOp->getRHS() : binOp->getLHS();
+                return AddElements(GetPointerAlignment(base), count, pointee,
+                                   binOp->getOpcode() == clang::BO_Sub);
+            }
+            case clang::BO_Assign:
+            case clang::BO_Comma:
+                return GetPointerAlignment(binOp->getRHS());
+            default:
+                return TypeAlignment(pointee);
+        }
+    }
+    if (const auto* cond = llvm::dyn_cast<clang::ConditionalOperator>(pointer)) {
+        return GetPointerAlignment(cond->getTrueExpr()).Join(GetPointerAlignment(cond->getFalseExpr()));
+    }
+    if (const auto* call = llvm::dyn_cast<clang::CallExpr>(pointer)) {
+        return CallAlignment(call);
+    }
+    if (const auto* newExpr = llvm::dyn_cast<clang::CXXNewExpr>(pointer)) {
+        return NewAlignment(newExpr);
+    }
+    if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(pointer)) {
+        if (const auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl())) {
+            return VarAlignment(var);
+        }
+    }
+    return TypeAlignment(pointee);
+}
+
+Alignment AlignmentAnalysis::CallAlignment(const clang::CallExpr* call)
+{
+    clang::QualType pointee = call->getType()->isPointerType() ? call->getType()->getPointeeType() :
+                                                                 clang::QualType();
+    const clang::FunctionDecl* callee = call->getDirectCallee();
+    if (!callee) return TypeAlignment(pointee);
+
+    uint64_t align = 0;
+    uint64_t offset = 0;
+    if (callee->getBuiltinID() == clang::Builtin::BI__builtin_assume_aligned) {
+        // (p - off) 按 A 对齐
+        if (call->getNumArgs() >= 2 && EvaluateAlign(call->getArg(1), align)) {
+            if (call->getNumArgs() >= 3) EvaluateAlign(call->getArg(2), offset);
+            return Alignment::Aligned(align, offset);
+        }
+        return GetPointerAlignment(call->getArg(0));
+    }
+
+    std::string name = CalleeName(callee);
+    if (name == "malloc" || name == "calloc" || name == "realloc") {
+        return Alignment::Aligned(MallocAlignment());
+    }
+    if ((name == "aligned_alloc" || name == "memalign") && call->getNumArgs() == 2 &&
+        EvaluateAlign(call->getArg(0), align)) {
+        return Alignment::Aligned(std::max(align, MallocAlignment()));
+    }
+    if ((name == "_mm_malloc" || name == "_aligned_malloc") && call->getNumArgs() == 2 &&
+        EvaluateAlign(call->getArg(1), align)) {
+        return Alignment::Aligned(align);
+    }
+
+    if (const auto* attr = callee->getAttr<clang::AssumeAlignedAttr>()) {
+        if (EvaluateAlign(attr->getAlignment(), align)) {
+            if (attr->getOffset()) EvaluateAlign(attr->getOffset(), offset);
+            return Alignment::Aligned(align, offset);
+        }
+    }
+    if (const auto* attr = callee->getAttr<clang::AllocAlignAttr>()) {
+        unsigned index = attr->getParamIndex().getASTIndex();
+        if (index < call->getNumArgs() && EvaluateAlign(call->getArg(index), align)) {
+            return Alignment::Aligned(align);
+        }
+    }
+    return TypeAlignment(pointee);
+}
+
+Alignment AlignmentAnalysis::NewAlignment(const clang::CXXNewExpr* newExpr)
+{
+    clang::QualType allocated = newExpr->getAllocatedType();
+    const clang::FunctionDecl* operatorNew = newExpr->getOperatorNew();
+
+    // 保留的放置 new 直接返回放置地址
+    if (operatorNew && operatorNew->isReservedGlobalPlacementOperator() &&
+        newExpr->getNumPlacementArgs() == 1) {
+        return GetPointerAlignment(newExpr->getPlacementArg(0));
+    }
+    // 类自定义/其他放置形式的 operator new 只保证类型对齐
+    if (!operatorNew || operatorNew->getDeclContext()->isRecord() || newExpr->getNumPlacementArgs() > 0) {
+        return TypeAlignment(allocated);
+    }
+    // 非平凡析构的数组 new 在分配首部放置元素个数 cookie，返回地址偏移
+    if (newExpr->isArray()) {
+        const clang::CXXRecordDecl* record = astContext.getBaseElementType(allocated)->getAsCXXRecordDecl();
+        if (record && record->hasDefinition() && !record->hasTrivialDestructor()) {
+            return TypeAlignment(allocated);
+        }
+    }
+    Alignment byType = TypeAlignment(allocated);
+    return Alignment::Aligned(std::max<uint64_t>(byType.align, MallocAlignment()));
+}
+
+// ============================================
+// 左值对象与访问
+// ============================================
+
+Alignment AlignmentAnalysis::GetObjectAlignment(const clang::Expr* lvalue)
+{
+    if (!lvalue) return Alignment::Unknown();
+    lvalue = lvalue->IgnoreParens();
+    clang::QualType type = lvalue->getType();
+    if (depth > kMaxDepth || lvalue->isValueDependent()) return TypeAlignment(type);
+
+    DepthGuard guard(depth);
+
+    if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(lvalue)) {
+        const auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl());
+        if (!var || var->getType()->isReferenceType() || var->getType()->isDependentType() ||
+            var->getType()->isIncompleteType()) {
+            return TypeAlignment(type);
+        }
+        // getDeclAlign 含 alignas/aligned 属性
+        return Alignment::Aligned(static_cast<uint64_t>(astContext.getDeclAlign(var).getQuantity()));
+    }
+    if (const auto* member = llvm::dyn_cast<clang::MemberExpr>(lvalue)) {
+        const clang::ValueDecl* decl = member->getMemberDecl();
+        if (const auto* var = llvm::dyn_cast<clang::VarDecl>(decl)) {
+            return Alignment::Aligned(static_cast<uint64_t>(astContext.getDeclAlign(var).getQuantity()));
+        }
+        const auto* field = llvm::dyn_cast<clang::FieldDecl>(decl);
+        if (!field || field->isBitField() || field->getParent()->isDependentType() ||
+            field->getParent()->isInvalidDecl() || !field->getParent()->getDefinition()) {
+            return TypeAlignment(type);
+        }
+        clang::QualType baseType = member->isArrow() ?
+            member->getBase()->getType()->getPointeeType() : member->getBase()->getType();
+        Alignment base = member->isArrow() ? GetPointerAlignment(member->getBase()) :
+                                             GetObjectAlignment(member->getBase());
+        base = WithTypeAlignment(base, baseType);
+        int64_t offset = static_cast<int64_t>(astContext.getFieldOffset(field) / 8);
+        return WithTypeAlignment(base.Offset(ValueRange::Constant(offset)), type);
+    }
+    if (llvm::isa<clang::ArraySubscriptExpr>(lvalue)) {
+        return GetAccessAlignment(lvalue);
+    }
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(lvalue)) {
+        if (unaryOp->getOpcode() == clang::UO_Deref) {
+            return WithTypeAlignment(GetPointerAlignment(unaryOp->getSubExpr()), type);
+        }
+    }
+    if (const auto* cast = llvm::dyn_cast<clang::CastExpr>(lvalue)) {
+        if (cast->getCastKind() == clang::CK_NoOp || cast->getCastKind() == clang::CK_LValueBitCast) {
+            return GetObjectAlignment(cast->getSubExpr());
+        }
+    }
+    return TypeAlignment(type);
+}
+
+Alignment AlignmentAnalysis::GetAccessAlignment(const clang::Expr* access)
+{
+    if (!access) return Alignment::Unknown();
+    access = access->IgnoreParens();
+    const auto* subscript = llvm::dyn_cast<clang::ArraySubscriptExpr>(access);
+    if (!subscript) return GetObjectAlignment(access);
+
+    clang::QualType element = subscript->getType();
+    const clang::Expr* base = subscript->getBase();
+    clang::QualType baseType = base->getType();
+    if (!baseType->isPointerType() && !baseType->isArrayType()) return TypeAlignment(element);
+
+    Alignment result = AddElements(GetPointerAlignment(base), subscript->getIdx(), element, false);
+    return WithTypeAlignment(result, element);
+}
+
+ValueRange AlignmentAnalysis::EntryIndexRange(const clang::Expr* index, const clang::VarDecl* iv,
+                                              const ValueRange& ivEntry)
+{
+    const clang::Expr* stripped = index->IgnoreParenImpCasts();
+    if (!ReferencesVar(stripped, iv)) return IndexRange(index);
+    if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(stripped)) {
+        return ref->getDecl() == iv ? ivEntry : IndexRange(index);
+    }
+    // 只展开 iv 所在的 + - *，另一侧取其全部取值（首次迭代的值是其子集）
+    const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(stripped);
+    if (!binOp) return ValueRange::Top();
+    ValueRange lhs = EntryIndexRange(binOp->getLHS(), iv, ivEntry);
+    ValueRange rhs = EntryIndexRange(binOp->getRHS(), iv, ivEntry);
+    switch (binOp->getOpcode()) {
+        case clang::BO_Add: return lhs.Add(rhs);
+        case clang::BO_Sub: return lhs.Sub(rhs);
+        case clang::BO_Mul: return lhs.Mul(rhs);
+        default:            return ValueRange::Top();
+    }
+}
+
+Alignment AlignmentAnalysis::GetLoopEntryAlignment(const clang::Expr* access, const clang::Stmt* loopStmt,
+                                                   const clang::VarDecl* iv)
+{
+    if (!access) return Alignment::Unknown();
+    const auto* subscript = llvm::dyn_cast<clang::ArraySubscriptExpr>(access->IgnoreParens());
+    if (!subscript || !cpgContext || !loopStmt || !iv) return GetAccessAlignment(access);
+
+    clang::QualType element = subscript->getType();
+    const clang::Expr* base = subscript->getBase();
+    if (!base->getType()->isPointerType() && !base->getType()->isArrayType()) return TypeAlignment(element);
+    if (element->isIncompleteType() || element->isDependentType()) return GetAccessAlignment(access);
+
+    ValueRange ivEntry = cpgContext->GetValueRanges().GetLoopEntryRange(loopStmt, iv);
+    ValueRange bytes = EntryIndexRange(subscript->getIdx(), iv, ivEntry)
+                           .Mul(ValueRange::Constant(astContext.getTypeSizeInChars(element).getQuantity()));
+    return WithTypeAlignment(GetPointerAlignment(base).Offset(bytes), element);
+}
+
+// ============================================
+// 局部指针变量：流不敏感不动点
+// ============================================
+
+AlignmentAnalysis::FunctionFacts* AlignmentAnalysis::FactsFor(const clang::FunctionDecl* func)
+{
+    const clang::FunctionDecl* key = func->getCanonicalDecl();
+    auto it = functions.find(key);
+    if (it != functions.end()) return it->second.get();
+
+    FunctionFacts* facts = functions.emplace(key, std::make_unique<FunctionFacts>()).first->second.get();
+    const clang::FunctionDecl* definition = nullptr;
+    if (func->hasBody(definition) && definition && !definition->isDependentContext()) {
+        Solve(definition, *facts);
+    }
+    return facts;
+}
+
+void AlignmentAnalysis::Solve(const clang::FunctionDecl* func, FunctionFacts& facts)
+{
+    PointerVarScanner scanner;
+    scanner.TraverseStmt(const_cast<clang::Stmt*>(func->getBody()));
+
+    auto tracked = [&](const clang::VarDecl* var) {
+        clang::QualType type = var->getType();
+        if (!var->hasLocalStorage() || !type->isPointerType() || type.isVolatileQualified() ||
+            scanner.escaped.count(var)) {
+            return false;
+        }
+        auto it = scanner.uses.find(var);
+        return it == scanner.uses.end() || it->second.refs == it->second.plainUses;
+    };
+    for (const clang::ParmVarDecl* param : func->parameters()) {
+        if (tracked(param)) facts.definitions[param].push_back(Definition());
+    }
+    for (const clang::VarDecl* local : scanner.locals) {
+        if (tracked(local)) facts.definitions[local];
+    }
+    for (const auto& raw : scanner.definitions) {
+        auto it = facts.definitions.find(raw.var);
+        if (it == facts.definitions.end()) continue;
+        Definition def;
+        def.value = raw.value;
+        def.delta = raw.delta;
+        def.subtract = raw.subtract;
+        def.step = raw.step;
+        if (raw.alignArg) {
+            // posix_memalign 的对齐非常量时仍至少是 sizeof(void*)
+            uint64_t align = 0;
+            def.aligned = EvaluateAlign(raw.alignArg, align) && align > 0 ? align :
+                static_cast<uint64_t>(astContext.getTypeSizeInChars(astContext.VoidPtrTy).getQuantity());
+        }
+        if (!def.value && !def.delta && def.step == 0 && def.aligned == 0) {
+            // 其他复合赋值（对指针不合法）或空初始化：未知
+            def.aligned = 1;
+        }
+        it->second.push_back(def);
+    }
+
+    for (const auto& [var, defs] : facts.definitions) {
+        facts.vars[var] = Alignment::Bottom();
+    }
+
+    const clang::FunctionDecl* savedSolving = solvingFunc;
+    solvingFunc = func->getCanonicalDecl();
+    facts.solving = true;
+    bool converged = false;
+    for (int round = 0; round < kMaxSolveRounds && !converged; ++round) {
+        converged = true;
+        for (const auto& [var, defs] : facts.definitions) {
+            Alignment value = Alignment::Bottom();
+            for (const Definition& def : defs) {
+                value = value.Join(DefinitionAlignment(var, def));
+            }
+            // 定义只会合并进来，取值单调变粗
+            value = facts.vars[var].Join(value);
+            if (value != facts.vars[var]) {
+                facts.vars[var] = value;
+                converged = false;
+            }
+        }
+    }
+    facts.solving = false;
+    solvingFunc = savedSolving;
+
+    for (auto& [var, value] : facts.vars) {
+        // 未收敛或没有任何定义（未初始化）：只剩类型对齐
+        if (!converged || value.empty) value = TypeAlignment(var->getType()->getPointeeType());
+    }
+}
+
+Alignment AlignmentAnalysis::DefinitionAlignment(const clang::VarDecl* var, const Definition& def)
+{
+    clang::QualType pointee = var->getType()->getPointeeType();
+    if (def.aligned > 0) return Alignment::Aligned(def.aligned);
+    if (def.value) return GetPointerAlignment(def.value);
+    if (def.delta) return AddElements(VarAlignment(var), def.delta, pointee, def.subtract);
+    if (def.step != 0) {
+        if (pointee->isIncompleteType() && !pointee->isVoidType()) return Alignment::Unknown();
+        int64_t size = pointee->isVoidType() ? 1 : astContext.getTypeSizeInChars(pointee).getQuantity();
+        return VarAlignment(var).Offset(ValueRange::Constant(def.step * size));
+    }
+    const auto* param = llvm::dyn_cast<clang::ParmVarDecl>(var);
+    return param ? ParamAlignment(param) : Alignment::Unknown();
+}
+
+Alignment AlignmentAnalysis::VarAlignment(const clang::VarDecl* var)
+{
+    clang::QualType type = var->getType();
+    if (type->isArrayType()) return Alignment::Unknown();
+    clang::QualType pointee = type->isPointerType() ? type->getPointeeType() : clang::QualType();
+
+    const auto* func = llvm::dyn_cast_or_null<clang::FunctionDecl>(var->getParentFunctionOrMethod());
+    if (!func || !var->hasLocalStorage()) return TypeAlignment(pointee);
+
+    FunctionFacts* facts = FactsFor(func);
+    auto it = facts->vars.find(var);
+    if (it == facts->vars.end()) return TypeAlignment(pointee);
+    // 其他函数的不动点尚未完成时其中间结果不可用（跨函数递归）
+    if (facts->solving && func->getCanonicalDecl() != solvingFunc) return TypeAlignment(pointee);
+    return it->second;
+}
+
+// ============================================
+// 形参：align_value 属性或内部函数的全部调用点
+// ============================================
+
+void AlignmentAnalysis::CollectCallSites()
+{
+    callSitesCollected = true;
+    CallSiteCollector collector(cpgContext);
+    collector.TraverseDecl(astContext.getTranslationUnitDecl());
+    callSites = std::move(collector.callSites);
+    for (const auto& [ref, func] : collector.functionRefs) {
+        if (!collector.calleeRefs.count(ref)) addressTaken.insert(func);
+    }
+}
+
+Alignment AlignmentAnalysis::ParamAlignment(const clang::ParmVarDecl* param)
+{
+    clang::QualType pointee = param->getType()->getPointeeType();
+    uint64_t align = 0;
+    if (const auto* attr = param->getAttr<clang::AlignValueAttr>()) {
+        if (EvaluateAlign(attr->getAlignment(), align)) return Alignment::Aligned(align);
+    }
+    if (const auto* typedefType = param->getType()->getAs<clang::TypedefType>()) {
+        if (const auto* attr = typedefType->getDecl()->getAttr<clang::AlignValueAttr>()) {
+            if (EvaluateAlign(attr->getAlignment(), align)) return Alignment::Aligned(align);
+        }
+    }
+
+    // 外部可见的函数可能从其他翻译单元调用，只能依赖类型
+    const auto* func = llvm::dyn_cast<clang::FunctionDecl>(param->getDeclContext());
+    if (!func || func->isExternallyVisible() || llvm::isa<clang::CXXMethodDecl>(func) ||
+        paramsInProgress.count(param)) {
+        return TypeAlignment(pointee);
+    }
+    if (!callSitesCollected) CollectCallSites();
+    const clang::FunctionDecl* key = func->getCanonicalDecl();
+    auto sites = callSites.find(key);
+    if (addressTaken.count(key) || sites == callSites.end() || sites->second.empty()) {
+        return TypeAlignment(pointee);
+    }
+
+    paramsInProgress.insert(param);
+    unsigned index = param->getFunctionScopeIndex();
+    Alignment result = Alignment::Bottom();
+    for (const clang::CallExpr* call : sites->second) {
+        if (index >= call->getNumArgs()) {
+            result = TypeAlignment(pointee);
+            break;
+        }
+        result = result.Join(GetPointerAlignment(call->getArg(index)));
+    }
+    paramsInProgress.erase(param);
+    return result.empty ? TypeAlignment(pointee) : result;
+}
+
+// ============================================
+// CPGContext 接口
+// ============================================
+
+AlignmentAnalysis& CPGContext::GetAlignment() const
+{
+    if (!alignment) {
+        alignment = std::make_unique<AlignmentAnalysis>(astContext, this);
+    }
+    return *alignment;
+}
+
+} // namespace cpg
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * AnalysisPipeline.cpp - 从锚点到导出的分阶段流水线（内存受限）
+ */
+
+#include "AnalysisPipeline.h"
+
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <string>
+
+namespace compute_graph {
+
+size_t CurrentResidentBytes()
+{
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    if (statm >> totalPages >> residentPages) {
+        return residentPages * static_cast<size_t>(llvm::sys::Process::getPageSizeEstimate());
+    }
+#endif
+    return llvm::sys::Process::GetMallocUsage();
+}
+
+size_t PeakResidentBytes()
+{
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return static_cast<size_t>(std::strtoull(line.c_str() + 6, nullptr, 10)) << 10;
+        }
+    }
+#endif
+    return 0;
+}
+
+AnalysisPipeline::AnalysisPipeline(cpg::CPGContext& cpgCtx, const PipelineOptions& opts)
+    : cpgContext(cpgCtx), options(opts)
+{
+    if (options.maxQueuedClusters == 0) {
+        options.maxQueuedClusters = 1;
+    }
+    options.calleeDepth = std::max(options.calleeDepth, 0);
+    options.callerDepth = std::max(options.callerDepth, 0);
+}
+
+void AnalysisPipeline::CountReferences(const std::vector<const clang::FunctionDecl*>& functions)
+{
+    using NeighborFn = std::set<const clang::FunctionDecl*> (cpg::CPGContext::*)(
+        const clang::FunctionDecl*) const;
+    std::map<const clang::FunctionDecl*, std::set<const clang::FunctionDecl*>> calleeCache;
+    std::map<const clang::FunctionDecl*, std::set<const clang::FunctionDecl*>> callerCache;
+
+    // 沿一个方向走 depth 层，把到达的函数加入 visited
+    auto walk = [this](const clang::FunctionDecl* start, int depth, NeighborFn neighborsOf,
+                       std::map<const clang::FunctionDecl*, std::set<const clang::FunctionDecl*>>& cache,
+                       std::set<const clang::FunctionDecl*>& visited) {
+        std::set<const clang::FunctionDecl*> seen{start};
+        std::vector<const clang::FunctionDecl*> frontier{start};
+        for (int hop = 0; hop < depth && !frontier.empty(); ++hop) {
+            std::vector<const clang::FunctionDecl*> nextFrontier;
+            for (const auto* current : frontier) {
+                auto it = cache.find(current);
+                if (it == cache.end()) {
+                    it = cache.emplace(current, (cpgContext.*neighborsOf)(current)).first;
+                }
+                for (const auto* neighbor : it->second) {
+                    if (seen.insert(neighbor).second) {
+                        nextFrontier.push_back(neighbor);
+                        visited.insert(neighbor);
+                    }
+                }
+            }
+            frontier = std::move(nextFrontier);
+        }
+    };
+
+    for (const auto* func : functions) {
+        const auto* canonicalFunc = func->getCanonicalDecl();
+        auto& refs = referencedBy[canonicalFunc];
+        if (!refs.empty()) {
+            continue;
+        }
+        // 【修复】构建器只向被调用者内联 calleeDepth 层、向调用者回溯 callerDepth 层，
+        // 按方向分别计引用，而不是无向地取两者之和作为半径
+        std::set<const clang::FunctionDecl*> visited{canonicalFunc};
+        walk(canonicalFunc, options.calleeDepth, &cpg::CPGContext::GetCallees, calleeCache, visited);
+        walk(canonicalFunc, options.callerDepth, &cpg::CPGContext::GetCallers, callerCache, visited);
+        refs.assign(visited.begin(), visited.end());
+        for (const auto* ref : refs) {
+            references[ref]++;
+        }
+    }
+}
+
+void AnalysisPipeline::Run(const std::vector<const clang::FunctionDecl*>& functions,
+                           const DiscoverFn& discover, const BuildFn& build, const ExportFn& exportFn,
+                           const ReanalyzeFn& reanalyze)
+{
+    CountReferences(functions);
+
+    size_t next = 0;
+    while (true) {
+        // 下游优先：队首函数的簇全部完成即合并导出
+        if (!inFlight.empty() && inFlight.front()->remainingClusters == 0) {
+            MergeAndExport(exportFn, reanalyze);
+            continue;
+        }
+        if (next < functions.size() && CanAdmit()) {
+            Discover(functions[next++], discover);
+            continue;
+        }
+        if (!clusterQueue.empty()) {
+            BuildNext(build);
+            continue;
+        }
+        // 簇队列为空时在途函数都已导出，CanAdmit 不再看预算，这里一定是全部完成
+        break;
+    }
+}
+
+bool AnalysisPipeline::CanAdmit()
+{
+    if (clusterQueue.size() >= options.maxQueuedClusters) {
+        return false;
+    }
+    // 有函数在途时才看预算；下游排空后仍超预算也要接纳，保证每次至少处理一个函数
+    if (!inFlight.empty() && OverBudget()) {
+        if (!stalled) {
+            stats.backpressureStalls++;
+            stalled = true;
+        }
+        return false;
+    }
+    stalled = false;
+    return true;
+}
+
+bool AnalysisPipeline::OverBudget()
+{
+    size_t rss = CurrentResidentBytes();
+    stats.peakRSSBytes = std::max(stats.peakRSSBytes, rss);
+    return options.maxRSSBytes > 0 && rss > options.maxRSSBytes;
+}
+
+void AnalysisPipeline::Discover(const clang::FunctionDecl* func, const DiscoverFn& discover)
+{
+    // 【新增】按需构建引用集合的ICFG：构建器只会经由这些函数跨函数内联与回溯
+    auto refsIt = referencedBy.find(func->getCanonicalDecl());
+    if (refsIt != referencedBy.end()) {
+        for (const auto* ref : refsIt->second) {
+            cpgContext.BuildICFGFor(ref);
+        }
+    }
+
+    std::vector<AnchorCluster> clusters;
+    bool accepted = discover(func, clusters);
+    stats.peakLiveFunctions = std::max(stats.peakLiveFunctions, cpgContext.GetBuiltFunctionCount());
+    if (!accepted) {
+        stats.skippedFunctions++;
+        Finish(func);
+        return;
+    }
+
+    auto pending = std::make_unique<PendingFunction>();
+    pending->result.func = func;
+    pending->remainingClusters = clusters.size();
+    for (auto& cluster : clusters) {
+        clusterQueue.push_back({pending.get(), std::move(cluster)});
+    }
+    stats.peakQueuedClusters = std::max(stats.peakQueuedClusters, clusterQueue.size());
+    inFlight.push_back(std::move(pending));
+}
+
+void AnalysisPipeline::BuildNext(const BuildFn& build)
+{
+    QueuedCluster item = std::move(clusterQueue.front());
+    clusterQueue.pop_front();
+
+    auto graph = build(item.cluster);
+    if (graph && !graph->IsEmpty()) {
+        item.owner->result.graphSet.AddGraph(graph);
+        item.owner->result.anchorCount += static_cast<int>(item.cluster.anchors.size());
+    }
+    item.owner->remainingClusters--;
+    stats.clustersBuilt++;
+}
+
+void AnalysisPipeline::MergeAndExport(const ExportFn& exportFn, const ReanalyzeFn& reanalyze)
+{
+    std::unique_ptr<PendingFunction> pending = std::move(inFlight.front());
+    inFlight.pop_front();
+
+    // 去重并合并重叠的图（仅跨簇重叠，如嵌套循环，才需要合并）
+    ComputeGraphSet& graphSet = pending->result.graphSet;
+    pending->result.builtGraphs = graphSet.Size();
+    if (graphSet.Size() > 1) {
+        graphSet.Deduplicate();
+        graphSet.MergeOverlapping(reanalyze);
+    }
+
+    exportFn(pending->result);
+    stats.functions++;
+    Finish(pending->result.func);
+    OverBudget();   // 记录峰值
+}
+
+void AnalysisPipeline::Finish(const clang::FunctionDecl* func)
+{
+    auto refsIt = referencedBy.find(func->getCanonicalDecl());
+    if (refsIt == referencedBy.end()) {
+        return;
+    }
+    for (const auto* ref : refsIt->second) {
+        auto countIt = references.find(ref);
+        if (countIt == references.end() || countIt->second == 0) {
+            continue;
+        }
+        if (--countIt->second == 0 && options.releaseFunctions && cpgContext.ReleaseFunction(ref)) {
+            stats.releasedFunctions++;
+        }
+    }
+    referencedBy.erase(refsIt);
+}
+
+} // namespace compute_graph
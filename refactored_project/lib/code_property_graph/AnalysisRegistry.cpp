@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * AnalysisRegistry.cpp - 跨翻译单元的“已分析”登记表
+ */
+
+#include "AnalysisRegistry.h"
+
+#include "clang/Basic/SourceManager.h"
+#include "clang/Index/USRGeneration.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <fstream>
+
+namespace compute_graph {
+
+namespace {
+
+// 同一头文件经不同 -I 路径包含时拼写不同，统一成真实路径
+std::string RealPathOf(llvm::StringRef fileName)
+{
+    llvm::SmallString<256> realPath;
+    if (llvm::sys::fs::real_path(fileName, realPath)) {
+        realPath = fileName;
+    }
+    return realPath.str().str();
+}
+
+} // namespace
+
+std::string AnalysisIdentity::Key() const
+{
+    std::string key = file + "\t" + usr + "\t" + std::to_string(offset);
+    if (!spelling.empty()) {
+        key += "\t" + spelling;
+    }
+    return key;
+}
+
+AnalysisIdentity MakeAnalysisIdentity(const clang::FunctionDecl* func, const clang::Stmt* anchor,
+                                      clang::ASTContext& ctx)
+{
+    AnalysisIdentity identity;
+    if (!func) return identity;
+
+    const clang::Stmt* locStmt = anchor ? anchor : func->getBody();
+    if (!locStmt) return identity;
+
+    llvm::SmallString<128> usr;
+    if (clang::index::generateUSRForDecl(func, usr)) return identity;   // 返回true表示失败
+
+    const clang::SourceManager& sm = ctx.getSourceManager();
+    clang::SourceLocation begin = locStmt->getBeginLoc();
+    clang::SourceLocation loc = sm.getFileLoc(begin);
+    if (loc.isInvalid()) return identity;
+
+    auto decomposed = sm.getDecomposedLoc(loc);
+    llvm::StringRef fileName = sm.getFilename(loc);
+    if (fileName.empty()) return identity;
+
+    identity.file = RealPathOf(fileName);
+    identity.usr = usr.str().str();
+    identity.offset = decomposed.second;
+
+    // 【修复】同一宏展开内的多个锚点共用展开位置，补上各自的拼写位置；
+    // ## 拼接出的记号拼写在各翻译单元私有的 scratch 缓冲区，偏移不稳定，只作标记
+    if (begin.isMacroID()) {
+        clang::SourceLocation spellingLoc = sm.getSpellingLoc(begin);
+        llvm::StringRef spellingFile = sm.getFilename(spellingLoc);
+        if (sm.isWrittenInScratchSpace(spellingLoc) || spellingFile.empty()) {
+            identity.spelling = "<scratch>";
+        } else {
+            identity.spelling = RealPathOf(spellingFile) + ":" +
+                                std::to_string(sm.getDecomposedLoc(spellingLoc).second);
+        }
+    }
+    return identity;
+}
+
+AnalysisRegistry::AnalysisRegistry() = default;
+AnalysisRegistry::~AnalysisRegistry() = default;
+
+bool AnalysisRegistry::OpenFile(const std::string& path)
+{
+    std::error_code EC;
+    auto stream = std::make_unique<llvm::raw_fd_ostream>(path, EC, llvm::sys::fs::OF_Append);
+    if (EC) {
+        llvm::errs() << "Cannot open analysis registry: " << path << " (" << EC.message() << ")\n";
+        return false;
+    }
+    stream->SetUnbuffered();
+
+    appendStream = std::move(stream);
+    filePath = path;
+    readOffset = 0;
+    Refresh();
+    return true;
+}
+
+void AnalysisRegistry::Refresh()
+{
+    if (filePath.empty()) return;
+
+    std::ifstream in(filePath, std::ios::binary);
+    if (!in) return;
+    in.seekg(static_cast<std::streamoff>(readOffset));
+
+    // 只接收完整的行，写到一半的记录留到下次
+    std::string line;
+    while (std::getline(in, line)) {
+        if (in.eof()) break;
+        readOffset += line.size() + 1;
+        if (!line.empty()) {
+            keys.insert(line);
+        }
+    }
+}
+
+bool AnalysisRegistry::IsAnalyzed(const AnalysisIdentity& identity) const
+{
+    return identity.IsValid() && keys.count(identity.Key()) > 0;
+}
+
+bool AnalysisRegistry::Claim(const AnalysisIdentity& identity)
+{
+    if (!identity.IsValid()) return true;
+
+    std::string key = identity.Key();
+    if (!keys.insert(key).second) return false;
+
+    claimed++;
+    if (appendStream) {
+        // 整行一次写出，多个进程并发追加时记录不会交错
+        key.push_back('\n');
+        appendStream->write(key.data(), key.size());
+    }
+    return true;
+}
+
+} // namespace compute_graph
@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * AnchorProfile.cpp - 执行剖析数据解析（perf script / gcov / llvm-profdata）
+ */
+#include "AnchorProfile.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+
+namespace compute_graph {
+
+namespace {
+
+// 【修复】perf 会在行号后追加 " (discriminator N)"，去掉后 srcline 才在行尾
+llvm::StringRef StripDiscriminator(llvm::StringRef text)
+{
+    text = text.rtrim();
+    size_t open = text.rfind(" (discriminator ");
+    if (open != llvm::StringRef::npos && text.endswith(")")) {
+        text = text.substr(0, open).rtrim();
+    }
+    return text;
+}
+
+// 解析 "file:line" 形式的 srcline，成功返回true；路径中可以有空格
+bool ParseSrcLine(llvm::StringRef text, std::string& file, int& line)
+{
+    text = StripDiscriminator(text).ltrim();
+
+    size_t colon = text.rfind(':');
+    if (colon == llvm::StringRef::npos || colon == 0) {
+        return false;
+    }
+
+    llvm::StringRef lineStr = text.substr(colon + 1);
+    if (lineStr.empty() || lineStr.getAsInteger(10, line) || line <= 0) {
+        return false;
+    }
+
+    file = text.substr(0, colon).str();
+    return file != "??";
+}
+
+// 函数名匹配：精确匹配或Itanium修饰名中包含 "<len><name>"
+bool MatchFuncName(const std::string& profName, const std::string& funcName)
+{
+    if (profName == funcName) {
+        return true;
+    }
+    if (funcName.empty() || profName.rfind("_Z", 0) != 0) {
+        return false;
+    }
+    std::string encoded = std::to_string(funcName.size()) + funcName;
+    return profName.find(encoded) != std::string::npos;
+}
+
+// 两个 '/' 分隔的路径末尾相同的分量个数
+size_t CommonSuffixComponents(llvm::StringRef a, llvm::StringRef b)
+{
+    size_t count = 0;
+    while (!a.empty() && !b.empty()) {
+        size_t aSlash = a.rfind('/');
+        size_t bSlash = b.rfind('/');
+        llvm::StringRef aName = aSlash == llvm::StringRef::npos ? a : a.substr(aSlash + 1);
+        llvm::StringRef bName = bSlash == llvm::StringRef::npos ? b : b.substr(bSlash + 1);
+        if (aName.empty() || aName != bName) {
+            break;
+        }
+        ++count;
+        a = aSlash == llvm::StringRef::npos ? llvm::StringRef() : a.substr(0, aSlash);
+        b = bSlash == llvm::StringRef::npos ? llvm::StringRef() : b.substr(0, bSlash);
+    }
+    return count;
+}
+
+} // namespace
+
+// ============================================
+// 加载与格式识别
+// ============================================
+
+bool AnchorProfile::LoadFromFile(const std::string& filePath)
+{
+    Clear();
+
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> bufOrErr =
+        llvm::MemoryBuffer::getFile(filePath);
+    if (!bufOrErr) {
+        llvm::errs() << "Cannot open profile: " << filePath << "\n";
+        return false;
+    }
+
+    path = filePath;
+    std::string content = (*bufOrErr)->getBuffer().str();
+    format = DetectFormat(content);
+
+    switch (format) {
+        case Format::Gcov:
+            ParseGcov(content);
+            break;
+        case Format::LLVMProfdata:
+            ParseLLVMProfdata(content);
+            break;
+        case Format::PerfScript:
+            ParsePerfScript(content);
+            break;
+        default:
+            break;
+    }
+
+    if (IsEmpty()) {
+        llvm::errs() << "Profile contains no usable samples: " << filePath << "\n";
+        return false;
+    }
+
+    llvm::outs() << "  [Profile] Loaded " << AnchorProfileFormatToString(format)
+                 << " profile: " << LineCount() << " hot lines, "
+                 << funcCounts.size() << " function counts\n";
+    return true;
+}
+
+AnchorProfile::Format AnchorProfile::DetectFormat(const std::string& content)
+{
+    if (content.find(":    0:Source:") != std::string::npos) {
+        return Format::Gcov;
+    }
+    if (content.find("sampled lines") != std::string::npos ||
+        content.find("Function count:") != std::string::npos ||
+        content.find("Samples collected in") != std::string::npos) {
+        return Format::LLVMProfdata;
+    }
+    return Format::PerfScript;
+}
+
+// 【修改】原先只保留basename，不同目录下的同名文件计数会混在一起
+std::string AnchorProfile::NormalizePath(const std::string& file)
+{
+    llvm::SmallString<256> normalized;
+    if (llvm::sys::fs::real_path(file, normalized)) {
+        // 剖析数据来自别的机器/构建目录时文件不存在，只做词法规范化
+        normalized = file;
+        std::replace(normalized.begin(), normalized.end(), '\\', '/');
+        llvm::sys::path::remove_dots(normalized, true, llvm::sys::path::Style::posix);
+    }
+    return std::string(normalized);
+}
+
+const std::map<int, uint64_t>* AnchorProfile::FindFileLines(const std::string& fileName) const
+{
+    auto cached = fileMatchCache.find(fileName);
+    if (cached != fileMatchCache.end()) {
+        return cached->second;
+    }
+
+    std::string key = NormalizePath(fileName);
+    const std::map<int, uint64_t>* match = nullptr;
+    auto exact = lineCounts.find(key);
+    if (exact != lineCounts.end()) {
+        match = &exact->second;
+    } else {
+        // 构建目录不同：取路径分量后缀最长的一项，最长者不唯一时视为无法区分
+        size_t bestLength = 0;
+        bool ambiguous = false;
+        for (const auto& [file, lines] : lineCounts) {
+            size_t length = CommonSuffixComponents(file, key);
+            if (length == 0 || length < bestLength) {
+                continue;
+            }
+            ambiguous = length == bestLength;
+            if (length > bestLength) {
+                bestLength = length;
+                match = &lines;
+            }
+        }
+        if (ambiguous) {
+            match = nullptr;
+        }
+    }
+    fileMatchCache[fileName] = match;
+    return match;
+}
+
+void AnchorProfile::Clear()
+{
+    format = Format::Unknown;
+    path.clear();
+    lineCounts.clear();
+    fileMatchCache.clear();
+    funcOffsetCounts.clear();
+    funcCounts.clear();
+    maxCount = 0;
+    maxFuncCount = 0;
+}
+
+size_t AnchorProfile::LineCount() const
+{
+    size_t count = 0;
+    for (const auto& [file, lines] : lineCounts) {
+        count += lines.size();
+    }
+    for (const auto& [func, offsets] : funcOffsetCounts) {
+        count += offsets.size();
+    }
+    return count;
+}
+
+void AnchorProfile::AddLineCount(const std::string& file, int line, uint64_t count)
+{
+    uint64_t& slot = lineCounts[NormalizePath(file)][line];
+    slot += count;
+    maxCount = std::max(maxCount, slot);
+}
+
+void AnchorProfile::AddOffsetCount(const std::string& func, int offset, uint64_t count)
+{
+    uint64_t& slot = funcOffsetCounts[func][offset];
+    slot += count;
+    maxCount = std::max(maxCount, slot);
+}
+
+// ============================================
+// perf script：每个样本只统计第一个（自身）栈帧的srcline
+// ============================================
+
+void AnchorProfile::ParsePerfScript(const std::string& content)
+{
+    llvm::StringRef rest(content);
+    bool expectFirstFrame = false;
+
+    while (!rest.empty()) {
+        std::pair<llvm::StringRef, llvm::StringRef> split = rest.split('\n');
+        llvm::StringRef line = split.first.rtrim();
+        rest = split.second;
+
+        if (line.empty()) {
+            expectFirstFrame = false;
+            continue;
+        }
+
+        std::string file;
+        int lineNo = 0;
+
+        // 非缩进行是样本头；-F ...,srcline 单行格式时srcline在行尾
+        if (line.front() != ' ' && line.front() != '\t') {
+            expectFirstFrame = true;
+            if (ParseSrcLine(StripDiscriminator(line).rsplit(' ').second, file, lineNo)) {
+                AddLineCount(file, lineNo, 1);
+                expectFirstFrame = false;
+            }
+            continue;
+        }
+
+        if (expectFirstFrame && ParseSrcLine(line, file, lineNo)) {
+            AddLineCount(file, lineNo, 1);
+            expectFirstFrame = false;
+        }
+    }
+}
+
+// ============================================
+// gcov：  "<count>:<lineno>:<source>"
+// ============================================
+
+void AnchorProfile::ParseGcov(const std::string& content)
+{
+    llvm::StringRef rest(content);
+    std::string currentFile;
+
+    while (!rest.empty()) {
+        std::pair<llvm::StringRef, llvm::StringRef> split = rest.split('\n');
+        llvm::StringRef line = split.first;
+        rest = split.second;
+
+        std::pair<llvm::StringRef, llvm::StringRef> countSplit = line.split(':');
+        std::pair<llvm::StringRef, llvm::StringRef> lineSplit = countSplit.second.split(':');
+        llvm::StringRef countStr = countSplit.first.trim();
+        llvm::StringRef lineStr = lineSplit.first.trim();
+
+        int lineNo = 0;
+        if (lineStr.getAsInteger(10, lineNo)) {
+            continue;
+        }
+
+        if (lineNo == 0) {
+            if (lineSplit.second.startswith("Source:")) {
+                currentFile = lineSplit.second.drop_front(7).trim().str();
+            }
+            continue;
+        }
+
+        // "-" 不可执行，"#####"/"=====" 未执行
+        if (countStr.empty() || countStr == "-" ||
+            countStr.startswith("#") || countStr.startswith("=")) {
+            continue;
+        }
+
+        countStr = countStr.rtrim('*');
+        uint64_t count = 0;
+        if (countStr.getAsInteger(10, count) || count == 0 || currentFile.empty()) {
+            continue;
+        }
+        AddLineCount(currentFile, lineNo, count);
+    }
+}
+
+// ============================================
+// llvm-profdata show：
+//   --sample：   "Function: foo: total, head, N sampled lines" + " <offset>[.disc]: <count>"
+//   插桩格式：   "  foo:" + "    Function count: <count>"
+// ============================================
+
+void AnchorProfile::ParseLLVMProfdata(const std::string& content)
+{
+    llvm::StringRef rest(content);
+    std::string currentFunc;
+    int braceDepth = 0;
+
+    while (!rest.empty()) {
+        std::pair<llvm::StringRef, llvm::StringRef> split = rest.split('\n');
+        llvm::StringRef raw = split.first.rtrim();
+        llvm::StringRef line = raw.ltrim();
+        rest = split.second;
+
+        if (line.startswith("Function: ")) {
+            currentFunc = line.drop_front(10).split(':').first.str();
+            braceDepth = 0;
+            continue;
+        }
+
+        if (line.startswith("Function count:")) {
+            uint64_t count = 0;
+            if (!currentFunc.empty() &&
+                !line.drop_front(15).trim().getAsInteger(10, count)) {
+                funcCounts[currentFunc] += count;
+                maxFuncCount = std::max(maxFuncCount, funcCounts[currentFunc]);
+            }
+            continue;
+        }
+
+        // 插桩格式的函数名行：两格缩进、以':'结尾
+        if (raw.startswith("  ") && !raw.startswith("   ") && line.endswith(":")) {
+            llvm::StringRef name = line.drop_back();
+            // 静态函数形如 "file.c;foo" 或 "file.c:foo"
+            name = name.rsplit(';').second.empty() ? name : name.rsplit(';').second;
+            currentFunc = name.str();
+            continue;
+        }
+
+        if (line.endswith("{")) {
+            braceDepth++;
+            continue;
+        }
+        if (line.startswith("}")) {
+            braceDepth = std::max(0, braceDepth - 1);
+            continue;
+        }
+
+        // 只统计函数体本层样本，内联展开的子块计入调用行本身
+        if (braceDepth != 1 || currentFunc.empty()) {
+            continue;
+        }
+
+        std::pair<llvm::StringRef, llvm::StringRef> kv = line.split(": ");
+        int offset = 0;
+        uint64_t count = 0;
+        if (kv.first.split('.').first.getAsInteger(10, offset)) {
+            continue;
+        }
+        if (kv.second.split(',').first.trim().getAsInteger(10, count) || count == 0) {
+            continue;
+        }
+        AddOffsetCount(currentFunc, offset, count);
+    }
+}
+
+// ============================================
+// 查询
+// ============================================
+
+double AnchorProfile::GetHotness(const std::string& fileName, int line,
+                                 const std::string& funcName, int funcStartLine) const
+{
+    if (IsEmpty()) {
+        return 0.0;
+    }
+
+    // 1. 文件+行号（perf / gcov）
+    if (const std::map<int, uint64_t>* lines = FindFileLines(fileName)) {
+        auto lineIt = lines->find(line);
+        if (lineIt != lines->end() && maxCount > 0) {
+            return static_cast<double>(lineIt->second) / maxCount;
+        }
+    }
+
+    // 2. 函数内行偏移（llvm-profdata --sample）
+    for (const auto& [profFunc, offsets] : funcOffsetCounts) {
+        if (!MatchFuncName(profFunc, funcName)) {
+            continue;
+        }
+        auto offIt = offsets.find(line - funcStartLine);
+        if (offIt != offsets.end() && maxCount > 0) {
+            return static_cast<double>(offIt->second) / maxCount;
+        }
+    }
+
+    // 3. 函数级计数（插桩格式），粒度较粗，折半以免压过行级数据
+    for (const auto& [profFunc, count] : funcCounts) {
+        if (MatchFuncName(profFunc, funcName) && maxFuncCount > 0) {
+            return 0.5 * static_cast<double>(count) / maxFuncCount;
+        }
+    }
+
+    return 0.0;
+}
+
+std::string AnchorProfileFormatToString(AnchorProfile::Format format)
+{
+    switch (format) {
+        case AnchorProfile::Format::PerfScript: return "perf-script";
+        case AnchorProfile::Format::Gcov: return "gcov";
+        case AnchorProfile::Format::LLVMProfdata: return "llvm-profdata";
+        default: return "unknown";
+    }
+}
+
+} // namespace compute_graph
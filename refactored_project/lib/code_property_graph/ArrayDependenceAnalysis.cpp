@@ -0,0 +1,576 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * ArrayDependenceAnalysis.cpp - 数组访问依赖测试实现
+ *
+ * 归一化：第k层循环变量 i = L + s*t，t ∈ [0, M]（M = 迭代次数-1）。
+ * 源访问 Σa*i + cA 与汇访问 Σb*i' + cB 访问同一元素当且仅当
+ *     Σ (a*s)*t - Σ (b*s)*t' = cB - cA + Σ (b-a)*L
+ * 在此方程上依次做 GCD、strong SIV、Banerjee（逐层方向）测试。
+ */
+#include "ArrayDependenceAnalysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace compute_graph {
+
+int DependenceRank(const std::string& kind)
+{
+    if (kind == "flow") return 3;
+    if (kind == "output") return 2;
+    if (kind == "anti") return 1;
+    return 0;
+}
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+// 方程左侧的一项：源系数 alpha、汇系数 beta，迭代计数范围 [0, maxIter]
+struct DependenceTerm {
+    int64_t alpha = 0;
+    int64_t beta = 0;
+    double maxIter = kInf;
+    int level = -1;         // 公共循环层号；-1 表示只属于一侧的循环
+};
+
+// coeff * x，x ∈ [low, high]
+void Span(double coeff, double low, double high, double& lo, double& hi)
+{
+    if (coeff == 0.0) {
+        lo = hi = 0.0;
+        return;
+    }
+    double a = std::isinf(low) ? (coeff > 0 ? -kInf : kInf) : coeff * low;
+    double b = std::isinf(high) ? (coeff > 0 ? kInf : -kInf) : coeff * high;
+    lo = std::min(a, b);
+    hi = std::max(a, b);
+}
+
+// 某一项在给定方向约束下的取值范围（Banerjee 界），不可行返回false
+bool TermBounds(const DependenceTerm& term, unsigned dir, double& lo, double& hi)
+{
+    double m = term.maxIter;
+    double l1 = 0.0, h1 = 0.0, l2 = 0.0, h2 = 0.0;
+    double alpha = static_cast<double>(term.alpha);
+    double beta = static_cast<double>(term.beta);
+
+    if (dir == DirAll || term.level < 0) {
+        Span(alpha, 0.0, m, l1, h1);
+        Span(-beta, 0.0, m, l2, h2);
+    } else if (dir == DirEqual) {
+        Span(alpha - beta, 0.0, m, l1, h1);
+    } else {
+        if (m < 1.0) return false;
+        // '<'：t' = t + d；'>'：t = t' + d；t ∈ [0, M-1]，d ∈ [1, M]
+        Span(alpha - beta, 0.0, m - 1.0, l1, h1);
+        Span(dir == DirLess ? -beta : alpha, 1.0, m, l2, h2);
+    }
+    lo = l1 + l2;
+    hi = h1 + h2;
+    return true;
+}
+
+const char* DirectionToString(unsigned dir)
+{
+    switch (dir) {
+        case DirLess: return "<";
+        case DirEqual: return "=";
+        case DirGreater: return ">";
+        case DirLess | DirEqual: return "<=";
+        case DirGreater | DirEqual: return ">=";
+        case DirLess | DirGreater: return "<>";
+        default: return "*";
+    }
+}
+
+unsigned ReverseDirection(unsigned dir)
+{
+    unsigned result = dir & DirEqual;
+    if (dir & DirLess) result |= DirGreater;
+    if (dir & DirGreater) result |= DirLess;
+    return result;
+}
+
+} // namespace
+
+// ============================================
+// ArrayDependence
+// ============================================
+
+std::string ArrayDependence::DirectionString(bool reversed) const
+{
+    std::string result = "(";
+    for (size_t k = 0; k < directions.size(); ++k) {
+        if (k > 0) result += ",";
+        result += DirectionToString(reversed ? ReverseDirection(directions[k]) : directions[k]);
+    }
+    return result + ")";
+}
+
+std::string ArrayDependence::DistanceString(bool reversed) const
+{
+    std::string result = "(";
+    for (size_t k = 0; k < distances.size(); ++k) {
+        if (k > 0) result += ",";
+        result += distanceKnown[k] ?
+            std::to_string(reversed ? -distances[k] : distances[k]) : "*";
+    }
+    return result + ")";
+}
+
+// ============================================
+// 访问收集
+// ============================================
+
+ArrayDependenceAnalyzer::ArrayDependenceAnalyzer(clang::ASTContext& ctx,
+                                                 LoopInductionAnalysis& induction,
+                                                 const cpg::CPGContext* cpgCtx)
+    : astContext(ctx), inductionAnalysis(induction), cpgContext(cpgCtx)
+{}
+
+const clang::ValueDecl* ArrayDependenceAnalyzer::GetArrayDecl(
+    const clang::ArraySubscriptExpr* expr) const
+{
+    const clang::Expr* base = expr->getBase()->IgnoreParenImpCasts();
+    while (const auto* inner = llvm::dyn_cast<clang::ArraySubscriptExpr>(base)) {
+        base = inner->getBase()->IgnoreParenImpCasts();
+    }
+    if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(base)) {
+        return ref->getDecl();
+    }
+    if (const auto* member = llvm::dyn_cast<clang::MemberExpr>(base)) {
+        return member->getMemberDecl();
+    }
+    return nullptr;
+}
+
+void ArrayDependenceAnalyzer::ClassifyReadWrite(const clang::ArraySubscriptExpr* expr,
+                                                AccessInfo& info) const
+{
+    auto parents = astContext.getParents(*expr);
+    while (!parents.empty()) {
+        const auto* parent = parents[0].get<clang::Stmt>();
+        if (!parent) return;
+
+        if (llvm::isa<clang::ParenExpr>(parent)) {
+            parents = astContext.getParents(*parent);
+            continue;
+        }
+        if (const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(parent)) {
+            if (binOp->isAssignmentOp() && binOp->getLHS()->IgnoreParens() == expr) {
+                info.isWrite = true;
+                info.isRead = binOp->isCompoundAssignmentOp();
+                info.writeStmt = binOp;
+            }
+            return;
+        }
+        if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(parent)) {
+            // 自增自减读写同一元素；取地址后的访问无法跟踪，保守视为读写
+            if (unaryOp->isIncrementDecrementOp() || unaryOp->getOpcode() == clang::UO_AddrOf) {
+                info.isWrite = true;
+                info.isRead = true;
+                info.writeStmt = unaryOp;
+            }
+            return;
+        }
+        return;
+    }
+}
+
+bool ArrayDependenceAnalyzer::CollectAccess(const ComputeNode& node, AccessInfo& info)
+{
+    const auto* expr = llvm::dyn_cast_or_null<clang::ArraySubscriptExpr>(node.astStmt);
+    // 多维数组的部分下标由外层访问整体展开
+    if (!expr || expr->getType()->isArrayType()) return false;
+
+    info.nodeId = node.id;
+    info.expr = expr;
+    info.array = GetArrayDecl(expr);
+    if (!info.array) return false;
+
+    const clang::Expr* base = expr->getBase()->IgnoreParenImpCasts();
+    while (const auto* inner = llvm::dyn_cast<clang::ArraySubscriptExpr>(base)) {
+        base = inner->getBase()->IgnoreParenImpCasts();
+    }
+    info.arrayText = GetSourceText(base, astContext);
+
+    info.nest = inductionAnalysis.GetLoopNest(expr);
+    if (info.nest.empty()) return false;
+
+    info.index = inductionAnalysis.AnalyzeIndexInNest(expr, info.nest);
+    ClassifyReadWrite(expr, info);
+    return true;
+}
+
+bool ArrayDependenceAnalyzer::ExecutesBefore(const AccessInfo& a, const AccessInfo& b) const
+{
+    const clang::SourceManager& sm = astContext.getSourceManager();
+    auto contains = [&sm](const clang::Stmt* outer, const clang::Stmt* inner) {
+        return !sm.isBeforeInTranslationUnit(inner->getBeginLoc(), outer->getBeginLoc()) &&
+               !sm.isBeforeInTranslationUnit(outer->getEndLoc(), inner->getBeginLoc());
+    };
+
+    // 同一赋值语句中，右侧的读先于左侧的写
+    if (a.writeStmt && contains(a.writeStmt, b.expr)) return false;
+    if (b.writeStmt && contains(b.writeStmt, a.expr)) return true;
+    return sm.isBeforeInTranslationUnit(a.expr->getBeginLoc(), b.expr->getBeginLoc());
+}
+
+// 不同基址的两个访问是否可能落在同一对象上；未开启指针分析时沿用“不同名即不同对象”
+bool ArrayDependenceAnalyzer::MayAliasBases(const AccessInfo& a, const AccessInfo& b) const
+{
+    if (!cpgContext || cpgContext->GetPointsToMode() == cpg::PointsToMode::Off) {
+        return false;
+    }
+    return cpgContext->MayAlias(a.expr, b.expr);
+}
+
+// ============================================
+// 依赖测试
+// ============================================
+
+ArrayDependence ArrayDependenceAnalyzer::Test(const AccessInfo& src, const AccessInfo& dst,
+                                              const std::vector<const clang::Stmt*>& commonNest)
+{
+    ArrayDependence dep;
+    size_t depth = commonNest.size();
+    dep.directions.assign(depth, DirAll);
+    dep.distances.assign(depth, 0);
+    dep.distanceKnown.assign(depth, false);
+
+    // 非仿射或不变量部分不同：无法测试，保守认为任意方向都有依赖
+    if (!src.index.isAffine || !dst.index.isAffine ||
+        src.index.invariantTerms != dst.index.invariantTerms) {
+        dep.test = "conservative";
+        return dep;
+    }
+
+    // 1. 构造依赖方程
+    std::vector<DependenceTerm> terms;
+    std::vector<int64_t> freeCoeffs;     // 起始值未知时作为自由整数变量
+    int64_t rhs = dst.index.constant - src.index.constant;
+    std::set<const clang::VarDecl*> commonVars;
+
+    auto coeffOf = [](const NestedIndexForm& form, const clang::VarDecl* var) -> int64_t {
+        auto it = form.ivCoeffs.find(var);
+        return it != form.ivCoeffs.end() ? it->second : 0;
+    };
+
+    for (size_t k = 0; k < depth; ++k) {
+        const LoopInductionInfo& info = inductionAnalysis.Analyze(commonNest[k]);
+        DependenceTerm term;
+        term.level = static_cast<int>(k);
+        term.maxIter = info.hasTripCount ? std::max<int64_t>(info.tripCount - 1, 0) : kInf;
+
+        // 同一循环的多个归纳变量共用迭代计数 t
+        for (const auto& iv : info.inductionVars) {
+            commonVars.insert(iv.var);
+            int64_t a = coeffOf(src.index, iv.var);
+            int64_t b = coeffOf(dst.index, iv.var);
+            term.alpha += a * iv.step;
+            term.beta += b * iv.step;
+            if (a == b) continue;
+            if (iv.hasConstStart) {
+                rhs += (b - a) * iv.start;
+            } else {
+                freeCoeffs.push_back(b - a);
+            }
+        }
+        terms.push_back(term);
+    }
+
+    // 只属于一侧的循环（如同一外层循环中的两个并列内层循环）
+    auto addPrivateTerms = [&](const AccessInfo& access, bool isSource) {
+        for (const auto& [var, coeff] : access.index.ivCoeffs) {
+            if (commonVars.count(var)) continue;
+            const InductionVariable* iv = nullptr;
+            double maxIter = kInf;
+            for (const auto* loopStmt : access.nest) {
+                const LoopInductionInfo& info = inductionAnalysis.Analyze(loopStmt);
+                if ((iv = info.Find(var))) {
+                    if (info.hasTripCount) maxIter = std::max<int64_t>(info.tripCount - 1, 0);
+                    break;
+                }
+            }
+            if (!iv) {
+                freeCoeffs.push_back(coeff);
+                continue;
+            }
+            DependenceTerm term;
+            term.alpha = isSource ? coeff * iv->step : 0;
+            term.beta = isSource ? 0 : coeff * iv->step;
+            term.maxIter = maxIter;
+            terms.push_back(term);
+            if (iv->hasConstStart) {
+                rhs += (isSource ? -coeff : coeff) * iv->start;
+            } else {
+                freeCoeffs.push_back(coeff);
+            }
+        }
+    };
+    addPrivateTerms(src, true);
+    addPrivateTerms(dst, false);
+
+    // 2. GCD 测试
+    int64_t g = 0;
+    for (const auto& term : terms) {
+        g = std::gcd(g, std::llabs(term.alpha));
+        g = std::gcd(g, std::llabs(term.beta));
+    }
+    for (int64_t c : freeCoeffs) {
+        g = std::gcd(g, std::llabs(c));
+    }
+    if (g == 0) {
+        // ZIV：地址与迭代无关，相等则每对迭代都访问同一元素
+        dep.independent = rhs != 0;
+        dep.test = "ziv";
+        return dep;
+    }
+    if (rhs % g != 0) {
+        dep.independent = true;
+        dep.test = "gcd";
+        return dep;
+    }
+    dep.test = "gcd";
+    if (!freeCoeffs.empty()) {
+        return dep;     // 起始值未知，无法给出范围
+    }
+
+    // 3. strong SIV：仅一层公共循环有系数且两侧相同
+    int sivLevel = -1;
+    bool singleTerm = true;
+    for (const auto& term : terms) {
+        if (term.alpha == 0 && term.beta == 0) continue;
+        if (sivLevel >= 0 || term.level < 0 || term.alpha != term.beta) {
+            singleTerm = false;
+            break;
+        }
+        sivLevel = term.level;
+    }
+    if (singleTerm && sivLevel >= 0) {
+        const DependenceTerm& term = terms[sivLevel];
+        dep.test = "strong-siv";
+        // alpha*(t - t') = rhs，距离 d = t' - t
+        if (rhs % term.alpha != 0) {
+            dep.independent = true;
+            return dep;
+        }
+        int64_t distance = -rhs / term.alpha;
+        if (static_cast<double>(std::llabs(distance)) > term.maxIter) {
+            dep.independent = true;
+            return dep;
+        }
+        dep.distances[sivLevel] = distance;
+        dep.distanceKnown[sivLevel] = true;
+        dep.directions[sivLevel] = distance > 0 ? DirLess : (distance == 0 ? DirEqual : DirGreater);
+        return dep;
+    }
+
+    // 4. Banerjee：先整体，再逐层细化方向
+    auto feasible = [&](int level, unsigned dir) {
+        double lo = 0.0, hi = 0.0;
+        for (const auto& term : terms) {
+            double tlo = 0.0, thi = 0.0;
+            if (!TermBounds(term, term.level == level ? dir : DirAll, tlo, thi)) return false;
+            lo += tlo;
+            hi += thi;
+        }
+        double value = static_cast<double>(rhs);
+        return value >= lo && value <= hi;
+    };
+
+    dep.test = "banerjee";
+    if (!feasible(-1, DirAll)) {
+        dep.independent = true;
+        return dep;
+    }
+    for (size_t k = 0; k < depth; ++k) {
+        unsigned allowed = DirNone;
+        for (unsigned dir : {DirLess, DirEqual, DirGreater}) {
+            if (feasible(static_cast<int>(k), dir)) allowed |= dir;
+        }
+        if (allowed == DirNone) {
+            dep.independent = true;
+            return dep;
+        }
+        dep.directions[k] = allowed;
+    }
+    return dep;
+}
+
+// ============================================
+// 在图上运行
+// ============================================
+
+void ArrayDependenceAnalyzer::Run(ComputeGraph& graph)
+{
+    std::vector<AccessInfo> accesses;
+    for (const auto& node : graph.GetAllNodes()) {
+        if (node->kind != ComputeNodeKind::ArrayAccess) continue;
+        AccessInfo info;
+        if (CollectAccess(*node, info)) {
+            accesses.push_back(std::move(info));
+        }
+    }
+    if (accesses.empty()) return;
+
+    int tested = 0;
+    int mayAlias = 0;
+    int disjointBases = 0;     // 【新增】指针分析证明不重叠的不同基址访问对
+    int independent = 0;
+    int carried = 0;
+    int loopIndependent = 0;
+    std::string innerDependence = "none";
+    int64_t minInnerDistance = -1;
+
+    auto addEdge = [&graph](ComputeNode::NodeId from, ComputeNode::NodeId to,
+                            ComputeEdgeKind kind, const std::string& label) -> ComputeGraph::EdgePtr {
+        for (const auto& edge : graph.GetOutgoingEdges(from)) {
+            if (edge->targetId == to && edge->kind == kind && edge->label == label) {
+                return nullptr;
+            }
+        }
+        return graph.AddEdge(from, to, kind, label);
+    };
+    auto depKind = [](const AccessInfo& source, const AccessInfo& sink) -> std::string {
+        if (source.isWrite && sink.isRead) return "flow";
+        if (source.isWrite && sink.isWrite) return "output";
+        return "anti";
+    };
+
+    for (size_t i = 0; i < accesses.size(); ++i) {
+        for (size_t j = i; j < accesses.size(); ++j) {
+            const AccessInfo& a = accesses[i];
+            const AccessInfo& b = accesses[j];
+            if (!a.isWrite && !b.isWrite) continue;
+            bool sameBase = a.array == b.array && a.arrayText == b.arrayText;
+            if (!sameBase && !MayAliasBases(a, b)) {
+                disjointBases++;
+                continue;
+            }
+
+            // 公共循环嵌套（由外到内）
+            std::vector<const clang::Stmt*> common;
+            for (auto ita = a.nest.rbegin(), itb = b.nest.rbegin();
+                 ita != a.nest.rend() && itb != b.nest.rend() && *ita == *itb; ++ita, ++itb) {
+                common.push_back(*ita);
+            }
+            if (common.empty()) continue;
+
+            tested++;
+            ArrayDependence dep;
+            if (sameBase) {
+                dep = Test(a, b, common);
+            } else {
+                // 基址可能别名但相对偏移未知：每层任意方向
+                dep.test = "may-alias";
+                dep.directions.assign(common.size(), DirAll);
+                dep.distances.assign(common.size(), 0);
+                dep.distanceKnown.assign(common.size(), false);
+                mayAlias++;
+            }
+            if (dep.independent) {
+                independent++;
+                continue;
+            }
+
+            std::string arrayName = a.array->getNameAsString();
+            if (!sameBase) {
+                arrayName += "/" + b.array->getNameAsString();
+            }
+
+            // 同一迭代内的依赖：按执行顺序连 Memory 边
+            bool canBeEqual = std::all_of(dep.directions.begin(), dep.directions.end(),
+                [](unsigned dir) { return (dir & DirEqual) != 0; });
+            if (canBeEqual && i != j) {
+                bool aFirst = ExecutesBefore(a, b);
+                const AccessInfo& source = aFirst ? a : b;
+                const AccessInfo& sink = aFirst ? b : a;
+                std::string kind = depKind(source, sink);
+                if (auto edge = addEdge(source.nodeId, sink.nodeId, ComputeEdgeKind::Memory,
+                                        arrayName + " " + kind)) {
+                    edge->properties["dep_kind"] = kind;
+                    edge->properties["direction"] = dep.DirectionString(!aFirst);
+                    edge->properties["distance"] = dep.DistanceString(!aFirst);
+                    edge->properties["dep_test"] = dep.test;
+                    loopIndependent++;
+                }
+            }
+
+            // 跨迭代的依赖：第一层非'='方向决定携带层与方向
+            for (bool forward : {true, false}) {
+                if (i == j && !forward) continue;   // 自身依赖两个方向对称
+
+                int carrier = -1;
+                unsigned want = forward ? DirLess : DirGreater;
+                for (size_t k = 0; k < dep.directions.size(); ++k) {
+                    if (dep.directions[k] & want) {
+                        carrier = static_cast<int>(k);
+                        break;
+                    }
+                    if (!(dep.directions[k] & DirEqual)) break;
+                }
+                if (carrier < 0) continue;
+
+                const AccessInfo& source = forward ? a : b;
+                const AccessInfo& sink = forward ? b : a;
+                std::string kind = depKind(source, sink);
+                std::string dirText = dep.DirectionString(!forward);
+                auto edge = addEdge(source.nodeId, sink.nodeId, ComputeEdgeKind::LoopCarried,
+                                    arrayName + " " + kind + " " + dirText);
+                if (!edge) continue;
+
+                bool innerCarried = carrier + 1 == static_cast<int>(dep.directions.size());
+                size_t inner = dep.directions.size() - 1;
+                edge->properties["dep_kind"] = kind;
+                edge->properties["direction"] = dirText;
+                edge->properties["distance"] = dep.DistanceString(!forward);
+                edge->properties["dep_test"] = dep.test;
+                edge->properties["carrier_level"] = std::to_string(carrier);
+                edge->properties["inner_carried"] = innerCarried ? "true" : "false";
+                // 【修复】反依赖只有在迭代内读先于写时，按源码顺序逐语句向量化才仍读到旧值；
+                // 写在前时向量写会覆盖后续迭代要读的元素，与流依赖一样受距离约束
+                bool harmlessAnti = kind == "anti" && ExecutesBefore(source, sink);
+                if (kind == "anti") {
+                    edge->properties["read_before_write"] = harmlessAnti ? "true" : "false";
+                }
+                carried++;
+
+                if (!innerCarried) continue;
+                if (dep.distanceKnown[inner]) {
+                    int64_t distance = std::llabs(dep.distances[inner]);
+                    edge->properties["inner_distance"] = std::to_string(distance);
+                    if (!harmlessAnti && (minInnerDistance < 0 || distance < minInnerDistance)) {
+                        minInnerDistance = distance;
+                    }
+                }
+                if (DependenceRank(kind) > DependenceRank(innerDependence)) {
+                    innerDependence = kind;
+                }
+            }
+        }
+    }
+
+    graph.SetProperty("dep_pairs_tested", std::to_string(tested));
+    graph.SetProperty("dep_independent", std::to_string(independent));
+    if (mayAlias > 0) {
+        graph.SetProperty("dep_may_alias", std::to_string(mayAlias));
+    }
+    // 【新增】不同基址的访问按哪种指针分析判定（off 表示按“不同名即不同对象”假定）
+    cpg::PointsToMode pointsToMode = cpgContext ? cpgContext->GetPointsToMode() : cpg::PointsToMode::Off;
+    graph.SetProperty("dep_points_to", cpg::PointsToModeName(pointsToMode));
+    if (pointsToMode != cpg::PointsToMode::Off) {
+        graph.SetProperty("dep_disjoint_bases", std::to_string(disjointBases));
+    }
+    graph.SetProperty("dep_loop_carried", std::to_string(carried));
+    graph.SetProperty("dep_loop_independent", std::to_string(loopIndependent));
+    graph.SetProperty("inner_loop_dependence", innerDependence);
+    if (minInnerDistance >= 0) {
+        graph.SetProperty("min_dep_distance", std::to_string(minInnerDistance));
+    }
+}
+
+} // namespace compute_graph
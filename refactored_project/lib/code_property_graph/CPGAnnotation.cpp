@@ -162,7 +162,8 @@ std::string CallContext::ToString() const
 
 bool PathCondition::IsFeasible() const
 {
-    return true;
+    PathFeasibilityChecker checker;
+    return checker.IsFeasible(*this);
 }
 
 std::string PathCondition::ToString() const
@@ -269,6 +270,11 @@ std::set<const clang::Stmt*> CPGContext::GetDefinitions(
 
     auto it = reachingDefsMap.find(func);
     if (it == reachingDefsMap.end()) {
+        // 【新增】数据被流水线提前释放时结果不完整，不能静默返回空
+        if (IsReleased(func) && releasedQueryWarned.insert(func->getCanonicalDecl()).second) {
+            llvm::errs() << "Warning: definitions queried after the CPG of '"
+                         << func->getNameAsString() << "' was released; results are incomplete\n";
+        }
         return {};
     }
 
@@ -401,13 +407,38 @@ void CPGContext::ExploreSuccessors(
     int maxDepth,
     std::vector<ICFGNode*>& currentPath,
     std::set<ICFGNode*>& visited,
-    std::vector<std::vector<ICFGNode*>>& allPaths) const
+    std::vector<std::vector<ICFGNode*>>& allPaths,
+    PathSearchState& state) const
 {
-    for (auto* succ : GetSuccessors(node)) {
-        if (!visited.count(succ)) {
+    const clang::Stmt* terminator = node->cfgBlock ? node->cfgBlock->getTerminatorStmt() : nullptr;
+
+    for (const auto& [succ, kind] : GetSuccessorsWithEdgeKind(node)) {
+        if (visited.count(succ)) {
+            continue;
+        }
+
+        bool branchEdge = kind == ICFGEdgeKind::True || kind == ICFGEdgeKind::False;
+        bool leavesActivation = kind == ICFGEdgeKind::Call || kind == ICFGEdgeKind::Return ||
+                                kind == ICFGEdgeKind::ParamIn || kind == ICFGEdgeKind::ParamOut;
+
+        // 离开起点所在的函数活动后，同一形参可能对应不同的实参，不再记录条件
+        bool savedRecording = state.recording;
+        if (leavesActivation) {
+            state.recording = false;
+        }
+
+        bool recorded = state.recording && branchEdge && terminator;
+        if (recorded) {
+            state.path.AddCondition(terminator, kind == ICFGEdgeKind::True);
+        }
+        if (!recorded || state.checker.IsFeasible(state.path)) {
             FindPathsDFS(succ, sink, depth + 1, maxDepth,
-                         currentPath, visited, allPaths);
+                         currentPath, visited, allPaths, state);
+        }
+        if (recorded) {
+            state.path.conditions.pop_back();
         }
+        state.recording = savedRecording;
     }
 }
 
@@ -419,7 +450,8 @@ void CPGContext::FindPathsDFS(
     int maxDepth,
     std::vector<ICFGNode*>& currentPath,
     std::set<ICFGNode*>& visited,
-    std::vector<std::vector<ICFGNode*>>& allPaths) const
+    std::vector<std::vector<ICFGNode*>>& allPaths,
+    PathSearchState& state) const
 {
     if (depth > maxDepth) {
         return;
@@ -432,7 +464,7 @@ void CPGContext::FindPathsDFS(
         allPaths.push_back(currentPath);
     } else {
         ExploreSuccessors(node, sink, depth, maxDepth,
-                          currentPath, visited, allPaths);
+                          currentPath, visited, allPaths, state);
     }
 
     visited.erase(node);
@@ -449,7 +481,9 @@ std::vector<std::vector<ICFGNode*>> CPGContext::FindAllPaths(
     std::vector<ICFGNode*> currentPath;
     std::set<ICFGNode*> visited;
 
-    FindPathsDFS(source, sink, 0, maxDepth, currentPath, visited, allPaths);
+    // 【新增】沿途的分支取值组成路径条件，矛盾的组合不再继续展开
+    PathSearchState state(&astContext);
+    FindPathsDFS(source, sink, 0, maxDepth, currentPath, visited, allPaths, state);
     return allPaths;
 }
 
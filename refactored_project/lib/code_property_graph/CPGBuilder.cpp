@@ -9,6 +9,7 @@
 #include "clang/Basic/SourceManager.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <queue>
 
 namespace cpg {
@@ -24,8 +25,10 @@ void CPGContext::BuildCPG(const clang::FunctionDecl* func)
     }
 
     llvm::outs() << "Building CPG for function: " << func->getNameAsString() << "\n";
+    releasedFunctions.erase(func->getCanonicalDecl());
 
     BuildICFG(func);
+    LinkCallSitesOf(func);
     ComputeReachingDefinitions(func);
     BuildPDG(func);
 
@@ -33,9 +36,123 @@ void CPGContext::BuildCPG(const clang::FunctionDecl* func)
                  << func->getNameAsString() << "\n";
 }
 
-void CPGContext::BuildICFGForTranslationUnit()
+namespace {
+
+// 删除指向已释放节点的边
+void DropEdgesTo(std::vector<std::pair<ICFGNode*, ICFGEdgeKind>>& edges,
+                 const std::set<const ICFGNode*>& released)
 {
-    llvm::outs() << "Building global ICFG...\n";
+    edges.erase(std::remove_if(edges.begin(), edges.end(), [&](const auto& edge) {
+        return released.count(edge.first) > 0;
+    }), edges.end());
+}
+
+} // namespace
+
+void CPGContext::BuildICFGFor(const clang::FunctionDecl* func)
+{
+    if (!func || !func->hasBody()) {
+        return;
+    }
+    releasedFunctions.erase(func->getCanonicalDecl());
+    BuildICFG(func);
+    LinkCallSitesOf(func);
+}
+
+bool CPGContext::ReleaseFunction(const clang::FunctionDecl* func)
+{
+    if (!func) {
+        return false;
+    }
+    const auto* canonicalFunc = func->getCanonicalDecl();
+    bool released = false;
+
+    // 断开的调用点在任一端重新构建时重新连接
+    auto sitesIt = callSites.find(canonicalFunc);
+    for (auto it = linkedCalls.begin(); it != linkedCalls.end();) {
+        auto targetIt = callTargets.find(*it);
+        bool touches = (targetIt != callTargets.end() && targetIt->second == canonicalFunc) ||
+                       (sitesIt != callSites.end() && sitesIt->second.count(*it) > 0);
+        if (touches) {
+            it = linkedCalls.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto icfgIt = icfgNodes.find(canonicalFunc);
+    if (icfgIt != icfgNodes.end()) {
+        std::set<const ICFGNode*> owned;
+        for (const auto& node : icfgIt->second) {
+            owned.insert(node.get());
+        }
+        // 调用/返回/参数边会从其他函数的节点指进来，先断开
+        for (const auto& node : icfgIt->second) {
+            for (const auto& [succ, kind] : node->successors) {
+                if (!owned.count(succ)) {
+                    DropEdgesTo(succ->predecessors, owned);
+                }
+            }
+            for (const auto& [pred, kind] : node->predecessors) {
+                if (!owned.count(pred)) {
+                    DropEdgesTo(pred->successors, owned);
+                }
+            }
+            if (node->stmt) {
+                auto stmtIt = stmtToICFGNode.find(node->stmt);
+                if (stmtIt != stmtToICFGNode.end() && stmtIt->second == node.get()) {
+                    stmtToICFGNode.erase(stmtIt);
+                }
+            }
+        }
+        icfgNodes.erase(icfgIt);
+        released = true;
+    }
+    funcEntries.erase(canonicalFunc);
+    funcExits.erase(canonicalFunc);
+
+    // 到达定值按 BuildCPG 传入的声明登记，不一定是规范声明
+    for (auto it = reachingDefsMap.begin(); it != reachingDefsMap.end();) {
+        if (it->first->getCanonicalDecl() == canonicalFunc) {
+            it = reachingDefsMap.erase(it);
+            released = true;
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = pdgNodes.begin(); it != pdgNodes.end();) {
+        const clang::FunctionDecl* owner = it->second->func;
+        if (owner && owner->getCanonicalDecl() == canonicalFunc) {
+            it = pdgNodes.erase(it);
+            released = true;
+        } else {
+            ++it;
+        }
+    }
+    if (cfgCache.erase(canonicalFunc) > 0) {
+        released = true;
+    }
+    if (valueRanges) {
+        valueRanges->Release(canonicalFunc);
+    }
+    if (alignment) {
+        alignment->Release(canonicalFunc);
+    }
+    if (released) {
+        releasedFunctions.insert(canonicalFunc);
+        releasedQueryWarned.erase(canonicalFunc);
+    }
+    return released;
+}
+
+bool CPGContext::IsReleased(const clang::FunctionDecl* func) const
+{
+    return func && releasedFunctions.count(func->getCanonicalDecl()) > 0;
+}
+
+std::vector<const clang::FunctionDecl*> CPGContext::CollectTranslationUnitFunctions() const
+{
+    std::vector<const clang::FunctionDecl*> result;
     clang::SourceManager& sm = astContext.getSourceManager();
 
     for (clang::Decl* decl : astContext.getTranslationUnitDecl()->decls()) {
@@ -61,9 +178,21 @@ void CPGContext::BuildICFGForTranslationUnit()
                 sm.isInSystemHeader(func->getBody()->getBeginLoc())) {
                 continue;
             }
-            BuildICFG(func);
+            result.push_back(func);
         }
     }
+    return result;
+}
+
+void CPGContext::BuildICFGForTranslationUnit()
+{
+    llvm::outs() << "Building global ICFG...\n";
+
+    auto functions = CollectTranslationUnitFunctions();
+    for (const auto* func : functions) {
+        callGraphFunctions.insert(func->getCanonicalDecl());
+        BuildICFG(func);
+    }
 
     BuildCallGraph();
     LinkCallSites();
@@ -71,6 +200,19 @@ void CPGContext::BuildICFGForTranslationUnit()
     llvm::outs() << "Global ICFG construction completed\n";
 }
 
+void CPGContext::BuildCallGraphForTranslationUnit()
+{
+    llvm::outs() << "Building call graph...\n";
+
+    for (const auto* func : CollectTranslationUnitFunctions()) {
+        callGraphFunctions.insert(func->getCanonicalDecl());
+    }
+    BuildCallGraph();
+
+    llvm::outs() << "Call graph construction completed (" << callGraphFunctions.size()
+                 << " functions, ICFGs built on demand)\n";
+}
+
 // ============================================
 // ICFG构建实现
 // ============================================
@@ -335,7 +477,7 @@ bool CPGContext::ContainsCallExpr(
 }
 
     // 辅助函数：注册单个调用点
-void CPGContext::RegisterCallSite(clang::CallExpr* call)
+void CPGContext::RegisterCallSite(clang::CallExpr* call, const clang::FunctionDecl* caller)
 {
     clang::FunctionDecl* callee = call->getDirectCallee();
     if (!callee) {
@@ -350,10 +492,57 @@ void CPGContext::RegisterCallSite(clang::CallExpr* call)
     }
     callTargets[call] = calleeToStore->getCanonicalDecl();
 
-    const clang::FunctionDecl* containingFunc = FindContainingFunctionForCall(call);
-    if (containingFunc) {
-        callSites[containingFunc].insert(call);
+    // 【修改】调用者取遍历时所在的函数，不再在已构建的ICFG中查找
+    if (caller && callGraphFunctions.count(caller->getCanonicalDecl())) {
+        callSites[caller->getCanonicalDecl()].insert(call);
+    }
+}
+
+const clang::FunctionDecl* CPGContext::GetCallTarget(const clang::CallExpr* call) const
+{
+    auto it = callTargets.find(call);
+    return it != callTargets.end() ? it->second : nullptr;
+}
+
+std::set<const clang::FunctionDecl*> CPGContext::GetCallees(const clang::FunctionDecl* func) const
+{
+    std::set<const clang::FunctionDecl*> callees;
+    if (!func) {
+        return callees;
+    }
+    auto sitesIt = callSites.find(func->getCanonicalDecl());
+    if (sitesIt == callSites.end()) {
+        return callees;
+    }
+    for (const clang::CallExpr* call : sitesIt->second) {
+        auto targetIt = callTargets.find(call);
+        if (targetIt != callTargets.end() && targetIt->second) {
+            callees.insert(targetIt->second);
+        }
+    }
+    callees.erase(func->getCanonicalDecl());
+    return callees;
+}
+
+std::set<const clang::FunctionDecl*> CPGContext::GetCallers(const clang::FunctionDecl* func) const
+{
+    std::set<const clang::FunctionDecl*> callers;
+    if (!func) {
+        return callers;
+    }
+    const auto* canonicalFunc = func->getCanonicalDecl();
+
+    for (const auto& [caller, calls] : callSites) {
+        for (const clang::CallExpr* call : calls) {
+            auto targetIt = callTargets.find(call);
+            if (targetIt != callTargets.end() && targetIt->second == canonicalFunc) {
+                callers.insert(caller);
+                break;
+            }
+        }
     }
+    callers.erase(canonicalFunc);
+    return callers;
 }
 
 void CPGContext::BuildCallGraph()
@@ -367,7 +556,37 @@ void CPGContext::LinkCallSites()
 {
     for (const auto& [caller, calls] : callSites) {
         for (const clang::CallExpr* callExpr : calls) {
-            LinkSingleCallSite(caller, callExpr);
+            if (linkedCalls.insert(callExpr).second) {
+                LinkSingleCallSite(caller, callExpr);
+            }
+        }
+    }
+}
+
+void CPGContext::LinkCallSitesOf(const clang::FunctionDecl* func)
+{
+    const auto* canonicalFunc = func->getCanonicalDecl();
+    if (funcEntries.find(canonicalFunc) == funcEntries.end()) {
+        return;
+    }
+
+    for (const auto& [caller, calls] : callSites) {
+        if (funcEntries.find(caller) == funcEntries.end()) {
+            continue;
+        }
+        for (const clang::CallExpr* callExpr : calls) {
+            auto targetIt = callTargets.find(callExpr);
+            const clang::FunctionDecl* callee = targetIt != callTargets.end() ? targetIt->second : nullptr;
+            if (caller != canonicalFunc && callee != canonicalFunc) {
+                continue;
+            }
+            // 被调函数参与分析但ICFG尚未构建：等它构建时再连接
+            if (callee && callGraphFunctions.count(callee) && funcEntries.find(callee) == funcEntries.end()) {
+                continue;
+            }
+            if (linkedCalls.insert(callExpr).second) {
+                LinkSingleCallSite(caller, callExpr);
+            }
         }
     }
 }
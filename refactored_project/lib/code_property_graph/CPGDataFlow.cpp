@@ -2,6 +2,7 @@
 * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
  */
 #include "CPGAnnotation.h"
+#include "clang/AST/ParentMapContext.h"
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -531,11 +532,61 @@ PDGNode* CPGContext::GetPDGNodeInContext(const clang::Stmt* stmt,
     return GetPDGNode(stmt);
 }
 
+// 辅助函数：收集执行到 stmt 必须满足的外层分支条件（then/else 体、while/for 循环体）
+static void AppendEnclosingConditions(clang::ASTContext& ctx, const clang::Stmt* stmt,
+                                      PathCondition& path)
+{
+    clang::DynTypedNode child = clang::DynTypedNode::create(*stmt);
+    for (int hops = 0; hops < 64; ++hops) {
+        auto parents = ctx.getParents(child);
+        if (parents.empty()) {
+            return;
+        }
+        const clang::DynTypedNode& parent = parents[0];
+        const clang::Stmt* childStmt = child.get<clang::Stmt>();
+
+        if (auto* ifStmt = parent.get<clang::IfStmt>()) {
+            if (childStmt && childStmt == ifStmt->getThen()) {
+                path.AddCondition(ifStmt, true);
+            } else if (childStmt && childStmt == ifStmt->getElse()) {
+                path.AddCondition(ifStmt, false);
+            }
+        } else if (auto* whileStmt = parent.get<clang::WhileStmt>()) {
+            if (childStmt && childStmt == whileStmt->getBody()) {
+                path.AddCondition(whileStmt, true);
+            }
+        } else if (auto* forStmt = parent.get<clang::ForStmt>()) {
+            if (childStmt && childStmt == forStmt->getBody() && forStmt->getCond()) {
+                path.AddCondition(forStmt, true);
+            }
+        } else if (parent.get<clang::FunctionDecl>()) {
+            return;
+        }
+        child = parent;
+    }
+}
+
 std::vector<DataDependency> CPGContext::GetDataDependenciesOnPath(
     const clang::Stmt* stmt,
     const PathCondition& path) const
 {
-    return GetDataDependencies(stmt);
+    // 【修改】路径本身矛盾时没有依赖；否则剔除定义点的外层分支条件与路径矛盾的依赖
+    PathFeasibilityChecker checker(&astContext);
+    if (!checker.IsFeasible(path)) {
+        return {};
+    }
+
+    std::vector<DataDependency> result;
+    for (const auto& dep : GetDataDependencies(stmt)) {
+        PathCondition extended = path;
+        if (dep.sourceStmt) {
+            AppendEnclosingConditions(astContext, dep.sourceStmt, extended);
+        }
+        if (extended.conditions.size() == path.conditions.size() || checker.IsFeasible(extended)) {
+            result.push_back(dep);
+        }
+    }
+    return result;
 }
 
 // 辅助函数：处理单个调用点的上下文敏感遍历
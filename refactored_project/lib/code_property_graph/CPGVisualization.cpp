@@ -3,10 +3,18 @@
  */
 #include "code_property_graph/CPGAnnotation.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <tuple>
+
 namespace cpg {
 
+namespace {
+constexpr size_t kICFGFlatNodeLimit = 2000;     // 超过该节点数时折叠被调函数
+constexpr size_t kICFGDotBufferSize = 1 << 20;
+} // namespace
+
 // ============================================
 // 可视化入口方法
 // ============================================
@@ -153,6 +161,71 @@ void CPGContext::WriteICFGFunctionEdges(
     }
 }
 
+// 【新增】折叠被调函数后的ICFG总览：每个被调函数一个摘要节点，函数体写到单独的下钻文件
+void CPGContext::ExportICFGCollapsedCallees(
+    llvm::raw_fd_ostream& out,
+    const clang::FunctionDecl* func,
+    const std::set<const clang::FunctionDecl*>& funcsToInclude,
+    const std::string& filename) const
+{
+    const clang::FunctionDecl* entryFunc = func->getCanonicalDecl();
+    llvm::StringRef stem(filename);
+    stem.consume_back(".dot");
+
+    // 入口函数的节点各占一个ID，被调函数的全部节点共用其摘要节点的ID
+    std::map<ICFGNode*, int> globalNodeIds;
+    int globalId = 0;
+    auto entryIt = icfgNodes.find(entryFunc);
+    if (entryIt != icfgNodes.end()) {
+        for (const auto& node : entryIt->second) {
+            globalNodeIds[node.get()] = globalId++;
+        }
+    }
+    WriteICFGSubgraph(out, entryFunc, func, globalNodeIds);
+
+    out << "  // Collapsed callees\n";
+    for (const auto* includedFunc : funcsToInclude) {
+        auto it = icfgNodes.find(includedFunc);
+        if (includedFunc == entryFunc || it == icfgNodes.end()) {
+            continue;
+        }
+
+        int summaryId = globalId++;
+        for (const auto& node : it->second) {
+            globalNodeIds[node.get()] = summaryId;
+        }
+
+        std::string calleeFile = stem.str() + "." + includedFunc->getNameAsString() + ".dot";
+        ExportICFGDotFile(includedFunc, calleeFile);
+        out << "  n" << summaryId << " [shape=box3d, style=filled, fillcolor=lightyellow, label=\""
+            << EscapeForDot(includedFunc->getNameAsString()) << "\\n" << it->second.size()
+            << " nodes\", URL=\"" << llvm::sys::path::filename(calleeFile) << "\"];\n";
+    }
+
+    // 跨函数的边按 (源, 目标, 类型) 去重，被调函数内部的边不再画出
+    out << "  // Edges\n";
+    std::set<std::tuple<int, int, ICFGEdgeKind>> written;
+    for (const auto* includedFunc : funcsToInclude) {
+        auto it = icfgNodes.find(includedFunc);
+        if (it == icfgNodes.end()) {
+            continue;
+        }
+        for (const auto& node : it->second) {
+            int fromId = globalNodeIds.at(node.get());
+            for (const auto& [succ, kind] : node->successors) {
+                auto toIt = globalNodeIds.find(succ);
+                if (toIt == globalNodeIds.end() || toIt->second == fromId ||
+                    !written.insert(std::make_tuple(fromId, toIt->second, kind)).second) {
+                    continue;
+                }
+                out << "  n" << fromId << " -> n" << toIt->second << " [";
+                WriteEdgeAttributes(out, kind);
+                out << "];\n";
+            }
+        }
+    }
+}
+
 // 主函数：导出ICFG及其调用的函数
 // 注意：使用你已有的 CollectCalleeFunctions 函数
 void CPGContext::ExportICFGWithCalleesDotFile(
@@ -165,6 +238,7 @@ void CPGContext::ExportICFGWithCalleesDotFile(
         llvm::errs() << "Cannot create file: " << filename << "\n";
         return;
     }
+    out.SetBufferSize(kICFGDotBufferSize);
 
     // 收集所有需要包含的函数
     std::set<const clang::FunctionDecl*> funcsToInclude;
@@ -176,6 +250,20 @@ void CPGContext::ExportICFGWithCalleesDotFile(
     out << "  node [shape=box, fontname=\"Courier\", fontsize=10];\n";
     out << "  compound=true;\n\n";
 
+    // 【新增】节点过多时折叠被调函数（Graphviz 对数千节点的平铺图布局极慢）
+    size_t totalNodes = 0;
+    for (const auto* includedFunc : funcsToInclude) {
+        auto it = icfgNodes.find(includedFunc);
+        if (it != icfgNodes.end()) {
+            totalNodes += it->second.size();
+        }
+    }
+    if (funcsToInclude.size() > 1 && totalNodes > kICFGFlatNodeLimit) {
+        ExportICFGCollapsedCallees(out, func, funcsToInclude, filename);
+        out << "}\n";
+        return;
+    }
+
     // 为所有节点分配全局ID
     std::map<ICFGNode*, int> globalNodeIds;
     int globalId = 0;
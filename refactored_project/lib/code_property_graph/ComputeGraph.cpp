@@ -4,6 +4,7 @@
  */
 #include "ComputeGraph.h"
 #include "code_property_graph/CPGAnnotation.h"
+#include "SIMDCostModel.h"
 
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/AST/ParentMapContext.h"
@@ -11,10 +12,12 @@
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/FileSystem.h"
 
+#include <cstdint>
 #include <queue>
 #include <stack>
 #include <algorithm>
 #include <sstream>
+#include <tuple>
 
 namespace compute_graph {
 
@@ -36,6 +39,9 @@ std::string DataTypeInfo::ToString() const
         case BaseType::UInt64: oss << "u64"; break;
         case BaseType::Float: oss << "f32"; break;
         case BaseType::Double: oss << "f64"; break;
+        case BaseType::Float16: oss << (isStorageOnly ? "fp16" : "f16"); break;
+        case BaseType::BFloat16: oss << "bf16"; break;
+        case BaseType::Predicate: oss << "pred"; break;
         case BaseType::Pointer: oss << "ptr"; break;
         case BaseType::Array: oss << "arr"; break;
         case BaseType::Void: oss << "void"; break;
@@ -49,12 +55,116 @@ std::string DataTypeInfo::ToString() const
             break;
         default: oss << "unknown"; break;
     }
-    if (vectorWidth > 1) {
+    if (isScalable) {
+        oss << "x(vscale*" << vectorWidth << ")";
+    } else if (vectorWidth > 1) {
         oss << "x" << vectorWidth;
     }
     return oss.str();
 }
 
+bool DataTypeInfo::IsFloatingPoint() const
+{
+    return baseType == BaseType::Float || baseType == BaseType::Double ||
+           baseType == BaseType::Float16 || baseType == BaseType::BFloat16;
+}
+
+// 半精度/bfloat16 等低精度浮点标量
+bool DataTypeInfo::FromBuiltinFloat(const clang::BuiltinType* builtin, DataTypeInfo& info)
+{
+    switch (builtin->getKind()) {
+        case clang::BuiltinType::Half:       // __fp16：仅存储格式
+            info.baseType = BaseType::Float16;
+            info.isStorageOnly = true;
+            break;
+        case clang::BuiltinType::Float16:    // _Float16
+            info.baseType = BaseType::Float16;
+            break;
+        case clang::BuiltinType::BFloat16:   // __bf16
+            info.baseType = BaseType::BFloat16;
+            break;
+        default:
+            return false;
+    }
+    info.bitWidth = 16;
+    info.totalBitWidth = 16;
+    info.isSigned = true;
+    return true;
+}
+
+// SVE sizeless 内建类型，按名字解析（各版本clang的 .def 宏签名不一致）
+//   __SVFloat32_t / __SVInt8_t / __SVUint16_t / __SVBfloat16_t / __SVBool_t
+//   __clang_svfloat32x2_t 等多向量元组
+bool DataTypeInfo::FromSizelessBuiltin(const clang::BuiltinType* builtin, DataTypeInfo& info)
+{
+    clang::LangOptions langOpts;
+    clang::PrintingPolicy policy(langOpts);
+    llvm::StringRef name = builtin->getName(policy);
+
+    int tupleCount = 1;
+    if (name.consume_front("__SV")) {
+        name.consume_back("_t");
+    } else if (name.consume_front("__clang_sv")) {
+        name.consume_back("_t");
+        std::pair<llvm::StringRef, llvm::StringRef> parts = name.rsplit('x');
+        if (!parts.second.empty() && !parts.second.getAsInteger(10, tupleCount)) {
+            name = parts.first;
+        } else {
+            tupleCount = 1;
+        }
+    } else {
+        return false;  // 其他 sizeless 类型（如RVV）暂不建模
+    }
+
+    std::string lower = name.lower();
+    llvm::StringRef kind(lower);
+    int bits = 0;
+
+    if (kind == "bool") {
+        info.baseType = BaseType::Predicate;
+        info.bitWidth = 1;
+        info.vectorWidth = 16 * tupleCount;
+        info.totalBitWidth = 16 * tupleCount;
+        info.isScalable = true;
+        info.isSigned = false;
+        return true;
+    }
+
+    if (kind.consume_front("bfloat")) {
+        info.baseType = BaseType::BFloat16;
+    } else if (kind.consume_front("float")) {
+        info.baseType = BaseType::Float;
+    } else if (kind.consume_front("uint")) {
+        info.baseType = BaseType::UInt32;
+        info.isSigned = false;
+    } else if (kind.consume_front("int")) {
+        info.baseType = BaseType::Int32;
+    } else {
+        return false;
+    }
+
+    if (kind.getAsInteger(10, bits) || bits <= 0 || bits > 64) {
+        return false;
+    }
+
+    if (info.baseType == BaseType::Float) {
+        info.baseType = bits == 16 ? BaseType::Float16 :
+                        bits == 64 ? BaseType::Double : BaseType::Float;
+    } else if (info.baseType == BaseType::Int32 || info.baseType == BaseType::UInt32) {
+        static const BaseType kSigned[] = {BaseType::Int8, BaseType::Int16, BaseType::Int32, BaseType::Int64};
+        static const BaseType kUnsigned[] = {BaseType::UInt8, BaseType::UInt16, BaseType::UInt32, BaseType::UInt64};
+        int idx = bits == 8 ? 0 : bits == 16 ? 1 : bits == 32 ? 2 : 3;
+        info.baseType = info.isSigned ? kSigned[idx] : kUnsigned[idx];
+    }
+
+    // 最小向量长度为128位（vscale = 1）
+    info.bitWidth = bits;
+    info.vectorWidth = (128 / bits) * tupleCount;
+    info.totalBitWidth = 128 * tupleCount;
+    info.isScalable = true;
+    return true;
+}
+
 DataTypeInfo DataTypeInfo::FromClangType(const clang::QualType& type)
 {
     DataTypeInfo info;
@@ -99,6 +209,29 @@ DataTypeInfo DataTypeInfo::FromClangType(const clang::QualType& type)
         return info;
     }
 
+    // 【新增】定长向量：GCC vector_size / NEON / SSE / AVX / ext_vector_type
+    if (const auto* vecType = typePtr->getAs<clang::VectorType>()) {
+        info = FromClangType(vecType->getElementType());
+        info.vectorWidth = static_cast<int>(vecType->getNumElements());
+        info.totalBitWidth = info.bitWidth * info.vectorWidth;
+        info.typeName = type.getAsString();
+        return info;
+    }
+
+    // 【新增】低精度浮点与 SVE 可伸缩向量
+    if (const auto* builtin = type.getCanonicalType()->getAs<clang::BuiltinType>()) {
+        if (FromBuiltinFloat(builtin, info)) {
+            return info;
+        }
+        if (builtin->isSizelessBuiltinType()) {
+            if (!FromSizelessBuiltin(builtin, info)) {
+                info.baseType = BaseType::Unknown;
+            }
+            info.typeName = type.getAsString();
+            return info;
+        }
+    }
+
     if (typePtr->isPointerType()) {
         info.baseType = BaseType::Pointer;
         info.bitWidth = 64;  // 假设64位系统
@@ -164,6 +297,7 @@ DataTypeInfo DataTypeInfo::FromClangType(const clang::QualType& type)
         info.baseType = BaseType::Void;
     }
 
+    info.totalBitWidth = info.bitWidth;
     return info;
 }
 
@@ -188,13 +322,13 @@ std::string ComputeNode::GetLabel() const
 
     if (kind == ComputeNodeKind::BinaryOp ||
         kind == ComputeNodeKind::UnaryOp ||
-        kind == ComputeNodeKind::CompareOp) {
+        kind == ComputeNodeKind::CompareOp ||
+        (kind == ComputeNodeKind::IntrinsicCall && opCode != OpCode::Unknown)) {
         oss << " [" << OpCodeToString(opCode) << "]";
     }
 
     if (hasConstValue) {
-        if (dataType.baseType == DataTypeInfo::BaseType::Float ||
-            dataType.baseType == DataTypeInfo::BaseType::Double) {
+        if (dataType.IsFloatingPoint()) {
             oss << " = " << constValue.floatValue;
         } else {
             oss << " = " << constValue.intValue;
@@ -235,6 +369,7 @@ bool ComputeNode::IsVectorizable() const
         case ComputeNodeKind::Store:
         case ComputeNodeKind::ArrayAccess:
         case ComputeNodeKind::Cast:
+        case ComputeNodeKind::IntrinsicCall:
             return true;
         case ComputeNodeKind::Call:
             // 某些内置函数可以向量化
@@ -359,6 +494,19 @@ ComputeGraph::NodePtr ComputeGraph::GetNode(ComputeNode::NodeId id) const
 
 ComputeGraph::NodePtr ComputeGraph::FindNodeByStmt(const clang::Stmt* stmt) const
 {
+    if (!stmt) return nullptr;
+
+    // 【修复】astStmt 在 CreateNode 之后才由构建器设置，映射在有新节点时按需重建
+    if (stmtIndexStamp != nextNodeId) {
+        stmtToNode.clear();
+        for (const auto& [id, node] : nodes) {
+            if (node->astStmt) {
+                stmtToNode.emplace(node->astStmt, id);
+            }
+        }
+        stmtIndexStamp = nextNodeId;
+    }
+
     auto it = stmtToNode.find(stmt);
     if (it != stmtToNode.end()) {
         return GetNode(it->second);
@@ -412,6 +560,7 @@ ComputeGraph::EdgePtr ComputeGraph::AddEdge(
     auto edge = std::make_shared<ComputeEdge>(nextEdgeId++, kind, src, tgt);
     edge->label = varName;
     edges[edge->id] = edge;
+    edgeKeyCounts[MakeEdgeKey(*edge)]++;
 
     UpdateAdjacencyLists(edge);
 
@@ -441,6 +590,12 @@ void ComputeGraph::RemoveEdge(ComputeEdge::EdgeId id)
 
     auto edge = edgeIt->second;
 
+    // 【新增】更新边存在性索引
+    auto keyIt = edgeKeyCounts.find(MakeEdgeKey(*edge));
+    if (keyIt != edgeKeyCounts.end() && --keyIt->second == 0) {
+        edgeKeyCounts.erase(keyIt);
+    }
+
     // 更新邻接表
     auto& srcOutEdges = outEdges[edge->sourceId];
     srcOutEdges.erase(
@@ -455,6 +610,42 @@ void ComputeGraph::RemoveEdge(ComputeEdge::EdgeId id)
     edges.erase(edgeIt);
 }
 
+size_t ComputeGraph::EdgeKeyHash::operator()(const EdgeKey& key) const
+{
+    size_t h = std::hash<uint64_t>()(key.src);
+    h ^= std::hash<uint64_t>()(key.tgt) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    uint64_t tail = (static_cast<uint64_t>(key.kind) << 32) | key.labelId;
+    h ^= std::hash<uint64_t>()(tail) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+ComputeGraph::EdgeKey ComputeGraph::MakeEdgeKey(const ComputeEdge& edge)
+{
+    EdgeKey key;
+    key.src = edge.sourceId;
+    key.tgt = edge.targetId;
+    key.kind = static_cast<uint32_t>(edge.kind);
+    key.labelId = edgeLabelIds.emplace(edge.label,
+        static_cast<uint32_t>(edgeLabelIds.size())).first->second;
+    return key;
+}
+
+bool ComputeGraph::HasEdge(ComputeNode::NodeId src, ComputeNode::NodeId tgt,
+                           ComputeEdgeKind kind, const std::string& label) const
+{
+    auto labelIt = edgeLabelIds.find(label);
+    if (labelIt == edgeLabelIds.end()) {
+        return false;   // 从未出现过的标签
+    }
+
+    EdgeKey key;
+    key.src = src;
+    key.tgt = tgt;
+    key.kind = static_cast<uint32_t>(kind);
+    key.labelId = labelIt->second;
+    return edgeKeyCounts.count(key) != 0;
+}
+
 std::vector<ComputeGraph::EdgePtr> ComputeGraph::GetIncomingEdges(
     ComputeNode::NodeId nodeId) const
 {
@@ -601,6 +792,8 @@ std::vector<ComputeGraph::NodePtr> ComputeGraph::TopologicalSort() const
         newEdge->weight = edge->weight;
         newEdge->properties = edge->properties;
     }
+
+    idiomMask |= other.idiomMask;
 }
 
     ComputeGraph ComputeGraph::ExtractSubgraph(
@@ -659,6 +852,8 @@ ComputeGraph ComputeGraph::Clone() const
 
     auto cloned = ExtractSubgraph(allIds);
     cloned.name = name + "_clone";
+    cloned.properties = properties;
+    cloned.idiomMask = idiomMask;
     return cloned;
 }
 
@@ -667,9 +862,12 @@ void ComputeGraph::Clear()
     nodes.clear();
     edges.clear();
     stmtToNode.clear();
+    stmtIndexStamp = 0;
     nameToNode.clear();
     inEdges.clear();
     outEdges.clear();
+    edgeLabelIds.clear();
+    edgeKeyCounts.clear();
     nextNodeId = 0;
     nextEdgeId = 0;
 }
@@ -706,6 +904,31 @@ bool ComputeGraph::IsIsomorphicTo(const ComputeGraph& other) const
     return ComputeCanonicalSignature() == other.ComputeCanonicalSignature();
 }
 
+std::map<const clang::FunctionDecl*, std::string> ComputeGraph::AssignFunctionColors() const
+{
+    static const char* const colorPalette[] = {
+        "#cce5ff",  // 浅蓝
+        "#d4edda",  // 浅绿
+        "#fff3cd",  // 浅黄
+        "#f8d7da",  // 浅红
+        "#e2e3e5",  // 浅灰
+        "#d1ecf1",  // 浅青
+        "#ffeeba",  // 橙黄
+        "#c3e6cb",  // 薄荷绿
+    };
+    constexpr size_t paletteSize = sizeof(colorPalette) / sizeof(colorPalette[0]);
+
+    std::map<const clang::FunctionDecl*, std::string> funcColors;
+    size_t colorIdx = 0;
+    for (const auto& [id, node] : nodes) {
+        if (node->containingFunc && funcColors.find(node->containingFunc) == funcColors.end()) {
+            funcColors[node->containingFunc] = colorPalette[colorIdx % paletteSize];
+            colorIdx++;
+        }
+    }
+    return funcColors;
+}
+
 void ComputeGraph::ExportDotFile(const std::string& filename) const
 {
     std::error_code EC;
@@ -714,6 +937,8 @@ void ComputeGraph::ExportDotFile(const std::string& filename) const
         llvm::errs() << "Cannot create file: " << filename << "\n";
         return;
     }
+    // 【修改】大缓冲区逐行写出，标签不再预先拼成字符串
+    out.SetBufferSize(kDotWriteBufferSize);
 
     out << "digraph ComputeGraph {\n";
     out << "  rankdir=TB;\n";  // 从上到下
@@ -735,24 +960,7 @@ void ComputeGraph::ExportDotFile(const std::string& filename) const
     out << "  edge [fontname=\"Helvetica\", fontsize=8];\n\n";
 
     // 收集所有涉及的函数，为每个函数分配颜色
-    std::map<const clang::FunctionDecl*, std::string> funcColors;
-    std::vector<std::string> colorPalette = {
-        "#cce5ff",  // 浅蓝
-        "#d4edda",  // 浅绿
-        "#fff3cd",  // 浅黄
-        "#f8d7da",  // 浅红
-        "#e2e3e5",  // 浅灰
-        "#d1ecf1",  // 浅青
-        "#ffeeba",  // 橙黄
-        "#c3e6cb",  // 薄荷绿
-    };
-    int colorIdx = 0;
-    for (const auto& [id, node] : nodes) {
-        if (node->containingFunc && funcColors.find(node->containingFunc) == funcColors.end()) {
-            funcColors[node->containingFunc] = colorPalette[colorIdx % colorPalette.size()];
-            colorIdx++;
-        }
-    }
+    auto funcColors = AssignFunctionColors();
 
     // 输出图例（函数颜色说明）
     out << "  // Legend\n";
@@ -779,8 +987,9 @@ void ComputeGraph::ExportDotFile(const std::string& filename) const
 
     // 输出边（带类型标签）
     for (const auto& [id, edge] : edges) {
-        out << "  n" << edge->sourceId << " -> n" << edge->targetId;
-        out << " [" << GetDetailedEdgeStyle(edge) << "];\n";
+        out << "  n" << edge->sourceId << " -> n" << edge->targetId << " [";
+        WriteDetailedEdgeStyle(out, edge);
+        out << "];\n";
     }
 
     out << "}\n";
@@ -923,45 +1132,49 @@ void ComputeGraph::WriteDetailedNode(
 
 std::string ComputeGraph::GetDetailedEdgeStyle(const EdgePtr& edge) const
 {
-    std::ostringstream oss;
+    std::string style;
+    llvm::raw_string_ostream oss(style);
+    WriteDetailedEdgeStyle(oss, edge);
+    return oss.str();
+}
 
+void ComputeGraph::WriteDetailedEdgeStyle(llvm::raw_ostream& out, const EdgePtr& edge) const
+{
     // 边类型标签
     std::string typeLabel = ComputeEdgeKindToString(edge->kind);
     if (!edge->label.empty()) {
         typeLabel += ": " + edge->label;
     }
-    oss << "label=\"" << EscapeDotString(typeLabel) << "\"";
+    out << "label=\"" << EscapeDotString(typeLabel) << "\"";
 
     // 边样式
     switch (edge->kind) {
         case ComputeEdgeKind::DataFlow:
-            oss << ", color=\"#0066cc\", penwidth=1.5";
+            out << ", color=\"#0066cc\", penwidth=1.5";
             break;
         case ComputeEdgeKind::Control:
             // 检查是否是CFG边
             if (edge->label.find("cfg") == 0) {
                 // CFG边：绿色虚线
-                oss << ", color=\"#00cc00\", style=dashed, penwidth=1.0";
+                out << ", color=\"#00cc00\", style=dashed, penwidth=1.0";
             } else {
                 // 其他控制依赖：红色点线
-                oss << ", color=\"#cc0000\", style=dotted, penwidth=1.0";
+                out << ", color=\"#cc0000\", style=dotted, penwidth=1.0";
             }
             break;
         case ComputeEdgeKind::LoopCarried:
-            oss << ", color=\"#cc0000\", penwidth=2, style=bold";
+            out << ", color=\"#cc0000\", penwidth=2, style=bold";
             break;
         case ComputeEdgeKind::Return:
-            oss << ", color=\"#ff6600\", penwidth=2, style=bold";
+            out << ", color=\"#ff6600\", penwidth=2, style=bold";
             break;
         case ComputeEdgeKind::Call:
-            oss << ", color=\"#006600\", penwidth=2";
+            out << ", color=\"#006600\", penwidth=2";
             break;
         case ComputeEdgeKind::Memory:
-            oss << ", color=\"#660066\", style=dotted, penwidth=1.5";
+            out << ", color=\"#660066\", style=dotted, penwidth=1.5";
             break;
     }
-
-    return oss.str();
 }
 
 void ComputeGraph::ExportDotFileEnhanced(const std::string& filename) const
@@ -1289,6 +1502,98 @@ void ComputeGraph::PrintSummary() const
         llvm::outs() << ComputeNodeKindToString(kind) << "=" << count << " ";
     }
     llvm::outs() << "\n";
+
+    if (HasProperty("cost_speedup")) {
+        llvm::outs() << "  Est. speedup (" << GetProperty("cost_target") << "): "
+                     << GetProperty("cost_speedup") << "x, VF=" << GetProperty("cost_lanes");
+        if (HasProperty("cost_reason")) {
+            llvm::outs() << " [" << GetProperty("cost_reason") << "]";
+        }
+        llvm::outs() << "\n";
+    }
+
+    if (HasProperty("idioms")) {
+        llvm::outs() << "  Idioms: " << GetProperty("idioms");
+        if (GetProperty("fp_reassociation") == "true") {
+            llvm::outs() << " (requires FP reassociation)";
+        }
+        llvm::outs() << "\n";
+    }
+}
+
+void ComputeGraph::DumpCanonical(llvm::raw_ostream& os) const
+{
+    // 1. 节点排序：源码行 → 类型 → 操作码 → 名称 → 源码文本 → 数据类型，最后按原ID
+    std::vector<NodePtr> ordered;
+    ordered.reserve(nodes.size());
+    for (const auto& [id, node] : nodes) {
+        ordered.push_back(node);
+    }
+    auto sortKey = [](const NodePtr& node) {
+        return std::make_tuple(node->sourceLine, static_cast<int>(node->kind), static_cast<int>(node->opCode),
+                               node->name, node->sourceText, node->dataType.ToString(), node->id);
+    };
+    std::sort(ordered.begin(), ordered.end(), [&sortKey](const NodePtr& a, const NodePtr& b) {
+        return sortKey(a) < sortKey(b);
+    });
+    std::map<ComputeNode::NodeId, size_t> canonicalIndex;
+    for (size_t i = 0; i < ordered.size(); ++i) {
+        canonicalIndex[ordered[i]->id] = i;
+    }
+    auto ref = [&canonicalIndex](ComputeNode::NodeId id) {
+        auto it = canonicalIndex.find(id);
+        return it != canonicalIndex.end() ? "n" + std::to_string(it->second) : std::string("n?");
+    };
+
+    os << "graph \"" << name << "\" nodes=" << nodes.size() << " edges=" << edges.size() << "\n";
+    for (const auto& [key, value] : properties) {
+        os << "  @" << key << " = " << value << "\n";
+    }
+
+    // 2. 节点与属性
+    for (size_t i = 0; i < ordered.size(); ++i) {
+        const auto& node = ordered[i];
+        os << "  n" << i << " " << ComputeNodeKindToString(node->kind);
+        if (node->opCode != OpCode::Unknown) {
+            os << " [" << OpCodeToString(node->opCode) << "]";
+        }
+        os << " \"" << node->name << "\" : " << node->dataType.ToString();
+        if (node->sourceLine > 0) {
+            os << " L" << node->sourceLine;
+        }
+        if (node->loopDepth > 0) {
+            os << " depth=" << node->loopDepth;
+        }
+        if (node->loopContextId != 0) {
+            os << " loop=" << ref(node->loopContextId);
+        }
+        if (node->branchContextId != 0) {
+            os << " branch=" << ref(node->branchContextId) << ":" << node->branchType;
+        }
+        os << "\n";
+        for (const auto& [key, value] : node->properties) {
+            os << "    " << key << " = " << value << "\n";
+        }
+    }
+
+    // 3. 边：按 (源, 目标, 类型, 标签) 排序
+    std::vector<std::tuple<size_t, size_t, std::string, std::string>> sortedEdges;
+    sortedEdges.reserve(edges.size());
+    for (const auto& [id, edge] : edges) {
+        auto src = canonicalIndex.find(edge->sourceId);
+        auto dst = canonicalIndex.find(edge->targetId);
+        sortedEdges.emplace_back(src != canonicalIndex.end() ? src->second : SIZE_MAX,
+                                 dst != canonicalIndex.end() ? dst->second : SIZE_MAX,
+                                 edge->GetKindName(), edge->label);
+    }
+    std::sort(sortedEdges.begin(), sortedEdges.end());
+    for (const auto& [src, dst, kind, label] : sortedEdges) {
+        os << "  n" << src << " -> n" << dst << " " << kind;
+        if (!label.empty()) {
+            os << " \"" << label << "\"";
+        }
+        os << "\n";
+    }
 }
 
 void ComputeGraph::SetProperty(const std::string& key, const std::string& value)
@@ -1403,9 +1708,10 @@ void ComputeGraphSet::Deduplicate()
     std::set<std::string> seenSignatures;  // 基于结构去重
 
     for (const auto& g : graphs) {
-        // 首先基于锚点位置去重（函数名+行号）
-        std::string anchorKey = g->GetProperty("anchor_func") + ":" +
-                                g->GetProperty("anchor_line");
+        // 首先基于锚点位置去重（【修改】优先用稳定标识，否则函数名+行号）
+        std::string anchorKey = g->HasProperty("anchor_identity")
+            ? g->GetProperty("anchor_identity")
+            : g->GetProperty("anchor_func") + ":" + g->GetProperty("anchor_line");
 
         if (seenAnchors.find(anchorKey) != seenAnchors.end()) {
             // 已经有这个锚点的图了，跳过
@@ -1427,7 +1733,7 @@ void ComputeGraphSet::Deduplicate()
     graphs = std::move(unique);
 }
 
-void ComputeGraphSet::MergeOverlapping()
+void ComputeGraphSet::MergeOverlapping(const std::function<void(ComputeGraph&)>& reanalyze)
 {
     auto& graphsRef = graphs;
 
@@ -1440,6 +1746,9 @@ void ComputeGraphSet::MergeOverlapping()
                 if (ComputeGraphMerger::HasOverlap(*graphsRef[i], *graphsRef[j])) {
                     // 合并两个图
                     auto merged = ComputeGraphMerger::Merge(*graphsRef[i], *graphsRef[j]);
+                    if (reanalyze) {
+                        reanalyze(*merged);
+                    }
                     graphsRef[i] = merged;
                     graphsRef.erase(graphsRef.begin() + j);
                     changed = true;
@@ -1451,14 +1760,59 @@ void ComputeGraphSet::MergeOverlapping()
 
 void ComputeGraphSet::SortByScore()
 {
-    std::sort(graphs.begin(), graphs.end(),
-        [](const GraphPtr& a, const GraphPtr& b) {
-            int scoreA = std::stoi(a->GetProperty("score"));
-            int scoreB = std::stoi(b->GetProperty("score"));
-            return scoreA > scoreB;
+    auto parseNumber = [](const std::string& value) {
+        double result = 0.0;
+        if (!value.empty()) {
+            llvm::StringRef(value).getAsDouble(result);
+        }
+        return result;
+    };
+
+    // 【修复】不可向量化的图预估加速比记为 1.0（维持标量），排在所有可向量化的图之后
+    auto rank = [](const GraphPtr& g) {
+        return g->GetProperty("vectorizable") == "false" ? 0 : 1;
+    };
+
+    std::stable_sort(graphs.begin(), graphs.end(),
+        [&parseNumber, &rank](const GraphPtr& a, const GraphPtr& b) {
+            if (rank(a) != rank(b)) {
+                return rank(a) > rank(b);
+            }
+            double speedupA = parseNumber(a->GetProperty("cost_speedup"));
+            double speedupB = parseNumber(b->GetProperty("cost_speedup"));
+            if (speedupA != speedupB) {
+                return speedupA > speedupB;
+            }
+            return parseNumber(a->GetProperty("score")) > parseNumber(b->GetProperty("score"));
         });
 }
 
+void ComputeGraphSet::ApplyCostModel(const CostModel& model)
+{
+    for (auto& g : graphs) {
+        model.Annotate(*g);
+    }
+}
+
+size_t ComputeGraphSet::PruneUnprofitable(double minSpeedup)
+{
+    size_t before = graphs.size();
+    graphs.erase(std::remove_if(graphs.begin(), graphs.end(),
+        [minSpeedup](const GraphPtr& g) {
+            // 【修复】不可向量化的图没有向量化收益，无论加速比字段如何都剪除
+            if (g->GetProperty("vectorizable") == "false") {
+                return true;
+            }
+            std::string value = g->GetProperty("cost_speedup");
+            double speedup = 0.0;
+            if (value.empty() || llvm::StringRef(value).getAsDouble(speedup)) {
+                return false;   // 未标注的图保留
+            }
+            return speedup < minSpeedup;
+        }), graphs.end());
+    return before - graphs.size();
+}
+
 void ComputeGraphSet::Dump() const
 {
     llvm::outs() << "\n========== ComputeGraphSet ==========\n";
@@ -1534,6 +1888,7 @@ std::string OpCodeToString(OpCode op)
         case OpCode::Xor: return "^";
         case OpCode::Shl: return "<<";
         case OpCode::Shr: return ">>";
+        case OpCode::AndNot: return "andnot";
         case OpCode::Neg: return "neg";
         case OpCode::Not: return "!";
         case OpCode::BitNot: return "~";
@@ -1543,6 +1898,21 @@ std::string OpCodeToString(OpCode op)
         case OpCode::Ge: return ">=";
         case OpCode::Eq: return "==";
         case OpCode::Ne: return "!=";
+        case OpCode::Fma: return "fma";
+        case OpCode::Fms: return "fms";
+        case OpCode::Fnma: return "fnma";
+        case OpCode::Min: return "min";
+        case OpCode::Max: return "max";
+        case OpCode::Abs: return "abs";
+        case OpCode::Sqrt: return "sqrt";
+        case OpCode::Load: return "load";
+        case OpCode::Store: return "store";
+        case OpCode::Convert: return "cvt";
+        case OpCode::Broadcast: return "dup";
+        case OpCode::Shuffle: return "shuffle";
+        case OpCode::Select: return "select";
+        case OpCode::Reduce: return "reduce";
+        case OpCode::Dot: return "dot";
         case OpCode::Assign: return "=";
         default: return "?";
     }
@@ -1567,6 +1937,22 @@ OpCode StringToOpCode(const std::string& str)
     if (str == "==" || str == "Eq") return OpCode::Eq;
     if (str == "!=" || str == "Ne") return OpCode::Ne;
     if (str == "=" || str == "Assign") return OpCode::Assign;
+    if (str == "fma" || str == "Fma") return OpCode::Fma;
+    if (str == "fms" || str == "Fms") return OpCode::Fms;
+    if (str == "fnma" || str == "Fnma") return OpCode::Fnma;
+    if (str == "andnot" || str == "AndNot") return OpCode::AndNot;
+    if (str == "min" || str == "Min") return OpCode::Min;
+    if (str == "max" || str == "Max") return OpCode::Max;
+    if (str == "abs" || str == "Abs") return OpCode::Abs;
+    if (str == "sqrt" || str == "Sqrt") return OpCode::Sqrt;
+    if (str == "load" || str == "Load") return OpCode::Load;
+    if (str == "store" || str == "Store") return OpCode::Store;
+    if (str == "cvt" || str == "Convert") return OpCode::Convert;
+    if (str == "dup" || str == "Broadcast") return OpCode::Broadcast;
+    if (str == "shuffle" || str == "Shuffle") return OpCode::Shuffle;
+    if (str == "select" || str == "Select") return OpCode::Select;
+    if (str == "reduce" || str == "Reduce") return OpCode::Reduce;
+    if (str == "dot" || str == "Dot") return OpCode::Dot;
     return OpCode::Unknown;
 }
 
@@ -1,6 +1,8 @@
 
 #include "ComputeGraphAnchor.h"
 #include "CPGAnnotation.h"
+#include "clang/AST/ParentMapContext.h"
+#include <map>
 namespace compute_graph {
     // ============================================
     // AnchorFinder 实现
@@ -62,6 +64,7 @@ namespace compute_graph {
         visitor.TraverseStmt(func->getBody());
 
         for (auto& anchor : anchors) {
+            anchor.hotness = LookupHotness(anchor);
             anchor.score = ComputeAnchorScore(anchor);
         }
 
@@ -107,18 +110,18 @@ namespace compute_graph {
             seenLocations.insert(locKey);
         }
 
-        // 【修改】对去重后的锚点进行排序
-        std::sort(filtered.begin(), filtered.end(),
+        // 【修改】对去重后的锚点进行排序（评分已融合剖析热度，同分保持源码顺序）
+        std::stable_sort(filtered.begin(), filtered.end(),
             [this](const AnchorPoint& a, const AnchorPoint& b) {
                 return ComputeAnchorScore(a) > ComputeAnchorScore(b);
             });
 
-        // 【新增】限制锚点数量，避免过多重复分析
-        const size_t MAX_ANCHORS = 50;
-        if (filtered.size() > MAX_ANCHORS) {
+        // 【修改】限制锚点数量，避免过多重复分析（上限可配置）
+        if (maxAnchors > 0 && filtered.size() > maxAnchors) {
             llvm::outs() << "  [FilterAnchors] Limiting from " << filtered.size()
-                         << " to " << MAX_ANCHORS << " anchors\n";
-            filtered.resize(MAX_ANCHORS);
+                         << " to " << maxAnchors << " anchors"
+                         << (profile ? " (profile-guided)" : "") << "\n";
+            filtered.resize(maxAnchors);
         }
 
         return filtered;
@@ -158,9 +161,114 @@ namespace compute_graph {
             score += 50;
         }
 
+        // 【新增】融合剖析热度：冷代码保持静态评分，热点按比例加分
+        score += static_cast<int>(anchor.hotness * profileWeight);
+
         return score;
     }
 
+    std::vector<AnchorCluster> AnchorFinder::ClusterAnchors(
+        const std::vector<AnchorPoint>& rankedAnchors) const
+    {
+        std::vector<AnchorCluster> clusters;
+        // 作用域语句 -> clusters下标；按排序后的首个锚点决定簇的先后
+        std::map<const clang::Stmt*, size_t> scopeToCluster;
+        clang::SourceManager& sm = astContext.getSourceManager();
+
+        for (const auto& anchor : rankedAnchors) {
+            if (!anchor.stmt) continue;
+
+            const clang::Stmt* loop = FindInnermostLoop(anchor.stmt);
+            const clang::Stmt* scope = loop;
+            if (!scope && anchor.func) {
+                scope = anchor.func->getBody();
+            }
+
+            auto it = scopeToCluster.find(scope);
+            if (it == scopeToCluster.end()) {
+                AnchorCluster cluster;
+                cluster.func = anchor.func;
+                cluster.scopeStmt = scope;
+                cluster.isLoopScope = loop != nullptr;
+                cluster.scopeLine = scope ?
+                    static_cast<int>(sm.getSpellingLineNumber(scope->getBeginLoc())) : 0;
+                cluster.score = anchor.score;
+                it = scopeToCluster.emplace(scope, clusters.size()).first;
+                clusters.push_back(cluster);
+            }
+            clusters[it->second].anchors.push_back(anchor);
+        }
+
+        // 簇内按源码顺序构建，记录最高分锚点（排序输入中首个即最高分）
+        for (auto& cluster : clusters) {
+            const clang::Stmt* best = cluster.anchors.front().stmt;
+            std::stable_sort(cluster.anchors.begin(), cluster.anchors.end(),
+                [](const AnchorPoint& a, const AnchorPoint& b) {
+                    return a.sourceLine < b.sourceLine;
+                });
+            for (size_t i = 0; i < cluster.anchors.size(); ++i) {
+                if (cluster.anchors[i].stmt == best) {
+                    cluster.primaryIndex = i;
+                    break;
+                }
+            }
+        }
+
+        llvm::outs() << "  [ClusterAnchors] " << rankedAnchors.size() << " anchors -> "
+                     << clusters.size() << " clusters\n";
+        return clusters;
+    }
+
+    const clang::Stmt* AnchorFinder::FindInnermostLoop(const clang::Stmt* stmt) const
+    {
+        if (!stmt) return nullptr;
+
+        auto parents = astContext.getParents(*stmt);
+        while (!parents.empty()) {
+            const auto& parent = parents[0];
+
+            // 到达函数边界（含Lambda），停止查找
+            if (parent.get<clang::FunctionDecl>()) break;
+
+            if (const auto* pStmt = parent.get<clang::Stmt>()) {
+                if (llvm::isa<clang::ForStmt>(pStmt) ||
+                    llvm::isa<clang::WhileStmt>(pStmt) ||
+                    llvm::isa<clang::DoStmt>(pStmt) ||
+                    llvm::isa<clang::CXXForRangeStmt>(pStmt)) {
+                    return pStmt;
+                }
+                parents = astContext.getParents(*pStmt);
+            } else if (const auto* pDecl = parent.get<clang::Decl>()) {
+                // 如 float x = a[i] * b[i]; 中运算的父节点是VarDecl
+                parents = astContext.getParents(*pDecl);
+            } else {
+                break;
+            }
+        }
+        return nullptr;
+    }
+
+    double AnchorFinder::LookupHotness(const AnchorPoint& anchor) const
+    {
+        if (!profile || profile->IsEmpty() || !anchor.stmt || !anchor.func) {
+            return 0.0;
+        }
+
+        clang::SourceManager& sm = astContext.getSourceManager();
+        clang::SourceLocation loc = sm.getSpellingLoc(anchor.stmt->getBeginLoc());
+        if (loc.isInvalid()) {
+            return 0.0;
+        }
+
+        std::string fileName = sm.getFilename(loc).str();
+        int line = static_cast<int>(sm.getSpellingLineNumber(loc));
+        int funcLine = static_cast<int>(
+            sm.getSpellingLineNumber(anchor.func->getLocation()));
+
+        return profile->GetHotness(fileName, line,
+                                   anchor.func->getNameAsString(), funcLine);
+    }
+
 
 
 
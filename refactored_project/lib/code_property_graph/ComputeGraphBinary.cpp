@@ -0,0 +1,854 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * ComputeGraphBinary.cpp - ComputeGraphSet 的紧凑二进制交换格式
+ */
+
+#include "ComputeGraphBinary.h"
+
+#include "llvm/Support/Error.h"
+#include "llvm/Support/SwapByteOrder.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace compute_graph {
+
+using namespace cgbin;
+
+namespace {
+
+constexpr size_t kBinaryWriteBufferSize = 1 << 20;
+
+template <typename T>
+uint64_t BitsOf(T value)
+{
+    static_assert(sizeof(T) == sizeof(uint64_t), "8-byte payload expected");
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+template <typename T>
+T FromBits(uint64_t bits)
+{
+    T value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// 能精确还原该值的最短十进制表示
+std::string FormatDouble(double value)
+{
+    char text[32];
+    for (int precision = 1; precision <= 17; ++precision) {
+        std::snprintf(text, sizeof(text), "%.*g", precision, value);
+        if (std::strtod(text, nullptr) == value) break;
+    }
+    return text;
+}
+
+// ============================================
+// 【新增】枚举的冻结磁盘编码
+// 编码一经发布不再改动：枚举新增值时在表尾追加新编码，删除的值保留其编码不复用。
+// 现有编码与格式 1.0 写出时的枚举序数一致，旧文件无需转换
+// ============================================
+template <typename E, typename Code>
+struct CodeEntry {
+    E value;
+    Code code;
+};
+
+constexpr CodeEntry<ComputeNodeKind, uint16_t> kNodeKindCodes[] = {
+    {ComputeNodeKind::Constant, 0},      {ComputeNodeKind::Variable, 1},
+    {ComputeNodeKind::Parameter, 2},     {ComputeNodeKind::BinaryOp, 3},
+    {ComputeNodeKind::UnaryOp, 4},       {ComputeNodeKind::CompareOp, 5},
+    {ComputeNodeKind::Load, 6},          {ComputeNodeKind::Store, 7},
+    {ComputeNodeKind::ArrayAccess, 8},   {ComputeNodeKind::MemberAccess, 9},
+    {ComputeNodeKind::Phi, 10},          {ComputeNodeKind::Select, 11},
+    {ComputeNodeKind::LoopInduction, 12}, {ComputeNodeKind::Loop, 13},
+    {ComputeNodeKind::Branch, 14},       {ComputeNodeKind::Call, 15},
+    {ComputeNodeKind::IntrinsicCall, 16}, {ComputeNodeKind::Cast, 17},
+    {ComputeNodeKind::Return, 18},       {ComputeNodeKind::Unknown, 19},
+};
+
+constexpr CodeEntry<OpCode, uint16_t> kOpCodeCodes[] = {
+    {OpCode::Add, 0},        {OpCode::Sub, 1},      {OpCode::Mul, 2},      {OpCode::Div, 3},
+    {OpCode::Mod, 4},        {OpCode::And, 5},      {OpCode::Or, 6},       {OpCode::Xor, 7},
+    {OpCode::Shl, 8},        {OpCode::Shr, 9},      {OpCode::Neg, 10},     {OpCode::Not, 11},
+    {OpCode::BitNot, 12},    {OpCode::Lt, 13},      {OpCode::Gt, 14},      {OpCode::Le, 15},
+    {OpCode::Ge, 16},        {OpCode::Eq, 17},      {OpCode::Ne, 18},      {OpCode::Fma, 19},
+    {OpCode::Min, 20},       {OpCode::Max, 21},     {OpCode::Abs, 22},     {OpCode::Sqrt, 23},
+    {OpCode::Load, 24},      {OpCode::Store, 25},   {OpCode::Convert, 26}, {OpCode::Broadcast, 27},
+    {OpCode::Shuffle, 28},   {OpCode::Select, 29},  {OpCode::Reduce, 30},  {OpCode::Dot, 31},
+    {OpCode::Assign, 32},    {OpCode::Unknown, 33},  {OpCode::AndNot, 34},  {OpCode::Fms, 35},
+    {OpCode::Fnma, 36},
+};
+
+constexpr CodeEntry<DataTypeInfo::BaseType, uint8_t> kBaseTypeCodes[] = {
+    {DataTypeInfo::BaseType::Int8, 0},       {DataTypeInfo::BaseType::Int16, 1},
+    {DataTypeInfo::BaseType::Int32, 2},      {DataTypeInfo::BaseType::Int64, 3},
+    {DataTypeInfo::BaseType::UInt8, 4},      {DataTypeInfo::BaseType::UInt16, 5},
+    {DataTypeInfo::BaseType::UInt32, 6},     {DataTypeInfo::BaseType::UInt64, 7},
+    {DataTypeInfo::BaseType::Float, 8},      {DataTypeInfo::BaseType::Double, 9},
+    {DataTypeInfo::BaseType::Float16, 10},   {DataTypeInfo::BaseType::BFloat16, 11},
+    {DataTypeInfo::BaseType::Predicate, 12}, {DataTypeInfo::BaseType::Pointer, 13},
+    {DataTypeInfo::BaseType::Array, 14},     {DataTypeInfo::BaseType::Void, 15},
+    {DataTypeInfo::BaseType::TemplateParam, 16}, {DataTypeInfo::BaseType::Dependent, 17},
+    {DataTypeInfo::BaseType::Unknown, 18},
+};
+
+constexpr CodeEntry<ComputeEdgeKind, uint16_t> kEdgeKindCodes[] = {
+    {ComputeEdgeKind::DataFlow, 0}, {ComputeEdgeKind::Control, 1},
+    {ComputeEdgeKind::Memory, 2},   {ComputeEdgeKind::Call, 3},
+    {ComputeEdgeKind::Return, 4},   {ComputeEdgeKind::LoopCarried, 5},
+};
+
+// 每个枚举值都必须有编码；枚举新增值而忘记补表时在这里编译失败
+template <typename E, typename Code, size_t N>
+constexpr bool CoversEnum(const CodeEntry<E, Code> (&)[N], E last)
+{
+    return N == static_cast<size_t>(last) + 1;
+}
+static_assert(CoversEnum(kNodeKindCodes, ComputeNodeKind::Unknown), "ComputeNodeKind code table incomplete");
+static_assert(CoversEnum(kOpCodeCodes, OpCode::Unknown), "OpCode code table incomplete");
+static_assert(CoversEnum(kBaseTypeCodes, DataTypeInfo::BaseType::Unknown), "BaseType code table incomplete");
+static_assert(CoversEnum(kEdgeKindCodes, ComputeEdgeKind::LoopCarried), "ComputeEdgeKind code table incomplete");
+static_assert(static_cast<uint8_t>(AttrType::String) == 0 && static_cast<uint8_t>(AttrType::Int) == 1 &&
+              static_cast<uint8_t>(AttrType::Float) == 2 && static_cast<uint8_t>(AttrType::Bool) == 3,
+              "AttrType codes are frozen");
+
+template <typename E, typename Code, size_t N>
+Code EncodeWith(const CodeEntry<E, Code> (&table)[N], E value, E fallback)
+{
+    Code fallbackCode = 0;
+    for (const auto& entry : table) {
+        if (entry.value == value) return entry.code;
+        if (entry.value == fallback) fallbackCode = entry.code;
+    }
+    return fallbackCode;
+}
+
+template <typename E, typename Code, size_t N>
+bool DecodeWith(const CodeEntry<E, Code> (&table)[N], uint64_t code, E& value)
+{
+    for (const auto& entry : table) {
+        if (entry.code == code) {
+            value = entry.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool IsKnownAttrType(uint8_t code)
+{
+    switch (static_cast<AttrType>(code)) {
+        case AttrType::String:
+        case AttrType::Int:
+        case AttrType::Float:
+        case AttrType::Bool:
+            return true;
+    }
+    return false;
+}
+
+// ============================================
+// 字符串池：偏移0固定为空串
+// ============================================
+class StringPoolBuilder {
+public:
+    StringPoolBuilder() { Intern(""); }
+
+    uint32_t Intern(llvm::StringRef ref)
+    {
+        std::string str = ref.str();
+        auto it = offsets.find(str);
+        if (it != offsets.end()) return it->second;
+
+        uint32_t offset = static_cast<uint32_t>(bytes.size());
+        uint32_t length = static_cast<uint32_t>(str.size());
+        bytes.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        bytes.append(str.data(), str.size());
+        bytes.push_back('\0');
+        bytes.resize((bytes.size() + 3) & ~size_t(3), '\0');
+        offsets.emplace(std::move(str), offset);
+        return offset;
+    }
+
+    const std::string& Bytes() const { return bytes; }
+
+private:
+    std::unordered_map<std::string, uint32_t> offsets;
+    std::string bytes;
+};
+
+// ============================================
+// 表构建
+// ============================================
+class BinaryTableBuilder {
+public:
+    explicit BinaryTableBuilder(const clang::SourceManager* sm) : sourceManager(sm) {}
+
+    void AddGraph(const ComputeGraph& graph)
+    {
+        GraphRecord record = {};
+        record.name = pool.Intern(graph.GetName());
+        record.firstAttr = static_cast<uint32_t>(attrs.size());
+        for (const auto& [key, value] : graph.GetProperties()) {
+            attrs.push_back(MakeAttr(key, value));
+        }
+        record.attrCount = static_cast<uint32_t>(attrs.size()) - record.firstAttr;
+
+        record.firstNode = nodes.size();
+        for (const auto& [id, node] : graph.GetNodes()) {
+            nodes.push_back(MakeNode(*node));
+        }
+        record.nodeCount = nodes.size() - record.firstNode;
+
+        record.firstEdge = edges.size();
+        for (const auto& [id, edge] : graph.GetEdges()) {
+            edges.push_back(MakeEdge(*edge));
+        }
+        record.edgeCount = edges.size() - record.firstEdge;
+
+        graphs.push_back(record);
+    }
+
+    bool Write(const std::string& filename) const
+    {
+        FileHeader header = {};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.versionMajor = kVersionMajor;
+        header.versionMinor = kVersionMinor;
+
+        // 各段依次排列；记录大小都是8的倍数，段起点天然8字节对齐
+        uint64_t offset = sizeof(FileHeader);
+        auto place = [&offset](Section& section, uint64_t count, uint64_t recordSize) {
+            section.offset = offset;
+            section.count = count;
+            offset += count * recordSize;
+        };
+        place(header.graphs, graphs.size(), sizeof(GraphRecord));
+        place(header.nodes, nodes.size(), sizeof(NodeRecord));
+        place(header.edges, edges.size(), sizeof(EdgeRecord));
+        place(header.attrs, attrs.size(), sizeof(AttrRecord));
+        place(header.locations, locations.size(), sizeof(LocationRecord));
+        place(header.strings, pool.Bytes().size(), 1);
+        header.fileSize = offset;
+
+        std::error_code EC;
+        llvm::raw_fd_ostream out(filename, EC);
+        if (EC) {
+            llvm::errs() << "Cannot create file: " << filename << "\n";
+            return false;
+        }
+        out.SetBufferSize(kBinaryWriteBufferSize);
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        WriteTable(out, graphs);
+        WriteTable(out, nodes);
+        WriteTable(out, edges);
+        WriteTable(out, attrs);
+        WriteTable(out, locations);
+        out.write(pool.Bytes().data(), pool.Bytes().size());
+
+        out.close();
+        if (out.has_error()) {
+            llvm::errs() << "Failed to write binary graph file: " << filename << "\n";
+            out.clear_error();
+            return false;
+        }
+        return true;
+    }
+
+    size_t GraphCount() const { return graphs.size(); }
+
+private:
+    const clang::SourceManager* sourceManager;
+    StringPoolBuilder pool;
+    std::vector<GraphRecord> graphs;
+    std::vector<NodeRecord> nodes;
+    std::vector<EdgeRecord> edges;
+    std::vector<AttrRecord> attrs;
+    std::vector<LocationRecord> locations;
+    std::map<std::tuple<uint32_t, uint32_t, uint32_t>, uint32_t> locationIds;
+
+    template <typename T>
+    static void WriteTable(llvm::raw_fd_ostream& out, const std::vector<T>& table)
+    {
+        out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(T));
+    }
+
+    // 属性值按字面推断类型；只有能原样转回文本的值才存为数值
+    AttrRecord MakeAttr(const std::string& key, const std::string& value)
+    {
+        AttrRecord record = {};
+        record.key = pool.Intern(key);
+
+        llvm::StringRef text(value);
+        int64_t intValue = 0;
+        double floatValue = 0.0;
+        if (text == "true" || text == "false") {
+            record.type = static_cast<uint8_t>(AttrType::Bool);
+            record.value = text == "true" ? 1 : 0;
+        } else if (!text.empty() && !text.getAsInteger(10, intValue) &&
+                   std::to_string(intValue) == value) {
+            record.type = static_cast<uint8_t>(AttrType::Int);
+            record.value = static_cast<uint64_t>(intValue);
+        } else if (!text.empty() && text.find_first_of(".eE") != llvm::StringRef::npos &&
+                   !text.getAsDouble(floatValue) && FormatDouble(floatValue) == value) {
+            record.type = static_cast<uint8_t>(AttrType::Float);
+            record.value = BitsOf(floatValue);
+        } else {
+            record.type = static_cast<uint8_t>(AttrType::String);
+            record.value = pool.Intern(text);
+        }
+        return record;
+    }
+
+    uint32_t MakeLocation(const ComputeNode& node)
+    {
+        uint32_t file = 0;
+        uint32_t line = node.sourceLine > 0 ? static_cast<uint32_t>(node.sourceLine) : 0;
+        uint32_t column = 0;
+
+        clang::SourceLocation loc;
+        if (node.astStmt) {
+            loc = node.astStmt->getBeginLoc();
+        } else if (node.astDecl) {
+            loc = node.astDecl->getLocation();
+        }
+        if (sourceManager && loc.isValid()) {
+            clang::PresumedLoc presumed = sourceManager->getPresumedLoc(sourceManager->getFileLoc(loc));
+            if (presumed.isValid()) {
+                file = pool.Intern(presumed.getFilename());
+                line = presumed.getLine();
+                column = presumed.getColumn();
+            }
+        }
+        if (file == 0 && line == 0) return kNoIndex;
+
+        auto key = std::make_tuple(file, line, column);
+        auto it = locationIds.find(key);
+        if (it != locationIds.end()) return it->second;
+
+        LocationRecord record = {};
+        record.file = file;
+        record.line = line;
+        record.column = column;
+        uint32_t idx = static_cast<uint32_t>(locations.size());
+        locations.push_back(record);
+        locationIds.emplace(key, idx);
+        return idx;
+    }
+
+    NodeRecord MakeNode(const ComputeNode& node)
+    {
+        NodeRecord record = {};
+        record.id = node.id;
+        record.loopContextId = node.loopContextId;
+        record.branchContextId = node.branchContextId;
+        record.name = pool.Intern(node.name);
+        record.sourceText = pool.Intern(node.sourceText);
+        record.typeName = pool.Intern(node.dataType.typeName);
+        record.location = MakeLocation(node);
+        record.kind = EncodeNodeKind(node.kind);
+        record.opCode = EncodeOpCode(node.opCode);
+        record.vectorWidth = static_cast<uint16_t>(node.dataType.vectorWidth);
+        record.bitWidth = static_cast<uint16_t>(node.dataType.bitWidth);
+        record.loopDepth = static_cast<uint16_t>(node.loopDepth);
+        record.baseType = EncodeBaseType(node.dataType.baseType);
+
+        if (node.hasConstValue) {
+            record.flags |= kHasConstValue;
+            if (node.dataType.IsFloatingPoint()) {
+                record.constBits = BitsOf(node.constValue.floatValue);
+            } else {
+                record.flags |= kConstIsInt;
+                record.constBits = static_cast<uint64_t>(node.constValue.intValue);
+            }
+        }
+        if (node.isLoopInvariant) record.flags |= kLoopInvariant;
+        if (node.dataType.isSigned) record.flags |= kIsSigned;
+        if (node.dataType.isScalable) record.flags |= kIsScalable;
+        if (node.dataType.isStorageOnly) record.flags |= kStorageOnly;
+
+        record.firstAttr = static_cast<uint32_t>(attrs.size());
+        for (const auto& [key, value] : node.properties) {
+            attrs.push_back(MakeAttr(key, value));
+        }
+        record.attrCount = static_cast<uint32_t>(attrs.size()) - record.firstAttr;
+        return record;
+    }
+
+    EdgeRecord MakeEdge(const ComputeEdge& edge)
+    {
+        EdgeRecord record = {};
+        record.id = edge.id;
+        record.source = edge.sourceId;
+        record.target = edge.targetId;
+        record.label = pool.Intern(edge.label);
+        record.kind = EncodeEdgeKind(edge.kind);
+        record.weight = edge.weight;
+
+        record.firstAttr = static_cast<uint32_t>(attrs.size());
+        for (const auto& [key, value] : edge.properties) {
+            attrs.push_back(MakeAttr(key, value));
+        }
+        record.attrCount = static_cast<uint32_t>(attrs.size()) - record.firstAttr;
+        return record;
+    }
+};
+
+} // namespace
+
+// ============================================
+// 【新增】枚举编码（公开接口）
+// ============================================
+uint16_t cgbin::EncodeNodeKind(ComputeNodeKind kind)
+{
+    return EncodeWith(kNodeKindCodes, kind, ComputeNodeKind::Unknown);
+}
+
+uint16_t cgbin::EncodeOpCode(OpCode op)
+{
+    return EncodeWith(kOpCodeCodes, op, OpCode::Unknown);
+}
+
+uint8_t cgbin::EncodeBaseType(DataTypeInfo::BaseType type)
+{
+    return EncodeWith(kBaseTypeCodes, type, DataTypeInfo::BaseType::Unknown);
+}
+
+uint16_t cgbin::EncodeEdgeKind(ComputeEdgeKind kind)
+{
+    return EncodeWith(kEdgeKindCodes, kind, ComputeEdgeKind::DataFlow);
+}
+
+bool cgbin::DecodeNodeKind(uint16_t code, ComputeNodeKind& kind)
+{
+    return DecodeWith(kNodeKindCodes, code, kind);
+}
+
+bool cgbin::DecodeOpCode(uint16_t code, OpCode& op)
+{
+    return DecodeWith(kOpCodeCodes, code, op);
+}
+
+bool cgbin::DecodeBaseType(uint8_t code, DataTypeInfo::BaseType& type)
+{
+    return DecodeWith(kBaseTypeCodes, code, type);
+}
+
+bool cgbin::DecodeEdgeKind(uint16_t code, ComputeEdgeKind& kind)
+{
+    return DecodeWith(kEdgeKindCodes, code, kind);
+}
+
+// ============================================
+// 写出
+// ============================================
+
+bool WriteComputeGraphSetBinary(const ComputeGraphSet& graphSet, const std::string& filename,
+                                const clang::SourceManager* sourceManager)
+{
+    if (!llvm::sys::IsLittleEndianHost) {
+        llvm::errs() << "Binary graph format requires a little-endian host\n";
+        return false;
+    }
+
+    BinaryTableBuilder builder(sourceManager);
+    for (const auto& graph : graphSet.GetAllGraphs()) {
+        if (graph) {
+            builder.AddGraph(*graph);
+        }
+    }
+    if (!builder.Write(filename)) {
+        return false;
+    }
+
+    llvm::outs() << "Binary graphs exported to: " << filename << " (" << builder.GraphCount()
+                 << " graphs)\n";
+    return true;
+}
+
+// ============================================
+// 读取
+// ============================================
+
+bool ComputeGraphBinaryReader::Open(const std::string& filename)
+{
+    mapping.reset();
+    header = nullptr;
+
+    if (!llvm::sys::IsLittleEndianHost) {
+        llvm::errs() << "Binary graph format requires a little-endian host\n";
+        return false;
+    }
+
+    uint64_t fileSize = 0;
+    if (llvm::sys::fs::file_size(filename, fileSize) || fileSize < sizeof(FileHeader)) {
+        llvm::errs() << "Not a binary graph file: " << filename << "\n";
+        return false;
+    }
+
+    auto fd = llvm::sys::fs::openNativeFileForRead(filename);
+    if (!fd) {
+        llvm::errs() << "Cannot open file: " << filename << "\n";
+        llvm::consumeError(fd.takeError());
+        return false;
+    }
+    std::error_code EC;
+    auto region = std::make_unique<llvm::sys::fs::mapped_file_region>(
+        *fd, llvm::sys::fs::mapped_file_region::readonly, fileSize, 0, EC);
+    llvm::sys::fs::closeFile(*fd);
+    if (EC) {
+        llvm::errs() << "Cannot map file: " << filename << " (" << EC.message() << ")\n";
+        return false;
+    }
+
+    const char* base = region->const_data();
+    const auto* fileHeader = reinterpret_cast<const FileHeader*>(base);
+    if (std::memcmp(fileHeader->magic, kMagic, sizeof(kMagic)) != 0) {
+        llvm::errs() << "Not a binary graph file: " << filename << "\n";
+        return false;
+    }
+    if (fileHeader->versionMajor != kVersionMajor) {
+        llvm::errs() << "Unsupported binary graph version " << fileHeader->versionMajor << "."
+                     << fileHeader->versionMinor << " in " << filename << "\n";
+        return false;
+    }
+    if (fileHeader->fileSize > fileSize) {
+        llvm::errs() << "Truncated binary graph file: " << filename << "\n";
+        return false;
+    }
+
+    auto sectionFits = [&](const Section& section, uint64_t recordSize) {
+        return section.offset % 8 == 0 && section.offset <= fileSize &&
+               section.count <= (fileSize - section.offset) / recordSize;
+    };
+    if (!sectionFits(fileHeader->graphs, sizeof(GraphRecord)) ||
+        !sectionFits(fileHeader->nodes, sizeof(NodeRecord)) ||
+        !sectionFits(fileHeader->edges, sizeof(EdgeRecord)) ||
+        !sectionFits(fileHeader->attrs, sizeof(AttrRecord)) ||
+        !sectionFits(fileHeader->locations, sizeof(LocationRecord)) ||
+        !sectionFits(fileHeader->strings, 1)) {
+        llvm::errs() << "Corrupt section table in " << filename << "\n";
+        return false;
+    }
+
+    graphs = reinterpret_cast<const GraphRecord*>(base + fileHeader->graphs.offset);
+    nodes = reinterpret_cast<const NodeRecord*>(base + fileHeader->nodes.offset);
+    edges = reinterpret_cast<const EdgeRecord*>(base + fileHeader->edges.offset);
+    attrs = reinterpret_cast<const AttrRecord*>(base + fileHeader->attrs.offset);
+    locations = reinterpret_cast<const LocationRecord*>(base + fileHeader->locations.offset);
+    strings = base + fileHeader->strings.offset;
+
+    // 只校验记录之间的下标范围，字符串偏移在访问时检查
+    auto rangeFits = [](uint64_t first, uint64_t count, uint64_t total) {
+        return first <= total && count <= total - first;
+    };
+    uint64_t attrTotal = fileHeader->attrs.count;
+    for (uint64_t i = 0; i < fileHeader->graphs.count; ++i) {
+        const GraphRecord& g = graphs[i];
+        if (!rangeFits(g.firstNode, g.nodeCount, fileHeader->nodes.count) ||
+            !rangeFits(g.firstEdge, g.edgeCount, fileHeader->edges.count) ||
+            !rangeFits(g.firstAttr, g.attrCount, attrTotal)) {
+            llvm::errs() << "Corrupt graph record " << i << " in " << filename << "\n";
+            return false;
+        }
+    }
+    // 【修改】枚举字段按冻结编码解码，未知编码在加载时拒绝，视图解码时无需再检查
+    ComputeNodeKind nodeKind;
+    OpCode opCode;
+    DataTypeInfo::BaseType baseType;
+    ComputeEdgeKind edgeKind;
+    for (uint64_t i = 0; i < fileHeader->nodes.count; ++i) {
+        const NodeRecord& n = nodes[i];
+        if (!rangeFits(n.firstAttr, n.attrCount, attrTotal) ||
+            (n.location != kNoIndex && n.location >= fileHeader->locations.count) ||
+            !DecodeNodeKind(n.kind, nodeKind) ||
+            !DecodeOpCode(n.opCode, opCode) ||
+            !DecodeBaseType(n.baseType, baseType)) {
+            llvm::errs() << "Corrupt node record " << i << " in " << filename << "\n";
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < fileHeader->edges.count; ++i) {
+        if (!rangeFits(edges[i].firstAttr, edges[i].attrCount, attrTotal) ||
+            !DecodeEdgeKind(edges[i].kind, edgeKind)) {
+            llvm::errs() << "Corrupt edge record " << i << " in " << filename << "\n";
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < attrTotal; ++i) {
+        if (!IsKnownAttrType(attrs[i].type)) {
+            llvm::errs() << "Corrupt attribute record " << i << " in " << filename << "\n";
+            return false;
+        }
+    }
+
+    mapping = std::move(region);
+    header = fileHeader;
+    return true;
+}
+
+llvm::StringRef ComputeGraphBinaryReader::GetString(uint32_t offset) const
+{
+    uint64_t poolSize = header->strings.count;
+    if (static_cast<uint64_t>(offset) + sizeof(uint32_t) > poolSize) return llvm::StringRef();
+
+    uint32_t length = 0;
+    std::memcpy(&length, strings + offset, sizeof(length));
+    if (length > poolSize - offset - sizeof(uint32_t)) return llvm::StringRef();
+    return llvm::StringRef(strings + offset + sizeof(uint32_t), length);
+}
+
+BinaryAttrView ComputeGraphBinaryReader::MakeAttr(uint64_t idx) const
+{
+    return BinaryAttrView{&attrs[idx], this};
+}
+
+BinaryGraphView ComputeGraphBinaryReader::Graph(size_t idx) const
+{
+    return BinaryGraphView{&graphs[idx], this};
+}
+
+// ---------- 视图 ----------
+
+llvm::StringRef BinaryAttrView::Key() const
+{
+    return reader->GetString(record->key);
+}
+
+llvm::StringRef BinaryAttrView::AsString() const
+{
+    return Type() == AttrType::String ? reader->GetString(static_cast<uint32_t>(record->value))
+                                      : llvm::StringRef();
+}
+
+int64_t BinaryAttrView::AsInt() const
+{
+    switch (Type()) {
+        case AttrType::Int:
+        case AttrType::Bool:
+            return static_cast<int64_t>(record->value);
+        case AttrType::Float:
+            return static_cast<int64_t>(FromBits<double>(record->value));
+        default:
+            return 0;
+    }
+}
+
+double BinaryAttrView::AsFloat() const
+{
+    switch (Type()) {
+        case AttrType::Float:
+            return FromBits<double>(record->value);
+        case AttrType::Int:
+        case AttrType::Bool:
+            return static_cast<double>(static_cast<int64_t>(record->value));
+        default:
+            return 0.0;
+    }
+}
+
+bool BinaryAttrView::AsBool() const
+{
+    return Type() == AttrType::Bool ? record->value != 0 : AsInt() != 0;
+}
+
+std::string BinaryAttrView::ToString() const
+{
+    switch (Type()) {
+        case AttrType::Bool:
+            return record->value ? "true" : "false";
+        case AttrType::Int:
+            return std::to_string(static_cast<int64_t>(record->value));
+        case AttrType::Float:
+            return FormatDouble(FromBits<double>(record->value));
+        default:
+            return AsString().str();
+    }
+}
+
+// 加载时已校验编码，这里解码必然成功
+ComputeNodeKind BinaryNodeView::Kind() const
+{
+    ComputeNodeKind kind = ComputeNodeKind::Unknown;
+    DecodeNodeKind(record->kind, kind);
+    return kind;
+}
+
+OpCode BinaryNodeView::Op() const
+{
+    OpCode op = OpCode::Unknown;
+    DecodeOpCode(record->opCode, op);
+    return op;
+}
+
+DataTypeInfo::BaseType BinaryNodeView::BaseType() const
+{
+    DataTypeInfo::BaseType type = DataTypeInfo::BaseType::Unknown;
+    DecodeBaseType(record->baseType, type);
+    return type;
+}
+
+llvm::StringRef BinaryNodeView::Name() const
+{
+    return reader->GetString(record->name);
+}
+
+llvm::StringRef BinaryNodeView::SourceText() const
+{
+    return reader->GetString(record->sourceText);
+}
+
+const LocationRecord* BinaryNodeView::Location() const
+{
+    return record->location == kNoIndex ? nullptr : &reader->locations[record->location];
+}
+
+llvm::StringRef BinaryNodeView::LocationFile() const
+{
+    const LocationRecord* loc = Location();
+    return loc ? reader->GetString(loc->file) : llvm::StringRef();
+}
+
+BinaryAttrView BinaryNodeView::Attr(size_t idx) const
+{
+    return reader->MakeAttr(record->firstAttr + idx);
+}
+
+ComputeEdgeKind BinaryEdgeView::Kind() const
+{
+    ComputeEdgeKind kind = ComputeEdgeKind::DataFlow;
+    DecodeEdgeKind(record->kind, kind);
+    return kind;
+}
+
+llvm::StringRef BinaryEdgeView::Label() const
+{
+    return reader->GetString(record->label);
+}
+
+BinaryAttrView BinaryEdgeView::Attr(size_t idx) const
+{
+    return reader->MakeAttr(record->firstAttr + idx);
+}
+
+llvm::StringRef BinaryGraphView::Name() const
+{
+    return reader->GetString(record->name);
+}
+
+BinaryNodeView BinaryGraphView::Node(size_t idx) const
+{
+    return BinaryNodeView{&reader->nodes[record->firstNode + idx], reader};
+}
+
+BinaryEdgeView BinaryGraphView::Edge(size_t idx) const
+{
+    return BinaryEdgeView{&reader->edges[record->firstEdge + idx], reader};
+}
+
+BinaryAttrView BinaryGraphView::Attr(size_t idx) const
+{
+    return reader->MakeAttr(record->firstAttr + idx);
+}
+
+std::string BinaryGraphView::GetProperty(llvm::StringRef key) const
+{
+    for (size_t i = 0; i < AttrCount(); ++i) {
+        BinaryAttrView attr = Attr(i);
+        if (attr.Key() == key) {
+            return attr.ToString();
+        }
+    }
+    return std::string();
+}
+
+// ---------- 还原 ----------
+
+std::shared_ptr<ComputeGraph> ComputeGraphBinaryReader::Materialize(size_t idx) const
+{
+    if (!header || idx >= GraphCount()) return nullptr;
+
+    BinaryGraphView view = Graph(idx);
+    auto graph = std::make_shared<ComputeGraph>(view.Name().str());
+    for (size_t i = 0; i < view.AttrCount(); ++i) {
+        BinaryAttrView attr = view.Attr(i);
+        graph->SetProperty(attr.Key().str(), attr.ToString());
+    }
+
+    std::map<ComputeNode::NodeId, ComputeNode::NodeId> idMap;
+    for (size_t i = 0; i < view.NodeCount(); ++i) {
+        BinaryNodeView nodeView = view.Node(i);
+        const NodeRecord& record = *nodeView.record;
+        auto node = graph->CreateNode(nodeView.Kind());
+        idMap[record.id] = node->id;
+
+        node->name = nodeView.Name().str();
+        node->sourceText = nodeView.SourceText().str();
+        node->opCode = nodeView.Op();
+        node->loopDepth = record.loopDepth;
+        node->isLoopInvariant = (record.flags & kLoopInvariant) != 0;
+        node->dataType.baseType = nodeView.BaseType();
+        node->dataType.vectorWidth = record.vectorWidth;
+        node->dataType.bitWidth = record.bitWidth;
+        node->dataType.totalBitWidth = record.bitWidth * record.vectorWidth;
+        node->dataType.isSigned = (record.flags & kIsSigned) != 0;
+        node->dataType.isScalable = (record.flags & kIsScalable) != 0;
+        node->dataType.isStorageOnly = (record.flags & kStorageOnly) != 0;
+        node->dataType.typeName = GetString(record.typeName).str();
+        if (record.flags & kHasConstValue) {
+            node->hasConstValue = true;
+            if (record.flags & kConstIsInt) {
+                node->constValue.intValue = static_cast<int64_t>(record.constBits);
+            } else {
+                node->constValue.floatValue = FromBits<double>(record.constBits);
+            }
+        }
+        if (const LocationRecord* loc = nodeView.Location()) {
+            node->sourceLine = static_cast<int>(loc->line);
+        }
+        for (size_t a = 0; a < nodeView.AttrCount(); ++a) {
+            BinaryAttrView attr = nodeView.Attr(a);
+            node->SetProperty(attr.Key().str(), attr.ToString());
+        }
+    }
+
+    // 上下文ID在全部节点建好后再映射
+    for (size_t i = 0; i < view.NodeCount(); ++i) {
+        const NodeRecord& record = *view.Node(i).record;
+        auto node = graph->GetNode(idMap[record.id]);
+        auto loopIt = idMap.find(record.loopContextId);
+        auto branchIt = idMap.find(record.branchContextId);
+        node->loopContextId = loopIt != idMap.end() ? loopIt->second : 0;
+        node->branchContextId = branchIt != idMap.end() ? branchIt->second : 0;
+    }
+
+    for (size_t i = 0; i < view.EdgeCount(); ++i) {
+        BinaryEdgeView edgeView = view.Edge(i);
+        auto srcIt = idMap.find(edgeView.Source());
+        auto tgtIt = idMap.find(edgeView.Target());
+        if (srcIt == idMap.end() || tgtIt == idMap.end()) continue;
+
+        auto edge = graph->AddEdge(srcIt->second, tgtIt->second, edgeView.Kind(),
+                                   edgeView.Label().str());
+        edge->weight = edgeView.record->weight;
+        for (size_t a = 0; a < edgeView.AttrCount(); ++a) {
+            BinaryAttrView attr = edgeView.Attr(a);
+            edge->properties[attr.Key().str()] = attr.ToString();
+        }
+    }
+    return graph;
+}
+
+} // namespace compute_graph
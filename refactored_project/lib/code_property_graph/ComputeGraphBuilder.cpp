@@ -9,6 +9,11 @@
  */
 #include "ComputeGraph.h"
 #include "code_property_graph/CPGAnnotation.h"
+#include "LoopInductionAnalysis.h"
+#include "ArrayDependenceAnalysis.h"
+#include "IdiomRecognizer.h"
+#include "TemplateInstantiation.h"
+#include "AnalysisRegistry.h"
 
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/AST/ParentMapContext.h"
@@ -22,12 +27,16 @@
 #include <stack>
 #include <algorithm>
 #include <climits>
+#include <functional>
+#include <numeric>
 
 namespace compute_graph {
 
 ComputeGraphBuilder::ComputeGraphBuilder(cpg::CPGContext& cpgCtx,
                                          clang::ASTContext& astCtx)
-    : cpgContext(cpgCtx), astContext(astCtx)
+    : cpgContext(cpgCtx), astContext(astCtx),
+      regionIndex(astCtx.getSourceManager()),
+      feasibilityChecker(&astCtx)
 {}
 
 /*
@@ -248,6 +257,25 @@ std::string ComputeGraphBuilder::GetCFGEdgeLabel(cpg::ICFGEdgeKind kind)
 std::shared_ptr<ComputeGraph> ComputeGraphBuilder::BuildFromAnchor(
     const AnchorPoint& anchor)
 {
+    // 单锚点即只含一个锚点的簇
+    AnchorCluster cluster;
+    cluster.func = anchor.func;
+    cluster.isLoopScope = anchor.loopDepth > 0;
+    cluster.scopeLine = anchor.sourceLine;
+    cluster.score = anchor.score;
+    cluster.anchors.push_back(anchor);
+    return BuildFromAnchorCluster(cluster);
+}
+
+// 【新增】一个簇（同一最内层循环/函数）的所有锚点共用一次构建
+// 所有锚点共享processedStmts等状态，重叠部分只追踪一次，无需事后合并
+std::shared_ptr<ComputeGraph> ComputeGraphBuilder::BuildFromAnchorCluster(
+    const AnchorCluster& cluster)
+{
+    if (cluster.anchors.empty()) return nullptr;
+
+    const AnchorPoint& primary = cluster.Primary();
+
     // ================================================================
     // 初始化：清空所有状态
     // ================================================================
@@ -259,74 +287,102 @@ std::shared_ptr<ComputeGraph> ComputeGraphBuilder::BuildFromAnchor(
     currentLoopInfo = LoopInfo();  // 重置循环信息
 
     // ================================================================
-    // 创建计算图
+    // 创建计算图（以簇内最高分锚点命名，与单锚点构建保持一致）
     // ================================================================
-    std::string graphName = anchor.func ? anchor.func->getNameAsString() : "unknown";
-    graphName += "_L" + std::to_string(anchor.sourceLine);
+    // 【修改】模板实例按实例名命名（如 dot<float>_L12），与模式及其他实例区分
+    std::string funcName = primary.func ? GetInstanceName(primary.func, astContext) : "unknown";
+    std::string graphName = funcName + "_L" + std::to_string(primary.sourceLine);
     currentGraph = std::make_shared<ComputeGraph>(graphName);
+    regionIndex.Reset();
+    loopContextMembers.clear();
+    unionAliasIndex.clear();
+    unionMemberSlots.clear();
+    expandingCallSiteId = 0;
+    aliasTracedLoads.clear();
 
     // ================================================================
     // 设置图属性
     // ================================================================
-    currentGraph->SetProperty("anchor_func",
-        anchor.func ? anchor.func->getNameAsString() : "unknown");
-    currentGraph->SetProperty("anchor_line", std::to_string(anchor.sourceLine));
-    currentGraph->SetProperty("anchor_code", anchor.sourceText);
-    currentGraph->SetProperty("loop_depth", std::to_string(anchor.loopDepth));
+    currentGraph->SetProperty("anchor_func", funcName);
+    currentGraph->SetProperty("anchor_line", std::to_string(primary.sourceLine));
+    currentGraph->SetProperty("anchor_code", primary.sourceText);
+    // 【新增】与翻译单元无关的锚点标识（文件真实路径 + 函数USR + 偏移），跨TU去重使用
+    AnalysisIdentity identity = MakeAnalysisIdentity(primary.func, primary.stmt, astContext);
+    if (identity.IsValid()) {
+        currentGraph->SetProperty("anchor_identity", identity.Key());
+    }
+    currentGraph->SetProperty("loop_depth", std::to_string(primary.loopDepth));
+    if (primary.hotness > 0.0) {
+        currentGraph->SetProperty("profile_hotness", std::to_string(primary.hotness));
+    }
+    if (cluster.anchors.size() > 1) {
+        std::string lines;
+        for (const auto& anchor : cluster.anchors) {
+            if (!lines.empty()) lines += ",";
+            lines += std::to_string(anchor.sourceLine);
+        }
+        currentGraph->SetProperty("cluster_size", std::to_string(cluster.anchors.size()));
+        currentGraph->SetProperty("cluster_anchor_lines", lines);
+        currentGraph->SetProperty("cluster_scope",
+            (cluster.isLoopScope ? "loop@L" : "func@L") + std::to_string(cluster.scopeLine));
+    }
 
     // 【原有】检查是否是模板函数
-    if (anchor.func) {
-        bool isTemplate = anchor.func->getDescribedFunctionTemplate() != nullptr ||
-                          anchor.func->isFunctionTemplateSpecialization();
+    if (primary.func) {
+        bool isTemplate = primary.func->getDescribedFunctionTemplate() != nullptr ||
+                          primary.func->isFunctionTemplateSpecialization();
         currentGraph->SetProperty("is_template", isTemplate ? "true" : "false");
         if (isTemplate) {
             currentGraph->SetProperty("template_marker", "[TEMPLATE]");
         }
+        if (const clang::FunctionTemplateDecl* tmpl = primary.func->getPrimaryTemplate()) {
+            // 实例的源码文本是模式的文本，向量代码生成与微基准据此跳过
+            currentGraph->SetProperty("template_pattern", tmpl->getNameAsString());
+            currentGraph->SetProperty("template_args",
+                funcName.substr(primary.func->getNameAsString().size()));
+        }
     }
 
-    // ================================================================
-    // 【新增】预处理：按顺序构建同一作用域中锚点之前的所有语句
-    // 这是解决同行多语句（如 len++; if(ref[len]...) ）问题的关键
-    // ================================================================
     llvm::outs() << "\n========================================\n";
-    llvm::outs() << "[BuildFromAnchor] Processing anchor at line " << anchor.sourceLine
-                 << " in function " << (anchor.func ? anchor.func->getNameAsString() : "unknown") << "\n";
-    llvm::outs() << "[BuildFromAnchor] Anchor code: " << anchor.sourceText << "\n";
-
-    // 调用预处理函数：确保前置语句已构建
-    EnsurePrecedingStatementsBuilt(anchor.stmt);
-    // ================================================================
+    llvm::outs() << "[BuildFromAnchor] Processing " << cluster.anchors.size()
+                 << " anchor(s) at line " << primary.sourceLine
+                 << " in function " << funcName << "\n";
+    llvm::outs() << "[BuildFromAnchor] Anchor code: " << primary.sourceText << "\n";
 
     // ================================================================
-    // 0. 检测包含锚点的循环，创建Loop节点并记录循环变量
+    // 0-1. 按源码顺序构建每个锚点的表达式树
+    // 【关键】先确保同一作用域中锚点之前的语句已构建
+    //        （解决同行多语句如 len++; if(ref[len]...) 的顺序问题）
+    // 簇内锚点共享最内层循环，Loop节点只创建一次
     // ================================================================
-    if (anchor.loopDepth > 0) {
-        currentLoopInfo = BuildContainingLoopNode(anchor.stmt);
-    }
+    std::vector<ComputeNode::NodeId> anchorNodeIds;
+    for (const auto& anchor : cluster.anchors) {
+        EnsurePrecedingStatementsBuilt(anchor.stmt);
 
-    // ================================================================
-    // 1. 递归构建锚点表达式树（包括深入函数调用）
-    // ================================================================
-    auto anchorNodeId = BuildExpressionTree(anchor.stmt, 0);
-    auto anchorNode = currentGraph->GetNode(anchorNodeId);
-    if (anchorNode) {
-        anchorNode->SetProperty("is_anchor", "true");
-        anchorNode->loopDepth = anchor.loopDepth;
-        anchorNode->containingFunc = anchor.func;
-    }
-
-    // 记录锚点ID到循环信息
-    currentLoopInfo.anchorNodeId = anchorNodeId;
+        if (anchor.loopDepth > 0 && currentLoopInfo.loopNodeId == 0) {
+            currentLoopInfo = BuildContainingLoopNode(anchor.stmt);
+        }
 
-    // ================================================================
-    // 2. 跨函数向后追踪变量定义（循环变量会特殊处理）
-    // ================================================================
-    TraceAllDefinitionsBackward(anchor.stmt, 0);
+        auto anchorNodeId = BuildExpressionTree(anchor.stmt, 0);
+        auto anchorNode = currentGraph->GetNode(anchorNodeId);
+        if (anchorNode) {
+            anchorNode->SetProperty("is_anchor", "true");
+            anchorNode->loopDepth = anchor.loopDepth;
+            anchorNode->containingFunc = anchor.func;
+        }
+        anchorNodeIds.push_back(anchorNodeId);
+    }
 
     // ================================================================
-    // 3. 向前追踪使用点
+    // 2-3. 跨函数向后追踪定义、向前追踪使用点
+    // （已构建的语句在processedStmts中命中，不会重复追踪）
     // ================================================================
-    TraceAllUsesForward(anchor.stmt, 0);
+    for (const auto& anchor : cluster.anchors) {
+        TraceAllDefinitionsBackward(anchor.stmt, 0);
+    }
+    for (const auto& anchor : cluster.anchors) {
+        TraceAllUsesForward(anchor.stmt, 0);
+    }
 
     // ================================================================
     // 4. 对图中所有参数节点追踪到调用点
@@ -334,11 +390,14 @@ std::shared_ptr<ComputeGraph> ComputeGraphBuilder::BuildFromAnchor(
     TraceAllParametersToCallSites();
 
     // ================================================================
-    // 5. 【改进】连接循环结构
+    // 5. 【改进】连接循环结构（每个锚点都连接到Loop节点）
     // ================================================================
     if (currentLoopInfo.loopNodeId != 0) {
-        // 连接Loop节点到循环体
-        ConnectLoopToBody(currentLoopInfo);
+        for (auto anchorNodeId : anchorNodeIds) {
+            currentLoopInfo.anchorNodeId = anchorNodeId;
+            ConnectLoopToBody(currentLoopInfo);
+        }
+        currentLoopInfo.anchorNodeId = anchorNodeIds[cluster.primaryIndex];
         // 将循环体内的循环变量连接到Loop节点
         ConnectLoopVariablesToLoopNode(currentLoopInfo);
         // 【新增】连接外部循环变量初始化到Loop，并清理错误的边
@@ -346,15 +405,28 @@ std::shared_ptr<ComputeGraph> ComputeGraphBuilder::BuildFromAnchor(
     }
 
     // ================================================================
-    // 【新增】6. 添加CFG边，显示代码执行顺序
+    // 6. 添加CFG边，显示代码执行顺序
     // ================================================================
     AddCFGEdges();
+
     // ================================================================
+    // 7. 【新增】归纳变量、迭代次数与数组访问步长；数组依赖测试
+    // ================================================================
+    LoopInductionAnalysis inductionAnalysis(astContext);
+    AnnotateLoopInduction(inductionAnalysis);
+    AnnotateValueRanges(inductionAnalysis);
+    AnnotateAlignment(inductionAnalysis);
+    ArrayDependenceAnalyzer(astContext, inductionAnalysis, &cpgContext).Run(*currentGraph);
 
     // ================================================================
-    // 设置图的得分
+    // 8. 【新增】归约/扫描/直方图/逐元素映射惯用法识别
     // ================================================================
-    currentGraph->SetProperty("score", std::to_string(anchor.score));
+    IdiomRecognizer(astContext, inductionAnalysis).Annotate(*currentGraph);
+
+    // ================================================================
+    // 设置图的得分（簇内最高分）
+    // ================================================================
+    currentGraph->SetProperty("score", std::to_string(cluster.score));
 
     return currentGraph;
 }
@@ -385,49 +457,49 @@ void ComputeGraphBuilder::ConnectLoopVariablesToLoopNode(const LoopInfo& loopInf
 
     int markedCount = 0;
 
-    // 遍历所有节点，设置循环上下文
-    for (auto& [id, node] : currentGraph->GetNodes()) {
-        if (id == loopInfo.loopNodeId) continue;
+    // 【修改】循环语句源码区间内的节点由区间索引给出；
+    // 展开函数中的节点不在该区间内，但创建时已继承 loopContextId
+    std::vector<ComputeNode::NodeId> members = CollectNodesInRegion(
+        loopInfo.loopStmt, loopInfo.bodyStartLine, loopInfo.bodyEndLine);
+    // 【修改】后者由 loopContextMembers 索引给出，不再逐循环扫描全图
+    std::set<ComputeNode::NodeId> memberSet(members.begin(), members.end());
+    auto inheritedIt = loopContextMembers.find(loopInfo.loopNodeId);
+    if (inheritedIt != loopContextMembers.end()) {
+        for (ComputeNode::NodeId id : inheritedIt->second) {
+            auto node = currentGraph->GetNode(id);
+            if (node && node->loopContextId == loopInfo.loopNodeId && memberSet.insert(id).second) {
+                members.push_back(id);
+            }
+        }
+    }
 
-        // 检查节点是否在循环体内
-        bool inLoopBody = false;
-
-        if (loopInfo.bodyStartLine > 0 && loopInfo.bodyEndLine > 0 &&
-            node->sourceLine >= loopInfo.bodyStartLine &&
-            node->sourceLine <= loopInfo.bodyEndLine) {
-            inLoopBody = true;
-        }
-        // 已经有loopContextId的节点（展开函数中的节点）
-        else if (node->loopContextId == loopInfo.loopNodeId) {
-            inLoopBody = true;
-        }
-
-        if (inLoopBody) {
-            // 【关键】设置循环上下文信息
-            node->loopContextId = loopInfo.loopNodeId;
-            node->loopContextVar = loopInfo.loopVarName;
-            node->loopContextLine = loopLine;
-            markedCount++;
-
-            // 如果是循环变量节点，连接到Loop节点
-            if (!loopInfo.loopVarName.empty() &&
-                (node->kind == ComputeNodeKind::Variable ||
-                 node->kind == ComputeNodeKind::Parameter) &&
-                node->name == loopInfo.loopVarName) {
-
-                // 检查是否已经有从Loop来的边
-                bool hasLoopEdge = false;
-                for (const auto& edge : currentGraph->GetIncomingEdges(id)) {
-                    if (edge->sourceId == loopInfo.loopNodeId) {
-                        hasLoopEdge = true;
-                        break;
-                    }
+    for (ComputeNode::NodeId id : members) {
+        if (id == loopInfo.loopNodeId) continue;
+        auto node = currentGraph->GetNode(id);
+        if (!node) continue;
+
+        // 【关键】设置循环上下文信息
+        AssignLoopContext(node, loopInfo.loopNodeId, loopInfo.loopVarName, loopLine);
+        markedCount++;
+
+        // 如果是循环变量节点，连接到Loop节点
+        if (!loopInfo.loopVarName.empty() &&
+            (node->kind == ComputeNodeKind::Variable ||
+             node->kind == ComputeNodeKind::Parameter) &&
+            node->name == loopInfo.loopVarName) {
+
+            // 检查是否已经有从Loop来的边
+            bool hasLoopEdge = false;
+            for (const auto& edge : currentGraph->GetIncomingEdges(id)) {
+                if (edge->sourceId == loopInfo.loopNodeId) {
+                    hasLoopEdge = true;
+                    break;
                 }
+            }
 
-                if (!hasLoopEdge) {
-                    ConnectNodes(loopInfo.loopNodeId, id,
-                                 ComputeEdgeKind::DataFlow, loopInfo.loopVarName);
-                }
+            if (!hasLoopEdge) {
+                ConnectNodes(loopInfo.loopNodeId, id,
+                             ComputeEdgeKind::DataFlow, loopInfo.loopVarName);
             }
         }
     }
@@ -446,23 +518,50 @@ void ComputeGraphBuilder::ConnectLoopVarInitToLoop(const LoopInfo& loopInfo)
     int loopLine = loopNode->sourceLine;
 
     // 1. 找到循环变量的外部初始化节点
-    // 外部初始化是：行号小于循环行号、名称匹配循环变量、是Variable类型
-    // 选择行号最大（最接近循环）的那个
+    // 外部初始化是：位于所在函数体起点与循环起点之间、名称匹配循环变量、是Variable类型
+    // 选择位置最靠后（最接近循环）的那个
     ComputeNode::NodeId initNodeId = 0;
     int initLine = 0;
 
-    for (const auto& [id, node] : currentGraph->GetNodes()) {
-        // 跳过 Loop 节点本身
-        if (id == loopInfo.loopNodeId) continue;
-
-        if (node->name == loopInfo.loopVarName &&
-            node->kind == ComputeNodeKind::Variable &&
-            node->sourceLine > 0 &&
-            node->sourceLine < loopLine) {
-            // 选择行号最大的（最接近循环的定义）
-            if (node->sourceLine > initLine) {
+    // 【修改】用区间索引按源码偏移查找，代替遍历全部节点比较行号
+    const clang::FunctionDecl* func = loopNode->containingFunc;
+    if (!func && loopInfo.loopStmt) {
+        func = GetContainingFunction(loopInfo.loopStmt);
+    }
+    SourceRegionIndex::Region region;
+    if (func && func->getBody() && loopInfo.loopStmt) {
+        region = regionIndex.GetRegion(func->getBody()->getBeginLoc(),
+                                       loopInfo.loopStmt->getBeginLoc());
+    }
+
+    if (region.IsValid()) {
+        // 按偏移升序返回：从后向前取第一个匹配的节点
+        std::vector<ComputeNode::NodeId> candidates = regionIndex.Query(*currentGraph, region);
+        for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+            if (*it == loopInfo.loopNodeId) continue;
+            auto node = currentGraph->GetNode(*it);
+            if (node->name == loopInfo.loopVarName &&
+                node->kind == ComputeNodeKind::Variable &&
+                node->astStmt != loopInfo.loopStmt) {
                 initLine = node->sourceLine;
-                initNodeId = id;
+                initNodeId = *it;
+                break;
+            }
+        }
+    } else {
+        for (const auto& [id, node] : currentGraph->GetNodes()) {
+            // 跳过 Loop 节点本身
+            if (id == loopInfo.loopNodeId) continue;
+
+            if (node->name == loopInfo.loopVarName &&
+                node->kind == ComputeNodeKind::Variable &&
+                node->sourceLine > 0 &&
+                node->sourceLine < loopLine) {
+                // 选择行号最大的（最接近循环的定义）
+                if (node->sourceLine > initLine) {
+                    initLine = node->sourceLine;
+                    initNodeId = id;
+                }
             }
         }
     }
@@ -759,6 +858,275 @@ std::string ComputeGraphBuilder::ExtractLoopVarFromCondition(const clang::Expr*
 
     return "";
 }
+
+// ============================================
+// 【新增】循环归纳分析
+// ============================================
+void ComputeGraphBuilder::AnnotateLoopInduction(LoopInductionAnalysis& analysis)
+{
+    // (loopStmt, 变量名) -> LoopInduction节点
+    std::map<std::pair<const clang::Stmt*, std::string>, ComputeNode::NodeId> ivNodes;
+
+    // 1. Loop节点：归纳变量与迭代次数
+    for (const auto& loopNode : currentGraph->GetAllNodes()) {
+        if (loopNode->kind != ComputeNodeKind::Loop || !loopNode->astStmt) continue;
+
+        const LoopInductionInfo& info = analysis.Analyze(loopNode->astStmt);
+        if (!info.tripCountExpr.empty()) {
+            loopNode->SetProperty("trip_count", info.tripCountExpr);
+        }
+        if (info.inductionVars.empty()) continue;
+
+        for (const auto& iv : info.inductionVars) {
+            auto ivNode = currentGraph->CreateNode(ComputeNodeKind::LoopInduction);
+            ivNode->name = iv.name;
+            ivNode->astDecl = iv.var;
+            ivNode->containingFunc = loopNode->containingFunc;
+            ivNode->dataType = DataTypeInfo::FromClangType(iv.var->getType());
+            ivNode->sourceLine = loopNode->sourceLine;
+            ivNode->loopDepth = loopNode->loopDepth + 1;
+            AssignLoopContext(ivNode, loopNode->id, iv.name, loopNode->sourceLine);
+
+            ivNode->SetProperty("iv_start", iv.startExpr);
+            ivNode->SetProperty("iv_step", std::to_string(iv.step));
+            if (iv.isPrimary) {
+                ivNode->SetProperty("is_primary_iv", "true");
+                if (!iv.boundExpr.empty()) {
+                    ivNode->SetProperty("iv_bound", iv.boundExpr);
+                    ivNode->SetProperty("iv_compare", iv.compareOp);
+                }
+            }
+
+            ConnectNodes(loopNode->id, ivNode->id, ComputeEdgeKind::Control, "induction");
+            ivNodes[{loopNode->astStmt, iv.name}] = ivNode->id;
+        }
+
+        const InductionVariable* primary = info.GetPrimary();
+        loopNode->SetProperty("induction_var", primary ? primary->name : info.inductionVars[0].name);
+    }
+
+    // 2. ArrayAccess节点：仿射下标与访问步长
+    int annotated = 0;
+    for (const auto& node : currentGraph->GetAllNodes()) {
+        if (node->kind != ComputeNodeKind::ArrayAccess) continue;
+
+        const auto* access = llvm::dyn_cast_or_null<clang::ArraySubscriptExpr>(node->astStmt);
+        // 多维数组的部分下标（结果仍是数组行）只参与外层访问的展开
+        if (!access || access->getType()->isArrayType()) continue;
+
+        const clang::Stmt* loopStmt = analysis.FindEnclosingLoop(access);
+        if (!loopStmt) continue;
+
+        AffineIndex index = analysis.AnalyzeIndex(access, analysis.Analyze(loopStmt));
+        node->SetProperty("affine_index", index.ToString());
+        node->SetProperty("access_stride", index.StrideString());
+        annotated++;
+        if (!index.isAffine) continue;
+
+        if (!index.ivName.empty()) {
+            node->SetProperty("index_iv", index.ivName);
+            node->SetProperty("index_stride", index.hasConstStride ?
+                std::to_string(index.stride) : index.symbolicStride);
+        }
+        node->SetProperty("index_offset", std::to_string(index.offset));
+        if (!index.base.empty()) {
+            node->SetProperty("index_base", index.base);
+        }
+
+        auto ivIt = ivNodes.find({loopStmt, index.ivName});
+        if (ivIt != ivNodes.end() && (index.stride != 0 || !index.hasConstStride)) {
+            ConnectNodes(ivIt->second, node->id, ComputeEdgeKind::DataFlow,
+                         "stride " + index.StrideString());
+        }
+    }
+
+    if (!ivNodes.empty() || annotated > 0) {
+        llvm::outs() << "  [LoopInduction] " << ivNodes.size() << " induction vars, "
+                     << annotated << " array accesses annotated\n";
+    }
+}
+
+// ============================================
+// 【新增】值域分析：表达式取值、下标范围与迭代次数
+// ============================================
+void ComputeGraphBuilder::PromoteTripCount(ComputeGraph& graph, const ComputeNode& loopNode)
+{
+    for (const char* key : {"trip_count_min", "trip_count_max", "trip_count_multiple"}) {
+        if (loopNode.HasProperty(key)) {
+            graph.SetProperty(key, loopNode.GetProperty(key));
+        }
+    }
+}
+
+void ComputeGraphBuilder::AnnotateValueRanges(LoopInductionAnalysis& analysis)
+{
+    cpg::ValueRangeAnalysis& ranges = cpgContext.GetValueRanges();
+
+    // 循环条件中与主归纳变量比较的另一侧
+    auto findBound = [](const clang::Stmt* loopStmt, const clang::VarDecl* var) -> const clang::Expr* {
+        const clang::Expr* cond = nullptr;
+        if (const auto* forStmt = llvm::dyn_cast<clang::ForStmt>(loopStmt)) {
+            cond = forStmt->getCond();
+        } else if (const auto* whileStmt = llvm::dyn_cast<clang::WhileStmt>(loopStmt)) {
+            cond = whileStmt->getCond();
+        }
+        const auto* binOp = cond ? llvm::dyn_cast<clang::BinaryOperator>(cond->IgnoreParenImpCasts()) : nullptr;
+        if (!binOp || !binOp->isComparisonOp()) return nullptr;
+        auto refersTo = [var](const clang::Expr* side) {
+            const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(side->IgnoreParenImpCasts());
+            return ref && ref->getDecl() == var;
+        };
+        if (refersTo(binOp->getLHS())) return binOp->getRHS();
+        if (refersTo(binOp->getRHS())) return binOp->getLHS();
+        return nullptr;
+    };
+
+    int rangedNodes = 0;
+    int boundedLoops = 0;
+    const ComputeNode* innermost = nullptr;   // 迭代次数有界的最内层循环，结果提升为图属性
+
+    for (const auto& node : currentGraph->GetAllNodes()) {
+        if (!node->astStmt) continue;
+
+        // 1. Loop节点：归纳变量取值与迭代次数范围
+        if (node->kind == ComputeNodeKind::Loop) {
+            const LoopInductionInfo& info = analysis.Analyze(node->astStmt);
+            const InductionVariable* primary = info.GetPrimary();
+            if (!primary || !primary->var || primary->compareOp.empty()) continue;
+
+            cpg::ValueRange head = ranges.GetLoopHeadRange(node->astStmt, primary->var);
+            if (!head.empty && head != cpg::ValueRange::OfType(primary->var->getType(), astContext)) {
+                node->SetProperty("iv_range", head.ToString());
+            }
+
+            const clang::Expr* bound = findBound(node->astStmt, primary->var);
+            cpg::ValueRange boundRange = bound && analysis.IsLoopInvariant(bound, info) ?
+                ranges.GetRange(bound) : cpg::ValueRange::Top();
+            cpg::ValueRange trips = cpg::LoopTripCount(
+                ranges.GetLoopEntryRange(node->astStmt, primary->var), boundRange,
+                primary->step, primary->compareOp);
+            if (info.hasTripCount) {
+                cpg::ValueRange exact = trips.Meet(cpg::ValueRange::Constant(info.tripCount));
+                if (!exact.empty) trips = exact;
+            }
+            if (trips.empty || (trips.lo <= 0 && !trips.HasUpper() && trips.KnownMultiple() <= 1)) continue;
+
+            node->SetProperty("trip_count_range", trips.ToString());
+            node->SetProperty("trip_count_min", std::to_string(trips.lo));
+            if (trips.HasUpper()) {
+                node->SetProperty("trip_count_max", std::to_string(trips.hi));
+            }
+            if (trips.KnownMultiple() != 1) {
+                node->SetProperty("trip_count_multiple", std::to_string(trips.KnownMultiple()));
+            }
+            if (!innermost || node->loopDepth > innermost->loopDepth) {
+                innermost = node.get();
+            }
+            boundedLoops++;
+            continue;
+        }
+
+        // 2. ArrayAccess节点：下标取值范围
+        if (node->kind == ComputeNodeKind::ArrayAccess) {
+            const auto* access = llvm::dyn_cast<clang::ArraySubscriptExpr>(node->astStmt);
+            if (!access) continue;
+            cpg::ValueRange index = ranges.GetRange(access->getIdx());
+            if (!index.empty && !index.IsTop() &&
+                index != cpg::ValueRange::OfType(access->getIdx()->getType(), astContext)) {
+                node->SetProperty("index_range", index.ToString());
+                rangedNodes++;
+            }
+            continue;
+        }
+
+        // 3. 其他整型表达式节点：取值范围（与类型范围相同则不标注）
+        const auto* expr = llvm::dyn_cast<clang::Expr>(node->astStmt);
+        if (!expr || !expr->getType()->isIntegralOrEnumerationType()) continue;
+        cpg::ValueRange value = ranges.GetRange(expr);
+        if (!value.empty && !value.IsTop() && value != cpg::ValueRange::OfType(expr->getType(), astContext)) {
+            node->SetProperty("value_range", value.ToString());
+            rangedNodes++;
+        }
+    }
+
+    if (innermost) {
+        PromoteTripCount(*currentGraph, *innermost);
+    }
+
+    if (rangedNodes > 0 || boundedLoops > 0) {
+        llvm::outs() << "  [ValueRange] " << rangedNodes << " nodes with ranges, "
+                     << boundedLoops << " loops with trip count bounds\n";
+    }
+}
+
+// ============================================
+// 【新增】对齐与连续性：访问地址对齐、循环入口对齐与步长
+// ============================================
+void ComputeGraphBuilder::AnnotateAlignment(LoopInductionAnalysis& analysis)
+{
+    cpg::AlignmentAnalysis& alignment = cpgContext.GetAlignment();
+
+    int annotated = 0;
+    int entryAligned = 0;
+    for (const auto& node : currentGraph->GetAllNodes()) {
+        // 构建器不单独生成 Load/Store 节点时，解引用以 UnaryOp 节点出现
+        bool isDeref = false;
+        if (node->kind == ComputeNodeKind::UnaryOp) {
+            const auto* unaryOp = llvm::dyn_cast_or_null<clang::UnaryOperator>(node->astStmt);
+            isDeref = unaryOp && unaryOp->getOpcode() == clang::UO_Deref;
+        }
+        if (!isDeref && node->kind != ComputeNodeKind::ArrayAccess && node->kind != ComputeNodeKind::Load &&
+            node->kind != ComputeNodeKind::Store && node->kind != ComputeNodeKind::MemberAccess) {
+            continue;
+        }
+
+        const auto* access = llvm::dyn_cast_or_null<clang::Expr>(node->astStmt);
+        if (!access || access->getType()->isArrayType() || access->isTypeDependent()) continue;
+        if (!llvm::isa<clang::ArraySubscriptExpr>(access) && !llvm::isa<clang::UnaryOperator>(access) &&
+            !llvm::isa<clang::MemberExpr>(access)) {
+            continue;
+        }
+
+        // 1. 所有执行中的地址对齐
+        cpg::Alignment all = alignment.GetAccessAlignment(access);
+        if (all.empty) continue;
+        node->SetProperty("align", std::to_string(all.KnownAlignment()));
+        if (all.offset != 0) {
+            node->SetProperty("align_mod", all.ToString());
+        }
+        if (const auto* subscript = llvm::dyn_cast<clang::ArraySubscriptExpr>(access)) {
+            cpg::Alignment base = alignment.GetPointerAlignment(subscript->getBase());
+            if (!base.empty) {
+                node->SetProperty("align_base", std::to_string(base.KnownAlignment()));
+            }
+        }
+        annotated++;
+
+        // 2. 连续性：每次迭代的访问步长（元素个数）为 1
+        if (node->HasProperty("access_stride")) {
+            std::string stride = node->GetProperty("access_stride");
+            node->SetProperty("contiguous", stride == "1" ? "true" : (stride == "unknown" ? "unknown" : "false"));
+        }
+
+        // 3. 最内层循环首次迭代时的对齐：决定向量循环能否省去运行时对齐检查/剥离
+        const clang::Stmt* loopStmt = analysis.FindEnclosingLoop(access);
+        if (!loopStmt) continue;
+        const InductionVariable* primary = analysis.Analyze(loopStmt).GetPrimary();
+        if (!primary || !primary->var) continue;
+        cpg::Alignment entry = alignment.GetLoopEntryAlignment(access, loopStmt, primary->var);
+        if (entry.empty) continue;
+        node->SetProperty("align_entry", std::to_string(entry.KnownAlignment()));
+        if (entry.KnownAlignment() > all.KnownAlignment()) {
+            entryAligned++;
+        }
+    }
+
+    if (annotated > 0) {
+        llvm::outs() << "  [Alignment] " << annotated << " memory accesses annotated, "
+                     << entryAligned << " with stronger alignment at loop entry\n";
+    }
+}
+
 // ============================================
 // 【新增】分支相关函数实现
 // ============================================
@@ -768,49 +1136,62 @@ void ComputeGraphBuilder::MarkNodesInBranch(const BranchInfo& branchInfo)
 
     int markedCount = 0;
 
-    // 遍历所有节点，标注在分支内的节点
-    for (auto& [id, node] : currentGraph->GetNodes()) {
+    // 匹配分支类型
+    std::string branchLabel;
+    if (branchInfo.branchType == "THEN" || branchInfo.branchType == "ELSE" ||
+        branchInfo.branchType == "DEFAULT" ||
+        branchInfo.branchType.rfind("CASE", 0) == 0) { // 处理 CASE x
+        branchLabel = branchInfo.branchType;
+    }
+    if (branchLabel.empty()) return;
+
+    // 【修改】只检查分支体源码区间内的节点（区间索引查询），不再遍历所有节点；
+    // 按字符偏移判定，同一行上的 then/else 不会互相覆盖
+    std::vector<ComputeNode::NodeId> members = CollectNodesInRegion(
+        branchInfo.bodyStmt, branchInfo.bodyStartLine, branchInfo.bodyEndLine);
+
+    for (ComputeNode::NodeId id : members) {
         if (id == branchInfo.branchNodeId) continue;
+        auto node = currentGraph->GetNode(id);
+        if (!node) continue;
 
-        // 检查节点是否在分支范围内
-        bool inBranch = false;
-        std::string branchLabel;
-
-        if (!branchInfo.branchType.empty()) {
-            if (branchInfo.bodyStartLine > 0 && branchInfo.bodyEndLine > 0 &&
-                node->sourceLine >= branchInfo.bodyStartLine &&
-                node->sourceLine <= branchInfo.bodyEndLine) {
-
-                // 匹配分支类型
-                if (branchInfo.branchType == "THEN") {
-                    inBranch = true;
-                    branchLabel = "THEN";
-                } else if (branchInfo.branchType == "ELSE") {
-                    inBranch = true;
-                    branchLabel = "ELSE";
-                } else if (branchInfo.branchType.rfind("CASE", 0) == 0) { // 处理 CASE x
-                    inBranch = true;
-                    branchLabel = branchInfo.branchType;
-                } else if (branchInfo.branchType == "DEFAULT") {
-                    inBranch = true;
-                    branchLabel = "DEFAULT";
-                }
-                }
-        }
+        // 设置分支上下文属性
+        node->branchContextId = branchInfo.branchNodeId;
+        node->branchType = branchInfo.branchType;
+        node->branchContextLine = branchInfo.branchLine;
 
-        if (inBranch) {
-            // 设置分支上下文属性
-            node->branchContextId = branchInfo.branchNodeId;
-            node->branchType = branchInfo.branchType;
-            node->branchContextLine = branchInfo.branchLine;
+        // 【优化】新开一栏属性 branch_label，不再修改 node->name
+        // 这样你的可视化工具可以读取这个属性并显示在独立列中
+        node->SetProperty("branch_label", branchLabel);
 
-            // 【优化】新开一栏属性 branch_label，不再修改 node->name
-            // 这样你的可视化工具可以读取这个属性并显示在独立列中
-            node->SetProperty("branch_label", branchLabel);
+        markedCount++;
+    }
+}
 
-            markedCount++;
+// 【新增】区间内的节点：有AST位置的节点走区间索引；
+// 没有位置的节点（或语句区间跨文件时全部节点）按行号范围回退
+std::vector<ComputeNode::NodeId> ComputeGraphBuilder::CollectNodesInRegion(
+    const clang::Stmt* stmt, int startLine, int endLine)
+{
+    auto inLines = [&](const ComputeGraph::NodePtr& node) {
+        return node && startLine > 0 && endLine > 0 &&
+               node->sourceLine >= startLine && node->sourceLine <= endLine;
+    };
+
+    std::vector<ComputeNode::NodeId> result;
+    SourceRegionIndex::Region region = regionIndex.GetRegion(stmt);
+    if (!region.IsValid()) {
+        for (const auto& [id, node] : currentGraph->GetNodes()) {
+            if (inLines(node)) result.push_back(id);
         }
+        return result;
+    }
+
+    result = regionIndex.Query(*currentGraph, region);
+    for (ComputeNode::NodeId id : regionIndex.GetUnlocatedNodes()) {
+        if (inLines(currentGraph->GetNode(id))) result.push_back(id);
     }
+    return result;
 }
 
 
@@ -846,9 +1227,8 @@ ComputeNode::NodeId ComputeGraphBuilder::BuildIfBranch(
 
     // 继承循环上下文
     if (currentLoopInfo.loopNodeId != 0) {
-        branchNode->loopContextId = currentLoopInfo.loopNodeId;
-        branchNode->loopContextVar = currentLoopInfo.loopVarName;
-        branchNode->loopContextLine = currentLoopInfo.bodyStartLine;
+        AssignLoopContext(branchNode, currentLoopInfo.loopNodeId,
+                          currentLoopInfo.loopVarName, currentLoopInfo.bodyStartLine);
     }
 
     processedStmts[ifStmt] = branchId;
@@ -870,10 +1250,18 @@ ComputeNode::NodeId ComputeGraphBuilder::BuildIfBranch(
     branchInfo.branchLine = GetSourceLine(ifStmt, astContext);
 
     // 4. 处理THEN分支
+    // 【新增】与外层分支条件矛盾的分支体不构建
     auto* thenStmt = ifStmt->getThen();
+    if (thenStmt && !IsBranchFeasible(ifStmt, ifStmt, true)) {
+        branchNode->SetProperty("pruned_then", "infeasible");
+        thenStmt = nullptr;
+    }
     if (thenStmt) {
+        branchPath.push_back({thenStmt, thenStmt, ifStmt, true});
+
         // 为 THEN 分支设置专门的 info
         branchInfo.branchType = "THEN";
+        branchInfo.bodyStmt = thenStmt;
         branchInfo.bodyStartLine = GetSourceLine(thenStmt, astContext);
 
         auto& srcMgr = astContext.getSourceManager();
@@ -891,13 +1279,21 @@ ComputeNode::NodeId ComputeGraphBuilder::BuildIfBranch(
 
         // 处理完 THEN 后立刻标注，防止 info 被 ELSE 覆盖
         MarkNodesInBranch(branchInfo);
+        branchPath.pop_back();
     }
 
     // 5. 处理ELSE分支
     auto* elseStmt = ifStmt->getElse();
+    if (elseStmt && !IsBranchFeasible(ifStmt, ifStmt, false)) {
+        branchNode->SetProperty("pruned_else", "infeasible");
+        elseStmt = nullptr;
+    }
     if (elseStmt) {
+        branchPath.push_back({elseStmt, elseStmt, ifStmt, false});
+
         // 为 ELSE 分支更新 info
         branchInfo.branchType = "ELSE";
+        branchInfo.bodyStmt = elseStmt;
         branchInfo.bodyStartLine = GetSourceLine(elseStmt, astContext);
 
         auto& srcMgr = astContext.getSourceManager();
@@ -915,11 +1311,31 @@ ComputeNode::NodeId ComputeGraphBuilder::BuildIfBranch(
 
         // 处理完 ELSE 后立刻标注
         MarkNodesInBranch(branchInfo);
+        branchPath.pop_back();
     }
 
     return branchId;
 }
 
+bool ComputeGraphBuilder::IsBranchFeasible(const clang::Stmt* stmt, const clang::Stmt* condition,
+                                           bool value)
+{
+    SourceRegionIndex::Region target = regionIndex.GetRegion(stmt);
+
+    cpg::PathCondition path;
+    for (const auto& entry : branchPath) {
+        SourceRegionIndex::Region begin = regionIndex.GetRegion(entry.bodyBegin);
+        SourceRegionIndex::Region end = regionIndex.GetRegion(entry.bodyEnd);
+        if (!target.IsValid() || !begin.IsValid() || !end.IsValid()) continue;
+        if (begin.file != target.file || end.file != target.file) continue;
+        if (begin.begin <= target.begin && target.end <= end.end) {
+            path.AddCondition(entry.condition, entry.value);
+        }
+    }
+    path.AddCondition(condition, value);
+    return feasibilityChecker.IsFeasible(path);
+}
+
     ComputeNode::NodeId ComputeGraphBuilder::BuildBranchBody(
         const clang::Stmt* body, int depth, const std::string& branchType,
         const BranchInfo& parentBranch)
@@ -1090,13 +1506,8 @@ void ComputeGraphBuilder::ConnectNodes(ComputeNode::NodeId from,
 {
     if (from == to || from == 0 || to == 0) return;
 
-    auto existingEdges = currentGraph->GetOutgoingEdges(from);
-    for (const auto& edge : existingEdges) {
-        if (edge->targetId == to && edge->kind == kind &&
-            edge->label == label) {
-            return;
-        }
-    }
+    // 【修改】哈希索引判重，不再复制出边列表逐条比较标签
+    if (currentGraph->HasEdge(from, to, kind, label)) return;
 
     currentGraph->AddEdge(from, to, kind, label);
 }
@@ -1141,8 +1552,11 @@ std::shared_ptr<ComputeGraph> ComputeGraphMerger::Merge(
     }
 
     for (const auto& edge : g1.GetAllEdges()) {
-        merged->AddEdge(g1Map[edge->sourceId], g1Map[edge->targetId],
-                        edge->kind, edge->label);
+        auto newEdge = merged->AddEdge(g1Map[edge->sourceId], g1Map[edge->targetId],
+                                       edge->kind, edge->label);
+        if (newEdge) {
+            newEdge->properties = edge->properties;
+        }
     }
 
     for (const auto& node : g2.GetAllNodes()) {
@@ -1174,13 +1588,110 @@ std::shared_ptr<ComputeGraph> ComputeGraphMerger::Merge(
         }
 
         if (!exists) {
-            merged->AddEdge(fromId, toId, edge->kind, edge->label);
+            auto newEdge = merged->AddEdge(fromId, toId, edge->kind, edge->label);
+            if (newEdge) {
+                newEdge->properties = edge->properties;
+            }
         }
     }
 
+    MergeGraphProperties(g1, g2, *merged);
     return merged;
 }
 
+// 【修改】合并图级属性：描述性属性以g1为准、g2补充缺失项；分析结论取两侧中较保守的值，
+// 代价模型的结论丢弃（合并后重新估计）；惯用法摘要取并集
+void ComputeGraphMerger::MergeGraphProperties(
+    const ComputeGraph& g1, const ComputeGraph& g2, ComputeGraph& merged)
+{
+    for (const auto& [key, value] : g1.GetProperties()) {
+        merged.SetProperty(key, value);
+    }
+    for (const auto& [key, value] : g2.GetProperties()) {
+        if (!merged.HasProperty(key)) {
+            merged.SetProperty(key, value);
+        }
+    }
+
+    std::vector<std::string> costKeys;
+    for (const auto& [key, value] : merged.GetProperties()) {
+        if (llvm::StringRef(key).startswith("cost_")) {
+            costKeys.push_back(key);
+        }
+    }
+    for (const auto& key : costKeys) {
+        merged.RemoveProperty(key);
+    }
+    merged.RemoveProperty("vectorizable");
+
+    auto parse = [](const ComputeGraph& g, const char* key, long long& value) {
+        return g.HasProperty(key) && !llvm::StringRef(g.GetProperty(key)).getAsInteger(10, value);
+    };
+    // 只有一侧有结论时不能沿用（另一侧未知），两侧都有时取较保守者
+    auto combine = [&](const char* key, const std::function<long long(long long, long long)>& pick) {
+        long long a = 0;
+        long long b = 0;
+        if (parse(g1, key, a) && parse(g2, key, b)) {
+            merged.SetProperty(key, std::to_string(pick(a, b)));
+        } else {
+            merged.RemoveProperty(key);
+        }
+    };
+    auto minOf = [](long long a, long long b) { return std::min(a, b); };
+    auto maxOf = [](long long a, long long b) { return std::max(a, b); };
+
+    // 依赖：最严重的依赖类别；任一侧有内层携带依赖时取已知距离的最小值
+    std::string dep1 = g1.GetProperty("inner_loop_dependence");
+    std::string dep2 = g2.GetProperty("inner_loop_dependence");
+    if (!dep1.empty() || !dep2.empty()) {
+        merged.SetProperty("inner_loop_dependence",
+                           DependenceRank(dep2) > DependenceRank(dep1) ? dep2 : dep1);
+    }
+    long long d1 = 0;
+    long long d2 = 0;
+    bool has1 = parse(g1, "min_dep_distance", d1);
+    bool has2 = parse(g2, "min_dep_distance", d2);
+    if (has1 || has2) {
+        long long distance = has1 && has2 ? std::min(d1, d2) : (has1 ? d1 : d2);
+        merged.SetProperty("min_dep_distance", std::to_string(distance));
+    }
+    combine("dep_loop_carried", maxOf);
+    combine("dep_may_alias", maxOf);
+    combine("dep_independent", minOf);
+
+    // 迭代次数：范围取并，倍数取最大公约数
+    combine("trip_count_min", minOf);
+    combine("trip_count_max", maxOf);
+    combine("trip_count_multiple", [](long long a, long long b) { return std::gcd(a, b); });
+
+    merged.SetIdiomMask(g1.GetIdiomMask() | g2.GetIdiomMask());
+    if (merged.GetIdiomMask() != 0) {
+        merged.SetProperty("idiom_mask", std::to_string(merged.GetIdiomMask()));
+    }
+
+    std::string idioms = g1.GetProperty("idioms");
+    std::string other = g2.GetProperty("idioms");
+    size_t start = 0;
+    while (start < other.size()) {
+        size_t end = other.find(',', start);
+        if (end == std::string::npos) end = other.size();
+        std::string item = other.substr(start, end - start);
+        if (!item.empty() && ("," + idioms + ",").find("," + item + ",") == std::string::npos) {
+            idioms += idioms.empty() ? item : "," + item;
+        }
+        start = end + 1;
+    }
+    if (!idioms.empty()) {
+        merged.SetProperty("idioms", idioms);
+    }
+
+    for (const char* flag : {"has_reduction", "fp_reassociation"}) {
+        if (g1.GetProperty(flag) == "true" || g2.GetProperty(flag) == "true") {
+            merged.SetProperty(flag, "true");
+        }
+    }
+}
+
 void ComputeGraphMerger::CopyNodeProperties(const ComputeNode* src, ComputeNode* dst)
 {
     dst->name = src->name;
@@ -1228,13 +1739,55 @@ bool ComputeGraphMerger::HasOverlap(const ComputeGraph& g1, const ComputeGraph&
     return false;
 }
 
+// ============================================
+// 【新增】合并图的重新分析
+// ============================================
+
+void ComputeGraphBuilder::ReanalyzeMerged(ComputeGraph& graph)
+{
+    // 1. 丢弃两侧各自的依赖边与图级摘要（合并后出现了跨原图的访问对）
+    std::vector<ComputeEdge::EdgeId> depEdges;
+    for (const auto& edge : graph.GetAllEdges()) {
+        bool depKind = edge->kind == ComputeEdgeKind::Memory || edge->kind == ComputeEdgeKind::LoopCarried;
+        if (depKind && edge->properties.find("dep_kind") != edge->properties.end()) {
+            depEdges.push_back(edge->id);
+        }
+    }
+    for (auto id : depEdges) {
+        graph.RemoveEdge(id);
+    }
+    for (const char* key : {"dep_pairs_tested", "dep_independent", "dep_may_alias", "dep_points_to",
+                            "dep_disjoint_bases", "dep_loop_carried", "dep_loop_independent",
+                            "inner_loop_dependence", "min_dep_distance",
+                            "trip_count_min", "trip_count_max", "trip_count_multiple"}) {
+        graph.RemoveProperty(key);
+    }
+
+    // 2. 迭代次数：节点级结果随节点保留，重新提升最内层有界循环
+    const ComputeNode* innermost = nullptr;
+    for (const auto& node : graph.GetAllNodes()) {
+        if (node->kind == ComputeNodeKind::Loop && node->HasProperty("trip_count_min") &&
+            (!innermost || node->loopDepth > innermost->loopDepth)) {
+            innermost = node.get();
+        }
+    }
+    if (innermost) {
+        PromoteTripCount(graph, *innermost);
+    }
+
+    // 3. 在合并后的访问集合上重新做依赖测试
+    LoopInductionAnalysis inductionAnalysis(astContext);
+    ArrayDependenceAnalyzer(astContext, inductionAnalysis, &cpgContext).Run(graph);
+}
+
 // ============================================
 // 全局辅助函数
 // ============================================
 
-void MergeOverlappingGraphs(ComputeGraphSet& graphSet)
+void MergeOverlappingGraphs(ComputeGraphSet& graphSet,
+                            const std::function<void(ComputeGraph&)>& reanalyze)
 {
-    graphSet.MergeOverlapping();
+    graphSet.MergeOverlapping(reanalyze);
 }
 
     std::shared_ptr<ComputeGraph> ComputeGraphBuilder::BuildFromFunction(
@@ -1249,6 +1802,12 @@ void MergeOverlappingGraphs(ComputeGraphSet& graphSet)
     processedFunctions.clear();
     currentCallDepth = 0;
     currentGraph = std::make_shared<ComputeGraph>(func->getNameAsString());
+    regionIndex.Reset();
+    loopContextMembers.clear();
+    unionAliasIndex.clear();
+    unionMemberSlots.clear();
+    expandingCallSiteId = 0;
+    aliasTracedLoads.clear();
 
     for (const clang::ParmVarDecl* param : func->parameters()) {
         std::shared_ptr<ComputeNode> paramNode =
@@ -1306,8 +1865,12 @@ void ComputeGraphBuilder::AnalyzeCalleeBody(
 
     RegisterParamRefsInCallee(callee, paramToNodeId);
 
+    // 展开期间新建的union成员按本调用点登记别名（嵌套展开时恢复外层调用点）
+    ComputeNode::NodeId outerCallSiteId = expandingCallSiteId;
+    expandingCallSiteId = callNodeId;
     ProcessCalleeBodyStmts(callee, callNodeId, inheritedLoopContextId,
                           inheritedLoopContextVar, inheritedLoopContextLine);
+    expandingCallSiteId = outerCallSiteId;
 
     PropagateContextToCalleeNodes(callee, callNodeId,
                                  inheritedLoopContextId,
@@ -1416,9 +1979,8 @@ void ComputeGraphBuilder::ClearCalleeStmts(const clang::FunctionDecl* callee)
         paramNode->SetProperty("call_site_id", std::to_string(callNodeId));
 
         if (inheritedLoopContextId != 0) {
-            paramNode->loopContextId = inheritedLoopContextId;
-            paramNode->loopContextVar = inheritedLoopContextVar;
-            paramNode->loopContextLine = inheritedLoopContextLine;
+            AssignLoopContext(paramNode, inheritedLoopContextId,
+                              inheritedLoopContextVar, inheritedLoopContextLine);
             paramNode->SetProperty("in_loop_context", "true");
         }
 
@@ -1508,9 +2070,8 @@ void ComputeGraphBuilder::ProcessCalleeBodyStmts(
         }
         std::shared_ptr<ComputeNode> node = currentGraph->GetNode(nodeId);
         if (node) {
-            node->loopContextId = inheritedLoopContextId;
-            node->loopContextVar = inheritedLoopContextVar;
-            node->loopContextLine = inheritedLoopContextLine;
+            AssignLoopContext(node, inheritedLoopContextId,
+                              inheritedLoopContextVar, inheritedLoopContextLine);
             node->SetProperty("in_loop_context", "true");
         }
     };
@@ -1711,9 +2272,8 @@ void ComputeGraphBuilder::PropagateContextToCalleeNodes(
                 }
 
                 if (inheritedLoopContextId != 0 && node->loopContextId == 0) {
-                    node->loopContextId = inheritedLoopContextId;
-                    node->loopContextVar = inheritedLoopContextVar;
-                    node->loopContextLine = inheritedLoopContextLine;
+                    AssignLoopContext(node, inheritedLoopContextId,
+                                      inheritedLoopContextVar, inheritedLoopContextLine);
                     node->SetProperty("in_loop_context", "true");
                 }
             }
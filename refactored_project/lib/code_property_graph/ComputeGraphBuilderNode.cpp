@@ -4,16 +4,20 @@
  */
 
 #include "ComputeGraph.h"
+#include "IntrinsicSemantics.h"
 #include "code_property_graph/CPGAnnotation.h"
 
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/AST/ParentMapContext.h"
 #include "clang/AST/DeclTemplate.h"
 #include "clang/AST/ExprCXX.h"
+#include "clang/AST/StmtVisitor.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Lex/Lexer.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <sstream>
+
 namespace compute_graph {
 
 // ============================================
@@ -25,29 +29,35 @@ std::shared_ptr<ComputeNode> ComputeGraphBuilder::CreateCallExprNode(
 {
     if (!callExpr) return nullptr;
     
-    std::shared_ptr<ComputeNode> node = 
-        currentGraph->CreateNode(ComputeNodeKind::Call);
+    std::string calleeName;
     
     // 尝试获取函数名
     if (const clang::FunctionDecl* callee = callExpr->getDirectCallee()) {
         // 直接调用
-        node->name = callee->getNameAsString();
+        calleeName = callee->getNameAsString();
     } else if (const clang::Expr* calleeExpr = callExpr->getCallee()) {
         // 模板函数中的未解析调用
         const clang::Expr* stripped = calleeExpr->IgnoreParenImpCasts();
         
         if (const clang::UnresolvedLookupExpr* unresolvedLookup = 
             llvm::dyn_cast<clang::UnresolvedLookupExpr>(stripped)) {
-            node->name = unresolvedLookup->getName().getAsString();
+            calleeName = unresolvedLookup->getName().getAsString();
         } else if (const clang::DeclRefExpr* declRef = 
                    llvm::dyn_cast<clang::DeclRefExpr>(stripped)) {
-            node->name = declRef->getDecl()->getNameAsString();
+            calleeName = declRef->getDecl()->getNameAsString();
         } else if (const clang::MemberExpr* memberExpr = 
                    llvm::dyn_cast<clang::MemberExpr>(stripped)) {
-            node->name = memberExpr->getMemberDecl()->getNameAsString();
+            calleeName = memberExpr->getMemberDecl()->getNameAsString();
         }
     }
     
+    // 【新增】查询intrinsic语义表（O(1)），命中则建模为IntrinsicCall
+    const IntrinsicInfo* intrinsic = LookupIntrinsic(callExpr, calleeName);
+    
+    std::shared_ptr<ComputeNode> node = currentGraph->CreateNode(
+        intrinsic ? ComputeNodeKind::IntrinsicCall : ComputeNodeKind::Call);
+    node->name = calleeName;
+    
     // 如果还是没有名字，标记为未知
     if (node->name.empty()) {
         node->name = "<call>";
@@ -55,9 +65,75 @@ std::shared_ptr<ComputeNode> ComputeGraphBuilder::CreateCallExprNode(
     
     node->dataType = DataTypeInfo::FromClangType(callExpr->getType());
     
+    if (intrinsic) {
+        ApplyIntrinsicSemantics(node, *intrinsic);
+    }
+    
     return node;
 }
 
+// 【新增】用户自定义的同名函数（非系统头文件中有函数体）不按intrinsic处理
+const IntrinsicInfo* ComputeGraphBuilder::LookupIntrinsic(
+    const clang::CallExpr* callExpr, const std::string& calleeName)
+{
+    if (calleeName.empty()) return nullptr;
+    
+    const IntrinsicInfo* info = IntrinsicSemanticsDB::Instance().Lookup(calleeName);
+    if (!info) return nullptr;
+    
+    const clang::FunctionDecl* callee = callExpr->getDirectCallee();
+    if (callee && callee->hasBody() &&
+        !IsVectorIntrinsicFunction(callee, astContext.getSourceManager())) {
+        return nullptr;
+    }
+    return info;
+}
+
+void ComputeGraphBuilder::ApplyIntrinsicSemantics(
+    std::shared_ptr<ComputeNode> node, const IntrinsicInfo& info)
+{
+    node->opCode = info.opCode;
+    
+    // SVE重载名的lane类型由调用结果（或首个向量实参）类型补全
+    DataTypeInfo lane = info.laneType;
+    DataTypeInfo result = info.resultType;
+    if (lane.baseType == DataTypeInfo::BaseType::Unknown && node->dataType.IsVector()) {
+        lane = node->dataType;
+        result = node->dataType;
+    }
+    
+    node->SetProperty("is_intrinsic", "true");
+    node->SetProperty("intrinsic_isa", IntrinsicISAToString(info.isa));
+    node->SetProperty("intrinsic_lane_type", lane.ToString());
+    node->SetProperty("intrinsic_lanes", std::to_string(lane.vectorWidth));
+    // 【新增】加宽运算的结果lane类型与操作数不同，单独记录
+    if (result.baseType != lane.baseType || result.vectorWidth != lane.vectorWidth) {
+        node->SetProperty("intrinsic_result_type", result.ToString());
+        node->SetProperty("intrinsic_result_lanes", std::to_string(result.vectorWidth));
+    }
+    if (info.IsMemoryOp()) {
+        node->SetProperty("intrinsic_mem", IntrinsicMemKindToString(info.memKind));
+    }
+    if (info.isMasked) {
+        node->SetProperty("intrinsic_masked", "true");
+    }
+    
+    // 形如 "neoverse-v1:4/0.25,..."，只列出有数据的微架构
+    std::string costs;
+    for (size_t i = 0; i < static_cast<size_t>(Microarch::Count); ++i) {
+        Microarch arch = static_cast<Microarch>(i);
+        IntrinsicCost cost = info.GetCost(arch);
+        if (!cost.IsValid()) continue;
+        if (!costs.empty()) costs += ",";
+        std::ostringstream oss;
+        oss << MicroarchToString(arch) << ":" << cost.latency << "/" << cost.recipThroughput;
+        costs += oss.str();
+    }
+    if (!costs.empty()) {
+        node->SetProperty("intrinsic_cost", costs);
+    }
+}
+
 // ============================================
 // 节点创建：构造函数调用
 // ============================================
@@ -97,13 +173,13 @@ std::shared_ptr<ComputeNode> ComputeGraphBuilder::CreateMemberAccessNode(
     if (!memberExpr) return nullptr;
     
     const clang::ValueDecl* memberDecl = memberExpr->getMemberDecl();
-    bool isUnionMember = false;
+    const clang::FieldDecl* unionField = nullptr;
     
     if (const clang::FieldDecl* fieldDecl = 
         llvm::dyn_cast<clang::FieldDecl>(memberDecl)) {
         const clang::RecordDecl* recordDecl = fieldDecl->getParent();
         if (recordDecl && recordDecl->isUnion()) {
-            isUnionMember = true;
+            unionField = fieldDecl;
         }
     }
     
@@ -131,9 +207,11 @@ std::shared_ptr<ComputeNode> ComputeGraphBuilder::CreateMemberAccessNode(
     node->dataType = DataTypeInfo::FromClangType(memberExpr->getType());
     node->SetProperty("is_member_access", "true");
     
-    if (isUnionMember) {
+    if (unionField) {
         node->SetProperty("is_union_member", "true");
         node->SetProperty("union_var", baseName);
+        // 【修复】在创建处登记别名索引，不经 HandleUnionMemberAccess 的成员也能被其他成员找到
+        RegisterUnionMember(node->id, memberExpr, unionField);
     }
     
     return node;
@@ -404,122 +482,142 @@ void ComputeGraphBuilder::SetContainingFunction(
 }
 
 // ============================================
-// 主函数：CreateNodeFromStmt
-// 从原来的492行重构为<50行
+// 【新增】节点创建分发表
+// ConstStmtVisitor::Visit 对 getStmtClass() 做 switch（由 StmtNodes.inc 在编译期生成），
+// 每个语句类只经过一次跳转；未单独列出的子类沿类层次回落到父类的处理函数：
+//   CompoundAssignOperator -> BinaryOperator，CXXMemberCallExpr -> CallExpr，
+//   CStyleCastExpr 等显式转换 -> CastExpr，其余 -> VisitStmt（Unknown节点）
 // ============================================
+class ComputeGraphBuilder::NodeCreator
+    : public clang::ConstStmtVisitor<NodeCreator, std::shared_ptr<ComputeNode>> {
+public:
+    explicit NodeCreator(ComputeGraphBuilder& owner) : builder(owner) {}
 
-ComputeNode::NodeId ComputeGraphBuilder::CreateNodeFromStmt(
-    const clang::Stmt* stmt)
-{
-    if (!stmt) return 0;
-    
-    // 检查缓存
-    std::map<const clang::Stmt*, ComputeNode::NodeId>::iterator it = 
-        processedStmts.find(stmt);
-    if (it != processedStmts.end()) {
-        return it->second;
+    std::shared_ptr<ComputeNode> VisitBinaryOperator(const clang::BinaryOperator* binOp)
+    {
+        return builder.CreateBinaryOpNode(binOp);
     }
-    
-    // 根据类型创建节点
-    std::shared_ptr<ComputeNode> node;
-    
-    if (const clang::BinaryOperator* binOp = 
-        llvm::dyn_cast<clang::BinaryOperator>(stmt)) {
-        node = CreateBinaryOpNode(binOp);
-    }
-    else if (const clang::UnaryOperator* unaryOp = 
-             llvm::dyn_cast<clang::UnaryOperator>(stmt)) {
-        node = CreateUnaryOpNode(unaryOp);
+    std::shared_ptr<ComputeNode> VisitUnaryOperator(const clang::UnaryOperator* unaryOp)
+    {
+        return builder.CreateUnaryOpNode(unaryOp);
     }
-    else if (const clang::DeclRefExpr* declRef = 
-             llvm::dyn_cast<clang::DeclRefExpr>(stmt)) {
-        node = CreateVariableNode(declRef);
+    std::shared_ptr<ComputeNode> VisitDeclRefExpr(const clang::DeclRefExpr* declRef)
+    {
+        return builder.CreateVariableNode(declRef);
     }
-    else if (const clang::IntegerLiteral* intLit = 
-             llvm::dyn_cast<clang::IntegerLiteral>(stmt)) {
-        node = CreateIntConstantNode(intLit);
+    std::shared_ptr<ComputeNode> VisitIntegerLiteral(const clang::IntegerLiteral* intLit)
+    {
+        return builder.CreateIntConstantNode(intLit);
     }
-    else if (const clang::FloatingLiteral* floatLit = 
-             llvm::dyn_cast<clang::FloatingLiteral>(stmt)) {
-        node = CreateFloatConstantNode(floatLit);
+    std::shared_ptr<ComputeNode> VisitFloatingLiteral(const clang::FloatingLiteral* floatLit)
+    {
+        return builder.CreateFloatConstantNode(floatLit);
     }
-    else if (const clang::DeclStmt* declStmt = 
-             llvm::dyn_cast<clang::DeclStmt>(stmt)) {
-        node = CreateDeclStmtNode(declStmt);
+    std::shared_ptr<ComputeNode> VisitDeclStmt(const clang::DeclStmt* declStmt)
+    {
+        return builder.CreateDeclStmtNode(declStmt);
     }
-    else if (const clang::ArraySubscriptExpr* arrayExpr = 
-             llvm::dyn_cast<clang::ArraySubscriptExpr>(stmt)) {
-        node = CreateArrayAccessNode(arrayExpr);
+    std::shared_ptr<ComputeNode> VisitArraySubscriptExpr(const clang::ArraySubscriptExpr* arrayExpr)
+    {
+        return builder.CreateArrayAccessNode(arrayExpr);
     }
-    else if (const clang::CXXOperatorCallExpr* opCallExpr = 
-             llvm::dyn_cast<clang::CXXOperatorCallExpr>(stmt)) {
-        node = CreateOperatorCallNode(opCallExpr);
+    std::shared_ptr<ComputeNode> VisitCXXOperatorCallExpr(const clang::CXXOperatorCallExpr* opCallExpr)
+    {
+        return builder.CreateOperatorCallNode(opCallExpr);
     }
-    else if (const clang::CallExpr* callExpr = 
-             llvm::dyn_cast<clang::CallExpr>(stmt)) {
-        node = CreateCallExprNode(callExpr);
+    std::shared_ptr<ComputeNode> VisitCallExpr(const clang::CallExpr* callExpr)
+    {
+        return builder.CreateCallExprNode(callExpr);
     }
-    else if (const clang::CXXConstructExpr* ctorExpr = 
-             llvm::dyn_cast<clang::CXXConstructExpr>(stmt)) {
-        node = CreateConstructorNode(ctorExpr);
+    std::shared_ptr<ComputeNode> VisitCXXConstructExpr(const clang::CXXConstructExpr* ctorExpr)
+    {
+        return builder.CreateConstructorNode(ctorExpr);
     }
-    else if (const clang::MemberExpr* memberExpr = 
-             llvm::dyn_cast<clang::MemberExpr>(stmt)) {
-        node = CreateMemberAccessNode(memberExpr);
+    std::shared_ptr<ComputeNode> VisitMemberExpr(const clang::MemberExpr* memberExpr)
+    {
+        return builder.CreateMemberAccessNode(memberExpr);
     }
-    else if (const clang::MaterializeTemporaryExpr* matTemp = 
-             llvm::dyn_cast<clang::MaterializeTemporaryExpr>(stmt)) {
-        node = CreateTempNode(matTemp);
+    std::shared_ptr<ComputeNode> VisitMaterializeTemporaryExpr(
+        const clang::MaterializeTemporaryExpr* matTemp)
+    {
+        return builder.CreateTempNode(matTemp);
     }
-    else if (const clang::ImplicitCastExpr* implCast = 
-             llvm::dyn_cast<clang::ImplicitCastExpr>(stmt)) {
-        node = CreateCastNode(implCast, "implicit_cast");
+    std::shared_ptr<ComputeNode> VisitImplicitCastExpr(const clang::ImplicitCastExpr* implCast)
+    {
+        return builder.CreateCastNode(implCast, "implicit_cast");
     }
-    else if (const clang::CastExpr* castExpr = 
-             llvm::dyn_cast<clang::CastExpr>(stmt)) {
-        node = CreateCastNode(castExpr, "cast");
+    std::shared_ptr<ComputeNode> VisitCastExpr(const clang::CastExpr* castExpr)
+    {
+        return builder.CreateCastNode(castExpr, "cast");
     }
-    else if (const clang::ReturnStmt* retStmt = 
-             llvm::dyn_cast<clang::ReturnStmt>(stmt)) {
-        node = CreateReturnNode(retStmt);
+    std::shared_ptr<ComputeNode> VisitReturnStmt(const clang::ReturnStmt* retStmt)
+    {
+        return builder.CreateReturnNode(retStmt);
     }
-    else if (const clang::ForStmt* forStmt = 
-             llvm::dyn_cast<clang::ForStmt>(stmt)) {
-        node = CreateForLoopNode(forStmt);
+    std::shared_ptr<ComputeNode> VisitForStmt(const clang::ForStmt* forStmt)
+    {
+        return builder.CreateForLoopNode(forStmt);
     }
-    else if (const clang::WhileStmt* whileStmt = 
-             llvm::dyn_cast<clang::WhileStmt>(stmt)) {
-        node = CreateWhileLoopNode(whileStmt);
+    std::shared_ptr<ComputeNode> VisitWhileStmt(const clang::WhileStmt* whileStmt)
+    {
+        return builder.CreateWhileLoopNode(whileStmt);
     }
-    else if (const clang::DoStmt* doStmt = 
-             llvm::dyn_cast<clang::DoStmt>(stmt)) {
-        node = CreateDoWhileLoopNode(doStmt);
+    std::shared_ptr<ComputeNode> VisitDoStmt(const clang::DoStmt* doStmt)
+    {
+        return builder.CreateDoWhileLoopNode(doStmt);
     }
-    else if (const clang::IfStmt* ifStmt = 
-             llvm::dyn_cast<clang::IfStmt>(stmt)) {
-        node = CreateIfBranchNode(ifStmt);
+    std::shared_ptr<ComputeNode> VisitIfStmt(const clang::IfStmt* ifStmt)
+    {
+        return builder.CreateIfBranchNode(ifStmt);
     }
-    else if (const clang::SwitchStmt* switchStmt = 
-             llvm::dyn_cast<clang::SwitchStmt>(stmt)) {
-        node = CreateSwitchBranchNode(switchStmt);
+    std::shared_ptr<ComputeNode> VisitSwitchStmt(const clang::SwitchStmt* switchStmt)
+    {
+        return builder.CreateSwitchBranchNode(switchStmt);
     }
-    else if (const clang::ConditionalOperator* condOp = 
-             llvm::dyn_cast<clang::ConditionalOperator>(stmt)) {
-        node = CreateSelectNode(condOp);
+    std::shared_ptr<ComputeNode> VisitConditionalOperator(const clang::ConditionalOperator* condOp)
+    {
+        return builder.CreateSelectNode(condOp);
     }
-    else if (const clang::InitListExpr* initList = 
-             llvm::dyn_cast<clang::InitListExpr>(stmt)) {
-        node = CreateInitListNode(initList);
+    std::shared_ptr<ComputeNode> VisitInitListExpr(const clang::InitListExpr* initList)
+    {
+        return builder.CreateInitListNode(initList);
     }
-    else if (const clang::CompoundLiteralExpr* compLit = 
-             llvm::dyn_cast<clang::CompoundLiteralExpr>(stmt)) {
-        node = CreateCompoundLiteralNode(compLit);
+    std::shared_ptr<ComputeNode> VisitCompoundLiteralExpr(const clang::CompoundLiteralExpr* compLit)
+    {
+        return builder.CreateCompoundLiteralNode(compLit);
     }
-    else {
-        // 未知类型
-        node = currentGraph->CreateNode(ComputeNodeKind::Unknown);
+
+    // 未知类型
+    std::shared_ptr<ComputeNode> VisitStmt(const clang::Stmt* stmt)
+    {
+        auto node = builder.currentGraph->CreateNode(ComputeNodeKind::Unknown);
         node->name = stmt->getStmtClassName();
+        return node;
     }
+
+private:
+    ComputeGraphBuilder& builder;
+};
+
+// ============================================
+// 主函数：CreateNodeFromStmt
+// 从原来的492行重构为<50行
+// ============================================
+
+ComputeNode::NodeId ComputeGraphBuilder::CreateNodeFromStmt(
+    const clang::Stmt* stmt)
+{
+    if (!stmt) return 0;
+    
+    // 检查缓存
+    std::map<const clang::Stmt*, ComputeNode::NodeId>::iterator it = 
+        processedStmts.find(stmt);
+    if (it != processedStmts.end()) {
+        return it->second;
+    }
+    
+    // 【修改】根据 StmtClass 一次分发创建节点（原为约25个 dyn_cast 的顺序测试）
+    std::shared_ptr<ComputeNode> node = NodeCreator(*this).Visit(stmt);
     
     if (!node) return 0;
     
@@ -987,12 +1085,7 @@ ComputeNode::NodeId ComputeGraphBuilder::CreateUnaryOpDefNode(
             ConnectNodes(nodeId, operandId,
                         ComputeEdgeKind::DataFlow, "assign_to");
 
-            std::shared_ptr<ComputeNode> operandNode =
-                currentGraph->GetNode(operandId);
-            if (operandNode) {
-                operandNode->SetProperty("is_assign_target", "true");
-                operandNode->SetProperty("is_read_write", "true");
-            }
+            MarkAssignTarget(currentGraph->GetNode(operandId), true);
         }
     }
 
@@ -1071,10 +1164,24 @@ void ComputeGraphBuilder::SetLoopContextForNode(ComputeNode::NodeId nodeId)
 
     std::shared_ptr<ComputeNode> node = currentGraph->GetNode(nodeId);
     if (node) {
-        node->loopContextId = currentLoopInfo.loopNodeId;
-        node->loopContextVar = currentLoopInfo.loopVarName;
-        node->loopContextLine = currentLoopInfo.bodyStartLine;
+        AssignLoopContext(node, currentLoopInfo.loopNodeId,
+                          currentLoopInfo.loopVarName, currentLoopInfo.bodyStartLine);
+    }
+}
+
+void ComputeGraphBuilder::AssignLoopContext(
+    const std::shared_ptr<ComputeNode>& node, ComputeNode::NodeId loopId,
+    const std::string& loopVar, int loopLine)
+{
+    if (!node || loopId == 0) {
+        return;
+    }
+    if (node->loopContextId != loopId) {
+        loopContextMembers[loopId].push_back(node->id);
     }
+    node->loopContextId = loopId;
+    node->loopContextVar = loopVar;
+    node->loopContextLine = loopLine;
 }
 
 } // namespace compute_graph
@@ -11,10 +11,13 @@
 #include "clang/AST/ParentMapContext.h"
 #include "clang/AST/DeclTemplate.h"
 #include "clang/AST/ExprCXX.h"
+#include "clang/AST/StmtVisitor.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Lex/Lexer.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <cstdlib>
+
 namespace compute_graph {
 
 // ============================================
@@ -25,20 +28,49 @@ bool ComputeGraphBuilder::IsControlFlowStmt(const clang::Stmt* stmt)
 {
     if (!stmt) return false;
     
-    return llvm::isa<clang::IfStmt>(stmt) ||
-           llvm::isa<clang::SwitchStmt>(stmt) ||
-           llvm::isa<clang::ForStmt>(stmt) ||
-           llvm::isa<clang::WhileStmt>(stmt) ||
-           llvm::isa<clang::DoStmt>(stmt);
+    switch (stmt->getStmtClass()) {
+        case clang::Stmt::IfStmtClass:
+        case clang::Stmt::SwitchStmtClass:
+        case clang::Stmt::ForStmtClass:
+        case clang::Stmt::WhileStmtClass:
+        case clang::Stmt::DoStmtClass:
+            return true;
+        default:
+            return false;
+    }
 }
 
 bool ComputeGraphBuilder::IsLoopStmt(const clang::Stmt* stmt)
 {
     if (!stmt) return false;
     
-    return llvm::isa<clang::ForStmt>(stmt) ||
-           llvm::isa<clang::WhileStmt>(stmt) ||
-           llvm::isa<clang::DoStmt>(stmt);
+    switch (stmt->getStmtClass()) {
+        case clang::Stmt::ForStmtClass:
+        case clang::Stmt::WhileStmtClass:
+        case clang::Stmt::DoStmtClass:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 【新增】字面量只是所在表达式的叶子：单独构建时不必先构建外层控制流，
+// 外层控制流稍后构建时会通过 processedStmts 复用该节点
+bool ComputeGraphBuilder::MayNeedControlFlowLift(const clang::Stmt* stmt)
+{
+    switch (stmt->getStmtClass()) {
+        case clang::Stmt::IntegerLiteralClass:
+        case clang::Stmt::FloatingLiteralClass:
+        case clang::Stmt::CharacterLiteralClass:
+        case clang::Stmt::StringLiteralClass:
+        case clang::Stmt::ImaginaryLiteralClass:
+        case clang::Stmt::CXXBoolLiteralExprClass:
+        case clang::Stmt::CXXNullPtrLiteralExprClass:
+        case clang::Stmt::NullStmtClass:
+            return false;
+        default:
+            return true;
+    }
 }
 
 // ============================================
@@ -138,8 +170,8 @@ void ComputeGraphBuilder::ApplyLoopContext(
             ComputeNode::NodeId loopId = processedStmts[pStmt];
             std::shared_ptr<ComputeNode> loopNode = currentGraph->GetNode(loopId);
             
-            node->loopContextId = loopId;
-            node->loopContextLine = loopNode ? loopNode->sourceLine : 0;
+            AssignLoopContext(node, loopId, node->loopContextVar,
+                              loopNode ? loopNode->sourceLine : 0);
             
             std::string loopTag = "IN LOOP[" + std::to_string(loopId) + "]";
             node->SetProperty("loop_context", loopTag);
@@ -175,11 +207,7 @@ void ComputeGraphBuilder::HandleCompoundAssignment(
             // 写操作
             ConnectNodes(nodeId, lhsId, ComputeEdgeKind::DataFlow, "assign_to");
             
-            std::shared_ptr<ComputeNode> lhsNode = currentGraph->GetNode(lhsId);
-            if (lhsNode) {
-                lhsNode->SetProperty("is_assign_target", "true");
-                lhsNode->SetProperty("is_read_write", "true");
-            }
+            MarkAssignTarget(currentGraph->GetNode(lhsId), true);
         }
     }
     
@@ -218,10 +246,7 @@ void ComputeGraphBuilder::HandleAssignment(
         if (lhsId != 0) {
             ConnectNodes(nodeId, lhsId, ComputeEdgeKind::DataFlow, "assign_to");
             
-            std::shared_ptr<ComputeNode> lhsNode = currentGraph->GetNode(lhsId);
-            if (lhsNode) {
-                lhsNode->SetProperty("is_assign_target", "true");
-            }
+            MarkAssignTarget(currentGraph->GetNode(lhsId), false);
         }
     }
 }
@@ -698,86 +723,94 @@ void ComputeGraphBuilder::ProcessGenericChildren(
 // 子节点处理总调度
 // ============================================
 
-void ComputeGraphBuilder::ProcessStatementChildren(
-    const clang::Stmt* stmt, ComputeNode::NodeId nodeId, int depth)
-{
-    if (!stmt) return;
-    
-    // 使用dynamic_cast分发到具体处理函数
-    if (const clang::BinaryOperator* binOp = 
-        llvm::dyn_cast<clang::BinaryOperator>(stmt)) {
-        ProcessBinaryOperator(binOp, nodeId, depth);
-    }
-    else if (const clang::UnaryOperator* unaryOp = 
-             llvm::dyn_cast<clang::UnaryOperator>(stmt)) {
-        ProcessUnaryOperator(unaryOp, nodeId, depth);
-    }
-    else if (const clang::ArraySubscriptExpr* arrayExpr = 
-             llvm::dyn_cast<clang::ArraySubscriptExpr>(stmt)) {
-        ProcessArraySubscript(arrayExpr, nodeId, depth);
-    }
-    else if (const clang::CXXConstructExpr* ctorExpr = 
-             llvm::dyn_cast<clang::CXXConstructExpr>(stmt)) {
-        ProcessConstructorExpr(ctorExpr, nodeId, depth);
-    }
-    else if (const clang::CallExpr* callExpr = 
-             llvm::dyn_cast<clang::CallExpr>(stmt)) {
-        ProcessCallExpr(callExpr, nodeId, depth);
-    }
-    else if (const clang::CastExpr* castExpr = 
-             llvm::dyn_cast<clang::CastExpr>(stmt)) {
-        ProcessCastExpr(castExpr, nodeId, depth);
-    }
-    else if (const clang::MaterializeTemporaryExpr* matTemp = 
-             llvm::dyn_cast<clang::MaterializeTemporaryExpr>(stmt)) {
-        ProcessMaterializeTemporaryExpr(matTemp, nodeId, depth);
-    }
-    else if (const clang::ImplicitCastExpr* implCast = 
-             llvm::dyn_cast<clang::ImplicitCastExpr>(stmt)) {
-        // 隐式转换在这里处理子表达式
-        if (const clang::Expr* subExpr = implCast->getSubExpr()) {
-            ComputeNode::NodeId subId = BuildExpressionTree(
-                subExpr->IgnoreParenImpCasts(), depth + 1);
-            if (subId != 0) {
-                ConnectNodes(subId, nodeId, ComputeEdgeKind::DataFlow, "implicit");
-            }
-        }
+// 【新增】子节点处理分发表：与 NodeCreator 相同，按 StmtClass 一次跳转
+// （ImplicitCastExpr 等所有转换回落到 VisitCastExpr，CXXOperatorCallExpr 等回落到 VisitCallExpr）
+class ComputeGraphBuilder::ChildProcessor
+    : public clang::ConstStmtVisitor<ChildProcessor> {
+public:
+    ChildProcessor(ComputeGraphBuilder& owner, ComputeNode::NodeId id, int d)
+        : builder(owner), nodeId(id), depth(d) {}
+
+    void VisitBinaryOperator(const clang::BinaryOperator* binOp)
+    {
+        builder.ProcessBinaryOperator(binOp, nodeId, depth);
+    }
+    void VisitUnaryOperator(const clang::UnaryOperator* unaryOp)
+    {
+        builder.ProcessUnaryOperator(unaryOp, nodeId, depth);
+    }
+    void VisitArraySubscriptExpr(const clang::ArraySubscriptExpr* arrayExpr)
+    {
+        builder.ProcessArraySubscript(arrayExpr, nodeId, depth);
+    }
+    void VisitCXXConstructExpr(const clang::CXXConstructExpr* ctorExpr)
+    {
+        builder.ProcessConstructorExpr(ctorExpr, nodeId, depth);
+    }
+    void VisitCallExpr(const clang::CallExpr* callExpr)
+    {
+        builder.ProcessCallExpr(callExpr, nodeId, depth);
+    }
+    void VisitCastExpr(const clang::CastExpr* castExpr)
+    {
+        builder.ProcessCastExpr(castExpr, nodeId, depth);
+    }
+    void VisitMaterializeTemporaryExpr(const clang::MaterializeTemporaryExpr* matTemp)
+    {
+        builder.ProcessMaterializeTemporaryExpr(matTemp, nodeId, depth);
     }
-    else if (const clang::MemberExpr* memberExpr = 
-             llvm::dyn_cast<clang::MemberExpr>(stmt)) {
-        ProcessMemberExpr(memberExpr, nodeId, depth);
+    void VisitMemberExpr(const clang::MemberExpr* memberExpr)
+    {
+        builder.ProcessMemberExpr(memberExpr, nodeId, depth);
     }
-    else if (llvm::isa<clang::DeclRefExpr>(stmt)) {
+    void VisitDeclRefExpr(const clang::DeclRefExpr*)
+    {
         // 叶子节点，无需处理子节点
     }
-    else if (const clang::ForStmt* forStmt = 
-             llvm::dyn_cast<clang::ForStmt>(stmt)) {
-        ProcessForStmt(forStmt, nodeId, depth);
+    void VisitForStmt(const clang::ForStmt* forStmt)
+    {
+        builder.ProcessForStmt(forStmt, nodeId, depth);
     }
-    else if (const clang::WhileStmt* whileStmt = 
-             llvm::dyn_cast<clang::WhileStmt>(stmt)) {
-        ProcessWhileStmt(whileStmt, nodeId, depth);
+    void VisitWhileStmt(const clang::WhileStmt* whileStmt)
+    {
+        builder.ProcessWhileStmt(whileStmt, nodeId, depth);
     }
-    else if (const clang::DoStmt* doStmt = 
-             llvm::dyn_cast<clang::DoStmt>(stmt)) {
-        ProcessDoStmt(doStmt, nodeId, depth);
+    void VisitDoStmt(const clang::DoStmt* doStmt)
+    {
+        builder.ProcessDoStmt(doStmt, nodeId, depth);
     }
-    else if (const clang::ConditionalOperator* condOp = 
-             llvm::dyn_cast<clang::ConditionalOperator>(stmt)) {
-        ProcessConditionalOperator(condOp, nodeId, depth);
+    void VisitConditionalOperator(const clang::ConditionalOperator* condOp)
+    {
+        builder.ProcessConditionalOperator(condOp, nodeId, depth);
     }
-    else if (const clang::ReturnStmt* retStmt = 
-             llvm::dyn_cast<clang::ReturnStmt>(stmt)) {
-        ProcessReturnStmt(retStmt, nodeId, depth);
+    void VisitReturnStmt(const clang::ReturnStmt* retStmt)
+    {
+        builder.ProcessReturnStmt(retStmt, nodeId, depth);
     }
-    else if (const clang::DeclStmt* declStmt = 
-             llvm::dyn_cast<clang::DeclStmt>(stmt)) {
-        ProcessDeclStmt(declStmt, nodeId, depth);
+    void VisitDeclStmt(const clang::DeclStmt* declStmt)
+    {
+        builder.ProcessDeclStmt(declStmt, nodeId, depth);
     }
-    else {
-        // 其他类型使用通用处理
-        ProcessGenericChildren(stmt, nodeId, depth);
+
+    // 其他类型使用通用处理
+    void VisitStmt(const clang::Stmt* stmt)
+    {
+        builder.ProcessGenericChildren(stmt, nodeId, depth);
     }
+
+private:
+    ComputeGraphBuilder& builder;
+    ComputeNode::NodeId nodeId;
+    int depth;
+};
+
+void ComputeGraphBuilder::ProcessStatementChildren(
+    const clang::Stmt* stmt, ComputeNode::NodeId nodeId, int depth)
+{
+    if (!stmt) return;
+    
+    // 【修改】按 StmtClass 分发到具体处理函数（原为逐个 dyn_cast 测试）
+    ChildProcessor(*this, nodeId, depth).Visit(stmt);
 }
 
     // 获取语句所在的函数
@@ -816,10 +849,12 @@ ComputeNode::NodeId ComputeGraphBuilder::BuildExpressionTree(
     if (!stmt) return 0;
     if (depth > maxExprDepth) return 0;
     
+    const clang::Stmt::StmtClass stmtClass = stmt->getStmtClass();
+    
     // 1. 处理简单隐式转换
-    if (const clang::ImplicitCastExpr* implCast = 
-        llvm::dyn_cast<clang::ImplicitCastExpr>(stmt)) {
-        ComputeNode::NodeId result = HandleSimpleImplicitCast(implCast, depth);
+    if (stmtClass == clang::Stmt::ImplicitCastExprClass) {
+        ComputeNode::NodeId result = HandleSimpleImplicitCast(
+            llvm::cast<clang::ImplicitCastExpr>(stmt), depth);
         if (result != 0) return result;
     }
     
@@ -830,8 +865,9 @@ ComputeNode::NodeId ComputeGraphBuilder::BuildExpressionTree(
         return it->second;
     }
     
-    // 3. 控制流提升
-    const clang::Stmt* enclosingControl = FindEnclosingControlFlow(stmt);
+    // 3. 控制流提升（【修改】仅对可能需要的语句类逐级查找父节点）
+    const clang::Stmt* enclosingControl =
+        MayNeedControlFlowLift(stmt) ? FindEnclosingControlFlow(stmt) : nullptr;
     if (enclosingControl) {
         BuildExpressionTree(enclosingControl, depth);
         if (processedStmts.count(stmt)) {
@@ -840,12 +876,11 @@ ComputeNode::NodeId ComputeGraphBuilder::BuildExpressionTree(
     }
     
     // 4. 特殊分支结构优先处理
-    if (const clang::IfStmt* ifStmt = llvm::dyn_cast<clang::IfStmt>(stmt)) {
-        return BuildIfBranch(ifStmt, depth);
+    if (stmtClass == clang::Stmt::IfStmtClass) {
+        return BuildIfBranch(llvm::cast<clang::IfStmt>(stmt), depth);
     }
-    if (const clang::SwitchStmt* switchStmt = 
-        llvm::dyn_cast<clang::SwitchStmt>(stmt)) {
-        return BuildSwitchBranch(switchStmt, depth);
+    if (stmtClass == clang::Stmt::SwitchStmtClass) {
+        return BuildSwitchBranch(llvm::cast<clang::SwitchStmt>(stmt), depth);
     }
     
     // 5. 创建节点
@@ -868,6 +903,66 @@ ComputeNode::NodeId ComputeGraphBuilder::BuildExpressionTree(
     return nodeId;
 }
 
+namespace {
+
+// union变量的规范声明：剥去 s.u / a[i].u / p->u 的外层，取最外层引用的变量
+const clang::VarDecl* GetUnionRootVar(const clang::Expr* base)
+{
+    while (base) {
+        base = base->IgnoreParenImpCasts();
+        if (const auto* declRef = llvm::dyn_cast<clang::DeclRefExpr>(base)) {
+            const auto* var = llvm::dyn_cast<clang::VarDecl>(declRef->getDecl());
+            return var ? var->getCanonicalDecl() : nullptr;
+        }
+        if (const auto* member = llvm::dyn_cast<clang::MemberExpr>(base)) {
+            base = member->getBase();
+        } else if (const auto* subscript = llvm::dyn_cast<clang::ArraySubscriptExpr>(base)) {
+            base = subscript->getBase();
+        } else if (const auto* unary = llvm::dyn_cast<clang::UnaryOperator>(base)) {
+            if (unary->getOpcode() != clang::UO_Deref) {
+                return nullptr;
+            }
+            base = unary->getSubExpr();
+        } else {
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+void ComputeGraphBuilder::RegisterUnionMember(
+    ComputeNode::NodeId memberId,
+    const clang::MemberExpr* memberExpr,
+    const clang::FieldDecl* field)
+{
+    if (!memberExpr || !field || unionMemberSlots.count(memberId)) {
+        return;
+    }
+
+    // 键：规范 VarDecl；局部变量再按调用点/所在函数区分，全局变量在整个图中互为别名
+    UnionAliasKey key;
+    key.var = GetUnionRootVar(memberExpr->getBase());
+    if (!key.var) {
+        return;
+    }
+    if (key.var->hasLocalStorage()) {
+        key.callSiteId = expandingCallSiteId;
+        if (key.callSiteId == 0) {
+            const clang::FunctionDecl* func = GetContainingFunction(memberExpr);
+            key.func = func ? func->getCanonicalDecl() : nullptr;
+        }
+    }
+
+    std::vector<UnionMemberEntry>& members = unionAliasIndex[key];
+    UnionMemberEntry entry;
+    entry.nodeId = memberId;
+    entry.field = field;
+    unionMemberSlots[memberId] = std::make_pair(key, members.size());
+    members.push_back(entry);
+}
+
     void ComputeGraphBuilder::ConnectUnionAliases(
     ComputeNode::NodeId baseId,
     ComputeNode::NodeId currentMemberId,
@@ -878,86 +973,69 @@ ComputeNode::NodeId ComputeGraphBuilder::BuildExpressionTree(
         return;
     }
 
-    std::string currentFieldName = currentField->getNameAsString();
     std::shared_ptr<ComputeNode> currentNode =
         currentGraph->GetNode(currentMemberId);
-
-    if (!currentNode) {
+    auto slot = unionMemberSlots.find(currentMemberId);
+    if (!currentNode || slot == unionMemberSlots.end()) {
         return;
     }
 
-    std::string currentUnionVar = currentNode->GetProperty("union_var");
-    std::string currentCallSiteId = currentNode->GetProperty("call_site_id");
-    bool currentIsWriteTarget =
+    // 1. 当前成员已在创建时按别名键登记
+    std::vector<UnionMemberEntry>& members = unionAliasIndex[slot->second.first];
+    size_t currentSlot = slot->second.second;
+    UnionMemberEntry& current = members[currentSlot];
+    if (current.connectedUpTo != 0) {
+        return;
+    }
+    current.connectedUpTo = members.size();
+    current.isWriteTarget = current.isWriteTarget ||
         (currentNode->GetProperty("is_assign_target") == "true");
 
-    const std::map<ComputeNode::NodeId,
-                   std::shared_ptr<ComputeNode>>& nodes =
-        currentGraph->GetNodes();
-
-    for (const std::pair<const ComputeNode::NodeId,
-                         std::shared_ptr<ComputeNode>>& nodePair : nodes) {
-        ComputeNode::NodeId id = nodePair.first;
-        const std::shared_ptr<ComputeNode>& node = nodePair.second;
-
-        if (id == currentMemberId) {
-            continue;
-        }
-
-        if (node->GetProperty("is_union_member") != "true") {
-            continue;
-        }
-
-        std::string otherUnionVar = node->GetProperty("union_var");
-        if (otherUnionVar.empty() || otherUnionVar != currentUnionVar) {
-            continue;
-        }
-
-        std::string otherCallSiteId = node->GetProperty("call_site_id");
-
-        if (!currentCallSiteId.empty() && !otherCallSiteId.empty()) {
-            if (currentCallSiteId != otherCallSiteId) {
-                continue;
-            }
-        } else if (!currentCallSiteId.empty() || !otherCallSiteId.empty()) {
-            continue;
-        } else {
-            if (currentNode->containingFunc != node->containingFunc) {
-                continue;
-            }
-        }
-
-        std::string otherFieldName = node->name;
-        size_t dotPos = otherFieldName.find_last_of('.');
-        if (dotPos != std::string::npos) {
-            otherFieldName = otherFieldName.substr(dotPos + 1);
-        }
+    // 2. 只与同键的其他字段成员连接别名边；对方连边时已登记了当前成员的，边已存在
+    std::string currentFieldName = currentField->getNameAsString();
 
-        if (otherFieldName == currentFieldName) {
+    for (const UnionMemberEntry& other : members) {
+        if (other.nodeId == currentMemberId || other.field == currentField ||
+            currentSlot < other.connectedUpTo || !currentGraph->GetNode(other.nodeId)) {
             continue;
         }
 
-        bool otherIsWriteTarget =
-            (node->GetProperty("is_assign_target") == "true");
+        std::string otherFieldName = other.field->getNameAsString();
 
-        if (currentIsWriteTarget && !otherIsWriteTarget) {
+        if (current.isWriteTarget && !other.isWriteTarget) {
             std::string label = "union(" + currentFieldName + "->" +
                               otherFieldName + ")";
-            ConnectNodes(currentMemberId, id, ComputeEdgeKind::Memory, label);
-        } else if (!currentIsWriteTarget && otherIsWriteTarget) {
+            ConnectNodes(currentMemberId, other.nodeId, ComputeEdgeKind::Memory, label);
+        } else if (!current.isWriteTarget && other.isWriteTarget) {
             std::string label = "union(" + otherFieldName + "->" +
                               currentFieldName + ")";
-            ConnectNodes(id, currentMemberId, ComputeEdgeKind::Memory, label);
+            ConnectNodes(other.nodeId, currentMemberId, ComputeEdgeKind::Memory, label);
         } else {
-            if (id < currentMemberId) {
-                std::string label = "union(" + otherFieldName + "<->" +
-                                  currentFieldName + ")";
-                ConnectNodes(id, currentMemberId, ComputeEdgeKind::Memory, label);
-            }
+            std::string label = "union(" + otherFieldName + "<->" +
+                              currentFieldName + ")";
+            ConnectNodes(other.nodeId, currentMemberId, ComputeEdgeKind::Memory, label);
         }
     }
 }
 
+void ComputeGraphBuilder::MarkAssignTarget(
+    const std::shared_ptr<ComputeNode>& node, bool readWrite)
+{
+    if (!node) {
+        return;
+    }
+
+    node->SetProperty("is_assign_target", "true");
+    if (readWrite) {
+        node->SetProperty("is_read_write", "true");
+    }
+
+    auto slot = unionMemberSlots.find(node->id);
+    if (slot != unionMemberSlots.end()) {
+        unionAliasIndex[slot->second.first][slot->second.second].isWriteTarget = true;
+    }
+}
+
 bool ComputeGraphBuilder::CheckIntermediateDefinitions(
     const clang::Stmt* defStmt,
     const clang::Stmt* useStmt,
@@ -977,6 +1055,49 @@ bool ComputeGraphBuilder::CheckIntermediateDefinitions(
     return finder.foundIntermediate;
 }
 
+// 【新增】语句内是否有可从外部跳入的位置：用户标签（goto 目标），或不在顶层的
+// case/default（如 Duff's device）。嵌套 switch 的标签只在其内部可达，不计
+static bool HasInnerEntry(const clang::Stmt* stmt, bool inNestedSwitch)
+{
+    if (!stmt) {
+        return false;
+    }
+    if (llvm::isa<clang::LabelStmt>(stmt) ||
+        (!inNestedSwitch && llvm::isa<clang::SwitchCase>(stmt))) {
+        return true;
+    }
+    bool nested = inNestedSwitch || llvm::isa<clang::SwitchStmt>(stmt);
+    for (const clang::Stmt* child : stmt->children()) {
+        if (HasInnerEntry(child, nested)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool HasInnerEntry(const clang::CompoundStmt* switchBody)
+{
+    for (const clang::Stmt* s : switchBody->body()) {
+        while (const auto* label = llvm::dyn_cast_or_null<clang::SwitchCase>(s)) {
+            s = label->getSubStmt();
+        }
+        if (HasInnerEntry(s, false)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 【新增】语句执行后一定不会落到下一条语句（只认直接的 break/return/continue/goto）
+static bool EndsWithJump(const clang::Stmt* stmt)
+{
+    while (const auto* label = llvm::dyn_cast_or_null<clang::SwitchCase>(stmt)) {
+        stmt = label->getSubStmt();
+    }
+    return stmt && (llvm::isa<clang::BreakStmt>(stmt) || llvm::isa<clang::ReturnStmt>(stmt) ||
+                    llvm::isa<clang::ContinueStmt>(stmt) || llvm::isa<clang::GotoStmt>(stmt));
+}
+
     ComputeNode::NodeId ComputeGraphBuilder::BuildSwitchBranch(
     const clang::SwitchStmt* switchStmt, int depth)
 {
@@ -1031,8 +1152,48 @@ void ComputeGraphBuilder::ProcessSwitchBody(
 
     std::string currentLabel = "";
 
-    for (const clang::Stmt* s : body->body()) {
-        if (processedStmts.count(s)) {
+    // 【新增】标签与外层分支条件矛盾、且无法从上一段贯穿进入的 case 段不构建。
+    // 段 = 从一个顶层标签到下一个顶层标签之前的语句；段内有其他入口时不剪
+    std::vector<const clang::Stmt*> stmts(body->body_begin(), body->body_end());
+    bool canPrune = !HasInnerEntry(body);
+    bool sectionLive = true;
+    bool pushed = false;
+    size_t prunedCases = 0;
+
+    for (size_t i = 0; i < stmts.size(); ++i) {
+        const clang::Stmt* s = stmts[i];
+
+        if (canPrune && llvm::isa<clang::SwitchCase>(s)) {
+            if (pushed) {
+                branchPath.pop_back();
+                pushed = false;
+            }
+            bool viaFallthrough = sectionLive && i > 0 && !EndsWithJump(stmts[i - 1]);
+
+            // 连续标签（case 1: case 2: ...）任一可行即可进入
+            size_t labelCount = 0;
+            bool labelFeasible = false;
+            const clang::Stmt* cur = s;
+            while (const auto* label = llvm::dyn_cast<clang::SwitchCase>(cur)) {
+                labelCount++;
+                labelFeasible = labelFeasible || IsBranchFeasible(s, label, true);
+                cur = label->getSubStmt();
+            }
+
+            sectionLive = labelFeasible || viaFallthrough;
+            if (!sectionLive) {
+                prunedCases++;
+            } else if (!viaFallthrough && labelCount == 1) {
+                size_t last = i;
+                while (last + 1 < stmts.size() && !llvm::isa<clang::SwitchCase>(stmts[last + 1])) {
+                    last++;
+                }
+                branchPath.push_back({s, stmts[last], s, true});
+                pushed = true;
+            }
+        }
+
+        if (!sectionLive || processedStmts.count(s)) {
             continue;
         }
 
@@ -1048,11 +1209,19 @@ void ComputeGraphBuilder::ProcessSwitchBody(
 
         if (!currentLabel.empty()) {
             switchInfo.branchType = currentLabel;
+            switchInfo.bodyStmt = s;
             switchInfo.bodyStartLine = GetSourceLine(s, astContext);
             switchInfo.bodyEndLine = switchInfo.bodyStartLine;
             MarkNodesInBranch(switchInfo);
         }
     }
+
+    if (pushed) {
+        branchPath.pop_back();
+    }
+    if (prunedCases > 0) {
+        currentGraph->GetNode(switchId)->SetProperty("pruned_cases", std::to_string(prunedCases));
+    }
 }
 
 void ComputeGraphBuilder::ProcessSwitchCasesSimple(
@@ -138,6 +138,89 @@ public:
     }
 };
 
+// ============================================
+// 【新增】经指针/下标的内存访问：a[i]、*p、p->f（及其上的 .g）
+// ============================================
+
+static bool IsIndirectLValue(const clang::Expr* expr)
+{
+    expr = expr->IgnoreParens();
+    if (llvm::isa<clang::ArraySubscriptExpr>(expr)) {
+        return true;
+    }
+    if (const auto* unary = llvm::dyn_cast<clang::UnaryOperator>(expr)) {
+        return unary->getOpcode() == clang::UO_Deref;
+    }
+    if (const auto* member = llvm::dyn_cast<clang::MemberExpr>(expr)) {
+        return member->isArrow() || IsIndirectLValue(member->getBase());
+    }
+    return false;
+}
+
+// 访问的基址（指针或数组）源码文本
+static std::string IndirectBaseText(const clang::Expr* expr, clang::ASTContext& ctx)
+{
+    expr = expr->IgnoreParenImpCasts();
+    while (true) {
+        if (const auto* subscript = llvm::dyn_cast<clang::ArraySubscriptExpr>(expr)) {
+            expr = subscript->getBase()->IgnoreParenImpCasts();
+        } else if (const auto* member = llvm::dyn_cast<clang::MemberExpr>(expr)) {
+            if (member->isArrow()) {
+                expr = member->getBase()->IgnoreParenImpCasts();
+                break;
+            }
+            expr = member->getBase()->IgnoreParenImpCasts();
+        } else if (const auto* unary = llvm::dyn_cast<clang::UnaryOperator>(expr)) {
+            if (unary->getOpcode() != clang::UO_Deref) {
+                break;
+            }
+            expr = unary->getSubExpr()->IgnoreParenImpCasts();
+        } else {
+            break;
+        }
+    }
+    return GetSourceText(expr, ctx);
+}
+
+class MemoryStoreFinder : public clang::RecursiveASTVisitor<MemoryStoreFinder> {
+public:
+    std::vector<std::pair<const clang::Stmt*, const clang::Expr*>> stores;  // 写入语句、被写左值
+
+    bool VisitBinaryOperator(clang::BinaryOperator* op) {
+        if (op->isAssignmentOp() && IsIndirectLValue(op->getLHS())) {
+            stores.push_back({op, op->getLHS()->IgnoreParens()});
+        }
+        return true;
+    }
+
+    bool VisitUnaryOperator(clang::UnaryOperator* op) {
+        if (op->isIncrementDecrementOp() && IsIndirectLValue(op->getSubExpr())) {
+            stores.push_back({op, op->getSubExpr()->IgnoreParens()});
+        }
+        return true;
+    }
+};
+
+class MemoryLoadCollector : public clang::RecursiveASTVisitor<MemoryLoadCollector> {
+public:
+    std::vector<const clang::Expr*> loads;
+
+    bool VisitImplicitCastExpr(clang::ImplicitCastExpr* cast) {
+        if (cast->getCastKind() == clang::CK_LValueToRValue &&
+            IsIndirectLValue(cast->getSubExpr())) {
+            loads.push_back(cast->getSubExpr()->IgnoreParens());
+        }
+        return true;
+    }
+};
+
+bool ComputeGraphBuilder::IsPointerDerefStmt(const clang::Stmt* stmt) const
+{
+    const auto* cast = llvm::dyn_cast_or_null<clang::ImplicitCastExpr>(stmt);
+    return cast && cast->getCastKind() == clang::CK_LValueToRValue &&
+           IsIndirectLValue(cast->getSubExpr());
+}
+
 // ============================================
 // 辅助函数：检查语句是否真的定义了变量
 // ============================================
@@ -557,6 +640,9 @@ void ComputeGraphBuilder::TraceAllDefinitionsBackward(
             }
         }
     }
+
+    // 【新增】经指针/下标的读取：可能别名的其他基址写入
+    TraceAliasingStores(stmt, depth);
 }
 
     void ComputeGraphBuilder::TraceAllUsesForward(
@@ -1208,6 +1294,123 @@ void ComputeGraphBuilder::TraceUnionMemberDefinitions(
     }
 }
 
+// 两条语句是否同在某个循环体内
+static bool ShareEnclosingLoop(const clang::Stmt* a, const clang::Stmt* b, clang::ASTContext& ctx)
+{
+    const clang::SourceManager& sm = ctx.getSourceManager();
+    clang::DynTypedNodeList parents = ctx.getParents(*a);
+    while (!parents.empty()) {
+        const clang::Stmt* parent = parents[0].get<clang::Stmt>();
+        if (!parent) {
+            return false;
+        }
+        if (llvm::isa<clang::ForStmt>(parent) || llvm::isa<clang::WhileStmt>(parent) ||
+            llvm::isa<clang::DoStmt>(parent) || llvm::isa<clang::CXXForRangeStmt>(parent)) {
+            if (!sm.isBeforeInTranslationUnit(b->getBeginLoc(), parent->getBeginLoc()) &&
+                !sm.isBeforeInTranslationUnit(parent->getEndLoc(), b->getBeginLoc())) {
+                return true;
+            }
+        }
+        parents = ctx.getParents(*parent);
+    }
+    return false;
+}
+
+void ComputeGraphBuilder::TraceAliasingStores(const clang::Stmt* stmt, int depth)
+{
+    if (!stmt || depth >= maxBackwardDepth ||
+        cpgContext.GetPointsToMode() == cpg::PointsToMode::Off) {
+        return;
+    }
+
+    MemoryLoadCollector loadCollector;
+    loadCollector.TraverseStmt(const_cast<clang::Stmt*>(stmt));
+    if (loadCollector.loads.empty()) {
+        return;
+    }
+
+    const clang::FunctionDecl* func = GetContainingFunction(stmt);
+    if (!func || !func->hasBody()) {
+        return;
+    }
+    auto cacheIt = memoryStoreCache.find(func);
+    if (cacheIt == memoryStoreCache.end()) {
+        MemoryStoreFinder finder;
+        finder.TraverseStmt(func->getBody());
+        cacheIt = memoryStoreCache.emplace(func, std::move(finder.stores)).first;
+    }
+    const auto& stores = cacheIt->second;
+
+    const size_t MAX_CARRIED_STORES = 4;
+    const clang::SourceManager& sm = astContext.getSourceManager();
+    for (const clang::Expr* load : loadCollector.loads) {
+        auto nodeIt = processedStmts.find(load);
+        if (nodeIt == processedStmts.end() || !aliasTracedLoads.insert(load).second) {
+            continue;
+        }
+        std::string loadBase = IndirectBaseText(load, astContext);
+
+        const clang::Stmt* nearest = nullptr;
+        std::string nearestBase;
+        std::vector<std::pair<const clang::Stmt*, std::string>> carried;
+        for (const auto& [storeStmt, target] : stores) {
+            // 同一语句内先读后写；同一基址之间由数组依赖测试处理
+            if (!sm.isBeforeInTranslationUnit(load->getBeginLoc(), storeStmt->getBeginLoc()) &&
+                !sm.isBeforeInTranslationUnit(storeStmt->getEndLoc(), load->getBeginLoc())) {
+                continue;
+            }
+            std::string storeBase = IndirectBaseText(target, astContext);
+            if (storeBase == loadBase || !cpgContext.MayAlias(target, load)) {
+                continue;
+            }
+            if (sm.isBeforeInTranslationUnit(storeStmt->getBeginLoc(), load->getBeginLoc())) {
+                if (!nearest || sm.isBeforeInTranslationUnit(nearest->getBeginLoc(),
+                                                             storeStmt->getBeginLoc())) {
+                    nearest = storeStmt;
+                    nearestBase = storeBase;
+                }
+            } else if (carried.size() < MAX_CARRIED_STORES &&
+                       ShareEnclosingLoop(storeStmt, load, astContext)) {
+                carried.push_back({storeStmt, storeBase});
+            }
+        }
+
+        if (nearest) {
+            ConnectAliasingStore(nearest, nearestBase, loadBase, nodeIt->second,
+                                 ComputeEdgeKind::Memory, depth);
+        }
+        for (const auto& [storeStmt, storeBase] : carried) {
+            ConnectAliasingStore(storeStmt, storeBase, loadBase, nodeIt->second,
+                                 ComputeEdgeKind::LoopCarried, depth);
+        }
+    }
+}
+
+void ComputeGraphBuilder::ConnectAliasingStore(
+    const clang::Stmt* storeStmt,
+    const std::string& storeBase,
+    const std::string& loadBase,
+    ComputeNode::NodeId loadId,
+    ComputeEdgeKind kind,
+    int depth)
+{
+    std::map<const clang::Stmt*, ComputeNode::NodeId>::iterator storeIt =
+        processedStmts.find(storeStmt);
+    ComputeNode::NodeId storeId = storeIt != processedStmts.end() ?
+        storeIt->second : BuildExpressionTree(storeStmt, depth + 1);
+    if (storeId == 0 || storeId == loadId) {
+        return;
+    }
+
+    ConnectNodes(storeId, loadId, kind, "alias(" + storeBase + "->" + loadBase + ")");
+    if (std::shared_ptr<ComputeNode> storeNode = currentGraph->GetNode(storeId)) {
+        storeNode->SetProperty("alias_store_source", "true");
+    }
+    if (std::shared_ptr<ComputeNode> loadNode = currentGraph->GetNode(loadId)) {
+        loadNode->SetProperty("may_alias_store", "true");
+    }
+}
+
  void ComputeGraphBuilder::TraceParameterToCallSites(
     const clang::ParmVarDecl* paramDecl,
     ComputeNode::NodeId paramNodeId,
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * ComputeGraphDotLOD.cpp - 大图的分层（LOD）DOT导出
+ *
+ * 簇的层次来自节点上已有的上下文信息：
+ *   - 被调函数体：containingFunc 不是图的主函数
+ *   - 循环体：loopContextId 指向的循环节点
+ *   - 分支区域：branchContextId 指向的分支节点
+ * 循环/分支簇的父簇就是其上下文节点自身所在的簇，因此嵌套关系无需额外记录。
+ * 每个视图只展开本簇的直接成员，子簇画成摘要节点（URL指向下钻文件），
+ * 簇外的节点按可见的最近祖先簇合并成虚线占位节点，跨单元的边按 (源, 目标, 类型) 聚合计数。
+ */
+
+#include "ComputeGraph.h"
+
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace compute_graph {
+
+namespace {
+
+struct DotCluster {
+    std::string label;
+    ComputeNode::NodeId contextNode = 0;            // 循环/分支节点，被调函数簇为0
+    size_t parent = 0;
+    size_t depth = 0;
+    std::vector<ComputeNode::NodeId> members;       // 直接成员
+    std::vector<size_t> children;
+    std::vector<ComputeEdge::EdgeId> edges;         // 至少一端落在本簇子树内的边
+    size_t totalNodes = 0;                          // 含子簇
+    size_t anchorCount = 0;
+};
+
+// ============================================
+// 簇层次构建
+// ============================================
+class DotClusterTree {
+public:
+    explicit DotClusterTree(const ComputeGraph& g) : graph(g)
+    {
+        clusters.emplace_back();
+        clusters[0].label = g.GetName();
+        primaryFunc = FindPrimaryFunction();
+
+        for (const auto& [id, node] : graph.GetNodes()) {
+            size_t c = ClusterOf(id);
+            clusters[c].members.push_back(id);
+            if (node->GetProperty("is_anchor") == "true") {
+                clusters[c].anchorCount++;
+            }
+        }
+
+        // 子簇总在父簇之后创建，逆序一遍即可累加子树规模
+        for (size_t c = clusters.size(); c-- > 0;) {
+            clusters[c].totalNodes += clusters[c].members.size();
+            if (c != 0) {
+                clusters[clusters[c].parent].totalNodes += clusters[c].totalNodes;
+                clusters[clusters[c].parent].anchorCount += clusters[c].anchorCount;
+                clusters[clusters[c].parent].children.push_back(c);
+            }
+        }
+        for (auto& cluster : clusters) {
+            std::sort(cluster.children.begin(), cluster.children.end());
+        }
+
+        BucketEdges();
+    }
+
+    std::vector<DotCluster> clusters;
+    std::map<ComputeNode::NodeId, size_t> nodeCluster;
+
+    // view 视图中节点所属的显示单元：本簇成员为节点自身(返回 false)，否则为某个簇(返回 true)
+    bool UnitOf(ComputeNode::NodeId id, size_t view, size_t& unitCluster) const
+    {
+        size_t leaf = nodeCluster.at(id);
+        if (leaf == view) return false;
+
+        // leaf 上溯到与 view 同深度后求最近公共祖先，显示单元取 LCA 下方 leaf 一侧的簇
+        size_t a = leaf;
+        size_t b = view;
+        size_t belowA = leaf;
+        while (clusters[a].depth > clusters[b].depth) {
+            belowA = a;
+            a = clusters[a].parent;
+        }
+        while (clusters[b].depth > clusters[a].depth) {
+            b = clusters[b].parent;
+        }
+        while (a != b) {
+            belowA = a;
+            a = clusters[a].parent;
+            b = clusters[b].parent;
+        }
+        unitCluster = (a == leaf) ? a : belowA;
+        return true;
+    }
+
+    bool IsInside(size_t cluster, size_t view) const
+    {
+        for (size_t c = cluster;; c = clusters[c].parent) {
+            if (c == view) return true;
+            if (c == 0) return false;
+        }
+    }
+
+private:
+    const ComputeGraph& graph;
+    const clang::FunctionDecl* primaryFunc = nullptr;
+    std::map<const clang::FunctionDecl*, size_t> calleeClusters;
+    std::map<ComputeNode::NodeId, size_t> contextClusters;
+    std::set<ComputeNode::NodeId> visiting;
+
+    // 节点最多的函数视为图的主函数，其余函数的节点属于被调函数簇
+    const clang::FunctionDecl* FindPrimaryFunction() const
+    {
+        std::map<const clang::FunctionDecl*, size_t> counts;
+        const clang::FunctionDecl* best = nullptr;
+        size_t bestCount = 0;
+        for (const auto& [id, node] : graph.GetNodes()) {
+            if (!node->containingFunc) continue;
+            size_t count = ++counts[node->containingFunc];
+            if (count > bestCount) {
+                best = node->containingFunc;
+                bestCount = count;
+            }
+        }
+        return best;
+    }
+
+    size_t NewCluster(size_t parent, std::string label, ComputeNode::NodeId contextNode)
+    {
+        DotCluster cluster;
+        cluster.label = std::move(label);
+        cluster.contextNode = contextNode;
+        cluster.parent = parent;
+        cluster.depth = clusters[parent].depth + 1;
+        clusters.push_back(std::move(cluster));
+        return clusters.size() - 1;
+    }
+
+    size_t FunctionCluster(const clang::FunctionDecl* func)
+    {
+        if (!func || func == primaryFunc) return 0;
+        auto it = calleeClusters.find(func);
+        if (it != calleeClusters.end()) return it->second;
+
+        size_t c = NewCluster(0, "callee " + func->getNameAsString(), 0);
+        calleeClusters[func] = c;
+        return c;
+    }
+
+    size_t ContextCluster(ComputeNode::NodeId contextId, const ComputeNode& owner)
+    {
+        auto it = contextClusters.find(contextId);
+        if (it != contextClusters.end()) return it->second;
+
+        auto ctxNode = graph.GetNode(contextId);
+        // 上下文链成环（字段复制出错时可能出现）时退回到函数簇
+        size_t parent = visiting.count(contextId) ? FunctionCluster(owner.containingFunc)
+                                                  : ClusterOf(contextId);
+        std::string label = ComputeNodeKindToString(ctxNode->kind);
+        std::string branchLabel = ctxNode->GetProperty("branch_label");
+        if (!branchLabel.empty()) label += " " + branchLabel;
+        if (!ctxNode->name.empty()) label += " " + ctxNode->name;
+        if (ctxNode->sourceLine > 0) label += " @L" + std::to_string(ctxNode->sourceLine);
+
+        // ClusterOf 可能已经递归创建了同一个簇
+        it = contextClusters.find(contextId);
+        if (it != contextClusters.end()) return it->second;
+
+        size_t c = NewCluster(parent, label, contextId);
+        contextClusters[contextId] = c;
+        return c;
+    }
+
+    // 节点的最内层上下文：同时在循环和分支中时，分支节点与本节点同属一个循环则分支在内
+    ComputeNode::NodeId InnermostContext(const ComputeNode& node) const
+    {
+        auto valid = [&](ComputeNode::NodeId ctx) {
+            return ctx != 0 && ctx != node.id && graph.GetNode(ctx) != nullptr;
+        };
+        bool inLoop = valid(node.loopContextId);
+        bool inBranch = valid(node.branchContextId);
+        if (inLoop && inBranch) {
+            auto branchNode = graph.GetNode(node.branchContextId);
+            return branchNode->loopContextId == node.loopContextId ? node.branchContextId
+                                                                   : node.loopContextId;
+        }
+        if (inBranch) return node.branchContextId;
+        if (inLoop) return node.loopContextId;
+        return 0;
+    }
+
+    size_t ClusterOf(ComputeNode::NodeId id)
+    {
+        auto it = nodeCluster.find(id);
+        if (it != nodeCluster.end()) return it->second;
+
+        auto node = graph.GetNode(id);
+        visiting.insert(id);
+        ComputeNode::NodeId ctx = InnermostContext(*node);
+        size_t c = ctx != 0 ? ContextCluster(ctx, *node) : FunctionCluster(node->containingFunc);
+        visiting.erase(id);
+
+        nodeCluster[id] = c;
+        return c;
+    }
+
+    // 边挂到两端所在簇的全部祖先上，每个视图只遍历与自己相关的边
+    void BucketEdges()
+    {
+        std::vector<size_t> stamp(clusters.size(), 0);
+        size_t round = 0;
+        for (const auto& [edgeId, edge] : graph.GetEdges()) {
+            round++;
+            for (ComputeNode::NodeId end : {edge->sourceId, edge->targetId}) {
+                auto it = nodeCluster.find(end);
+                if (it == nodeCluster.end()) continue;
+                for (size_t c = it->second;; c = clusters[c].parent) {
+                    if (stamp[c] == round) break;   // 祖先链已记录
+                    stamp[c] = round;
+                    clusters[c].edges.push_back(edgeId);
+                    if (c == 0) break;
+                }
+            }
+        }
+    }
+};
+
+std::string DrillDownFileName(const std::string& stem, size_t cluster)
+{
+    return stem + ".c" + std::to_string(cluster) + ".dot";
+}
+
+} // namespace
+
+size_t ComputeGraph::ExportDotFileLOD(const std::string& filename, size_t flatThreshold) const
+{
+    if (flatThreshold == 0 || nodes.size() <= flatThreshold) {
+        ExportDotFile(filename);
+        return 1;
+    }
+
+    DotClusterTree tree(*this);
+    auto funcColors = AssignFunctionColors();
+
+    llvm::StringRef stemRef(filename);
+    stemRef.consume_back(".dot");
+    std::string stem = stemRef.str();
+    std::string overviewLink = llvm::sys::path::filename(filename).str();
+
+    size_t written = 0;
+    for (size_t view = 0; view < tree.clusters.size(); ++view) {
+        const DotCluster& cluster = tree.clusters[view];
+        std::string viewFile = view == 0 ? filename : DrillDownFileName(stem, view);
+
+        std::error_code EC;
+        llvm::raw_fd_ostream out(viewFile, EC);
+        if (EC) {
+            llvm::errs() << "Cannot create file: " << viewFile << "\n";
+            continue;
+        }
+        out.SetBufferSize(kDotWriteBufferSize);
+
+        out << "digraph ComputeGraph {\n";
+        out << "  rankdir=TB;\n";
+        out << "  nodesep=0.3;\n";
+        out << "  ranksep=0.5;\n";
+        out << "  graph [fontname=\"Helvetica\", fontsize=14, label=\"" << EscapeDotString(name);
+        if (view != 0) {
+            out << " / " << EscapeDotString(cluster.label);
+        }
+        out << "\\nNodes: " << cluster.totalNodes << " (" << cluster.members.size()
+            << " shown), Clusters: " << cluster.children.size() << "\", labelloc=t];\n";
+        out << "  node [shape=record, fontname=\"Courier\", fontsize=9];\n";
+        out << "  edge [fontname=\"Helvetica\", fontsize=8];\n\n";
+
+        // 本簇的直接成员
+        out << "  // Nodes\n";
+        for (auto id : cluster.members) {
+            WriteDetailedNode(out, nodes.at(id), funcColors);
+        }
+
+        // 子簇摘要
+        out << "\n  // Collapsed clusters\n";
+        for (size_t child : cluster.children) {
+            const DotCluster& sub = tree.clusters[child];
+            out << "  c" << child << " [shape=box3d, style=filled, fillcolor=\"#fff8dc\", label=\""
+                << EscapeDotString(sub.label) << "\\n" << sub.totalNodes << " nodes";
+            if (!sub.children.empty()) {
+                out << ", " << sub.children.size() << " sub-clusters";
+            }
+            if (sub.anchorCount > 0) {
+                out << ", " << sub.anchorCount << " anchors";
+            }
+            out << "\", URL=\"" << llvm::sys::path::filename(DrillDownFileName(stem, child))
+                << "\"";
+            if (sub.anchorCount > 0) {
+                out << ", penwidth=3, color=red";
+            }
+            out << "];\n";
+        }
+
+        // 跨单元的边聚合；两端都是展开节点的边逐条写出
+        using UnitKey = std::pair<bool, uint64_t>;   // (是否为簇, 节点ID或簇号)
+        std::map<std::tuple<UnitKey, UnitKey, ComputeEdgeKind>, size_t> aggregated;
+        std::set<size_t> outsideUnits;
+
+        out << "\n  // Edges\n";
+        for (auto edgeId : cluster.edges) {
+            const auto& edge = edges.at(edgeId);
+            if (!tree.nodeCluster.count(edge->sourceId) || !tree.nodeCluster.count(edge->targetId)) {
+                continue;
+            }
+            size_t srcCluster = 0;
+            size_t dstCluster = 0;
+            bool srcIsCluster = tree.UnitOf(edge->sourceId, view, srcCluster);
+            bool dstIsCluster = tree.UnitOf(edge->targetId, view, dstCluster);
+
+            if (!srcIsCluster && !dstIsCluster) {
+                out << "  n" << edge->sourceId << " -> n" << edge->targetId << " [";
+                WriteDetailedEdgeStyle(out, edge);
+                out << "];\n";
+                continue;
+            }
+            if (srcIsCluster && dstIsCluster && srcCluster == dstCluster) continue;
+
+            UnitKey src(srcIsCluster, srcIsCluster ? srcCluster : edge->sourceId);
+            UnitKey dst(dstIsCluster, dstIsCluster ? dstCluster : edge->targetId);
+            aggregated[std::make_tuple(src, dst, edge->kind)]++;
+            if (srcIsCluster && !tree.IsInside(srcCluster, view)) outsideUnits.insert(srcCluster);
+            if (dstIsCluster && !tree.IsInside(dstCluster, view)) outsideUnits.insert(dstCluster);
+        }
+
+        // 簇外的占位节点
+        for (size_t outside : outsideUnits) {
+            out << "  c" << outside << " [shape=box, style=dashed, label=\"(outside) "
+                << EscapeDotString(tree.clusters[outside].label) << "\", URL=\""
+                << (outside == 0 ? overviewLink
+                                 : llvm::sys::path::filename(DrillDownFileName(stem, outside)).str())
+                << "\"];\n";
+        }
+
+        for (const auto& [key, count] : aggregated) {
+            const auto& [src, dst, kind] = key;
+            out << "  " << (src.first ? "c" : "n") << src.second << " -> "
+                << (dst.first ? "c" : "n") << dst.second << " [label=\""
+                << ComputeEdgeKindToString(kind);
+            if (count > 1) {
+                out << " x" << count;
+            }
+            out << "\", penwidth=" << (count > 1 ? 2 : 1) << ", style=bold];\n";
+        }
+
+        out << "}\n";
+        written++;
+    }
+
+    llvm::outs() << "ComputeGraph exported to: " << filename << " (" << nodes.size()
+                 << " nodes, " << tree.clusters.size() - 1 << " collapsed clusters, "
+                 << written << " files)\n";
+    return written;
+}
+
+} // namespace compute_graph
@@ -3,15 +3,25 @@
  * ComputeGraphTester.cpp - 计算图测试器类实现
  */
 #include "ComputeGraphTester.h"
+#include "AnalysisRegistry.h"
+#include "ComputeGraphBinary.h"
+#include "GraphSimilarity.h"
+#include "KernelBenchmark.h"
+#include "SIMDCodeEmitter.h"
+#include "TemplateInstantiation.h"
 
 #include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/AST/DeclTemplate.h"
 #include "clang/Basic/SourceManager.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Format.h"
 
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <memory>
 
 using namespace clang;
 using namespace llvm;
@@ -25,6 +35,358 @@ ComputeGraphTestConfig g_cgConfig;
 // ComputeGraphTestRunner 实现
 // ============================================
 
+const AnchorProfile* GetConfiguredProfile()
+{
+    static AnchorProfile profile;
+    static std::string loadedPath;
+    static bool loaded = false;
+
+    if (g_cgConfig.profileFile.empty()) {
+        return nullptr;
+    }
+    if (loadedPath != g_cgConfig.profileFile) {
+        loadedPath = g_cgConfig.profileFile;
+        loaded = profile.LoadFromFile(loadedPath);
+    }
+    return loaded ? &profile : nullptr;
+}
+
+const CostModel* GetConfiguredCostModel()
+{
+    static std::unique_ptr<CostModel> model;
+    static std::string createdTarget;
+    static bool created = false;
+
+    if (g_cgConfig.simdTarget.empty() || g_cgConfig.simdTarget == "none") {
+        return nullptr;
+    }
+    if (!created || createdTarget != g_cgConfig.simdTarget) {
+        created = true;
+        createdTarget = g_cgConfig.simdTarget;
+        model = CreateCostModel(createdTarget);
+        if (!model) {
+            errs() << "Unknown SIMD target '" << createdTarget << "', supported:";
+            for (const auto& name : GetSupportedSIMDTargets()) {
+                errs() << " " << name;
+            }
+            errs() << "\n";
+        }
+    }
+    return model.get();
+}
+
+size_t ApplyConfiguredCostModel(ComputeGraphSet& graphSet)
+{
+    const CostModel* model = GetConfiguredCostModel();
+    if (!model) {
+        return 0;
+    }
+    graphSet.ApplyCostModel(*model);
+    graphSet.SortByScore();
+    return g_cgConfig.minSpeedup > 0.0 ? graphSet.PruneUnprofitable(g_cgConfig.minSpeedup) : 0;
+}
+
+size_t ExpandConfiguredInstantiations(std::vector<AnchorCluster>& clusters, const FunctionDecl* func,
+                                      cpg::CPGContext& cpgCtx, ASTContext& astCtx)
+{
+    if (!g_cgConfig.instantiations || clusters.empty()) {
+        return 0;
+    }
+    auto instances = CollectTemplateInstantiations(func, astCtx);
+    if (instances.empty()) {
+        return 0;
+    }
+
+    // 锚点簇（骨架）只在模式上查找一次；每个实例在自身AST上构建CPG与计算图
+    std::vector<AnchorCluster> expanded;
+    for (const auto& inst : instances) {
+        InstantiationMapper mapper(inst.instance);
+        size_t mapped = 0;
+        for (const auto& cluster : clusters) {
+            AnchorCluster instanceCluster;
+            if (SpecializeCluster(cluster, inst, mapper, instanceCluster)) {
+                expanded.push_back(std::move(instanceCluster));
+                mapped++;
+            }
+        }
+        if (mapped > 0) {
+            cpgCtx.BuildCPG(inst.instance);
+        }
+        if (g_cgConfig.verbose) {
+            outs() << "    [Template] " << inst.name << ": " << mapped << "/" << clusters.size()
+                   << " clusters mapped\n";
+        }
+    }
+    if (expanded.empty()) {
+        return 0;
+    }
+    clusters = std::move(expanded);
+    return clusters.size();
+}
+
+bool ExportConfiguredBinary(const ComputeGraphSet& graphSet, const std::string& baseName,
+                            ASTContext& astCtx)
+{
+    if (!g_cgConfig.emitBinary || graphSet.Size() == 0) {
+        return false;
+    }
+    std::error_code ec = sys::fs::create_directories(g_cgConfig.outputDir);
+    if (ec) {
+        errs() << "Failed to create output directory: " << g_cgConfig.outputDir << "\n";
+        return false;
+    }
+    std::string filename = g_cgConfig.outputDir + "/" + baseName + ".cgb";
+    return WriteComputeGraphSetBinary(graphSet, filename, &astCtx.getSourceManager());
+}
+
+static GraphSimilarityIndex& GetConfiguredSimilarityIndex()
+{
+    static GraphSimilarityIndex index;
+    return index;
+}
+
+size_t IndexConfiguredSimilarity(const ComputeGraphSet& graphSet, ASTContext& astCtx)
+{
+    if (!g_cgConfig.similarity) {
+        return 0;
+    }
+
+    const SourceManager& sm = astCtx.getSourceManager();
+    size_t added = 0;
+    for (const auto& graph : graphSet.GetAllGraphs()) {
+        // 位置取图中第一个有AST关联的节点所在文件 + 锚点行
+        std::string file;
+        for (const auto& [id, node] : graph->GetNodes()) {
+            if (node->astStmt) {
+                file = sm.getFilename(sm.getFileLoc(node->astStmt->getBeginLoc())).str();
+                break;
+            }
+        }
+        std::string location = (file.empty() ? "?" : file) + ":" + graph->GetProperty("anchor_line");
+        GetConfiguredSimilarityIndex().Add(*graph, graph->GetProperty("anchor_func"), location);
+        added++;
+    }
+    return added;
+}
+
+void ReportConfiguredSimilarity()
+{
+    if (!g_cgConfig.similarity) {
+        return;
+    }
+
+    constexpr size_t kMaxListedMembers = 10;
+    const GraphSimilarityIndex& index = GetConfiguredSimilarityIndex();
+    auto clusters = index.Cluster(g_cgConfig.similarityThreshold);
+    const auto& entries = index.GetEntries();
+
+    size_t shared = 0;
+    for (const auto& cluster : clusters) {
+        if (cluster.members.size() > 1) shared++;
+    }
+
+    outs() << "\n=== Kernel Similarity Clusters (threshold " << g_cgConfig.similarityThreshold << ") ===\n";
+    outs() << "  Graphs: " << index.Size() << ", clusters: " << clusters.size()
+           << ", multi-member clusters: " << shared << "\n";
+
+    size_t clusterIdx = 0;
+    for (const auto& cluster : clusters) {
+        if (cluster.members.size() < 2) break;   // 已按大小降序
+        const SimilarityEntry& rep = entries[cluster.members.front()];
+        outs() << "\n  Cluster #" << clusterIdx++ << ": " << cluster.members.size() << " kernels, "
+               << rep.fingerprint.nodeCount << " nodes, min similarity "
+               << format("%.2f", cluster.minSimilarity) << "\n";
+        for (size_t i = 0; i < cluster.members.size() && i < kMaxListedMembers; ++i) {
+            const SimilarityEntry& entry = entries[cluster.members[i]];
+            outs() << "    " << (i == 0 ? "* " : "  ") << entry.function << "  " << entry.location
+                   << "  (" << entry.graphName << ")\n";
+        }
+        if (cluster.members.size() > kMaxListedMembers) {
+            outs() << "      ... " << cluster.members.size() - kMaxListedMembers << " more\n";
+        }
+    }
+}
+
+// 按配置懒创建的登记表；未启用时返回nullptr
+static AnalysisRegistry* GetConfiguredRegistry()
+{
+    static AnalysisRegistry registry;
+    static std::string openedPath;
+    static bool opened = false;
+
+    if (!g_cgConfig.crossTUDedup && g_cgConfig.dedupRegistry.empty()) {
+        return nullptr;
+    }
+    if (!g_cgConfig.dedupRegistry.empty() && openedPath != g_cgConfig.dedupRegistry) {
+        openedPath = g_cgConfig.dedupRegistry;
+        opened = registry.OpenFile(openedPath);
+        if (!opened) {
+            errs() << "Cross-TU dedup falls back to in-process registry\n";
+        }
+    }
+    return &registry;
+}
+
+bool ClaimConfiguredFunction(const FunctionDecl* func, ASTContext& astCtx)
+{
+    AnalysisRegistry* registry = GetConfiguredRegistry();
+    if (!registry) {
+        return true;
+    }
+    registry->Refresh();
+    if (registry->Claim(MakeAnalysisIdentity(func, nullptr, astCtx))) {
+        return true;
+    }
+    registry->CountSkipped(1);
+    return false;
+}
+
+size_t FilterConfiguredAnalyzedAnchors(std::vector<AnchorPoint>& anchors, ASTContext& astCtx)
+{
+    AnalysisRegistry* registry = GetConfiguredRegistry();
+    if (!registry) {
+        return 0;
+    }
+
+    size_t before = anchors.size();
+    anchors.erase(std::remove_if(anchors.begin(), anchors.end(), [&](const AnchorPoint& anchor) {
+        return !registry->Claim(MakeAnalysisIdentity(anchor.func, anchor.stmt, astCtx));
+    }), anchors.end());
+    return before - anchors.size();
+}
+
+void ReportConfiguredDedup()
+{
+    AnalysisRegistry* registry = GetConfiguredRegistry();
+    if (!registry) {
+        return;
+    }
+    outs() << "\n=== Cross-TU Dedup ===\n";
+    outs() << "  Claimed: " << registry->ClaimedCount() << " functions/anchors, skipped "
+           << registry->SkippedCount() << " functions already analyzed\n";
+}
+
+size_t DumpConfiguredCanonical(const ComputeGraphSet& graphSet, const std::string& funcName)
+{
+    static std::unique_ptr<raw_fd_ostream> stream;
+    static std::string openedPath;
+
+    if (g_cgConfig.goldenDump.empty()) {
+        return 0;
+    }
+    if (!stream || openedPath != g_cgConfig.goldenDump) {
+        std::error_code ec;
+        stream = std::make_unique<raw_fd_ostream>(g_cgConfig.goldenDump, ec, sys::fs::OF_Text);
+        openedPath = g_cgConfig.goldenDump;
+        if (ec) {
+            errs() << "Failed to open golden dump file: " << g_cgConfig.goldenDump << " (" << ec.message() << ")\n";
+            stream.reset();
+            return 0;
+        }
+    }
+
+    *stream << "function " << funcName << " graphs=" << graphSet.Size() << "\n";
+    for (const auto& graph : graphSet.GetAllGraphs()) {
+        graph->DumpCanonical(*stream);
+    }
+    *stream << "\n";
+    stream->flush();
+    return graphSet.Size();
+}
+
+std::string GetConfiguredEmitTarget()
+{
+    return g_cgConfig.emitISA.empty() ? g_cgConfig.simdTarget : g_cgConfig.emitISA;
+}
+
+size_t EmitConfiguredSIMDCode(const ComputeGraphSet& graphSet, const std::string& baseName,
+                              ASTContext& astCtx)
+{
+    if (!g_cgConfig.emitSIMD) {
+        return 0;
+    }
+    std::string target = GetConfiguredEmitTarget();
+    std::error_code ec = sys::fs::create_directories(g_cgConfig.outputDir);
+    if (ec) {
+        errs() << "Failed to create output directory: " << g_cgConfig.outputDir << "\n";
+        return 0;
+    }
+
+    SIMDCodeEmitter emitter(astCtx, target);
+    size_t emitted = 0;
+    int idx = 0;
+    for (const auto& graph : graphSet.GetAllGraphs()) {
+        std::string prefix = g_cgConfig.outputDir + "/" + baseName + "_cg_" + std::to_string(idx++);
+        SIMDEmitResult result = emitter.Emit(*graph);
+        if (!result.success) {
+            if (g_cgConfig.verbose) {
+                outs() << "  [SIMD] " << graph->GetName() << ": not emitted, " << result.reason << "\n";
+            }
+            continue;
+        }
+
+        std::string filename = prefix + "." + result.isaSuffix + ".cpp";
+        raw_fd_ostream out(filename, ec);
+        if (ec) {
+            errs() << "Cannot write " << filename << ": " << ec.message() << "\n";
+            continue;
+        }
+        out << result.code;
+        outs() << "  Emitted: " << filename << " (" << result.functionName << ")\n";
+        emitted++;
+    }
+    return emitted;
+}
+
+size_t RunConfiguredBenchmarks(const ComputeGraphSet& graphSet, const std::string& baseName,
+                               ASTContext& astCtx)
+{
+    if (!g_cgConfig.emitBench) {
+        return 0;
+    }
+    std::error_code ec = sys::fs::create_directories(g_cgConfig.outputDir);
+    if (ec) {
+        errs() << "Failed to create output directory: " << g_cgConfig.outputDir << "\n";
+        return 0;
+    }
+
+    KernelBenchGenerator generator(astCtx, GetConfiguredEmitTarget(), g_cgConfig.benchElements);
+    size_t generated = 0;
+    int idx = 0;
+    for (const auto& graph : graphSet.GetAllGraphs()) {
+        if (g_cgConfig.benchTop > 0 && static_cast<size_t>(idx) >= g_cgConfig.benchTop) {
+            break;
+        }
+        std::string prefix = g_cgConfig.outputDir + "/" + baseName + "_cg_" + std::to_string(idx++);
+        std::string filename = prefix + ".bench.cpp";
+        KernelBenchHarness harness = generator.Generate(*graph, sys::path::filename(filename).str());
+        if (!harness.success) {
+            outs() << "  [Bench] " << graph->GetName() << ": no harness, " << harness.reason << "\n";
+            continue;
+        }
+
+        raw_fd_ostream out(filename, ec);
+        if (ec) {
+            errs() << "Cannot write " << filename << ": " << ec.message() << "\n";
+            continue;
+        }
+        out << harness.code;
+        out.close();
+        generated++;
+        outs() << "  Generated: " << filename << " (" << harness.kernelName << ", "
+               << (harness.hasVector ? harness.isaSuffix : "scalar only") << ")\n";
+        if (!harness.hasVector && g_cgConfig.verbose) {
+            outs() << "  [Bench] vector version not emitted: " << harness.vectorReason << "\n";
+        }
+
+        if (!g_cgConfig.benchCompiler.empty()) {
+            CompileAndRunKernelBench(g_cgConfig.benchCompiler, filename, harness.compileFlags,
+                                     prefix + ".bench", g_cgConfig.benchTimeout);
+        }
+    }
+    return generated;
+}
+
 ComputeGraphTestRunner::ComputeGraphTestRunner(ASTContext& astCtx,
                                                cpg::CPGContext& cpgCtx)
     : astContext_(astCtx), cpgContext_(cpgCtx)
@@ -100,10 +462,22 @@ void ComputeGraphTestRunner::AnalyzeFunction(const FunctionDecl* func)
 {
     outs() << "\n  [Analyzing Function: " << func->getNameAsString() << "]\n";
 
+    // 【新增】头文件中的函数在其他翻译单元已分析过则跳过
+    if (!ClaimConfiguredFunction(func, astContext_)) {
+        outs() << "  Skipped: already analyzed in another translation unit\n";
+        return;
+    }
+
     // 1. 查找锚点
     AnchorFinder finder(cpgContext_, astContext_);
+    finder.SetProfile(GetConfiguredProfile());
+    finder.SetMaxAnchors(g_cgConfig.maxAnchors);
     auto anchors = finder.FindAnchorsInFunction(func);
     auto rankedAnchors = finder.FilterAndRankAnchors(anchors);
+    size_t claimedElsewhere = FilterConfiguredAnalyzedAnchors(rankedAnchors, astContext_);
+    if (claimedElsewhere > 0) {
+        outs() << "  Skipped " << claimedElsewhere << " anchors already analyzed\n";
+    }
 
     outs() << "  Found " << anchors.size() << " raw anchors, ";
     outs() << rankedAnchors.size() << " after filtering\n";
@@ -117,6 +491,9 @@ void ComputeGraphTestRunner::AnalyzeFunction(const FunctionDecl* func)
             outs() << "L" << anchor.sourceLine << " ";
             outs() << "score=" << anchor.score << " ";
             outs() << "depth=" << anchor.loopDepth << " ";
+            if (anchor.hotness > 0.0) {
+                outs() << "hot=" << anchor.hotness << " ";
+            }
             outs() << ComputeNodeKindToString(anchor.expectedKind);
             if (anchor.opCode != OpCode::Unknown) {
                 outs() << "(" << OpCodeToString(anchor.opCode) << ")";
@@ -133,8 +510,10 @@ void ComputeGraphTestRunner::AnalyzeFunction(const FunctionDecl* func)
 
     ComputeGraphSet graphSet;
 
-    for (const auto& anchor : rankedAnchors) {
-        auto graph = builder.BuildFromAnchor(anchor);
+    // 【修改】按最内层循环分簇，每簇一次构建
+    auto clusters = finder.ClusterAnchors(rankedAnchors);
+    for (const auto& cluster : clusters) {
+        auto graph = builder.BuildFromAnchorCluster(cluster);
         if (graph && !graph->IsEmpty()) {
             graphSet.AddGraph(graph);
 
@@ -148,9 +527,13 @@ void ComputeGraphTestRunner::AnalyzeFunction(const FunctionDecl* func)
 
     outs() << "  Built " << graphSet.Size() << " computation graphs\n";
 
-    // 3. 合并重叠的图
+    // 3. 合并重叠的图（簇内锚点已共同构建，只剩跨簇重叠）
     size_t beforeMerge = graphSet.Size();
-    MergeOverlappingGraphs(graphSet);
+    if (beforeMerge > 1) {
+        MergeOverlappingGraphs(graphSet, [&builder](ComputeGraph& merged) {
+            builder.ReanalyzeMerged(merged);
+        });
+    }
     if (beforeMerge != graphSet.Size()) {
         outs() << "  Merged overlapping graphs: " << beforeMerge << " -> " << graphSet.Size() << "\n";
     }
@@ -162,9 +545,22 @@ void ComputeGraphTestRunner::AnalyzeFunction(const FunctionDecl* func)
         outs() << "  Deduplicated: " << beforeDedup << " -> " << graphSet.Size() << "\n";
     }
 
+    // 【新增】模板函数按实例展开（骨架只在模式上构建一次）
+    size_t instanceGraphs = ExpandConfiguredInstantiations(graphSet, func, astContext_);
+    if (instanceGraphs > 0) {
+        outs() << "  Template instantiations: " << instanceGraphs << " graphs\n";
+    }
+
+    // 5. 向量化收益估计：排序并剪除无收益的图
+    size_t pruned = ApplyConfiguredCostModel(graphSet);
+    if (pruned > 0) {
+        outs() << "  Pruned " << pruned << " graphs not vectorizable or below speedup "
+               << g_cgConfig.minSpeedup << "\n";
+    }
+
     outs() << "  Final: " << graphSet.Size() << " graphs\n";
 
-    // 5. 输出图信息
+    // 6. 输出图信息
     if (g_cgConfig.dumpGraphs) {
         for (const auto& graph : graphSet.GetAllGraphs()) {
             outs() << "\n  --- Graph: " << graph->GetName() << " ---\n";
@@ -180,6 +576,17 @@ void ComputeGraphTestRunner::AnalyzeFunction(const FunctionDecl* func)
             if (graph->HasProperty("anchor_code")) {
                 outs() << "  Anchor Code: " << graph->GetProperty("anchor_code") << "\n";
             }
+            if (graph->HasProperty("cost_speedup")) {
+                outs() << "  Est. Speedup (" << graph->GetProperty("cost_target") << "): "
+                       << graph->GetProperty("cost_speedup") << "x\n";
+            }
+            if (graph->HasProperty("idioms")) {
+                outs() << "  Idioms: " << graph->GetProperty("idioms");
+                if (graph->GetProperty("fp_reassociation") == "true") {
+                    outs() << " (requires FP reassociation)";
+                }
+                outs() << "\n";
+            }
 
             if (g_cgConfig.verbose) {
                 graph->Dump();
@@ -187,16 +594,22 @@ void ComputeGraphTestRunner::AnalyzeFunction(const FunctionDecl* func)
         }
     }
 
-    // 6. 生成可视化文件
+    // 7. 生成可视化文件
     if (g_cgConfig.visualize) {
         int idx = 0;
         for (const auto& graph : graphSet.GetAllGraphs()) {
             std::string filename = g_cgConfig.outputDir + "/" +
                 func->getNameAsString() + "_cg_" + std::to_string(idx++) + ".dot";
-            graph->ExportDotFile(filename);
+            graph->ExportDotFileLOD(filename, g_cgConfig.dotLODThreshold);
             outs() << "  Generated: " << filename << "\n";
         }
     }
+
+    // 8. 【新增】生成向量化代码、微基准与二进制图文件
+    EmitConfiguredSIMDCode(graphSet, func->getNameAsString(), astContext_);
+    ExportConfiguredBinary(graphSet, func->getNameAsString(), astContext_);
+    IndexConfiguredSimilarity(graphSet, astContext_);
+    RunConfiguredBenchmarks(graphSet, func->getNameAsString(), astContext_);
 }
 
 void ComputeGraphTestRunner::PrintSummary() const
@@ -519,7 +932,7 @@ void VisualizationGenerator::GenerateAllGraphDots(const ComputeGraphSet& graphSe
     for (const auto& graph : graphSet.GetAllGraphs()) {
         std::string filename = outputDir + "/compute_graph_" +
             std::to_string(idx++) + ".dot";
-        graph->ExportDotFile(filename);
+        graph->ExportDotFileLOD(filename, g_cgConfig.dotLODThreshold);
     }
 
     outs() << "Generated " << idx << " DOT files in " << outputDir << "\n";
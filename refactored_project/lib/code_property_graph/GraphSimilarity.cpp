@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * GraphSimilarity.cpp - 计算图的近似相似度索引（跨文件内核聚类）
+ */
+
+#include "GraphSimilarity.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <tuple>
+
+namespace compute_graph {
+
+namespace {
+
+// splitmix64：进程内外都稳定的哈希，聚类结果可复现
+uint64_t Mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t Combine(uint64_t seed, uint64_t value)
+{
+    return Mix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+// 初始标签：只看计算本身，名字/常量值/位置都不参与
+uint64_t InitialLabel(const ComputeNode& node)
+{
+    uint64_t label = Combine(static_cast<uint64_t>(node.kind), static_cast<uint64_t>(node.opCode));
+    label = Combine(label, static_cast<uint64_t>(node.dataType.baseType));
+    return Combine(label, node.dataType.IsVector() ? static_cast<uint64_t>(node.dataType.vectorWidth) : 1);
+}
+
+class UnionFind {
+public:
+    explicit UnionFind(size_t n) : parent(n) { std::iota(parent.begin(), parent.end(), 0); }
+
+    size_t Find(size_t x)
+    {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    // 较小的下标作为根，簇代表即最早加入索引的图
+    void Unite(size_t a, size_t b)
+    {
+        a = Find(a);
+        b = Find(b);
+        if (a == b) return;
+        if (b < a) std::swap(a, b);
+        parent[b] = a;
+    }
+
+private:
+    std::vector<size_t> parent;
+};
+
+} // namespace
+
+GraphSimilarityIndex::GraphSimilarityIndex(int wlIterations, size_t numHashes, size_t bands)
+    : iterations(std::max(wlIterations, 0)),
+      hashCount(numHashes > 0 ? numHashes : 64),
+      bandCount(bands > 0 && hashCount % bands == 0 ? bands : 1),
+      rowsPerBand(hashCount / bandCount)
+{
+    seeds.reserve(hashCount);
+    for (size_t i = 0; i < hashCount; ++i) {
+        seeds.push_back(Mix(0x51ed270b27bc9ULL + i));
+    }
+}
+
+GraphFingerprint GraphSimilarityIndex::ComputeFingerprint(const ComputeGraph& graph) const
+{
+    GraphFingerprint fp;
+    const auto& nodes = graph.GetNodes();
+    fp.nodeCount = nodes.size();
+    fp.edgeCount = graph.EdgeCount();
+
+    // 节点压缩为连续下标
+    std::map<ComputeNode::NodeId, size_t> index;
+    std::vector<uint64_t> labels;
+    labels.reserve(nodes.size());
+    for (const auto& [id, node] : nodes) {
+        index[id] = labels.size();
+        labels.push_back(InitialLabel(*node));
+    }
+
+    // 邻接：(邻居下标, 方向与边类型)
+    std::vector<std::vector<std::pair<size_t, uint64_t>>> adjacency(labels.size());
+    for (const auto& [edgeId, edge] : graph.GetEdges()) {
+        auto src = index.find(edge->sourceId);
+        auto tgt = index.find(edge->targetId);
+        if (src == index.end() || tgt == index.end()) continue;
+        uint64_t kind = static_cast<uint64_t>(edge->kind) << 1;
+        adjacency[src->second].emplace_back(tgt->second, kind);        // 出边
+        adjacency[tgt->second].emplace_back(src->second, kind | 1);    // 入边
+    }
+
+    for (uint64_t label : labels) {
+        fp.features[label]++;
+    }
+
+    std::vector<uint64_t> next(labels.size());
+    std::vector<uint64_t> neighborhood;
+    for (int round = 0; round < iterations; ++round) {
+        for (size_t v = 0; v < labels.size(); ++v) {
+            neighborhood.clear();
+            for (const auto& [u, tag] : adjacency[v]) {
+                neighborhood.push_back(Combine(tag, labels[u]));
+            }
+            std::sort(neighborhood.begin(), neighborhood.end());
+
+            uint64_t label = Combine(static_cast<uint64_t>(round) + 1, labels[v]);
+            for (uint64_t n : neighborhood) {
+                label = Combine(label, n);
+            }
+            next[v] = label;
+            fp.features[label]++;
+        }
+        labels.swap(next);
+    }
+
+    // 加权 MinHash：第k次出现的特征视为独立元素 (feature, k)
+    fp.minHash.assign(hashCount, std::numeric_limits<uint64_t>::max());
+    for (const auto& [feature, count] : fp.features) {
+        for (uint32_t k = 0; k < count; ++k) {
+            uint64_t element = Combine(feature, k);
+            for (size_t i = 0; i < hashCount; ++i) {
+                fp.minHash[i] = std::min(fp.minHash[i], Mix(element ^ seeds[i]));
+            }
+        }
+    }
+    return fp;
+}
+
+std::vector<uint64_t> GraphSimilarityIndex::BandKeys(const GraphFingerprint& fingerprint) const
+{
+    std::vector<uint64_t> keys;
+    keys.reserve(bandCount);
+    for (size_t band = 0; band < bandCount; ++band) {
+        uint64_t key = Mix(band);
+        for (size_t row = 0; row < rowsPerBand; ++row) {
+            key = Combine(key, fingerprint.minHash[band * rowsPerBand + row]);
+        }
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+size_t GraphSimilarityIndex::Add(const ComputeGraph& graph, const std::string& function,
+                                 const std::string& location)
+{
+    SimilarityEntry entry;
+    entry.graphName = graph.GetName();
+    entry.function = function;
+    entry.location = location;
+    entry.fingerprint = ComputeFingerprint(graph);
+
+    size_t idx = entries.size();
+    for (uint64_t key : BandKeys(entry.fingerprint)) {
+        buckets[key].push_back(idx);
+    }
+    entries.push_back(std::move(entry));
+    return idx;
+}
+
+double GraphSimilarityIndex::EstimateSimilarity(const GraphFingerprint& a, const GraphFingerprint& b)
+{
+    if (a.minHash.empty() || a.minHash.size() != b.minHash.size()) return 0.0;
+
+    size_t same = 0;
+    for (size_t i = 0; i < a.minHash.size(); ++i) {
+        if (a.minHash[i] == b.minHash[i]) same++;
+    }
+    return static_cast<double>(same) / static_cast<double>(a.minHash.size());
+}
+
+std::vector<std::pair<size_t, double>> GraphSimilarityIndex::Query(const ComputeGraph& graph,
+                                                                   double threshold) const
+{
+    GraphFingerprint fp = ComputeFingerprint(graph);
+
+    std::vector<size_t> candidates;
+    for (uint64_t key : BandKeys(fp)) {
+        auto it = buckets.find(key);
+        if (it != buckets.end()) {
+            candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    std::vector<std::pair<size_t, double>> result;
+    for (size_t idx : candidates) {
+        double sim = EstimateSimilarity(fp, entries[idx].fingerprint);
+        if (sim >= threshold) {
+            result.emplace_back(idx, sim);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    return result;
+}
+
+std::vector<SimilarityCluster> GraphSimilarityIndex::Cluster(double threshold) const
+{
+    // 同一桶里大量完全相同的图很常见：每个条目只和桶内少数几个已出现的簇根比较
+    constexpr size_t kMaxRootsPerBucket = 8;
+
+    UnionFind uf(entries.size());
+    for (const auto& [key, members] : buckets) {
+        std::vector<size_t> roots;
+        for (size_t idx : members) {
+            bool merged = false;
+            for (size_t root : roots) {
+                if (uf.Find(idx) == uf.Find(root)) {
+                    merged = true;
+                    break;
+                }
+                if (EstimateSimilarity(entries[idx].fingerprint, entries[root].fingerprint) >= threshold) {
+                    uf.Unite(idx, root);
+                    merged = true;
+                    break;
+                }
+            }
+            if (!merged && roots.size() < kMaxRootsPerBucket) {
+                roots.push_back(idx);
+            }
+        }
+    }
+
+    std::map<size_t, SimilarityCluster> byRoot;
+    for (size_t idx = 0; idx < entries.size(); ++idx) {
+        SimilarityCluster& cluster = byRoot[uf.Find(idx)];
+        cluster.members.push_back(idx);
+        if (cluster.members.size() > 1) {
+            double sim = EstimateSimilarity(entries[cluster.members.front()].fingerprint,
+                                            entries[idx].fingerprint);
+            cluster.minSimilarity = std::min(cluster.minSimilarity, sim);
+        }
+    }
+
+    std::vector<SimilarityCluster> clusters;
+    clusters.reserve(byRoot.size());
+    for (auto& [root, cluster] : byRoot) {
+        clusters.push_back(std::move(cluster));
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const auto& a, const auto& b) {
+        return a.members.size() > b.members.size();
+    });
+    return clusters;
+}
+
+} // namespace compute_graph
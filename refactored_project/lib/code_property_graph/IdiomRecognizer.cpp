@@ -0,0 +1,795 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * IdiomRecognizer.cpp - 归约/扫描/直方图/逐元素映射惯用法识别实现
+ *
+ * 以图中赋值/复合赋值/自增节点为候选，结合其AST与所在循环的归纳信息判定：
+ *   标量目标：s op= E、s = s op E、s = min(s, E)、s = E < s ? E : s、if (E > s) s = E
+ *   数组目标：out[i] = out[i-1] op E（扫描）、h[idx[i]] += E（直方图）、y[i] = f(x[i], ...)（映射）
+ */
+#include "IdiomRecognizer.h"
+
+#include "clang/AST/ParentMapContext.h"
+
+#include <algorithm>
+
+namespace compute_graph {
+
+namespace {
+
+const clang::Expr* Strip(const clang::Expr* expr)
+{
+    return expr ? expr->IgnoreParenCasts() : nullptr;
+}
+
+// 非指针标量变量（允许引用类型的累加器参数）
+const clang::VarDecl* GetScalarVar(const clang::Expr* expr)
+{
+    const auto* ref = llvm::dyn_cast_or_null<clang::DeclRefExpr>(Strip(expr));
+    if (!ref) return nullptr;
+    const auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl());
+    if (!var) return nullptr;
+    clang::QualType type = var->getType().getNonReferenceType();
+    return type->isScalarType() && !type->isPointerType() ? var : nullptr;
+}
+
+bool ContainsStmt(const clang::Stmt* outer, const clang::Stmt* inner)
+{
+    if (!outer) return false;
+    if (outer == inner) return true;
+    for (const auto* child : outer->children()) {
+        if (ContainsStmt(child, inner)) return true;
+    }
+    return false;
+}
+
+// 子树中是否有表达式满足谓词
+bool ContainsMatching(const clang::Stmt* stmt, const std::function<bool(const clang::Expr*)>& pred)
+{
+    if (!stmt) return false;
+    if (const auto* expr = llvm::dyn_cast<clang::Expr>(stmt)) {
+        if (pred(Strip(expr))) return true;
+    }
+    for (const auto* child : stmt->children()) {
+        if (ContainsMatching(child, pred)) return true;
+    }
+    return false;
+}
+
+void CollectVarRefs(const clang::Stmt* stmt, const clang::VarDecl* var,
+                    std::vector<const clang::DeclRefExpr*>& refs)
+{
+    if (!stmt) return;
+    if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(stmt)) {
+        if (ref->getDecl() == var) refs.push_back(ref);
+    }
+    for (const auto* child : stmt->children()) {
+        CollectVarRefs(child, var, refs);
+    }
+}
+
+bool HasSideEffectOps(const clang::Stmt* stmt)
+{
+    if (!stmt) return false;
+    if (const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(stmt)) {
+        if (binOp->isAssignmentOp()) return true;
+    }
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(stmt)) {
+        if (unaryOp->isIncrementDecrementOp()) return true;
+    }
+    for (const auto* child : stmt->children()) {
+        if (HasSideEffectOps(child)) return true;
+    }
+    return false;
+}
+
+// 从内存读取的标量：a[i]、*p，以及对它们的单参数转换调用（如 GGML_BF16_TO_FP32(x[i])）
+bool IsLoadOperand(const clang::Expr* expr)
+{
+    expr = Strip(expr);
+    if (!expr) return false;
+    if (const auto* access = llvm::dyn_cast<clang::ArraySubscriptExpr>(expr)) {
+        return !access->getType()->isArrayType();
+    }
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(expr)) {
+        return unaryOp->getOpcode() == clang::UO_Deref;
+    }
+    if (const auto* call = llvm::dyn_cast<clang::CallExpr>(expr)) {
+        return call->getNumArgs() == 1 && IsLoadOperand(call->getArg(0));
+    }
+    return false;
+}
+
+bool IsMulOfLoads(const clang::Expr* expr)
+{
+    const auto* binOp = llvm::dyn_cast_or_null<clang::BinaryOperator>(Strip(expr));
+    return binOp && binOp->getOpcode() == clang::BO_Mul &&
+           IsLoadOperand(binOp->getLHS()) && IsLoadOperand(binOp->getRHS());
+}
+
+// 沿同族运算（+/- 或 *）遍历，要求恰好一个累加器叶子；累加器位于减号右侧时不是归约
+bool WalkChain(const clang::Expr* expr, bool additive,
+               const std::function<bool(const clang::Expr*)>& isAccumulator,
+               std::vector<const clang::Expr*>& others, bool& found)
+{
+    const clang::Expr* stripped = Strip(expr);
+    if (isAccumulator(stripped)) {
+        if (found) return false;
+        found = true;
+        return true;
+    }
+
+    const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(stripped);
+    bool sameFamily = binOp && (additive ?
+        (binOp->getOpcode() == clang::BO_Add || binOp->getOpcode() == clang::BO_Sub) :
+        binOp->getOpcode() == clang::BO_Mul);
+    if (!sameFamily) {
+        others.push_back(stripped);
+        return true;
+    }
+
+    if (!WalkChain(binOp->getLHS(), additive, isAccumulator, others, found)) return false;
+    bool foundBefore = found;
+    if (!WalkChain(binOp->getRHS(), additive, isAccumulator, others, found)) return false;
+    return !(binOp->getOpcode() == clang::BO_Sub && !foundBefore && found);
+}
+
+clang::BinaryOperatorKind FlipRelational(clang::BinaryOperatorKind op)
+{
+    switch (op) {
+        case clang::BO_LT: return clang::BO_GT;
+        case clang::BO_LE: return clang::BO_GE;
+        case clang::BO_GT: return clang::BO_LT;
+        case clang::BO_GE: return clang::BO_LE;
+        default: return op;
+    }
+}
+
+bool IsMinMaxCallee(const std::string& name, bool& isMin)
+{
+    static const char* const kMinNames[] = {"min", "fmin", "fminf", "fminl"};
+    static const char* const kMaxNames[] = {"max", "fmax", "fmaxf", "fmaxl"};
+    for (const char* candidate : kMinNames) {
+        if (name == candidate) {
+            isMin = true;
+            return true;
+        }
+    }
+    for (const char* candidate : kMaxNames) {
+        if (name == candidate) {
+            isMin = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool IsReductionKind(IdiomKind kind)
+{
+    return (IdiomBit(kind) & kReductionIdiomMask) != 0;
+}
+
+std::string ReductionOpName(const std::string& op)
+{
+    if (op == "+") return "sum";
+    if (op == "*") return "product";
+    return op;
+}
+
+// 按运算与元素类型填写代数性质；min/max 在浮点上同样满足结合与交换律
+void FillAlgebra(IdiomMatch& match, bool isFloat)
+{
+    bool arithmetic = match.op == "+" || match.op == "*";
+    bool minMax = match.op == "min" || match.op == "max";
+    if (arithmetic) {
+        match.isCommutative = true;
+        match.isAssociative = !isFloat;
+    } else if (minMax) {
+        match.isCommutative = true;
+        match.isAssociative = true;
+    }
+
+    switch (match.kind) {
+        case IdiomKind::SumReduction:
+        case IdiomKind::ProductReduction:
+        case IdiomKind::MinReduction:
+        case IdiomKind::MaxReduction:
+        case IdiomKind::DotProduct:
+        case IdiomKind::Histogram:
+            match.requiresAssociativity = true;
+            match.requiresCommutativity = true;
+            break;
+        case IdiomKind::PrefixScan:
+            match.requiresAssociativity = true;
+            break;
+        default:
+            break;
+    }
+    match.needsFPReassociation = match.requiresAssociativity && arithmetic && isFloat;
+}
+
+bool IsFloatType(clang::QualType type)
+{
+    type = type.getNonReferenceType().getCanonicalType();
+    return type->isRealFloatingType();
+}
+
+} // namespace
+
+const char* IdiomKindToString(IdiomKind kind)
+{
+    switch (kind) {
+        case IdiomKind::SumReduction: return "sum";
+        case IdiomKind::ProductReduction: return "product";
+        case IdiomKind::MinReduction: return "min";
+        case IdiomKind::MaxReduction: return "max";
+        case IdiomKind::DotProduct: return "dot";
+        case IdiomKind::PrefixScan: return "scan";
+        case IdiomKind::Histogram: return "histogram";
+        case IdiomKind::ElementwiseMap: return "map";
+        default: return "none";
+    }
+}
+
+std::string IdiomMatch::ToString() const
+{
+    std::string result = std::string(IdiomKindToString(kind)) + "(" + variable + ")";
+    if (!op.empty()) result += " op=" + op;
+    if (!subtype.empty()) result += " " + subtype;
+    if (requiresAssociativity || requiresCommutativity) {
+        result += std::string(" assoc=") + (isAssociative ? "yes" : "no");
+        result += std::string(" comm=") + (isCommutative ? "yes" : "no");
+    }
+    if (needsFPReassociation) result += " fp-reassoc";
+    if (needsConflictDetection) result += " conflict-detect";
+    if (sourceLine > 0) result += " @line " + std::to_string(sourceLine);
+    return result;
+}
+
+IdiomRecognizer::IdiomRecognizer(clang::ASTContext& ctx, LoopInductionAnalysis& induction)
+    : astContext(ctx), inductionAnalysis(induction)
+{}
+
+// ============================================
+// 通用判定
+// ============================================
+
+bool IdiomRecognizer::SameExpr(const clang::Expr* a, const clang::Expr* b) const
+{
+    if (!a || !b) return false;
+    std::string textA = GetSourceText(Strip(a), astContext);
+    return !textA.empty() && textA == GetSourceText(Strip(b), astContext);
+}
+
+std::string IdiomRecognizer::GetBaseText(const clang::ArraySubscriptExpr* access) const
+{
+    const clang::Expr* base = access->getBase()->IgnoreParenImpCasts();
+    while (const auto* inner = llvm::dyn_cast<clang::ArraySubscriptExpr>(base)) {
+        base = inner->getBase()->IgnoreParenImpCasts();
+    }
+    return GetSourceText(base, astContext);
+}
+
+bool IdiomRecognizer::IsInvariantExpr(const clang::Expr* expr, const LoopInductionInfo& loop) const
+{
+    expr = Strip(expr);
+    if (!expr) return true;
+    if (llvm::isa<clang::ArraySubscriptExpr>(expr) || llvm::isa<clang::CallExpr>(expr)) {
+        return false;
+    }
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(expr)) {
+        if (unaryOp->getOpcode() == clang::UO_Deref || unaryOp->isIncrementDecrementOp()) {
+            return false;
+        }
+    }
+    if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(expr)) {
+        const auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl());
+        return !var || (!loop.Find(var) && !loop.variantVars.count(var) &&
+                        !loop.bodyDefinitions.count(var));
+    }
+    for (const auto* child : expr->children()) {
+        const auto* childExpr = llvm::dyn_cast_or_null<clang::Expr>(child);
+        if (childExpr && !IsInvariantExpr(childExpr, loop)) return false;
+    }
+    return true;
+}
+
+IdiomKind IdiomRecognizer::ClassifyChain(const clang::Expr* expr,
+                                         const ExprPredicate& isAccumulator,
+                                         std::vector<const clang::Expr*>& addends) const
+{
+    const auto* binOp = llvm::dyn_cast_or_null<clang::BinaryOperator>(Strip(expr));
+    if (!binOp) return IdiomKind::None;
+
+    bool additive = binOp->getOpcode() == clang::BO_Add || binOp->getOpcode() == clang::BO_Sub;
+    if (!additive && binOp->getOpcode() != clang::BO_Mul) return IdiomKind::None;
+
+    std::vector<const clang::Expr*> others;
+    bool found = false;
+    if (!WalkChain(binOp, additive, isAccumulator, others, found) || !found || others.empty()) {
+        return IdiomKind::None;
+    }
+    for (const auto* other : others) {
+        if (ContainsMatching(other, isAccumulator)) return IdiomKind::None;
+    }
+    addends = std::move(others);
+    return additive ? IdiomKind::SumReduction : IdiomKind::ProductReduction;
+}
+
+IdiomKind IdiomRecognizer::ClassifyMinMax(const clang::Expr* cond, const clang::Expr* picked,
+                                          const ExprPredicate& isAccumulator) const
+{
+    const auto* cmp = llvm::dyn_cast_or_null<clang::BinaryOperator>(Strip(cond));
+    if (!cmp || !cmp->isRelationalOp()) return IdiomKind::None;
+
+    bool accLeft = isAccumulator(Strip(cmp->getLHS()));
+    bool accRight = isAccumulator(Strip(cmp->getRHS()));
+    if (accLeft == accRight) return IdiomKind::None;
+
+    const clang::Expr* other = accLeft ? cmp->getRHS() : cmp->getLHS();
+    if (ContainsMatching(other, isAccumulator)) return IdiomKind::None;
+
+    // 归一化为 "E op s"
+    clang::BinaryOperatorKind op = accLeft ? FlipRelational(cmp->getOpcode()) : cmp->getOpcode();
+    bool otherLess = op == clang::BO_LT || op == clang::BO_LE;
+
+    bool picksOther;
+    if (isAccumulator(Strip(picked))) {
+        picksOther = false;
+    } else if (SameExpr(picked, other)) {
+        picksOther = true;
+    } else {
+        return IdiomKind::None;
+    }
+    // E < s 时取 E 为 min；E > s 时取 E 为 max
+    return otherLess == picksOther ? IdiomKind::MinReduction : IdiomKind::MaxReduction;
+}
+
+bool IdiomRecognizer::CheckAccumulatorUses(const clang::VarDecl* var, const clang::Stmt* loopStmt,
+                                           const clang::Stmt* update, const clang::Stmt* guard,
+                                           bool& storedToArray) const
+{
+    std::vector<const clang::DeclRefExpr*> refs;
+    CollectVarRefs(loopStmt, var, refs);
+
+    const auto* guardIf = llvm::dyn_cast_or_null<clang::IfStmt>(guard);
+    for (const auto* ref : refs) {
+        if (ContainsStmt(update, ref)) continue;
+        if (guardIf && ContainsStmt(guardIf->getCond(), ref)) continue;
+
+        // 唯一允许的其他用法：out[k] = s（前缀扫描的逐次写出）
+        const clang::Stmt* cursor = ref;
+        auto parents = astContext.getParents(*cursor);
+        while (!parents.empty()) {
+            const auto* parent = parents[0].get<clang::Stmt>();
+            if (!parent || !(llvm::isa<clang::ImplicitCastExpr>(parent) ||
+                             llvm::isa<clang::ParenExpr>(parent) ||
+                             llvm::isa<clang::CStyleCastExpr>(parent))) {
+                break;
+            }
+            cursor = parent;
+            parents = astContext.getParents(*cursor);
+        }
+        const auto* store = parents.empty() ? nullptr :
+            parents[0].get<clang::BinaryOperator>();
+        if (store && store->getOpcode() == clang::BO_Assign && store->getRHS() == cursor &&
+            llvm::isa<clang::ArraySubscriptExpr>(Strip(store->getLHS()))) {
+            storedToArray = true;
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool IdiomRecognizer::HasOtherArrayRefs(const clang::Stmt* loopStmt, const clang::Stmt* update,
+                                        const std::string& baseText) const
+{
+    std::function<bool(const clang::Stmt*)> visit = [&](const clang::Stmt* stmt) {
+        if (!stmt || stmt == update) return false;
+        if (const auto* access = llvm::dyn_cast<clang::ArraySubscriptExpr>(stmt)) {
+            if (!access->getType()->isArrayType() && GetBaseText(access) == baseText) return true;
+        }
+        for (const auto* child : stmt->children()) {
+            if (visit(child)) return true;
+        }
+        return false;
+    };
+    return visit(loopStmt);
+}
+
+void IdiomRecognizer::CollectNodes(const ComputeGraph& graph, const clang::Stmt* stmt,
+                                   std::set<ComputeNode::NodeId>& nodes) const
+{
+    if (!stmt) return;
+    if (auto node = graph.FindNodeByStmt(stmt)) {
+        nodes.insert(node->id);
+    }
+    for (const auto* child : stmt->children()) {
+        CollectNodes(graph, child, nodes);
+    }
+}
+
+// ============================================
+// 标量累加器
+// ============================================
+
+bool IdiomRecognizer::MatchScalarUpdate(const ComputeGraph& graph, const clang::Stmt* update,
+                                        const clang::Stmt* loopStmt, IdiomMatch& match)
+{
+    const clang::VarDecl* var = nullptr;
+    const clang::Stmt* guard = nullptr;
+    IdiomKind kind = IdiomKind::None;
+    std::vector<const clang::Expr*> addends;
+
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(update)) {
+        var = GetScalarVar(unaryOp->getSubExpr());
+        kind = IdiomKind::SumReduction;
+    } else if (const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(update)) {
+        var = GetScalarVar(binOp->getLHS());
+        if (!var) return false;
+
+        ExprPredicate isAccumulator = [var](const clang::Expr* expr) {
+            const auto* ref = llvm::dyn_cast_or_null<clang::DeclRefExpr>(Strip(expr));
+            return ref && ref->getDecl() == var;
+        };
+        const clang::Expr* rhs = Strip(binOp->getRHS());
+
+        if (binOp->isCompoundAssignmentOp()) {
+            if (ContainsMatching(rhs, isAccumulator)) return false;
+            if (binOp->getOpcode() == clang::BO_AddAssign ||
+                binOp->getOpcode() == clang::BO_SubAssign) {
+                kind = IdiomKind::SumReduction;
+                addends.push_back(rhs);
+            } else if (binOp->getOpcode() == clang::BO_MulAssign) {
+                kind = IdiomKind::ProductReduction;
+            }
+        } else if (llvm::isa<clang::BinaryOperator>(rhs)) {
+            // s = s + E / s = E * s
+            kind = ClassifyChain(rhs, isAccumulator, addends);
+        } else if (const auto* cond = llvm::dyn_cast<clang::ConditionalOperator>(rhs)) {
+            bool trueAcc = isAccumulator(Strip(cond->getTrueExpr()));
+            bool falseAcc = isAccumulator(Strip(cond->getFalseExpr()));
+            const clang::Expr* other = trueAcc ? cond->getFalseExpr() : cond->getTrueExpr();
+            if (trueAcc != falseAcc && !ContainsMatching(other, isAccumulator)) {
+                kind = ClassifyMinMax(cond->getCond(), cond->getTrueExpr(), isAccumulator);
+            }
+        } else if (const auto* call = llvm::dyn_cast<clang::CallExpr>(rhs)) {
+            const auto* callee = call->getDirectCallee();
+            bool isMin = false;
+            if (callee && call->getNumArgs() == 2 &&
+                IsMinMaxCallee(callee->getNameAsString(), isMin)) {
+                bool acc0 = isAccumulator(Strip(call->getArg(0)));
+                bool acc1 = isAccumulator(Strip(call->getArg(1)));
+                const clang::Expr* other = acc0 ? call->getArg(1) : call->getArg(0);
+                if (acc0 != acc1 && !ContainsMatching(other, isAccumulator)) {
+                    kind = isMin ? IdiomKind::MinReduction : IdiomKind::MaxReduction;
+                }
+            }
+        } else if (!ContainsMatching(rhs, isAccumulator)) {
+            // if (E > s) { s = E; [idx = i;] }
+            const clang::Stmt* cursor = binOp;
+            auto parents = astContext.getParents(*cursor);
+            if (!parents.empty()) {
+                if (const auto* block = parents[0].get<clang::CompoundStmt>()) {
+                    cursor = block;
+                    parents = astContext.getParents(*cursor);
+                }
+            }
+            const auto* ifStmt = parents.empty() ? nullptr : parents[0].get<clang::IfStmt>();
+            if (ifStmt && ifStmt->getThen() == cursor && !ifStmt->getElse()) {
+                kind = ClassifyMinMax(ifStmt->getCond(), rhs, isAccumulator);
+                guard = ifStmt;
+                const auto* block = llvm::dyn_cast<clang::CompoundStmt>(cursor);
+                if (kind != IdiomKind::None && block && block->size() > 1) {
+                    match.subtype = kind == IdiomKind::MinReduction ? "argmin" : "argmax";
+                }
+            }
+        }
+    }
+
+    if (!var || kind == IdiomKind::None) return false;
+
+    // 累加器必须在循环外声明，且不能是归纳变量
+    const auto& sm = astContext.getSourceManager();
+    if (!sm.isBeforeInTranslationUnit(var->getLocation(), loopStmt->getBeginLoc())) return false;
+    if (inductionAnalysis.Analyze(loopStmt).Find(var)) return false;
+
+    bool storedToArray = false;
+    if (!CheckAccumulatorUses(var, loopStmt, update, guard, storedToArray)) return false;
+
+    switch (kind) {
+        case IdiomKind::SumReduction: match.op = "+"; break;
+        case IdiomKind::ProductReduction: match.op = "*"; break;
+        case IdiomKind::MinReduction: match.op = "min"; break;
+        case IdiomKind::MaxReduction: match.op = "max"; break;
+        default: break;
+    }
+    if (kind == IdiomKind::SumReduction &&
+        std::any_of(addends.begin(), addends.end(), IsMulOfLoads)) {
+        kind = IdiomKind::DotProduct;
+    }
+    if (storedToArray) {
+        kind = IdiomKind::PrefixScan;
+        match.subtype.clear();
+    }
+
+    match.kind = kind;
+    match.variable = var->getNameAsString();
+    FillAlgebra(match, IsFloatType(var->getType()));
+    CollectNodes(graph, update, match.nodes);
+    if (const auto* guardIf = llvm::dyn_cast_or_null<clang::IfStmt>(guard)) {
+        CollectNodes(graph, guardIf->getCond(), match.nodes);
+    }
+    return true;
+}
+
+// ============================================
+// 数组目标
+// ============================================
+
+std::string IdiomRecognizer::ClassifyMapUpdate(const clang::Expr* rhs,
+                                               const LoopInductionInfo& loop, bool compound) const
+{
+    // a * x[i] 或 x[i] * a
+    auto isScaled = [&](const clang::Expr* expr) {
+        const auto* mul = llvm::dyn_cast_or_null<clang::BinaryOperator>(Strip(expr));
+        if (!mul || mul->getOpcode() != clang::BO_Mul) return false;
+        return (IsInvariantExpr(mul->getLHS(), loop) && IsLoadOperand(mul->getRHS())) ||
+               (IsLoadOperand(mul->getLHS()) && IsInvariantExpr(mul->getRHS(), loop));
+    };
+
+    const clang::Expr* expr = Strip(rhs);
+    if (compound) {
+        return isScaled(expr) ? "saxpy" : "map";
+    }
+    if (IsLoadOperand(expr)) return "copy";
+    if (isScaled(expr)) return "scale";
+    if (const auto* add = llvm::dyn_cast<clang::BinaryOperator>(expr)) {
+        if (add->getOpcode() == clang::BO_Add) {
+            bool lhsScaled = isScaled(add->getLHS());
+            bool rhsScaled = isScaled(add->getRHS());
+            if (lhsScaled && rhsScaled) return "axpby";
+            if ((lhsScaled && IsLoadOperand(add->getRHS())) ||
+                (rhsScaled && IsLoadOperand(add->getLHS()))) {
+                return "saxpy";
+            }
+        }
+    }
+    return "map";
+}
+
+bool IdiomRecognizer::MatchArrayUpdate(const ComputeGraph& graph, const clang::Stmt* update,
+                                       const clang::ArraySubscriptExpr* target,
+                                       const clang::Stmt* loopStmt, IdiomMatch& match)
+{
+    const LoopInductionInfo& info = inductionAnalysis.Analyze(loopStmt);
+    AffineIndex index = inductionAnalysis.AnalyzeIndex(target, info);
+    std::string baseText = GetBaseText(target);
+    if (baseText.empty()) return false;
+
+    const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(update);
+    const clang::Expr* rhs = binOp ? Strip(binOp->getRHS()) : nullptr;
+    bool isFloat = IsFloatType(target->getType());
+
+    // 同一元素上的累加：h[k] += E、h[k]++、h[k] = h[k] + E
+    bool additiveUpdate = !binOp ||
+        binOp->getOpcode() == clang::BO_AddAssign || binOp->getOpcode() == clang::BO_SubAssign;
+    std::vector<const clang::Expr*> addends;
+    if (binOp && binOp->getOpcode() == clang::BO_Assign) {
+        ExprPredicate sameElement = [&](const clang::Expr* expr) {
+            return llvm::isa<clang::ArraySubscriptExpr>(expr) && SameExpr(expr, target);
+        };
+        additiveUpdate = ClassifyChain(rhs, sameElement, addends) == IdiomKind::SumReduction;
+    } else if (binOp && additiveUpdate) {
+        addends.push_back(rhs);
+    }
+
+    // 非仿射下标上的累加：直方图
+    if (additiveUpdate && !index.isAffine) {
+        match.kind = IdiomKind::Histogram;
+        match.op = "+";
+        match.needsConflictDetection = true;
+    } else if (additiveUpdate && index.hasConstStride && index.iterationStride == 0) {
+        // 循环内固定元素上的累加，等价于标量归约
+        if (HasOtherArrayRefs(loopStmt, update, baseText)) return false;
+        match.kind = std::any_of(addends.begin(), addends.end(), IsMulOfLoads) ?
+            IdiomKind::DotProduct : IdiomKind::SumReduction;
+        match.op = "+";
+    } else if (index.isAffine && index.hasConstStride && index.iterationStride != 0 && binOp) {
+        // 前一次迭代写入的元素：out[i-1]
+        ExprPredicate previousElement = [&](const clang::Expr* expr) {
+            const auto* access = llvm::dyn_cast<clang::ArraySubscriptExpr>(expr);
+            if (!access || access == target || access->getType()->isArrayType() ||
+                GetBaseText(access) != baseText) {
+                return false;
+            }
+            AffineIndex prev = inductionAnalysis.AnalyzeIndex(access, info);
+            return prev.isAffine && prev.hasConstStride && prev.base == index.base &&
+                   prev.stride == index.stride &&
+                   prev.offset == index.offset - index.iterationStride;
+        };
+
+        IdiomKind chain = IdiomKind::None;
+        if (binOp->getOpcode() == clang::BO_Assign) {
+            chain = ClassifyChain(rhs, previousElement, addends);
+        } else if (binOp->getOpcode() == clang::BO_AddAssign && previousElement(rhs)) {
+            chain = IdiomKind::SumReduction;
+        }
+
+        if (chain != IdiomKind::None) {
+            match.kind = IdiomKind::PrefixScan;
+            match.op = chain == IdiomKind::SumReduction ? "+" : "*";
+        } else {
+            // 逐元素映射：不读同一数组的其他元素，且不处在流依赖环上
+            bool compound = binOp->isCompoundAssignmentOp();
+            if (HasSideEffectOps(rhs)) return false;
+            ExprPredicate otherElement = [&](const clang::Expr* expr) {
+                const auto* access = llvm::dyn_cast<clang::ArraySubscriptExpr>(expr);
+                return access && !access->getType()->isArrayType() &&
+                       GetBaseText(access) == baseText && !SameExpr(access, target);
+            };
+            if (ContainsMatching(rhs, otherElement)) return false;
+            if (auto targetNode = graph.FindNodeByStmt(target)) {
+                for (const auto& edge : graph.GetIncomingEdges(targetNode->id)) {
+                    if (edge->kind == ComputeEdgeKind::LoopCarried &&
+                        edge->properties.count("dep_kind") &&
+                        edge->properties.at("dep_kind") == "flow") {
+                        return false;
+                    }
+                }
+            }
+            match.kind = IdiomKind::ElementwiseMap;
+            match.subtype = ClassifyMapUpdate(rhs, info, compound);
+        }
+    } else {
+        return false;
+    }
+
+    match.variable = baseText;
+    FillAlgebra(match, isFloat);
+    CollectNodes(graph, update, match.nodes);
+    return true;
+}
+
+// ============================================
+// 手工构建的图（无AST，按 reduction_op / is_accumulator 标注识别）
+// ============================================
+
+bool IdiomRecognizer::MatchHandBuilt(const ComputeGraph& graph, const ComputeNode& node,
+                                     IdiomMatch& match)
+{
+    std::string reductionOp = node.GetProperty("reduction_op");
+    if (reductionOp == "sum" || reductionOp == "add") {
+        match.kind = IdiomKind::SumReduction;
+        match.op = "+";
+    } else if (reductionOp == "product" || reductionOp == "mul") {
+        match.kind = IdiomKind::ProductReduction;
+        match.op = "*";
+    } else if (reductionOp == "min" || reductionOp == "max") {
+        match.kind = reductionOp == "min" ? IdiomKind::MinReduction : IdiomKind::MaxReduction;
+        match.op = reductionOp;
+    } else {
+        return false;
+    }
+
+    match.updateNodeId = node.id;
+    match.variable = node.name;
+    match.sourceLine = node.sourceLine;
+    match.nodes.insert(node.id);
+    for (const auto& edge : graph.GetIncomingEdges(node.id)) {
+        auto source = graph.GetNode(edge->sourceId);
+        if (!source) continue;
+        match.nodes.insert(source->id);
+        if (source->GetProperty("is_accumulator") == "true") {
+            match.targetNodeId = source->id;
+            match.variable = source->name;
+        } else if (match.kind == IdiomKind::SumReduction &&
+                   source->kind == ComputeNodeKind::BinaryOp && source->opCode == OpCode::Mul) {
+            match.kind = IdiomKind::DotProduct;
+        }
+    }
+    FillAlgebra(match, node.dataType.IsFloatingPoint());
+    return true;
+}
+
+// ============================================
+// 识别与标注
+// ============================================
+
+std::vector<IdiomMatch> IdiomRecognizer::Recognize(const ComputeGraph& graph)
+{
+    std::vector<IdiomMatch> matches;
+    std::set<const clang::Stmt*> visited;
+
+    for (const auto& node : graph.GetAllNodes()) {
+        IdiomMatch match;
+        const clang::Stmt* stmt = node->astStmt;
+        if (!stmt) {
+            if (MatchHandBuilt(graph, *node, match)) {
+                matches.push_back(std::move(match));
+            }
+            continue;
+        }
+
+        const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(stmt);
+        const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(stmt);
+        bool isUpdate = (binOp && binOp->isAssignmentOp()) ||
+                        (unaryOp && unaryOp->isIncrementDecrementOp());
+        if (!isUpdate || !visited.insert(stmt).second) continue;
+
+        const clang::Stmt* loopStmt = inductionAnalysis.FindEnclosingLoop(stmt);
+        if (!loopStmt) continue;
+        // for 头部的初始化/条件/步进不是循环体内的计算
+        if (const auto* forStmt = llvm::dyn_cast<clang::ForStmt>(loopStmt)) {
+            if (!ContainsStmt(forStmt->getBody(), stmt)) continue;
+        }
+
+        const clang::Expr* lhs = binOp ? binOp->getLHS() : unaryOp->getSubExpr();
+        const auto* target = llvm::dyn_cast<clang::ArraySubscriptExpr>(lhs->IgnoreParens());
+        bool matched = target ?
+            MatchArrayUpdate(graph, stmt, target, loopStmt, match) :
+            MatchScalarUpdate(graph, stmt, loopStmt, match);
+        if (!matched) continue;
+
+        match.updateNodeId = node->id;
+        match.sourceLine = node->sourceLine > 0 ? node->sourceLine : GetSourceLine(stmt, astContext);
+        for (const auto& edge : graph.GetOutgoingEdges(node->id)) {
+            if (edge->label == "assign_to") {
+                match.targetNodeId = edge->targetId;
+                break;
+            }
+        }
+        if (match.targetNodeId == 0) {
+            if (auto targetNode = graph.FindNodeByStmt(lhs->IgnoreParenImpCasts())) {
+                match.targetNodeId = targetNode->id;
+            }
+        }
+        matches.push_back(std::move(match));
+    }
+    return matches;
+}
+
+void IdiomRecognizer::Annotate(ComputeGraph& graph)
+{
+    std::vector<IdiomMatch> matches = Recognize(graph);
+
+    unsigned mask = 0;
+    std::string idioms;
+    bool fpReassociation = false;
+    for (const auto& match : matches) {
+        mask |= IdiomBit(match.kind);
+        fpReassociation = fpReassociation || match.needsFPReassociation;
+
+        std::string item = std::string(IdiomKindToString(match.kind)) + "(" + match.variable + ")";
+        if (("," + idioms + ",").find("," + item + ",") == std::string::npos) {
+            idioms += idioms.empty() ? item : "," + item;
+        }
+
+        if (auto update = graph.GetNode(match.updateNodeId)) {
+            update->SetProperty("idiom", IdiomKindToString(match.kind));
+            if (!match.op.empty()) update->SetProperty("idiom_op", match.op);
+            if (!match.subtype.empty()) update->SetProperty("idiom_subtype", match.subtype);
+            if (IsReductionKind(match.kind)) {
+                update->SetProperty("is_reduction", "true");
+                update->SetProperty("reduction_op", ReductionOpName(match.op));
+            }
+            if (match.needsFPReassociation) update->SetProperty("idiom_fp_reassoc", "true");
+            if (match.needsConflictDetection) update->SetProperty("needs_conflict_detection", "true");
+        }
+        if (auto target = graph.GetNode(match.targetNodeId)) {
+            if (IsReductionKind(match.kind) || match.kind == IdiomKind::PrefixScan) {
+                target->SetProperty("is_accumulator", "true");
+            }
+        }
+    }
+
+    graph.SetIdiomMask(mask);
+    if (mask == 0) return;
+
+    graph.SetProperty("idioms", idioms);
+    graph.SetProperty("idiom_mask", std::to_string(mask));
+    graph.SetProperty("has_reduction", (mask & kReductionIdiomMask) ? "true" : "false");
+    graph.SetProperty("fp_reassociation", fpReassociation ? "true" : "false");
+}
+
+} // namespace compute_graph
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * IntrinsicSemantics.cpp - SIMD intrinsic 语义数据库（展开 IntrinsicSemantics.def）
+ */
+#include "IntrinsicSemantics.h"
+
+#include "llvm/ADT/SmallVector.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+namespace compute_graph {
+
+namespace {
+
+using BaseType = DataTypeInfo::BaseType;
+
+DataTypeInfo MakeLaneType(BaseType base, int bits, bool isSigned)
+{
+    DataTypeInfo info;
+    info.baseType = base;
+    info.bitWidth = bits;
+    info.isSigned = isSigned;
+    return info;
+}
+
+// NEON/SVE 类型后缀：s8..s64 / u8..u64 / f16 f32 f64 / bf16 / b[N]（谓词）
+bool DecodeArmType(llvm::StringRef token, DataTypeInfo& info)
+{
+    int bits = 0;
+    if (token == "b") {
+        info = MakeLaneType(BaseType::Predicate, 8, false);
+        return true;
+    }
+    if (token.consume_front("bf")) {
+        if (token != "16") return false;
+        info = MakeLaneType(BaseType::BFloat16, 16, true);
+        return true;
+    }
+
+    char prefix = token.empty() ? '\0' : token.front();
+    if (token.drop_front().getAsInteger(10, bits)) {
+        return false;
+    }
+
+    static const BaseType kSigned[] = {BaseType::Int8, BaseType::Int16, BaseType::Int32, BaseType::Int64};
+    static const BaseType kUnsigned[] = {BaseType::UInt8, BaseType::UInt16, BaseType::UInt32, BaseType::UInt64};
+    int idx = bits == 8 ? 0 : bits == 16 ? 1 : bits == 32 ? 2 : bits == 64 ? 3 : -1;
+    if (idx < 0) return false;
+
+    switch (prefix) {
+        case 's':
+            info = MakeLaneType(kSigned[idx], bits, true);
+            return true;
+        case 'u':
+            info = MakeLaneType(kUnsigned[idx], bits, false);
+            return true;
+        case 'f':
+            if (bits == 8) return false;
+            info = MakeLaneType(bits == 16 ? BaseType::Float16 :
+                                bits == 32 ? BaseType::Float : BaseType::Double, bits, true);
+            return true;
+        case 'b':
+            // 谓词按元素位宽区分lane数
+            info = MakeLaneType(BaseType::Predicate, bits, false);
+            return true;
+        default:
+            return false;
+    }
+}
+
+// x86 类型后缀：ps pd ph pbh ss sd / epiN epuN / siN
+bool DecodeX86Type(llvm::StringRef token, DataTypeInfo& info)
+{
+    if (token == "ps" || token == "ss") {
+        info = MakeLaneType(BaseType::Float, 32, true);
+    } else if (token == "pd" || token == "sd") {
+        info = MakeLaneType(BaseType::Double, 64, true);
+    } else if (token == "ph") {
+        info = MakeLaneType(BaseType::Float16, 16, true);
+    } else if (token == "pbh") {
+        info = MakeLaneType(BaseType::BFloat16, 16, true);
+    } else if (token.startswith("si")) {
+        // 整向量按32位lane记录
+        info = MakeLaneType(BaseType::Int32, 32, true);
+    } else {
+        bool isSigned = token.consume_front("epi");
+        if (!isSigned && !token.consume_front("epu")) return false;
+        DataTypeInfo tmp;
+        if (!DecodeArmType((isSigned ? "s" : "u") + token.str(), tmp)) return false;
+        info = tmp;
+    }
+    return true;
+}
+
+// "f32_s32" / "s32offset_f32"：取第一个能完整解析的部分作为结果类型
+bool DecodeResultType(llvm::StringRef token, bool isX86, DataTypeInfo& info)
+{
+    llvm::SmallVector<llvm::StringRef, 4> parts;
+    token.split(parts, '_');
+    for (llvm::StringRef part : parts) {
+        if (isX86 ? DecodeX86Type(part, info) : DecodeArmType(part, info)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 【新增】"epi16>epi32"：'>' 前为名字后缀（操作数类型），后为结果类型；无 '>' 时二者相同
+bool DecodeTypeToken(llvm::StringRef token, bool isX86, llvm::StringRef& suffix,
+                     DataTypeInfo& lane, DataTypeInfo& result)
+{
+    llvm::StringRef resultToken;
+    std::tie(suffix, resultToken) = token.split('>');
+    if (!DecodeResultType(suffix, isX86, lane)) return false;
+    if (resultToken.empty()) {
+        result = lane;
+        return true;
+    }
+    return DecodeResultType(resultToken, isX86, result);
+}
+
+void ApplyLanes(DataTypeInfo& info, int widthBits, bool scalable)
+{
+    if (info.baseType == BaseType::Predicate) {
+        // 谓词每个元素1位，lane数 = 128 / 元素位宽
+        info.vectorWidth = std::max(1, widthBits / info.bitWidth);
+        info.bitWidth = 1;
+    } else {
+        info.vectorWidth = std::max(1, widthBits / std::max(1, info.bitWidth));
+    }
+    info.totalBitWidth = info.bitWidth * info.vectorWidth;
+    info.isScalable = scalable;
+}
+
+} // namespace
+
+// ============================================
+// 构建
+// ============================================
+
+const IntrinsicSemanticsDB& IntrinsicSemanticsDB::Instance()
+{
+    static const IntrinsicSemanticsDB db;
+    return db;
+}
+
+IntrinsicSemanticsDB::IntrinsicSemanticsDB()
+{
+#define NEON_OP(Stem, Op, Mem, Types, LatN2, TpN2, LatV1, TpV1) \
+    AddNeon(Stem, OpCode::Op, IntrinsicMemKind::Mem, Types, {LatN2, TpN2}, {LatV1, TpV1});
+#define SVE_OP(Stem, Op, Mem, Types, LatN2, TpN2, LatV1, TpV1) \
+    AddSve(Stem, OpCode::Op, IntrinsicMemKind::Mem, Types, {LatN2, TpN2}, {LatV1, TpV1});
+#define X86_OP(Stem, Op, Mem, Types, LatSKX, TpSKX, LatZen4, TpZen4) \
+    AddX86(Stem, OpCode::Op, IntrinsicMemKind::Mem, Types, {LatSKX, TpSKX}, {LatZen4, TpZen4});
+#define INTRINSIC(Name, Isa, Op, Mem, Type, Width, Lat0, Tp0, Lat1, Tp1) \
+    AddExplicit(Name, IntrinsicISA::Isa, OpCode::Op, IntrinsicMemKind::Mem, Type, Width, \
+                {Lat0, Tp0}, {Lat1, Tp1});
+#include "IntrinsicSemantics.def"
+}
+
+const IntrinsicInfo* IntrinsicSemanticsDB::Lookup(llvm::StringRef name) const
+{
+    auto it = table.find(name);
+    return it != table.end() ? &it->second : nullptr;
+}
+
+void IntrinsicSemanticsDB::AddEntry(const std::string& name, IntrinsicISA isa, OpCode op,
+                                    IntrinsicMemKind mem, const DataTypeInfo& laneType,
+                                    const DataTypeInfo& resultType, bool masked,
+                                    Microarch arch0, IntrinsicCost cost0,
+                                    Microarch arch1, IntrinsicCost cost1)
+{
+    IntrinsicInfo info;
+    info.name = name;
+    info.isa = isa;
+    info.opCode = op;
+    info.memKind = mem;
+    info.laneType = laneType;
+    info.resultType = resultType;
+    info.isMasked = masked;
+    info.costs[static_cast<size_t>(arch0)] = cost0;
+    info.costs[static_cast<size_t>(arch1)] = cost1;
+
+    // 同名以先出现的行为准
+    table.try_emplace(name, std::move(info));
+}
+
+void IntrinsicSemanticsDB::AddNeon(const char* stem, OpCode op, IntrinsicMemKind mem,
+                                   const char* types, IntrinsicCost n2, IntrinsicCost v1)
+{
+    static const char* const kForms[] = {"", "_n", "_lane", "_laneq"};
+
+    llvm::SmallVector<llvm::StringRef, 16> tokens;
+    llvm::StringRef(types).split(tokens, ' ', -1, false);
+
+    for (llvm::StringRef token : tokens) {
+        llvm::StringRef suffix;
+        DataTypeInfo lane, result;
+        if (!DecodeTypeToken(token, false, suffix, lane, result)) continue;
+
+        for (bool quad : {false, true}) {
+            DataTypeInfo vec = lane;
+            DataTypeInfo resultVec = result;
+            ApplyLanes(vec, quad ? 128 : 64, false);
+            ApplyLanes(resultVec, quad ? 128 : 64, false);
+            for (const char* form : kForms) {
+                std::string name = std::string(stem) + (quad ? "q" : "") + form + "_" + suffix.str();
+                AddEntry(name, IntrinsicISA::NEON, op, mem, vec, resultVec, false,
+                         Microarch::NeoverseN2, n2, Microarch::NeoverseV1, v1);
+            }
+        }
+    }
+}
+
+void IntrinsicSemanticsDB::AddSve(const char* stem, OpCode op, IntrinsicMemKind mem,
+                                  const char* types, IntrinsicCost n2, IntrinsicCost v1)
+{
+    static const char* const kPreds[] = {"", "_m", "_x", "_z"};
+    std::string base = std::string("sv") + stem;
+
+    // 重载名（svadd_m 等），lane类型未知，仅标记可伸缩
+    DataTypeInfo unknownLane;
+    unknownLane.isScalable = true;
+    for (const char* pred : kPreds) {
+        AddEntry(base + pred, IntrinsicISA::SVE, op, mem, unknownLane, unknownLane,
+                 pred[0] == '_' && pred[1] != 'x',
+                 Microarch::NeoverseN2, n2, Microarch::NeoverseV1, v1);
+    }
+
+    llvm::SmallVector<llvm::StringRef, 16> tokens;
+    llvm::StringRef(types).split(tokens, ' ', -1, false);
+
+    for (llvm::StringRef token : tokens) {
+        llvm::StringRef suffix;
+        DataTypeInfo lane, result;
+        if (!DecodeTypeToken(token, false, suffix, lane, result)) continue;
+        ApplyLanes(lane, 128, true);
+        ApplyLanes(result, 128, true);
+
+        for (const char* form : {"", "_n"}) {
+            for (const char* pred : kPreds) {
+                std::string name = base + form + "_" + suffix.str() + pred;
+                AddEntry(name, IntrinsicISA::SVE, op, mem, lane, result,
+                         pred[0] == '_' && pred[1] != 'x',
+                         Microarch::NeoverseN2, n2, Microarch::NeoverseV1, v1);
+            }
+        }
+    }
+}
+
+void IntrinsicSemanticsDB::AddX86(const char* stem, OpCode op, IntrinsicMemKind mem,
+                                  const char* types, IntrinsicCost skx, IntrinsicCost zen4)
+{
+    struct Prefix {
+        const char* text;
+        IntrinsicISA isa;
+        int width;
+        bool masked;
+    };
+    static const Prefix kPrefixes[] = {
+        {"_mm_",          IntrinsicISA::SSE,    128, false},
+        {"_mm256_",       IntrinsicISA::AVX2,   256, false},
+        {"_mm512_",       IntrinsicISA::AVX512, 512, false},
+        {"_mm_mask_",     IntrinsicISA::AVX512, 128, true},
+        {"_mm_maskz_",    IntrinsicISA::AVX512, 128, true},
+        {"_mm256_mask_",  IntrinsicISA::AVX512, 256, true},
+        {"_mm256_maskz_", IntrinsicISA::AVX512, 256, true},
+        {"_mm512_mask_",  IntrinsicISA::AVX512, 512, true},
+        {"_mm512_maskz_", IntrinsicISA::AVX512, 512, true},
+    };
+
+    llvm::SmallVector<llvm::StringRef, 16> tokens;
+    llvm::StringRef(types).split(tokens, ' ', -1, false);
+
+    for (llvm::StringRef token : tokens) {
+        llvm::StringRef suffix;
+        DataTypeInfo lane, result;
+        if (!DecodeTypeToken(token, true, suffix, lane, result)) continue;
+        bool scalar = suffix == "ss" || suffix == "sd";
+
+        for (const Prefix& prefix : kPrefixes) {
+            DataTypeInfo vec = lane;
+            DataTypeInfo resultVec = result;
+            ApplyLanes(vec, scalar ? vec.bitWidth : prefix.width, false);
+            ApplyLanes(resultVec, scalar ? resultVec.bitWidth : prefix.width, false);
+
+            // Zen4 的512位运算拆成两个256位uop执行
+            IntrinsicCost zenCost = zen4;
+            if (prefix.width == 512) {
+                zenCost.recipThroughput *= 2;
+            }
+
+            std::string name = std::string(prefix.text) + stem + "_" + suffix.str();
+            AddEntry(name, prefix.isa, op, mem, vec, resultVec, prefix.masked,
+                     Microarch::SkylakeX, skx, Microarch::Zen4, zenCost);
+        }
+    }
+}
+
+void IntrinsicSemanticsDB::AddExplicit(const char* name, IntrinsicISA isa, OpCode op,
+                                       IntrinsicMemKind mem, const char* type, int width,
+                                       IntrinsicCost cost0, IntrinsicCost cost1)
+{
+    bool isArm = isa == IntrinsicISA::NEON || isa == IntrinsicISA::SVE;
+    llvm::StringRef suffix;
+    DataTypeInfo lane, result;
+    if (!DecodeTypeToken(type, !isArm, suffix, lane, result)) return;
+
+    bool scalar = suffix == "ss" || suffix == "sd";
+    ApplyLanes(lane, scalar ? lane.bitWidth : width, isa == IntrinsicISA::SVE);
+    ApplyLanes(result, scalar ? result.bitWidth : width, isa == IntrinsicISA::SVE);
+
+    if (isArm) {
+        AddEntry(name, isa, op, mem, lane, result, false,
+                 Microarch::NeoverseN2, cost0, Microarch::NeoverseV1, cost1);
+    } else {
+        AddEntry(name, isa, op, mem, lane, result, false,
+                 Microarch::SkylakeX, cost0, Microarch::Zen4, cost1);
+    }
+}
+
+// ============================================
+// 字符串转换
+// ============================================
+
+std::string IntrinsicISAToString(IntrinsicISA isa)
+{
+    switch (isa) {
+        case IntrinsicISA::NEON: return "NEON";
+        case IntrinsicISA::SVE: return "SVE";
+        case IntrinsicISA::SSE: return "SSE";
+        case IntrinsicISA::AVX2: return "AVX2";
+        case IntrinsicISA::AVX512: return "AVX-512";
+        default: return "unknown";
+    }
+}
+
+std::string IntrinsicMemKindToString(IntrinsicMemKind kind)
+{
+    switch (kind) {
+        case IntrinsicMemKind::Load: return "load";
+        case IntrinsicMemKind::Store: return "store";
+        case IntrinsicMemKind::Gather: return "gather";
+        case IntrinsicMemKind::Scatter: return "scatter";
+        default: return "none";
+    }
+}
+
+std::string MicroarchToString(Microarch arch)
+{
+    switch (arch) {
+        case Microarch::SkylakeX: return "skylake-avx512";
+        case Microarch::Zen4: return "znver4";
+        case Microarch::NeoverseN2: return "neoverse-n2";
+        case Microarch::NeoverseV1: return "neoverse-v1";
+        default: return "unknown";
+    }
+}
+
+} // namespace compute_graph
@@ -0,0 +1,894 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * KernelBenchmark.cpp - 候选内核微基准与差分测试实现
+ *
+ * 生成的测试程序结构：
+ *   KernelScalar_(形参...)  原循环（#line 指回源码）
+ *   KernelVector_(形参...)  SIMDCodeEmitter 生成的向量循环（可选）
+ *   main: 合成输入 -> 各运行一次并比对输出 -> 分别计时，输出 ns/element
+ *
+ * 【修复】指令集选项只作用于向量内核：KernelVector_ 单独编译为一个目标文件
+ * （-DCG_BENCH_VECTOR_ONLY + 指令集选项），标量内核与驱动不带指令集选项编译
+ * （-DCG_BENCH_DRIVER_ONLY），否则标量基线会被编译器按同一指令集自动向量化
+ */
+#include "KernelBenchmark.h"
+#include "SIMDCodeEmitter.h"
+
+#include "clang/AST/RecursiveASTVisitor.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/Lexer.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace compute_graph {
+
+namespace {
+
+const clang::VarDecl* GetVar(const clang::Expr* expr)
+{
+    const auto* ref = llvm::dyn_cast_or_null<clang::DeclRefExpr>(
+        expr ? expr->IgnoreParenImpCasts() : nullptr);
+    return ref ? llvm::dyn_cast<clang::VarDecl>(ref->getDecl()) : nullptr;
+}
+
+// a[i][j] 的基址引用
+const clang::DeclRefExpr* GetRootRef(const clang::ArraySubscriptExpr* access)
+{
+    const clang::Expr* base = access->getBase()->IgnoreParenImpCasts();
+    while (const auto* inner = llvm::dyn_cast<clang::ArraySubscriptExpr>(base)) {
+        base = inner->getBase()->IgnoreParenImpCasts();
+    }
+    return llvm::dyn_cast<clang::DeclRefExpr>(base);
+}
+
+void CollectVars(const clang::Stmt* stmt, std::set<const clang::VarDecl*>& vars)
+{
+    if (!stmt) return;
+    if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(stmt)) {
+        if (const auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl())) {
+            vars.insert(var);
+        }
+    }
+    for (const auto* child : stmt->children()) {
+        CollectVars(child, vars);
+    }
+}
+
+// 类型对应的元素个数（多维数组各维乘积），变长数组返回0
+int64_t ElementCount(clang::QualType type)
+{
+    int64_t count = 1;
+    while (const auto* arrayType = llvm::dyn_cast<clang::ArrayType>(type.getCanonicalType())) {
+        const auto* constArray = llvm::dyn_cast<clang::ConstantArrayType>(arrayType);
+        if (!constArray) return 0;
+        count *= constArray->getSize().getSExtValue();
+        type = constArray->getElementType();
+    }
+    return count;
+}
+
+std::string EscapeString(const std::string& text)
+{
+    std::string result;
+    for (char c : text) {
+        if (c == '\\' || c == '"') {
+            result += '\\';
+            result += c;
+        } else if (c == '\n') {
+            result += "\\n";
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+// 循环内的变量引用、写入、声明与调用
+class KernelScanner : public clang::RecursiveASTVisitor<KernelScanner> {
+public:
+    std::vector<const clang::VarDecl*> referenced;      // 按首次出现顺序
+    std::map<const clang::VarDecl*, std::vector<const clang::DeclRefExpr*>> refs;
+    std::set<const clang::VarDecl*> declared;
+    std::set<const clang::VarDecl*> written;
+    std::set<const clang::DeclRefExpr*> subscriptBases;
+    std::vector<const clang::ArraySubscriptExpr*> accesses;  // 元素访问（结果非数组）
+    std::vector<const clang::CallExpr*> calls;
+    bool hasMacro = false;
+
+    bool VisitStmt(clang::Stmt* stmt)
+    {
+        if (stmt->getBeginLoc().isMacroID()) hasMacro = true;
+        return true;
+    }
+
+    bool VisitVarDecl(clang::VarDecl* var)
+    {
+        declared.insert(var);
+        return true;
+    }
+
+    bool VisitDeclRefExpr(clang::DeclRefExpr* ref)
+    {
+        if (const auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl())) {
+            if (refs.find(var) == refs.end()) referenced.push_back(var);
+            refs[var].push_back(ref);
+        }
+        return true;
+    }
+
+    bool VisitBinaryOperator(clang::BinaryOperator* op)
+    {
+        if (op->isAssignmentOp()) MarkWritten(op->getLHS());
+        return true;
+    }
+
+    bool VisitUnaryOperator(clang::UnaryOperator* op)
+    {
+        if (op->isIncrementDecrementOp() || op->getOpcode() == clang::UO_AddrOf) {
+            MarkWritten(op->getSubExpr());
+        }
+        return true;
+    }
+
+    bool VisitArraySubscriptExpr(clang::ArraySubscriptExpr* access)
+    {
+        if (const auto* ref = GetRootRef(access)) subscriptBases.insert(ref);
+        if (!access->getType()->isArrayType()) accesses.push_back(access);
+        return true;
+    }
+
+    bool VisitCallExpr(clang::CallExpr* call)
+    {
+        calls.push_back(call);
+        return true;
+    }
+
+private:
+    // a[i] = ... 写的是元素，不记为写指针本身
+    void MarkWritten(const clang::Expr* expr)
+    {
+        if (const auto* var = GetVar(expr)) written.insert(var);
+    }
+};
+
+} // namespace
+
+// ============================================
+// KernelBenchGenerator
+// ============================================
+
+KernelBenchGenerator::KernelBenchGenerator(clang::ASTContext& ctx, const std::string& target,
+                                           long elements)
+    : astContext(ctx), targetName(target), defaultElements(elements > 0 ? elements : 4096),
+      inductionAnalysis(ctx)
+{}
+
+bool KernelBenchGenerator::Fail(const std::string& reason)
+{
+    if (failure.empty()) {
+        failure = reason;
+    }
+    return false;
+}
+
+std::string KernelBenchGenerator::GetText(const clang::Stmt* stmt) const
+{
+    if (!stmt) return "";
+    clang::SourceRange range = stmt->getSourceRange();
+    if (range.isInvalid() || range.getBegin().isMacroID() || range.getEnd().isMacroID()) {
+        return "";
+    }
+    return clang::Lexer::getSourceText(clang::CharSourceRange::getTokenRange(range),
+                                       astContext.getSourceManager(),
+                                       astContext.getLangOpts()).str();
+}
+
+KernelParam* KernelBenchGenerator::FindParam(const clang::VarDecl* var)
+{
+    for (auto& param : params) {
+        if (param.var == var) return &param;
+    }
+    return nullptr;
+}
+
+const clang::Stmt* KernelBenchGenerator::SelectLoop(const ComputeGraph& graph) const
+{
+    // 优先选择惯用法所在循环（与向量代码生成一致），否则取锚点所在循环
+    for (const char* key : {"idiom", "is_anchor"}) {
+        for (const auto& node : graph.GetAllNodes()) {
+            if (!node->astStmt || !node->HasProperty(key)) continue;
+            if (const clang::Stmt* loop = inductionAnalysis.FindEnclosingLoop(node->astStmt)) {
+                return loop;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool KernelBenchGenerator::ClassifyParam(KernelParam& param, bool written)
+{
+    clang::QualType type = param.var->getType().getNonReferenceType();
+    clang::QualType canonical = type.getCanonicalType();
+    clang::PrintingPolicy policy(astContext.getLangOpts());
+
+    auto declare = [&](clang::QualType declType) {
+        std::string text;
+        llvm::raw_string_ostream os(text);
+        declType.print(os, policy, param.name);
+        return os.str();
+    };
+
+    if (canonical->isArrayType() || canonical->isPointerType()) {
+        if (written) return Fail("pointer '" + param.name + "' is modified in the loop");
+        clang::QualType pointerType = canonical->isArrayType() ?
+            astContext.getArrayDecayedType(canonical) : canonical;
+        clang::QualType element = pointerType->getPointeeType();
+        while (const auto* arrayType = astContext.getAsArrayType(element)) {
+            element = arrayType->getElementType();
+        }
+        if (!element->isArithmeticType() || element->isAnyComplexType() ||
+            element->isEnumeralType()) {
+            return Fail("buffer '" + param.name + "' has unsupported element type '" +
+                        element.getAsString(policy) + "'");
+        }
+        param.isBuffer = true;
+        param.isOutput = !element.isConstQualified();
+        param.elementType = element.getUnqualifiedType().getAsString(policy);
+        param.elementInfo = DataTypeInfo::FromClangType(element.getUnqualifiedType());
+        param.typeText = pointerType.getAsString(policy);
+        param.declText = declare(pointerType);
+        return true;
+    }
+
+    if (!canonical->isArithmeticType() || canonical->isAnyComplexType() ||
+        canonical->isEnumeralType()) {
+        return Fail("variable '" + param.name + "' has unsupported type '" +
+                    type.getAsString(policy) + "'");
+    }
+    clang::QualType scalar = canonical.getUnqualifiedType();
+    param.isOutput = written;
+    param.elementType = scalar.getAsString(policy);
+    param.elementInfo = DataTypeInfo::FromClangType(scalar);
+    param.declText = declare(written ? astContext.getLValueReferenceType(scalar) : scalar);
+    return true;
+}
+
+bool KernelBenchGenerator::CollectParams(const clang::Stmt* loop)
+{
+    KernelScanner scanner;
+    scanner.TraverseStmt(const_cast<clang::Stmt*>(loop));
+    if (scanner.hasMacro) return Fail("loop uses macros");
+
+    const clang::SourceManager& sm = astContext.getSourceManager();
+    for (const auto* call : scanner.calls) {
+        const clang::FunctionDecl* callee = call->getDirectCallee();
+        if (!callee) return Fail("loop contains an indirect call");
+        bool library = callee->getBuiltinID() != 0 || sm.isInSystemHeader(callee->getLocation());
+        if (!library) {
+            return Fail("loop calls '" + callee->getNameAsString() + "', which is not available in the harness");
+        }
+        const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(call->getCallee()->IgnoreParenImpCasts());
+        if (callee->isInStdNamespace() && ref && !ref->hasQualifier()) {
+            needsStdUsing = true;
+        }
+    }
+
+    for (const auto* var : scanner.referenced) {
+        if (scanner.declared.count(var)) continue;
+        KernelParam param;
+        param.var = var;
+        param.name = var->getNameAsString();
+        if (!ClassifyParam(param, scanner.written.count(var) > 0)) return false;
+        if (param.isBuffer) {
+            for (const auto* ref : scanner.refs[var]) {
+                if (!scanner.subscriptBases.count(ref)) {
+                    return Fail("buffer '" + param.name + "' is used other than by subscripting");
+                }
+            }
+        }
+        params.push_back(param);
+    }
+    accesses = scanner.accesses;
+    return true;
+}
+
+std::string KernelBenchGenerator::FlatIndexText(const clang::ArraySubscriptExpr* access,
+                                                const clang::VarDecl*& base) const
+{
+    std::string text;
+    const clang::Expr* expr = access;
+    while (const auto* level = llvm::dyn_cast<clang::ArraySubscriptExpr>(expr->IgnoreParenImpCasts())) {
+        int64_t scale = ElementCount(level->getType());
+        std::string index = GetText(level->getIdx());
+        if (scale == 0 || index.empty()) return "";
+        std::string term = "(" + index + ")";
+        if (scale != 1) term += " * " + std::to_string(scale);
+        text = text.empty() ? term : term + " + " + text;
+        expr = level->getBase();
+    }
+    base = GetVar(expr);
+    return text;
+}
+
+bool KernelBenchGenerator::CollectAccesses()
+{
+    const InductionVariable* iv = loopInfo->GetPrimary();
+    for (const auto* access : accesses) {
+        const clang::DeclRefExpr* root = GetRootRef(access);
+        KernelParam* param = root ? FindParam(llvm::dyn_cast<clang::VarDecl>(root->getDecl())) : nullptr;
+        if (!param) continue;       // 循环内声明的局部数组
+
+        AffineIndex index = inductionAnalysis.AnalyzeIndex(access, *loopInfo);
+        if (!index.isAffine) {
+            // 仅支持 a[idx[...]]：idx 取值限制在 [0, count)
+            const auto* inner = llvm::dyn_cast<clang::ArraySubscriptExpr>(access->getIdx()->IgnoreParenImpCasts());
+            const clang::DeclRefExpr* innerRoot = inner ? GetRootRef(inner) : nullptr;
+            KernelParam* indexParam = innerRoot ?
+                FindParam(llvm::dyn_cast<clang::VarDecl>(innerRoot->getDecl())) : nullptr;
+            if (!indexParam || !indexParam->isBuffer || indexParam->elementInfo.IsFloatingPoint()) {
+                return Fail("cannot bound the non-affine access '" + GetText(access) + "'");
+            }
+            indexParam->isIndexArray = true;
+            param->hasIndirectAccess = true;
+            continue;
+        }
+
+        // 仿射下标在首末迭代处取极值；下标只能引用主归纳变量与只读标量
+        const clang::VarDecl* base = nullptr;
+        std::string flat = FlatIndexText(access, base);
+        if (flat.empty()) return Fail("cannot size buffer '" + param->name + "'");
+        std::set<const clang::VarDecl*> vars;
+        const clang::Expr* expr = access;
+        while (const auto* level = llvm::dyn_cast<clang::ArraySubscriptExpr>(expr->IgnoreParenImpCasts())) {
+            CollectVars(level->getIdx(), vars);
+            expr = level->getBase();
+        }
+        for (const auto* var : vars) {
+            const KernelParam* used = FindParam(var);
+            if (var != iv->var && (!used || used->isBuffer || used->isOutput)) {
+                return Fail("index of '" + param->name + "' depends on '" + var->getNameAsString() + "'");
+            }
+        }
+        param->indexExprs.push_back(flat);
+    }
+
+    for (const auto& param : params) {
+        if (param.isBuffer && param.indexExprs.empty() && !param.hasIndirectAccess) {
+            return Fail("cannot size buffer '" + param.name + "'");
+        }
+    }
+    return true;
+}
+
+void KernelBenchGenerator::InitScalar(KernelParam& param, const clang::VarDecl* ivVar)
+{
+    const std::string& type = param.elementType;
+    if (param.var == ivVar) {
+        param.initValue = "static_cast<" + type + ">(first_)";
+        return;
+    }
+
+    // 常量（如 const int N = 1024）保留原值
+    const clang::Expr* init = param.var->getInit();
+    if (param.var->getType().isConstQualified() && init && !init->isValueDependent()) {
+        clang::Expr::EvalResult result;
+        if (init->EvaluateAsRValue(result, astContext)) {
+            if (result.Val.isInt()) {
+                const llvm::APSInt& value = result.Val.getInt();
+                param.initValue = "static_cast<" + type + ">(" +
+                    (value.isSigned() ? std::to_string(value.getExtValue()) :
+                     std::to_string(value.getZExtValue())) + ")";
+                return;
+            }
+            if (result.Val.isFloat()) {
+                llvm::SmallString<32> text;
+                result.Val.getFloat().toString(text);
+                param.initValue = "static_cast<" + type + ">(" + text.str().str() + ")";
+                return;
+            }
+        }
+    }
+
+    if (param.isBound) {
+        param.initValue = "static_cast<" + type + ">(elements_)";
+    } else if (param.elementInfo.IsFloatingPoint()) {
+        param.initValue = "static_cast<" + type + ">(0.5f)";
+    } else {
+        param.initValue = "static_cast<" + type + ">(1)";
+    }
+}
+
+KernelBenchHarness KernelBenchGenerator::Generate(const ComputeGraph& graph,
+                                                  const std::string& harnessFile)
+{
+    KernelBenchHarness result;
+    loopInfo = nullptr;
+    params.clear();
+    accesses.clear();
+    failure.clear();
+    needsStdUsing = false;
+
+    auto fail = [&result](const std::string& reason) {
+        result.reason = reason;
+        return result;
+    };
+
+    // 【修复】模板实例的源码文本是模式的文本，生成的测试程序无法编译
+    if (graph.HasProperty("template_args")) {
+        return fail("template instances are not benchmarked (their source text is the pattern's)");
+    }
+
+    const clang::Stmt* loop = SelectLoop(graph);
+    if (!loop) return fail("graph has no enclosing loop");
+
+    const LoopInductionInfo& info = inductionAnalysis.Analyze(loop);
+    loopInfo = &info;
+    const InductionVariable* iv = info.GetPrimary();
+    if (!iv || iv->step <= 0) return fail("requires an increasing induction variable");
+    if (iv->compareOp != "<" && iv->compareOp != "<=" && iv->compareOp != "!=") {
+        return fail("unsupported loop condition '" + iv->compareOp + "'");
+    }
+
+    // 迭代范围：起始值与边界取自AST的完整源码文本
+    const clang::Expr* condExpr = nullptr;
+    const auto* forStmt = llvm::dyn_cast<clang::ForStmt>(loop);
+    if (forStmt) {
+        condExpr = forStmt->getCond();
+    } else if (const auto* whileStmt = llvm::dyn_cast<clang::WhileStmt>(loop)) {
+        condExpr = whileStmt->getCond();
+    } else if (const auto* doStmt = llvm::dyn_cast<clang::DoStmt>(loop)) {
+        condExpr = doStmt->getCond();
+    }
+    const auto* cond = llvm::dyn_cast_or_null<clang::BinaryOperator>(
+        condExpr ? condExpr->IgnoreParenImpCasts() : nullptr);
+    if (!cond) return fail("unsupported loop condition");
+    const clang::Expr* boundExpr = GetVar(cond->getLHS()) == iv->var ? cond->getRHS() : cond->getLHS();
+    std::string boundText = GetText(boundExpr);
+
+    std::string startText;
+    const auto* initDecl = forStmt ? llvm::dyn_cast_or_null<clang::DeclStmt>(forStmt->getInit()) : nullptr;
+    const auto* initAssign = forStmt ? llvm::dyn_cast_or_null<clang::BinaryOperator>(forStmt->getInit()) : nullptr;
+    if (initDecl && initDecl->isSingleDecl() && initDecl->getSingleDecl() == iv->var && iv->var->getInit()) {
+        startText = GetText(iv->var->getInit());
+    } else if (initAssign && initAssign->getOpcode() == clang::BO_Assign &&
+               GetVar(initAssign->getLHS()) == iv->var) {
+        startText = GetText(initAssign->getRHS());
+    } else if (iv->hasConstStart) {
+        startText = std::to_string(iv->start);
+    }
+    std::string loopText = GetText(loop);
+    if (boundText.empty() || startText.empty() || loopText.empty()) {
+        return fail("loop bounds are not available as source text");
+    }
+
+    if (!CollectParams(loop)) return fail(failure);
+    std::set<const clang::VarDecl*> boundVars;
+    CollectVars(boundExpr, boundVars);
+    for (auto& param : params) {
+        param.isBound = !param.isBuffer && boundVars.count(param.var) > 0;
+    }
+    if (!CollectAccesses()) return fail(failure);
+    for (auto& param : params) {
+        if (!param.isBuffer) InitScalar(param, iv->var);
+    }
+
+    // 向量版本（与原循环使用同一组形参）
+    SIMDCodeEmitter emitter(astContext, targetName);
+    SIMDEmitResult vectorResult = emitter.Emit(graph);
+    if (vectorResult.success && vectorResult.loopStmt == loop) {
+        result.hasVector = true;
+        result.isaSuffix = vectorResult.isaSuffix;
+        result.compileFlags = vectorResult.compileFlags;
+    } else {
+        result.vectorReason = vectorResult.success ? "vectorized loop differs from the kernel loop" : vectorResult.reason;
+    }
+
+    const clang::SourceManager& sm = astContext.getSourceManager();
+    std::string file = sm.getFilename(sm.getSpellingLoc(loop->getBeginLoc())).str();
+    int loopLine = static_cast<int>(sm.getSpellingLineNumber(loop->getBeginLoc()));
+    unsigned column = sm.getSpellingColumnNumber(loop->getBeginLoc());
+    std::string funcName = graph.HasProperty("anchor_func") ? graph.GetProperty("anchor_func") : graph.GetName();
+    result.kernelName = funcName + " loop at " + file + ":" + std::to_string(loopLine);
+
+    bool fpReassoc = graph.GetProperty("fp_reassociation") == "true";
+    std::string paramList;
+    for (const auto& param : params) {
+        if (!paramList.empty()) paramList += ", ";
+        paramList += param.declText;
+    }
+    auto args = [this](const std::string& suffix) {
+        std::string text;
+        for (const auto& param : params) {
+            if (!text.empty()) text += ", ";
+            if (param.isBuffer) {
+                text += "reinterpret_cast<" + param.typeText + ">(" + param.name +
+                        (param.isOutput ? suffix : "_in_") + ")";
+            } else {
+                text += param.isOutput ? param.name + suffix : param.name;
+            }
+        }
+        return text;
+    };
+
+    std::ostringstream os;
+    auto resetLine = [&os, &harnessFile]() {
+        std::string text = os.str();
+        size_t lines = static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+        os << "#line " << lines + 2 << " \"" << EscapeString(harnessFile) << "\"\n";
+    };
+
+    os << "// Generated by ComputeGraphTool: microbenchmark for " << result.kernelName << "\n";
+    if (graph.HasProperty("idioms")) {
+        os << "// Idioms: " << graph.GetProperty("idioms") << "\n";
+    }
+    if (result.hasVector && !result.compileFlags.empty()) {
+        os << "// Build: c++ -O2 -std=c++17 -c -DCG_BENCH_VECTOR_ONLY " << result.compileFlags
+           << " <this file> -o vector.o\n";
+        os << "//        c++ -O2 -std=c++17 -DCG_BENCH_DRIVER_ONLY <this file> vector.o\n";
+        os << "// ISA flags apply to KernelVector_ only; the scalar kernel and driver use the baseline target.\n";
+    } else {
+        os << "// Build: c++ -O2 -std=c++17 <this file>\n";
+    }
+    os << "// Usage: <binary> [elements]\n";
+    os << "#include <algorithm>\n#include <chrono>\n#include <cmath>\n#include <cstdint>\n"
+       << "#include <cstdio>\n#include <cstdlib>\n#include <cstring>\n";
+    if (result.hasVector) {
+        os << vectorResult.preamble;
+    }
+    if (needsStdUsing) {
+        os << "using namespace std;\n";
+    }
+
+    // 向量内核具有外部链接，可单独带指令集选项编译
+    if (result.hasVector) {
+        os << "\nvoid KernelVector_(" << paramList << ");\n\n";
+        os << "#ifndef CG_BENCH_DRIVER_ONLY\n";
+        os << "[[gnu::noinline]] void KernelVector_(" << paramList << ")\n{\n";
+        os << vectorResult.loopCode;
+        resetLine();
+        os << "}\n";
+        os << "#endif\n";
+    }
+
+    os << R"(
+#ifndef CG_BENCH_VECTOR_ONLY
+namespace {
+
+constexpr size_t kPad_ = 64;
+
+template <typename T>
+T* Allocate_(size_t count)
+{
+    size_t bytes = (count * sizeof(T) + 63) / 64 * 64;
+    void* data = std::aligned_alloc(64, bytes > 0 ? bytes : 64);
+    if (!data) {
+        std::printf("out of memory\n");
+        std::exit(3);
+    }
+    std::memset(data, 0, bytes);
+    return static_cast<T*>(data);
+}
+
+uint64_t Next_(uint64_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+template <typename T>
+void FillFloat_(T* data, size_t count, uint64_t seed)
+{
+    for (size_t k = 0; k < count; ++k) {
+        double unit = static_cast<double>(Next_(seed) >> 40) / static_cast<double>(1ull << 24);
+        data[k] = static_cast<T>(static_cast<float>(unit * 2.0 - 1.0));
+    }
+}
+
+template <typename T>
+void FillInt_(T* data, size_t count, uint64_t seed, long lo, long hi)
+{
+    for (size_t k = 0; k < count; ++k) {
+        data[k] = static_cast<T>(lo + static_cast<long>(Next_(seed) % static_cast<uint64_t>(hi - lo)));
+    }
+}
+
+template <typename F>
+size_t Extent_(const char* name, F index, long first, long last)
+{
+    if (last < first) {
+        return kPad_;
+    }
+    const long lo = std::min(index(first), index(last));
+    const long hi = std::max(index(first), index(last));
+    if (lo < 0) {
+        std::printf("unsupported: %s is indexed at %ld\n", name, lo);
+        std::exit(3);
+    }
+    return static_cast<size_t>(hi) + 1 + kPad_;
+}
+
+template <typename T>
+bool Compare_(const char* name, const T* ref, const T* vec, size_t count, double rtol, double atol)
+{
+    for (size_t k = 0; k < count; ++k) {
+        const double a = static_cast<double>(ref[k]);
+        const double b = static_cast<double>(vec[k]);
+        if (std::isnan(a) && std::isnan(b)) {
+            continue;
+        }
+        if (!(std::fabs(a - b) <= atol + rtol * std::max(std::fabs(a), std::fabs(b)))) {
+            std::printf("mismatch: %s[%zu] scalar=%.9g vector=%.9g\n", name, k, a, b);
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename F>
+double NsPerElement_(F&& run, long count)
+{
+    using Clock = std::chrono::steady_clock;
+    if (count <= 0) {
+        return 0.0;
+    }
+    double best = 0.0;
+    for (int trial = 0; trial < 5; ++trial) {
+        long reps = 0;
+        const auto start = Clock::now();
+        double elapsed = 0.0;
+        do {
+            run();
+            ++reps;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < 0.02);
+        const double perRun = elapsed / static_cast<double>(reps);
+        if (trial == 0 || perRun < best) {
+            best = perRun;
+        }
+    }
+    return best * 1e9 / static_cast<double>(count);
+}
+
+)";
+
+    std::string indent(column > 0 ? column - 1 : 0, ' ');
+    os << "[[gnu::noinline]] void KernelScalar_(" << paramList << ")\n{\n";
+    os << "#line " << loopLine << " \"" << EscapeString(file) << "\"\n";
+    os << indent << loopText << "\n";
+    resetLine();
+    os << "}\n\n";
+    os << "} // namespace\n\n";
+
+    os << "int main(int argc, char** argv)\n{\n";
+    os << "    const long elements_ = argc > 1 ? std::atol(argv[1]) : " << defaultElements << ";\n";
+    os << "    (void)elements_;\n";
+    for (const auto& param : params) {
+        if (!param.isBuffer && !param.isOutput) {
+            os << "    " << param.elementType << " " << param.name << " = " << param.initValue << ";\n";
+        }
+    }
+    os << "    const long first_ = static_cast<long>(" << startText << ");\n";
+    os << "    const long last_ = static_cast<long>(" << boundText << ")"
+       << (iv->compareOp == "<=" ? "" : " - 1") << ";\n";
+    os << "    const long count_ = last_ >= first_ ? (last_ - first_) / " << iv->step << " + 1 : 0;\n";
+
+    // 缓冲区：输入一份，可写缓冲区另备标量/向量两份
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+    std::vector<std::string> freeList;
+    std::string resetCode;
+    std::string compareCode;
+    for (const auto& param : params) {
+        if (!param.isBuffer) continue;
+        const std::string& name = param.name;
+        const std::string& type = param.elementType;
+        std::vector<std::string> extents;
+        for (const auto& index : param.indexExprs) {
+            extents.push_back("Extent_(\"" + name + "\", [&](long " + iv->name +
+                              ") -> long { return static_cast<long>(" + index + "); }, first_, last_)");
+        }
+        if (param.hasIndirectAccess) {
+            extents.push_back("static_cast<size_t>(count_) + kPad_");
+        }
+        os << "    const size_t " << name << "_extent_ = std::max<size_t>({";
+        for (size_t k = 0; k < extents.size(); ++k) {
+            os << (k > 0 ? ",\n        " : "") << extents[k];
+        }
+        os << "});\n";
+
+        std::vector<std::string> copies = {"_in_"};
+        if (param.isOutput) {
+            copies.push_back("_ref_");
+            if (result.hasVector) copies.push_back("_vec_");
+        }
+        for (const auto& copy : copies) {
+            os << "    " << type << "* " << name << copy << " = Allocate_<" << type << ">("
+               << name << "_extent_);\n";
+            freeList.push_back(name + copy);
+        }
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        std::string seedText = std::to_string(seed | 1) + "ull";
+        if (param.isIndexArray) {
+            os << "    FillInt_(" << name << "_in_, " << name << "_extent_, " << seedText
+               << ", 0, std::max(count_, 1L));\n";
+        } else if (param.elementInfo.IsFloatingPoint()) {
+            os << "    FillFloat_(" << name << "_in_, " << name << "_extent_, " << seedText << ");\n";
+        } else if (param.elementInfo.isSigned) {
+            os << "    FillInt_(" << name << "_in_, " << name << "_extent_, " << seedText << ", -8, 8);\n";
+        } else {
+            os << "    FillInt_(" << name << "_in_, " << name << "_extent_, " << seedText << ", 0, 16);\n";
+        }
+
+        if (param.isOutput) {
+            for (size_t k = 1; k < copies.size(); ++k) {
+                resetCode += "        std::memcpy(" + name + copies[k] + ", " + name + "_in_, " +
+                             name + "_extent_ * sizeof(" + type + "));\n";
+            }
+            bool exact = !param.elementInfo.IsFloatingPoint();
+            compareCode += "        match_ = Compare_(\"" + name + "\", " + name + "_ref_, " + name +
+                           "_vec_, " + name + "_extent_, " + (exact ? "0.0, 0.0" : "rtol_, atol_") +
+                           ") && match_;\n";
+        }
+    }
+
+    // 被写标量（累加器等）：每次运行前复位
+    std::string scalarResetRef;
+    std::string scalarResetVec;
+    for (const auto& param : params) {
+        if (param.isBuffer || !param.isOutput) continue;
+        const std::string& name = param.name;
+        os << "    const " << param.elementType << " " << name << "_init_ = " << param.initValue << ";\n";
+        os << "    " << param.elementType << " " << name << "_ref_ = " << name << "_init_;\n";
+        os << "    " << param.elementType << " " << name << "_vec_ = " << name << "_init_;\n";
+        scalarResetRef += "        " + name + "_ref_ = " + name + "_init_;\n";
+        scalarResetVec += "        " + name + "_vec_ = " + name + "_init_;\n";
+        bool exact = !param.elementInfo.IsFloatingPoint();
+        compareCode += "        match_ = Compare_(\"" + name + "\", &" + name + "_ref_, &" + name +
+                       "_vec_, 1, " + (exact ? "0.0, 0.0" : "rtol_, atol_") + ") && match_;\n";
+    }
+
+    // 浮点容差：重排的归约按元素数放宽绝对误差
+    os << "    const double rtol_ = " << (fpReassoc ? "1e-3" : "1e-5") << ";\n";
+    os << "    const double atol_ = " << (fpReassoc ? "1e-4 * static_cast<double>(count_ + 1)" : "1e-6")
+       << ";\n";
+    os << "    (void)rtol_;\n    (void)atol_;\n\n";
+
+    os << "    auto reset_ = [&]() {\n" << resetCode << "    };\n";
+    os << "    auto runScalar_ = [&]() {\n" << scalarResetRef
+       << "        KernelScalar_(" << args("_ref_") << ");\n    };\n";
+    if (result.hasVector) {
+        os << "    auto runVector_ = [&]() {\n" << scalarResetVec
+           << "        KernelVector_(" << args("_vec_") << ");\n    };\n";
+    }
+
+    os << "\n    std::printf(\"kernel: %s, %ld elements\\n\", \"" << EscapeString(result.kernelName)
+       << "\", count_);\n";
+    os << "    reset_();\n";
+    os << "    runScalar_();\n";
+    os << "    bool match_ = true;\n";
+    if (result.hasVector) {
+        if (!vectorResult.cpuFeature.empty()) {
+            os << "#if defined(__x86_64__) || defined(__i386__)\n";
+            os << "    const bool vectorRun_ = __builtin_cpu_supports(\"" << vectorResult.cpuFeature << "\");\n";
+            os << "#else\n";
+            os << "    const bool vectorRun_ = false;\n";
+            os << "#endif\n";
+        } else {
+            os << "    const bool vectorRun_ = true;\n";
+        }
+        os << "    if (vectorRun_) {\n";
+        os << "        runVector_();\n";
+        os << compareCode;
+        os << "    }\n";
+    }
+    os << "    const double scalarNs_ = NsPerElement_(runScalar_, count_);\n";
+    os << "    std::printf(\"scalar: %.3f ns/element\\n\", scalarNs_);\n";
+    if (result.hasVector) {
+        os << "    if (vectorRun_) {\n";
+        os << "        const double vectorNs_ = NsPerElement_(runVector_, count_);\n";
+        os << "        std::printf(\"" << result.isaSuffix
+           << ": %.3f ns/element, speedup %.2fx\\n\", vectorNs_, vectorNs_ > 0.0 ? scalarNs_ / vectorNs_ : 0.0);\n";
+        os << "        std::printf(\"outputs: %s\\n\", match_ ? \"match\" : \"MISMATCH\");\n";
+        os << "    } else {\n";
+        os << "        std::printf(\"" << result.isaSuffix << ": skipped, host does not support "
+           << vectorResult.cpuFeature << "\\n\");\n";
+        os << "    }\n";
+    } else {
+        os << "    std::printf(\"vector: not emitted (%s)\\n\", \"" << EscapeString(result.vectorReason)
+           << "\");\n";
+    }
+    for (const auto& name : freeList) {
+        os << "    std::free(" << name << ");\n";
+    }
+    os << "    return match_ ? 0 : 1;\n";
+    os << "}\n";
+    os << "#endif // CG_BENCH_VECTOR_ONLY\n";
+
+    result.success = true;
+    result.code = os.str();
+    return result;
+}
+
+// ============================================
+// 本地编译与运行
+// ============================================
+
+namespace {
+
+// 【新增】ExecuteAndWait 超时后杀掉子进程并返回 -2，错误信息注明超时
+bool TimedOut(int status, unsigned timeoutSeconds, const std::string& errMsg)
+{
+    return status == -2 && timeoutSeconds > 0 && errMsg.find("timed out") != std::string::npos;
+}
+
+} // namespace
+
+bool CompileAndRunKernelBench(const std::string& compiler, const std::string& sourceFile,
+                              const std::string& compileFlags, const std::string& exeFile,
+                              unsigned timeoutSeconds)
+{
+    auto program = llvm::sys::findProgramByName(compiler);
+    if (!program) {
+        llvm::errs() << "  [Bench] Compiler '" << compiler << "' not found, " << sourceFile
+                     << " not built\n";
+        return false;
+    }
+
+    std::string errMsg;
+    auto build = [&](std::vector<std::string> args) {
+        args.insert(args.begin(), {*program, "-O2", "-std=c++17"});
+        std::vector<llvm::StringRef> argRefs(args.begin(), args.end());
+        llvm::outs().flush();
+        int status = llvm::sys::ExecuteAndWait(*program, argRefs, {}, {}, timeoutSeconds, 0, &errMsg);
+        if (TimedOut(status, timeoutSeconds, errMsg)) {
+            llvm::errs() << "  [Bench] Build of " << sourceFile << " timed out after "
+                         << timeoutSeconds << " s\n";
+            return false;
+        }
+        if (status != 0) {
+            llvm::errs() << "  [Bench] Build failed for " << sourceFile
+                         << (errMsg.empty() ? "" : ": " + errMsg) << "\n";
+            return false;
+        }
+        return true;
+    };
+
+    // 【修复】指令集选项只用于向量内核的目标文件，标量内核与驱动按基线目标编译
+    if (compileFlags.empty()) {
+        if (!build({sourceFile, "-o", exeFile})) return false;
+    } else {
+        std::string vectorObject = exeFile + ".vector.o";
+        std::vector<std::string> vectorArgs = {"-c", "-DCG_BENCH_VECTOR_ONLY"};
+        llvm::SmallVector<llvm::StringRef, 8> flags;
+        llvm::StringRef(compileFlags).split(flags, ' ', -1, false);
+        for (const auto& flag : flags) {
+            vectorArgs.push_back(flag.str());
+        }
+        vectorArgs.insert(vectorArgs.end(), {sourceFile, "-o", vectorObject});
+        if (!build(vectorArgs)) return false;
+        if (!build({"-DCG_BENCH_DRIVER_ONLY", sourceFile, vectorObject, "-o", exeFile})) return false;
+    }
+
+    // 【修复】生成的内核可能死循环（如边界推断错误），运行同样受超时限制
+    llvm::StringRef exeRef(exeFile);
+    int status = llvm::sys::ExecuteAndWait(exeRef, {exeRef}, {}, {}, timeoutSeconds, 0, &errMsg);
+    if (TimedOut(status, timeoutSeconds, errMsg)) {
+        llvm::errs() << "  [Bench] " << exeFile << " timed out after " << timeoutSeconds
+                     << " s, benchmark failed\n";
+        return false;
+    }
+    if (status != 0) {
+        llvm::errs() << "  [Bench] " << exeFile << " exited with status " << status
+                     << (errMsg.empty() ? "" : ": " + errMsg) << "\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace compute_graph
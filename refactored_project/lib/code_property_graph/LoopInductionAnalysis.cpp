@@ -0,0 +1,804 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * LoopInductionAnalysis.cpp - 循环归纳变量、迭代次数与访问步长分析
+ */
+#include "LoopInductionAnalysis.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace compute_graph {
+
+namespace {
+
+const clang::VarDecl* GetReferencedVar(const clang::Expr* expr)
+{
+    if (!expr) return nullptr;
+    if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(expr->IgnoreParenImpCasts())) {
+        return llvm::dyn_cast<clang::VarDecl>(ref->getDecl());
+    }
+    return nullptr;
+}
+
+bool IsLoopStmt(const clang::Stmt* stmt)
+{
+    return llvm::isa<clang::ForStmt>(stmt) || llvm::isa<clang::WhileStmt>(stmt) ||
+           llvm::isa<clang::DoStmt>(stmt) || llvm::isa<clang::CXXForRangeStmt>(stmt);
+}
+
+std::string FlipCompare(const std::string& op)
+{
+    if (op == "<") return ">";
+    if (op == "<=") return ">=";
+    if (op == ">") return "<";
+    if (op == ">=") return "<=";
+    return op;
+}
+
+// 把 "a + -b" 规整为 "a - b"
+std::string JoinTerms(const std::vector<std::string>& parts)
+{
+    std::string result;
+    for (const auto& part : parts) {
+        if (result.empty()) {
+            result = part;
+        } else if (!part.empty() && part[0] == '-') {
+            result += " - " + part.substr(1);
+        } else {
+            result += " + " + part;
+        }
+    }
+    return result;
+}
+
+std::string FormatTerm(int64_t coeff, const std::string& text)
+{
+    if (coeff == 1) return text;
+    if (coeff == -1) return "-" + text;
+    return std::to_string(coeff) + " * " + text;
+}
+
+} // namespace
+
+// ============================================
+// 结果结构
+// ============================================
+
+const InductionVariable* LoopInductionInfo::Find(const clang::VarDecl* var) const
+{
+    for (const auto& iv : inductionVars) {
+        if (iv.var == var) return &iv;
+    }
+    return nullptr;
+}
+
+std::string AffineIndex::ToString() const
+{
+    if (!isAffine) return "non-affine";
+
+    std::vector<std::string> parts;
+    if (!base.empty()) {
+        parts.push_back(base);
+    }
+    if (!ivName.empty()) {
+        if (!hasConstStride) {
+            parts.push_back(symbolicStride + " * " + ivName);
+        } else if (stride != 0) {
+            parts.push_back(FormatTerm(stride, ivName));
+        }
+    }
+    if (offset != 0 || parts.empty()) {
+        parts.push_back(std::to_string(offset));
+    }
+    return JoinTerms(parts);
+}
+
+std::string AffineIndex::StrideString() const
+{
+    if (!isAffine) return "unknown";
+    if (!hasConstStride) {
+        return ivStep == 1 ? symbolicStride :
+            std::to_string(ivStep) + " * (" + symbolicStride + ")";
+    }
+    return std::to_string(iterationStride);
+}
+
+// ============================================
+// 分析器
+// ============================================
+
+LoopInductionAnalysis::LoopInductionAnalysis(clang::ASTContext& ctx)
+    : astContext(ctx)
+{}
+
+const LoopInductionInfo& LoopInductionAnalysis::Analyze(const clang::Stmt* loopStmt)
+{
+    auto it = cache.find(loopStmt);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    LoopInductionInfo& info = cache[loopStmt];
+    info.loopStmt = loopStmt;
+    if (loopStmt) {
+        CollectInductionVars(loopStmt, info);
+    }
+    return info;
+}
+
+const clang::Stmt* LoopInductionAnalysis::FindEnclosingLoop(const clang::Stmt* stmt) const
+{
+    if (!stmt) return nullptr;
+
+    auto parents = astContext.getParents(*stmt);
+    while (!parents.empty()) {
+        const auto& parent = parents[0];
+
+        // 到达函数边界，停止查找
+        if (parent.get<clang::FunctionDecl>()) break;
+
+        if (const auto* pStmt = parent.get<clang::Stmt>()) {
+            if (llvm::isa<clang::LambdaExpr>(pStmt)) break;
+            if (IsLoopStmt(pStmt)) return pStmt;
+            parents = astContext.getParents(*pStmt);
+        } else if (const auto* pDecl = parent.get<clang::Decl>()) {
+            parents = astContext.getParents(*pDecl);
+        } else {
+            break;
+        }
+    }
+    return nullptr;
+}
+
+bool LoopInductionAnalysis::EvaluateConstant(const clang::Expr* expr, int64_t& value) const
+{
+    if (!expr || expr->isValueDependent() || expr->isTypeDependent()) {
+        return false;
+    }
+    clang::Expr::EvalResult result;
+    if (!expr->EvaluateAsInt(result, astContext)) {
+        return false;
+    }
+    value = result.Val.getInt().getExtValue();
+    return true;
+}
+
+// ============================================
+// 归纳变量识别
+// ============================================
+
+void LoopInductionAnalysis::CollectInductionVars(const clang::Stmt* loopStmt,
+                                                 LoopInductionInfo& info)
+{
+    const clang::Stmt* init = nullptr;
+    const clang::Expr* cond = nullptr;
+    const clang::Expr* inc = nullptr;
+    const clang::Stmt* body = nullptr;
+
+    if (const auto* forStmt = llvm::dyn_cast<clang::ForStmt>(loopStmt)) {
+        init = forStmt->getInit();
+        cond = forStmt->getCond();
+        inc = forStmt->getInc();
+        body = forStmt->getBody();
+    } else if (const auto* whileStmt = llvm::dyn_cast<clang::WhileStmt>(loopStmt)) {
+        cond = whileStmt->getCond();
+        body = whileStmt->getBody();
+    } else if (const auto* doStmt = llvm::dyn_cast<clang::DoStmt>(loopStmt)) {
+        cond = doStmt->getCond();
+        body = doStmt->getBody();
+    } else {
+        return;  // range-for 没有显式归纳变量
+    }
+
+    // 1. 收集每次迭代无条件执行的常量步长更新
+    std::map<const clang::VarDecl*, int64_t> steps;
+    CollectUpdates(inc, false, steps, info);
+    CollectUpdates(body, false, steps, info);
+    CollectUpdates(cond, false, steps, info);   // 如 while (i++ < n)
+
+    for (const auto& [var, step] : steps) {
+        // 循环体内声明的变量每次迭代重新初始化，不是归纳变量
+        if (step == 0 || info.variantVars.count(var) || info.bodyDefinitions.count(var)) {
+            info.variantVars.insert(var);
+            continue;
+        }
+        InductionVariable iv;
+        iv.var = var;
+        iv.name = var->getNameAsString();
+        iv.step = step;
+        ExtractStart(init, loopStmt, iv);
+        info.inductionVars.push_back(iv);
+    }
+    for (const auto* var : info.variantVars) {
+        info.bodyDefinitions.erase(var);
+    }
+    std::sort(info.inductionVars.begin(), info.inductionVars.end(),
+        [](const InductionVariable& a, const InductionVariable& b) {
+            return a.name < b.name;
+        });
+
+    // 2. 主归纳变量与边界，迭代次数
+    ExtractBound(cond, info);
+    ComputeTripCount(info);
+}
+
+void LoopInductionAnalysis::CollectUpdates(const clang::Stmt* stmt, bool conditional,
+                                           std::map<const clang::VarDecl*, int64_t>& steps,
+                                           LoopInductionInfo& info) const
+{
+    if (!stmt || llvm::isa<clang::LambdaExpr>(stmt)) return;
+
+    if (const auto* declStmt = llvm::dyn_cast<clang::DeclStmt>(stmt)) {
+        for (const auto* decl : declStmt->decls()) {
+            const auto* var = llvm::dyn_cast<clang::VarDecl>(decl);
+            if (var && var->getInit()) {
+                info.bodyDefinitions[var] = var->getInit();
+            }
+        }
+    }
+
+    if (const auto* expr = llvm::dyn_cast<clang::Expr>(stmt)) {
+        const clang::VarDecl* var = nullptr;
+        int64_t step = 0;
+        if (ExtractConstantStep(expr, var, step)) {
+            if (conditional) {
+                info.variantVars.insert(var);
+            } else {
+                steps[var] += step;
+            }
+        } else if (var) {
+            info.variantVars.insert(var);
+        }
+    }
+
+    // 分支、短路求值与内层循环中的更新不是每次迭代都执行
+    bool childConditional = conditional ||
+        llvm::isa<clang::IfStmt>(stmt) || llvm::isa<clang::SwitchStmt>(stmt) ||
+        llvm::isa<clang::ConditionalOperator>(stmt) || IsLoopStmt(stmt);
+    if (const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(stmt)) {
+        childConditional = childConditional || binOp->isLogicalOp();
+    }
+
+    for (const auto* child : stmt->children()) {
+        CollectUpdates(child, childConditional, steps, info);
+    }
+}
+
+bool LoopInductionAnalysis::ExtractConstantStep(const clang::Expr* update,
+                                                const clang::VarDecl*& var,
+                                                int64_t& step) const
+{
+    var = nullptr;
+    update = update->IgnoreParens();
+
+    // ++i / i--
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(update)) {
+        if (!unaryOp->isIncrementDecrementOp()) return false;
+        var = GetReferencedVar(unaryOp->getSubExpr());
+        if (!var) return false;
+        step = unaryOp->isIncrementOp() ? 1 : -1;
+        return true;
+    }
+
+    const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(update);
+    if (!binOp || !binOp->isAssignmentOp()) return false;
+
+    var = GetReferencedVar(binOp->getLHS());
+    if (!var) return false;
+
+    int64_t value = 0;
+    // i += k / i -= k
+    if (binOp->getOpcode() == clang::BO_AddAssign || binOp->getOpcode() == clang::BO_SubAssign) {
+        if (!EvaluateConstant(binOp->getRHS(), value)) return false;
+        step = binOp->getOpcode() == clang::BO_AddAssign ? value : -value;
+        return true;
+    }
+
+    // i = i + k / i = k + i / i = i - k
+    if (binOp->getOpcode() == clang::BO_Assign) {
+        const auto* rhs = llvm::dyn_cast<clang::BinaryOperator>(
+            binOp->getRHS()->IgnoreParenImpCasts());
+        if (!rhs || (rhs->getOpcode() != clang::BO_Add && rhs->getOpcode() != clang::BO_Sub)) {
+            return false;
+        }
+        if (GetReferencedVar(rhs->getLHS()) == var && EvaluateConstant(rhs->getRHS(), value)) {
+            step = rhs->getOpcode() == clang::BO_Add ? value : -value;
+            return true;
+        }
+        if (rhs->getOpcode() == clang::BO_Add && GetReferencedVar(rhs->getRHS()) == var &&
+            EvaluateConstant(rhs->getLHS(), value)) {
+            step = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+void LoopInductionAnalysis::ExtractStart(const clang::Stmt* init, const clang::Stmt* loopStmt,
+                                         InductionVariable& iv) const
+{
+    auto setStart = [&](const clang::Expr* value) {
+        iv.startExpr = GetSourceText(value, astContext);
+        iv.hasConstStart = EvaluateConstant(value, iv.start);
+    };
+
+    // 在一条语句中查找对 iv 的初始化/赋值
+    std::function<bool(const clang::Stmt*)> matchInit = [&](const clang::Stmt* stmt) -> bool {
+        if (!stmt) return false;
+        if (const auto* declStmt = llvm::dyn_cast<clang::DeclStmt>(stmt)) {
+            for (const auto* decl : declStmt->decls()) {
+                if (decl == iv.var && iv.var->getInit()) {
+                    setStart(iv.var->getInit());
+                    return true;
+                }
+            }
+            return false;
+        }
+        const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(stmt);
+        if (!binOp) return false;
+        if (binOp->getOpcode() == clang::BO_Comma) {
+            return matchInit(binOp->getRHS()) || matchInit(binOp->getLHS());
+        }
+        if (binOp->getOpcode() == clang::BO_Assign && GetReferencedVar(binOp->getLHS()) == iv.var) {
+            setStart(binOp->getRHS());
+            return true;
+        }
+        return false;
+    };
+
+    // 1. for 的初始化部分
+    if (matchInit(init)) return;
+
+    // 2. 循环前紧邻的同级语句（while/do 的常见写法）
+    auto parents = astContext.getParents(*loopStmt);
+    if (!parents.empty()) {
+        if (const auto* compound = parents[0].get<clang::CompoundStmt>()) {
+            std::vector<const clang::Stmt*> preceding;
+            for (const auto* child : compound->body()) {
+                if (child == loopStmt) break;
+                preceding.push_back(child);
+            }
+            for (auto it = preceding.rbegin(); it != preceding.rend(); ++it) {
+                if (matchInit(*it)) return;
+            }
+        }
+    }
+
+    // 3. 未找到：以进入循环时的变量值作为符号起始值
+    iv.startExpr = iv.name;
+    iv.hasConstStart = false;
+}
+
+void LoopInductionAnalysis::ExtractBound(const clang::Expr* cond, LoopInductionInfo& info) const
+{
+    if (!cond) return;
+
+    const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(cond->IgnoreParenImpCasts());
+    if (!binOp) return;
+
+    if (binOp->getOpcode() == clang::BO_LAnd) {
+        ExtractBound(binOp->getLHS(), info);
+        if (!info.GetPrimary()) {
+            ExtractBound(binOp->getRHS(), info);
+        }
+        return;
+    }
+    if (!binOp->isComparisonOp()) return;
+
+    std::string op = binOp->getOpcodeStr().str();
+    const clang::Expr* boundExpr = nullptr;
+    const clang::VarDecl* ivVar = GetReferencedVar(binOp->getLHS());
+    if (ivVar && info.Find(ivVar)) {
+        boundExpr = binOp->getRHS();
+    } else {
+        ivVar = GetReferencedVar(binOp->getRHS());
+        if (!ivVar || !info.Find(ivVar)) return;
+        boundExpr = binOp->getLHS();
+        op = FlipCompare(op);
+    }
+
+    // 主归纳变量移到首位
+    auto it = std::find_if(info.inductionVars.begin(), info.inductionVars.end(),
+        [ivVar](const InductionVariable& iv) { return iv.var == ivVar; });
+    std::rotate(info.inductionVars.begin(), it, it + 1);
+
+    InductionVariable& primary = info.inductionVars.front();
+    primary.isPrimary = true;
+    primary.compareOp = op;
+
+    // 边界在循环内变化时无法给出迭代次数
+    if (!IsLoopInvariant(boundExpr, info)) return;
+    primary.boundExpr = GetSourceText(boundExpr, astContext);
+    primary.hasConstBound = EvaluateConstant(boundExpr, primary.bound);
+}
+
+void LoopInductionAnalysis::ComputeTripCount(LoopInductionInfo& info) const
+{
+    const InductionVariable* iv = info.GetPrimary();
+    if (!iv || iv->boundExpr.empty() || iv->step == 0) return;
+
+    const std::string& op = iv->compareOp;
+    bool up = iv->step > 0;
+    int64_t step = std::llabs(iv->step);
+    bool inclusive = op == "<=" || op == ">=";
+
+    if (((op == "<" || op == "<=") && !up) || ((op == ">" || op == ">=") && up)) {
+        return;  // 步长方向与比较方向相反，迭代次数为0或不终止
+    }
+    if (op != "<" && op != "<=" && op != ">" && op != ">=" && op != "!=") {
+        return;
+    }
+
+    // 常量迭代次数
+    if (iv->hasConstStart && iv->hasConstBound) {
+        int64_t span = up ? iv->bound - iv->start : iv->start - iv->bound;
+        int64_t count = 0;
+        if (op == "!=") {
+            if (span < 0 || span % step != 0) return;
+            count = span / step;
+        } else {
+            if (inclusive) span += 1;
+            count = span <= 0 ? 0 : (span + step - 1) / step;
+        }
+        if (llvm::isa<clang::DoStmt>(info.loopStmt)) {
+            count = std::max<int64_t>(count, 1);
+        }
+        info.hasTripCount = true;
+        info.tripCount = count;
+        info.tripCountExpr = std::to_string(count);
+        return;
+    }
+
+    // 符号迭代次数
+    const std::string& hi = up ? iv->boundExpr : iv->startExpr;
+    const std::string& lo = up ? iv->startExpr : iv->boundExpr;
+    bool loIsZero = up ? (iv->hasConstStart && iv->start == 0) :
+                         (iv->hasConstBound && iv->bound == 0);
+    std::string span = loIsZero ? hi : hi + " - " + lo;
+    if (inclusive) span += " + 1";
+
+    if (step == 1) {
+        info.tripCountExpr = span;
+    } else if (op == "!=") {
+        info.tripCountExpr = "(" + span + ") / " + std::to_string(step);
+    } else {
+        info.tripCountExpr = "(" + span + " + " + std::to_string(step - 1) + ") / " +
+                             std::to_string(step);
+    }
+}
+
+// ============================================
+// 仿射下标
+// ============================================
+
+LoopInductionAnalysis::LinearForm LoopInductionAnalysis::Add(const LinearForm& a,
+                                                             const LinearForm& b,
+                                                             int64_t sign)
+{
+    LinearForm result = a;
+    result.ok = a.ok && b.ok;
+    result.constant += sign * b.constant;
+    for (const auto& [var, coeff] : b.ivCoeffs) {
+        result.ivCoeffs[var] += sign * coeff;
+        if (result.ivCoeffs[var] == 0) result.ivCoeffs.erase(var);
+    }
+    for (const auto& [coeff, text] : b.invariantTerms) {
+        result.invariantTerms.push_back({sign * coeff, text});
+    }
+    if (!b.symbolicCoeff.empty()) {
+        std::string term = sign < 0 ? "-(" + b.symbolicCoeff + ")" : b.symbolicCoeff;
+        if (result.symbolicCoeff.empty()) {
+            result.symbolicCoeff = term;
+            result.symbolicVar = b.symbolicVar;
+        } else if (result.symbolicVar == b.symbolicVar) {
+            result.symbolicCoeff = JoinTerms({result.symbolicCoeff, term});
+        } else {
+            result.ok = false;
+        }
+    }
+    return result;
+}
+
+LoopInductionAnalysis::LinearForm LoopInductionAnalysis::Scale(const LinearForm& a,
+                                                               int64_t factor)
+{
+    LinearForm result = a;
+    result.constant *= factor;
+    for (auto& [var, coeff] : result.ivCoeffs) {
+        coeff *= factor;
+    }
+    for (auto& term : result.invariantTerms) {
+        term.first *= factor;
+    }
+    if (!result.symbolicCoeff.empty() && factor != 1) {
+        result.symbolicCoeff = std::to_string(factor) + " * (" + result.symbolicCoeff + ")";
+    }
+    if (factor == 0) {
+        result.ivCoeffs.clear();
+        result.invariantTerms.clear();
+        result.symbolicCoeff.clear();
+        result.symbolicVar = nullptr;
+    }
+    return result;
+}
+
+bool LoopInductionAnalysis::IsLoopInvariant(const clang::Expr* expr,
+                                            const LoopInductionInfo& loop) const
+{
+    if (!expr) return true;
+
+    // 调用可能有副作用或依赖全局状态，保守处理
+    if (llvm::isa<clang::CallExpr>(expr)) return false;
+
+    if (const auto* var = GetReferencedVar(expr)) {
+        return !loop.Find(var) && !loop.variantVars.count(var) &&
+               !loop.bodyDefinitions.count(var);
+    }
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(expr)) {
+        if (unaryOp->isIncrementDecrementOp()) return false;
+    }
+    if (const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(expr)) {
+        if (binOp->isAssignmentOp()) return false;
+    }
+
+    // 读内存（a[j]、*p）按地址是否不变判断，不考虑循环内对同一地址的写
+    for (const auto* child : expr->children()) {
+        const auto* childExpr = llvm::dyn_cast_or_null<clang::Expr>(child);
+        if (childExpr && !IsLoopInvariant(childExpr, loop)) return false;
+    }
+    return true;
+}
+
+LoopInductionAnalysis::LinearForm LoopInductionAnalysis::Linearize(
+    const clang::Expr* expr, const LoopInductionInfo& loop, int depth) const
+{
+    LinearForm form;
+    if (!expr || depth > 16) {
+        form.ok = false;
+        return form;
+    }
+    expr = expr->IgnoreParenImpCasts();
+
+    int64_t value = 0;
+    if (EvaluateConstant(expr, value)) {
+        form.constant = value;
+        return form;
+    }
+
+    // 变量：归纳变量 / 循环内定义（代入其初始化）/ 不变量
+    if (const auto* var = GetReferencedVar(expr)) {
+        if (loop.Find(var)) {
+            form.ivCoeffs[var] = 1;
+        } else if (loop.variantVars.count(var)) {
+            form.ok = false;
+        } else if (loop.bodyDefinitions.count(var)) {
+            return Linearize(loop.bodyDefinitions.at(var), loop, depth + 1);
+        } else {
+            form.invariantTerms.push_back({1, var->getNameAsString()});
+        }
+        return form;
+    }
+
+    if (const auto* cast = llvm::dyn_cast<clang::ExplicitCastExpr>(expr)) {
+        return Linearize(cast->getSubExpr(), loop, depth + 1);
+    }
+
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(expr)) {
+        if (unaryOp->getOpcode() == clang::UO_Minus) {
+            return Scale(Linearize(unaryOp->getSubExpr(), loop, depth + 1), -1);
+        }
+        if (unaryOp->getOpcode() == clang::UO_Plus) {
+            return Linearize(unaryOp->getSubExpr(), loop, depth + 1);
+        }
+    }
+
+    auto isConstant = [](const LinearForm& f) {
+        return f.ivCoeffs.empty() && f.symbolicCoeff.empty() && f.invariantTerms.empty();
+    };
+    auto hasIV = [](const LinearForm& f) {
+        return !f.ivCoeffs.empty() || !f.symbolicCoeff.empty();
+    };
+
+    if (const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(expr)) {
+        switch (binOp->getOpcode()) {
+            case clang::BO_Add:
+            case clang::BO_Sub: {
+                LinearForm lhs = Linearize(binOp->getLHS(), loop, depth + 1);
+                LinearForm rhs = Linearize(binOp->getRHS(), loop, depth + 1);
+                return Add(lhs, rhs, binOp->getOpcode() == clang::BO_Add ? 1 : -1);
+            }
+            case clang::BO_Shl: {
+                LinearForm lhs = Linearize(binOp->getLHS(), loop, depth + 1);
+                if (EvaluateConstant(binOp->getRHS(), value) && value >= 0 && value < 62) {
+                    return Scale(lhs, int64_t(1) << value);
+                }
+                break;
+            }
+            case clang::BO_Mul: {
+                LinearForm lhs = Linearize(binOp->getLHS(), loop, depth + 1);
+                LinearForm rhs = Linearize(binOp->getRHS(), loop, depth + 1);
+                if (!lhs.ok || !rhs.ok) {
+                    form.ok = false;
+                    return form;
+                }
+                if (isConstant(lhs)) return Scale(rhs, lhs.constant);
+                if (isConstant(rhs)) return Scale(lhs, rhs.constant);
+                if (!hasIV(lhs) && !hasIV(rhs)) {
+                    form.invariantTerms.push_back({1, GetSourceText(expr, astContext)});
+                    return form;
+                }
+                if (hasIV(lhs) && hasIV(rhs)) {
+                    form.ok = false;   // 二次项
+                    return form;
+                }
+                // (k*iv + c) * inv：系数为符号不变量
+                const LinearForm& ivSide = hasIV(lhs) ? lhs : rhs;
+                const clang::Expr* invExpr = hasIV(lhs) ? binOp->getRHS() : binOp->getLHS();
+                if (ivSide.ivCoeffs.size() != 1 || !ivSide.symbolicCoeff.empty() ||
+                    !ivSide.invariantTerms.empty()) {
+                    form.ok = false;
+                    return form;
+                }
+                std::string invText = GetSourceText(invExpr->IgnoreParenImpCasts(), astContext);
+                const auto& [var, coeff] = *ivSide.ivCoeffs.begin();
+                form.symbolicVar = var;
+                form.symbolicCoeff = FormatTerm(coeff, invText);
+                if (ivSide.constant != 0) {
+                    form.invariantTerms.push_back({ivSide.constant, invText});
+                }
+                return form;
+            }
+            default:
+                break;
+        }
+    }
+
+    // 其他表达式：不含归纳变量时作为整体不变量，否则非仿射（如间接下标 a[idx[i]]）
+    if (IsLoopInvariant(expr, loop)) {
+        form.invariantTerms.push_back({1, GetSourceText(expr, astContext)});
+    } else {
+        form.ok = false;
+    }
+    return form;
+}
+
+LoopInductionAnalysis::LinearForm LoopInductionAnalysis::Flatten(
+    const clang::ArraySubscriptExpr* access, const LoopInductionInfo& loop,
+    std::string& rowBase) const
+{
+    LinearForm total;
+
+    // 1. 由外到内收集各维下标：a[x][y] -> [y, x]
+    std::vector<const clang::ArraySubscriptExpr*> levels;
+    for (const auto* cur = access; cur;
+         cur = llvm::dyn_cast<clang::ArraySubscriptExpr>(cur->getBase()->IgnoreParenImpCasts())) {
+        levels.push_back(cur);
+    }
+
+    // 2. 按行主序展开为元素下标；行长度未知（指针数组/变长数组）时外层作为基址
+    int64_t multiplier = 1;
+    for (size_t k = 0; k < levels.size(); ++k) {
+        LinearForm level = Linearize(levels[k]->getIdx(), loop);
+        if (!level.ok) return level;
+        total = Add(total, Scale(level, multiplier), 1);
+
+        if (k + 1 == levels.size()) break;
+        const auto* rowType = astContext.getAsConstantArrayType(levels[k + 1]->getType());
+        if (!rowType) {
+            if (!IsLoopInvariant(levels[k + 1], loop)) {
+                total.ok = false;
+                return total;
+            }
+            rowBase = GetSourceText(levels[k + 1], astContext);
+            break;
+        }
+        multiplier *= rowType->getSize().getSExtValue();
+    }
+    return total;
+}
+
+AffineIndex LoopInductionAnalysis::AnalyzeIndex(const clang::ArraySubscriptExpr* access,
+                                                const LoopInductionInfo& loop)
+{
+    AffineIndex result;
+    if (!access) return result;
+
+    std::string rowBase;
+    LinearForm total = Flatten(access, loop, rowBase);
+    if (!total.ok) return result;
+
+    // 3. 主归纳变量上的系数与每次迭代的步长
+    result.isAffine = true;
+    result.offset = total.constant;
+
+    const clang::VarDecl* mainVar = nullptr;
+    if (const InductionVariable* primary = loop.GetPrimary()) {
+        mainVar = primary->var;
+    }
+    if (!mainVar) {
+        for (const auto& iv : loop.inductionVars) {
+            if (total.ivCoeffs.count(iv.var)) {
+                mainVar = iv.var;
+                break;
+            }
+        }
+    }
+    if (!mainVar) mainVar = total.symbolicVar;
+
+    if (mainVar) {
+        result.ivName = mainVar->getNameAsString();
+        auto it = total.ivCoeffs.find(mainVar);
+        result.stride = it != total.ivCoeffs.end() ? it->second : 0;
+    }
+    for (const auto& iv : loop.inductionVars) {
+        auto it = total.ivCoeffs.find(iv.var);
+        if (it != total.ivCoeffs.end()) {
+            result.iterationStride += it->second * iv.step;
+        }
+    }
+    if (!total.symbolicCoeff.empty()) {
+        result.hasConstStride = false;
+        result.symbolicStride = total.symbolicCoeff;
+        if (const InductionVariable* symIv = loop.Find(total.symbolicVar)) {
+            result.ivStep = symIv->step;
+        }
+        if (total.symbolicVar != mainVar) {
+            result.ivName = total.symbolicVar->getNameAsString();
+        }
+    }
+
+    std::vector<std::string> baseParts;
+    if (!rowBase.empty()) baseParts.push_back(rowBase);
+    for (const auto& [coeff, text] : total.invariantTerms) {
+        if (coeff != 0) baseParts.push_back(FormatTerm(coeff, text));
+    }
+    result.base = JoinTerms(baseParts);
+    return result;
+}
+
+std::vector<const clang::Stmt*> LoopInductionAnalysis::GetLoopNest(const clang::Stmt* stmt) const
+{
+    std::vector<const clang::Stmt*> nest;
+    for (const clang::Stmt* loop = FindEnclosingLoop(stmt); loop; loop = FindEnclosingLoop(loop)) {
+        nest.push_back(loop);
+    }
+    return nest;
+}
+
+NestedIndexForm LoopInductionAnalysis::AnalyzeIndexInNest(
+    const clang::ArraySubscriptExpr* access, const std::vector<const clang::Stmt*>& nest)
+{
+    NestedIndexForm result;
+    if (!access) return result;
+
+    // 合并整个嵌套的归纳信息：外层归纳变量在内层视为不变量，这里作为自变量保留
+    LoopInductionInfo merged;
+    for (const auto* loopStmt : nest) {
+        const LoopInductionInfo& info = Analyze(loopStmt);
+        merged.inductionVars.insert(merged.inductionVars.end(),
+                                    info.inductionVars.begin(), info.inductionVars.end());
+        merged.variantVars.insert(info.variantVars.begin(), info.variantVars.end());
+        merged.bodyDefinitions.insert(info.bodyDefinitions.begin(), info.bodyDefinitions.end());
+    }
+    for (const auto& iv : merged.inductionVars) {
+        merged.variantVars.erase(iv.var);
+    }
+
+    std::string rowBase;
+    LinearForm total = Flatten(access, merged, rowBase);
+    if (!total.ok || !total.symbolicCoeff.empty()) return result;
+
+    result.isAffine = true;
+    result.ivCoeffs = total.ivCoeffs;
+    result.constant = total.constant;
+    if (!rowBase.empty()) {
+        result.invariantTerms.push_back({1, rowBase});
+    }
+    for (const auto& term : total.invariantTerms) {
+        if (term.first != 0) result.invariantTerms.push_back(term);
+    }
+    std::sort(result.invariantTerms.begin(), result.invariantTerms.end());
+    return result;
+}
+
+} // namespace compute_graph
@@ -0,0 +1,623 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * PathFeasibility.cpp - 路径条件的区间/差分约束可行性判定
+ */
+
+#include "code_property_graph/PathFeasibility.h"
+
+#include "clang/AST/ParentMapContext.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace cpg {
+
+namespace {
+
+constexpr int kMaxExprDepth = 8;
+constexpr size_t kMaxDisjuncts = 16;        // 单个条件展开后的析取项上限
+constexpr size_t kMaxCombinations = 64;     // 整条路径同时保留的析取组合上限
+constexpr size_t kMaxSymbols = 24;          // DBM 的变量数上限，超出的原子不参与判定
+constexpr int64_t kInf = std::numeric_limits<int64_t>::max() / 4;
+constexpr int64_t kConstLimit = int64_t(1) << 50;      // 常量与偏移的绝对值上限，保证约束相加不溢出
+
+int64_t SatAdd(int64_t a, int64_t b)
+{
+    if (a >= kInf || b >= kInf) return kInf;
+    int64_t sum = a + b;
+    return std::max(std::min(sum, kInf), -kInf);
+}
+
+clang::BinaryOperatorKind Negate(clang::BinaryOperatorKind op)
+{
+    switch (op) {
+        case clang::BO_LT: return clang::BO_GE;
+        case clang::BO_LE: return clang::BO_GT;
+        case clang::BO_GT: return clang::BO_LE;
+        case clang::BO_GE: return clang::BO_LT;
+        case clang::BO_EQ: return clang::BO_NE;
+        default: return clang::BO_EQ;
+    }
+}
+
+// 统计函数体内变量的“稳定性”：每次出现都只是被读取（左值到右值转换）、声明不在循环内
+class StabilityScanner : public clang::RecursiveASTVisitor<StabilityScanner> {
+public:
+    std::map<const clang::VarDecl*, size_t> refs;
+    std::map<const clang::VarDecl*, size_t> reads;
+    std::set<const clang::VarDecl*> declaredInLoop;
+    std::set<const clang::VarDecl*> locals;
+    bool hasGoto = false;
+
+    bool VisitDeclRefExpr(clang::DeclRefExpr* ref)
+    {
+        if (auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl())) {
+            refs[var]++;
+        }
+        return true;
+    }
+
+    bool VisitImplicitCastExpr(clang::ImplicitCastExpr* cast)
+    {
+        if (cast->getCastKind() != clang::CK_LValueToRValue) return true;
+        if (auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(cast->getSubExpr()->IgnoreParens())) {
+            if (auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl())) {
+                reads[var]++;
+            }
+        }
+        return true;
+    }
+
+    bool VisitVarDecl(clang::VarDecl* var)
+    {
+        if (!llvm::isa<clang::ParmVarDecl>(var)) {
+            locals.insert(var);
+            if (loopDepth > 0) declaredInLoop.insert(var);
+        }
+        return true;
+    }
+
+    bool VisitGotoStmt(clang::GotoStmt*) { hasGoto = true; return true; }
+    bool VisitIndirectGotoStmt(clang::IndirectGotoStmt*) { hasGoto = true; return true; }
+
+    bool TraverseForStmt(clang::ForStmt* s) { return InLoop([&] { return Base::TraverseForStmt(s); }); }
+    bool TraverseWhileStmt(clang::WhileStmt* s) { return InLoop([&] { return Base::TraverseWhileStmt(s); }); }
+    bool TraverseDoStmt(clang::DoStmt* s) { return InLoop([&] { return Base::TraverseDoStmt(s); }); }
+    bool TraverseCXXForRangeStmt(clang::CXXForRangeStmt* s)
+    {
+        return InLoop([&] { return Base::TraverseCXXForRangeStmt(s); });
+    }
+
+private:
+    using Base = clang::RecursiveASTVisitor<StabilityScanner>;
+    int loopDepth = 0;
+
+    template <typename Fn>
+    bool InLoop(Fn fn)
+    {
+        loopDepth++;
+        bool result = fn();
+        loopDepth--;
+        return result;
+    }
+};
+
+} // namespace
+
+// ============================================
+// 对外接口
+// ============================================
+
+bool PathFeasibilityChecker::IsFeasible(const PathCondition& path)
+{
+    checked++;
+
+    std::vector<Conjunction> combos(1);
+    for (const auto& [stmt, value] : path.conditions) {
+        Disjunction alternatives = DecomposeStmt(stmt, value);
+        if (alternatives.empty()) {
+            infeasible++;
+            return false;
+        }
+        // 超出组合上限的析取条件放弃，只会少剪不会误剪
+        if (alternatives.size() > 1 && combos.size() * alternatives.size() > kMaxCombinations) {
+            continue;
+        }
+
+        std::vector<Conjunction> next;
+        for (const auto& combo : combos) {
+            for (const auto& alt : alternatives) {
+                Conjunction merged = combo;
+                merged.insert(merged.end(), alt.begin(), alt.end());
+                if (IsConsistent(merged)) {
+                    next.push_back(std::move(merged));
+                }
+            }
+        }
+        if (next.empty()) {
+            infeasible++;
+            return false;
+        }
+        combos.swap(next);
+    }
+    return true;
+}
+
+// ============================================
+// 条件展开
+// ============================================
+
+PathFeasibilityChecker::Disjunction PathFeasibilityChecker::DecomposeStmt(const clang::Stmt* cond, bool value)
+{
+    if (!cond) return Disjunction(1);
+
+    // 没有给定 ASTContext 时取条件里第一个声明引用所在的上下文（常量折叠需要）
+    if (!astContext) {
+        std::vector<const clang::Stmt*> worklist{cond};
+        while (!worklist.empty() && !astContext) {
+            const clang::Stmt* s = worklist.back();
+            worklist.pop_back();
+            if (auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(s)) {
+                ContextFor(ref->getDecl());
+            }
+            for (const clang::Stmt* child : s->children()) {
+                if (child) worklist.push_back(child);
+            }
+        }
+    }
+
+    if (auto* ifStmt = llvm::dyn_cast<clang::IfStmt>(cond)) {
+        return DecomposeExpr(ifStmt->getCond(), value, 0);
+    }
+    if (auto* whileStmt = llvm::dyn_cast<clang::WhileStmt>(cond)) {
+        return DecomposeExpr(whileStmt->getCond(), value, 0);
+    }
+    if (auto* forStmt = llvm::dyn_cast<clang::ForStmt>(cond)) {
+        return forStmt->getCond() ? DecomposeExpr(forStmt->getCond(), value, 0) : Disjunction(value ? 1 : 0);
+    }
+    if (auto* doStmt = llvm::dyn_cast<clang::DoStmt>(cond)) {
+        return DecomposeExpr(doStmt->getCond(), value, 0);
+    }
+    if (auto* label = llvm::dyn_cast<clang::SwitchCase>(cond)) {
+        return DecomposeCase(label, value);
+    }
+    if (auto* expr = llvm::dyn_cast<clang::Expr>(cond)) {
+        return DecomposeExpr(expr, value, 0);
+    }
+    return Disjunction(1);
+}
+
+PathFeasibilityChecker::Disjunction PathFeasibilityChecker::DecomposeExpr(
+    const clang::Expr* expr, bool value, int depth)
+{
+    if (!expr || depth > kMaxExprDepth) return Disjunction(1);
+    const clang::Expr* e = expr->IgnoreParenImpCasts();
+
+    int64_t constant = 0;
+    if (EvaluateConstant(expr, constant)) {
+        return Disjunction(((constant != 0) == value) ? 1 : 0);
+    }
+
+    if (auto* unary = llvm::dyn_cast<clang::UnaryOperator>(e)) {
+        if (unary->getOpcode() == clang::UO_LNot) {
+            return DecomposeExpr(unary->getSubExpr(), !value, depth + 1);
+        }
+        return Disjunction(1);
+    }
+
+    if (auto* binary = llvm::dyn_cast<clang::BinaryOperator>(e)) {
+        clang::BinaryOperatorKind op = binary->getOpcode();
+        if (op == clang::BO_LAnd || op == clang::BO_LOr) {
+            Disjunction lhs = DecomposeExpr(binary->getLHS(), value, depth + 1);
+            Disjunction rhs = DecomposeExpr(binary->getRHS(), value, depth + 1);
+            // a&&b 为真 / a||b 为假：两边同时成立；否则任一边成立
+            bool conjunctive = (op == clang::BO_LAnd) == value;
+            return conjunctive ? And(lhs, rhs) : Or(lhs, rhs);
+        }
+        if (binary->isComparisonOp()) {
+            return DecomposeComparison(binary->getLHS(), binary->getRHS(), op, value);
+        }
+        return Disjunction(1);
+    }
+
+    // 单独的整型变量作条件：v != 0
+    if (llvm::isa<clang::DeclRefExpr>(e) && e->getType()->isIntegralOrEnumerationType()) {
+        Conjunction implied;
+        Term term;
+        if (!ToTerm(e, e->getType(), term, implied)) return Disjunction(1);
+        Atom atom;
+        atom.lhs = term;
+        atom.op = value ? clang::BO_NE : clang::BO_EQ;
+        implied.push_back(atom);
+        return Disjunction(1, implied);
+    }
+    return Disjunction(1);
+}
+
+PathFeasibilityChecker::Disjunction PathFeasibilityChecker::DecomposeComparison(
+    const clang::Expr* lhs, const clang::Expr* rhs, clang::BinaryOperatorKind op, bool value)
+{
+    // 比较在转换后的公共类型上进行，只处理整型
+    clang::QualType cmpType = lhs->getType();
+    if (!cmpType->isIntegralOrEnumerationType() || !rhs->getType()->isIntegralOrEnumerationType()) {
+        return Disjunction(1);
+    }
+
+    Conjunction conj;
+    Atom atom;
+    if (!ToTerm(lhs, cmpType, atom.lhs, conj) || !ToTerm(rhs, cmpType, atom.rhs, conj)) {
+        return Disjunction(1);
+    }
+    atom.op = value ? op : Negate(op);
+    conj.push_back(atom);
+    return Disjunction(1, conj);
+}
+
+PathFeasibilityChecker::Disjunction PathFeasibilityChecker::DecomposeCase(
+    const clang::SwitchCase* label, bool value)
+{
+    clang::ASTContext* ctx = astContext;
+    if (!ctx) return Disjunction(1);
+
+    // 向上找所属的 switch
+    const clang::SwitchStmt* switchStmt = nullptr;
+    clang::DynTypedNode node = clang::DynTypedNode::create(*label);
+    for (int hops = 0; hops < 64 && !switchStmt; ++hops) {
+        auto parents = ctx->getParents(node);
+        if (parents.empty()) break;
+        node = parents[0];
+        switchStmt = node.get<clang::SwitchStmt>();
+    }
+    if (!switchStmt || !switchStmt->getCond() || switchStmt->getConditionVariable()) {
+        return Disjunction(1);
+    }
+
+    const clang::Expr* cond = switchStmt->getCond();
+    clang::QualType cmpType = cond->getType();
+    Conjunction base;
+    Term subject;
+    if (!cmpType->isIntegralOrEnumerationType() || !ToTerm(cond, cmpType, subject, base)) {
+        return Disjunction(1);
+    }
+
+    auto equalsCase = [&](const clang::CaseStmt* caseStmt, bool equal, Disjunction& out) {
+        int64_t lo = 0;
+        int64_t hi = 0;
+        if (!EvaluateConstant(caseStmt->getLHS(), lo)) return false;
+        hi = lo;
+        if (caseStmt->caseStmtIsGNURange() && !EvaluateConstant(caseStmt->getRHS(), hi)) return false;
+
+        Atom lower;
+        lower.lhs = subject;
+        lower.rhs.offset = lo;
+        Atom upper = lower;
+        upper.rhs.offset = hi;
+        if (equal) {
+            lower.op = clang::BO_GE;
+            upper.op = clang::BO_LE;
+            Conjunction conj = base;
+            conj.push_back(lower);
+            conj.push_back(upper);
+            out.push_back(conj);
+        } else {
+            lower.op = clang::BO_LT;
+            upper.op = clang::BO_GT;
+            Conjunction below = base;
+            below.push_back(lower);
+            Conjunction above = base;
+            above.push_back(upper);
+            out.push_back(below);
+            out.push_back(above);
+        }
+        return true;
+    };
+
+    if (auto* caseStmt = llvm::dyn_cast<clang::CaseStmt>(label)) {
+        Disjunction result;
+        return equalsCase(caseStmt, value, result) ? result : Disjunction(1);
+    }
+
+    // default：与所有 case 都不相等；不进入 default 则等于其中之一
+    Disjunction result(1, base);
+    Disjunction anyCase;
+    for (const clang::SwitchCase* sc = switchStmt->getSwitchCaseList(); sc; sc = sc->getNextSwitchCase()) {
+        auto* caseStmt = llvm::dyn_cast<clang::CaseStmt>(sc);
+        if (!caseStmt) continue;
+        Disjunction one;
+        if (!equalsCase(caseStmt, !value, one)) return Disjunction(1);
+        if (value) {
+            result = And(result, one);
+        } else {
+            anyCase = Or(anyCase, one);
+        }
+    }
+    return value ? result : anyCase;
+}
+
+// ============================================
+// 项与常量
+// ============================================
+
+bool PathFeasibilityChecker::ToTerm(const clang::Expr* expr, clang::QualType cmpType, Term& term,
+                                    Conjunction& implied)
+{
+    int64_t constant = 0;
+    if (EvaluateConstant(expr, constant)) {
+        term.var = nullptr;
+        term.offset = constant;
+        return true;
+    }
+
+    const clang::Expr* e = expr->IgnoreParenImpCasts();
+    bool unsignedCmp = cmpType->isUnsignedIntegerOrEnumerationType();
+
+    // v + c / c + v / v - c（无符号比较下会回绕，不处理）
+    if (auto* binary = llvm::dyn_cast<clang::BinaryOperator>(e)) {
+        clang::BinaryOperatorKind op = binary->getOpcode();
+        if (unsignedCmp || (op != clang::BO_Add && op != clang::BO_Sub)) return false;
+
+        int64_t c = 0;
+        const clang::Expr* varSide = nullptr;
+        if (EvaluateConstant(binary->getRHS(), c)) {
+            varSide = binary->getLHS();
+            if (op == clang::BO_Sub) c = -c;
+        } else if (op == clang::BO_Add && EvaluateConstant(binary->getLHS(), c)) {
+            varSide = binary->getRHS();
+        } else {
+            return false;
+        }
+        if (!binary->getType()->isSignedIntegerOrEnumerationType()) return false;
+        if (!ToTerm(varSide, binary->getType(), term, implied) || !term.var) return false;
+        term.offset += c;
+        return term.offset > -kConstLimit && term.offset < kConstLimit;
+    }
+
+    auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(e);
+    if (!ref) return false;
+    auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl());
+    if (!var) return false;
+    ContextFor(var);
+
+    clang::QualType varType = var->getType();
+    if (!varType->isIntegralOrEnumerationType() || varType.isVolatileQualified()) return false;
+    if (!IsStable(var)) return false;
+
+    // 无符号比较只接受与比较类型完全一致的变量（有符号变量转成无符号会改变取值）
+    if (unsignedCmp && varType.getCanonicalType().getUnqualifiedType() !=
+                       cmpType.getCanonicalType().getUnqualifiedType()) {
+        return false;
+    }
+
+    term.var = var;
+    term.offset = 0;
+
+    // 值域常识：无符号/布尔变量非负，布尔不超过1
+    if (varType->isUnsignedIntegerOrEnumerationType() || varType->isBooleanType()) {
+        Atom nonNegative;
+        nonNegative.lhs.var = var;
+        nonNegative.op = clang::BO_GE;
+        implied.push_back(nonNegative);
+    }
+    if (varType->isBooleanType()) {
+        Atom atMostOne;
+        atMostOne.lhs.var = var;
+        atMostOne.rhs.offset = 1;
+        atMostOne.op = clang::BO_LE;
+        implied.push_back(atMostOne);
+    }
+    return true;
+}
+
+bool PathFeasibilityChecker::EvaluateConstant(const clang::Expr* expr, int64_t& value)
+{
+    if (!expr) return false;
+
+    llvm::APSInt result;
+    if (astContext) {
+        if (expr->isValueDependent() || expr->isTypeDependent()) return false;
+        clang::Expr::EvalResult eval;
+        if (!expr->EvaluateAsInt(eval, *astContext)) return false;
+        result = eval.Val.getInt();
+    } else if (auto* literal = llvm::dyn_cast<clang::IntegerLiteral>(expr->IgnoreParenImpCasts())) {
+        result = llvm::APSInt(literal->getValue(), literal->getType()->isUnsignedIntegerType());
+    } else {
+        return false;
+    }
+
+    if (result.isSigned() ? !result.isSignedIntN(48) : result.getActiveBits() > 47) return false;
+    value = result.getExtValue();
+    return true;
+}
+
+clang::ASTContext* PathFeasibilityChecker::ContextFor(const clang::Decl* decl)
+{
+    if (!astContext && decl) {
+        astContext = &decl->getASTContext();
+    }
+    return astContext;
+}
+
+bool PathFeasibilityChecker::IsStable(const clang::VarDecl* var)
+{
+    if (!var->hasLocalStorage() || var->getType()->isReferenceType()) return false;
+
+    auto* func = llvm::dyn_cast_or_null<clang::FunctionDecl>(var->getParentFunctionOrMethod());
+    if (!func) return false;
+    const clang::FunctionDecl* definition = nullptr;
+    const clang::Stmt* body = func->getBody(definition);
+    if (!body || !definition) return false;
+
+    auto cached = stableVarsCache.find(definition);
+    if (cached == stableVarsCache.end()) {
+        StabilityScanner scanner;
+        scanner.TraverseStmt(const_cast<clang::Stmt*>(body));
+
+        std::set<const clang::VarDecl*> stable;
+        auto consider = [&](const clang::VarDecl* candidate) {
+            if (scanner.declaredInLoop.count(candidate)) return;
+            if (scanner.hasGoto && !llvm::isa<clang::ParmVarDecl>(candidate)) return;
+            auto refIt = scanner.refs.find(candidate);
+            size_t refCount = refIt == scanner.refs.end() ? 0 : refIt->second;
+            auto readIt = scanner.reads.find(candidate);
+            size_t readCount = readIt == scanner.reads.end() ? 0 : readIt->second;
+            if (refCount == readCount) stable.insert(candidate);
+        };
+        for (const clang::ParmVarDecl* param : definition->parameters()) {
+            consider(param);
+        }
+        for (const clang::VarDecl* local : scanner.locals) {
+            consider(local);
+        }
+        cached = stableVarsCache.emplace(definition, std::move(stable)).first;
+    }
+
+    // 形参可能来自另一个重声明，按下标映射到定义上的形参
+    if (auto* param = llvm::dyn_cast<clang::ParmVarDecl>(var)) {
+        unsigned index = param->getFunctionScopeIndex();
+        if (index < definition->getNumParams()) {
+            var = definition->getParamDecl(index);
+        }
+    }
+    return cached->second.count(var) > 0;
+}
+
+// ============================================
+// 析取范式组合
+// ============================================
+
+PathFeasibilityChecker::Disjunction PathFeasibilityChecker::And(const Disjunction& a, const Disjunction& b)
+{
+    if (a.empty() || b.empty()) return {};
+    if (a.size() * b.size() > kMaxDisjuncts) {
+        // 丢掉项数多的一边（弱化约束）
+        return a.size() <= b.size() ? a : b;
+    }
+    Disjunction result;
+    for (const auto& x : a) {
+        for (const auto& y : b) {
+            Conjunction merged = x;
+            merged.insert(merged.end(), y.begin(), y.end());
+            result.push_back(std::move(merged));
+        }
+    }
+    return result;
+}
+
+PathFeasibilityChecker::Disjunction PathFeasibilityChecker::Or(const Disjunction& a, const Disjunction& b)
+{
+    if (a.size() + b.size() > kMaxDisjuncts) return Disjunction(1);
+    Disjunction result = a;
+    result.insert(result.end(), b.begin(), b.end());
+    return result;
+}
+
+// ============================================
+// 差分约束判定
+// ============================================
+
+bool PathFeasibilityChecker::IsConsistent(const Conjunction& atoms)
+{
+    // 下标0为常量0，其余为变量
+    std::map<const clang::VarDecl*, size_t> index;
+    auto symbol = [&](const clang::VarDecl* var) -> int {
+        if (!var) return 0;
+        auto it = index.find(var);
+        if (it != index.end()) return static_cast<int>(it->second);
+        if (index.size() >= kMaxSymbols) return -1;
+        size_t id = index.size() + 1;
+        index.emplace(var, id);
+        return static_cast<int>(id);
+    };
+
+    // x - y <= c
+    struct Bound { int x; int y; int64_t c; };
+    std::vector<Bound> bounds;
+    struct NotEqual { int x; int y; int64_t c; };
+    std::vector<NotEqual> notEquals;
+
+    for (const Atom& atom : atoms) {
+        int x = symbol(atom.lhs.var);
+        int y = symbol(atom.rhs.var);
+        if (x < 0 || y < 0) continue;
+        // (x + a) op (y + b)  <=>  x - y op b - a
+        int64_t k = atom.rhs.offset - atom.lhs.offset;
+
+        if (x == y) {
+            // 两边同一变量（或都是常量）：0 op k
+            bool holds = true;
+            switch (atom.op) {
+                case clang::BO_LT: holds = 0 < k; break;
+                case clang::BO_LE: holds = 0 <= k; break;
+                case clang::BO_GT: holds = 0 > k; break;
+                case clang::BO_GE: holds = 0 >= k; break;
+                case clang::BO_EQ: holds = 0 == k; break;
+                case clang::BO_NE: holds = 0 != k; break;
+                default: break;
+            }
+            if (!holds) return false;
+            continue;
+        }
+
+        switch (atom.op) {
+            case clang::BO_LE: bounds.push_back({x, y, k}); break;
+            case clang::BO_LT: bounds.push_back({x, y, k - 1}); break;
+            case clang::BO_GE: bounds.push_back({y, x, -k}); break;
+            case clang::BO_GT: bounds.push_back({y, x, -k - 1}); break;
+            case clang::BO_EQ:
+                bounds.push_back({x, y, k});
+                bounds.push_back({y, x, -k});
+                break;
+            case clang::BO_NE: notEquals.push_back({x, y, k}); break;
+            default: break;
+        }
+    }
+    if (bounds.empty()) return true;
+
+    size_t n = index.size() + 1;
+    std::vector<std::vector<int64_t>> d(n, std::vector<int64_t>(n, kInf));
+    for (size_t i = 0; i < n; ++i) d[i][i] = 0;
+    for (const Bound& b : bounds) {
+        d[b.x][b.y] = std::min(d[b.x][b.y], b.c);
+    }
+
+    auto close = [&]() {
+        for (size_t k = 0; k < n; ++k) {
+            for (size_t i = 0; i < n; ++i) {
+                if (d[i][k] >= kInf) continue;
+                for (size_t j = 0; j < n; ++j) {
+                    int64_t via = SatAdd(d[i][k], d[k][j]);
+                    if (via < d[i][j]) d[i][j] = via;
+                }
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (d[i][i] < 0) return false;
+        }
+        return true;
+    };
+
+    if (!close()) return false;
+
+    // x - y != k：k 恰在边界上时收紧一格，区间收缩为空即矛盾
+    for (size_t round = 0; round <= notEquals.size(); ++round) {
+        bool changed = false;
+        for (const NotEqual& ne : notEquals) {
+            int64_t upper = d[ne.x][ne.y];
+            int64_t lower = d[ne.y][ne.x] >= kInf ? -kInf : -d[ne.y][ne.x];
+            if (upper == ne.c && lower == ne.c) return false;
+            if (upper == ne.c) {
+                d[ne.x][ne.y] = ne.c - 1;
+                changed = true;
+            } else if (lower == ne.c) {
+                d[ne.y][ne.x] = -(ne.c + 1);
+                changed = true;
+            }
+        }
+        if (!changed) break;
+        if (!close()) return false;
+    }
+    return true;
+}
+
+} // namespace cpg
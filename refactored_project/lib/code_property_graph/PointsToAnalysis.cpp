@@ -0,0 +1,1495 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * PointsToAnalysis.cpp - 字段敏感指针分析实现
+ *
+ * 约束变量与对象共用编号：对象 o 的约束变量的指向集合即 o 中存放的指针所指对象。
+ * 表达式 e 的 Addr(e) 指向 e 所在的对象，Val(e) 指向 e 的值所指的对象。
+ */
+#include "code_property_graph/PointsToAnalysis.h"
+#include "code_property_graph/CPGAnnotation.h"
+
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/ExprCXX.h"
+#include "clang/AST/ParentMapContext.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace cpg {
+
+// ============================================
+// 求解器
+// ============================================
+
+class PointsToSolver {
+public:
+    virtual ~PointsToSolver() = default;
+
+    virtual int NewVar() = 0;
+    virtual size_t VarCount() const = 0;
+    virtual void AddrOf(int dst, int obj) = 0;
+    virtual void Copy(int dst, int src) = 0;
+    virtual void Load(int dst, int ptr) = 0;
+    virtual void Store(int ptr, int src) = 0;
+    virtual void FieldAddr(int dst, int ptr, const clang::FieldDecl* field) = 0;
+    virtual void Solve() {}
+
+    // a、b 指向的对象是否可能重叠（同一对象，或一个是另一个的字段）
+    virtual bool MayOverlap(int a, int b) = 0;
+};
+
+namespace {
+
+// 合一求解：每个等价类至多一个指向类，字段按 FieldDecl 挂在类上
+class SteensgaardSolver : public PointsToSolver {
+public:
+    int NewVar() override
+    {
+        int id = static_cast<int>(parent.size());
+        parent.push_back(id);
+        pointee.push_back(-1);
+        fields.emplace_back();
+        return id;
+    }
+
+    size_t VarCount() const override { return parent.size(); }
+
+    void AddrOf(int dst, int obj) override { Unify(Pointee(dst), obj); }
+    void Copy(int dst, int src) override { Unify(Pointee(dst), Pointee(src)); }
+    void Load(int dst, int ptr) override { Unify(Pointee(dst), Pointee(Pointee(ptr))); }
+    void Store(int ptr, int src) override { Unify(Pointee(Pointee(ptr)), Pointee(src)); }
+
+    void FieldAddr(int dst, int ptr, const clang::FieldDecl* field) override
+    {
+        int base = Pointee(ptr);
+        Unify(Pointee(dst), FieldOf(base, field));
+    }
+
+    bool MayOverlap(int a, int b) override
+    {
+        int ra = Find(a);
+        int rb = Find(b);
+        if (pointee[ra] < 0 || pointee[rb] < 0) {
+            return false;
+        }
+        int ca = Find(pointee[ra]);
+        int cb = Find(pointee[rb]);
+        return ca == cb || ContainsField(ca, cb) || ContainsField(cb, ca);
+    }
+
+private:
+    std::vector<int> parent;
+    std::vector<int> pointee;
+    std::vector<std::map<const clang::FieldDecl*, int>> fields;
+
+    int Find(int v)
+    {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    }
+
+    int Pointee(int v)
+    {
+        v = Find(v);
+        if (pointee[v] < 0) {
+            int target = NewVar();
+            pointee[v] = target;
+        }
+        return Find(pointee[v]);
+    }
+
+    int FieldOf(int cls, const clang::FieldDecl* field)
+    {
+        cls = Find(cls);
+        auto it = fields[cls].find(field);
+        if (it != fields[cls].end()) {
+            return Find(it->second);
+        }
+        int child = NewVar();
+        fields[cls][field] = child;
+        return child;
+    }
+
+    void Unify(int a, int b)
+    {
+        std::vector<std::pair<int, int>> work{{a, b}};
+        while (!work.empty()) {
+            auto [x, y] = work.back();
+            work.pop_back();
+            x = Find(x);
+            y = Find(y);
+            if (x == y) {
+                continue;
+            }
+            if (fields[x].size() < fields[y].size()) {
+                std::swap(x, y);
+            }
+            parent[y] = x;
+            if (pointee[y] >= 0) {
+                if (pointee[x] < 0) {
+                    pointee[x] = pointee[y];
+                } else {
+                    work.push_back({pointee[x], pointee[y]});
+                }
+            }
+            for (const auto& [field, child] : fields[y]) {
+                auto it = fields[x].find(field);
+                if (it == fields[x].end()) {
+                    fields[x][field] = child;
+                } else {
+                    work.push_back({it->second, child});
+                }
+            }
+            fields[y].clear();
+        }
+    }
+
+    // inner 是否为 outer 的（嵌套）字段
+    bool ContainsField(int outer, int inner)
+    {
+        std::vector<int> stack{outer};
+        std::set<int> visited;
+        while (!stack.empty()) {
+            int cls = Find(stack.back());
+            stack.pop_back();
+            if (!visited.insert(cls).second) {
+                continue;
+            }
+            for (const auto& entry : fields[cls]) {
+                int child = Find(entry.second);
+                if (child == inner) {
+                    return true;
+                }
+                stack.push_back(child);
+            }
+        }
+        return false;
+    }
+};
+
+// 包含关系求解：增量工作表，字段子对象在基对象出现时按需创建
+class AndersenSolver : public PointsToSolver {
+public:
+    int NewVar() override
+    {
+        vars.emplace_back();
+        queued.push_back(false);
+        return static_cast<int>(vars.size() - 1);
+    }
+
+    size_t VarCount() const override { return vars.size(); }
+
+    void AddrOf(int dst, int obj) override
+    {
+        if (vars[dst].pts.insert(obj).second) {
+            Enqueue(dst);
+        }
+    }
+
+    void Copy(int dst, int src) override { AddEdge(src, dst); }
+
+    void Load(int dst, int ptr) override
+    {
+        vars[ptr].loads.push_back(dst);
+        Enqueue(ptr);
+    }
+
+    void Store(int ptr, int src) override
+    {
+        vars[ptr].stores.push_back(src);
+        Enqueue(ptr);
+    }
+
+    void FieldAddr(int dst, int ptr, const clang::FieldDecl* field) override
+    {
+        vars[ptr].fieldAddrs.push_back({dst, field});
+        Enqueue(ptr);
+    }
+
+    void Solve() override
+    {
+        while (!worklist.empty()) {
+            int v = worklist.back();
+            worklist.pop_back();
+            queued[v] = false;
+
+            // 处理过程中会新建变量，vars 可能扩容，这里只按下标访问
+            std::vector<int> pts(vars[v].pts.begin(), vars[v].pts.end());
+            std::vector<int> loads = vars[v].loads;
+            std::vector<int> stores = vars[v].stores;
+            auto fieldAddrs = vars[v].fieldAddrs;
+            for (int obj : pts) {
+                for (int dst : loads) {
+                    AddEdge(obj, dst);
+                }
+                for (int src : stores) {
+                    AddEdge(src, obj);
+                }
+                for (const auto& [dst, field] : fieldAddrs) {
+                    AddrOf(dst, FieldVar(obj, field));
+                }
+            }
+            std::vector<int> targets(vars[v].copyTo.begin(), vars[v].copyTo.end());
+            for (int dst : targets) {
+                size_t before = vars[dst].pts.size();
+                vars[dst].pts.insert(pts.begin(), pts.end());
+                if (vars[dst].pts.size() != before) {
+                    Enqueue(dst);
+                }
+            }
+        }
+    }
+
+    bool MayOverlap(int a, int b) override
+    {
+        Solve();
+        const std::set<int>& as = vars[a].pts;
+        const std::set<int>& bs = vars[b].pts;
+        // a 中对象及其所有外层对象；b 中对象沿外层链命中 a 即重叠
+        std::set<int> enclosingA;
+        for (int obj : as) {
+            for (int cur = obj; cur >= 0; cur = vars[cur].parent) {
+                enclosingA.insert(cur);
+            }
+        }
+        for (int obj : bs) {
+            if (enclosingA.count(obj)) {
+                return true;
+            }
+            for (int cur = vars[obj].parent; cur >= 0; cur = vars[cur].parent) {
+                if (as.count(cur)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    struct VarInfo {
+        std::set<int> pts;
+        std::set<int> copyTo;
+        std::vector<int> loads;
+        std::vector<int> stores;
+        std::vector<std::pair<int, const clang::FieldDecl*>> fieldAddrs;
+        int parent = -1;        // 字段子对象所属的对象
+    };
+
+    std::vector<VarInfo> vars;
+    std::vector<bool> queued;
+    std::vector<int> worklist;
+    std::map<std::pair<int, const clang::FieldDecl*>, int> fieldVars;
+
+    void Enqueue(int v)
+    {
+        if (!queued[v]) {
+            queued[v] = true;
+            worklist.push_back(v);
+        }
+    }
+
+    void AddEdge(int src, int dst)
+    {
+        if (src != dst && vars[src].copyTo.insert(dst).second && !vars[src].pts.empty()) {
+            Enqueue(src);
+        }
+    }
+
+    int FieldVar(int obj, const clang::FieldDecl* field)
+    {
+        auto key = std::make_pair(obj, field);
+        auto it = fieldVars.find(key);
+        if (it != fieldVars.end()) {
+            return it->second;
+        }
+        int child = NewVar();
+        vars[child].parent = obj;
+        fieldVars[key] = child;
+        return child;
+    }
+};
+
+const clang::Expr* StripFull(const clang::Expr* expr)
+{
+    while (expr) {
+        if (const auto* full = llvm::dyn_cast<clang::FullExpr>(expr)) {
+            expr = full->getSubExpr();
+        } else if (const auto* bind = llvm::dyn_cast<clang::CXXBindTemporaryExpr>(expr)) {
+            expr = bind->getSubExpr();
+        } else if (const auto* paren = llvm::dyn_cast<clang::ParenExpr>(expr)) {
+            expr = paren->getSubExpr();
+        } else {
+            break;
+        }
+    }
+    return expr;
+}
+
+std::string PlainName(const clang::FunctionDecl* func)
+{
+    const clang::IdentifierInfo* id = func->getIdentifier();
+    if (!id) {
+        return "";
+    }
+    llvm::StringRef name = id->getName();
+    name.consume_front("__builtin_");
+    return name.str();
+}
+
+bool IsAllocationFunction(const clang::FunctionDecl* func)
+{
+    if (func->isReplaceableGlobalAllocationFunction()) {
+        return true;
+    }
+    static const std::set<std::string> kAllocators = {
+        "malloc", "calloc", "realloc", "aligned_alloc", "valloc", "pvalloc", "memalign",
+        "_mm_malloc", "_aligned_malloc", "strdup", "strndup"
+    };
+    return kAllocators.count(PlainName(func)) > 0;
+}
+
+// 返回第一个实参的库函数
+bool ReturnsFirstArgument(const std::string& name)
+{
+    static const std::set<std::string> kNames = {
+        "memcpy", "memmove", "memset", "strcpy", "strncpy", "strcat", "strncat",
+        "wmemcpy", "wmemmove", "wmemset"
+    };
+    return kNames.count(name) > 0;
+}
+
+bool IsCopyOrMoveAssignment(const clang::FunctionDecl* func)
+{
+    const auto* method = llvm::dyn_cast_or_null<clang::CXXMethodDecl>(func);
+    return method && (method->isCopyAssignmentOperator() || method->isMoveAssignmentOperator()) &&
+           (method->isTrivial() || method->isDefaulted());
+}
+
+} // namespace
+
+// ============================================
+// 遍历：预扫描与约束生成
+// ============================================
+
+// 预扫描：调用关系、取地址的函数、按值拷贝过的含指针结构体
+class PointsToCollector : public clang::RecursiveASTVisitor<PointsToCollector> {
+public:
+    explicit PointsToCollector(PointsToAnalysis& a) : analysis(a) {}
+
+    bool shouldVisitTemplateInstantiations() const { return true; }
+
+    bool TraverseDecl(clang::Decl* decl)
+    {
+        const auto* context = llvm::dyn_cast_or_null<clang::DeclContext>(decl);
+        if (context && context->isDependentContext()) {
+            return true;    // 未实例化的模板，只分析实例
+        }
+        if (const auto* func = llvm::dyn_cast_or_null<clang::FunctionDecl>(decl)) {
+            if (func->doesThisDeclarationHaveABody()) {
+                functions.push_back(func);
+            }
+        }
+        return clang::RecursiveASTVisitor<PointsToCollector>::TraverseDecl(decl);
+    }
+
+    bool VisitCallExpr(clang::CallExpr* call)
+    {
+        if (const clang::FunctionDecl* callee = analysis.ResolveCallee(call)) {
+            called.insert(callee->getCanonicalDecl());
+        }
+        if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(call->getCallee()->IgnoreParenImpCasts())) {
+            calleeRefs.insert(ref);
+        }
+        if (IsCopyOrMoveAssignment(call->getDirectCallee())) {
+            CollapseIfCopied(call->getType());
+        }
+        return true;
+    }
+
+    bool VisitDeclRefExpr(clang::DeclRefExpr* ref)
+    {
+        if (const auto* func = llvm::dyn_cast<clang::FunctionDecl>(ref->getDecl())) {
+            if (!calleeRefs.count(ref)) {
+                addressTaken.insert(func->getCanonicalDecl());
+            }
+        }
+        return true;
+    }
+
+    bool VisitCXXConstructExpr(clang::CXXConstructExpr* construct)
+    {
+        if (construct->getConstructor()->isCopyOrMoveConstructor()) {
+            CollapseIfCopied(construct->getType());
+        }
+        return true;
+    }
+
+    bool VisitImplicitCastExpr(clang::ImplicitCastExpr* cast)
+    {
+        // C 中结构体按值拷贝表现为结构体类型的左值到右值转换
+        if (cast->getCastKind() == clang::CK_LValueToRValue) {
+            CollapseIfCopied(cast->getType());
+        }
+        return true;
+    }
+
+    std::vector<const clang::FunctionDecl*> functions;
+    std::set<const clang::FunctionDecl*> called;
+    std::set<const clang::FunctionDecl*> addressTaken;
+
+private:
+    PointsToAnalysis& analysis;
+    std::set<const clang::DeclRefExpr*> calleeRefs;
+
+    void CollapseIfCopied(clang::QualType type)
+    {
+        const auto* record = type->getAsRecordDecl();
+        if (record && analysis.HasPointers(type)) {
+            analysis.CollapseRecord(record);
+        }
+    }
+};
+
+class PointsToGenerator : public clang::RecursiveASTVisitor<PointsToGenerator> {
+public:
+    explicit PointsToGenerator(PointsToAnalysis& a) : analysis(a) {}
+
+    bool shouldVisitTemplateInstantiations() const { return true; }
+
+    bool TraverseDecl(clang::Decl* decl)
+    {
+        const auto* context = llvm::dyn_cast_or_null<clang::DeclContext>(decl);
+        if (context && context->isDependentContext()) {
+            return true;
+        }
+        const auto* func = llvm::dyn_cast_or_null<clang::FunctionDecl>(decl);
+        if (!func || !func->doesThisDeclarationHaveABody()) {
+            return clang::RecursiveASTVisitor<PointsToGenerator>::TraverseDecl(decl);
+        }
+        if (const auto* ctor = llvm::dyn_cast<clang::CXXConstructorDecl>(func)) {
+            analysis.InitializeMembers(ctor);
+        }
+        functionStack.push_back(func);
+        bool result = clang::RecursiveASTVisitor<PointsToGenerator>::TraverseDecl(decl);
+        functionStack.pop_back();
+        return result;
+    }
+
+    bool TraverseLambdaExpr(clang::LambdaExpr* lambda)
+    {
+        functionStack.push_back(lambda->getCallOperator());
+        bool result = clang::RecursiveASTVisitor<PointsToGenerator>::TraverseLambdaExpr(lambda);
+        functionStack.pop_back();
+        return result;
+    }
+
+    bool VisitVarDecl(clang::VarDecl* var)
+    {
+        if (llvm::isa<clang::ParmVarDecl>(var) || !var->getInit() || var->getType()->isDependentType()) {
+            return true;
+        }
+        analysis.Initialize(analysis.DeclAddr(var), var->getType(), var->getInit());
+        return true;
+    }
+
+    bool VisitReturnStmt(clang::ReturnStmt* ret)
+    {
+        if (!functionStack.empty() && ret->getRetValue()) {
+            analysis.Return(functionStack.back(), ret->getRetValue());
+        }
+        return true;
+    }
+
+    bool VisitBinaryOperator(clang::BinaryOperator* op)
+    {
+        if (op->getOpcode() == clang::BO_Assign) {
+            analysis.Assign(op);
+        }
+        return true;
+    }
+
+    bool VisitCallExpr(clang::CallExpr* call)
+    {
+        analysis.Call(call);
+        return true;
+    }
+
+    bool VisitCXXConstructExpr(clang::CXXConstructExpr* construct)
+    {
+        // 变量/成员初始化中的构造已在 Initialize 中以目标对象处理，其余为临时对象
+        if (!analysis.generated.count(construct)) {
+            analysis.Val(construct);
+        }
+        return true;
+    }
+
+    bool VisitCXXNewExpr(clang::CXXNewExpr* newExpr)
+    {
+        analysis.Val(newExpr);
+        return true;
+    }
+
+private:
+    PointsToAnalysis& analysis;
+    std::vector<const clang::FunctionDecl*> functionStack;
+};
+
+// ============================================
+// 模式名称
+// ============================================
+
+const char* PointsToModeName(PointsToMode mode)
+{
+    switch (mode) {
+        case PointsToMode::Off: return "off";
+        case PointsToMode::Steensgaard: return "steensgaard";
+        case PointsToMode::Andersen: return "andersen";
+    }
+    return "off";
+}
+
+bool ParsePointsToMode(const std::string& text, PointsToMode& mode)
+{
+    for (PointsToMode candidate : {PointsToMode::Off, PointsToMode::Steensgaard, PointsToMode::Andersen}) {
+        if (text == PointsToModeName(candidate)) {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================
+// PointsToAnalysis
+// ============================================
+
+PointsToAnalysis::PointsToAnalysis(clang::ASTContext& ctx, const CPGContext* cpgCtx,
+                                   PointsToMode pointsToMode)
+    : astContext(ctx), cpgContext(cpgCtx), mode(pointsToMode)
+{
+    if (mode == PointsToMode::Andersen) {
+        solver = std::make_unique<AndersenSolver>();
+    } else {
+        solver = std::make_unique<SteensgaardSolver>();
+    }
+    // 外部内存中的指针可指向任何已逃逸的对象，包括外部内存自身
+    externalVar = ObjectVar(ObjectKind::External, nullptr);
+    AddrOf(externalVar, externalVar);
+}
+
+PointsToAnalysis::~PointsToAnalysis() = default;
+
+size_t PointsToAnalysis::VariableCount() const
+{
+    return solver->VarCount();
+}
+
+void PointsToAnalysis::Run()
+{
+    if (ran || mode == PointsToMode::Off) {
+        return;
+    }
+    ran = true;
+
+    PointsToCollector collector(*this);
+    collector.TraverseDecl(astContext.getTranslationUnitDecl());
+    for (const auto* func : collector.functions) {
+        const auto* canonical = func->getCanonicalDecl();
+        if (!collector.called.count(canonical) || collector.addressTaken.count(canonical)) {
+            rootFunctions.insert(canonical);
+        }
+    }
+    for (const auto* func : collector.functions) {
+        if (rootFunctions.count(func->getCanonicalDecl())) {
+            BindRootParameters(func);
+        }
+    }
+
+    PointsToGenerator generator(*this);
+    generator.TraverseDecl(astContext.getTranslationUnitDecl());
+    solver->Solve();
+}
+
+bool PointsToAnalysis::MayAlias(const clang::Expr* a, const clang::Expr* b)
+{
+    if (mode == PointsToMode::Off || !a || !b) {
+        return true;
+    }
+    Run();
+    int locA = Location(a);
+    int locB = Location(b);
+    if (locA < 0 || locB < 0) {
+        return true;
+    }
+    solver->Solve();
+    return solver->MayOverlap(locA, locB);
+}
+
+int PointsToAnalysis::Location(const clang::Expr* expr)
+{
+    if (expr->isGLValue()) {
+        return Addr(expr);
+    }
+    if (expr->getType()->isPointerType() && !expr->getType()->isFunctionPointerType()) {
+        return Val(expr);
+    }
+    return -1;
+}
+
+// ============================================
+// 约束
+// ============================================
+
+int PointsToAnalysis::NewVar()
+{
+    return solver->NewVar();
+}
+
+void PointsToAnalysis::AddrOf(int dst, int objectVar)
+{
+    if (dst >= 0 && objectVar >= 0) {
+        constraints++;
+        solver->AddrOf(dst, objectVar);
+    }
+}
+
+void PointsToAnalysis::Copy(int dst, int src)
+{
+    if (dst >= 0 && src >= 0 && dst != src) {
+        constraints++;
+        solver->Copy(dst, src);
+    }
+}
+
+void PointsToAnalysis::Load(int dst, int srcPtr)
+{
+    if (dst >= 0 && srcPtr >= 0) {
+        constraints++;
+        solver->Load(dst, srcPtr);
+    }
+}
+
+void PointsToAnalysis::Store(int dstPtr, int src)
+{
+    if (dstPtr >= 0 && src >= 0) {
+        constraints++;
+        solver->Store(dstPtr, src);
+    }
+}
+
+void PointsToAnalysis::FieldAddr(int dst, int srcPtr, const clang::FieldDecl* field)
+{
+    if (dst >= 0 && srcPtr >= 0) {
+        constraints++;
+        solver->FieldAddr(dst, srcPtr, field);
+    }
+}
+
+// 写入位置未知时，写入的指针视为逃逸
+void PointsToAnalysis::StoreTo(int dstAddr, int value)
+{
+    if (value < 0) {
+        return;
+    }
+    if (dstAddr < 0) {
+        Copy(externalVar, value);
+        return;
+    }
+    Store(dstAddr, value);
+}
+
+int PointsToAnalysis::Join(int a, int b)
+{
+    if (a < 0 || b < 0) {
+        return -1;
+    }
+    int v = NewVar();
+    Copy(v, a);
+    Copy(v, b);
+    return v;
+}
+
+int PointsToAnalysis::ExternalPointer()
+{
+    int v = NewVar();
+    Copy(v, externalVar);
+    return v;
+}
+
+// ============================================
+// 对象
+// ============================================
+
+int PointsToAnalysis::ObjectVar(ObjectKind kind, const void* key)
+{
+    auto indexKey = std::make_pair(kind, key);
+    auto it = objectIndex.find(indexKey);
+    if (it != objectIndex.end()) {
+        return objects[it->second].var;
+    }
+    Object object;
+    object.kind = kind;
+    object.key = key;
+    object.var = NewVar();
+    objectIndex[indexKey] = static_cast<int>(objects.size());
+    objects.push_back(object);
+    return object.var;
+}
+
+const clang::ValueDecl* PointsToAnalysis::CanonicalStorage(const clang::ValueDecl* decl) const
+{
+    // 声明与定义的形参是不同的 ParmVarDecl，统一到定义上
+    if (const auto* param = llvm::dyn_cast<clang::ParmVarDecl>(decl)) {
+        const auto* func = llvm::dyn_cast_or_null<clang::FunctionDecl>(param->getDeclContext());
+        const clang::FunctionDecl* def = func ? func->getDefinition() : nullptr;
+        unsigned index = param->getFunctionScopeIndex();
+        if (def && def != func && index < def->getNumParams()) {
+            return def->getParamDecl(index);
+        }
+        return param;
+    }
+    return llvm::cast<clang::ValueDecl>(decl->getCanonicalDecl());
+}
+
+int PointsToAnalysis::DeclObjectVar(const clang::ValueDecl* decl)
+{
+    decl = CanonicalStorage(decl);
+    bool created = !objectIndex.count(std::make_pair(ObjectKind::Variable, static_cast<const void*>(decl)));
+    int var = ObjectVar(ObjectKind::Variable, decl);
+    if (!created) {
+        return var;
+    }
+    // 外部可见的全局变量：其他翻译单元可读写
+    const auto* varDecl = llvm::dyn_cast<clang::VarDecl>(decl);
+    if (varDecl && varDecl->hasGlobalStorage() && !varDecl->isStaticLocal() &&
+        varDecl->isExternallyVisible()) {
+        AddrOf(externalVar, var);
+        if (IsTracked(varDecl->getType())) {
+            Copy(var, externalVar);
+        }
+    }
+    return var;
+}
+
+int PointsToAnalysis::DeclAddr(const clang::ValueDecl* decl)
+{
+    decl = CanonicalStorage(decl);
+    auto it = declAddrMemo.find(decl);
+    if (it != declAddrMemo.end()) {
+        return it->second;
+    }
+    int v = NewVar();
+    AddrOf(v, DeclObjectVar(decl));
+    declAddrMemo[decl] = v;
+    return v;
+}
+
+int PointsToAnalysis::ReturnVar(const clang::FunctionDecl* func)
+{
+    func = func->getCanonicalDecl();
+    auto it = returnVars.find(func);
+    if (it != returnVars.end()) {
+        return it->second;
+    }
+    int v = NewVar();
+    returnVars[func] = v;
+    return v;
+}
+
+int PointsToAnalysis::ThisVar(const clang::CXXMethodDecl* method)
+{
+    method = method->getCanonicalDecl();
+    auto it = thisVars.find(method);
+    if (it != thisVars.end()) {
+        return it->second;
+    }
+    int v = NewVar();
+    thisVars[method] = v;
+    if (rootFunctions.count(method)) {
+        Copy(v, externalVar);
+    }
+    return v;
+}
+
+void PointsToAnalysis::BindRootParameters(const clang::FunctionDecl* func)
+{
+    for (const clang::ParmVarDecl* param : func->parameters()) {
+        clang::QualType type = param->getType();
+        if (!IsTracked(type)) {
+            continue;
+        }
+        int content = DeclObjectVar(param);
+        if (type->isPointerType() && type.isRestrictQualified()) {
+            // restrict：调用期间只能经由该形参访问所指对象
+            int target = ObjectVar(ObjectKind::Restrict, CanonicalStorage(param));
+            AddrOf(content, target);
+            Copy(target, externalVar);
+        } else {
+            Copy(content, externalVar);
+        }
+    }
+}
+
+// ============================================
+// 表达式
+// ============================================
+
+int PointsToAnalysis::Addr(const clang::Expr* expr)
+{
+    if (!expr) {
+        return -1;
+    }
+    auto it = addrMemo.find(expr);
+    if (it != addrMemo.end()) {
+        return it->second;
+    }
+    addrMemo[expr] = -1;
+    int v = ComputeAddr(expr);
+    addrMemo[expr] = v;
+    return v;
+}
+
+int PointsToAnalysis::Val(const clang::Expr* expr)
+{
+    if (!expr) {
+        return -1;
+    }
+    auto it = valMemo.find(expr);
+    if (it != valMemo.end()) {
+        return it->second;
+    }
+    valMemo[expr] = -1;
+    int v = ComputeVal(expr);
+    valMemo[expr] = v;
+    return v;
+}
+
+int PointsToAnalysis::ComputeAddr(const clang::Expr* expr)
+{
+    expr = StripFull(expr);
+
+    if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(expr)) {
+        const auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl());
+        if (!var) {
+            return -1;
+        }
+        // 引用变量的内容即被引用对象的位置
+        return var->getType()->isReferenceType() ? DeclObjectVar(var) : DeclAddr(var);
+    }
+    if (const auto* unary = llvm::dyn_cast<clang::UnaryOperator>(expr)) {
+        switch (unary->getOpcode()) {
+            case clang::UO_Deref:
+                return Val(unary->getSubExpr());
+            case clang::UO_PreInc:
+            case clang::UO_PreDec:
+            case clang::UO_Real:
+            case clang::UO_Imag:
+            case clang::UO_Extension:
+                return Addr(unary->getSubExpr());
+            default:
+                return -1;
+        }
+    }
+    if (const auto* subscript = llvm::dyn_cast<clang::ArraySubscriptExpr>(expr)) {
+        // 不区分元素：基址（已退化为指针）所指的整个对象
+        return Val(subscript->getBase());
+    }
+    if (const auto* member = llvm::dyn_cast<clang::MemberExpr>(expr)) {
+        const clang::ValueDecl* decl = member->getMemberDecl();
+        if (const auto* staticMember = llvm::dyn_cast<clang::VarDecl>(decl)) {
+            return staticMember->getType()->isReferenceType() ? DeclObjectVar(staticMember)
+                                                              : DeclAddr(staticMember);
+        }
+        const auto* field = llvm::dyn_cast<clang::FieldDecl>(decl);
+        if (!field) {
+            return -1;
+        }
+        int base = member->isArrow() ? Val(member->getBase()) : Addr(member->getBase());
+        if (base < 0) {
+            return -1;
+        }
+        int fieldAddr = base;
+        if (!IsCollapsed(field)) {
+            fieldAddr = NewVar();
+            FieldAddr(fieldAddr, base, field);
+        }
+        if (field->getType()->isReferenceType()) {
+            int target = NewVar();
+            Load(target, fieldAddr);
+            return target;
+        }
+        return fieldAddr;
+    }
+    if (const auto* binary = llvm::dyn_cast<clang::BinaryOperator>(expr)) {
+        if (binary->isAssignmentOp()) {
+            if (binary->getOpcode() == clang::BO_Assign) {
+                Assign(binary);
+            }
+            return Addr(binary->getLHS());
+        }
+        if (binary->getOpcode() == clang::BO_Comma) {
+            return Addr(binary->getRHS());
+        }
+        return -1;
+    }
+    if (const auto* cond = llvm::dyn_cast<clang::AbstractConditionalOperator>(expr)) {
+        return Join(Addr(cond->getTrueExpr()), Addr(cond->getFalseExpr()));
+    }
+    if (const auto* cast = llvm::dyn_cast<clang::CastExpr>(expr)) {
+        return Addr(cast->getSubExpr());     // 左值转换：NoOp、派生类到基类等
+    }
+    if (llvm::isa<clang::StringLiteral>(expr) || llvm::isa<clang::PredefinedExpr>(expr)) {
+        int v = NewVar();
+        AddrOf(v, ObjectVar(ObjectKind::Literal, expr));
+        return v;
+    }
+    if (const auto* literal = llvm::dyn_cast<clang::CompoundLiteralExpr>(expr)) {
+        int v = NewVar();
+        AddrOf(v, ObjectVar(ObjectKind::Temporary, expr));
+        Initialize(v, literal->getType(), literal->getInitializer());
+        return v;
+    }
+    if (const auto* temp = llvm::dyn_cast<clang::MaterializeTemporaryExpr>(expr)) {
+        int v = NewVar();
+        AddrOf(v, ObjectVar(ObjectKind::Temporary, expr));
+        Initialize(v, temp->getSubExpr()->getType(), temp->getSubExpr());
+        return v;
+    }
+    if (const auto* call = llvm::dyn_cast<clang::CallExpr>(expr)) {
+        return Call(call);      // 返回引用
+    }
+    if (const auto* opaque = llvm::dyn_cast<clang::OpaqueValueExpr>(expr)) {
+        return Addr(opaque->getSourceExpr());
+    }
+    if (const auto* defaultArg = llvm::dyn_cast<clang::CXXDefaultArgExpr>(expr)) {
+        return Addr(defaultArg->getExpr());
+    }
+    if (const auto* defaultInit = llvm::dyn_cast<clang::CXXDefaultInitExpr>(expr)) {
+        return Addr(defaultInit->getExpr());
+    }
+    return -1;
+}
+
+int PointsToAnalysis::ComputeVal(const clang::Expr* expr)
+{
+    expr = StripFull(expr);
+    clang::QualType type = expr->getType();
+
+    if (expr->isGLValue()) {
+        if (!IsTracked(type)) {
+            return -1;
+        }
+        int addr = Addr(expr);
+        if (addr < 0) {
+            return ExternalPointer();
+        }
+        int v = NewVar();
+        Load(v, addr);
+        return v;
+    }
+
+    if (const auto* cast = llvm::dyn_cast<clang::CastExpr>(expr)) {
+        const clang::Expr* sub = cast->getSubExpr();
+        switch (cast->getCastKind()) {
+            case clang::CK_LValueToRValue:
+                return Val(sub);
+            case clang::CK_ArrayToPointerDecay:
+                return Addr(sub);
+            case clang::CK_FunctionToPointerDecay:
+            case clang::CK_BuiltinFnToFnPtr:
+                return -1;
+            case clang::CK_NullToPointer:
+                return NewVar();
+            case clang::CK_IntegralToPointer:
+                return ExternalPointer();
+            case clang::CK_PointerToIntegral:
+                // 指针转成整数后无法再跟踪，所指对象视为逃逸
+                Copy(externalVar, Val(sub));
+                return -1;
+            default:
+                return Val(sub);    // NoOp、BitCast、基类/派生类转换不改变指向
+        }
+    }
+    if (const auto* unary = llvm::dyn_cast<clang::UnaryOperator>(expr)) {
+        switch (unary->getOpcode()) {
+            case clang::UO_AddrOf:
+                return Addr(unary->getSubExpr());
+            case clang::UO_PostInc:
+            case clang::UO_PostDec:
+            case clang::UO_PreInc:
+            case clang::UO_PreDec:
+            case clang::UO_Extension:
+                return Val(unary->getSubExpr());
+            default:
+                return -1;
+        }
+    }
+    if (const auto* binary = llvm::dyn_cast<clang::BinaryOperator>(expr)) {
+        if (binary->getOpcode() == clang::BO_Assign) {
+            Assign(binary);     // C 中赋值表达式为右值
+            return Val(binary->getRHS());
+        }
+        if (binary->isCompoundAssignmentOp()) {
+            return Val(binary->getLHS());
+        }
+        if (binary->getOpcode() == clang::BO_Comma) {
+            return Val(binary->getRHS());
+        }
+        if (type->isPointerType()) {
+            // 指针算术：结果与指针操作数指向同一对象
+            const clang::Expr* ptr = binary->getLHS()->getType()->isPointerType() ? binary->getLHS()
+                                                                                  : binary->getRHS();
+            return Val(ptr);
+        }
+        return -1;
+    }
+    if (const auto* cond = llvm::dyn_cast<clang::AbstractConditionalOperator>(expr)) {
+        return Join(Val(cond->getTrueExpr()), Val(cond->getFalseExpr()));
+    }
+    if (const auto* call = llvm::dyn_cast<clang::CallExpr>(expr)) {
+        return Call(call);
+    }
+    if (const auto* construct = llvm::dyn_cast<clang::CXXConstructExpr>(expr)) {
+        int addr = NewVar();
+        AddrOf(addr, ObjectVar(ObjectKind::Temporary, expr));
+        Construct(construct, addr);
+        if (!IsTracked(type)) {
+            return -1;
+        }
+        int v = NewVar();
+        Load(v, addr);
+        return v;
+    }
+    if (const auto* newExpr = llvm::dyn_cast<clang::CXXNewExpr>(expr)) {
+        int v = NewVar();
+        AddrOf(v, ObjectVar(ObjectKind::Heap, expr));
+        if (const clang::Expr* init = newExpr->getInitializer()) {
+            Initialize(v, newExpr->getAllocatedType(), init);
+        }
+        return v;
+    }
+    if (llvm::isa<clang::CXXThisExpr>(expr)) {
+        const clang::CXXMethodDecl* method = EnclosingMethod(expr);
+        return method ? ThisVar(method) : -1;
+    }
+    if (const auto* opaque = llvm::dyn_cast<clang::OpaqueValueExpr>(expr)) {
+        return Val(opaque->getSourceExpr());
+    }
+    if (const auto* defaultArg = llvm::dyn_cast<clang::CXXDefaultArgExpr>(expr)) {
+        return Val(defaultArg->getExpr());
+    }
+    if (const auto* defaultInit = llvm::dyn_cast<clang::CXXDefaultInitExpr>(expr)) {
+        return Val(defaultInit->getExpr());
+    }
+    if (llvm::isa<clang::InitListExpr>(expr)) {
+        int addr = NewVar();
+        AddrOf(addr, ObjectVar(ObjectKind::Temporary, expr));
+        Initialize(addr, type, expr);
+        int v = NewVar();
+        Load(v, addr);
+        return v;
+    }
+    if (!IsTracked(type)) {
+        return -1;
+    }
+    if (llvm::isa<clang::CXXNullPtrLiteralExpr>(expr) || llvm::isa<clang::GNUNullExpr>(expr) ||
+        llvm::isa<clang::ImplicitValueInitExpr>(expr) || llvm::isa<clang::IntegerLiteral>(expr)) {
+        return NewVar();
+    }
+    // 未建模的指针值按外部指针处理
+    return ExternalPointer();
+}
+
+// ============================================
+// 赋值、初始化、调用
+// ============================================
+
+void PointsToAnalysis::CopyValue(int dstAddr, int srcAddr, clang::QualType type)
+{
+    if (!HasPointers(type) || srcAddr < 0) {
+        return;
+    }
+    int v = NewVar();
+    Load(v, srcAddr);
+    StoreTo(dstAddr, v);
+}
+
+void PointsToAnalysis::Assign(const clang::BinaryOperator* assign)
+{
+    if (!generated.insert(assign).second || !IsTracked(assign->getLHS()->getType())) {
+        return;
+    }
+    StoreTo(Addr(assign->getLHS()), Val(assign->getRHS()));
+}
+
+void PointsToAnalysis::Initialize(int targetAddr, clang::QualType type, const clang::Expr* init)
+{
+    init = StripFull(init);
+    if (!init) {
+        return;
+    }
+    if (const auto* construct = llvm::dyn_cast<clang::CXXConstructExpr>(init)) {
+        generated.insert(construct);
+        Construct(construct, targetAddr);
+        return;
+    }
+    if (const auto* list = llvm::dyn_cast<clang::InitListExpr>(init)) {
+        if (list->isTransparent()) {
+            Initialize(targetAddr, type, list->getInit(0));
+            return;
+        }
+        const clang::RecordDecl* record = type->getAsRecordDecl();
+        if (!record || !record->getDefinition()) {
+            // 数组（不区分元素）或标量的花括号初始化
+            clang::QualType elementType = type->isArrayType() ?
+                astContext.getAsArrayType(type)->getElementType() : type;
+            for (const clang::Expr* element : list->inits()) {
+                Initialize(targetAddr, elementType, element);
+            }
+            return;
+        }
+        if (const clang::FieldDecl* unionField = list->getInitializedFieldInUnion()) {
+            if (list->getNumInits() > 0) {
+                Initialize(targetAddr, unionField->getType(), list->getInit(0));
+            }
+            return;
+        }
+        // C++ 聚合的基类初始化在前（基类子对象与对象本身不区分），之后按字段顺序
+        unsigned index = 0;
+        if (const auto* cxxRecord = llvm::dyn_cast<clang::CXXRecordDecl>(record->getDefinition())) {
+            for (const clang::CXXBaseSpecifier& base : cxxRecord->bases()) {
+                if (index < list->getNumInits()) {
+                    Initialize(targetAddr, base.getType(), list->getInit(index++));
+                }
+            }
+        }
+        for (const clang::FieldDecl* field : record->getDefinition()->fields()) {
+            if (field->isBitField() && !field->getDeclName()) {
+                continue;   // 匿名位域不占初始化项
+            }
+            if (index >= list->getNumInits()) {
+                break;
+            }
+            const clang::Expr* element = list->getInit(index++);
+            int fieldAddr = targetAddr;
+            if (!IsCollapsed(field) && targetAddr >= 0) {
+                fieldAddr = NewVar();
+                FieldAddr(fieldAddr, targetAddr, field);
+            }
+            Initialize(fieldAddr, field->getType(), element);
+        }
+        return;
+    }
+    if (type->isReferenceType()) {
+        StoreTo(targetAddr, Addr(init));
+        return;
+    }
+    if (IsTracked(type)) {
+        StoreTo(targetAddr, Val(init));
+    }
+}
+
+void PointsToAnalysis::Construct(const clang::CXXConstructExpr* construct, int targetAddr)
+{
+    const clang::CXXConstructorDecl* ctor = construct->getConstructor();
+    clang::QualType type = construct->getType();
+
+    // 默认的拷贝/移动构造：按值拷贝
+    if (ctor->isCopyOrMoveConstructor() && construct->getNumArgs() >= 1 &&
+        (ctor->isTrivial() || ctor->isDefaulted())) {
+        CopyValue(targetAddr, Addr(construct->getArg(0)), type);
+        return;
+    }
+
+    const clang::FunctionDecl* def = ctor->getDefinition();
+    if (!def) {
+        // 无定义的构造函数（库类型）：对象内容未知
+        if (IsTracked(type)) {
+            StoreTo(targetAddr, ExternalPointer());
+        }
+        return;
+    }
+    for (unsigned i = 0; i < construct->getNumArgs() && i < def->getNumParams(); ++i) {
+        const clang::ParmVarDecl* param = def->getParamDecl(i);
+        Initialize(DeclAddr(param), param->getType(), construct->getArg(i));
+    }
+    Copy(ThisVar(llvm::cast<clang::CXXMethodDecl>(def)), targetAddr);
+}
+
+void PointsToAnalysis::InitializeMembers(const clang::CXXConstructorDecl* ctor)
+{
+    int thisAddr = ThisVar(ctor);
+    for (const clang::CXXCtorInitializer* init : ctor->inits()) {
+        if (!init->getInit()) {
+            continue;
+        }
+        if (const clang::FieldDecl* field = init->getMember()) {
+            int fieldAddr = thisAddr;
+            if (!IsCollapsed(field)) {
+                fieldAddr = NewVar();
+                FieldAddr(fieldAddr, thisAddr, field);
+            }
+            Initialize(fieldAddr, field->getType(), init->getInit());
+        } else if (init->isBaseInitializer() || init->isDelegatingInitializer()) {
+            // 基类子对象与对象本身不区分
+            Initialize(thisAddr, init->getInit()->getType(), init->getInit());
+        }
+    }
+}
+
+void PointsToAnalysis::Return(const clang::FunctionDecl* func, const clang::Expr* value)
+{
+    clang::QualType type = func->getReturnType();
+    if (type->isReferenceType()) {
+        Copy(ReturnVar(func), Addr(value));
+    } else if (IsTracked(type)) {
+        Copy(ReturnVar(func), Val(value));
+    }
+}
+
+int PointsToAnalysis::Call(const clang::CallExpr* call)
+{
+    auto it = callMemo.find(call);
+    if (it != callMemo.end()) {
+        return it->second;
+    }
+    callMemo[call] = -1;
+
+    const clang::FunctionDecl* callee = ResolveCallee(call);
+    clang::QualType returnType = call->getCallReturnType(astContext);
+    bool tracked = IsTracked(returnType);
+    int result = -1;
+
+    // 隐式对象：成员调用的对象表达式，或成员运算符调用的第一个实参
+    const auto* method = llvm::dyn_cast_or_null<clang::CXXMethodDecl>(callee);
+    unsigned firstArg = 0;
+    int objectAddr = -1;
+    if (const auto* memberCall = llvm::dyn_cast<clang::CXXMemberCallExpr>(call)) {
+        if (const clang::Expr* object = memberCall->getImplicitObjectArgument()) {
+            objectAddr = object->getType()->isPointerType() ? Val(object) : Addr(object);
+        }
+    } else if (llvm::isa<clang::CXXOperatorCallExpr>(call) && method && !method->isStatic() &&
+               call->getNumArgs() > 0) {
+        objectAddr = Addr(call->getArg(0));
+        firstArg = 1;
+    }
+
+    auto argValue = [this](const clang::Expr* arg) {
+        return arg->isGLValue() ? Addr(arg) : Val(arg);
+    };
+
+    if (!callee) {
+        // 间接调用：目标未知，指针实参逃逸
+        for (const clang::Expr* arg : call->arguments()) {
+            Copy(externalVar, argValue(arg));
+        }
+        result = tracked ? ExternalPointer() : -1;
+    } else if (IsCopyOrMoveAssignment(callee) && call->getNumArgs() > firstArg) {
+        CopyValue(objectAddr, Addr(call->getArg(firstArg)), call->getArg(firstArg)->getType());
+        result = objectAddr;
+    } else if (!callee->hasBody()) {
+        std::string name = PlainName(callee);
+        if (IsAllocationFunction(callee)) {
+            result = NewVar();
+            AddrOf(result, ObjectVar(ObjectKind::Heap, call));
+            if (name == "realloc" && call->getNumArgs() > 0) {
+                Copy(result, Val(call->getArg(0)));
+            }
+        } else if (name == "posix_memalign" && call->getNumArgs() > 0) {
+            int heap = NewVar();
+            AddrOf(heap, ObjectVar(ObjectKind::Heap, call));
+            Store(Val(call->getArg(0)), heap);
+        } else if (ReturnsFirstArgument(name) && call->getNumArgs() > 0) {
+            int dst = Val(call->getArg(0));
+            if ((name == "memcpy" || name == "memmove") && call->getNumArgs() > 1) {
+                int content = NewVar();
+                Load(content, Val(call->getArg(1)));
+                Store(dst, content);
+            }
+            result = tracked ? dst : -1;
+        } else if (tracked) {
+            result = ExternalPointer();
+        }
+    } else {
+        for (unsigned i = firstArg; i < call->getNumArgs(); ++i) {
+            const clang::Expr* arg = call->getArg(i);
+            unsigned index = i - firstArg;
+            if (index < callee->getNumParams()) {
+                const clang::ParmVarDecl* param = callee->getParamDecl(index);
+                Initialize(DeclAddr(param), param->getType(), arg);
+            } else {
+                Copy(externalVar, argValue(arg));     // 可变参数
+            }
+        }
+        if (method && !method->isStatic()) {
+            Copy(ThisVar(method), objectAddr);
+        }
+        result = tracked ? ReturnVar(callee) : -1;
+    }
+
+    callMemo[call] = result;
+    return result;
+}
+
+// ============================================
+// 类型与调用
+// ============================================
+
+bool PointsToAnalysis::IsTracked(clang::QualType type) const
+{
+    if (type.isNull() || type->isDependentType()) {
+        return false;
+    }
+    if (type->isReferenceType()) {
+        return true;
+    }
+    return HasPointers(type);
+}
+
+bool PointsToAnalysis::HasPointers(clang::QualType type, int depth) const
+{
+    if (type.isNull() || depth > 8) {
+        return false;
+    }
+    type = type.getCanonicalType();
+    const clang::Type* key = type.getTypePtr();
+    auto cached = hasPointersCache.find(key);
+    if (cached != hasPointersCache.end()) {
+        return cached->second;
+    }
+
+    bool result = false;
+    if (type->isPointerType()) {
+        result = !type->isFunctionPointerType();
+    } else if (type->isReferenceType()) {
+        result = true;
+    } else if (const clang::ArrayType* array = type->getAsArrayTypeUnsafe()) {
+        result = HasPointers(array->getElementType(), depth + 1);
+    } else if (const clang::RecordDecl* record = type->getAsRecordDecl()) {
+        if (const clang::RecordDecl* def = record->getDefinition()) {
+            for (const clang::FieldDecl* field : def->fields()) {
+                if (HasPointers(field->getType(), depth + 1)) {
+                    result = true;
+                    break;
+                }
+            }
+            const auto* cxxRecord = llvm::dyn_cast<clang::CXXRecordDecl>(def);
+            if (!result && cxxRecord) {
+                for (const clang::CXXBaseSpecifier& base : cxxRecord->bases()) {
+                    if (HasPointers(base.getType(), depth + 1)) {
+                        result = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    hasPointersCache[key] = result;
+    return result;
+}
+
+bool PointsToAnalysis::IsCollapsed(const clang::FieldDecl* field) const
+{
+    const clang::RecordDecl* record = field->getParent();
+    return record->isUnion() ||
+           collapsedRecords.count(llvm::cast<clang::RecordDecl>(record->getCanonicalDecl())) > 0;
+}
+
+void PointsToAnalysis::CollapseRecord(const clang::RecordDecl* record)
+{
+    record = llvm::cast<clang::RecordDecl>(record->getCanonicalDecl());
+    if (!collapsedRecords.insert(record).second) {
+        return;
+    }
+    // 嵌套的结构体随外层一起按值拷贝
+    const clang::RecordDecl* def = record->getDefinition();
+    if (!def) {
+        return;
+    }
+    for (const clang::FieldDecl* field : def->fields()) {
+        clang::QualType type = field->getType();
+        while (const clang::ArrayType* array = type->getAsArrayTypeUnsafe()) {
+            type = array->getElementType();
+        }
+        if (const clang::RecordDecl* nested = type->getAsRecordDecl()) {
+            CollapseRecord(nested);
+        }
+    }
+    if (const auto* cxxRecord = llvm::dyn_cast<clang::CXXRecordDecl>(def)) {
+        for (const clang::CXXBaseSpecifier& base : cxxRecord->bases()) {
+            if (const clang::RecordDecl* baseRecord = base.getType()->getAsRecordDecl()) {
+                CollapseRecord(baseRecord);
+            }
+        }
+    }
+}
+
+const clang::FunctionDecl* PointsToAnalysis::ResolveCallee(const clang::CallExpr* call) const
+{
+    const clang::FunctionDecl* callee = cpgContext ? cpgContext->GetCallTarget(call) : nullptr;
+    if (!callee) {
+        callee = call->getDirectCallee();
+    }
+    if (!callee) {
+        return nullptr;
+    }
+    const clang::FunctionDecl* def = callee->getDefinition();
+    return def ? def : callee;
+}
+
+const clang::CXXMethodDecl* PointsToAnalysis::EnclosingMethod(const clang::Expr* expr) const
+{
+    clang::DynTypedNodeList parents = astContext.getParents(*expr);
+    while (!parents.empty()) {
+        const clang::DynTypedNode& node = parents[0];
+        if (const auto* method = node.get<clang::CXXMethodDecl>()) {
+            // lambda 中的 this 指外层成员函数的对象
+            if (!method->getParent()->isLambda()) {
+                return method;
+            }
+        }
+        if (const auto* stmt = node.get<clang::Stmt>()) {
+            parents = astContext.getParents(*stmt);
+        } else if (const auto* decl = node.get<clang::Decl>()) {
+            parents = astContext.getParents(*decl);
+        } else {
+            break;
+        }
+    }
+    return nullptr;
+}
+
+// ============================================
+// CPGContext 接口
+// ============================================
+
+void CPGContext::SetPointsToMode(PointsToMode mode)
+{
+    if (mode != pointsToMode) {
+        pointsToMode = mode;
+        pointsTo.reset();
+    }
+}
+
+PointsToAnalysis& CPGContext::GetPointsToAnalysis() const
+{
+    if (!pointsTo) {
+        pointsTo = std::make_unique<PointsToAnalysis>(astContext, this, pointsToMode);
+        pointsTo->Run();
+    }
+    return *pointsTo;
+}
+
+bool CPGContext::MayAlias(const clang::Expr* a, const clang::Expr* b) const
+{
+    if (pointsToMode == PointsToMode::Off) {
+        return true;
+    }
+    return GetPointsToAnalysis().MayAlias(a, b);
+}
+
+} // namespace cpg
@@ -0,0 +1,967 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * SIMDCodeEmitter.cpp - 向量化C++代码生成实现
+ *
+ * 生成的函数结构：
+ *   原函数前半段
+ *   {
+ *       V_ vacc_s_ = 单位元;                    // 每个标量累加器一个向量累加器
+ *       if (所有访问首地址对齐) { for (; i + vl_ <= n; i += vl_) 对齐加载/存储 }
+ *       else                  { for (; i + vl_ <= n; i += vl_) 非对齐加载/存储 }
+ *       各 lane 合并回标量累加器
+ *       for (; i < n; ++i) 原循环体                // 标量尾部
+ *   }
+ *   值域分析给出迭代次数时：迭代次数是 vl 的倍数则省略标量尾部，
+ *   迭代次数不足 4 组向量时不做对齐分派，少于 vl 时不生成。
+ *   对齐分析证明所有访问在循环入口已按向量宽度对齐时只生成对齐版本。
+ *   原函数后半段
+ */
+#include "SIMDCodeEmitter.h"
+
+#include "clang/AST/ParentMapContext.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/Lexer.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <sstream>
+
+namespace compute_graph {
+
+namespace {
+
+// 用操作数替换模板中的 %0 / %1
+std::string Fill(const std::string& pattern, const std::string& arg0, const std::string& arg1 = "")
+{
+    std::string result;
+    for (size_t k = 0; k < pattern.size(); ++k) {
+        if (pattern[k] == '%' && k + 1 < pattern.size() &&
+            (pattern[k + 1] == '0' || pattern[k + 1] == '1')) {
+            result += pattern[k + 1] == '0' ? arg0 : arg1;
+            ++k;
+        } else {
+            result += pattern[k];
+        }
+    }
+    return result;
+}
+
+std::string NormalizeTarget(const std::string& target)
+{
+    std::string name = llvm::StringRef(target).lower();
+    if (name == "sse4.2" || name == "sse42" || name == "sse") return "sse4.2";
+    if (name == "avx-512") return "avx512";
+    // SVE 为长度无关的谓词化向量，固定宽度模板不适用，改用可移植 simd
+    if (name == "portable" || name == "stdsimd" || name == "none" ||
+        name == "sve256" || name == "sve-256" || name == "sve") {
+        return "simd";
+    }
+    return name;
+}
+
+std::string FunctionSuffix(const std::string& isaName)
+{
+    return isaName == "sse4.2" ? "sse42" : isaName;
+}
+
+// x86：prefix 为 _mm / _mm256 / _mm512
+void FillX86(const std::string& prefix, int bits, const std::string& elem, SIMDIntrinsicSet& s)
+{
+    const std::string p = prefix + "_";
+    const std::string bitsText = std::to_string(bits);
+    s.header = "immintrin.h";
+    s.alignment = std::to_string(bits / 8);
+    s.compileFlags = bits == 128 ? "-msse4.2" : (bits == 256 ? "-mavx2 -mfma" : "-mavx512f");
+    s.cpuFeature = bits == 128 ? "sse4.2" : (bits == 256 ? "avx2" : "avx512f");
+
+    if (elem == "float" || elem == "double") {
+        bool isFloat = elem == "float";
+        std::string sfx = isFloat ? "ps" : "pd";
+        s.vectorType = "__m" + bitsText + (isFloat ? "" : "d");
+        s.lanes = std::to_string(bits / (isFloat ? 32 : 64));
+        s.loadAligned = p + "load_" + sfx + "(%0)";
+        s.loadUnaligned = p + "loadu_" + sfx + "(%0)";
+        s.storeAligned = p + "store_" + sfx + "(%0, %1)";
+        s.storeUnaligned = p + "storeu_" + sfx + "(%0, %1)";
+        s.broadcast = p + "set1_" + sfx + "(%0)";
+        s.add = p + "add_" + sfx + "(%0, %1)";
+        s.sub = p + "sub_" + sfx + "(%0, %1)";
+        s.mul = p + "mul_" + sfx + "(%0, %1)";
+        s.div = p + "div_" + sfx + "(%0, %1)";
+        s.min = p + "min_" + sfx + "(%0, %1)";
+        s.max = p + "max_" + sfx + "(%0, %1)";
+        s.sqrt = p + "sqrt_" + sfx + "(%0)";
+        // 128/256位没有浮点abs，清除符号位
+        s.abs = bits == 512 ? p + "abs_" + sfx + "(%0)" :
+            p + "andnot_" + sfx + "(" + p + "set1_" + sfx + (isFloat ? "(-0.0f)" : "(-0.0)") + ", %0)";
+        return;
+    }
+
+    s.vectorType = "__m" + bitsText + "i";
+    s.lanes = std::to_string(bits / 32);
+    if (bits == 512) {
+        s.loadAligned = "_mm512_load_si512(%0)";
+        s.loadUnaligned = "_mm512_loadu_si512(%0)";
+        s.storeAligned = "_mm512_store_si512(%0, %1)";
+        s.storeUnaligned = "_mm512_storeu_si512(%0, %1)";
+    } else {
+        std::string si = "si" + bitsText;
+        s.loadAligned = p + "load_" + si + "(reinterpret_cast<const " + s.vectorType + "*>(%0))";
+        s.loadUnaligned = p + "loadu_" + si + "(reinterpret_cast<const " + s.vectorType + "*>(%0))";
+        s.storeAligned = p + "store_" + si + "(reinterpret_cast<" + s.vectorType + "*>(%0), %1)";
+        s.storeUnaligned = p + "storeu_" + si + "(reinterpret_cast<" + s.vectorType + "*>(%0), %1)";
+    }
+    s.broadcast = p + "set1_epi32(%0)";
+    s.add = p + "add_epi32(%0, %1)";
+    s.sub = p + "sub_epi32(%0, %1)";
+    s.mul = p + "mullo_epi32(%0, %1)";
+    s.min = p + "min_epi32(%0, %1)";
+    s.max = p + "max_epi32(%0, %1)";
+    s.abs = p + "abs_epi32(%0)";
+}
+
+void FillNEON(const std::string& elem, SIMDIntrinsicSet& s)
+{
+    std::string sfx = elem == "float" ? "f32" : (elem == "double" ? "f64" : "s32");
+    s.header = "arm_neon.h";
+    s.alignment = "16";
+    s.vectorType = elem == "float" ? "float32x4_t" : (elem == "double" ? "float64x2_t" : "int32x4_t");
+    s.lanes = elem == "double" ? "2" : "4";
+    // NEON 加载/存储不区分对齐
+    s.loadAligned = s.loadUnaligned = "vld1q_" + sfx + "(%0)";
+    s.storeAligned = s.storeUnaligned = "vst1q_" + sfx + "(%0, %1)";
+    s.broadcast = "vdupq_n_" + sfx + "(%0)";
+    s.add = "vaddq_" + sfx + "(%0, %1)";
+    s.sub = "vsubq_" + sfx + "(%0, %1)";
+    s.mul = "vmulq_" + sfx + "(%0, %1)";
+    s.min = "vminq_" + sfx + "(%0, %1)";
+    s.max = "vmaxq_" + sfx + "(%0, %1)";
+    s.abs = "vabsq_" + sfx + "(%0)";
+    if (elem != "int") {
+        s.div = "vdivq_" + sfx + "(%0, %1)";
+        s.sqrt = "vsqrtq_" + sfx + "(%0)";
+    }
+}
+
+void FillPortable(const std::string& elem, SIMDIntrinsicSet& s)
+{
+    s.header = "experimental/simd";
+    s.prelude = "namespace stdx = std::experimental;";
+    s.compileFlags = "-march=native";     // native_simd 的宽度取决于编译目标
+    s.vectorType = "stdx::native_simd<" + elem + ">";
+    s.lanes = "static_cast<int>(" + s.vectorType + "::size())";
+    s.alignment = "stdx::memory_alignment_v<" + s.vectorType + ">";
+    s.loadAligned = s.vectorType + "(%0, stdx::vector_aligned)";
+    s.loadUnaligned = s.vectorType + "(%0, stdx::element_aligned)";
+    s.storeAligned = "%1.copy_to(%0, stdx::vector_aligned)";
+    s.storeUnaligned = "%1.copy_to(%0, stdx::element_aligned)";
+    s.broadcast = s.vectorType + "(%0)";
+    s.add = "(%0 + %1)";
+    s.sub = "(%0 - %1)";
+    s.mul = "(%0 * %1)";
+    s.div = "(%0 / %1)";
+    s.min = "stdx::min(%0, %1)";
+    s.max = "stdx::max(%0, %1)";
+    s.abs = "stdx::abs(%0)";
+    if (elem != "int") {
+        s.sqrt = "stdx::sqrt(%0)";
+    }
+}
+
+const clang::FunctionDecl* FindContainingFunction(const clang::Stmt* stmt, clang::ASTContext& ctx)
+{
+    auto parents = ctx.getParents(*stmt);
+    while (!parents.empty()) {
+        if (const auto* func = parents[0].get<clang::FunctionDecl>()) return func;
+        if (const auto* pStmt = parents[0].get<clang::Stmt>()) {
+            parents = ctx.getParents(*pStmt);
+        } else if (const auto* pDecl = parents[0].get<clang::Decl>()) {
+            parents = ctx.getParents(*pDecl);
+        } else {
+            break;
+        }
+    }
+    return nullptr;
+}
+
+bool ContainsJump(const clang::Stmt* stmt)
+{
+    if (!stmt) return false;
+    if (llvm::isa<clang::BreakStmt>(stmt) || llvm::isa<clang::ContinueStmt>(stmt) ||
+        llvm::isa<clang::ReturnStmt>(stmt) || llvm::isa<clang::GotoStmt>(stmt)) {
+        return true;
+    }
+    for (const auto* child : stmt->children()) {
+        if (ContainsJump(child)) return true;
+    }
+    return false;
+}
+
+const clang::VarDecl* GetVar(const clang::Expr* expr)
+{
+    const auto* ref = llvm::dyn_cast_or_null<clang::DeclRefExpr>(
+        expr ? expr->IgnoreParenImpCasts() : nullptr);
+    return ref ? llvm::dyn_cast<clang::VarDecl>(ref->getDecl()) : nullptr;
+}
+
+std::string EscapeFileName(const std::string& file)
+{
+    std::string result;
+    for (char c : file) {
+        if (c == '\\' || c == '"') result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+bool IsSupportedIdiom(const std::string& idiom)
+{
+    return idiom == "sum" || idiom == "product" || idiom == "min" || idiom == "max" || idiom == "dot";
+}
+
+} // namespace
+
+// ============================================
+// SIMDIntrinsicSet
+// ============================================
+
+bool SIMDIntrinsicSet::Get(const std::string& target, const std::string& elementType,
+                           SIMDIntrinsicSet& result)
+{
+    if (elementType != "float" && elementType != "double" && elementType != "int") {
+        return false;
+    }
+
+    std::string name = NormalizeTarget(target);
+    result = SIMDIntrinsicSet();
+    result.isaName = name;
+    result.elementType = elementType;
+
+    if (name == "sse4.2") {
+        FillX86("_mm", 128, elementType, result);
+    } else if (name == "avx2") {
+        FillX86("_mm256", 256, elementType, result);
+    } else if (name == "avx512") {
+        FillX86("_mm512", 512, elementType, result);
+    } else if (name == "neon") {
+        FillNEON(elementType, result);
+    } else if (name == "simd") {
+        FillPortable(elementType, result);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> SIMDCodeEmitter::GetSupportedTargets()
+{
+    return {"sse4.2", "avx2", "avx512", "neon", "simd"};
+}
+
+// ============================================
+// SIMDCodeEmitter
+// ============================================
+
+SIMDCodeEmitter::SIMDCodeEmitter(clang::ASTContext& ctx, const std::string& target)
+    : astContext(ctx), targetName(NormalizeTarget(target)), inductionAnalysis(ctx)
+{}
+
+bool SIMDCodeEmitter::Fail(const std::string& reason)
+{
+    if (failure.empty()) {
+        failure = reason;
+    }
+    return false;
+}
+
+std::string SIMDCodeEmitter::GetText(clang::SourceLocation begin, clang::SourceLocation end) const
+{
+    if (begin.isInvalid() || end.isInvalid() || begin.isMacroID() || end.isMacroID()) {
+        return "";
+    }
+    return clang::Lexer::getSourceText(clang::CharSourceRange::getCharRange(begin, end),
+                                       astContext.getSourceManager(),
+                                       astContext.getLangOpts()).str();
+}
+
+// 完整源码文本（GetSourceText 会截断并压成一行，不能用于生成代码）
+std::string SIMDCodeEmitter::GetText(const clang::Stmt* stmt) const
+{
+    if (!stmt) return "";
+    clang::SourceRange range = stmt->getSourceRange();
+    if (range.isInvalid() || range.getBegin().isMacroID() || range.getEnd().isMacroID()) {
+        return "";
+    }
+    return clang::Lexer::getSourceText(clang::CharSourceRange::getTokenRange(range),
+                                       astContext.getSourceManager(),
+                                       astContext.getLangOpts()).str();
+}
+
+const clang::Stmt* SIMDCodeEmitter::SelectLoop(const ComputeGraph& computeGraph) const
+{
+    for (const auto& node : computeGraph.GetAllNodes()) {
+        if (!node->astStmt || !node->HasProperty("idiom")) continue;
+        if (const clang::Stmt* loop = inductionAnalysis.FindEnclosingLoop(node->astStmt)) {
+            return loop;
+        }
+    }
+    return nullptr;
+}
+
+bool SIMDCodeEmitter::DetermineElementType(const clang::Stmt* body)
+{
+    std::vector<const clang::Stmt*> stmts;
+    if (const auto* block = llvm::dyn_cast<clang::CompoundStmt>(body)) {
+        stmts.assign(block->body_begin(), block->body_end());
+    } else {
+        stmts.push_back(body);
+    }
+
+    for (const auto* stmt : stmts) {
+        if (const auto* ifStmt = llvm::dyn_cast<clang::IfStmt>(stmt)) {
+            stmt = ifStmt->getThen();
+            if (const auto* block = llvm::dyn_cast<clang::CompoundStmt>(stmt)) {
+                stmt = block->size() == 1 ? block->body_front() : nullptr;
+            }
+        }
+        const clang::Expr* target = nullptr;
+        if (const auto* binOp = llvm::dyn_cast_or_null<clang::BinaryOperator>(stmt)) {
+            if (binOp->isAssignmentOp()) target = binOp->getLHS();
+        } else if (const auto* unaryOp = llvm::dyn_cast_or_null<clang::UnaryOperator>(stmt)) {
+            if (unaryOp->isIncrementDecrementOp()) target = unaryOp->getSubExpr();
+        }
+        if (!target) continue;
+
+        clang::QualType type = target->getType().getNonReferenceType().getCanonicalType()
+                                   .getUnqualifiedType();
+        if (type->isSpecificBuiltinType(clang::BuiltinType::Float)) {
+            elementTypeName = "float";
+        } else if (type->isSpecificBuiltinType(clang::BuiltinType::Double)) {
+            elementTypeName = "double";
+        } else if (type->isSpecificBuiltinType(clang::BuiltinType::Int)) {
+            elementTypeName = "int";
+        } else {
+            return Fail("unsupported element type '" + type.getAsString() + "'");
+        }
+        elementType = type;
+        if (!SIMDIntrinsicSet::Get(targetName, elementTypeName, isa)) {
+            return Fail("unknown SIMD target '" + targetName + "'");
+        }
+        return true;
+    }
+    return Fail("loop body has no store or reduction");
+}
+
+bool SIMDCodeEmitter::CheckDependences() const
+{
+    int lanes = 0;
+    if (llvm::StringRef(isa.lanes).getAsInteger(10, lanes)) {
+        lanes = 64;     // 可移植 simd 的宽度在编译期确定，按最宽情况检查
+    }
+    for (const auto& edge : graph->GetAllEdges()) {
+        if (edge->kind != ComputeEdgeKind::LoopCarried) continue;
+        auto carried = edge->properties.find("inner_carried");
+        auto kind = edge->properties.find("dep_kind");
+        if (carried == edge->properties.end() || carried->second != "true") continue;
+        // 【修复】只有迭代内读先于写的反依赖可以忽略（语句按源码顺序翻译）
+        auto readFirst = edge->properties.find("read_before_write");
+        if (kind != edge->properties.end() && kind->second == "anti" &&
+            readFirst != edge->properties.end() && readFirst->second == "true") {
+            continue;
+        }
+
+        int distance = 0;
+        auto distanceIt = edge->properties.find("inner_distance");
+        if (distanceIt == edge->properties.end() ||
+            llvm::StringRef(distanceIt->second).getAsInteger(10, distance) || distance < lanes) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================
+// 表达式翻译
+// ============================================
+
+bool SIMDCodeEmitter::TranslateAccess(const clang::ArraySubscriptExpr* access, bool aligned,
+                                      std::string& out)
+{
+    std::string text = GetText(access);
+    if (text.empty()) return Fail("array access inside a macro");
+    if (!astContext.hasSameUnqualifiedType(access->getType(), elementType)) {
+        return Fail("mixed element types at '" + text + "'");
+    }
+
+    AffineIndex index = inductionAnalysis.AnalyzeIndex(access, *loopInfo);
+    if (!index.isAffine || !index.hasConstStride || index.iterationStride != 1) {
+        return Fail("non-contiguous access '" + text + "' (stride " + index.StrideString() + ")");
+    }
+
+    std::string address = "&(" + text + ")";
+    if (alignmentCheckSet.insert(address).second) {
+        alignmentChecks.push_back(address);
+        // 对齐分析给出首次迭代的地址对齐（align_entry）不小于向量对齐时无需运行时检查
+        auto node = graph->FindNodeByStmt(access);
+        unsigned long long required = 0;
+        unsigned long long entry = 0;
+        if (node && !llvm::StringRef(isa.alignment).getAsInteger(10, required) && required > 0 &&
+            !llvm::StringRef(node->GetProperty("align_entry")).getAsInteger(10, entry) && entry >= required) {
+            staticallyAligned.insert(address);
+        }
+    }
+    out = Fill(aligned ? isa.loadAligned : isa.loadUnaligned, address);
+    return true;
+}
+
+bool SIMDCodeEmitter::TranslateExpr(const clang::Expr* expr, bool aligned, std::string& out)
+{
+    if (!expr) return Fail("missing expression");
+
+    // 向量局部变量与归约累加器
+    if (const auto* var = GetVar(expr)) {
+        auto it = vectorLocals.find(var);
+        if (it != vectorLocals.end()) {
+            out = it->second;
+            return true;
+        }
+    }
+
+    // 循环不变量：循环外求值后广播
+    if (expr->getType()->isArithmeticType() &&
+        inductionAnalysis.IsLoopInvariant(expr, *loopInfo)) {
+        std::string text = GetText(expr);
+        if (text.empty()) return Fail("invariant operand inside a macro");
+        if (!astContext.hasSameUnqualifiedType(expr->getType(), elementType)) {
+            text = "static_cast<" + elementTypeName + ">(" + text + ")";
+        }
+        out = Fill(isa.broadcast, text);
+        return true;
+    }
+
+    if (const auto* paren = llvm::dyn_cast<clang::ParenExpr>(expr)) {
+        return TranslateExpr(paren->getSubExpr(), aligned, out);
+    }
+    if (const auto* cast = llvm::dyn_cast<clang::CastExpr>(expr)) {
+        // 只接受不改变元素类型的转换（左值到右值、同类型显式转换）
+        if (!astContext.hasSameUnqualifiedType(cast->getType(), elementType) ||
+            !astContext.hasSameUnqualifiedType(cast->getSubExpr()->getType(), elementType)) {
+            return Fail("type conversion in '" + GetText(expr) + "'");
+        }
+        return TranslateExpr(cast->getSubExpr(), aligned, out);
+    }
+    if (const auto* access = llvm::dyn_cast<clang::ArraySubscriptExpr>(expr)) {
+        return TranslateAccess(access, aligned, out);
+    }
+    if (!astContext.hasSameUnqualifiedType(expr->getType(), elementType)) {
+        return Fail("mixed element types in '" + GetText(expr) + "'");
+    }
+
+    if (const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(expr)) {
+        const std::string* pattern = nullptr;
+        switch (binOp->getOpcode()) {
+            case clang::BO_Add: pattern = &isa.add; break;
+            case clang::BO_Sub: pattern = &isa.sub; break;
+            case clang::BO_Mul: pattern = &isa.mul; break;
+            case clang::BO_Div: pattern = &isa.div; break;
+            default: break;
+        }
+        if (!pattern || pattern->empty()) {
+            return Fail("operator '" + binOp->getOpcodeStr().str() + "' has no " +
+                        isa.isaName + " " + elementTypeName + " form");
+        }
+        std::string lhs, rhs;
+        if (!TranslateExpr(binOp->getLHS(), aligned, lhs) ||
+            !TranslateExpr(binOp->getRHS(), aligned, rhs)) {
+            return false;
+        }
+        out = Fill(*pattern, lhs, rhs);
+        return true;
+    }
+
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(expr)) {
+        std::string operand;
+        if (unaryOp->getOpcode() == clang::UO_Plus) {
+            return TranslateExpr(unaryOp->getSubExpr(), aligned, out);
+        }
+        if (unaryOp->getOpcode() == clang::UO_Minus &&
+            TranslateExpr(unaryOp->getSubExpr(), aligned, operand)) {
+            out = Fill(isa.sub, Fill(isa.broadcast, "0"), operand);
+            return true;
+        }
+        return Fail("unsupported unary operator in '" + GetText(expr) + "'");
+    }
+
+    if (const auto* call = llvm::dyn_cast<clang::CallExpr>(expr)) {
+        const auto* callee = call->getDirectCallee();
+        std::string name = callee ? callee->getNameAsString() : "";
+        const std::string* pattern = nullptr;
+        unsigned arity = 1;
+        if (name == "sqrt" || name == "sqrtf") {
+            pattern = &isa.sqrt;
+        } else if (name == "fabs" || name == "fabsf" || name == "abs") {
+            pattern = &isa.abs;
+        } else if (name == "fmin" || name == "fminf" || name == "min") {
+            pattern = &isa.min;
+            arity = 2;
+        } else if (name == "fmax" || name == "fmaxf" || name == "max") {
+            pattern = &isa.max;
+            arity = 2;
+        }
+        if (!pattern || pattern->empty() || call->getNumArgs() != arity) {
+            return Fail("call to '" + name + "' has no " + isa.isaName + " form");
+        }
+        std::string arg0, arg1;
+        if (!TranslateExpr(call->getArg(0), aligned, arg0) ||
+            (arity == 2 && !TranslateExpr(call->getArg(1), aligned, arg1))) {
+            return false;
+        }
+        out = Fill(*pattern, arg0, arg1);
+        return true;
+    }
+
+    return Fail("unsupported expression '" + GetText(expr) + "'");
+}
+
+// ============================================
+// 语句翻译
+// ============================================
+
+bool SIMDCodeEmitter::TranslateStore(const clang::BinaryOperator* binOp,
+                                     const clang::ArraySubscriptExpr* target, VectorStmt& out)
+{
+    auto node = graph->FindNodeByStmt(binOp);
+    std::string idiom = node ? node->GetProperty("idiom") : "";
+    if (idiom != "map") {
+        return Fail("store '" + GetText(binOp) + "' is not an element-wise map" +
+                    (idiom.empty() ? "" : " (" + idiom + ")"));
+    }
+
+    const std::string* combine = nullptr;
+    switch (binOp->getOpcode()) {
+        case clang::BO_Assign: break;
+        case clang::BO_AddAssign: combine = &isa.add; break;
+        case clang::BO_SubAssign: combine = &isa.sub; break;
+        case clang::BO_MulAssign: combine = &isa.mul; break;
+        case clang::BO_DivAssign: combine = &isa.div; break;
+        default: return Fail("unsupported compound assignment '" + GetText(binOp) + "'");
+    }
+    if (combine && combine->empty()) {
+        return Fail("compound assignment has no " + isa.isaName + " " + elementTypeName + " form");
+    }
+
+    for (bool aligned : {true, false}) {
+        std::string current, value;
+        if (!TranslateAccess(target, aligned, current) ||
+            !TranslateExpr(binOp->getRHS(), aligned, value)) {
+            return false;
+        }
+        if (combine) {
+            value = Fill(*combine, current, value);
+        }
+        std::string address = "&(" + GetText(target) + ")";
+        std::string code = Fill(aligned ? isa.storeAligned : isa.storeUnaligned, address, value) + ";";
+        (aligned ? out.alignedCode : out.unalignedCode) = code;
+    }
+    return true;
+}
+
+bool SIMDCodeEmitter::TranslateReduction(const clang::Stmt* update, const std::string& idiom,
+                                         VectorStmt& out)
+{
+    if (!IsSupportedIdiom(idiom)) {
+        return Fail("'" + GetText(update) + "' is " +
+                    (idiom.empty() ? "not a recognized reduction" : "a " + idiom + " idiom") +
+                    ", which is not emitted");
+    }
+    auto node = graph->FindNodeByStmt(update);
+    if (node && !node->GetProperty("idiom_subtype").empty()) {
+        return Fail(node->GetProperty("idiom_subtype") + " reductions are not emitted");
+    }
+
+    const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(update);
+    const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(update);
+    if (!binOp && !unaryOp) return Fail("unsupported reduction update '" + GetText(update) + "'");
+    const clang::VarDecl* var = GetVar(binOp ? binOp->getLHS() : unaryOp->getSubExpr());
+    if (!var) return Fail("reduction target is not a variable");
+    if (!astContext.hasSameUnqualifiedType(var->getType().getNonReferenceType(), elementType)) {
+        return Fail("accumulator '" + var->getNameAsString() + "' has a different element type");
+    }
+
+    std::string op = node ? node->GetProperty("idiom_op") : "";
+    if (op.empty()) return Fail("reduction operator unknown");
+
+    Reduction* reduction = nullptr;
+    for (auto& existing : reductions) {
+        if (existing.var == var) reduction = &existing;
+    }
+    if (!reduction) {
+        reductions.push_back({var, var->getNameAsString(), "vacc_" + var->getNameAsString() + "_", op});
+        reduction = &reductions.back();
+    } else if (reduction->op != op) {
+        return Fail("accumulator '" + reduction->name + "' mixes reduction operators");
+    }
+    const std::string acc = reduction->vectorName;
+
+    for (bool aligned : {true, false}) {
+        std::string value;
+        if (unaryOp) {
+            bool increment = unaryOp->isIncrementOp();
+            value = Fill(increment ? isa.add : isa.sub, acc, Fill(isa.broadcast, "1"));
+        } else if (binOp->isCompoundAssignmentOp()) {
+            std::string operand;
+            if (!TranslateExpr(binOp->getRHS(), aligned, operand)) return false;
+            const std::string& pattern = binOp->getOpcode() == clang::BO_SubAssign ? isa.sub :
+                (binOp->getOpcode() == clang::BO_MulAssign ? isa.mul : isa.add);
+            value = Fill(pattern, acc, operand);
+        } else if (op == "+" || op == "*") {
+            // s = s + E：在右侧把累加器替换为向量累加器
+            vectorLocals[var] = acc;
+            bool ok = TranslateExpr(binOp->getRHS(), aligned, value);
+            vectorLocals.erase(var);
+            if (!ok) return false;
+        } else {
+            // min/max：取不是累加器的那个操作数
+            const clang::Expr* rhs = binOp->getRHS()->IgnoreParenImpCasts();
+            const clang::Expr* operand = rhs;
+            if (const auto* call = llvm::dyn_cast<clang::CallExpr>(rhs)) {
+                if (call->getNumArgs() == 2) {
+                    operand = GetVar(call->getArg(0)) == var ? call->getArg(1) : call->getArg(0);
+                }
+            } else if (const auto* cond = llvm::dyn_cast<clang::ConditionalOperator>(rhs)) {
+                operand = GetVar(cond->getTrueExpr()) == var ? cond->getFalseExpr() : cond->getTrueExpr();
+            }
+            std::string translated;
+            if (!TranslateExpr(operand, aligned, translated)) return false;
+            value = Fill(op == "min" ? isa.min : isa.max, acc, translated);
+        }
+        (aligned ? out.alignedCode : out.unalignedCode) = acc + " = " + value + ";";
+    }
+    return true;
+}
+
+bool SIMDCodeEmitter::TranslateStmt(const clang::Stmt* stmt, VectorStmt& out)
+{
+    if (llvm::isa<clang::NullStmt>(stmt)) {
+        return true;
+    }
+
+    if (const auto* declStmt = llvm::dyn_cast<clang::DeclStmt>(stmt)) {
+        const auto* var = declStmt->isSingleDecl() ?
+            llvm::dyn_cast<clang::VarDecl>(declStmt->getSingleDecl()) : nullptr;
+        if (!var || !var->getInit()) return Fail("unsupported declaration '" + GetText(stmt) + "'");
+        if (!astContext.hasSameUnqualifiedType(var->getType(), elementType)) {
+            return Fail("local '" + var->getNameAsString() + "' has a different element type");
+        }
+        if (!loopInfo->bodyDefinitions.count(var)) {
+            return Fail("local '" + var->getNameAsString() + "' is modified in the loop");
+        }
+        std::string name = var->getNameAsString();
+        for (bool aligned : {true, false}) {
+            std::string init;
+            if (!TranslateExpr(var->getInit(), aligned, init)) return false;
+            (aligned ? out.alignedCode : out.unalignedCode) = "V_ " + name + " = " + init + ";";
+        }
+        vectorLocals[var] = name;
+        return true;
+    }
+
+    // if (E > s) s = E;
+    if (const auto* ifStmt = llvm::dyn_cast<clang::IfStmt>(stmt)) {
+        const clang::Stmt* then = ifStmt->getThen();
+        if (const auto* block = llvm::dyn_cast<clang::CompoundStmt>(then)) {
+            then = block->size() == 1 ? block->body_front() : nullptr;
+        }
+        auto node = then ? graph->FindNodeByStmt(then) : nullptr;
+        std::string idiom = node ? node->GetProperty("idiom") : "";
+        if (ifStmt->getElse() || (idiom != "min" && idiom != "max")) {
+            return Fail("conditional statement at line " +
+                        std::to_string(GetSourceLine(ifStmt, astContext)) + " is not vectorized");
+        }
+        return TranslateReduction(then, idiom, out);
+    }
+
+    if (const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(stmt)) {
+        if (binOp->isAssignmentOp()) {
+            const clang::Expr* lhs = binOp->getLHS()->IgnoreParens();
+            if (const auto* target = llvm::dyn_cast<clang::ArraySubscriptExpr>(lhs)) {
+                return TranslateStore(binOp, target, out);
+            }
+            auto node = graph->FindNodeByStmt(binOp);
+            return TranslateReduction(binOp, node ? node->GetProperty("idiom") : "", out);
+        }
+    }
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(stmt)) {
+        if (unaryOp->isIncrementDecrementOp() && GetVar(unaryOp->getSubExpr())) {
+            auto node = graph->FindNodeByStmt(unaryOp);
+            return TranslateReduction(unaryOp, node ? node->GetProperty("idiom") : "", out);
+        }
+    }
+
+    return Fail("unsupported statement '" + GetText(stmt) + "'");
+}
+
+// ============================================
+// 生成
+// ============================================
+
+SIMDEmitResult SIMDCodeEmitter::Emit(const ComputeGraph& computeGraph)
+{
+    SIMDEmitResult result;
+    graph = &computeGraph;
+    loopInfo = nullptr;
+    elementTypeName.clear();
+    elementType = clang::QualType();
+    vectorLocals.clear();
+    reductions.clear();
+    alignmentChecks.clear();
+    alignmentCheckSet.clear();
+    staticallyAligned.clear();
+    failure.clear();
+
+    auto fail = [&result](const std::string& reason) {
+        result.reason = reason;
+        return result;
+    };
+
+    const auto* forStmt = llvm::dyn_cast_or_null<clang::ForStmt>(SelectLoop(computeGraph));
+    if (!forStmt) return fail("no recognized idiom inside a for-loop");
+
+    const clang::FunctionDecl* func = FindContainingFunction(forStmt, astContext);
+    if (!func) return fail("loop is not inside a function");
+    if (llvm::isa<clang::CXXMethodDecl>(func) || func->isTemplated()) {
+        return fail("member and template functions are not emitted");
+    }
+    // 【修复】实例的源码区间指向模式的文本（含模板参数），切出的代码无法编译
+    if (func->isTemplateInstantiation()) {
+        return fail("template instances are not emitted (their source text is the pattern's)");
+    }
+
+    // 归纳变量：单个、步长为1、上界形式
+    const LoopInductionInfo& info = inductionAnalysis.Analyze(forStmt);
+    loopInfo = &info;
+    const InductionVariable* iv = info.GetPrimary();
+    if (!iv || iv->step != 1 || info.inductionVars.size() != 1) {
+        return fail("requires a single unit-stride induction variable");
+    }
+    if (iv->compareOp != "<" && iv->compareOp != "<=" && iv->compareOp != "!=") {
+        return fail("unsupported loop condition '" + iv->compareOp + "'");
+    }
+    const auto* cond = llvm::dyn_cast_or_null<clang::BinaryOperator>(
+        forStmt->getCond() ? forStmt->getCond()->IgnoreParenImpCasts() : nullptr);
+    if (!cond) return fail("unsupported loop condition");
+    std::string bound = GetText(GetVar(cond->getLHS()) == iv->var ? cond->getRHS() : cond->getLHS());
+    if (bound.empty()) return fail("loop bound is a macro");
+
+    std::string ivInit;
+    if (const auto* init = forStmt->getInit()) {
+        const auto* declStmt = llvm::dyn_cast<clang::DeclStmt>(init);
+        if (declStmt && declStmt->isSingleDecl() && declStmt->getSingleDecl() == iv->var &&
+            iv->var->getInit()) {
+            ivInit = iv->var->getType().getAsString() + " " + iv->name + " = " +
+                     GetText(iv->var->getInit()) + ";";
+        } else if (!declStmt) {
+            ivInit = GetText(init) + ";";
+        }
+        if (ivInit.empty() || ivInit == ";") return fail("unsupported loop initializer");
+    }
+
+    // 值域分析给出的迭代次数（Loop节点的 trip_count_*）
+    int lanes = 0;
+    bool numericLanes = !llvm::StringRef(isa.lanes).getAsInteger(10, lanes) && lanes > 0;
+    long long tripMax = -1;
+    unsigned long long tripMultiple = 1;
+    if (auto loopNode = graph->FindNodeByStmt(forStmt)) {
+        if (llvm::StringRef(loopNode->GetProperty("trip_count_max")).getAsInteger(10, tripMax)) {
+            tripMax = -1;
+        }
+        if (llvm::StringRef(loopNode->GetProperty("trip_count_multiple")).getAsInteger(10, tripMultiple)) {
+            tripMultiple = 1;
+        }
+    }
+    if (numericLanes && tripMax >= 0 && tripMax < lanes) {
+        return fail("trip count " + std::to_string(tripMax) + " is below the vector length");
+    }
+    bool needsTail = !numericLanes || tripMultiple % static_cast<unsigned long long>(lanes) != 0;
+    bool alignmentDispatch = !numericLanes || tripMax < 0 || tripMax >= 4LL * lanes;
+
+    const clang::Stmt* body = forStmt->getBody();
+    if (ContainsJump(body)) return fail("loop body contains break/continue/return/goto");
+    if (!DetermineElementType(body)) return fail(failure);
+    if (!CheckDependences()) {
+        return fail("loop-carried dependence shorter than the vector length");
+    }
+
+    std::vector<VectorStmt> vectorStmts;
+    std::vector<const clang::Stmt*> stmts;
+    if (const auto* block = llvm::dyn_cast<clang::CompoundStmt>(body)) {
+        stmts.assign(block->body_begin(), block->body_end());
+    } else {
+        stmts.push_back(body);
+    }
+    for (const auto* stmt : stmts) {
+        VectorStmt vectorStmt;
+        if (!TranslateStmt(stmt, vectorStmt)) return fail(failure);
+        vectorStmts.push_back(vectorStmt);
+    }
+
+    // 函数文本切分：[开头, 函数名) 新函数名 [函数名之后, 循环) 向量化块 (循环, 函数结尾]
+    const clang::SourceManager& sm = astContext.getSourceManager();
+    const clang::LangOptions& langOpts = astContext.getLangOpts();
+    clang::SourceLocation nameEnd =
+        clang::Lexer::getLocForEndOfToken(func->getLocation(), 0, sm, langOpts);
+    clang::SourceLocation loopEnd =
+        clang::Lexer::getLocForEndOfToken(forStmt->getEndLoc(), 0, sm, langOpts);
+    clang::SourceLocation funcEnd =
+        clang::Lexer::getLocForEndOfToken(func->getEndLoc(), 0, sm, langOpts);
+
+    std::string head = GetText(func->getBeginLoc(), func->getLocation());
+    std::string signature = GetText(nameEnd, forStmt->getBeginLoc());
+    std::string tail = GetText(loopEnd, funcEnd);
+    std::string bodyText = GetText(body);
+    if (head.empty() || signature.empty() || tail.empty() || bodyText.empty()) {
+        return fail("function text is not available (macro expansion?)");
+    }
+    if (!llvm::isa<clang::CompoundStmt>(body)) {
+        bodyText = "{ " + bodyText + "; }";
+    }
+
+    std::string file = EscapeFileName(sm.getFilename(sm.getSpellingLoc(forStmt->getBeginLoc())).str());
+    int funcLine = static_cast<int>(sm.getSpellingLineNumber(func->getBeginLoc()));
+    int loopLine = static_cast<int>(sm.getSpellingLineNumber(forStmt->getBeginLoc()));
+    int bodyLine = static_cast<int>(sm.getSpellingLineNumber(body->getBeginLoc()));
+    int tailLine = static_cast<int>(sm.getSpellingLineNumber(forStmt->getEndLoc()));
+    unsigned column = sm.getSpellingColumnNumber(forStmt->getBeginLoc());
+    std::string indent(column > 0 ? column - 1 : 0, ' ');
+    std::string in1 = indent + "    ";
+    std::string in2 = in1 + "    ";
+    std::string in3 = in2 + "    ";
+
+    std::string name = func->getNameAsString() + "_" + FunctionSuffix(isa.isaName);
+    std::string vectorCond = iv->compareOp == "<=" ?
+        iv->name + " + vl_ - 1 <= (" + bound + ")" : iv->name + " + vl_ <= (" + bound + ")";
+    std::string vectorLoop = "for (; " + vectorCond + "; " + iv->name + " += vl_) {\n";
+
+    std::ostringstream comment;
+    comment << "// Generated by ComputeGraphTool: " << isa.isaName << " version of '"
+            << func->getNameAsString() << "' (loop at " << file << ":" << loopLine << ")\n";
+    if (graph->HasProperty("idioms")) {
+        comment << "// Idioms: " << graph->GetProperty("idioms");
+        if (graph->GetProperty("fp_reassociation") == "true") {
+            comment << " (reassociates floating-point reductions)";
+        }
+        comment << "\n";
+    }
+    // 【修复】只在未做指针分析时声明“假定不重叠”，否则说明依赖检查用到的别名事实
+    comment << "// Compile together with the original translation unit.\n";
+    std::string pointsTo = graph->GetProperty("dep_points_to");
+    if (pointsTo.empty() || pointsTo == "off") {
+        comment << "// Distinct arrays are assumed not to overlap (--points-to=off).\n";
+    } else {
+        std::string disjoint = graph->GetProperty("dep_disjoint_bases");
+        std::string mayAlias = graph->GetProperty("dep_may_alias");
+        comment << "// Memory dependences checked with " << pointsTo << " points-to analysis: "
+                << (disjoint.empty() ? "0" : disjoint) << " access pair(s) on distinct bases proven disjoint, "
+                << (mayAlias.empty() ? "0" : mayAlias) << " may alias.\n";
+    }
+
+    std::ostringstream preamble;
+    preamble << "#include <cstdint>\n";
+    preamble << "#include <" << isa.header << ">\n";
+    if (!isa.prelude.empty()) {
+        preamble << isa.prelude << "\n";
+    }
+
+    // 替换原循环的代码块
+    std::ostringstream os;
+    os << "#line " << loopLine << " \"" << file << "\"\n";
+    os << indent << "{\n";
+    os << in1 << "using V_ = " << isa.vectorType << ";\n";
+    os << in1 << "constexpr int vl_ = " << isa.lanes << ";\n";
+    if (!ivInit.empty()) {
+        os << in1 << ivInit << "\n";
+    }
+    for (const auto& reduction : reductions) {
+        std::string identity = reduction.op == "+" ? "0" :
+            (reduction.op == "*" ? "1" : reduction.name);
+        os << in1 << "V_ " << reduction.vectorName << " = " << Fill(isa.broadcast, identity) << ";\n";
+    }
+
+    auto writeLoop = [&](const std::string& ind, bool aligned) {
+        os << ind << vectorLoop;
+        for (const auto& stmt : vectorStmts) {
+            const std::string& code = aligned ? stmt.alignedCode : stmt.unalignedCode;
+            if (!code.empty()) {
+                os << ind << "    " << code << "\n";
+            }
+        }
+        os << ind << "}\n";
+    };
+    if (isa.HasAlignedForms() && !alignmentChecks.empty() &&
+        staticallyAligned.size() == alignmentChecks.size()) {
+        os << in1 << "// all accesses are " << isa.alignment << "-byte aligned at loop entry\n";
+        writeLoop(in1, true);
+    } else if (isa.HasAlignedForms() && !alignmentChecks.empty() && alignmentDispatch) {
+        // 每次迭代前进 vl_ 个元素，首地址对齐则后续迭代都对齐
+        os << in1 << "const bool aligned_ = ((";
+        for (size_t k = 0; k < alignmentChecks.size(); ++k) {
+            if (k > 0) os << " |\n" << in1 << "    ";
+            os << "reinterpret_cast<std::uintptr_t>(" << alignmentChecks[k] << ")";
+        }
+        os << ") % (" << isa.alignment << ")) == 0;\n";
+        os << in1 << "if (aligned_) {\n";
+        writeLoop(in2, true);
+        os << in1 << "} else {\n";
+        writeLoop(in2, false);
+        os << in1 << "}\n";
+    } else {
+        writeLoop(in1, false);
+    }
+
+    for (const auto& reduction : reductions) {
+        os << in1 << "{\n";
+        os << in2 << "alignas(64) " << elementTypeName << " lanes_[vl_];\n";
+        os << in2 << Fill(isa.storeUnaligned, "lanes_", reduction.vectorName) << ";\n";
+        os << in2 << "for (int k_ = 0; k_ < vl_; ++k_) {\n";
+        if (reduction.op == "+" || reduction.op == "*") {
+            os << in3 << reduction.name << " " << reduction.op << "= lanes_[k_];\n";
+        } else {
+            os << in3 << "if (lanes_[k_] " << (reduction.op == "min" ? "<" : ">") << " "
+               << reduction.name << ") " << reduction.name << " = lanes_[k_];\n";
+        }
+        os << in2 << "}\n";
+        os << in1 << "}\n";
+    }
+
+    // 标量尾部：原循环体（迭代次数是 vl_ 的倍数时向量循环已处理全部元素）
+    if (needsTail) {
+        os << "#line " << bodyLine << " \"" << file << "\"\n";
+        os << in1 << "for (; " << iv->name << " " << iv->compareOp << " (" << bound << "); ++"
+           << iv->name << ") " << bodyText << "\n";
+    } else {
+        os << in1 << "// trip count is a multiple of vl_: no scalar remainder\n";
+    }
+    os << indent << "}\n";
+
+    std::ostringstream full;
+    full << comment.str() << preamble.str();
+    full << "\n#line " << funcLine << " \"" << file << "\"\n";
+    full << head << name << signature << "\n";
+    full << os.str();
+    full << "#line " << tailLine << " \"" << file << "\"\n";
+    full << tail << "\n";
+
+    result.success = true;
+    result.functionName = name;
+    result.isaSuffix = FunctionSuffix(isa.isaName);
+    result.preamble = preamble.str();
+    result.compileFlags = isa.compileFlags;
+    result.cpuFeature = isa.cpuFeature;
+    result.loopCode = os.str();
+    result.code = full.str();
+    result.loopStmt = forStmt;
+    result.sourceFile = file;
+    result.loopLine = loopLine;
+    return result;
+}
+
+} // namespace compute_graph
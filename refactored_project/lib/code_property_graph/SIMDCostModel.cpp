@@ -0,0 +1,532 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * SIMDCostModel.cpp - 计算图向量化收益估计
+ *
+ * 代价单位为"周期"的粗略量级（按倒数吞吐估算），只用于图之间的相对比较。
+ */
+#include "SIMDCostModel.h"
+
+#include "llvm/ADT/StringRef.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <set>
+#include <sstream>
+
+namespace compute_graph {
+
+namespace {
+
+using BaseType = DataTypeInfo::BaseType;
+
+std::string FormatDouble(double value)
+{
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << value;
+    return oss.str();
+}
+
+bool IsIntegerType(const DataTypeInfo& type)
+{
+    switch (type.baseType) {
+        case BaseType::Int8: case BaseType::Int16: case BaseType::Int32: case BaseType::Int64:
+        case BaseType::UInt8: case BaseType::UInt16: case BaseType::UInt32: case BaseType::UInt64:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 满足结合律、可做并行归约的运算
+bool IsReductionOp(OpCode op)
+{
+    switch (op) {
+        case OpCode::Add: case OpCode::Mul:
+        case OpCode::Min: case OpCode::Max:
+        case OpCode::And: case OpCode::Or: case OpCode::Xor:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 标量调用的粗略代价（未内联、不可向量化）
+constexpr double kScalarCallCost = 10.0;
+
+} // namespace
+
+// ============================================
+// 目标描述
+// ============================================
+
+SIMDTargetInfo SIMDTargetInfo::Get(SIMDTarget target)
+{
+    SIMDTargetInfo info;
+    info.target = target;
+    switch (target) {
+        case SIMDTarget::SSE42:
+            info.name = "sse4.2";
+            info.vectorBits = 128;
+            info.uarch = Microarch::SkylakeX;
+            break;
+        case SIMDTarget::AVX2:
+            info.name = "avx2";
+            info.vectorBits = 256;
+            info.hasGather = true;
+            info.uarch = Microarch::SkylakeX;
+            break;
+        case SIMDTarget::AVX512:
+            info.name = "avx512";
+            info.vectorBits = 512;
+            info.hasGather = true;
+            info.hasMasking = true;
+            info.hasNativeFP16 = true;   // AVX512-FP16
+            info.hasNativeBF16 = true;   // AVX512-BF16
+            info.uarch = Microarch::SkylakeX;
+            break;
+        case SIMDTarget::NEON:
+            info.name = "neon";
+            info.vectorBits = 128;
+            info.hasStructLoads = true;
+            info.hasNativeFP16 = true;
+            info.hasNativeBF16 = true;
+            info.uarch = Microarch::NeoverseN2;
+            break;
+        case SIMDTarget::SVE256:
+            info.name = "sve256";
+            info.vectorBits = 256;
+            info.hasGather = true;
+            info.hasMasking = true;
+            info.hasStructLoads = true;
+            info.hasNativeFP16 = true;
+            info.hasNativeBF16 = true;
+            info.uarch = Microarch::NeoverseV1;
+            break;
+    }
+    return info;
+}
+
+std::string CostEstimate::ToString() const
+{
+    std::ostringstream oss;
+    oss << targetName << ": speedup=" << FormatDouble(speedup)
+        << " (scalar " << FormatDouble(scalarCost)
+        << " / vector " << FormatDouble(vectorCost) << " cyc/elem, VF=" << lanes
+        << ", " << FormatDouble(memoryBytes) << " B/elem)";
+    if (!vectorizable || !reason.empty()) {
+        oss << " [" << (vectorizable ? "" : "not vectorizable: ") << reason << "]";
+    }
+    return oss.str();
+}
+
+// ============================================
+// CostModel
+// ============================================
+
+CostEstimate CostModel::Annotate(ComputeGraph& graph) const
+{
+    CostEstimate est = Estimate(graph);
+
+    graph.SetProperty("cost_target", est.targetName);
+    graph.SetProperty("cost_speedup", FormatDouble(est.speedup));
+    graph.SetProperty("cost_scalar", FormatDouble(est.scalarCost));
+    graph.SetProperty("cost_vector", FormatDouble(est.vectorCost));
+    graph.SetProperty("cost_lanes", std::to_string(est.lanes));
+    graph.SetProperty("cost_mem_bytes", FormatDouble(est.memoryBytes));
+    graph.SetProperty("vectorizable", est.vectorizable ? "true" : "false");
+    if (!est.reason.empty()) {
+        graph.SetProperty("cost_reason", est.reason);
+    }
+    if (est.tripCountMax >= 0 && est.tripCountMin == est.tripCountMax) {
+        graph.SetProperty("cost_trip_count", std::to_string(est.tripCountMax));
+    }
+    graph.SetProperty("cost_remainder", est.needsRemainder ? "scalar" : "none");
+    graph.SetProperty("cost_peel", est.peelForAlignment ? "true" : "false");
+    if (est.alignedAccesses > 0) {
+        graph.SetProperty("cost_aligned_accesses", std::to_string(est.alignedAccesses));
+    }
+    return est;
+}
+
+// ============================================
+// SIMDCostModel
+// ============================================
+
+SIMDCostModel::SIMDCostModel(SIMDTarget target)
+    : targetInfo(SIMDTargetInfo::Get(target))
+{}
+
+bool SIMDCostModel::IsInLoopBody(const ComputeNode& node) const
+{
+    return node.loopContextId != 0 || node.loopDepth > 0;
+}
+
+int SIMDCostModel::ElementBits(const ComputeNode& node) const
+{
+    const DataTypeInfo& type = node.dataType;
+    switch (type.baseType) {
+        case BaseType::Pointer:
+        case BaseType::Array:
+        case BaseType::Void:
+        case BaseType::Predicate:
+        case BaseType::Unknown:
+        case BaseType::TemplateParam:
+        case BaseType::Dependent:
+            return 0;
+        default:
+            return type.bitWidth;
+    }
+}
+
+double SIMDCostModel::ScalarOpCost(const ComputeNode& node) const
+{
+    bool isInt = IsIntegerType(node.dataType);
+    bool isDouble = node.dataType.baseType == BaseType::Double;
+
+    switch (node.kind) {
+        case ComputeNodeKind::Cast:
+        case ComputeNodeKind::Select:
+            return 1.0;
+        default:
+            break;
+    }
+
+    switch (node.opCode) {
+        case OpCode::Div:
+            return isInt ? 10.0 : (isDouble ? 8.0 : 4.0);
+        case OpCode::Mod:
+            return 10.0;
+        case OpCode::Sqrt:
+            return isDouble ? 8.0 : 4.0;
+        case OpCode::Assign:
+            return 0.0;
+        default:
+            return 1.0;
+    }
+}
+
+double SIMDCostModel::VectorOpCost(const ComputeNode& node, int lanes) const
+{
+    const DataTypeInfo& type = node.dataType;
+    bool isInt = IsIntegerType(type);
+    bool isX86 = targetInfo.target == SIMDTarget::SSE42 ||
+                 targetInfo.target == SIMDTarget::AVX2 ||
+                 targetInfo.target == SIMDTarget::AVX512;
+    double cost = 1.0;
+
+    switch (node.opCode) {
+        case OpCode::Mul:
+            // x86无字节乘法；64位整数乘法在AVX-512之前需要拆分
+            if (isInt && isX86 && (type.bitWidth == 8 ||
+                (type.bitWidth == 64 && targetInfo.target != SIMDTarget::AVX512))) {
+                cost = 3.0;
+            }
+            break;
+        case OpCode::Div:
+        case OpCode::Mod:
+            if (isInt || node.opCode == OpCode::Mod) {
+                // 无向量整数除法：逐lane标量化，另加插入/提取
+                cost = lanes * (ScalarOpCost(node) + 1.0);
+            } else {
+                // 浮点除法器非全流水，按半数lane计
+                cost = lanes * ScalarOpCost(node) / 2.0;
+            }
+            break;
+        case OpCode::Sqrt:
+            cost = lanes * ScalarOpCost(node) / 2.0;
+            break;
+        case OpCode::Assign:
+            cost = 0.0;
+            break;
+        default:
+            break;
+    }
+
+    if (node.kind == ComputeNodeKind::Cast) {
+        cost = 2.0;  // 宽度变化需要打包/解包
+    }
+
+    if ((type.baseType == BaseType::Float16 && !targetInfo.hasNativeFP16) ||
+        (type.baseType == BaseType::BFloat16 && !targetInfo.hasNativeBF16)) {
+        cost += 2.0;  // 扩展到f32运算再收窄
+    }
+    return cost;
+}
+
+double SIMDCostModel::MemoryAccessCost(const ComputeNode& node, int lanes,
+                                       CostEstimate& est) const
+{
+    bool isStore = node.kind == ComputeNodeKind::Store ||
+                   node.GetProperty("is_assign_target") == "true";
+
+    // 步长由循环归纳分析写入 access_stride（元素个数）；缺失时按连续访问估计
+    std::string strideStr = node.GetProperty("access_stride");
+    long long stride = 1;
+    bool knownStride = true;
+    if (strideStr.empty()) {
+        est.assumedStrideAccesses++;
+    } else if (llvm::StringRef(strideStr).getAsInteger(10, stride)) {
+        knownStride = false;
+    }
+
+    if (knownStride && stride == 0) {
+        return 0.5;  // 循环不变量：广播一次
+    }
+    if (knownStride && (stride == 1 || stride == -1)) {
+        est.contiguousAccesses++;
+        // 对齐分析给出首次迭代的地址已按向量宽度对齐：每次向量迭代都是对齐访问
+        long long entryAlign = 0;
+        if (stride == 1 && !llvm::StringRef(node.GetProperty("align_entry")).getAsInteger(10, entryAlign) &&
+            entryAlign >= targetInfo.vectorBits / 8) {
+            est.alignedAccesses++;
+        }
+        return stride == 1 ? 1.0 : 2.0;  // 反向访问需额外反转
+    }
+    long long absStride = knownStride ? std::llabs(stride) : 0;
+    if (knownStride && absStride <= 4) {
+        est.stridedAccesses++;
+        // 交织加载一次取回多个流；否则多次加载再重排
+        return targetInfo.hasStructLoads ? static_cast<double>(absStride) :
+                                           static_cast<double>(absStride) + 1.0;
+    }
+
+    est.gatherAccesses++;
+    bool hasHardware = isStore ? targetInfo.hasMasking && targetInfo.hasGather :
+                                 targetInfo.hasGather;
+    return hasHardware ? lanes * 0.5 + 2.0 : lanes * 1.5;
+}
+
+CostEstimate SIMDCostModel::Estimate(const ComputeGraph& graph) const
+{
+    CostEstimate est;
+    est.targetName = targetInfo.name;
+
+    // 1. 收集循环体内的节点（只有它们按元素重复执行）
+    std::vector<ComputeGraph::NodePtr> body;
+    for (const auto& [id, node] : graph.GetNodes()) {
+        if (IsInLoopBody(*node)) {
+            body.push_back(node);
+        }
+    }
+    if (body.empty()) {
+        std::string depth = graph.GetProperty("loop_depth");
+        if (depth.empty() || depth == "0") {
+            est.reason = "no enclosing loop";
+            return est;
+        }
+        for (const auto& [id, node] : graph.GetNodes()) {
+            body.push_back(node);
+        }
+    }
+
+    std::set<ComputeNode::NodeId> bodyIds;
+    int maxBits = 0;
+    for (const auto& node : body) {
+        bodyIds.insert(node->id);
+        if (node->IsOperationNode() || node->IsMemoryNode()) {
+            maxBits = std::max(maxBits, ElementBits(*node));
+        }
+    }
+    if (maxBits == 0) maxBits = 32;
+    est.lanes = std::max(1, targetInfo.vectorBits / maxBits);
+
+    // 2. 逐节点累加标量/向量代价
+    bool alreadyVector = false;
+    std::vector<std::string> reasons;
+    double vectorPerGroup = 0.0;   // 每处理 lanes 个元素的向量代价
+    double scalarPerElem = 0.0;
+
+    for (const auto& node : body) {
+        switch (node->kind) {
+            case ComputeNodeKind::BinaryOp:
+            case ComputeNodeKind::UnaryOp:
+            case ComputeNodeKind::CompareOp:
+            case ComputeNodeKind::Select:
+            case ComputeNodeKind::Cast:
+                scalarPerElem += ScalarOpCost(*node);
+                vectorPerGroup += VectorOpCost(*node, est.lanes);
+                break;
+            case ComputeNodeKind::ArrayAccess:
+            case ComputeNodeKind::Load:
+            case ComputeNodeKind::Store:
+                // 多维数组的部分下标只是行地址计算，不单独访存
+                if (node->dataType.baseType == BaseType::Array) break;
+                scalarPerElem += 1.0;
+                est.memoryBytes += std::max(1, ElementBits(*node)) / 8.0;
+                vectorPerGroup += MemoryAccessCost(*node, est.lanes, est);
+                break;
+            case ComputeNodeKind::Branch:
+                // if-conversion：条件合成掩码/blend
+                scalarPerElem += 1.0;
+                vectorPerGroup += targetInfo.hasMasking ? 1.0 : 2.0;
+                break;
+            case ComputeNodeKind::IntrinsicCall: {
+                alreadyVector = true;
+                double cost = 1.0;
+                if (const IntrinsicInfo* info =
+                        IntrinsicSemanticsDB::Instance().Lookup(node->name)) {
+                    IntrinsicCost ic = info->GetCost(targetInfo.uarch);
+                    if (ic.IsValid()) cost = ic.recipThroughput;
+                }
+                scalarPerElem += cost;
+                vectorPerGroup += cost * est.lanes;
+                break;
+            }
+            case ComputeNodeKind::Call:
+                if (node->GetProperty("callee_analyzed") == "true") {
+                    // 被调函数体已展开进图，代价由其节点计入
+                    break;
+                }
+                if (node->HasProperty("vectorizable")) {
+                    scalarPerElem += 1.0;
+                    vectorPerGroup += 1.0;
+                } else {
+                    // 不透明调用：逐lane标量执行
+                    scalarPerElem += kScalarCallCost;
+                    vectorPerGroup += est.lanes * (kScalarCallCost + 1.0);
+                    reasons.push_back("scalar call " + node->name);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    // 3. 循环携带依赖：可归约的按结合律并行，否则为递推、不可向量化
+    bool hasRecurrence = false;
+    bool hasFPReduction = false;
+    for (const auto& [id, edge] : graph.GetEdges()) {
+        if (edge->kind != ComputeEdgeKind::LoopCarried) continue;
+        if (!bodyIds.count(edge->sourceId) || !bodyIds.count(edge->targetId)) continue;
+
+        // 数组依赖测试给出的边：迭代内读先于写的反依赖、外层携带或距离不小于向量长度的依赖
+        // 不妨碍向量化
+        auto depKind = edge->properties.find("dep_kind");
+        if (depKind != edge->properties.end()) {
+            auto readFirst = edge->properties.find("read_before_write");
+            if (depKind->second == "anti" && readFirst != edge->properties.end() &&
+                readFirst->second == "true") {
+                continue;
+            }
+            auto inner = edge->properties.find("inner_carried");
+            if (inner != edge->properties.end() && inner->second != "true") continue;
+            auto distance = edge->properties.find("inner_distance");
+            long long dist = 0;
+            if (distance != edge->properties.end() &&
+                !llvm::StringRef(distance->second).getAsInteger(10, dist) && dist >= est.lanes) {
+                continue;
+            }
+            hasRecurrence = true;
+            continue;
+        }
+
+        auto target = graph.GetNode(edge->targetId);
+        auto source = graph.GetNode(edge->sourceId);
+        bool reducible = (target && IsReductionOp(target->opCode)) ||
+                         (source && IsReductionOp(source->opCode));
+        if (!reducible) {
+            hasRecurrence = true;
+            continue;
+        }
+        if (target && target->dataType.IsFloatingPoint()) {
+            hasFPReduction = true;
+        }
+        // 尾部水平归约 log2(VF) 步，摊到循环上按一次向量运算计
+        vectorPerGroup += 1.0;
+    }
+    if (hasRecurrence) reasons.push_back("loop-carried recurrence");
+    if (hasFPReduction) reasons.push_back("fp reduction needs reassociation");
+    if (alreadyVector) reasons.push_back("already vectorized");
+
+    // 4. 【新增】迭代次数：短于向量长度不值得向量化；是 lanes 的倍数时省掉标量尾循环
+    ReadTripCount(graph, est);
+    // 【新增】所有连续访问都已静态对齐时无需剥离/多版本化
+    if (est.contiguousAccesses > 0 && est.alignedAccesses == est.contiguousAccesses) {
+        est.peelForAlignment = false;
+    }
+    bool tooShort = est.tripCountMax >= 0 && est.tripCountMax < est.lanes;
+    if (tooShort) reasons.push_back("trip count below vector length");
+
+    // 5. 汇总
+    est.scalarCost = scalarPerElem;
+    est.vectorCost = vectorPerGroup / est.lanes;
+
+    // 访存带宽下限：每周期两次整向量加载
+    double bandwidthBound = est.memoryBytes / (2.0 * targetInfo.vectorBits / 8.0);
+    est.vectorCost = std::max(est.vectorCost, bandwidthBound);
+
+    est.vectorizable = !hasRecurrence && !alreadyVector && !tooShort && scalarPerElem > 0.0;
+    if (est.vectorizable && est.vectorCost > 0.0) {
+        est.speedup = est.scalarCost / est.vectorCost;
+        // 迭代次数已知时，尾部 N % lanes 个元素按标量代价计入
+        if (est.tripCountMax > 0 && est.tripCountMin == est.tripCountMax) {
+            int64_t trips = est.tripCountMax;
+            int64_t remainder = trips % est.lanes;
+            double total = (trips - remainder) * est.vectorCost + remainder * est.scalarCost;
+            est.speedup = trips * est.scalarCost / total;
+        }
+    } else {
+        est.speedup = 1.0;
+        if (scalarPerElem <= 0.0) reasons.push_back("no operations in loop body");
+    }
+
+    for (const auto& r : reasons) {
+        if (!est.reason.empty()) est.reason += "; ";
+        est.reason += r;
+    }
+    return est;
+}
+
+void SIMDCostModel::ReadTripCount(const ComputeGraph& graph, CostEstimate& est) const
+{
+    long long value = 0;
+    if (!llvm::StringRef(graph.GetProperty("trip_count_min")).getAsInteger(10, value) && value >= 0) {
+        est.tripCountMin = value;
+    }
+    if (!llvm::StringRef(graph.GetProperty("trip_count_max")).getAsInteger(10, value) && value >= 0) {
+        est.tripCountMax = value;
+    }
+    unsigned long long multiple = 0;
+    if (!llvm::StringRef(graph.GetProperty("trip_count_multiple")).getAsInteger(10, multiple)) {
+        est.tripCountMultiple = multiple;
+    }
+
+    // 倍数为 0 表示迭代次数恒为 0
+    est.needsRemainder = est.tripCountMultiple != 0 &&
+                         est.tripCountMultiple % static_cast<uint64_t>(est.lanes) != 0;
+    // 剥离前若干次迭代对齐只在后续至少还有几组整向量时才划算
+    est.peelForAlignment = est.tripCountMax < 0 || est.tripCountMin >= 4 * static_cast<int64_t>(est.lanes);
+}
+
+// ============================================
+// 工厂
+// ============================================
+
+std::unique_ptr<CostModel> CreateCostModel(const std::string& targetName)
+{
+    std::string name = llvm::StringRef(targetName).lower();
+    if (name == "sse4.2" || name == "sse42" || name == "sse") {
+        return std::make_unique<SIMDCostModel>(SIMDTarget::SSE42);
+    }
+    if (name == "avx2") {
+        return std::make_unique<SIMDCostModel>(SIMDTarget::AVX2);
+    }
+    if (name == "avx512" || name == "avx-512") {
+        return std::make_unique<SIMDCostModel>(SIMDTarget::AVX512);
+    }
+    if (name == "neon") {
+        return std::make_unique<SIMDCostModel>(SIMDTarget::NEON);
+    }
+    if (name == "sve256" || name == "sve-256" || name == "sve") {
+        return std::make_unique<SIMDCostModel>(SIMDTarget::SVE256);
+    }
+    return nullptr;
+}
+
+std::vector<std::string> GetSupportedSIMDTargets()
+{
+    return {"sse4.2", "avx2", "avx512", "neon", "sve256"};
+}
+
+} // namespace compute_graph
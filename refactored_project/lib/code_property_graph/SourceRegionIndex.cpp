@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * SourceRegionIndex.cpp - 节点源码区间索引（循环体/分支体成员查询）
+ */
+
+#include "ComputeGraph.h"
+
+#include "clang/Basic/SourceManager.h"
+
+namespace compute_graph {
+
+void SourceRegionIndex::Reset()
+{
+    indexedGraph = nullptr;
+    lastIndexedId = 0;
+    offsets.clear();
+    unlocatedNodes.clear();
+}
+
+bool SourceRegionIndex::GetNodeLocation(const ComputeNode& node, clang::FileID& file,
+                                        unsigned& offset) const
+{
+    clang::SourceLocation loc;
+    if (node.astStmt) {
+        loc = node.astStmt->getBeginLoc();
+    } else if (node.astDecl) {
+        loc = node.astDecl->getLocation();
+    }
+    if (loc.isInvalid()) return false;
+
+    auto decomposed = sourceManager.getDecomposedLoc(sourceManager.getFileLoc(loc));
+    if (decomposed.first.isInvalid()) return false;
+
+    file = decomposed.first;
+    offset = decomposed.second;
+    return true;
+}
+
+void SourceRegionIndex::Sync(const ComputeGraph& graph)
+{
+    if (indexedGraph != &graph) {
+        Reset();
+        indexedGraph = &graph;
+    }
+
+    const auto& nodes = graph.GetNodes();
+    for (auto it = nodes.upper_bound(lastIndexedId); it != nodes.end(); ++it) {
+        const auto& [id, node] = *it;
+        lastIndexedId = id;
+
+        clang::FileID file;
+        unsigned offset = 0;
+        if (node && GetNodeLocation(*node, file, offset)) {
+            offsets[file].emplace(offset, id);
+        } else {
+            unlocatedNodes.push_back(id);
+        }
+    }
+}
+
+SourceRegionIndex::Region SourceRegionIndex::GetRegion(const clang::Stmt* stmt) const
+{
+    if (!stmt) return Region();
+    return GetRegion(stmt->getBeginLoc(), stmt->getEndLoc());
+}
+
+SourceRegionIndex::Region SourceRegionIndex::GetRegion(clang::SourceLocation begin,
+                                                       clang::SourceLocation end) const
+{
+    Region region;
+    if (begin.isInvalid() || end.isInvalid()) return region;
+
+    auto first = sourceManager.getDecomposedLoc(sourceManager.getFileLoc(begin));
+    auto last = sourceManager.getDecomposedLoc(sourceManager.getFileLoc(end));
+
+    // 跨文件的区间（如 #include 进来的语句体）无法用单一偏移区间表示
+    if (first.first.isInvalid() || first.first != last.first) return region;
+
+    region.file = first.first;
+    region.begin = first.second;
+    region.end = last.second;
+    return region;
+}
+
+std::vector<ComputeNode::NodeId> SourceRegionIndex::Query(const ComputeGraph& graph,
+                                                          const Region& region)
+{
+    std::vector<ComputeNode::NodeId> result;
+    Sync(graph);
+    if (!region.IsValid()) return result;
+
+    auto fileIt = offsets.find(region.file);
+    if (fileIt == offsets.end()) return result;
+
+    const auto& byOffset = fileIt->second;
+    auto end = byOffset.upper_bound(region.end);
+    for (auto it = byOffset.lower_bound(region.begin); it != end; ++it) {
+        if (graph.GetNode(it->second)) {
+            result.push_back(it->second);
+        }
+    }
+    return result;
+}
+
+} // namespace compute_graph
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * TemplateInstantiation.cpp - 函数模板实例化感知的计算图
+ */
+
+#include "TemplateInstantiation.h"
+
+#include "clang/AST/DeclTemplate.h"
+#include "clang/AST/ExprCXX.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace compute_graph {
+
+// ============================================
+// 实例收集
+// ============================================
+
+namespace {
+
+// 实例的模板实参文本（如 "<float>"），不是函数模板实例时为空
+std::string GetTemplateArgsText(const clang::FunctionDecl* func, clang::ASTContext& ctx)
+{
+    std::string text;
+    if (const clang::TemplateArgumentList* args = func->getTemplateSpecializationArgs()) {
+        llvm::raw_string_ostream os(text);
+        clang::printTemplateArgumentList(os, args->asArray(), ctx.getPrintingPolicy());
+        os.flush();
+    }
+    return text;
+}
+
+} // namespace
+
+std::vector<TemplateInstantiation> CollectTemplateInstantiations(
+    const clang::FunctionDecl* pattern, clang::ASTContext& ctx)
+{
+    std::vector<TemplateInstantiation> result;
+    if (!pattern) return result;
+
+    const clang::FunctionTemplateDecl* tmpl = pattern->getDescribedFunctionTemplate();
+    if (!tmpl) return result;
+
+    for (const clang::FunctionDecl* spec : tmpl->specializations()) {
+        // 显式特化有自己的函数体，与模式的结构无关，不能复用骨架
+        auto kind = spec->getTemplateSpecializationKind();
+        if (kind != clang::TSK_ImplicitInstantiation &&
+            kind != clang::TSK_ExplicitInstantiationDefinition) {
+            continue;
+        }
+
+        const clang::FunctionDecl* def = nullptr;
+        if (!spec->hasBody(def) || !def || !def->getBody()) continue;
+
+        TemplateInstantiation inst;
+        inst.pattern = pattern;
+        inst.instance = def;
+        inst.argsText = GetTemplateArgsText(def, ctx);
+        inst.name = pattern->getNameAsString() + inst.argsText;
+        result.push_back(inst);
+    }
+    return result;
+}
+
+std::string GetInstanceName(const clang::FunctionDecl* func, clang::ASTContext& ctx)
+{
+    return func ? func->getNameAsString() + GetTemplateArgsText(func, ctx) : "";
+}
+
+// ============================================
+// 实例语句索引
+// ============================================
+
+class InstantiationIndexer {
+public:
+    explicit InstantiationIndexer(InstantiationMapper& m) : mapper(m) {}
+
+    // 先序遍历：同一区间先插入的是外层语句，emplace 保证外层优先
+    void IndexStmt(const clang::Stmt* stmt)
+    {
+        if (!stmt) return;
+
+        unsigned begin = stmt->getBeginLoc().getRawEncoding();
+        unsigned end = stmt->getEndLoc().getRawEncoding();
+        mapper.byClass.emplace(std::make_tuple(begin, end, static_cast<unsigned>(stmt->getStmtClass())),
+                               stmt);
+        if (!IsImplicitWrapper(stmt)) {
+            mapper.byRange.emplace(std::make_pair(begin, end), stmt);
+        }
+
+        for (const clang::Stmt* child : stmt->children()) {
+            IndexStmt(child);
+        }
+    }
+
+private:
+    static bool IsImplicitWrapper(const clang::Stmt* stmt)
+    {
+        switch (stmt->getStmtClass()) {
+            case clang::Stmt::ImplicitCastExprClass:
+            case clang::Stmt::ExprWithCleanupsClass:
+            case clang::Stmt::MaterializeTemporaryExprClass:
+            case clang::Stmt::CXXBindTemporaryExprClass:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    InstantiationMapper& mapper;
+};
+
+InstantiationMapper::InstantiationMapper(const clang::FunctionDecl* instance)
+{
+    if (!instance) return;
+
+    InstantiationIndexer indexer(*this);
+    indexer.IndexStmt(instance->getBody());
+}
+
+const clang::Stmt* InstantiationMapper::MapStmt(const clang::Stmt* patternStmt) const
+{
+    if (!patternStmt) return nullptr;
+
+    unsigned begin = patternStmt->getBeginLoc().getRawEncoding();
+    unsigned end = patternStmt->getEndLoc().getRawEncoding();
+
+    auto classIt = byClass.find(std::make_tuple(
+        begin, end, static_cast<unsigned>(patternStmt->getStmtClass())));
+    if (classIt != byClass.end()) return classIt->second;
+
+    // 依赖表达式在实例中会换成具体的语句类（如 CXXDependentScopeMemberExpr -> MemberExpr）
+    auto rangeIt = byRange.find(std::make_pair(begin, end));
+    return rangeIt != byRange.end() ? rangeIt->second : nullptr;
+}
+
+// ============================================
+// 实例锚点簇
+// ============================================
+
+bool SpecializeCluster(const AnchorCluster& patternCluster, const TemplateInstantiation& inst,
+                       const InstantiationMapper& mapper, AnchorCluster& instanceCluster)
+{
+    instanceCluster = AnchorCluster();
+    instanceCluster.func = inst.instance;
+    instanceCluster.isLoopScope = patternCluster.isLoopScope;
+    instanceCluster.scopeLine = patternCluster.scopeLine;
+    instanceCluster.score = patternCluster.score;
+    instanceCluster.scopeStmt = patternCluster.isLoopScope
+        ? mapper.MapStmt(patternCluster.scopeStmt) : inst.instance->getBody();
+    if (!instanceCluster.scopeStmt) {
+        return false;
+    }
+
+    bool primaryMapped = false;
+    for (size_t i = 0; i < patternCluster.anchors.size(); ++i) {
+        const AnchorPoint& anchor = patternCluster.anchors[i];
+        const clang::Stmt* instStmt = mapper.MapStmt(anchor.stmt);
+        if (!instStmt) {
+            continue;
+        }
+        if (i == patternCluster.primaryIndex) {
+            instanceCluster.primaryIndex = instanceCluster.anchors.size();
+            primaryMapped = true;
+        }
+        AnchorPoint instAnchor = anchor;
+        instAnchor.stmt = instStmt;
+        instAnchor.func = inst.instance;
+        instanceCluster.anchors.push_back(instAnchor);
+    }
+    if (instanceCluster.anchors.empty()) {
+        return false;
+    }
+    // 主锚点映射不到时取评分最高的剩余锚点
+    if (!primaryMapped) {
+        for (size_t i = 1; i < instanceCluster.anchors.size(); ++i) {
+            if (instanceCluster.anchors[i].score > instanceCluster.anchors[instanceCluster.primaryIndex].score) {
+                instanceCluster.primaryIndex = i;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace compute_graph
@@ -0,0 +1,1681 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * ValueRangeAnalysis.cpp - 区间 × 同余值域分析实现
+ *
+ * 区间端点用 INT64_MIN/INT64_MAX 表示无穷，端点运算溢出时取对应方向的无穷（只会放宽）。
+ * 有符号算术按“不溢出”处理（溢出是未定义行为），无符号算术与整型转换按回绕处理。
+ */
+#include "code_property_graph/ValueRangeAnalysis.h"
+#include "code_property_graph/CPGAnnotation.h"
+
+#include "clang/AST/ParentMapContext.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+#include "clang/Analysis/Analyses/PostOrderCFGView.h"
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+namespace cpg {
+
+namespace {
+
+constexpr int64_t kNegInf = ValueRange::kNegInf;
+constexpr int64_t kPosInf = ValueRange::kPosInf;
+
+constexpr int kWideningDelay = 2;           // 循环头先精确合并的次数，之后加宽
+constexpr int kNarrowingPasses = 2;
+constexpr size_t kMaxVisitsPerBlock = 32;   // 平均每块访问次数上限，超出视为不收敛
+constexpr int kMaxParentDepth = 256;
+
+using Int128 = __int128;
+
+// 128 位结果落在 int64 的有限部分（不含表示无穷的两端）时写入 out
+bool FitsBound(Int128 value, int64_t& out)
+{
+    if (value <= static_cast<Int128>(kNegInf) || value >= static_cast<Int128>(kPosInf)) {
+        return false;
+    }
+    out = static_cast<int64_t>(value);
+    return true;
+}
+
+// 下界/上界的加法：无穷参与或溢出时取该端的无穷
+int64_t AddBound(int64_t a, int64_t b, bool lower)
+{
+    int64_t inf = lower ? kNegInf : kPosInf;
+    if (a == inf || b == inf) return inf;
+    int64_t result;
+    return FitsBound(static_cast<Int128>(a) + b, result) ? result : inf;
+}
+
+bool IsInfinite(int64_t value)
+{
+    return value == kNegInf || value == kPosInf;
+}
+
+// 区间角点的乘积，符号由两个因子决定
+int64_t MulBound(int64_t a, int64_t b)
+{
+    if (a == 0 || b == 0) return 0;
+    bool negative = (a < 0) != (b < 0);
+    int64_t result;
+    if (IsInfinite(a) || IsInfinite(b) || !FitsBound(static_cast<Int128>(a) * b, result)) {
+        return negative ? kNegInf : kPosInf;
+    }
+    return result;
+}
+
+// 区间角点的截断除法（b != 0）；除数为无穷时商取 0，另一个角点给出无穷端
+int64_t DivBound(int64_t a, int64_t b)
+{
+    if (IsInfinite(b)) return 0;
+    if (IsInfinite(a)) return (a < 0) != (b < 0) ? kNegInf : kPosInf;
+    return a / b;
+}
+
+// 向下取到 step 的倍数（step > 0）
+int64_t FloorTo(int64_t value, int64_t step)
+{
+    if (IsInfinite(value)) return value;
+    int64_t quotient = value / step;
+    if (value % step != 0 && value < 0) quotient--;
+    int64_t result;
+    return FitsBound(static_cast<Int128>(quotient) * step, result) ? result : kNegInf;
+}
+
+// 不小于 value 的最小 2^k - 1（value >= 0）
+int64_t BitMask(int64_t value)
+{
+    if (value == kPosInf || value >= (int64_t(1) << 62)) return kPosInf;
+    int64_t mask = 0;
+    while (mask < value) mask = (mask << 1) | 1;
+    return mask;
+}
+
+uint64_t Gcd(uint64_t a, uint64_t b)
+{
+    return std::gcd(a, b);
+}
+
+int64_t Mod(Int128 value, uint64_t modulus)
+{
+    Int128 m = static_cast<Int128>(modulus);
+    Int128 r = value % m;
+    if (r < 0) r += m;
+    return static_cast<int64_t>(r);
+}
+
+uint64_t Abs(int64_t value)
+{
+    return value < 0 ? static_cast<uint64_t>(-(value + 1)) + 1 : static_cast<uint64_t>(value);
+}
+
+// 已知为 0 的低位个数
+unsigned TrailingZeros(const ValueRange& value)
+{
+    if (value.empty) return 64;
+    if (value.modulus == 0) {
+        return value.residue == 0 ? 64 : __builtin_ctzll(static_cast<uint64_t>(value.residue));
+    }
+    if (value.modulus == 1) return 0;
+    return __builtin_ctzll(Gcd(value.modulus, static_cast<uint64_t>(value.residue)));
+}
+
+// 同余类 x ≡ residue (mod modulus)，区间不限
+ValueRange Congruent(uint64_t modulus, int64_t residue)
+{
+    ValueRange result;
+    result.modulus = modulus;
+    result.residue = residue;
+    result.Normalize();
+    return result;
+}
+
+ValueRange MultipleOfPowerOfTwo(unsigned bits)
+{
+    return bits > 0 && bits < 63 ? Congruent(uint64_t(1) << bits, 0) : ValueRange::Top();
+}
+
+std::string BoundText(int64_t value)
+{
+    if (value == kNegInf) return "-inf";
+    if (value == kPosInf) return "+inf";
+    return std::to_string(value);
+}
+
+bool EvaluateInt(const clang::Expr* expr, const clang::ASTContext& ctx, int64_t& value)
+{
+    if (!expr || expr->isValueDependent() || expr->isTypeDependent()) return false;
+    clang::Expr::EvalResult eval;
+    if (!expr->EvaluateAsInt(eval, ctx)) return false;
+    const llvm::APSInt& result = eval.Val.getInt();
+    if (result.isSigned() ? !result.isSignedIntN(64) : result.getActiveBits() > 63) return false;
+    value = result.getExtValue();
+    return !IsInfinite(value);
+}
+
+// 变量只经由读、赋值与自增自减使用时才跟踪（取地址/引用绑定/lambda 捕获都会让写入不可见）
+class TrackedVarScanner : public clang::RecursiveASTVisitor<TrackedVarScanner> {
+public:
+    std::map<const clang::VarDecl*, size_t> refs;
+    std::map<const clang::VarDecl*, size_t> plainUses;
+    std::set<const clang::VarDecl*> locals;
+    std::set<const clang::VarDecl*> escaped;
+
+    bool VisitDeclRefExpr(clang::DeclRefExpr* ref)
+    {
+        if (auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl())) {
+            refs[var]++;
+            if (ref->refersToEnclosingVariableOrCapture()) escaped.insert(var);
+        }
+        return true;
+    }
+
+    bool VisitImplicitCastExpr(clang::ImplicitCastExpr* cast)
+    {
+        if (cast->getCastKind() == clang::CK_LValueToRValue) {
+            CountPlain(cast->getSubExpr());
+        }
+        return true;
+    }
+
+    bool VisitBinaryOperator(clang::BinaryOperator* binOp)
+    {
+        if (binOp->isAssignmentOp()) CountPlain(binOp->getLHS());
+        return true;
+    }
+
+    bool VisitUnaryOperator(clang::UnaryOperator* unaryOp)
+    {
+        if (unaryOp->isIncrementDecrementOp()) CountPlain(unaryOp->getSubExpr());
+        return true;
+    }
+
+    bool VisitVarDecl(clang::VarDecl* var)
+    {
+        if (!llvm::isa<clang::ParmVarDecl>(var)) locals.insert(var);
+        return true;
+    }
+
+    // lambda 体属于另一个函数；按引用或按值捕获的变量都不再跟踪
+    bool TraverseLambdaExpr(clang::LambdaExpr* lambda)
+    {
+        for (const clang::LambdaCapture& capture : lambda->captures()) {
+            if (capture.capturesVariable()) {
+                if (auto* var = llvm::dyn_cast<clang::VarDecl>(capture.getCapturedVar())) {
+                    escaped.insert(var);
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    void CountPlain(const clang::Expr* expr)
+    {
+        if (auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(expr->IgnoreParens())) {
+            if (auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl())) {
+                plainUses[var]++;
+            }
+        }
+    }
+};
+
+} // namespace
+
+// ============================================
+// ValueRange
+// ============================================
+
+ValueRange ValueRange::Bottom()
+{
+    ValueRange result;
+    result.empty = true;
+    result.lo = 0;
+    result.hi = -1;
+    result.modulus = 1;
+    result.residue = 0;
+    return result;
+}
+
+ValueRange ValueRange::Constant(int64_t value)
+{
+    if (IsInfinite(value)) return Top();
+    ValueRange result;
+    result.lo = result.hi = result.residue = value;
+    result.modulus = 0;
+    return result;
+}
+
+ValueRange ValueRange::Interval(int64_t low, int64_t high)
+{
+    ValueRange result;
+    result.lo = low;
+    result.hi = high;
+    result.Normalize();
+    return result;
+}
+
+ValueRange ValueRange::OfType(clang::QualType type, const clang::ASTContext& ctx)
+{
+    if (type.isNull() || type->isDependentType() || !type->isIntegralOrEnumerationType()) {
+        return Top();
+    }
+    if (type->isBooleanType()) return Interval(0, 1);
+    if (const auto* enumType = type->getAs<clang::EnumType>()) {
+        if (!enumType->getDecl()->isComplete()) return Top();
+    }
+
+    uint64_t width = ctx.getIntWidth(type);
+    bool isSigned = type->isSignedIntegerOrEnumerationType();
+    if (width == 0) return Top();
+    if (isSigned) {
+        if (width >= 64) return Top();
+        int64_t half = int64_t(1) << (width - 1);
+        return Interval(-half, half - 1);
+    }
+    if (width >= 63) return Interval(0, kPosInf);
+    return Interval(0, (int64_t(1) << width) - 1);
+}
+
+void ValueRange::Normalize()
+{
+    if (empty || lo > hi) {
+        *this = Bottom();
+        return;
+    }
+    if (modulus == 0) {
+        if (residue < lo || residue > hi) {
+            *this = Bottom();
+            return;
+        }
+        lo = hi = residue;
+        return;
+    }
+    if (modulus > static_cast<uint64_t>(kPosInf)) {
+        modulus = 1;
+    }
+    if (modulus == 1) {
+        residue = 0;
+    } else {
+        residue = Mod(residue, modulus);
+        Int128 m = static_cast<Int128>(modulus);
+        int64_t bound;
+        if (lo != kNegInf && FitsBound(lo + (m - Mod(static_cast<Int128>(lo) - residue, modulus)) % m,
+                                       bound)) {
+            lo = bound;
+        }
+        if (hi != kPosInf && FitsBound(static_cast<Int128>(hi) - Mod(static_cast<Int128>(hi) - residue, modulus), bound)) {
+            hi = bound;
+        }
+        if (lo > hi) {
+            *this = Bottom();
+            return;
+        }
+    }
+    if (lo == hi && !IsInfinite(lo)) {
+        modulus = 0;
+        residue = lo;
+    }
+}
+
+bool ValueRange::operator==(const ValueRange& other) const
+{
+    if (empty || other.empty) return empty == other.empty;
+    return lo == other.lo && hi == other.hi && modulus == other.modulus && residue == other.residue;
+}
+
+bool ValueRange::Contains(const ValueRange& other) const
+{
+    if (other.empty) return true;
+    if (empty) return false;
+    if (other.lo < lo || other.hi > hi) return false;
+    if (modulus == 1) return true;
+    if (modulus == 0) return other.modulus == 0 && other.residue == residue;
+    if (other.modulus != 0 && other.modulus % modulus != 0) return false;
+    return Mod(static_cast<Int128>(other.residue) - residue, modulus) == 0;
+}
+
+uint64_t ValueRange::KnownMultiple() const
+{
+    if (empty) return 1;
+    if (modulus == 0) return Abs(residue);
+    if (modulus == 1) return 1;
+    return Gcd(modulus, static_cast<uint64_t>(residue));
+}
+
+ValueRange ValueRange::Join(const ValueRange& other) const
+{
+    if (empty) return other;
+    if (other.empty) return *this;
+
+    ValueRange result;
+    result.lo = std::min(lo, other.lo);
+    result.hi = std::max(hi, other.hi);
+    Int128 diff = static_cast<Int128>(residue) - other.residue;
+    uint64_t absDiff = static_cast<uint64_t>(diff < 0 ? -diff : diff);
+    result.modulus = Gcd(Gcd(modulus, other.modulus), absDiff);
+    result.residue = residue;
+    if (result.modulus == 0) result.lo = result.hi = residue;
+    result.Normalize();
+    return result;
+}
+
+ValueRange ValueRange::Meet(const ValueRange& other) const
+{
+    if (empty || other.empty) return Bottom();
+
+    ValueRange result;
+    result.lo = std::max(lo, other.lo);
+    result.hi = std::min(hi, other.hi);
+
+    // 同余部分：一方为常量时检查另一方是否接受；否则保留更细的一方（可能偏大，但不丢可行值）
+    auto admits = [](const ValueRange& range, int64_t value) {
+        return range.modulus == 0 ? range.residue == value :
+               range.modulus == 1 || Mod(static_cast<Int128>(value) - range.residue, range.modulus) == 0;
+    };
+    if (modulus == 0 || other.modulus == 0) {
+        const ValueRange& constant = modulus == 0 ? *this : other;
+        const ValueRange& rest = modulus == 0 ? other : *this;
+        if (!admits(rest, constant.residue)) return Bottom();
+        result.modulus = 0;
+        result.residue = constant.residue;
+    } else if (modulus == 1 || other.modulus == 1) {
+        result.modulus = std::max(modulus, other.modulus);
+        result.residue = modulus == 1 ? other.residue : residue;
+    } else {
+        const ValueRange& fine = modulus >= other.modulus ? *this : other;
+        const ValueRange& coarse = modulus >= other.modulus ? other : *this;
+        if (fine.modulus % coarse.modulus == 0 && !admits(coarse, fine.residue)) return Bottom();
+        result.modulus = fine.modulus;
+        result.residue = fine.residue;
+    }
+    result.Normalize();
+    return result;
+}
+
+ValueRange ValueRange::Widen(const ValueRange& next) const
+{
+    if (empty) return next;
+    if (next.empty) return *this;
+
+    ValueRange result = Join(next);
+    result.lo = next.lo < lo ? kNegInf : lo;
+    result.hi = next.hi > hi ? kPosInf : hi;
+    if (result.modulus == 0 && result.lo != result.hi) result.modulus = 1;
+    result.Normalize();
+    return result;
+}
+
+ValueRange ValueRange::Narrow(const ValueRange& next) const
+{
+    if (empty || next.empty) return next;
+
+    ValueRange result = *this;
+    if (lo == kNegInf) result.lo = next.lo;
+    if (hi == kPosInf) result.hi = next.hi;
+    if (result.modulus == 0 && result.lo != result.hi) result.modulus = 1;
+    result.Normalize();
+    ValueRange congruence = next;
+    congruence.lo = kNegInf;
+    congruence.hi = kPosInf;
+    if (congruence.modulus == 0) congruence = Top();
+    return result.Meet(congruence);
+}
+
+ValueRange ValueRange::Add(const ValueRange& other) const
+{
+    if (empty || other.empty) return Bottom();
+
+    ValueRange result;
+    result.lo = AddBound(lo, other.lo, true);
+    result.hi = AddBound(hi, other.hi, false);
+    result.modulus = Gcd(modulus, other.modulus);
+    Int128 sum = static_cast<Int128>(residue) + other.residue;
+    if (result.modulus == 0) {
+        int64_t value;
+        if (!FitsBound(sum, value)) {
+            result.modulus = 1;
+        } else {
+            result.residue = value;
+        }
+    } else {
+        result.residue = Mod(sum, result.modulus);
+    }
+    result.Normalize();
+    return result;
+}
+
+ValueRange ValueRange::Sub(const ValueRange& other) const
+{
+    return Add(other.Neg());
+}
+
+ValueRange ValueRange::Neg() const
+{
+    if (empty) return Bottom();
+
+    ValueRange result;
+    result.lo = hi == kPosInf ? kNegInf : -hi;
+    result.hi = lo == kNegInf ? kPosInf : -lo;
+    result.modulus = modulus;
+    result.residue = modulus == 0 ? -residue : (modulus == 1 ? 0 : Mod(-static_cast<Int128>(residue), modulus));
+    result.Normalize();
+    return result;
+}
+
+ValueRange ValueRange::Not() const
+{
+    return Neg().Add(Constant(-1));
+}
+
+ValueRange ValueRange::Mul(const ValueRange& other) const
+{
+    if (empty || other.empty) return Bottom();
+
+    int64_t corners[] = {MulBound(lo, other.lo), MulBound(lo, other.hi),
+                         MulBound(hi, other.lo), MulBound(hi, other.hi)};
+    ValueRange result;
+    result.lo = *std::min_element(std::begin(corners), std::end(corners));
+    result.hi = *std::max_element(std::begin(corners), std::end(corners));
+
+    // (a + i·m1)(b + j·m2) ≡ ab (mod gcd(m1·m2, m1·b, m2·a))
+    using UInt128 = unsigned __int128;
+    auto gcd128 = [](UInt128 a, UInt128 b) {
+        while (b != 0) {
+            UInt128 t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    };
+    UInt128 m = gcd128(gcd128(static_cast<UInt128>(modulus) * other.modulus,
+                              static_cast<UInt128>(modulus) * Abs(other.residue)),
+                       static_cast<UInt128>(other.modulus) * Abs(residue));
+    Int128 product = static_cast<Int128>(residue) * other.residue;
+    if (m == 0) {
+        int64_t value;
+        if (FitsBound(product, value)) {
+            result.modulus = 0;
+            result.residue = value;
+        } else {
+            result.modulus = 1;
+        }
+    } else if (m > static_cast<UInt128>(kPosInf)) {
+        result.modulus = 1;
+    } else {
+        result.modulus = static_cast<uint64_t>(m);
+        result.residue = Mod(product, result.modulus);
+    }
+    result.Normalize();
+    return result;
+}
+
+ValueRange ValueRange::Div(const ValueRange& other) const
+{
+    if (empty || other.empty) return Bottom();
+
+    // 除数按正负两部分分别取角点（除以 0 是未定义行为，不计入）
+    ValueRange result = Bottom();
+    for (const ValueRange& part : {other.Meet(Interval(1, kPosInf)), other.Meet(Interval(kNegInf, -1))}) {
+        if (part.empty) continue;
+        int64_t corners[] = {DivBound(lo, part.lo), DivBound(lo, part.hi),
+                             DivBound(hi, part.lo), DivBound(hi, part.hi)};
+        result = result.Join(Interval(*std::min_element(std::begin(corners), std::end(corners)),
+                                      *std::max_element(std::begin(corners), std::end(corners))));
+    }
+    if (result.empty) return Top();
+
+    // x ≡ r (mod m)、x >= 0、c | m 时 x / c ≡ r / c (mod m / c)
+    if (other.IsConstant() && other.residue > 0 && lo >= 0 && modulus > 1 &&
+        modulus % static_cast<uint64_t>(other.residue) == 0) {
+        uint64_t c = static_cast<uint64_t>(other.residue);
+        result = result.Meet(Congruent(modulus / c, residue / other.residue));
+    }
+    return result;
+}
+
+ValueRange ValueRange::Rem(const ValueRange& other) const
+{
+    if (empty || other.empty) return Bottom();
+    if (IsConstant() && other.IsConstant()) {
+        if (other.residue == 0) return Top();
+        return Constant(residue % other.residue);
+    }
+    if (other.IsConstant() && other.residue > 0 && lo >= 0 && modulus > 1 &&
+        modulus % static_cast<uint64_t>(other.residue) == 0) {
+        return Constant(residue % other.residue);
+    }
+
+    // |x % y| < |y| 且 |x % y| <= |x|，符号与被除数相同
+    int64_t bound = kPosInf;
+    if (other.HasLower() && other.HasUpper()) {
+        uint64_t maxAbs = std::max(Abs(other.lo), Abs(other.hi));
+        if (maxAbs == 0) return Top();
+        bound = static_cast<int64_t>(std::min<uint64_t>(maxAbs - 1, static_cast<uint64_t>(kPosInf) - 1));
+    }
+    if (lo >= 0) return Interval(0, std::min(hi, bound));
+    if (HasUpper() && hi <= 0) return Interval(std::max(lo, bound == kPosInf ? kNegInf : -bound), 0);
+    return bound == kPosInf ? Top() : Interval(-bound, bound);
+}
+
+ValueRange ValueRange::Shl(const ValueRange& other) const
+{
+    if (empty || other.empty) return Bottom();
+    if (other.IsConstant() && other.residue >= 0 && other.residue < 63) {
+        return Mul(Constant(int64_t(1) << other.residue));
+    }
+    if (other.lo >= 0 && other.HasUpper() && other.hi < 63) {
+        return Mul(Interval(int64_t(1) << other.lo, int64_t(1) << other.hi));
+    }
+    return Top();
+}
+
+ValueRange ValueRange::Shr(const ValueRange& other) const
+{
+    if (empty || other.empty) return Bottom();
+    if (other.IsConstant() && other.residue >= 0 && other.residue < 64) {
+        int64_t shift = other.residue;
+        ValueRange result;
+        result.lo = lo == kNegInf ? kNegInf : (lo >> shift);
+        result.hi = hi == kPosInf ? kPosInf : (hi >> shift);
+        // x = q·m + r 且 2^k | m 时 x >> k = q·(m >> k) + (r >> k)
+        if (modulus > 1 && shift < 63 && modulus % (uint64_t(1) << shift) == 0) {
+            result.modulus = modulus >> shift;
+            result.residue = residue >> shift;
+        }
+        result.Normalize();
+        return result;
+    }
+    if (lo >= 0 && other.lo >= 0) {
+        int64_t maxShift = other.HasUpper() ? std::min<int64_t>(other.hi, 63) : 63;
+        return Interval(lo >> maxShift, hi == kPosInf ? kPosInf : (hi >> std::min<int64_t>(other.lo, 63)));
+    }
+    return Top();
+}
+
+ValueRange ValueRange::And(const ValueRange& other) const
+{
+    if (empty || other.empty) return Bottom();
+    if (IsConstant() && other.IsConstant()) return Constant(residue & other.residue);
+
+    ValueRange result = Top();
+    const ValueRange* mask = other.IsConstant() ? &other : (IsConstant() ? this : nullptr);
+    if (mask) {
+        const ValueRange& value = mask == &other ? *this : other;
+        int64_t c = mask->residue;
+        if (c >= 0) {
+            // 低位掩码 2^k - 1：x ≡ r (mod 2^k·j) 时结果就是 r 的低 k 位
+            if (c < kPosInf && ((c + 1) & c) == 0 && value.modulus > 1 &&
+                value.modulus % (static_cast<uint64_t>(c) + 1) == 0) {
+                return Constant(value.residue & c);
+            }
+            result = Interval(0, value.lo >= 0 ? std::min(c, value.hi) : c);
+        } else if (((-c) & (-c - 1)) == 0) {
+            // ~(2^k - 1)：向下取到 2^k 的倍数
+            result = Interval(FloorTo(value.lo, -c), FloorTo(value.hi, -c));
+        } else if (value.lo >= 0) {
+            result = Interval(0, value.hi);
+        }
+    } else if (lo >= 0 || other.lo >= 0) {
+        int64_t high = kPosInf;
+        if (lo >= 0) high = std::min(high, hi);
+        if (other.lo >= 0) high = std::min(high, other.hi);
+        result = Interval(0, high);
+    }
+    return result.Meet(MultipleOfPowerOfTwo(std::max(TrailingZeros(*this), TrailingZeros(other))));
+}
+
+ValueRange ValueRange::Or(const ValueRange& other) const
+{
+    if (empty || other.empty) return Bottom();
+    if (IsConstant() && other.IsConstant()) return Constant(residue | other.residue);
+
+    ValueRange result = Top();
+    if (lo >= 0 && other.lo >= 0) {
+        result = Interval(std::max(lo, other.lo), BitMask(std::max(hi, other.hi)));
+    }
+    return result.Meet(MultipleOfPowerOfTwo(std::min(TrailingZeros(*this), TrailingZeros(other))));
+}
+
+ValueRange ValueRange::Xor(const ValueRange& other) const
+{
+    if (empty || other.empty) return Bottom();
+    if (IsConstant() && other.IsConstant()) return Constant(residue ^ other.residue);
+
+    ValueRange result = Top();
+    if (lo >= 0 && other.lo >= 0) {
+        result = Interval(0, BitMask(std::max(hi, other.hi)));
+    }
+    return result.Meet(MultipleOfPowerOfTwo(std::min(TrailingZeros(*this), TrailingZeros(other))));
+}
+
+ValueRange ValueRange::CastTo(clang::QualType type, const clang::ASTContext& ctx, bool wraps) const
+{
+    if (empty) return *this;
+    if (type.isNull() || type->isDependentType() || !type->isIntegralOrEnumerationType()) return Top();
+    if (type->isBooleanType()) {
+        if (!Contains(Constant(0))) return Constant(1);
+        return IsConstant() ? Constant(0) : Interval(0, 1);
+    }
+
+    ValueRange limits = OfType(type, ctx);
+    if (limits.Contains(*this)) return *this;
+    if (!wraps) {
+        ValueRange clamped = Meet(limits);
+        return clamped.empty ? limits : clamped;
+    }
+
+    uint64_t width = ctx.getIntWidth(type);
+    if (IsConstant() && width < 64) {
+        uint64_t bits = static_cast<uint64_t>(residue) & ((uint64_t(1) << width) - 1);
+        if (type->isSignedIntegerOrEnumerationType() && ((bits >> (width - 1)) & 1)) {
+            return Constant(static_cast<int64_t>(bits) - (int64_t(1) << width));
+        }
+        return Constant(static_cast<int64_t>(bits));
+    }
+
+    // 回绕只改变 2^width 的倍数，保留 2 的幂次同余
+    if (modulus > 1) {
+        unsigned bits = std::min<unsigned>(__builtin_ctzll(modulus), static_cast<unsigned>(width));
+        if (bits > 0 && bits < 63) {
+            return limits.Meet(Congruent(uint64_t(1) << bits, residue));
+        }
+    }
+    return limits;
+}
+
+std::string ValueRange::ToString() const
+{
+    if (empty) return "empty";
+    if (IsConstant()) return "{" + std::to_string(residue) + "}";
+
+    std::ostringstream oss;
+    oss << (lo == kNegInf ? "(" : "[") << BoundText(lo) << ", " << BoundText(hi)
+        << (hi == kPosInf ? ")" : "]");
+    if (modulus > 1) {
+        oss << " mod " << modulus << " = " << residue;
+    }
+    return oss.str();
+}
+
+ValueRange LoopTripCount(const ValueRange& start, const ValueRange& bound, int64_t step,
+                         const std::string& compareOp)
+{
+    ValueRange unknown = ValueRange::Interval(0, kPosInf);
+    if (start.empty || bound.empty) return ValueRange::Constant(0);
+    if (step == 0 || step == kNegInf) return unknown;
+
+    // 距离：还需走过的值的个数
+    ValueRange distance;
+    if (step > 0 && (compareOp == "<" || compareOp == "<=" || (compareOp == "!=" && step == 1))) {
+        distance = bound.Sub(start);
+        if (compareOp == "<=") distance = distance.Add(ValueRange::Constant(1));
+    } else if (step < 0 && (compareOp == ">" || compareOp == ">=" || (compareOp == "!=" && step == -1))) {
+        distance = start.Sub(bound);
+        if (compareOp == ">=") distance = distance.Add(ValueRange::Constant(1));
+    } else {
+        return unknown;
+    }
+
+    int64_t absStep = step < 0 ? -step : step;
+    ValueRange positive = distance.Meet(ValueRange::Interval(1, kPosInf));
+    ValueRange trips = ValueRange::Constant(0);
+    if (!positive.empty) {
+        trips = absStep == 1 ? positive :
+            positive.Add(ValueRange::Constant(absStep - 1)).Div(ValueRange::Constant(absStep));
+        // 距离可能不为正时循环一次也不执行
+        if (!distance.Meet(ValueRange::Interval(kNegInf, 0)).empty) {
+            trips = trips.Join(ValueRange::Constant(0));
+        }
+    }
+    return trips;
+}
+
+// ============================================
+// ValueRangeAnalysis：函数定位与缓存
+// ============================================
+
+ValueRangeAnalysis::ValueRangeAnalysis(clang::ASTContext& ctx, const CPGContext* cpgCtx)
+    : astContext(ctx), cpgContext(cpgCtx)
+{}
+
+ValueRangeAnalysis::~ValueRangeAnalysis() = default;
+
+void ValueRangeAnalysis::Release(const clang::FunctionDecl* func)
+{
+    if (func) results.erase(func->getCanonicalDecl());
+}
+
+const clang::FunctionDecl* ValueRangeAnalysis::ContainingFunction(const clang::Stmt* stmt) const
+{
+    auto parents = astContext.getParents(*stmt);
+    for (int depth = 0; depth < kMaxParentDepth && !parents.empty(); ++depth) {
+        clang::DynTypedNode parent = parents[0];
+        if (const auto* func = parent.get<clang::FunctionDecl>()) return func;
+        if (const auto* lambda = parent.get<clang::LambdaExpr>()) return lambda->getCallOperator();
+        parents = astContext.getParents(parent);
+    }
+    return nullptr;
+}
+
+ValueRangeAnalysis::FunctionResult* ValueRangeAnalysis::ResultFor(const clang::Stmt* stmt)
+{
+    if (!stmt) return nullptr;
+    const clang::FunctionDecl* func = ContainingFunction(stmt);
+    if (!func || !func->hasBody()) return nullptr;
+
+    const clang::FunctionDecl* key = func->getCanonicalDecl();
+    auto it = results.find(key);
+    if (it == results.end()) {
+        auto result = std::make_unique<FunctionResult>();
+        FunctionResult* saved = current;
+        current = result.get();
+        Analyze(func, *result);
+        current = saved;
+        it = results.emplace(key, std::move(result)).first;
+    }
+    return it->second.get();
+}
+
+const clang::Stmt* ValueRangeAnalysis::EnclosingElement(const clang::Stmt* stmt) const
+{
+    if (current->elements.count(stmt)) return stmt;
+    auto parents = astContext.getParents(*stmt);
+    for (int depth = 0; depth < kMaxParentDepth && !parents.empty(); ++depth) {
+        clang::DynTypedNode parent = parents[0];
+        if (const auto* parentStmt = parent.get<clang::Stmt>()) {
+            if (current->elements.count(parentStmt)) return parentStmt;
+        } else if (!parent.get<clang::VarDecl>()) {
+            // 变量初始化表达式的父节点是 VarDecl，继续向上找 DeclStmt；其他声明即函数边界
+            return nullptr;
+        }
+        parents = astContext.getParents(parent);
+    }
+    return nullptr;
+}
+
+void ValueRangeAnalysis::CollectTracked(const clang::FunctionDecl* func, FunctionResult& result) const
+{
+    TrackedVarScanner scanner;
+    scanner.TraverseStmt(const_cast<clang::Stmt*>(func->getBody()));
+
+    auto consider = [&](const clang::VarDecl* var) {
+        clang::QualType type = var->getType();
+        if (!var->hasLocalStorage() || type->isReferenceType() || type.isVolatileQualified() ||
+            !type->isIntegralOrEnumerationType() || scanner.escaped.count(var)) {
+            return;
+        }
+        auto refIt = scanner.refs.find(var);
+        auto useIt = scanner.plainUses.find(var);
+        size_t refCount = refIt == scanner.refs.end() ? 0 : refIt->second;
+        size_t useCount = useIt == scanner.plainUses.end() ? 0 : useIt->second;
+        if (refCount == useCount) result.tracked.insert(var);
+    };
+    for (const clang::ParmVarDecl* param : func->parameters()) {
+        consider(param);
+    }
+    for (const clang::VarDecl* local : scanner.locals) {
+        consider(local);
+    }
+}
+
+// ============================================
+// 不动点迭代（沿用 CPGContext 到达定值的逆后序遍历，工作表按逆后序编号出队）
+// ============================================
+
+void ValueRangeAnalysis::Analyze(const clang::FunctionDecl* func, FunctionResult& result)
+{
+    const clang::Stmt* body = func->getBody();
+    if (!body || func->isDependentContext()) return;
+
+    CollectTracked(func, result);
+
+    const clang::CFG* cfg = cpgContext ? cpgContext->GetCFG(func) : nullptr;
+    std::unique_ptr<clang::CFG> owned;
+    if (!cfg) {
+        clang::CFG::BuildOptions options;
+        owned = clang::CFG::buildCFG(func, const_cast<clang::Stmt*>(body), &astContext, options);
+        cfg = owned.get();
+    }
+    if (!cfg) return;
+
+    for (const clang::CFGBlock* block : *cfg) {
+        for (const clang::CFGElement& elem : *block) {
+            if (auto stmt = elem.getAs<clang::CFGStmt>()) {
+                result.elements.insert(stmt->getStmt());
+            }
+        }
+    }
+
+    clang::PostOrderCFGView rpo(cfg);
+    std::vector<const clang::CFGBlock*> blocks;
+    std::map<const clang::CFGBlock*, unsigned> order;
+    for (const clang::CFGBlock* block : rpo) {
+        if (!block) continue;
+        order[block] = static_cast<unsigned>(blocks.size());
+        blocks.push_back(block);
+    }
+
+    // 循环头：存在逆后序中不靠前的前驱（回边）
+    std::set<const clang::CFGBlock*> loopHeads;
+    for (const clang::CFGBlock* block : blocks) {
+        for (const auto& pred : block->preds()) {
+            const clang::CFGBlock* predBlock = pred.getReachableBlock();
+            auto it = predBlock ? order.find(predBlock) : order.end();
+            if (it != order.end() && it->second >= order[block]) {
+                loopHeads.insert(block);
+            }
+        }
+    }
+
+    std::map<const clang::CFGBlock*, State> in;
+    std::map<const clang::CFGBlock*, std::vector<State>> out;
+    std::map<const clang::CFGBlock*, int> visits;
+
+    auto computeIn = [&](const clang::CFGBlock* block) {
+        State state;
+        if (block == &cfg->getEntry()) {
+            state.reachable = true;
+            return state;
+        }
+        for (const auto& pred : block->preds()) {
+            const clang::CFGBlock* predBlock = pred.getReachableBlock();
+            auto outIt = predBlock ? out.find(predBlock) : out.end();
+            if (outIt == out.end()) continue;
+            unsigned index = 0;
+            for (const auto& succ : predBlock->succs()) {
+                if (succ.getReachableBlock() == block && index < outIt->second.size()) {
+                    state = JoinStates(state, outIt->second[index]);
+                }
+                index++;
+            }
+        }
+        return state;
+    };
+
+    auto process = [&](const clang::CFGBlock* block, bool record) {
+        State state = in[block];
+        for (const clang::CFGElement& elem : *block) {
+            auto stmt = elem.getAs<clang::CFGStmt>();
+            if (!stmt) continue;
+            if (record) result.before[stmt->getStmt()] = state;
+            if (state.reachable) Transfer(stmt->getStmt(), state);
+        }
+        std::vector<State> edges(block->succ_size());
+        unsigned index = 0;
+        for (const auto& succ : block->succs()) {
+            const clang::CFGBlock* succBlock = succ.getReachableBlock();
+            if (succBlock && state.reachable) {
+                State edge = state;
+                if (RefineEdge(block, index, succBlock, edge)) {
+                    edges[index] = std::move(edge);
+                }
+            }
+            index++;
+        }
+        bool changed = out.find(block) == out.end() || out[block] != edges;
+        out[block] = std::move(edges);
+        return changed;
+    };
+
+    // 1. 上升阶段：循环头合并若干次后加宽
+    std::set<unsigned> worklist = {order[&cfg->getEntry()]};
+    size_t budget = kMaxVisitsPerBlock * blocks.size() + 16;
+    while (!worklist.empty()) {
+        if (budget-- == 0) return;
+        const clang::CFGBlock* block = blocks[*worklist.begin()];
+        worklist.erase(worklist.begin());
+
+        State next = computeIn(block);
+        bool seen = visits.count(block) > 0;
+        if (seen && loopHeads.count(block) && ++visits[block] > kWideningDelay) {
+            next = WidenStates(in[block], next);
+        } else if (!seen) {
+            visits[block] = 1;
+        }
+        if (seen && next == in[block]) continue;
+        in[block] = std::move(next);
+
+        if (process(block, false)) {
+            for (const auto& succ : block->succs()) {
+                const clang::CFGBlock* succBlock = succ.getReachableBlock();
+                auto it = succBlock ? order.find(succBlock) : order.end();
+                if (it != order.end()) worklist.insert(it->second);
+            }
+        }
+    }
+
+    // 2. 收窄阶段：按逆后序重算，循环头只收回加宽产生的无穷端
+    for (int pass = 0; pass < kNarrowingPasses; ++pass) {
+        for (const clang::CFGBlock* block : blocks) {
+            State next = computeIn(block);
+            in[block] = loopHeads.count(block) ? NarrowStates(in[block], next) : next;
+            process(block, false);
+        }
+    }
+
+    // 3. 记录元素状态与循环进入/循环头状态（收窄后不可达的块不保留旧取值）
+    result.values.clear();
+    for (const clang::CFGBlock* block : blocks) {
+        process(block, true);
+
+        const clang::Stmt* loop = block->getTerminatorStmt();
+        if (!loop || !(llvm::isa<clang::ForStmt>(loop) || llvm::isa<clang::WhileStmt>(loop) ||
+                       llvm::isa<clang::DoStmt>(loop))) {
+            continue;
+        }
+        result.loopHead[loop] = in[block];
+        if (llvm::isa<clang::DoStmt>(loop)) continue;   // 条件块的前驱都在循环体内
+
+        State entry;
+        for (const auto& pred : block->preds()) {
+            const clang::CFGBlock* predBlock = pred.getReachableBlock();
+            auto it = predBlock ? order.find(predBlock) : order.end();
+            if (it == order.end() || it->second >= order[block]) continue;
+            unsigned index = 0;
+            for (const auto& succ : predBlock->succs()) {
+                if (succ.getReachableBlock() == block && index < out[predBlock].size()) {
+                    entry = JoinStates(entry, out[predBlock][index]);
+                }
+                index++;
+            }
+        }
+        result.loopEntry[loop] = entry;
+    }
+    result.converged = true;
+}
+
+// ============================================
+// 状态格运算
+// ============================================
+
+ValueRangeAnalysis::State ValueRangeAnalysis::JoinStates(const State& a, const State& b) const
+{
+    if (!a.reachable) return b;
+    if (!b.reachable) return a;
+
+    State result;
+    result.reachable = true;
+    for (const auto& [var, range] : a.vars) {
+        auto it = b.vars.find(var);
+        if (it == b.vars.end()) continue;
+        ValueRange joined = range.Join(it->second);
+        if (joined != ValueRange::OfType(var->getType(), astContext)) {
+            result.vars[var] = joined;
+        }
+    }
+    return result;
+}
+
+ValueRangeAnalysis::State ValueRangeAnalysis::WidenStates(const State& older, const State& newer) const
+{
+    if (!older.reachable) return newer;
+    if (!newer.reachable) return older;
+
+    State result;
+    result.reachable = true;
+    for (const auto& [var, range] : older.vars) {
+        auto it = newer.vars.find(var);
+        if (it == newer.vars.end()) continue;
+        // 加宽到无穷后再收回到类型范围内
+        ValueRange limits = ValueRange::OfType(var->getType(), astContext);
+        ValueRange widened = range.Widen(it->second).Meet(limits);
+        if (!widened.empty && widened != limits) {
+            result.vars[var] = widened;
+        }
+    }
+    return result;
+}
+
+ValueRangeAnalysis::State ValueRangeAnalysis::NarrowStates(const State& older, const State& newer) const
+{
+    if (!older.reachable || !newer.reachable) return newer;
+
+    State result;
+    result.reachable = true;
+    for (const auto& [var, range] : newer.vars) {
+        // 旧值取到类型边界的一端视为加宽结果，可以收窄
+        ValueRange limits = ValueRange::OfType(var->getType(), astContext);
+        auto it = older.vars.find(var);
+        ValueRange previous = it == older.vars.end() ? limits : it->second;
+        if (previous.lo <= limits.lo) previous.lo = kNegInf;
+        if (previous.hi >= limits.hi) previous.hi = kPosInf;
+        if (previous.modulus == 0 && previous.lo != previous.hi) previous.modulus = 1;
+        ValueRange narrowed = previous.Narrow(range).Meet(limits);
+        if (narrowed.empty) narrowed = range;
+        if (narrowed != limits) {
+            result.vars[var] = narrowed;
+        }
+    }
+    return result;
+}
+
+// ============================================
+// 转移函数
+// ============================================
+
+const clang::VarDecl* ValueRangeAnalysis::TrackedVar(const clang::Expr* expr) const
+{
+    const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(expr->IgnoreParens());
+    const auto* var = ref ? llvm::dyn_cast<clang::VarDecl>(ref->getDecl()) : nullptr;
+    return var && current->tracked.count(var) ? var : nullptr;
+}
+
+ValueRange ValueRangeAnalysis::ReadVar(const clang::VarDecl* var, const State& state) const
+{
+    auto it = state.vars.find(var);
+    return it != state.vars.end() ? it->second : ValueRange::OfType(var->getType(), astContext);
+}
+
+void ValueRangeAnalysis::WriteVar(const clang::VarDecl* var, const ValueRange& value, State& state) const
+{
+    ValueRange limits = ValueRange::OfType(var->getType(), astContext);
+    ValueRange stored = value.Meet(limits);
+    if (stored.empty) {
+        // 写入不可能的值：所在路径不可达
+        state.reachable = false;
+        state.vars.clear();
+        return;
+    }
+    if (stored == limits) {
+        state.vars.erase(var);
+    } else {
+        state.vars[var] = stored;
+    }
+}
+
+void ValueRangeAnalysis::Transfer(const clang::Stmt* element, State& state)
+{
+    const clang::Stmt* saved = currentElement;
+    currentElement = element;
+
+    if (const auto* expr = llvm::dyn_cast<clang::Expr>(element)) {
+        current->values[expr] = Eval(expr, state);
+    } else if (const auto* declStmt = llvm::dyn_cast<clang::DeclStmt>(element)) {
+        for (const clang::Decl* decl : declStmt->decls()) {
+            const auto* var = llvm::dyn_cast<clang::VarDecl>(decl);
+            if (!var) continue;
+            ValueRange value = ValueRange::OfType(var->getType(), astContext);
+            if (const clang::Expr* init = var->getInit()) {
+                value = Eval(init, state).CastTo(var->getType(), astContext);
+            }
+            if (current->tracked.count(var)) {
+                WriteVar(var, value, state);
+            }
+        }
+    } else {
+        EvalChildren(element, state);
+    }
+
+    currentElement = saved;
+}
+
+void ValueRangeAnalysis::EvalChildren(const clang::Stmt* stmt, State& state)
+{
+    for (const clang::Stmt* child : stmt->children()) {
+        if (const auto* expr = llvm::dyn_cast_or_null<clang::Expr>(child)) {
+            Eval(expr, state);
+        }
+    }
+}
+
+ValueRange ValueRangeAnalysis::Eval(const clang::Expr* expr, State& state)
+{
+    if (!expr) return ValueRange::Top();
+    clang::QualType type = expr->getType();
+
+    // 已在 CFG 中单独求值过的子表达式直接取其结果（副作用已经作用在状态上）
+    if (expr != currentElement && current->elements.count(expr)) {
+        auto it = current->values.find(expr);
+        return it != current->values.end() ? it->second : ValueRange::OfType(type, astContext);
+    }
+    if (expr->isTypeDependent() || expr->isValueDependent()) return ValueRange::Top();
+
+    if (const auto* paren = llvm::dyn_cast<clang::ParenExpr>(expr)) {
+        return Eval(paren->getSubExpr(), state);
+    }
+    if (const auto* full = llvm::dyn_cast<clang::FullExpr>(expr)) {
+        return Eval(full->getSubExpr(), state);
+    }
+    if (llvm::isa<clang::IntegerLiteral>(expr) || llvm::isa<clang::CharacterLiteral>(expr) ||
+        llvm::isa<clang::UnaryExprOrTypeTraitExpr>(expr) || llvm::isa<clang::CXXBoolLiteralExpr>(expr)) {
+        int64_t value;
+        return EvaluateInt(expr, astContext, value) ? ValueRange::Constant(value) :
+                                                      ValueRange::OfType(type, astContext);
+    }
+    if (const auto* ref = llvm::dyn_cast<clang::DeclRefExpr>(expr)) {
+        if (const auto* enumConst = llvm::dyn_cast<clang::EnumConstantDecl>(ref->getDecl())) {
+            const llvm::APSInt& value = enumConst->getInitVal();
+            if (value.isSigned() ? value.isSignedIntN(64) : value.getActiveBits() <= 63) {
+                return ValueRange::Constant(value.getExtValue());
+            }
+            return ValueRange::OfType(type, astContext);
+        }
+        const auto* var = llvm::dyn_cast<clang::VarDecl>(ref->getDecl());
+        if (!var) return ValueRange::OfType(type, astContext);
+        if (current->tracked.count(var)) return ReadVar(var, state);
+        int64_t value;
+        if (var->getType().isConstQualified() && !var->getType().isVolatileQualified() &&
+            EvaluateInt(expr, astContext, value)) {
+            return ValueRange::Constant(value);
+        }
+        return ValueRange::OfType(type, astContext);
+    }
+    if (const auto* cast = llvm::dyn_cast<clang::CastExpr>(expr)) {
+        return EvalCast(cast, state);
+    }
+    if (const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(expr)) {
+        return EvalBinary(binOp, state);
+    }
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(expr)) {
+        return EvalUnary(unaryOp, state);
+    }
+    if (const auto* cond = llvm::dyn_cast<clang::ConditionalOperator>(expr)) {
+        // CFG 已拆分的条件表达式：分支的副作用已在分支块中生效，这里只在合并后的状态上估值
+        bool split = current->elements.count(expr) > 0;
+        ValueRange condValue = split ? ValueRange::Interval(0, 1) : Eval(cond->getCond(), state);
+        State thenState = state;
+        State elseState = state;
+        bool thenFeasible = condValue != ValueRange::Constant(0);
+        bool elseFeasible = condValue.Contains(ValueRange::Constant(0));
+        thenFeasible = thenFeasible && Refine(cond->getCond(), true, thenState);
+        elseFeasible = elseFeasible && Refine(cond->getCond(), false, elseState);
+        auto evalBranch = [&](const clang::Expr* branch, State& branchState) {
+            if (!split) return Eval(branch, branchState);
+            if (branch->HasSideEffects(astContext) && !current->elements.count(branch)) {
+                return ValueRange::OfType(branch->getType(), astContext);
+            }
+            State copy = branchState;
+            return Eval(branch, copy);
+        };
+        ValueRange result = ValueRange::Bottom();
+        if (thenFeasible) result = result.Join(evalBranch(cond->getTrueExpr(), thenState));
+        if (elseFeasible) result = result.Join(evalBranch(cond->getFalseExpr(), elseState));
+        if (!split) {
+            state = JoinStates(thenFeasible ? thenState : State(), elseFeasible ? elseState : State());
+        }
+        return result.empty ? ValueRange::OfType(type, astContext) : result.CastTo(type, astContext);
+    }
+    if (llvm::isa<clang::LambdaExpr>(expr) || llvm::isa<clang::StmtExpr>(expr) ||
+        llvm::isa<clang::BlockExpr>(expr) || llvm::isa<clang::BinaryConditionalOperator>(expr)) {
+        return ValueRange::OfType(type, astContext);
+    }
+
+    EvalChildren(expr, state);
+    return ValueRange::OfType(type, astContext);
+}
+
+ValueRange ValueRangeAnalysis::EvalCast(const clang::CastExpr* cast, State& state)
+{
+    ValueRange value = Eval(cast->getSubExpr(), state);
+    clang::QualType type = cast->getType();
+    switch (cast->getCastKind()) {
+        case clang::CK_LValueToRValue:
+        case clang::CK_NoOp:
+            return type->isIntegralOrEnumerationType() ? value : ValueRange::Top();
+        case clang::CK_IntegralCast:
+        case clang::CK_IntegralToBoolean:
+            return value.CastTo(type, astContext);
+        case clang::CK_BooleanToSignedIntegral:
+            return value.CastTo(astContext.BoolTy, astContext).Neg();
+        default:
+            return ValueRange::OfType(type, astContext);
+    }
+}
+
+namespace {
+
+ValueRange ApplyArithmetic(clang::BinaryOperatorKind op, const ValueRange& lhs, const ValueRange& rhs)
+{
+    switch (op) {
+        case clang::BO_Add: return lhs.Add(rhs);
+        case clang::BO_Sub: return lhs.Sub(rhs);
+        case clang::BO_Mul: return lhs.Mul(rhs);
+        case clang::BO_Div: return lhs.Div(rhs);
+        case clang::BO_Rem: return lhs.Rem(rhs);
+        case clang::BO_Shl: return lhs.Shl(rhs);
+        case clang::BO_Shr: return lhs.Shr(rhs);
+        case clang::BO_And: return lhs.And(rhs);
+        case clang::BO_Or:  return lhs.Or(rhs);
+        case clang::BO_Xor: return lhs.Xor(rhs);
+        default:            return ValueRange::Top();
+    }
+}
+
+ValueRange Compare(clang::BinaryOperatorKind op, const ValueRange& lhs, const ValueRange& rhs)
+{
+    if (lhs.empty || rhs.empty) return ValueRange::Bottom();
+    ValueRange unknown = ValueRange::Interval(0, 1);
+    auto decide = [](bool isTrue, bool isFalse) {
+        return isTrue ? ValueRange::Constant(1) :
+               (isFalse ? ValueRange::Constant(0) : ValueRange::Interval(0, 1));
+    };
+    switch (op) {
+        case clang::BO_LT: return decide(lhs.hi < rhs.lo, lhs.lo >= rhs.hi);
+        case clang::BO_LE: return decide(lhs.hi <= rhs.lo, lhs.lo > rhs.hi);
+        case clang::BO_GT: return decide(lhs.lo > rhs.hi, lhs.hi <= rhs.lo);
+        case clang::BO_GE: return decide(lhs.lo >= rhs.hi, lhs.hi < rhs.lo);
+        case clang::BO_EQ:
+            return decide(lhs.IsConstant() && rhs.IsConstant() && lhs.residue == rhs.residue,
+                          lhs.Meet(rhs).empty);
+        case clang::BO_NE:
+            return decide(lhs.Meet(rhs).empty,
+                          lhs.IsConstant() && rhs.IsConstant() && lhs.residue == rhs.residue);
+        default:
+            return unknown;
+    }
+}
+
+// 有符号且不会整型提升的类型上，溢出是未定义行为，按不溢出处理
+bool WrapsOnOverflow(clang::QualType type, const clang::ASTContext& ctx)
+{
+    return !type->isSignedIntegerOrEnumerationType() || ctx.getIntWidth(type) < ctx.getIntWidth(ctx.IntTy);
+}
+
+} // namespace
+
+ValueRange ValueRangeAnalysis::EvalBinary(const clang::BinaryOperator* binOp, State& state)
+{
+    clang::BinaryOperatorKind op = binOp->getOpcode();
+    clang::QualType type = binOp->getType();
+    const clang::Expr* lhs = binOp->getLHS();
+    const clang::Expr* rhs = binOp->getRHS();
+
+    if (op == clang::BO_Comma) {
+        Eval(lhs, state);
+        return Eval(rhs, state);
+    }
+
+    if (op == clang::BO_LAnd || op == clang::BO_LOr) {
+        bool isAnd = op == clang::BO_LAnd;
+        bool split = current->elements.count(binOp) > 0;
+        State scratch = state;
+        ValueRange left = Eval(lhs, split ? scratch : state);
+        // 左操作数已决定结果时右操作数不求值
+        if (isAnd ? left == ValueRange::Constant(0) : !left.Contains(ValueRange::Constant(0))) {
+            return ValueRange::Constant(isAnd ? 0 : 1);
+        }
+        State rhsState = split ? scratch : state;
+        if (!Refine(lhs, isAnd, rhsState)) return ValueRange::Constant(isAnd ? 0 : 1);
+        ValueRange right = Eval(rhs, rhsState);
+        if (!split) state = JoinStates(state, rhsState);
+        bool rightFalse = right == ValueRange::Constant(0);
+        bool rightTrue = !right.Contains(ValueRange::Constant(0));
+        if (isAnd && rightFalse) return ValueRange::Constant(0);
+        if (!isAnd && rightTrue) return ValueRange::Constant(1);
+        if (isAnd && rightTrue && !left.Contains(ValueRange::Constant(0))) return ValueRange::Constant(1);
+        if (!isAnd && rightFalse && left == ValueRange::Constant(0)) return ValueRange::Constant(0);
+        return ValueRange::Interval(0, 1);
+    }
+
+    if (binOp->isAssignmentOp()) {
+        ValueRange value = Eval(rhs, state);
+        const clang::VarDecl* var = TrackedVar(lhs);
+        if (!var) {
+            Eval(lhs, state);
+            return type->isIntegralOrEnumerationType() ? value.CastTo(type, astContext) : ValueRange::Top();
+        }
+        if (const auto* compound = llvm::dyn_cast<clang::CompoundAssignOperator>(binOp)) {
+            clang::QualType computation = compound->getComputationResultType();
+            ValueRange old = ReadVar(var, state).CastTo(compound->getComputationLHSType(), astContext);
+            value = ApplyArithmetic(clang::BinaryOperator::getOpForCompoundAssignment(op), old, value)
+                        .CastTo(computation, astContext, WrapsOnOverflow(computation, astContext));
+        }
+        value = value.CastTo(var->getType(), astContext);
+        WriteVar(var, value, state);
+        return value;
+    }
+
+    ValueRange left = Eval(lhs, state);
+    ValueRange right = Eval(rhs, state);
+    if (binOp->isComparisonOp()) {
+        if (!lhs->getType()->isIntegralOrEnumerationType() || !rhs->getType()->isIntegralOrEnumerationType()) {
+            return ValueRange::Interval(0, 1);
+        }
+        return Compare(op, left, right);
+    }
+    if (!type->isIntegralOrEnumerationType() || !lhs->getType()->isIntegralOrEnumerationType() ||
+        !rhs->getType()->isIntegralOrEnumerationType()) {
+        return ValueRange::OfType(type, astContext);
+    }
+    return ApplyArithmetic(op, left, right).CastTo(type, astContext, WrapsOnOverflow(type, astContext));
+}
+
+ValueRange ValueRangeAnalysis::EvalUnary(const clang::UnaryOperator* unaryOp, State& state)
+{
+    clang::QualType type = unaryOp->getType();
+    const clang::Expr* sub = unaryOp->getSubExpr();
+
+    switch (unaryOp->getOpcode()) {
+        case clang::UO_PreInc:
+        case clang::UO_PreDec:
+        case clang::UO_PostInc:
+        case clang::UO_PostDec: {
+            const clang::VarDecl* var = TrackedVar(sub);
+            if (!var) {
+                Eval(sub, state);
+                return ValueRange::OfType(type, astContext);
+            }
+            clang::QualType varType = var->getType();
+            ValueRange old = ReadVar(var, state);
+            ValueRange next = old.Add(ValueRange::Constant(unaryOp->isIncrementOp() ? 1 : -1))
+                                  .CastTo(varType, astContext, WrapsOnOverflow(varType, astContext));
+            WriteVar(var, next, state);
+            return unaryOp->isPrefix() ? next : old;
+        }
+        case clang::UO_Plus:
+        case clang::UO_Extension:
+            return Eval(sub, state);
+        case clang::UO_Minus:
+            return Eval(sub, state).Neg().CastTo(type, astContext, WrapsOnOverflow(type, astContext));
+        case clang::UO_Not:
+            return Eval(sub, state).Not().CastTo(type, astContext);
+        case clang::UO_LNot: {
+            ValueRange value = Eval(sub, state);
+            if (value == ValueRange::Constant(0)) return ValueRange::Constant(1);
+            if (!value.Contains(ValueRange::Constant(0))) return ValueRange::Constant(0);
+            return ValueRange::Interval(0, 1);
+        }
+        default:
+            Eval(sub, state);
+            return ValueRange::OfType(type, astContext);
+    }
+}
+
+// ============================================
+// 条件收紧
+// ============================================
+
+bool ValueRangeAnalysis::RefineEdge(const clang::CFGBlock* block, unsigned succIndex,
+                                    const clang::CFGBlock* succ, State& state)
+{
+    const clang::Stmt* term = block->getTerminatorStmt();
+    if (!term) return true;
+
+    const clang::Stmt* saved = currentElement;
+    currentElement = nullptr;
+    bool feasible = true;
+    if (const auto* switchStmt = llvm::dyn_cast<clang::SwitchStmt>(term)) {
+        // 进入 case 标签的边：条件等于标签值（GNU case 范围取区间）
+        const auto* caseStmt = llvm::dyn_cast_or_null<clang::CaseStmt>(succ->getLabel());
+        int64_t low;
+        int64_t high;
+        if (caseStmt && !switchStmt->getCond()->HasSideEffects(astContext) &&
+            EvaluateInt(caseStmt->getLHS(), astContext, low)) {
+            high = low;
+            if (!caseStmt->getRHS() || EvaluateInt(caseStmt->getRHS(), astContext, high)) {
+                feasible = RefineVar(switchStmt->getCond(), ValueRange::Interval(low, high), state);
+            }
+        }
+    } else if (block->succ_size() == 2 &&
+               (llvm::isa<clang::IfStmt>(term) || llvm::isa<clang::ForStmt>(term) ||
+                llvm::isa<clang::WhileStmt>(term) || llvm::isa<clang::DoStmt>(term) ||
+                llvm::isa<clang::ConditionalOperator>(term) || llvm::isa<clang::BinaryOperator>(term))) {
+        const auto* cond = llvm::dyn_cast_or_null<clang::Expr>(block->getTerminatorCondition());
+        feasible = Refine(cond, succIndex == 0, state);
+    }
+    currentElement = saved;
+    if (!feasible) {
+        state.reachable = false;
+        state.vars.clear();
+    }
+    return feasible;
+}
+
+bool ValueRangeAnalysis::Refine(const clang::Expr* cond, bool truth, State& state)
+{
+    if (!cond) return true;
+    cond = cond->IgnoreParens();
+    if (cond->HasSideEffects(astContext)) return true;
+
+    if (const auto* cast = llvm::dyn_cast<clang::ImplicitCastExpr>(cond)) {
+        if (cast->getCastKind() == clang::CK_IntegralToBoolean) {
+            cond = cast->getSubExpr()->IgnoreParens();
+        }
+    }
+    if (const auto* unaryOp = llvm::dyn_cast<clang::UnaryOperator>(cond)) {
+        if (unaryOp->getOpcode() == clang::UO_LNot) {
+            return Refine(unaryOp->getSubExpr(), !truth, state);
+        }
+    }
+    if (const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(cond)) {
+        clang::BinaryOperatorKind op = binOp->getOpcode();
+        if (op == clang::BO_LAnd) {
+            return !truth || (Refine(binOp->getLHS(), true, state) && Refine(binOp->getRHS(), true, state));
+        }
+        if (op == clang::BO_LOr) {
+            return truth || (Refine(binOp->getLHS(), false, state) && Refine(binOp->getRHS(), false, state));
+        }
+        if (binOp->isComparisonOp()) {
+            if (!truth) op = clang::BinaryOperator::negateComparisonOp(op);
+            return RefineComparison(binOp->getLHS(), binOp->getRHS(), op, state);
+        }
+    }
+    if (!cond->getType()->isIntegralOrEnumerationType()) return true;
+
+    // 整型值本身作条件：等价于与 0 比较
+    State scratch = state;
+    ValueRange value = Eval(cond, scratch);
+    if (truth) {
+        if (value == ValueRange::Constant(0)) return false;
+        if (value.lo == 0) return RefineVar(cond, ValueRange::Interval(1, kPosInf), state);
+        if (value.hi == 0) return RefineVar(cond, ValueRange::Interval(kNegInf, -1), state);
+        return true;
+    }
+    return RefineVar(cond, ValueRange::Constant(0), state);
+}
+
+bool ValueRangeAnalysis::RefineComparison(const clang::Expr* lhs, const clang::Expr* rhs,
+                                          clang::BinaryOperatorKind op, State& state)
+{
+    if (!lhs->getType()->isIntegralOrEnumerationType() || !rhs->getType()->isIntegralOrEnumerationType()) {
+        return true;
+    }
+
+    State scratch = state;
+    ValueRange left = Eval(lhs, scratch);
+    ValueRange right = Eval(rhs, scratch);
+    ValueRange outcome = Compare(op, left, right);
+    if (outcome == ValueRange::Constant(0) || outcome.empty) return false;
+
+    // 一侧在另一侧取值范围约束下的取值
+    auto constraintFor = [](clang::BinaryOperatorKind kind, const ValueRange& self, const ValueRange& other) {
+        switch (kind) {
+            case clang::BO_LT:
+                return other.HasUpper() ? ValueRange::Interval(kNegInf, other.hi - 1) : ValueRange::Top();
+            case clang::BO_LE:
+                return ValueRange::Interval(kNegInf, other.hi);
+            case clang::BO_GT:
+                return other.HasLower() ? ValueRange::Interval(other.lo + 1, kPosInf) : ValueRange::Top();
+            case clang::BO_GE:
+                return ValueRange::Interval(other.lo, kPosInf);
+            case clang::BO_EQ:
+                return other;
+            case clang::BO_NE:
+                // 只能去掉区间端点上的那个常量
+                if (other.IsConstant() && self.HasLower() && self.lo == other.residue) {
+                    return ValueRange::Interval(other.residue + 1, kPosInf);
+                }
+                if (other.IsConstant() && self.HasUpper() && self.hi == other.residue) {
+                    return ValueRange::Interval(kNegInf, other.residue - 1);
+                }
+                return ValueRange::Top();
+            default:
+                return ValueRange::Top();
+        }
+    };
+
+    return RefineVar(lhs, constraintFor(op, left, right), state) &&
+           RefineVar(rhs, constraintFor(clang::BinaryOperator::reverseComparisonOp(op), right, left), state);
+}
+
+bool ValueRangeAnalysis::RefineVar(const clang::Expr* expr, const ValueRange& constraint, State& state)
+{
+    if (constraint.IsTop()) return true;
+    expr = expr->IgnoreParens();
+
+    // 保值转换：源值都能在目标类型中表示时，约束原样作用到源表达式
+    while (const auto* cast = llvm::dyn_cast<clang::CastExpr>(expr)) {
+        clang::CastKind kind = cast->getCastKind();
+        if (kind == clang::CK_IntegralCast) {
+            State scratch = state;
+            ValueRange source = Eval(cast->getSubExpr(), scratch);
+            if (!ValueRange::OfType(cast->getType(), astContext).Contains(source)) return true;
+        } else if (kind != clang::CK_LValueToRValue && kind != clang::CK_NoOp) {
+            return true;
+        }
+        expr = cast->getSubExpr()->IgnoreParens();
+    }
+
+    if (const clang::VarDecl* var = TrackedVar(expr)) {
+        ValueRange refined = ReadVar(var, state).Meet(constraint);
+        if (refined.empty) return false;
+        WriteVar(var, refined, state);
+        return state.reachable;
+    }
+
+    const auto* binOp = llvm::dyn_cast<clang::BinaryOperator>(expr);
+    if (!binOp) return true;
+    State scratch = state;
+    ValueRange whole = Eval(binOp, scratch);
+    if (whole.Meet(constraint).empty) return false;
+
+    int64_t constant;
+    const clang::Expr* lhs = binOp->getLHS();
+    const clang::Expr* rhs = binOp->getRHS();
+    switch (binOp->getOpcode()) {
+        case clang::BO_And: {
+            // (x & (2^k - 1)) == c  =>  x ≡ c (mod 2^k)
+            const clang::Expr* value = lhs;
+            if (!EvaluateInt(rhs, astContext, constant)) {
+                value = rhs;
+                if (!EvaluateInt(lhs, astContext, constant)) return true;
+            }
+            if (constant > 0 && ((constant + 1) & constant) == 0 && constraint.IsConstant()) {
+                return RefineVar(value, Congruent(static_cast<uint64_t>(constant) + 1, constraint.residue),
+                                 state);
+            }
+            return true;
+        }
+        case clang::BO_Rem: {
+            // x % m == c 且 x >= 0  =>  x ≡ c (mod m)
+            ValueRange dividend = Eval(lhs, scratch);
+            if (EvaluateInt(rhs, astContext, constant) && constant > 0 && dividend.lo >= 0 &&
+                constraint.IsConstant()) {
+                return RefineVar(lhs, Congruent(static_cast<uint64_t>(constant), constraint.residue), state);
+            }
+            return true;
+        }
+        case clang::BO_Add:
+        case clang::BO_Sub: {
+            // x ± k 未回绕时把约束平移到 x 上
+            bool isAdd = binOp->getOpcode() == clang::BO_Add;
+            const clang::Expr* value = lhs;
+            if (!EvaluateInt(rhs, astContext, constant)) {
+                if (!isAdd || !EvaluateInt(lhs, astContext, constant)) return true;
+                value = rhs;
+            }
+            ValueRange operand = Eval(value, scratch);
+            ValueRange shift = ValueRange::Constant(isAdd ? constant : -constant);
+            if (!ValueRange::OfType(binOp->getType(), astContext).Contains(operand.Add(shift))) return true;
+            return RefineVar(value, constraint.Sub(shift), state);
+        }
+        default:
+            return true;
+    }
+}
+
+// ============================================
+// 查询
+// ============================================
+
+ValueRange ValueRangeAnalysis::GetRange(const clang::Expr* expr)
+{
+    if (!expr) return ValueRange::Top();
+    ValueRange fallback = ValueRange::OfType(expr->getType(), astContext);
+    FunctionResult* result = ResultFor(expr);
+    if (!result || !result->converged) return fallback;
+
+    FunctionResult* saved = current;
+    current = result;
+    ValueRange value = fallback;
+    auto valueIt = result->values.find(expr);
+    if (valueIt != result->values.end()) {
+        value = valueIt->second;
+    } else if (const clang::Stmt* element = EnclosingElement(expr)) {
+        auto beforeIt = result->before.find(element);
+        if (beforeIt == result->before.end() || !beforeIt->second.reachable) {
+            value = ValueRange::Bottom();
+        } else {
+            // 元素内部写入与 expr 的先后无法精确定位：写入过的变量取执行前后的合并
+            State after = beforeIt->second;
+            Transfer(element, after);
+            State merged = JoinStates(beforeIt->second, after);
+            const clang::Stmt* savedElement = currentElement;
+            currentElement = element;
+            value = Eval(expr, merged);
+            currentElement = savedElement;
+        }
+    }
+    current = saved;
+    return value;
+}
+
+ValueRange ValueRangeAnalysis::GetRangeBefore(const clang::Stmt* stmt, const clang::VarDecl* var)
+{
+    if (!stmt || !var) return ValueRange::Top();
+    ValueRange fallback = ValueRange::OfType(var->getType(), astContext);
+    FunctionResult* result = ResultFor(stmt);
+    if (!result || !result->converged || !result->tracked.count(var)) return fallback;
+
+    FunctionResult* saved = current;
+    current = result;
+    const clang::Stmt* element = EnclosingElement(stmt);
+    current = saved;
+    if (!element) return fallback;
+
+    auto it = result->before.find(element);
+    if (it == result->before.end() || !it->second.reachable) return ValueRange::Bottom();
+    return ReadVar(var, it->second);
+}
+
+ValueRange ValueRangeAnalysis::GetLoopEntryRange(const clang::Stmt* loopStmt, const clang::VarDecl* var)
+{
+    if (!loopStmt || !var) return ValueRange::Top();
+    ValueRange fallback = ValueRange::OfType(var->getType(), astContext);
+    FunctionResult* result = ResultFor(loopStmt);
+    if (!result || !result->converged || !result->tracked.count(var)) return fallback;
+
+    auto it = result->loopEntry.find(loopStmt);
+    if (it == result->loopEntry.end()) return fallback;
+    return it->second.reachable ? ReadVar(var, it->second) : ValueRange::Bottom();
+}
+
+ValueRange ValueRangeAnalysis::GetLoopHeadRange(const clang::Stmt* loopStmt, const clang::VarDecl* var)
+{
+    if (!loopStmt || !var) return ValueRange::Top();
+    ValueRange fallback = ValueRange::OfType(var->getType(), astContext);
+    FunctionResult* result = ResultFor(loopStmt);
+    if (!result || !result->converged || !result->tracked.count(var)) return fallback;
+
+    auto it = result->loopHead.find(loopStmt);
+    if (it == result->loopHead.end()) return fallback;
+    return it->second.reachable ? ReadVar(var, it->second) : ValueRange::Bottom();
+}
+
+// ============================================
+// CPGContext 接口
+// ============================================
+
+ValueRangeAnalysis& CPGContext::GetValueRanges() const
+{
+    if (!valueRanges) {
+        valueRanges = std::make_unique<ValueRangeAnalysis>(astContext, this);
+    }
+    return *valueRanges;
+}
+
+} // namespace cpg
@@ -0,0 +1,288 @@
+# ========================================================
+# 回归测试的单个用例（cmake -P 脚本）
+#
+# 参数：
+#   MODE        golden（默认）：规范化图转储与黄金输出比对，并检查时间/内存预算
+#               expect：工具输出（含规范化图转储）中各正则的出现次数须与 EXPECT 文件一致
+#               equivalent：ARGS 与 ALT_ARGS 两次运行的规范化图转储须完全一致
+#               bounded：在 INPUT 处生成 FUNCTIONS 个函数的输入，默认（释放CPG数据）与 --keep-cpg
+#                 两次运行的图须一致，同时持有ICFG的函数数不超过 MAX_LIVE，峰值常驻内存不高于保留时
+#   TOOL        ComputeGraphTool 可执行文件
+#   INPUT       输入源文件
+#   WORK_DIR    本用例的输出目录
+#   GOLDEN      golden：黄金输出文件（规范化图转储）
+#   BUDGET      golden：预算文件（update-golden 时记录的实测 wall_ms / peak_rss_kb）
+#   UPDATE      golden：为 ON 时用本次输出与实测值覆盖 GOLDEN/BUDGET，不做比对
+#   EXPECT      expect：每行 "<次数> <正则>"，次数为 + 表示至少一次；# 开头为注释
+#   ARGS        附加的工具选项，以 | 分隔（不得与下面的固定选项重复）
+#   ALT_ARGS    equivalent：第二次运行的附加选项，以 | 分隔
+#   VERBOSE     传给 --verbose，默认 false
+#   FUNCTIONS   bounded：生成的函数数
+#   MAX_LIVE    bounded：同时持有ICFG的函数数上限（与 FUNCTIONS 无关）
+# ========================================================
+cmake_minimum_required(VERSION 3.14)
+
+# 预算 = 实测值 × 系数 + 余量；余量吸收小用例上的计时/分配抖动
+set(CG_WALL_FACTOR 3)
+set(CG_WALL_SLACK_MS 2000)
+set(CG_RSS_PERCENT 125)
+set(CG_RSS_SLACK_KB 32768)
+# bounded：释放时的峰值常驻内存相对保留时允许的抖动
+set(CG_BOUNDED_RSS_SLACK_KB 1024)
+
+foreach(arg TOOL INPUT WORK_DIR)
+    if(NOT DEFINED ${arg})
+        message(FATAL_ERROR "RunGoldenTest.cmake: missing -D${arg}=...")
+    endif()
+endforeach()
+if(NOT DEFINED MODE)
+    set(MODE golden)
+endif()
+if(NOT DEFINED VERBOSE)
+    set(VERBOSE false)
+endif()
+
+get_filename_component(caseName "${INPUT}" NAME_WE)
+get_filename_component(inputDir "${INPUT}" DIRECTORY)
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+# 运行一次工具：<tag>.dump 为去掉输入目录后的规范化转储，输出变量为转储内容、标准输出、
+# 工具自报的墙钟时间（ms）与峰值常驻内存（KB，不可测的平台为 0）
+function(run_tool tag extraArgs dumpVar outputVar wallVar rssVar)
+    set(dumpFile "${WORK_DIR}/${tag}.dump")
+    file(REMOVE "${dumpFile}")
+    string(REPLACE "|" ";" extraList "${extraArgs}")
+    execute_process(
+        COMMAND "${TOOL}" "${INPUT}"
+                --golden-dump=${dumpFile}
+                --output-dir=${WORK_DIR}
+                --visualize=false
+                --dump-graphs=false
+                --verbose=${VERBOSE}
+                --simd-target=avx2
+                --min-speedup=0
+                ${extraList}
+                --
+                -std=c++17
+        WORKING_DIRECTORY "${WORK_DIR}"
+        RESULT_VARIABLE toolStatus
+        OUTPUT_VARIABLE toolOutput
+        ERROR_VARIABLE toolErrors)
+
+    file(WRITE "${WORK_DIR}/${tag}.log" "${toolOutput}\n${toolErrors}")
+    if(NOT toolStatus EQUAL 0)
+        message(FATAL_ERROR "[${tag}] ComputeGraphTool exited with ${toolStatus}\n${toolErrors}")
+    endif()
+    if(NOT EXISTS "${dumpFile}")
+        message(FATAL_ERROR "[${tag}] no canonical dump written (see ${WORK_DIR}/${tag}.log)")
+    endif()
+
+    string(REGEX MATCH "Wall time: ([0-9]+) ms" wallLine "${toolOutput}")
+    set(wallMS "${CMAKE_MATCH_1}")
+    string(REGEX MATCH "Peak RSS: ([0-9]+) KB" rssLine "${toolOutput}")
+    set(peakKB "${CMAKE_MATCH_1}")
+    if(NOT wallLine OR NOT rssLine)
+        message(FATAL_ERROR "[${tag}] tool output has no 'Wall time'/'Peak RSS' lines")
+    endif()
+
+    file(READ "${dumpFile}" dump)
+    string(REPLACE "${inputDir}/" "" dump "${dump}")
+    set(${dumpVar} "${dump}" PARENT_SCOPE)
+    set(${outputVar} "${toolOutput}" PARENT_SCOPE)
+    set(${wallVar} "${wallMS}" PARENT_SCOPE)
+    set(${rssVar} "${peakKB}" PARENT_SCOPE)
+endfunction()
+
+# 两段文本不一致时写出实际输出并给出统一差异格式
+function(report_mismatch expectedFile actual what)
+    set(actualFile "${WORK_DIR}/${caseName}.actual")
+    file(WRITE "${actualFile}" "${actual}")
+    find_program(DIFF_EXECUTABLE diff)
+    if(DIFF_EXECUTABLE)
+        execute_process(COMMAND "${DIFF_EXECUTABLE}" -u "${expectedFile}" "${actualFile}"
+                        OUTPUT_VARIABLE diffText)
+        message("${diffText}")
+    endif()
+    message(FATAL_ERROR "[${caseName}] ${what}")
+endfunction()
+
+# ========================================================
+# equivalent：两组选项下的图必须逐字一致
+# ========================================================
+if(MODE STREQUAL "equivalent")
+    if(NOT DEFINED ALT_ARGS)
+        message(FATAL_ERROR "RunGoldenTest.cmake: equivalent mode needs -DALT_ARGS=...")
+    endif()
+    run_tool(${caseName}.a "${ARGS}" dumpA outA wallA rssA)
+    run_tool(${caseName}.b "${ALT_ARGS}" dumpB outB wallB rssB)
+    if(NOT dumpA STREQUAL dumpB)
+        set(firstFile "${WORK_DIR}/${caseName}.a.normalized")
+        file(WRITE "${firstFile}" "${dumpA}")
+        report_mismatch("${firstFile}" "${dumpB}"
+                        "graphs differ between options '${ARGS}' and '${ALT_ARGS}'")
+    endif()
+    message(STATUS "[${caseName}] identical graphs with '${ARGS}' and '${ALT_ARGS}'")
+    return()
+endif()
+
+# ========================================================
+# bounded：多函数输入上的内存上界
+# ========================================================
+if(MODE STREQUAL "bounded")
+    foreach(arg FUNCTIONS MAX_LIVE)
+        if(NOT DEFINED ${arg})
+            message(FATAL_ERROR "RunGoldenTest.cmake: bounded mode needs -D${arg}=...")
+        endif()
+    endforeach()
+
+    # 互不调用的函数：每个函数的引用集合只有自身，驻留的CPG数据只取决于流水线深度
+    set(source "// Generated by RunGoldenTest.cmake: ${FUNCTIONS} independent kernels\n\n")
+    math(EXPR lastIndex "${FUNCTIONS} - 1")
+    foreach(i RANGE ${lastIndex})
+        string(APPEND source
+               "void kernel_${i}(float* a, const float* b, float* c, int n)\n{\n"
+               "    for (int j = 0; j < n; ++j) {\n        a[j] = a[j] * b[j] + ${i}.0f;\n    }\n"
+               "    for (int j = 0; j < n; ++j) {\n        c[j] = a[j] - b[j];\n    }\n"
+               "    float s = 0.0f;\n"
+               "    for (int j = 0; j < n; ++j) {\n        s += c[j] * ${i}.5f;\n    }\n"
+               "    c[0] = s;\n}\n\n")
+    endforeach()
+    file(WRITE "${INPUT}" "${source}")
+
+    run_tool(${caseName}.keep "--keep-cpg" dumpKeep outKeep wallKeep rssKeep)
+    run_tool(${caseName}.release "${ARGS}" dumpRelease outRelease wallRelease rssRelease)
+
+    foreach(run Keep Release)
+        string(REGEX MATCH "peak live CPG functions ([0-9]+)" liveLine "${out${run}}")
+        if(NOT liveLine)
+            message(FATAL_ERROR "[${caseName}] tool output has no 'peak live CPG functions' statistic")
+        endif()
+        set(live${run} "${CMAKE_MATCH_1}")
+    endforeach()
+
+    if(NOT dumpKeep STREQUAL dumpRelease)
+        set(firstFile "${WORK_DIR}/${caseName}.keep.normalized")
+        file(WRITE "${firstFile}" "${dumpKeep}")
+        report_mismatch("${firstFile}" "${dumpRelease}" "graphs differ when CPG data is released")
+    endif()
+    if(liveRelease GREATER MAX_LIVE)
+        message(FATAL_ERROR "[${caseName}] ${liveRelease} functions held CPG data at once, "
+                            "bound is ${MAX_LIVE} (${liveKeep} with --keep-cpg)")
+    endif()
+    if(NOT liveRelease LESS liveKeep)
+        message(FATAL_ERROR "[${caseName}] releasing did not reduce live CPG functions "
+                            "(${liveRelease} vs ${liveKeep} with --keep-cpg)")
+    endif()
+    if(rssRelease EQUAL 0 OR rssKeep EQUAL 0)
+        message(STATUS "[${caseName}] peak RSS not measurable on this platform, RSS comparison skipped")
+    else()
+        math(EXPR rssBound "${rssKeep} + ${CG_BOUNDED_RSS_SLACK_KB}")
+        if(rssRelease GREATER rssBound)
+            message(FATAL_ERROR "[${caseName}] peak RSS ${rssRelease} KB with release exceeds "
+                                "${rssKeep} KB with --keep-cpg")
+        endif()
+    endif()
+    message(STATUS "[${caseName}] ${FUNCTIONS} functions: live CPG ${liveRelease} (keep ${liveKeep}), "
+                   "peak RSS ${rssRelease} KB (keep ${rssKeep} KB)")
+    return()
+endif()
+
+# ========================================================
+# expect：按正则统计工具输出
+# ========================================================
+if(MODE STREQUAL "expect")
+    if(NOT DEFINED EXPECT OR NOT EXISTS "${EXPECT}")
+        message(FATAL_ERROR "RunGoldenTest.cmake: expect mode needs an existing -DEXPECT=file")
+    endif()
+    run_tool(${caseName} "${ARGS}" dump output wallMS peakKB)
+    # 【修改】图属性只出现在转储里，一并参与统计
+    string(APPEND output "\n${dump}")
+    file(STRINGS "${EXPECT}" expectLines ENCODING UTF-8)
+    set(failures "")
+    foreach(line IN LISTS expectLines)
+        if(line MATCHES "^[ \t]*(#|$)")
+            continue()
+        endif()
+        if(NOT line MATCHES "^([0-9]+|\\+)[ \t]+(.+)$")
+            message(FATAL_ERROR "[${caseName}] malformed expectation: ${line}")
+        endif()
+        set(wanted "${CMAKE_MATCH_1}")
+        set(pattern "${CMAKE_MATCH_2}")
+        string(REGEX MATCHALL "${pattern}" matches "${output}")
+        list(LENGTH matches count)
+        if((wanted STREQUAL "+" AND count EQUAL 0) OR
+           (NOT wanted STREQUAL "+" AND NOT count EQUAL wanted))
+            string(APPEND failures "\n  expected ${wanted} x '${pattern}', found ${count}")
+        endif()
+    endforeach()
+    if(failures)
+        message(FATAL_ERROR "[${caseName}] output expectations not met (see ${WORK_DIR}/${caseName}.log):"
+                            "${failures}")
+    endif()
+    message(STATUS "[${caseName}] all output expectations met")
+    return()
+endif()
+
+# ========================================================
+# golden：规范化图转储 + 实测预算
+# ========================================================
+foreach(arg GOLDEN BUDGET)
+    if(NOT DEFINED ${arg})
+        message(FATAL_ERROR "RunGoldenTest.cmake: missing -D${arg}=...")
+    endif()
+endforeach()
+
+run_tool(${caseName} "${ARGS}" actual output wallMS peakKB)
+
+if(UPDATE)
+    file(WRITE "${GOLDEN}" "${actual}")
+    file(WRITE "${BUDGET}" "wall_ms ${wallMS}\npeak_rss_kb ${peakKB}\n")
+    message(STATUS "[${caseName}] golden output updated: ${GOLDEN} "
+                   "(measured ${wallMS} ms, ${peakKB} KB)")
+    return()
+endif()
+
+if(NOT EXISTS "${GOLDEN}" OR NOT EXISTS "${BUDGET}")
+    file(WRITE "${WORK_DIR}/${caseName}.actual" "${actual}")
+    message(FATAL_ERROR "[${caseName}] no committed baseline (${GOLDEN}, ${BUDGET}); "
+                        "review ${WORK_DIR}/${caseName}.actual and run the 'update-golden' target")
+endif()
+
+# 1. 预算
+file(STRINGS "${BUDGET}" budgetLines)
+set(measuredWall "")
+set(measuredRSS "")
+foreach(line IN LISTS budgetLines)
+    if(line MATCHES "^wall_ms ([0-9]+)$")
+        set(measuredWall "${CMAKE_MATCH_1}")
+    elseif(line MATCHES "^peak_rss_kb ([0-9]+)$")
+        set(measuredRSS "${CMAKE_MATCH_1}")
+    endif()
+endforeach()
+if(measuredWall STREQUAL "" OR measuredRSS STREQUAL "")
+    message(FATAL_ERROR "[${caseName}] malformed budget file ${BUDGET}")
+endif()
+
+math(EXPR wallBudget "${measuredWall} * ${CG_WALL_FACTOR} + ${CG_WALL_SLACK_MS}")
+if(wallMS GREATER wallBudget)
+    message(FATAL_ERROR "[${caseName}] wall time ${wallMS} ms exceeds budget ${wallBudget} ms "
+                        "(measured baseline ${measuredWall} ms)")
+endif()
+if(peakKB EQUAL 0 OR measuredRSS EQUAL 0)
+    message(STATUS "[${caseName}] peak RSS not measurable on this platform, memory budget skipped")
+else()
+    math(EXPR rssBudget "${measuredRSS} * ${CG_RSS_PERCENT} / 100 + ${CG_RSS_SLACK_KB}")
+    if(peakKB GREATER rssBudget)
+        message(FATAL_ERROR "[${caseName}] peak RSS ${peakKB} KB exceeds budget ${rssBudget} KB "
+                            "(measured baseline ${measuredRSS} KB)")
+    endif()
+endif()
+message(STATUS "[${caseName}] ${wallMS} ms (budget ${wallBudget}), ${peakKB} KB")
+
+# 2. 与黄金输出比对
+file(READ "${GOLDEN}" expected)
+if(NOT actual STREQUAL expected)
+    report_mismatch("${GOLDEN}" "${actual}"
+                    "canonical graph dump differs from ${GOLDEN}; "
+                    "if the change is intended, run the 'update-golden' target")
+endif()
@@ -0,0 +1,27 @@
+/*
+ * anti_dependence.cpp - 回归用例：循环携带反依赖与向量代码生成
+ *
+ * 两个循环的依赖相同（a[i+1] 的读与下一迭代 a[i] 的写，距离 1），只差迭代内的语句顺序：
+ *   - 读在写前：逐语句按源码顺序向量化仍读到旧值，可以生成向量代码
+ *   - 写在读前：向量写 a[i..i+vl-1] 后再读 a[i+1..i+vl] 会读到新值，不能生成
+ */
+
+float a[1025];
+float b[1024];
+float x[1024];
+
+void shift_read_first()
+{
+    for (int i = 0; i < 1024; ++i) {
+        b[i] = a[i + 1];
+        a[i] = x[i];
+    }
+}
+
+void shift_write_first()
+{
+    for (int i = 0; i < 1024; ++i) {
+        a[i] = x[i];
+        b[i] = a[i + 1];
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ * bf16.cpp - 回归用例：BF16 转换辅助函数
+ *
+ * 覆盖：BF16 <-> FP32 转换（移位/联合体/就近舍入）、点积归约（FP64 累加）、
+ * 逐元素转换循环；与 case2 的 ggml_vec_dot_bf16 同构但不依赖系统头文件
+ */
+
+typedef unsigned short uint16_t;
+typedef unsigned int uint32_t;
+typedef double ggml_float;
+
+struct ggml_bf16_t {
+    uint16_t bits;
+};
+
+static inline float bf16_to_fp32(ggml_bf16_t h)
+{
+    union {
+        float f;
+        uint32_t i;
+    } u;
+    u.i = (uint32_t)h.bits << 16;
+    return u.f;
+}
+
+static inline ggml_bf16_t fp32_to_bf16(float s)
+{
+    union {
+        float f;
+        uint32_t i;
+    } u;
+    u.f = s;
+    ggml_bf16_t h;
+    if ((u.i & 0x7fffffff) > 0x7f800000) {
+        h.bits = (u.i >> 16) | 64;  // NaN 保持为静默 NaN
+        return h;
+    }
+    h.bits = (u.i + (0x7fff + ((u.i >> 16) & 1))) >> 16;  // 就近舍入到偶数
+    return h;
+}
+
+void vec_dot_bf16(int n, float* s, const ggml_bf16_t* x, const ggml_bf16_t* y)
+{
+    ggml_float sumf = 0;
+    for (int i = 0; i < n; ++i) {
+        sumf += (ggml_float)(bf16_to_fp32(x[i]) * bf16_to_fp32(y[i]));
+    }
+    *s = (float)sumf;
+}
+
+void fp32_to_bf16_row(const float* x, ggml_bf16_t* y, int n)
+{
+    for (int i = 0; i < n; i++) {
+        y[i] = fp32_to_bf16(x[i]);
+    }
+}
+
+void bf16_to_fp32_row(const ggml_bf16_t* x, float* y, int n)
+{
+    for (int i = 0; i < n; i++) {
+        y[i] = bf16_to_fp32(x[i]);
+    }
+}
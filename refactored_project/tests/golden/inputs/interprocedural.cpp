@@ -0,0 +1,51 @@
+/*
+ * interprocedural.cpp - 回归用例：跨函数
+ *
+ * 覆盖：循环体内调用内部函数（跨函数展开）、多层调用链、
+ * 指针参数经调用点传播（对齐/值域/指针分析）、返回值参与归约
+ */
+
+static float square(float x)
+{
+    return x * x;
+}
+
+static float weighted(float x, float w)
+{
+    return square(x) * w;
+}
+
+float weighted_norm(const float* x, const float* w, int n)
+{
+    float acc = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        acc += weighted(x[i], w[i]);
+    }
+    return acc;
+}
+
+static void add_into(float* dst, const float* src, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        dst[i] += src[i];
+    }
+}
+
+void accumulate_rows(float* dst, const float* rows, int count, int width)
+{
+    for (int r = 0; r < count; ++r) {
+        add_into(dst, rows + r * width, width);
+    }
+}
+
+static int clamp_index(int v, int hi)
+{
+    return v < 0 ? 0 : (v >= hi ? hi - 1 : v);
+}
+
+void gather_clamped(const float* table, const int* idx, float* out, int n, int size)
+{
+    for (int i = 0; i < n; ++i) {
+        out[i] = table[clamp_index(idx[i], size)];
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * loops.cpp - 回归用例：循环
+ *
+ * 覆盖：逐元素映射（saxpy）、求和/最大值归约、二维嵌套循环、步长访问、
+ * while 循环与常量迭代次数（值域/对齐/剥离分析的输入）
+ */
+
+void saxpy(float a, const float* x, float* y, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        y[i] = a * x[i] + y[i];
+    }
+}
+
+float sum_array(const float* data, int n)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+int max_element(const int* data, int n)
+{
+    int best = data[0];
+    for (int i = 1; i < n; ++i) {
+        if (data[i] > best) {
+            best = data[i];
+        }
+    }
+    return best;
+}
+
+void matvec(const float* m, const float* v, float* out, int rows, int cols)
+{
+    for (int r = 0; r < rows; ++r) {
+        float acc = 0.0f;
+        for (int c = 0; c < cols; ++c) {
+            acc += m[r * cols + c] * v[c];
+        }
+        out[r] = acc;
+    }
+}
+
+void deinterleave(const float* in, float* re, float* im, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        re[i] = in[2 * i];
+        im[i] = in[2 * i + 1];
+    }
+}
+
+void scale_fixed(float (&buf)[64], float k)
+{
+    for (int i = 0; i < 64; i += 1) {
+        buf[i] = buf[i] * k;
+    }
+}
+
+int count_down(int* data, int n)
+{
+    int steps = 0;
+    while (n > 0) {
+        --n;
+        data[n] = data[n] * 2 + 1;
+        steps++;
+    }
+    return steps;
+}
@@ -0,0 +1,26 @@
+/*
+ * profile_paths.cpp - 回归用例：剖析数据按真实路径匹配源码文件
+ *
+ * profile_paths.perf 的样本来自另一个构建目录：
+ *   - .../inputs/profile_paths.cpp 第 17 行（hot_kernel 循环体）的样本都带 " (discriminator N)"
+ *   - .../decoy/profile_paths.cpp 是同名的另一个文件，其样本落在第 24 行
+ * 只有 hot_kernel 的图应带 profile_hotness；cold_kernel 不能因 basename 相同而变热
+ */
+
+float a[1024];
+float b[1024];
+float c[1024];
+
+void hot_kernel()
+{
+    for (int i = 0; i < 1024; ++i) {
+        a[i] = b[i] * c[i];
+    }
+}
+
+void cold_kernel()
+{
+    for (int i = 0; i < 1024; ++i) {
+        b[i] = a[i] + c[i];
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ * switch.cpp - 回归用例：switch
+ *
+ * 覆盖：循环内 switch 的 case/default 分支标注、贯穿（fallthrough）、
+ * switch 标签对值域的收紧、break 退出 switch 而非循环
+ */
+
+enum Op { OpAdd, OpSub, OpMul, OpNeg };
+
+void apply_ops(const int* ops, const float* a, const float* b, float* out, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        switch (ops[i]) {
+            case OpAdd:
+                out[i] = a[i] + b[i];
+                break;
+            case OpSub:
+                out[i] = a[i] - b[i];
+                break;
+            case OpMul:
+                out[i] = a[i] * b[i];
+                break;
+            default:
+                out[i] = -a[i];
+                break;
+        }
+    }
+}
+
+int classify(int v)
+{
+    int score = 0;
+    switch (v & 3) {
+        case 0:
+            score += 4;
+            // fallthrough
+        case 1:
+            score += 2;
+            break;
+        case 2:
+            score = 1;
+            break;
+        default:
+            score = -1;
+    }
+    return score;
+}
+
+int histogram_classes(const int* values, int* bins, int n)
+{
+    int total = 0;
+    for (int i = 0; i < n; ++i) {
+        int c = classify(values[i]);
+        switch (c) {
+            case 6: bins[0]++; break;
+            case 2: bins[1]++; break;
+            case 1: bins[2]++; break;
+            default: bins[3]++; break;
+        }
+        total += c;
+    }
+    return total;
+}
@@ -0,0 +1,42 @@
+/*
+ * templates.cpp - 回归用例：模板
+ *
+ * 覆盖：函数模板按 float/double/int 实例化、类模板成员函数、
+ * 非类型模板参数给出的常量迭代次数、模板内调用模板
+ */
+
+template <typename T>
+T dot(const T* a, const T* b, int n)
+{
+    T acc = T(0);
+    for (int i = 0; i < n; ++i) {
+        acc += a[i] * b[i];
+    }
+    return acc;
+}
+
+template <typename T>
+T norm2(const T* a, int n)
+{
+    return dot(a, a, n);
+}
+
+template <typename T, int N>
+struct FixedVector {
+    T data[N];
+
+    void axpy(T alpha, const FixedVector& other)
+    {
+        for (int i = 0; i < N; ++i) {
+            data[i] += alpha * other.data[i];
+        }
+    }
+};
+
+float use_templates(const float* x, const double* y, const int* z, int n)
+{
+    FixedVector<float, 16> u = {};
+    FixedVector<float, 16> v = {};
+    u.axpy(2.0f, v);
+    return dot(x, x, n) + static_cast<float>(norm2(y, n)) + static_cast<float>(dot(z, z, n)) + u.data[0];
+}
@@ -0,0 +1,56 @@
+/*
+ * unions.cpp - 回归用例：联合体
+ *
+ * 覆盖：联合体按位重解释（float <-> int）、结构体内的匿名联合体、
+ * 经联合体成员读写的循环（指针分析/别名与成员访问节点）
+ */
+
+union FloatBits {
+    float f;
+    unsigned int u;
+};
+
+static inline float fast_abs(float x)
+{
+    FloatBits bits;
+    bits.f = x;
+    bits.u &= 0x7fffffffu;
+    return bits.f;
+}
+
+void abs_all(float* data, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        data[i] = fast_abs(data[i]);
+    }
+}
+
+struct Value {
+    int tag;
+    union {
+        int i;
+        float f;
+    };
+};
+
+float sum_values(const Value* values, int n)
+{
+    float total = 0.0f;
+    for (int k = 0; k < n; ++k) {
+        if (values[k].tag == 0) {
+            total += static_cast<float>(values[k].i);
+        } else {
+            total += values[k].f;
+        }
+    }
+    return total;
+}
+
+void pack_bits(const float* in, unsigned int* out, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        FloatBits bits;
+        bits.f = in[i];
+        out[i] = bits.u >> 16;
+    }
+}
@@ -20,6 +20,7 @@
  */
 
 #include "code_property_graph/ComputeGraphTester.h"
+#include "code_property_graph/AnalysisPipeline.h"
 
 #include "clang/AST/ASTConsumer.h"
 #include "clang/AST/RecursiveASTVisitor.h"
@@ -33,6 +34,7 @@
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/FileSystem.h"
 
+#include <chrono>
 #include <memory>
 
 using namespace clang;
@@ -73,6 +75,104 @@ static cl::opt<int> OptMaxDepth("max-depth",
     cl::desc("Maximum traversal depth for graph building"),
     cl::init(5), cl::cat(ToolCategory));
 
+static cl::opt<std::string> OptProfile("profile",
+    cl::desc("Execution profile for anchor ranking (perf script with srcline, gcov text, or llvm-profdata show output)"),
+    cl::init(""), cl::cat(ToolCategory));
+
+static cl::opt<unsigned> OptMaxAnchors("max-anchors",
+    cl::desc("Maximum number of anchors kept per function (0 = unlimited)"),
+    cl::init(50), cl::cat(ToolCategory));
+
+static cl::opt<std::string> OptSIMDTarget("simd-target",
+    cl::desc("Target ISA for vectorization profit estimate: sse4.2, avx2, avx512, neon, sve256, none"),
+    cl::init("avx2"), cl::cat(ToolCategory));
+
+static cl::opt<double> OptMinSpeedup("min-speedup",
+    cl::desc("Drop graphs that are not vectorizable or whose estimated speedup is below this value "
+             "(0 = keep all)"),
+    cl::init(1.0), cl::cat(ToolCategory));
+
+static cl::opt<bool> OptEmitSIMD("emit-simd",
+    cl::desc("Emit a vectorized C++ version of each loop with a recognized map/reduction idiom"),
+    cl::init(false), cl::cat(ToolCategory));
+
+static cl::opt<std::string> OptEmitISA("emit-isa",
+    cl::desc("ISA for --emit-simd: sse4.2, avx2, avx512, neon, simd (std::experimental::simd); "
+             "defaults to --simd-target"),
+    cl::init(""), cl::cat(ToolCategory));
+
+static cl::opt<bool> OptEmitBench("emit-bench",
+    cl::desc("Generate, build and run a scalar-vs-vector microbenchmark for the top-ranked graphs"),
+    cl::init(false), cl::cat(ToolCategory));
+
+static cl::opt<unsigned> OptBenchTop("bench-top",
+    cl::desc("Number of top-ranked graphs per function to benchmark (0 = all)"),
+    cl::init(3), cl::cat(ToolCategory));
+
+static cl::opt<unsigned> OptBenchElements("bench-elements",
+    cl::desc("Default element count of generated benchmarks"),
+    cl::init(4096), cl::cat(ToolCategory));
+
+static cl::opt<std::string> OptBenchCompiler("bench-cxx",
+    cl::desc("Local C++ compiler used to build benchmarks (empty = generate only)"),
+    cl::init("c++"), cl::cat(ToolCategory));
+
+static cl::opt<unsigned> OptBenchTimeout("bench-timeout",
+    cl::desc("Seconds allowed for building and for running each benchmark; a timeout fails it (0 = no limit)"),
+    cl::init(60), cl::cat(ToolCategory));
+
+static cl::opt<bool> OptInstantiations("instantiations",
+    cl::desc("Report function templates per instantiation: anchors are found once on the pattern, "
+             "each instance's graph is built from its own instantiated body"),
+    cl::init(false), cl::cat(ToolCategory));
+
+static cl::opt<unsigned> OptDotLODThreshold("dot-lod-threshold",
+    cl::desc("Graphs with more nodes are exported as a collapsed overview plus per-cluster "
+             "drill-down DOT files (0 = always flat)"),
+    cl::init(2000), cl::cat(ToolCategory));
+
+static cl::opt<bool> OptEmitBinary("emit-binary",
+    cl::desc("Write each function's graphs to <output-dir>/<function>.cgb (compact binary, mmap-readable)"),
+    cl::init(false), cl::cat(ToolCategory));
+
+static cl::opt<bool> OptSimilarity("similarity",
+    cl::desc("Cluster graphs across all functions and files by structural similarity (WL + MinHash/LSH)"),
+    cl::init(false), cl::cat(ToolCategory));
+
+static cl::opt<double> OptSimilarityThreshold("similarity-threshold",
+    cl::desc("Minimum estimated similarity for two graphs to share a cluster"),
+    cl::init(0.8), cl::cat(ToolCategory));
+
+static cl::opt<bool> OptCrossTUDedup("cross-tu-dedup",
+    cl::desc("Skip functions/anchors (file + USR + offset) already analyzed in another translation unit"),
+    cl::init(false), cl::cat(ToolCategory));
+
+static cl::opt<std::string> OptDedupRegistry("dedup-registry",
+    cl::desc("Registry file shared by batch processes for cross-TU dedup (implies --cross-tu-dedup)"),
+    cl::init(""), cl::cat(ToolCategory));
+
+static cl::opt<unsigned> OptPipelineQueue("pipeline-queue",
+    cl::desc("Maximum anchor clusters queued between discovery and graph building"),
+    cl::init(64), cl::cat(ToolCategory));
+
+static cl::opt<unsigned> OptMaxRSS("max-rss",
+    cl::desc("Resident memory budget in MB; discovery of new functions pauses above it until "
+             "exported functions have been released (0 = unlimited)"),
+    cl::init(0), cl::cat(ToolCategory));
+
+static cl::opt<bool> OptKeepCPG("keep-cpg",
+    cl::desc("Keep the CPG data of exported functions until the translation unit ends "
+             "(debugging; memory grows with the translation unit)"),
+    cl::init(false), cl::cat(ToolCategory));
+
+static cl::opt<std::string> OptPointsTo("points-to",
+    cl::desc("Pointer analysis for alias-aware memory dependences: off, steensgaard or andersen"),
+    cl::init("steensgaard"), cl::cat(ToolCategory));
+
+static cl::opt<std::string> OptGoldenDump("golden-dump",
+    cl::desc("Write a canonical, ID-independent dump of every exported graph to this file (regression tests)"),
+    cl::init(""), cl::cat(ToolCategory));
+
 static cl::opt<bool> OptRunBF16Demo("bf16-demo",
     cl::desc("Run BF16 dot product demo with manual graph construction"),
     cl::init(false), cl::cat(ToolCategory));
@@ -90,6 +190,29 @@ static void InitializeConfig()
     g_cgConfig.targetFunction = OptTargetFunction;
     g_cgConfig.maxBackwardDepth = OptMaxDepth;
     g_cgConfig.maxForwardDepth = OptMaxDepth;
+    g_cgConfig.profileFile = OptProfile;
+    g_cgConfig.maxAnchors = OptMaxAnchors;
+    g_cgConfig.simdTarget = OptSIMDTarget;
+    g_cgConfig.minSpeedup = OptMinSpeedup;
+    g_cgConfig.emitSIMD = OptEmitSIMD;
+    g_cgConfig.emitISA = OptEmitISA;
+    g_cgConfig.emitBench = OptEmitBench;
+    g_cgConfig.benchTop = OptBenchTop;
+    g_cgConfig.benchElements = OptBenchElements;
+    g_cgConfig.benchCompiler = OptBenchCompiler;
+    g_cgConfig.benchTimeout = OptBenchTimeout;
+    g_cgConfig.instantiations = OptInstantiations;
+    g_cgConfig.dotLODThreshold = OptDotLODThreshold;
+    g_cgConfig.emitBinary = OptEmitBinary;
+    g_cgConfig.similarity = OptSimilarity;
+    g_cgConfig.similarityThreshold = OptSimilarityThreshold;
+    g_cgConfig.crossTUDedup = OptCrossTUDedup;
+    g_cgConfig.dedupRegistry = OptDedupRegistry;
+    g_cgConfig.pipelineQueue = OptPipelineQueue;
+    g_cgConfig.maxRSSMB = OptMaxRSS;
+    g_cgConfig.keepCPG = OptKeepCPG;
+    g_cgConfig.pointsTo = OptPointsTo;
+    g_cgConfig.goldenDump = OptGoldenDump;
 }
 
 // ============================================
@@ -109,9 +232,51 @@ static void PrintToolBanner()
     outs() << "  Pattern Matching: " << (g_cgConfig.testPatternMatching ? "yes" : "no") << "\n";
     outs() << "  Output Dir: " << g_cgConfig.outputDir << "\n";
     outs() << "  Max Depth: " << g_cgConfig.maxBackwardDepth << "\n";
+    outs() << "  Max Anchors: " << g_cgConfig.maxAnchors << "\n";
+    outs() << "  SIMD Target: " << g_cgConfig.simdTarget << "\n";
+    outs() << "  Min Speedup: " << g_cgConfig.minSpeedup << "\n";
+    outs() << "  DOT LOD Threshold: " << g_cgConfig.dotLODThreshold << "\n";
+    outs() << "  Points-To: " << g_cgConfig.pointsTo << "\n";
+    outs() << "  Pipeline Queue: " << g_cgConfig.pipelineQueue << " clusters";
+    if (g_cgConfig.maxRSSMB > 0) {
+        outs() << ", max RSS " << g_cgConfig.maxRSSMB << " MB";
+    }
+    outs() << "\n";
+    if (g_cgConfig.emitSIMD) {
+        outs() << "  Emit SIMD: "
+               << (g_cgConfig.emitISA.empty() ? g_cgConfig.simdTarget : g_cgConfig.emitISA) << "\n";
+    }
+    if (g_cgConfig.emitBench) {
+        outs() << "  Emit Bench: top " << g_cgConfig.benchTop << ", "
+               << g_cgConfig.benchElements << " elements, compiler "
+               << (g_cgConfig.benchCompiler.empty() ? "(none)" : g_cgConfig.benchCompiler);
+        if (g_cgConfig.benchTimeout > 0) {
+            outs() << ", timeout " << g_cgConfig.benchTimeout << " s";
+        }
+        outs() << "\n";
+    }
+    if (g_cgConfig.instantiations) {
+        outs() << "  Template Instantiations: yes\n";
+    }
+    if (g_cgConfig.crossTUDedup || !g_cgConfig.dedupRegistry.empty()) {
+        outs() << "  Cross-TU Dedup: "
+               << (g_cgConfig.dedupRegistry.empty() ? "in-process" : g_cgConfig.dedupRegistry) << "\n";
+    }
+    if (g_cgConfig.similarity) {
+        outs() << "  Similarity Clusters: threshold " << g_cgConfig.similarityThreshold << "\n";
+    }
+    if (g_cgConfig.emitBinary) {
+        outs() << "  Emit Binary: " << g_cgConfig.outputDir << "/<function>.cgb\n";
+    }
+    if (!g_cgConfig.profileFile.empty()) {
+        outs() << "  Profile: " << g_cgConfig.profileFile << "\n";
+    }
     if (!g_cgConfig.targetFunction.empty()) {
         outs() << "  Target Function: " << g_cgConfig.targetFunction << "\n";
     }
+    if (!g_cgConfig.goldenDump.empty()) {
+        outs() << "  Golden Dump: " << g_cgConfig.goldenDump << "\n";
+    }
     outs() << "\n";
 }
 
@@ -132,8 +297,8 @@ public:
         CollectFunctions();
         outs() << "Found " << functions.size() << " functions to analyze\n\n";
 
-        // 构建全局ICFG
-        RunDemoBuildGlobalICFG();
+        // 【修改】只构建调用图，ICFG在发现阶段按需构建
+        RunDemoBuildCallGraph();
 
         // 分析每个函数
         RunDemoAnalyzeFunctions();
@@ -159,6 +324,7 @@ private:
     cpg::CPGContext& cpgContext;
     std::vector<FunctionDecl*> functions;
     std::vector<TestResult> results;
+    PipelineStats pipelineStats;
 
     void PrintHeader(const std::string& title)
     {
@@ -222,13 +388,13 @@ private:
     }
 
     // ========================================
-    // Demo 1: 构建全局ICFG
+    // Demo 1: 构建调用图
     // ========================================
-    void RunDemoBuildGlobalICFG()
+    void RunDemoBuildCallGraph()
     {
-        PrintSubHeader("Demo 1: Building Global ICFG");
-        cpgContext.BuildICFGForTranslationUnit();
-        outs() << "Global ICFG constructed successfully\n";
+        PrintSubHeader("Demo 1: Building Call Graph");
+        cpgContext.BuildCallGraphForTranslationUnit();
+        outs() << "Call graph constructed successfully\n";
     }
 
     // ========================================
@@ -236,79 +402,145 @@ private:
     // ========================================
     void RunDemoAnalyzeFunctions()
     {
-        for (auto* func : functions) {
-            std::string funcName = func->getNameAsString();
-            PrintSubHeader("Demo 2: Analyzing Function: " + funcName);
-
-            // 构建CPG
-            cpgContext.BuildCPG(func);
-
-            // 查找锚点
-            AnchorFinder finder(cpgContext, astContext);
-            auto anchors = finder.FindAnchorsInFunction(func);
-            auto rankedAnchors = finder.FilterAndRankAnchors(anchors);
-
-            outs() << "  Found " << anchors.size() << " raw anchors, ";
-            outs() << rankedAnchors.size() << " after filtering\n";
-
-            // 构建计算图
-            ComputeGraphBuilder builder(cpgContext, astContext);
-            builder.SetMaxBackwardDepth(g_cgConfig.maxBackwardDepth);
-            builder.SetMaxForwardDepth(g_cgConfig.maxForwardDepth);
-
-            ComputeGraphSet graphSet;
-            TestResult result;
-            result.testName = funcName;
-            result.passed = true;
-
-            for (const auto& anchor : rankedAnchors) {
-                auto graph = builder.BuildFromAnchor(anchor);
-                if (graph && !graph->IsEmpty()) {
-                    graphSet.AddGraph(graph);
-                    result.anchorCount++;
+        // 【修改】发现 → 构建 → 去重/合并 → 导出 的流式流水线，导出完的函数释放CPG数据
+        PipelineOptions options;
+        options.maxQueuedClusters = g_cgConfig.pipelineQueue;
+        options.maxRSSBytes = static_cast<size_t>(g_cgConfig.maxRSSMB) << 20;
+        // 【修复】默认释放；被调用者按内联深度、调用者按跨函数回溯深度计引用
+        options.releaseFunctions = !g_cgConfig.keepCPG;
+        options.calleeDepth = ComputeGraphBuilder::kDefaultMaxCallDepth;
+        options.callerDepth = g_cgConfig.maxBackwardDepth;
+
+        std::vector<const FunctionDecl*> worklist(functions.begin(), functions.end());
+        std::unique_ptr<ComputeGraphBuilder> builder;
+        const FunctionDecl* builderFunc = nullptr;
+
+        AnalysisPipeline pipeline(cpgContext, options);
+        pipeline.Run(worklist,
+            [this](const FunctionDecl* func, std::vector<AnchorCluster>& clusters) {
+                return DiscoverFunction(func, clusters);
+            },
+            [&](const AnchorCluster& cluster) {
+                // 同一函数的簇连续到达，构建器按函数复用
+                if (!builder || builderFunc != cluster.func) {
+                    builder = std::make_unique<ComputeGraphBuilder>(cpgContext, astContext);
+                    builder->SetMaxBackwardDepth(g_cgConfig.maxBackwardDepth);
+                    builder->SetMaxForwardDepth(g_cgConfig.maxForwardDepth);
+                    builderFunc = cluster.func;
                 }
-            }
+                return builder->BuildFromAnchorCluster(cluster);
+            },
+            [this](PipelineFunctionResult& functionResult) {
+                ExportFunction(functionResult);
+            },
+            [this](ComputeGraph& merged) {
+                // 【新增】合并后的图重新做依赖分析（函数的CPG在导出前不会被释放）
+                ComputeGraphBuilder(cpgContext, astContext).ReanalyzeMerged(merged);
+            });
+        pipelineStats = pipeline.GetStats();
+    }
+
+    // 流水线发现阶段：构建CPG、查找锚点并分簇
+    bool DiscoverFunction(const FunctionDecl* func, std::vector<AnchorCluster>& clusters)
+    {
+        std::string funcName = func->getNameAsString();
+        PrintSubHeader("Demo 2: Analyzing Function: " + funcName);
+
+        // 【新增】头文件中的函数在其他翻译单元已分析过则连CPG都不再构建
+        if (!ClaimConfiguredFunction(func, astContext)) {
+            outs() << "  Skipped: already analyzed in another translation unit\n";
+            return false;
+        }
+
+        // 构建CPG
+        cpgContext.BuildCPG(func);
+
+        // 查找锚点
+        AnchorFinder finder(cpgContext, astContext);
+        finder.SetProfile(GetConfiguredProfile());
+        finder.SetMaxAnchors(g_cgConfig.maxAnchors);
+        auto anchors = finder.FindAnchorsInFunction(func);
+        auto rankedAnchors = finder.FilterAndRankAnchors(anchors);
+        size_t claimedElsewhere = FilterConfiguredAnalyzedAnchors(rankedAnchors, astContext);
+
+        outs() << "  Found " << anchors.size() << " raw anchors, ";
+        outs() << rankedAnchors.size() << " after filtering";
+        if (claimedElsewhere > 0) {
+            outs() << " (" << claimedElsewhere << " already analyzed)";
+        }
+        outs() << "\n";
 
-            // 去重并合并重叠的图
-            size_t beforeDedup = graphSet.Size();
-            graphSet.Deduplicate();
-            graphSet.MergeOverlapping();  // 合并有共享节点的图
+        // 【修改】按最内层循环分簇，每簇一次构建
+        clusters = finder.ClusterAnchors(rankedAnchors);
 
-            outs() << "  Built " << beforeDedup << " graphs, ";
-            outs() << graphSet.Size() << " after dedup & merge\n";
+        // 【修改】模板函数按实例构建：锚点簇映射到各实例，图在实例自身的AST上构建
+        size_t instanceClusters = ExpandConfiguredInstantiations(clusters, func, cpgContext, astContext);
+        if (instanceClusters > 0) {
+            outs() << "  Template instantiations: " << instanceClusters << " clusters\n";
+        }
+        return true;
+    }
 
-            result.graphCount = graphSet.Size();
+    // 流水线导出阶段：图已去重合并，此后的处理只依赖图本身
+    void ExportFunction(PipelineFunctionResult& functionResult)
+    {
+        const FunctionDecl* func = functionResult.func;
+        std::string funcName = func->getNameAsString();
+        ComputeGraphSet& graphSet = functionResult.graphSet;
+
+        TestResult result;
+        result.testName = funcName;
+        result.passed = true;
+        result.anchorCount = functionResult.anchorCount;
+
+        outs() << "  [" << funcName << "] Built " << functionResult.builtGraphs << " graphs, ";
+        outs() << graphSet.Size() << " after dedup & merge\n";
+
+        // 【新增】向量化收益估计：按加速比排序并剪除无收益的图
+        size_t pruned = ApplyConfiguredCostModel(graphSet);
+        if (pruned > 0) {
+            outs() << "  Pruned " << pruned << " graphs not vectorizable or below speedup "
+                   << g_cgConfig.minSpeedup << "\n";
+        }
 
-            // 统计节点和边
-            for (const auto& graph : graphSet.GetAllGraphs()) {
-                result.nodeCount += graph->NodeCount();
-                result.edgeCount += graph->EdgeCount();
+        result.graphCount = graphSet.Size();
+        DumpConfiguredCanonical(graphSet, funcName);
 
-                if (g_cgConfig.dumpGraphs) {
-                    graph->PrintSummary();
-                    if (g_cgConfig.verbose) {
-                        graph->Dump();
-                    }
+        // 统计节点和边
+        for (const auto& graph : graphSet.GetAllGraphs()) {
+            result.nodeCount += graph->NodeCount();
+            result.edgeCount += graph->EdgeCount();
+
+            if (g_cgConfig.dumpGraphs) {
+                graph->PrintSummary();
+                if (g_cgConfig.verbose) {
+                    graph->Dump();
                 }
             }
+        }
 
-            // 生成可视化
-            if (g_cgConfig.visualize) {
-                std::error_code ec = sys::fs::create_directories(g_cgConfig.outputDir);
-                if (!ec) {
-                    int idx = 0;
-                    for (const auto& graph : graphSet.GetAllGraphs()) {
-                        std::string filename = g_cgConfig.outputDir + "/" +
-                            funcName + "_cg_" + std::to_string(idx++) + ".dot";
-                        graph->ExportDotFile(filename);
-                        outs() << "  Generated: " << filename << "\n";
-                    }
+        // 生成可视化
+        if (g_cgConfig.visualize) {
+            std::error_code ec = sys::fs::create_directories(g_cgConfig.outputDir);
+            if (!ec) {
+                int idx = 0;
+                for (const auto& graph : graphSet.GetAllGraphs()) {
+                    std::string filename = g_cgConfig.outputDir + "/" +
+                        funcName + "_cg_" + std::to_string(idx++) + ".dot";
+                    graph->ExportDotFileLOD(filename, g_cgConfig.dotLODThreshold);
+                    outs() << "  Generated: " << filename << "\n";
                 }
             }
-
-            result.message = "Analyzed " + std::to_string(result.graphCount) + " graphs";
-            results.push_back(result);
         }
+
+        // 【新增】生成向量化代码、微基准与二进制图文件
+        EmitConfiguredSIMDCode(graphSet, funcName, astContext);
+        ExportConfiguredBinary(graphSet, funcName, astContext);
+        IndexConfiguredSimilarity(graphSet, astContext);
+        RunConfiguredBenchmarks(graphSet, funcName, astContext);
+
+        result.message = "Analyzed " + std::to_string(result.graphCount) + " graphs";
+        results.push_back(result);
     }
 
     // // ========================================
@@ -581,6 +813,16 @@ private:
 
         cpgContext.PrintStatistics();
 
+        outs() << "Pipeline: " << pipelineStats.clustersBuilt << " clusters built, "
+               << pipelineStats.releasedFunctions << " functions released, peak queue "
+               << pipelineStats.peakQueuedClusters << " clusters, peak RSS "
+               << (pipelineStats.peakRSSBytes >> 20) << " MB";
+        outs() << ", peak live CPG functions " << pipelineStats.peakLiveFunctions;
+        if (pipelineStats.backpressureStalls > 0) {
+            outs() << ", " << pipelineStats.backpressureStalls << " backpressure stalls";
+        }
+        outs() << "\n";
+
         outs() << "\nFunctions analyzed: " << functions.size() << "\n";
         for (auto* func : functions) {
             outs() << "  - " << func->getNameAsString() << "\n";
@@ -616,6 +858,9 @@ public:
     {
         // 创建CPG上下文
         cpg::CPGContext cpgContext(context);
+        cpg::PointsToMode pointsToMode = cpg::PointsToMode::Steensgaard;
+        cpg::ParsePointsToMode(g_cgConfig.pointsTo, pointsToMode);
+        cpgContext.SetPointsToMode(pointsToMode);
 
         // 创建Demo运行器并执行
         DemoRunner runner(context, cpgContext);
@@ -641,6 +886,8 @@ public:
 // ============================================
 int main(int argc, const char** argv)
 {
+    auto startTime = std::chrono::steady_clock::now();
+
     // 解析命令行参数
     auto ExpectedParser = CommonOptionsParser::create(
         argc, argv, ToolCategory, cl::ZeroOrMore,
@@ -667,11 +914,28 @@ int main(int argc, const char** argv)
 
     // 初始化配置
     InitializeConfig();
+    cpg::PointsToMode pointsToMode;
+    if (!cpg::ParsePointsToMode(g_cgConfig.pointsTo, pointsToMode)) {
+        errs() << "Error: unknown --points-to mode '" << g_cgConfig.pointsTo
+               << "' (expected off, steensgaard or andersen)\n";
+        return 1;
+    }
     PrintToolBanner();
 
     // 运行Clang工具
     ClangTool Tool(OptionsParser.getCompilations(),
                    OptionsParser.getSourcePathList());
 
-    return Tool.run(newFrontendActionFactory<ComputeGraphAction>().get());
+    int status = Tool.run(newFrontendActionFactory<ComputeGraphAction>().get());
+
+    // 【新增】所有翻译单元处理完后输出跨文件的内核聚类与去重统计
+    ReportConfiguredSimilarity();
+    ReportConfiguredDedup();
+
+    // 【新增】回归测试按这两行检查时间与峰值内存预算
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    outs() << "\nWall time: " << elapsed.count() << " ms\n";
+    outs() << "Peak RSS: " << (PeakResidentBytes() >> 10) << " KB\n";
+    return status;
 }
\ No newline at end of file